@@ -0,0 +1,81 @@
+#include "ChamberClock.h"
+#include <stdio.h>
+
+// Discipline tuning. The stamp only resolves whole seconds, so individual
+// measurements carry up to a second of quantization noise; correcting a
+// fraction of each error with a hard per-report cap averages that out
+// while still tracking real drift (tens of ppm of crystal offset needs a
+// few ms of correction per report at the satellite's cadence). Errors
+// beyond the step threshold mean the satellite's own clock jumped — chase
+// it immediately rather than slewing for hours.
+#define CLOCK_STEP_THRESHOLD_MS 5000
+#define CLOCK_SLEW_DIV 8        // correct 1/8 of the measured error
+#define CLOCK_SLEW_MAX_MS 50    // but never more than this per report
+
+// offsetMs (epoch ms minus millis()) is written by the radio task and read
+// by the control and display tasks; a 64-bit value can tear on this
+// target, so all access goes through a short critical section
+static portMUX_TYPE clockMux = portMUX_INITIALIZER_UNLOCKED;
+static int64_t offsetMs = 0;
+static bool synced = false;
+
+static long lastErrMs = 0;       // Last measured error (diagnostics)
+static unsigned long clockSteps = 0;
+static unsigned long clockSlews = 0;
+static char clockBuf[96];
+
+void clockDiscipline(uint32_t unixTime, uint32_t airtimeMs) {
+  if (unixTime == 0) {
+    return;  // satellite had no valid date — nothing to discipline against
+  }
+
+  // The stamp was cut when the satellite built the report; by the time
+  // readData hands the packet over it is one airtime older than that
+  int64_t measured = (int64_t)unixTime * 1000 + airtimeMs - (int64_t)millis();
+
+  taskENTER_CRITICAL(&clockMux);
+  if (!synced) {
+    offsetMs = measured;
+    synced = true;
+    clockSteps++;
+  } else {
+    int64_t err = measured - offsetMs;
+    lastErrMs = (long)err;
+    if (err > CLOCK_STEP_THRESHOLD_MS || err < -CLOCK_STEP_THRESHOLD_MS) {
+      offsetMs = measured;
+      clockSteps++;
+    } else {
+      int64_t adj = err / CLOCK_SLEW_DIV;
+      if (adj > CLOCK_SLEW_MAX_MS) adj = CLOCK_SLEW_MAX_MS;
+      if (adj < -CLOCK_SLEW_MAX_MS) adj = -CLOCK_SLEW_MAX_MS;
+      offsetMs += adj;
+      clockSlews++;
+    }
+  }
+  taskEXIT_CRITICAL(&clockMux);
+}
+
+bool clockSynced() {
+  return synced;
+}
+
+uint64_t clockEpochMs() {
+  taskENTER_CRITICAL(&clockMux);
+  uint64_t ms = synced ? (uint64_t)((int64_t)millis() + offsetMs) : 0;
+  taskEXIT_CRITICAL(&clockMux);
+  return ms;
+}
+
+const char* clockToString() {
+  if (!synced) {
+    snprintf(clockBuf, sizeof(clockBuf), "Clock: unsynced (up %lus)",
+             millis() / 1000);
+    return clockBuf;
+  }
+  uint64_t ms = clockEpochMs();
+  snprintf(clockBuf, sizeof(clockBuf),
+           "Clock: %lu.%03u utc err:%+ldms steps:%lu slews:%lu",
+           (unsigned long)(ms / 1000), (unsigned)(ms % 1000),
+           lastErrMs, clockSteps, clockSlews);
+  return clockBuf;
+}
@@ -0,0 +1,28 @@
+#ifndef CHAMBER_CLOCK_H
+#define CHAMBER_CLOCK_H
+
+#include <Arduino.h>
+
+// Disciplined epoch clock for the chamber. The chamber has no absolute
+// time source of its own, so every decoded satellite report that carries a
+// GPS-backed unix_time stamp feeds one offset measurement (compensated for
+// the packet's LoRa airtime) and the local millis() timeline is slewed onto
+// it. Logs and the dose ledger then sit on the same timeline as the
+// satellite's stamps, so correlating the two sides needs no post-hoc
+// clock alignment on shore.
+//
+// Slewing, not stepping: once synced the clock moves by a bounded fraction
+// of the measured error per report, so timestamps stay monotonic through
+// the stamp's one-second quantization. A large error (satellite reboot,
+// first GPS fix after a long outage) steps instead.
+
+// Feed one offset measurement: the report's unix_time stamp plus the
+// airtime the packet spent on the wire before readData returned it.
+// Called from the radio task; readers on other cores stay consistent.
+void clockDiscipline(uint32_t unixTime, uint32_t airtimeMs);
+
+bool clockSynced();        // A real epoch has been acquired
+uint64_t clockEpochMs();   // Disciplined epoch in ms; 0 before first sync
+const char* clockToString(); // Status line in a static buffer (no heap)
+
+#endif
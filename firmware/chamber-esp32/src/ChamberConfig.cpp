@@ -0,0 +1,85 @@
+#include "ChamberConfig.h"
+#include <Preferences.h>
+
+ChamberConfig chamberCfg;
+
+#define CFG_NVS_NAMESPACE "chamber"
+
+// One row per tunable: serial/NVS key, cache field, accepted range. The
+// ranges keep a typo from parking the rig somewhere unsafe — a rejected
+// value leaves the running value alone.
+struct ConfigEntry {
+  const char* key;
+  uint32_t ChamberConfig::*field;
+  uint32_t defaultValue;
+  uint32_t minValue;
+  uint32_t maxValue;
+};
+
+static const ConfigEntry CONFIG_TABLE[] = {
+  { "scale",   &ChamberConfig::scaleConstant,    SCALE_CONSTANT,     100, 100000 },
+  { "pwmfreq", &ChamberConfig::pwmFreq,          PWM_FREQ,           100,   4880 },
+  { "fade",    &ChamberConfig::pwmFadeMs,        PWM_FADE_MS,          0,   1000 },
+  { "ewma",    &ChamberConfig::luxEwmaShift,     LUX_EWMA_SHIFT,       0,      8 },
+  { "poll",    &ChamberConfig::inputPollMs,      INPUT_POLL_MS,        5,   1000 },
+  { "disp",    &ChamberConfig::displayRefreshMs, DISPLAY_REFRESH_MS,  50,   5000 },
+  { "log",     &ChamberConfig::logPeriodMs,      LOG_PERIOD_MS,      100,  60000 },
+  { "specscale", &ChamberConfig::spectralScale,  SPECTRAL_SCALE_PCT,   1,    400 },
+  { "ratelead",  &ChamberConfig::rateLeader,     LORA_RATE_LEADER,     0,      1 },
+  { "chmask",    &ChamberConfig::channelMask,    LORA_CHANNEL_MASK,    1, 0x1FFF },
+  { "predms",    &ChamberConfig::predictMs,      SPECTRAL_PREDICT_MS,  0,   1000 },
+  { "lorachan",  &ChamberConfig::loraChannel,    LORA_CHANNEL,         0, LORA_CHANNEL_COUNT - 1 },
+};
+#define CONFIG_TABLE_LEN (sizeof(CONFIG_TABLE) / sizeof(CONFIG_TABLE[0]))
+
+void chamberConfigLoad() {
+  Preferences prefs;
+  bool haveNvs = prefs.begin(CFG_NVS_NAMESPACE, true);
+  for (size_t i = 0; i < CONFIG_TABLE_LEN; i++) {
+    const ConfigEntry& e = CONFIG_TABLE[i];
+    uint32_t v = haveNvs ? prefs.getUInt(e.key, e.defaultValue) : e.defaultValue;
+    if (v < e.minValue || v > e.maxValue) {
+      v = e.defaultValue;  // stored under an older range — back to default
+    }
+    chamberCfg.*(e.field) = v;
+  }
+  if (haveNvs) {
+    prefs.end();
+  }
+}
+
+bool chamberConfigApply(const char* key, uint32_t value) {
+  for (size_t i = 0; i < CONFIG_TABLE_LEN; i++) {
+    const ConfigEntry& e = CONFIG_TABLE[i];
+    if (strcmp(key, e.key) != 0) {
+      continue;
+    }
+    if (value < e.minValue || value > e.maxValue) {
+      return false;
+    }
+    chamberCfg.*(e.field) = value;
+    Preferences prefs;
+    if (prefs.begin(CFG_NVS_NAMESPACE, false)) {
+      prefs.putUInt(e.key, value);
+      prefs.end();
+    }
+    return true;
+  }
+  return false;
+}
+
+String chamberConfigToString() {
+  String s;
+  for (size_t i = 0; i < CONFIG_TABLE_LEN; i++) {
+    const ConfigEntry& e = CONFIG_TABLE[i];
+    s += e.key;
+    s += '=';
+    s += String(chamberCfg.*(e.field));
+    s += " [";
+    s += String(e.minValue);
+    s += "..";
+    s += String(e.maxValue);
+    s += "]\n";
+  }
+  return s;
+}
@@ -0,0 +1,47 @@
+#ifndef CHAMBER_CONFIG_H
+#define CHAMBER_CONFIG_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// NVS-backed runtime tuning. The #defines in Config.h stay as compile-time
+// defaults; any value set over serial persists (Preferences namespace
+// "chamber") and overrides the default on every subsequent boot. Values are
+// cached in this plain struct once at begin(), so hot paths read a RAM
+// field and never touch NVS. Array-sizing constants (LUX_BUFFER_SIZE, LCD
+// geometry, pin numbers) remain compile-time only.
+//
+// Serial usage (same UART as the lux stream — printable bytes that arrive
+// between binary frames are collected as command text):
+//   cfg                 print every key with its current value
+//   cfg <key> <value>   validate, apply and persist one value
+struct ChamberConfig {
+  uint32_t scaleConstant;    // SCALE_CONSTANT: lux scaling into the gamma LUT
+  uint32_t pwmFreq;          // PWM_FREQ: applied at begin() — reboot to change
+  uint32_t pwmFadeMs;        // PWM_FADE_MS: hardware fade time (0 = hard steps)
+  uint32_t luxEwmaShift;     // LUX_EWMA_SHIFT: smoothing weight (0 = off)
+  uint32_t inputPollMs;      // INPUT_POLL_MS: switch & pot sampling cadence
+  uint32_t displayRefreshMs; // DISPLAY_REFRESH_MS: LCD redraw cadence
+  uint32_t logPeriodMs;      // LOG_PERIOD_MS: serial debug log cadence
+  uint32_t spectralScale;    // SPECTRAL_SCALE_PCT: per-chamber drive scale (%)
+  uint32_t rateLeader;       // LORA_RATE_LEADER: may propose LoRa rate changes
+  uint32_t channelMask;      // LORA_CHANNEL_MASK: spectral channels requested
+  uint32_t predictMs;        // SPECTRAL_PREDICT_MS: trend-hold cadence (0 = off)
+  uint32_t loraChannel;      // LORA_CHANNEL: frequency-plan channel followed
+};
+
+// RAM cache, valid after chamberConfigLoad()
+extern ChamberConfig chamberCfg;
+
+// Fill chamberCfg from NVS, falling back to the Config.h defaults for any
+// key never overridden. Called once from InputOutput::begin().
+void chamberConfigLoad();
+
+// Validate, apply to the cache and persist one value. Returns false (cache
+// untouched) for an unknown key or out-of-range value.
+bool chamberConfigApply(const char* key, uint32_t value);
+
+// Every key with its current value, one per line, for the cfg command
+String chamberConfigToString();
+
+#endif
@@ -1,4 +1,8 @@
 // ESP32 Chamber Configuration File
+//
+// Tuning values (scale, fade, ewma, poll/display/log cadence, PWM freq)
+// are compile-time *defaults*: ChamberConfig.h overlays them with
+// NVS-persisted overrides settable over serial ("cfg <key> <value>").
 
 // ---------- Pin Definitions ----------
 #define SWITCH1_PIN 14      // Input switch 1 with pull-up
@@ -10,15 +14,185 @@
 #define UART0_BAUD  115200  // UART0 baud rate
 
 // ---------- PWM Settings ----------
-#define PWM_FREQ      5000   // 5 kHz PWM
+#define PWM_FREQ      4000   // 4 kHz PWM (14-bit caps out at ~4.88 kHz on the 80 MHz clock)
 #define PWM_CHANNEL   0      // PWM Channel
-#define PWM_RES_BITS  10     // 10-bit (0–1023)
-#define MAX_PWM_VALUE 1023   // Max for 10-bit
+#define PWM_RES_BITS  14     // 14-bit (0–16383) for fine low-end resolution
+#define MAX_PWM_VALUE 16383  // Max for 14-bit
 #define SCALE_CONSTANT 2750  // Lux scaling constant (increase to decrease intensity)
+#define PWM_FADE_MS   40     // Hardware fade time between duty targets (0 = hard steps)
+
+// ---------- Thermal derating governor ----------
+// NTC on the LED driver heatsink, bottom leg of a divider (series resistor
+// to 3V3, NTC to GND, ADC at the junction). That orientation fails safe:
+// an unfitted or open sensor reads full-scale, which converts to "cold"
+// and leaves output uncapped, while a short reads "hot" and derates.
+// Above DERATE_START_C the duty cap ramps linearly down to FLOOR_PCT at
+// DERATE_END_C — a graceful 90% of tropical noon instead of the driver's
+// own thermal cutout taking the chamber to 0%.
+#define THERMAL_NTC_PIN        34     // ADC1, input-only pin
+#define THERMAL_NTC_SERIES_OHM 10000  // Divider top resistor
+#define THERMAL_NTC_R25_OHM    10000  // NTC resistance at 25 C
+#define THERMAL_NTC_BETA       3950
+#define THERMAL_SAMPLE_MS      1000   // Heatsink time constant is minutes
+#define THERMAL_DERATE_START_C 70
+#define THERMAL_DERATE_END_C   95
+#define THERMAL_FLOOR_PCT      15     // Never fully dark while the NTC reads sane
+#define THERMAL_SLEW_Q16       1311   // Max cap change per sample (~2%/s)
+
+// ---------- Spectral PWM Settings ----------
+#define NUM_LED_CHANNELS  4           // blue, green, red, NIR strips
+#define LED_CH_PINS       {26, 32, 33, 23} // One GPIO per strip
+#define LED_CH_FIRST_LEDC 1           // LEDC channels 1..4 (0 is the single lux output)
+#define NUM_SRC_CHANNELS  13          // Spectral channels in the report payload
+#define MIX_SHIFT         12          // Q12 fixed-point mixing weights
+// Strip emitter spectra (peak nm, FWHM nm), one per LED channel. The
+// mixing matrix is generated from these at compile time (MixMatrix.h) —
+// swapping strip hardware means editing this line, not re-deriving
+// thirteen weights per row by hand.
+#define LED_EMITTER_TABLE { {450, 70}, {535, 60}, {645, 70}, {800, 140} }
+// Per-chamber drive scale (percent) applied to the mixed spectral output.
+// One satellite broadcast feeds every chamber on the vessel; this is where
+// an individual chamber compensates its own strip efficiency and optical
+// path without touching the shared transmitter ("cfg specscale <pct>").
+#define SPECTRAL_SCALE_PCT 100
+// Predictive hold cadence between reports: the control task extrapolates
+// the per-channel trend of the last two decoded reports and refreshes the
+// strips this often, so the light ramps instead of stepping once per
+// report. 0 disables prediction and holds the last report ("cfg predms 0").
+#define SPECTRAL_PREDICT_MS 50
+
+// ---------- LoRa Receiver Settings ----------
+// SX1262 on VSPI; pins chosen clear of the switch/pot/LCD/LED assignments
+#define LORA_SCK_PIN   18
+#define LORA_MISO_PIN  19
+#define LORA_MOSI_PIN  13
+#define LORA_CS_PIN    5
+#define LORA_DIO1_PIN  4
+#define LORA_RST_PIN   15
+#define LORA_BUSY_PIN  2
+// Radio parameters — must mirror the satellite firmware exactly
+#define LORA_FREQ_MHZ  915.0
+// Fleet frequency plan (mirrors the satellite's): carrier = base +
+// channel * step, channel being the satellite's FLEET_NODE_ID modulo the
+// channel count. Which satellite this chamber follows is runtime config
+// ("lorachan"); this default keeps the legacy node-0 carrier.
+#define LORA_CHANNEL_COUNT    8
+#define LORA_CHANNEL_STEP_MHZ 0.8
+#define LORA_CHANNEL          0
+#define LORA_BW_KHZ    250.0
+#define LORA_SF        9
+#define LORA_CR        7
+#define LORA_SYNC_WORD 0x12
+// Faster rate proposed to the satellite when receive margin allows; SF9 is
+// the fallback/floor rate both ends always know how to meet on
+#define LORA_SF_FAST   7
+// Whether this chamber may propose rate changes. Exactly one chamber per
+// vessel holds the role (1); the rest listen passively and retune by
+// overhearing the leader's signed rate frame, so a retune never strands
+// part of the broadcast audience ("cfg ratelead 0" on the followers).
+#define LORA_RATE_LEADER 1
+// Spectral channels requested from the satellite, bit i = wire channel i.
+// 0x1FFF (all 13) leaves the link in full keyframe/delta mode; anything
+// narrower makes the rate leader propose masked frames carrying only the
+// selected bands ("cfg chmask 0x..." takes decimal — 8191 = all).
+#define LORA_CHANNEL_MASK 0x1FFF
+// Implicit-header mode: 0 = explicit PHY headers (default); non-zero pads
+// every frame both ways to exactly that many bytes and drops the header
+// symbols. Must equal LORA_IMPLICIT_LEN in the satellite firmware — a
+// mismatch deafens the link in both directions.
+#define LORA_IMPLICIT_LEN 0
+// Uplink frame authentication: the satellite ends every frame in a 4-byte
+// SipHash-2-4 tag and the receiver drops anything that fails it, so a
+// neighboring 915 MHz device cannot inject frames the control path would
+// turn into light commands. Both values must match LORA_FRAME_AUTH and
+// LORA_FRAME_AUTH_KEY in the satellite firmware; the key is exactly 16
+// bytes and real deployments inject their own at build time.
+#define LORA_FRAME_AUTH 1
+#define LORA_FRAME_AUTH_KEY "orca-frame-key-1"
+// Solar plausibility check: a report claiming bright light while the sun
+// sits below civil twilight at the report's own GPS position and time is
+// dropped before it can reach the strips. The shore pipeline has always
+// done this on the Pi; chambers deployed without one get the same gate
+// on-device, using the satellite's fixed-point solar model (a table
+// lookup and a few integer multiplies — microseconds per report). Only
+// the bright-at-night direction is checked: darkness under a high sun is
+// just cloud or shading, never evidence of a bad report.
+#define SOLAR_CHECK_ENABLED     1
+#define SOLAR_NIGHT_CDEG        (-600)  // Elevation floor (centi-degrees)
+#define SOLAR_NIGHT_MAX_COUNTS  5000    // Max believable channel counts at night
+
+// ---------- Lux Transport Settings ----------
+// 1 compiles in the ESP-NOW receive path for the module's lux stream (see
+// EspNowLink.h); the frames are byte-identical to the UART protocol and
+// both transports stay live at runtime — bytes are accepted from whichever
+// arrives. The module must broadcast on this chamber's WiFi channel (the
+// web status soft-AP's channel, or 1 with the web compiled out). Build
+// with -DLUX_TRANSPORT_ESPNOW=1 in platformio.ini to enable.
+#ifndef LUX_TRANSPORT_ESPNOW
+#define LUX_TRANSPORT_ESPNOW 0
+#endif
+
+// ---------- Data Log Settings ----------
+// Binary on-chamber record of the lux stream and satellite reports (see
+// DataLog.h). Writes are coalesced into erase-aligned batches by a
+// low-priority task; nothing on the sample path touches flash.
+// Accelerated replay of the datalog through the live spectral pipeline
+// ("replay <accel>" over serial; see Replay.h)
+#define REPLAY_BASE_PERIOD_MS  1000  // Recorded report cadence being replayed
+#define REPLAY_ACCEL_MAX       600   // Tick granularity floors the pacing delay
+#define REPLAY_STAGE_BUDGET_US 2000  // Per-record extract+inject budget
+
+#define DATALOG_ENABLED     1
+#define DATALOG_FLUSH_BYTES 4096           // One flash erase sector per write
+#define DATALOG_FLUSH_MS    30000          // Partial-flush timeout (bounds loss)
+#define DATALOG_FILE_BYTES  (512 * 1024)   // Per-slot cap before rotation
+#define DATALOG_FILES       2              // Slots in the rotation ring
+
+// ---------- Web Status Settings ----------
+// Soft-AP + esp_http_server status endpoint (see WebStatus.h). The push
+// path is strictly non-blocking, so a slow or dead browser can never
+// stall anything; set WEB_STATUS_ENABLED 0 to compile the radio out.
+#define WEB_STATUS_ENABLED  1
+#define WEB_AP_SSID         "orca-chamber"
+#define WEB_AP_PASS         "orca-lights"  // >= 8 chars or the AP comes up open
+#define WEB_STATUS_PORT     80
+#define WEB_SSE_PERIOD_MS   1000  // Event-stream push cadence
+#define WEB_SSE_MAX_CLIENTS 4     // Concurrent event streams
+// Day-curve history behind "/history": a fixed RAM ring of lux points at
+// a coarse cadence, LTTB-downsampled to the requested size on demand.
+// The flash datalog keeps the lossless record; this exists so a chart
+// costs one bounded HTTP response instead of a bulk harvest.
+#define WEB_HISTORY_PERIOD_MS  15000 // Recording cadence
+#define WEB_HISTORY_LEN        5760  // 24 h at that cadence (~11 KB RAM)
+#define WEB_HISTORY_MAX_POINTS 2000  // "/history?n=" ceiling
+// OTA through the status server (see OtaUpdate.h): POST a full image to
+// "/ota" or a delta patch against the running version to "/ota/patch".
+// Rides the soft-AP, so updating means joining the chamber's own network
+// — no shore infrastructure and nothing new listening on the water.
+#define OTA_WEB_ENABLED 1
+
+// ---------- LCD Settings ----------
+#define LCD_ADDR 0x27        // I2C address
+#define LCD_COLS 16          // Character columns
+#define LCD_ROWS 2           // Character rows
 
 // ---------- Other Settings ----------
 #define I2C_FREQUENCY 400000 // 400 kHz Frequency
-#define LOOP_DELAY_MS 100    // 100 milliseconds loop delay
+#define SWITCH_DEBOUNCE_MS 30 // Contact-settle time before an edge commits
+
+// ---------- Loop Scheduling ----------
+// loop() free-runs (UART ingested every pass); everything else on its own timer
+#define INPUT_POLL_MS      25   // Switch & potentiometer sampling cadence
+#define DISPLAY_REFRESH_MS 250  // LCD redraw cadence
+#define LOG_PERIOD_MS      1000 // Serial debug log cadence
+#define BANNER_HOLD_MS     1000 // Boot banner hold (deferred first LCD refresh)
+
+// ---------- Lux Filter Settings ----------
+// Median-of-3 despike then integer EWMA between ingestion and the PWM:
+// a corrupt-but-in-bounds line can't survive the median unless it repeats,
+// and the EWMA keeps line noise from becoming visible flicker
+#define LUX_EWMA_SHIFT 2     // Smoothing weight 1/2^shift per sample (0 = off)
 
 // ---------- Bounds Buffer Settings ----------
-#define LUX_BUFFER_SIZE 600  // 1 minute of samples at 100ms intervals
\ No newline at end of file
+#define LUX_BUFFER_SIZE 3000 // 1 minute of samples at the module's 20ms cadence
+#define LUX_CLAMP_QUANTILE 0.05f // Clamp to the 5th/95th percentiles (P2 estimators)
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "DataLog.h"
+
+#if DATALOG_ENABLED
+
+#include <LittleFS.h>
+#include "Log.h"
+
+// Staging ring: multi-producer (ingestion and radio tasks on core 0),
+// so pushes take a spinlock for the duration of a memcpy — a few hundred
+// nanoseconds, not a flash transaction. Sized for several flush batches
+// of backlog in case the filesystem has a slow moment.
+#define DATALOG_RING_LEN (4 * DATALOG_FLUSH_BYTES)
+static uint8_t ring[DATALOG_RING_LEN];
+static volatile uint32_t ringHead = 0;
+static volatile uint32_t ringTail = 0;
+static portMUX_TYPE logMux = portMUX_INITIALIZER_UNLOCKED;
+
+static File logFile;
+static int fileIdx = 0;
+static bool logReady = false;
+static unsigned long recordsStaged = 0;
+static unsigned long recordsDropped = 0;
+static unsigned long bytesWritten = 0;
+static unsigned long flushes = 0;
+
+static void logFileName(char* buf, size_t len, int idx) {
+  snprintf(buf, len, "/datalog%d.bin", idx);
+}
+
+// Open slot idx for append, truncating it if rotation is reclaiming it
+static bool openLogFile(int idx, bool truncate) {
+  char name[24];
+  logFileName(name, sizeof(name), idx);
+  logFile = LittleFS.open(name, truncate ? "w" : "a");
+  return (bool)logFile;
+}
+
+// Rotate into the next slot once the current file would outgrow its cap;
+// the oldest slot is truncated, so total footprint is bounded at
+// DATALOG_FILES x DATALOG_FILE_BYTES regardless of run length
+static void maybeRotate(size_t pending) {
+  if (logFile && logFile.size() + pending <= DATALOG_FILE_BYTES) {
+    return;
+  }
+  if (logFile) {
+    logFile.close();
+  }
+  fileIdx = (fileIdx + 1) % DATALOG_FILES;
+  if (!openLogFile(fileIdx, true)) {
+    logReady = false;
+    LOG_ERROR("DataLog: rotation open failed, logging stopped");
+  }
+}
+
+// Drain up to maxLen staged bytes into buf under the lock; the flash
+// write itself happens with the lock long released
+static size_t ringDrain(uint8_t* buf, size_t maxLen) {
+  size_t n = 0;
+  portENTER_CRITICAL(&logMux);
+  uint32_t tail = ringTail;
+  while (n < maxLen && tail != ringHead) {
+    buf[n++] = ring[tail];
+    tail = (tail + 1) % DATALOG_RING_LEN;
+  }
+  ringTail = tail;
+  portEXIT_CRITICAL(&logMux);
+  return n;
+}
+
+// Low priority, core 0: fill an erase-aligned batch from the ring and
+// write it in one call. The timeout path flushes a partial batch so a
+// power cut costs bounded data, at the price of one unaligned write.
+static void dataLogTask(void*) {
+  static uint8_t batch[DATALOG_FLUSH_BYTES];
+  size_t filled = 0;
+  unsigned long lastFlushMs = millis();
+
+  for (;;) {
+    filled += ringDrain(batch + filled, sizeof(batch) - filled);
+
+    unsigned long now = millis();
+    bool full = (filled == sizeof(batch));
+    bool timedOut = (filled > 0 && now - lastFlushMs >= DATALOG_FLUSH_MS);
+    if ((full || timedOut) && logReady) {
+      maybeRotate(filled);
+      if (logReady) {
+        size_t wrote = logFile.write(batch, filled);
+        logFile.flush();
+        bytesWritten += wrote;
+        flushes++;
+        if (wrote < filled) {
+          LOG_ERROR("DataLog: short write (%u/%u), logging stopped",
+                    (unsigned)wrote, (unsigned)filled);
+          logReady = false;
+        }
+      }
+      filled = 0;
+      lastFlushMs = now;
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(50));
+  }
+}
+
+bool dataLogBegin() {
+  if (!LittleFS.begin(true)) {  // true: format a virgin partition
+    LOG_ERROR("DataLog: filesystem mount failed, logging disabled");
+    return false;
+  }
+
+  // Resume the largest existing slot so a reboot appends instead of
+  // clobbering the newest data
+  size_t best = 0;
+  for (int i = 0; i < DATALOG_FILES; i++) {
+    char name[24];
+    logFileName(name, sizeof(name), i);
+    File f = LittleFS.open(name, "r");
+    if (f && f.size() >= best && f.size() < DATALOG_FILE_BYTES) {
+      best = f.size();
+      fileIdx = i;
+    }
+    if (f) {
+      f.close();
+    }
+  }
+  if (!openLogFile(fileIdx, false)) {
+    LOG_ERROR("DataLog: open failed, logging disabled");
+    return false;
+  }
+  logReady = true;
+
+  xTaskCreatePinnedToCore(dataLogTask, "datalog", 4096, NULL, 1, NULL, 0);
+  LOG_INFO("DataLog: slot %d at %u bytes", fileIdx, (unsigned)logFile.size());
+  return true;
+}
+
+void dataLogRecord(uint8_t type, const uint8_t* payload, size_t len) {
+  if (!logReady || len > 0xFFFF) {
+    return;
+  }
+  const size_t total = 4 + len;  // sync + type + len16 + payload
+
+  portENTER_CRITICAL(&logMux);
+  uint32_t head = ringHead;
+  uint32_t used = (head - ringTail + DATALOG_RING_LEN) % DATALOG_RING_LEN;
+  if (total >= DATALOG_RING_LEN - used) {
+    recordsDropped++;  // whole-record drop, never a torn envelope
+    portEXIT_CRITICAL(&logMux);
+    return;
+  }
+  uint8_t hdr[4] = { 0xD5, type, (uint8_t)(len & 0xFF), (uint8_t)(len >> 8) };
+  for (size_t i = 0; i < sizeof(hdr); i++) {
+    ring[head] = hdr[i];
+    head = (head + 1) % DATALOG_RING_LEN;
+  }
+  for (size_t i = 0; i < len; i++) {
+    ring[head] = payload[i];
+    head = (head + 1) % DATALOG_RING_LEN;
+  }
+  ringHead = head;
+  recordsStaged++;
+  portEXIT_CRITICAL(&logMux);
+}
+
+// The logical stream concatenates the rotation slots oldest-first: the
+// slot after the active one holds the oldest surviving data, the active
+// slot the newest. Stateless per call (open/seek/read/close) so the
+// harvester needs no session; LittleFS serializes this against the flush
+// task's appends, and flush() after every batch means a read sees all
+// flushed data.
+size_t dataLogReadPage(uint32_t page, uint8_t* out, size_t maxLen) {
+  if (!logReady || maxLen == 0) {
+    return 0;
+  }
+  uint64_t skip = (uint64_t)page * maxLen;
+  size_t got = 0;
+  for (int i = 1; i <= DATALOG_FILES && got < maxLen; i++) {
+    char name[24];
+    logFileName(name, sizeof(name), (fileIdx + i) % DATALOG_FILES);
+    File f = LittleFS.open(name, "r");
+    if (!f) {
+      continue;
+    }
+    if (skip >= f.size()) {
+      skip -= f.size();  // page starts in a later (newer) slot
+      f.close();
+      continue;
+    }
+    // A page can straddle a slot boundary; keep filling from the next one
+    f.seek(skip);
+    skip = 0;
+    got += f.read(out + got, maxLen - got);
+    f.close();
+  }
+  return got;
+}
+
+const char* dataLogToString() {
+  static char buf[96];
+  snprintf(buf, sizeof(buf),
+           "DataLog: %lu rec, %lu drop, %lu B in %lu flushes, slot %d",
+           recordsStaged, recordsDropped, bytesWritten, flushes, fileIdx);
+  return buf;
+}
+
+#endif
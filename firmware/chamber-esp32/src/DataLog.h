@@ -0,0 +1,59 @@
+#ifndef DATA_LOG_H
+#define DATA_LOG_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// On-chamber binary data logger. Producers (ingestion, radio/control)
+// stage records into a RAM ring with a microseconds-long spinlocked copy;
+// a dedicated low-priority task drains the ring and writes the flash
+// filesystem in erase-aligned DATALOG_FLUSH_BYTES batches. No task on the
+// sample path ever touches the filesystem — a flush that takes tens of
+// milliseconds happens entirely in the logger task, which both cores
+// preempt at will. A full ring drops the newest record whole and counts
+// it, the same policy as every other queue here.
+//
+// Records carry the wire formats the chamber already speaks, wrapped in a
+// tiny envelope so one file can interleave streams:
+//
+//   [0xD5][type u8][len u16 LE][payload]
+//
+//   type 0: a verbatim module lux frame (single or batch, exactly the
+//           bytes that arrived — the host-side LuxFrame parser reads it)
+//   type 1: a decoded satellite report (orca_report_wire_t)
+//
+// A partial flush also runs on a timeout so a power cut costs at most
+// DATALOG_FLUSH_MS of data, and files rotate in a fixed-size ring so a
+// 23-hour run can never fill the partition.
+#define DATALOG_REC_LUX    0
+#define DATALOG_REC_REPORT 1
+
+#if DATALOG_ENABLED
+
+// Mount the filesystem (formatting a virgin one), open the newest log
+// file and start the flush task. Logs and returns false on failure; the
+// record calls become cheap no-ops.
+bool dataLogBegin();
+
+// Stage one record. Safe from any task; never blocks, never touches flash.
+void dataLogRecord(uint8_t type, const uint8_t* payload, size_t len);
+
+// Read up to maxLen bytes at byte offset page*maxLen of the logical log
+// stream (rotated files concatenated oldest-first). Returns the bytes
+// copied; 0 means past the end. Backs the binary harvest protocol —
+// reads only flushed data, so the newest DATALOG_FLUSH_MS may be absent.
+size_t dataLogReadPage(uint32_t page, uint8_t* out, size_t maxLen);
+
+// Stats line in a static buffer (no heap), for the periodic log
+const char* dataLogToString();
+
+#else
+
+static inline bool dataLogBegin() { return false; }
+static inline void dataLogRecord(uint8_t, const uint8_t*, size_t) {}
+static inline size_t dataLogReadPage(uint32_t, uint8_t*, size_t) { return 0; }
+static inline const char* dataLogToString() { return "datalog off"; }
+
+#endif
+
+#endif
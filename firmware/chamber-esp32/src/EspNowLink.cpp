@@ -0,0 +1,72 @@
+#include "EspNowLink.h"
+
+#if LUX_TRANSPORT_ESPNOW
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include "Log.h"
+
+// SPSC byte ring: head written only by the receive callback (WiFi task),
+// tail only by the ingestion task. Sized for several worst-case batch
+// frames of backlog — the ingestion task drains every tick.
+#define ESPNOW_RING_LEN 1024
+static uint8_t ring[ESPNOW_RING_LEN];
+static volatile uint32_t ringHead = 0;
+static volatile uint32_t ringTail = 0;
+static volatile unsigned long ringDrops = 0;
+
+static void onRecv(const uint8_t* mac, const uint8_t* data, int len) {
+  (void)mac;  // Broadcast stream; sender identity is the frame seq's job
+  if (len <= 0) {
+    return;
+  }
+  // All-or-nothing: a partially queued packet would tear a frame
+  uint32_t head = ringHead;
+  uint32_t used = (head - ringTail + ESPNOW_RING_LEN) % ESPNOW_RING_LEN;
+  if ((uint32_t)len >= ESPNOW_RING_LEN - used) {
+    ringDrops++;
+    return;
+  }
+  for (int i = 0; i < len; i++) {
+    ring[head] = data[i];
+    head = (head + 1) % ESPNOW_RING_LEN;
+  }
+  ringHead = head;
+}
+
+bool espNowLinkBegin() {
+  // The web status soft-AP normally owns WiFi; ESP-NOW rides the same
+  // interface (the module must broadcast on the AP's channel). With the
+  // web compiled out, station mode is enough to bring the radio up.
+  if (WiFi.getMode() == WIFI_OFF) {
+    WiFi.mode(WIFI_STA);
+  }
+  if (esp_now_init() != ESP_OK) {
+    LOG_ERROR("ESP-NOW init failed; lux stream stays UART-only");
+    return false;
+  }
+  if (esp_now_register_recv_cb(onRecv) != ESP_OK) {
+    LOG_ERROR("ESP-NOW recv callback registration failed");
+    esp_now_deinit();
+    return false;
+  }
+  LOG_INFO("ESP-NOW lux link listening");
+  return true;
+}
+
+size_t espNowLinkRead(uint8_t* buf, size_t maxLen) {
+  size_t n = 0;
+  uint32_t tail = ringTail;
+  while (n < maxLen && tail != ringHead) {
+    buf[n++] = ring[tail];
+    tail = (tail + 1) % ESPNOW_RING_LEN;
+  }
+  ringTail = tail;
+  return n;
+}
+
+unsigned long espNowLinkDrops() {
+  return ringDrops;
+}
+
+#endif
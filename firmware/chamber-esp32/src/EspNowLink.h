@@ -0,0 +1,37 @@
+#ifndef ESP_NOW_LINK_H
+#define ESP_NOW_LINK_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// ESP-NOW transport for the module's lux stream: the module broadcasts the
+// same binary frames it would write to the UART, and this link hands the
+// bytes to the ingestion task to run through the identical frame assembler
+// (InputOutput::ingestBytes). Connectionless with ~1 ms over-the-air
+// latency, so the control loop keeps its wired-path timing without a cable
+// through the deck penetration.
+//
+// The receive callback runs in the WiFi task; it only copies the packet
+// into a lock-free byte ring (same single-producer/single-consumer
+// discipline as the core-to-core queues in main.cpp) that the ingestion
+// task drains. A packet that does not fit is dropped whole — a torn frame
+// would just cost a resync, but whole-packet drops keep the counter
+// meaningful. Both transports stay live at runtime: frames are accepted
+// from whichever arrives, so a rig can run wired, wireless, or wired with
+// a wireless backup without reflashing the chamber.
+#if LUX_TRANSPORT_ESPNOW
+
+// Register the receive callback; requires WiFi to be up (the web status
+// soft-AP, or station mode is entered here if nothing started WiFi).
+// Logs and returns false on failure — the UART path still works.
+bool espNowLinkBegin();
+
+// Drain up to maxLen queued frame bytes; returns the count (0 = none)
+size_t espNowLinkRead(uint8_t* buf, size_t maxLen);
+
+// Packets dropped because the ring was full
+unsigned long espNowLinkDrops();
+
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef GAMMA_LUT_H
+#define GAMMA_LUT_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Compile-time perceptual linearization table for the LED output.
+//
+// LED duty is linear in photon flux but the eye (and our dawn/dusk
+// replication regime) cares about perceived brightness, so equal input steps
+// should map to equal perceptual steps. The CIE 1931 lightness curve gives
+// that mapping and, unlike a fractional gamma exponent, only needs a cube —
+// so the whole 256-entry table is computed by constexpr at compile time and
+// lives in flash. At runtime a duty is one table lookup instead of float
+// multiply/clamp math per control update.
+
+constexpr int GAMMA_LUT_SIZE = 256;
+
+// CIE 1931 lightness (0..100) -> linear intensity (0..1)
+constexpr float cieLinear(float l) {
+  return (l <= 8.0f) ? l / 903.3f
+                     : ((l + 16.0f) / 116.0f) * ((l + 16.0f) / 116.0f) *
+                       ((l + 16.0f) / 116.0f);
+}
+
+struct GammaLut {
+  uint16_t duty[GAMMA_LUT_SIZE];
+};
+
+constexpr GammaLut makeGammaLut() {
+  GammaLut lut{};
+  for (int i = 0; i < GAMMA_LUT_SIZE; i++) {
+    float lightness = 100.0f * (float)i / (float)(GAMMA_LUT_SIZE - 1);
+    lut.duty[i] = (uint16_t)(cieLinear(lightness) * (float)MAX_PWM_VALUE + 0.5f);
+  }
+  return lut;
+}
+
+// constexpr + const-qualified: placed in .rodata (flash), never copied to RAM
+inline constexpr GammaLut GAMMA_LUT = makeGammaLut();
+
+// Look up the duty for a LUT index, clamped to the table
+inline uint32_t gammaDutyAt(int index) {
+  if (index < 0) index = 0;
+  if (index >= GAMMA_LUT_SIZE) index = GAMMA_LUT_SIZE - 1;
+  return GAMMA_LUT.duty[index];
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef HARVEST_PROTO_H
+#define HARVEST_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "LuxFrame.h"
+
+// Binary command/response protocol for harvesting chamber statistics over
+// the USB serial port. Requests share the wire with the module's lux
+// stream and the text console: each stream has its own sync byte
+// (0xA7/0xA8 lux frames, 0xA9 requests, printable bytes are console
+// text), so the chamber's frame assembler routes bytes without any mode
+// switching, and a harvest can run while lux ingestion continues.
+// Responses carry length-prefixed structs — a day of dose buckets or a
+// log page is one bulk read on the host instead of scraping and
+// re-requesting toString() lines.
+//
+// Request (fixed 5 bytes, little-endian):
+//   0    sync byte (HARVEST_REQ_SYNC)
+//   1    command id
+//   2-3  argument (command-specific; log page index, else 0)
+//   4    CRC8 (poly 0x07, as the lux frames) over bytes 1-3
+//
+// Response (variable, little-endian):
+//   0       sync byte (HARVEST_RESP_SYNC)
+//   1       command id being answered
+//   2-3     payload length in bytes
+//   4..     payload (packed struct, layout per command below)
+//   last    CRC8 over bytes 1 .. end of payload
+//
+// Responses interleave with the chamber's normal log output on the same
+// port, so the host parser must hunt for the response sync exactly like
+// the chamber hunts for request syncs. An unknown command id is answered
+// with an empty payload rather than silence, so the host can tell "old
+// firmware" from "dropped request".
+//
+// Command payloads:
+//   BOUNDS   i32 lo, i32 hi (active clamp bounds), i32 restoredMin,
+//            i32 restoredMax, u8 restoredValid
+//   DOSE     u32 day total (lux-h), u8 count, count x u32 hourly buckets
+//            (lux-h, newest first — same order as the "dose" console cmd)
+//   LATHIST  u8 bin count, count x u32 decode-to-PWM latency counts
+//            (power-of-two ms bins: <1, <2, ..., >=128)
+//   LOG_PAGE arg = page index into the rotated data-log stream, oldest
+//            byte first; payload is up to HARVEST_LOG_PAGE_BYTES of raw
+//            log (envelope format in DataLog.h). Empty payload = past end.
+
+#define HARVEST_REQ_SYNC  0xA9
+#define HARVEST_RESP_SYNC 0xAA
+#define HARVEST_REQ_SIZE  5
+
+#define HARVEST_CMD_BOUNDS   0x01
+#define HARVEST_CMD_DOSE     0x02
+#define HARVEST_CMD_LATHIST  0x03
+#define HARVEST_CMD_LOG_PAGE 0x04
+
+#define HARVEST_LOG_PAGE_BYTES 256
+#define HARVEST_RESP_HDR_SIZE  4
+// Largest payload any command produces (a log page), plus envelope slack
+#define HARVEST_RESP_MAX (HARVEST_RESP_HDR_SIZE + HARVEST_LOG_PAGE_BYTES + 1)
+
+static inline void harvest_req_encode(uint8_t buf[HARVEST_REQ_SIZE],
+                                      uint8_t cmd, uint16_t arg) {
+  buf[0] = HARVEST_REQ_SYNC;
+  buf[1] = cmd;
+  buf[2] = (uint8_t)(arg & 0xFF);
+  buf[3] = (uint8_t)(arg >> 8);
+  buf[4] = lux_frame_crc8(&buf[1], 3);
+}
+
+// Returns false on sync or CRC mismatch
+static inline bool harvest_req_decode(const uint8_t buf[HARVEST_REQ_SIZE],
+                                      uint8_t *cmd, uint16_t *arg) {
+  if (buf[0] != HARVEST_REQ_SYNC || lux_frame_crc8(&buf[1], 3) != buf[4]) {
+    return false;
+  }
+  *cmd = buf[1];
+  *arg = (uint16_t)(buf[2] | (buf[3] << 8));
+  return true;
+}
+
+// Stamp the header and trailing CRC around a payload already written at
+// buf + HARVEST_RESP_HDR_SIZE; returns the total frame length to send
+static inline int harvest_resp_finish(uint8_t *buf, uint8_t cmd,
+                                      uint16_t payloadLen) {
+  buf[0] = HARVEST_RESP_SYNC;
+  buf[1] = cmd;
+  buf[2] = (uint8_t)(payloadLen & 0xFF);
+  buf[3] = (uint8_t)(payloadLen >> 8);
+  int end = HARVEST_RESP_HDR_SIZE + payloadLen;
+  buf[end] = lux_frame_crc8(&buf[1], end - 1);
+  return end + 1;
+}
+
+// Host-side: validate a complete response frame (sync, CRC) and expose
+// the payload; buf must hold HARVEST_RESP_HDR_SIZE + len + 1 bytes
+static inline bool harvest_resp_decode(const uint8_t *buf, uint8_t *cmd,
+                                       uint16_t *payloadLen) {
+  if (buf[0] != HARVEST_RESP_SYNC) {
+    return false;
+  }
+  uint16_t len = (uint16_t)(buf[2] | (buf[3] << 8));
+  int end = HARVEST_RESP_HDR_SIZE + len;
+  if (lux_frame_crc8(&buf[1], end - 1) != buf[end]) {
+    return false;
+  }
+  *cmd = buf[1];
+  *payloadLen = len;
+  return true;
+}
+
+#endif
@@ -1,15 +1,224 @@
 #include "InputOutput.h"
+#include <limits.h>
+#include <Preferences.h>
+#include "ChamberClock.h"
+#include "DataLog.h"
+#include "HarvestProto.h"
+#include "MixMatrix.h"
+#include "Replay.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "esp_timer.h"
 
-InputOutput::InputOutput() : lcd(0x27, 16, 2), sw1(false), sw2(false),
-                             potValue(0.0), luxValue(0),
-                             bufferIndex(0), bufferCount(0),
-                             liveMin(0), liveMax(0) {
-  for (int i = 0; i < LUX_BUFFER_SIZE; i++) {
-    luxBuffer[i] = 0;
+// Arduino-core channel numbering: 0-7 live in the high-speed LEDC group
+#define PWM_LEDC_MODE LEDC_HIGH_SPEED_MODE
+
+// Lux-bounds checkpoint: namespace shared with ChamberConfig, saved at most
+// once per period and only when the values moved
+#define BOUNDS_NVS_NAMESPACE "chamber"
+#define BOUNDS_NVS_KEY_MIN "lux_min"
+#define BOUNDS_NVS_KEY_MAX "lux_max"
+#define BOUNDS_SAVE_PERIOD_MS 60000UL
+
+// Light-dose checkpoint: the bucket ring plus the accumulating index in one
+// blob. The chamber never sleeps, so NVS (not RTC memory) is the store that
+// actually survives what kills the state here — a reboot or power cut.
+#define DOSE_NVS_KEY "dose"
+#define DOSE_SAVE_PERIOD_MS 300000UL
+#define DOSE_HOUR_MS 3600000UL
+#define DOSE_BUCKETS 24
+
+// Blob layout for the dose checkpoint (packed, little-endian on this target)
+struct DoseBlob {
+  uint64_t hour[DOSE_BUCKETS];
+  uint8_t idx;
+};
+
+// Divergence monitor tuning. The ratio only means anything when both
+// sensors see real light, so samples below the floor are ignored; the
+// baseline auto-calibrates once after ~1 minute of valid ratios and can be
+// re-pinned any time with the serial "divcal" command.
+#define DIV_NVS_KEY "div_base"
+#define DIV_RATIO_SHIFT 8       // Q8 ratio fixed point
+#define DIV_MIN_FP 160          // 10 lux floor for a meaningful ratio
+#define DIV_EWMA_SHIFT 4        // ~16-sample smoothing on the live ratio
+#define DIV_TOL_PCT 25          // Alarm when ratio drifts past +/-25%
+#define DIV_CAL_SAMPLES 3000    // ~1 minute at 50 Hz before auto-calibration
+#define DIV_LOG_PERIOD_MS 10000UL
+
+// Output continuity across soft resets: the last driven duty of every
+// channel lives in RTC RAM (same magic ^ check discipline as main's
+// ModeState), so a watchdog, panic or intentional reboot re-drives the
+// light first thing in begin() instead of going dark until the next
+// report arrives. Light output is the chamber's uptime metric; a reset
+// should cost the boot time, not a dark gap on top of it. Power-on finds
+// garbage here, fails the check and keeps the usual safe zero.
+struct DutyHold {
+  uint32_t magic;
+  uint32_t lux;
+  uint32_t led[NUM_LED_CHANNELS];
+  uint32_t check;  // magic ^ every duty — rejects partial writes
+};
+#define DUTY_HOLD_MAGIC 0x4C697448UL  // "LitH"
+RTC_NOINIT_ATTR static DutyHold rtcDutyHold;
+
+static uint32_t dutyHoldChecksum() {
+  uint32_t c = DUTY_HOLD_MAGIC ^ rtcDutyHold.lux;
+  for (int i = 0; i < NUM_LED_CHANNELS; i++) {
+    c ^= rtcDutyHold.led[i] + (uint32_t)i;  // position-salted: reordering shows
+  }
+  return c;
+}
+
+static void dutyHoldSeal() {
+  rtcDutyHold.check = dutyHoldChecksum();
+  rtcDutyHold.magic = DUTY_HOLD_MAGIC;
+}
+
+static bool dutyHoldValid() {
+  return rtcDutyHold.magic == DUTY_HOLD_MAGIC &&
+         rtcDutyHold.check == dutyHoldChecksum();
+}
+
+// Interrupt-debounced switches: each edge records the raw level and its
+// time from the ISR; the level commits once it has sat unchanged for the
+// debounce window. File-scope (not members) because ISRs need plain
+// function pointers.
+struct SwitchState {
+  volatile bool rawLevel;
+  volatile unsigned long lastEdgeMs;
+  bool stableLevel;             // Committed outside ISR context only
+};
+static SwitchState sw1State, sw2State;
+static volatile bool switchEventPending = false;
+
+static void IRAM_ATTR onSwitch1Change() {
+  sw1State.rawLevel = digitalRead(SWITCH1_PIN);
+  sw1State.lastEdgeMs = millis();
+  switchEventPending = true;
+}
+
+static void IRAM_ATTR onSwitch2Change() {
+  sw2State.rawLevel = digitalRead(SWITCH2_PIN);
+  sw2State.lastEdgeMs = millis();
+  switchEventPending = true;
+}
+
+// Pot oversampling. GPIO27 is an ADC2 channel, which the ESP32's digital
+// (DMA) controller cannot reach — I2S built-in ADC is ADC1-only — so
+// continuous DMA capture is off the table without a board spin. The next
+// best thing: an esp_timer callback oversamples into a small ring in the
+// timer task, and readAnalog() just scales the published average. Same
+// zero-marginal-cost, pre-averaged read on the control path, minus the
+// DMA engine; 16 samples knock the visible manual-mode jitter down ~4x.
+#define POT_SAMPLE_PERIOD_US 5000
+#define POT_OVERSAMPLE 16
+static uint16_t potRing[POT_OVERSAMPLE];
+static uint8_t potRingIdx = 0;
+static volatile uint32_t potAverage = 0;  // Rolling mean of the ring
+
+static void potSampleCb(void*) {
+  potRing[potRingIdx] = (uint16_t)analogRead(SWITCH3_PIN);
+  potRingIdx = (potRingIdx + 1) % POT_OVERSAMPLE;
+  uint32_t sum = 0;
+  for (int i = 0; i < POT_OVERSAMPLE; i++) {
+    sum += potRing[i];
+  }
+  potAverage = sum / POT_OVERSAMPLE;
+}
+
+// Commit the raw level once the contact has settled; until then the
+// previous stable level stands, so bounce never reaches the control task
+static bool debouncedLevel(SwitchState& s) {
+  if (millis() - s.lastEdgeMs >= SWITCH_DEBOUNCE_MS) {
+    s.stableLevel = s.rawLevel;
   }
+  return s.stableLevel;
+}
+
+InputOutput::InputOutput() : lcd(LCD_ADDR, LCD_COLS, LCD_ROWS), sw1(false), sw2(false),
+                             potValue(0), luxValue(0), lux1Value(0), lux2Value(0),
+                             luxUpdated(false),
+                             medianCount(0), medianIdx(0), ewmaFp(0), ewmaValid(false),
+                             liveMin(0), liveMax(0), lastDuty(0),
+                             restoredBounds(false), restoredMin(0), restoredMax(0),
+                             savedMin(0), savedMax(0), lastBoundsSaveMs(0),
+                             doseHourIdx(0), doseHourStartMs(0), doseEpochHour(0),
+                             lastDoseMs(0),
+                             lastDoseSaveMs(0), savedDoseTotal(0),
+                             ratioFastFp(0), ratioBaseFp(0), ratioSamples(0),
+                             divergenceAlarm(false), lastDivLogMs(0),
+                             luxLoQ(LUX_CLAMP_QUANTILE), luxHiQ(1.0f - LUX_CLAMP_QUANTILE),
+                             rxLen(0), cmdLen(0), latBins(NULL), latBinCount(0),
+                             lastSeq(0), seqValid(false), droppedFrames(0),
+                             glassValid(false),
+                             thermalCapQ16(65536), thermalC(25),
+                             lastThermalMs(0), thermalAlarm(false) {
+  memset(doseHour, 0, sizeof(doseHour));
+  memset(frameBuf, ' ', sizeof(frameBuf));
+  memset(glassBuf, ' ', sizeof(glassBuf));
 }
 
 void InputOutput::begin() {
+  // Runtime config first — the PWM timer frequency below comes from it
+  // (one fast NVS read, no peripherals involved)
+  chamberConfigLoad();
+
+  // Controlled state before anything slow: every LED channel is configured
+  // ahead of serial/I2C/LCD bring-up. A warm reset (watchdog, panic, soft
+  // restart) re-drives the duties the chamber was holding when it died —
+  // the experiment sees the boot time as its only outage — while a
+  // power-on finds RTC garbage and starts at the safe zero.
+  const bool resumeDuties = dutyHoldValid();
+  pinMode(PWM_PIN, OUTPUT);
+  ledcSetup(PWM_CHANNEL, chamberCfg.pwmFreq, PWM_RES_BITS);
+  ledcAttachPin(PWM_PIN, PWM_CHANNEL);
+  ledcWrite(PWM_CHANNEL, resumeDuties ? rtcDutyHold.lux : 0);
+  const uint8_t ledPins[NUM_LED_CHANNELS] = LED_CH_PINS;
+  for (int i = 0; i < NUM_LED_CHANNELS; i++) {
+    ledcSetup(LED_CH_FIRST_LEDC + i, chamberCfg.pwmFreq, PWM_RES_BITS);
+    ledcAttachPin(ledPins[i], LED_CH_FIRST_LEDC + i);
+    ledcWrite(LED_CH_FIRST_LEDC + i, resumeDuties ? rtcDutyHold.led[i] : 0);
+  }
+  if (resumeDuties) {
+    lastDuty = rtcDutyHold.lux;  // display/log continuity with the pads
+  }
+  // The channels are driven again — release any pad holds a pre-reset
+  // latchOutputsForReset() left pinned (no-op after an unplanned reset)
+  gpio_hold_dis((gpio_num_t)PWM_PIN);
+  for (int i = 0; i < NUM_LED_CHANNELS; i++) {
+    gpio_hold_dis((gpio_num_t)ledPins[i]);
+  }
+  ledc_fade_func_install(0);  // fade engine; fade time can be enabled at runtime
+
+  // Restore the last checkpointed lux bounds so clamping protects the rig
+  // from the first sample, not after a minute of unguarded warmup
+  {
+    Preferences prefs;
+    if (prefs.begin(BOUNDS_NVS_NAMESPACE, true)) {
+      if (prefs.isKey(BOUNDS_NVS_KEY_MIN) && prefs.isKey(BOUNDS_NVS_KEY_MAX)) {
+        restoredMin = prefs.getInt(BOUNDS_NVS_KEY_MIN, 0);
+        restoredMax = prefs.getInt(BOUNDS_NVS_KEY_MAX, 0);
+        restoredBounds = (restoredMax >= restoredMin);
+        savedMin = restoredMin;
+        savedMax = restoredMax;
+      }
+      // Resume the dose ledger where the last checkpoint left it, so a
+      // reboot costs at most one save period of accumulated dose
+      ratioBaseFp = prefs.getInt(DIV_NVS_KEY, 0);
+      DoseBlob blob;
+      if (prefs.getBytes(DOSE_NVS_KEY, &blob, sizeof(blob)) == sizeof(blob) &&
+          blob.idx < DOSE_BUCKETS) {
+        memcpy(doseHour, blob.hour, sizeof(doseHour));
+        doseHourIdx = blob.idx;
+        for (int i = 0; i < DOSE_BUCKETS; i++) {
+          savedDoseTotal += blob.hour[i];
+        }
+      }
+      prefs.end();
+    }
+  }
+
   // Serial & I2C Setup
   Serial.begin(UART0_BAUD);
   Wire.begin(LCD_SDA, LCD_SCL);
@@ -19,27 +228,46 @@ void InputOutput::begin() {
   lcd.init();
   lcd.backlight();
   lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("ESP32 Init...");
+
+  // init() cleared the glass, so the shadow copy (all spaces) is accurate
+  glassValid = true;
+  displaySetRow(0, "ESP32 Init...");
+  displayFlush();
 
   // Configure Pins
   pinMode(SWITCH1_PIN, INPUT_PULLUP);
   pinMode(SWITCH2_PIN, INPUT_PULLUP);
-  pinMode(PWM_PIN, OUTPUT);
 
-  // Configure PWM
-  ledcSetup(PWM_CHANNEL, PWM_FREQ, PWM_RES_BITS);
-  ledcAttachPin(PWM_PIN, PWM_CHANNEL);
+  // Switches are interrupt-driven: seed the debounce state from the
+  // current levels, then let edges keep it fresh without any polling
+  sw1State.rawLevel = sw1State.stableLevel = digitalRead(SWITCH1_PIN);
+  sw2State.rawLevel = sw2State.stableLevel = digitalRead(SWITCH2_PIN);
+  attachInterrupt(digitalPinToInterrupt(SWITCH1_PIN), onSwitch1Change, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(SWITCH2_PIN), onSwitch2Change, CHANGE);
 
-  // Setup Complete
-  delay(1000);
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("System Ready");
+  // Seed the pot ring with the current position, then let the periodic
+  // timer keep the oversampled average fresh off the ingestion path
+  uint16_t seed = (uint16_t)analogRead(SWITCH3_PIN);
+  for (int i = 0; i < POT_OVERSAMPLE; i++) {
+    potRing[i] = seed;
+  }
+  potAverage = seed;
+  esp_timer_create_args_t potTimerArgs = {};
+  potTimerArgs.callback = potSampleCb;
+  potTimerArgs.name = "pot_adc";
+  esp_timer_handle_t potTimer;
+  if (esp_timer_create(&potTimerArgs, &potTimer) == ESP_OK) {
+    esp_timer_start_periodic(potTimer, POT_SAMPLE_PERIOD_US);
+  }
+
+  // Setup complete — no blocking banner holds here: the "System Ready"
+  // row is staged and the display task keeps it on the glass for the
+  // banner period while control is already live
+  displaySetRow(0, "System Ready");
+  displayFlush();
   Serial.println("==================");
   Serial.println("   System Ready   ");
   Serial.println("==================");
-  delay(1000);
 }
 
 void InputOutput::update() {
@@ -48,74 +276,782 @@ void InputOutput::update() {
   readUART();
 }
 
+// No GPIO reads at steady state — just commit whatever the ISRs captured
 void InputOutput::readSwitches() {
-  sw1 = digitalRead(SWITCH1_PIN);
-  sw2 = digitalRead(SWITCH2_PIN);
+  sw1 = debouncedLevel(sw1State);
+  sw2 = debouncedLevel(sw2State);
 }
 
+// True once per settled edge, so the ingestion loop can push a snapshot
+// immediately instead of waiting out the input poll cadence
+bool InputOutput::takeSwitchEvent() {
+  if (!switchEventPending) {
+    return false;
+  }
+  unsigned long now = millis();
+  if (now - sw1State.lastEdgeMs < SWITCH_DEBOUNCE_MS ||
+      now - sw2State.lastEdgeMs < SWITCH_DEBOUNCE_MS) {
+    return false;  // still bouncing — report once it settles
+  }
+  switchEventPending = false;
+  return true;
+}
+
+// No ADC access here — just scale the oversampled average the timer
+// callback keeps fresh. Q16.16 straight from the counts; no float on
+// the control path.
 void InputOutput::readAnalog() {
-  potValue = analogRead(SWITCH3_PIN) / 4095.0;
+  potValue = fix16_from_ratio((int32_t)potAverage, 4095);
+  sampleThermal();  // Piggybacks the poll cadence; rate-limits itself
 }
 
+// Heatsink NTC sample plus derating-curve update, at most once per
+// THERMAL_SAMPLE_MS — the heatsink moves over minutes, so 1 Hz is plenty
+// and the float B-parameter conversion never touches a hot path.
+void InputOutput::sampleThermal() {
+  unsigned long now = millis();
+  if (now - lastThermalMs < THERMAL_SAMPLE_MS) {
+    return;
+  }
+  lastThermalMs = now;
+
+  int raw = analogRead(THERMAL_NTC_PIN);
+  if (raw >= 4080) {
+    // Open/unfitted sensor (divider pulled to 3V3): no feedback, no cap —
+    // see the orientation note in Config.h
+    thermalC = -99;
+    thermalCapQ16 = 65536;
+    return;
+  }
+  if (raw < 16) {
+    raw = 16;  // Shorted sensor clamps to "very hot" and derates fully
+  }
+
+  // Divider: R_ntc = R_series * raw / (4095 - raw), then the B-parameter
+  // equation against the 25 C reference
+  float rNtc = (float)THERMAL_NTC_SERIES_OHM * raw / (4095.0f - raw);
+  float invT = 1.0f / 298.15f +
+               logf(rNtc / THERMAL_NTC_R25_OHM) / THERMAL_NTC_BETA;
+  thermalC = (int)(1.0f / invT - 273.15f);
+
+  // Linear derating curve, then slew-limit the applied cap so the light
+  // glides down (or back up) instead of stepping with each sample
+  uint32_t target;
+  if (thermalC <= THERMAL_DERATE_START_C) {
+    target = 65536;
+  } else if (thermalC >= THERMAL_DERATE_END_C) {
+    target = (65536UL * THERMAL_FLOOR_PCT) / 100;
+  } else {
+    uint32_t floorQ16 = (65536UL * THERMAL_FLOOR_PCT) / 100;
+    target = 65536 - ((65536 - floorQ16) *
+                      (uint32_t)(thermalC - THERMAL_DERATE_START_C)) /
+                         (THERMAL_DERATE_END_C - THERMAL_DERATE_START_C);
+  }
+  if (target > thermalCapQ16 + THERMAL_SLEW_Q16) {
+    thermalCapQ16 += THERMAL_SLEW_Q16;
+  } else if (target + THERMAL_SLEW_Q16 < thermalCapQ16) {
+    thermalCapQ16 -= THERMAL_SLEW_Q16;
+  } else {
+    thermalCapQ16 = target;
+  }
+
+  bool active = thermalCapQ16 < 65536;
+  if (active != thermalAlarm) {
+    thermalAlarm = active;
+    Serial.printf("thermal: %s at %d C (duty cap %lu%%)\n",
+                  active ? "derating ENGAGED" : "derating released", thermalC,
+                  (unsigned long)((thermalCapQ16 * 100UL) >> 16));
+  }
+}
+
+uint32_t InputOutput::thermalApply(uint32_t duty) {
+  if (thermalCapQ16 >= 65536) {
+    return duty;
+  }
+  return (uint32_t)(((uint64_t)duty * thermalCapQ16) >> 16);
+}
+
+int InputOutput::getThermalC() { return thermalC; }
+uint32_t InputOutput::getThermalCapPct() {
+  return (uint32_t)((thermalCapQ16 * 100UL) >> 16);
+}
+
+// Non-blocking, allocation-free lux ingestion: drain whatever bytes have
+// arrived into a fixed frame buffer and decode on the 7th byte. On a sync
+// or CRC mismatch the buffer slides one byte to resynchronize; sequence
+// gaps count dropped frames without ever stalling the control loop.
 void InputOutput::readUART() {
-  if (Serial.available()) {
-    String line = Serial.readStringUntil('\n');
-    line.trim();
-    luxValue = line.toFloat();
+  while (Serial.available() > 0) {
+    ingestByte((uint8_t)Serial.read());
+  }
+}
+
+// Frame bytes from a non-UART transport (ESP-NOW) run through the exact
+// same assembler, so sync hunting, sequence accounting and the command
+// collector behave identically regardless of how the bytes arrived
+void InputOutput::ingestBytes(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    ingestByte(data[i]);
+  }
+}
+
+void InputOutput::ingestByte(uint8_t b) {
+  // Hunt for a sync byte before collecting a frame. Printable bytes in
+  // the gaps are command text (neither sync byte is printable, so the
+  // streams cannot be confused); a newline completes and dispatches it.
+  if (rxLen == 0 && b != LUX_FRAME_SYNC && b != LUX_BATCH_SYNC &&
+      b != HARVEST_REQ_SYNC) {
+    if (b == '\n' || b == '\r') {
+      if (cmdLen > 0) {
+        cmdBuf[cmdLen] = '\0';
+        handleCommandLine();
+        cmdLen = 0;
+      }
+    } else if (b >= 0x20 && b < 0x7F && cmdLen < sizeof(cmdBuf) - 1) {
+      cmdBuf[cmdLen++] = (char)b;
+    }
+    return;
+  }
+  rxFrame[rxLen++] = b;
+
+  // Frame length depends on the type: fixed for single-sample frames and
+  // harvest requests, count-dependent for batches (known once the header
+  // is in)
+  uint8_t need = LUX_FRAME_SIZE;
+  if (rxFrame[0] == HARVEST_REQ_SYNC) {
+    need = HARVEST_REQ_SIZE;
+  } else if (rxFrame[0] == LUX_BATCH_SYNC) {
+    if (rxLen < LUX_BATCH_HDR_SIZE) {
+      return;
+    }
+    uint8_t count = rxFrame[2];
+    if (count == 0 || count > LUX_BATCH_MAX_SAMPLES) {
+      droppedFrames++;
+      resyncFrame(rxLen);  // bogus count — treat as line noise
+      return;
+    }
+    need = LUX_BATCH_FRAME_SIZE(count);
+  }
+  if (rxLen < need) {
+    return;
+  }
+  rxLen = 0;
+
+  if (rxFrame[0] == HARVEST_REQ_SYNC) {
+    uint8_t cmd;
+    uint16_t arg;
+    if (!harvest_req_decode(rxFrame, &cmd, &arg)) {
+      droppedFrames++;
+      resyncFrame(HARVEST_REQ_SIZE);
+      return;
+    }
+    handleHarvestRequest(cmd, arg);
+  } else if (rxFrame[0] == LUX_FRAME_SYNC) {
+    lux_sample_t sample;
+    if (!lux_frame_decode(rxFrame, &sample)) {
+      droppedFrames++;
+      resyncFrame(LUX_FRAME_SIZE);
+      return;
+    }
+    if (seqValid) {
+      droppedFrames += (uint8_t)(sample.seq - lastSeq - 1);
+    }
+    lastSeq = sample.seq;
+    seqValid = true;
+    dataLogRecord(DATALOG_REC_LUX, rxFrame, LUX_FRAME_SIZE);
+    applyLuxSample(sample.lux1_fp, sample.lux2_fp);
+  } else {
+    lux_batch_t batch;
+    if (!lux_batch_decode(rxFrame, &batch)) {
+      droppedFrames++;
+      resyncFrame(need);
+      return;
+    }
+    if (seqValid) {
+      droppedFrames += (uint8_t)(batch.seq - lastSeq - 1);
+    }
+    lastSeq = batch.seq;
+    seqValid = true;
+    dataLogRecord(DATALOG_REC_LUX, rxFrame, need);
+    // Samples run through the filter in capture order, so the pipeline
+    // sees the same stream it would have per-frame, just later
+    for (int i = 0; i < batch.count; i++) {
+      applyLuxSample(batch.lux1_fp[i], batch.lux2_fp[i]);
+    }
+  }
+}
+
+// Corrupt frame — slide one byte so a sync byte inside the garbage still
+// lets us lock back on, then trim leading non-sync bytes
+void InputOutput::resyncFrame(uint8_t len) {
+  memmove(rxFrame, rxFrame + 1, len - 1);
+  rxLen = len - 1;
+  while (rxLen > 0 && rxFrame[0] != LUX_FRAME_SYNC &&
+         rxFrame[0] != LUX_BATCH_SYNC && rxFrame[0] != HARVEST_REQ_SYNC) {
+    memmove(rxFrame, rxFrame + 1, --rxLen);
+  }
+}
+
+// One decoded sample pair into the pipeline. A module sensor that is down
+// streams LUX_FP_INVALID in its slot; average whatever is valid, and skip
+// the light update entirely when both sensors are out.
+void InputOutput::applyLuxSample(uint16_t fp1, uint16_t fp2) {
+  bool valid1 = fp1 != LUX_FP_INVALID;
+  bool valid2 = fp2 != LUX_FP_INVALID;
+  lux1Value = valid1 ? (fp1 >> LUX_FIXED_SHIFT) : -1;
+  lux2Value = valid2 ? (fp2 >> LUX_FIXED_SHIFT) : -1;
+  if (valid1 && valid2) {
+    updateDivergence(fp1, fp2);
+  }
+  if (!valid1 && !valid2) {
+    return;
+  }
+  int raw;
+  if (valid1 && valid2) {
+    raw = (int)(((uint32_t)fp1 + fp2) >> (LUX_FIXED_SHIFT + 1));
+  } else if (valid1) {
+    raw = fp1 >> LUX_FIXED_SHIFT;
+  } else {
+    raw = fp2 >> LUX_FIXED_SHIFT;
+  }
+  luxValue = filterLux(raw);
+  luxUpdated = true;
+}
+
+// Filter pipeline between ingestion and the PWM. The CRC catches corrupt
+// frames, but a valid frame carrying a sensor glitch still lands inside
+// historical bounds and would reach the LEDs; a median-of-3 discards any
+// single-sample spike (a real change just arrives one sample late), and an
+// integer EWMA in Q4 smooths line noise below the flicker threshold. With
+// LUX_EWMA_SHIFT 0 the smoothing stage passes through untouched.
+int InputOutput::filterLux(int rawLux) {
+  medianBuf[medianIdx] = rawLux;
+  medianIdx = (medianIdx + 1) % 3;
+  if (medianCount < 3) {
+    medianCount++;
+  }
+
+  int med = rawLux;  // Warmup: pass raw through until the window fills
+  if (medianCount == 3) {
+    int a = medianBuf[0], b = medianBuf[1], c = medianBuf[2];
+    med = max(min(a, b), min(max(a, b), c));
   }
+
+  if (chamberCfg.luxEwmaShift == 0) {
+    return med;
+  }
+  if (!ewmaValid) {
+    ewmaFp = (int32_t)med << 4;
+    ewmaValid = true;
+  } else {
+    ewmaFp += (((int32_t)med << 4) - ewmaFp) >> chamberCfg.luxEwmaShift;
+  }
+  return (int)(ewmaFp >> 4);
+}
+
+// Dispatch one completed command line:
+//   cfg                 print every key and its current value
+//   cfg <key> <value>   validate, apply and persist
+//   dose                print the 24 hourly dose buckets and day total
+//   stats               print mean/min/max over the last second/minute/hour
+//   divcal              re-pin the divergence baseline to the current ratio
+//   replay <accel>      replay the datalog at accel x ("replay stop" ends it)
+void InputOutput::handleCommandLine() {
+  if (strncmp(cmdBuf, "replay", 6) == 0) {
+    unsigned long accel;
+    if (strstr(cmdBuf, "stop") != NULL) {
+      replayStop();
+      Serial.println("replay: stop requested");
+    } else if (sscanf(cmdBuf, "replay %lu", &accel) == 1 &&
+               accel >= 1 && accel <= REPLAY_ACCEL_MAX) {
+      Serial.println(replayStart((uint32_t)accel)
+                         ? "replay: started"
+                         : "replay: already running (or no datalog)");
+    } else {
+      Serial.printf("replay: usage 'replay <1-%d>' or 'replay stop'\n",
+                    REPLAY_ACCEL_MAX);
+    }
+    return;
+  }
+  if (strncmp(cmdBuf, "divcal", 6) == 0) {
+    if (ratioSamples == 0) {
+      Serial.println("divcal: no valid ratio yet");
+    } else {
+      saveDivergenceBaseline(ratioFastFp);
+      Serial.printf("divcal: baseline %.3f saved\n", ratioBaseFp / 256.0f);
+    }
+    return;
+  }
+  if (strncmp(cmdBuf, "stats", 5) == 0) {
+    // Each window is a handful of aggregate merges, not a history rescan
+    LuxAgg s = luxStats.overSeconds(1);
+    LuxAgg m = luxStats.overMinutes(1);
+    LuxAgg h = luxStats.overHours(1);
+    Serial.printf("stats: 1s %d (%d/%d) n=%lu | 1m %d (%d/%d) n=%lu | 1h %d (%d/%d) n=%lu\n",
+                  s.mean(), s.count ? s.minV : 0, s.count ? s.maxV : 0, s.count,
+                  m.mean(), m.count ? m.minV : 0, m.count ? m.maxV : 0, m.count,
+                  h.mean(), h.count ? h.minV : 0, h.count ? h.maxV : 0, h.count);
+    return;
+  }
+  if (strncmp(cmdBuf, "dose", 4) == 0) {
+    Serial.printf("dose: day %lu lux-h, buckets (lux-h, newest first):",
+                  getDoseDayLuxHours());
+    for (int i = 0; i < DOSE_BUCKETS; i++) {
+      int idx = (doseHourIdx + DOSE_BUCKETS - i) % DOSE_BUCKETS;
+      Serial.printf(" %lu", (unsigned long)(doseHour[idx] / DOSE_HOUR_MS));
+    }
+    Serial.println();
+    return;
+  }
+  if (strncmp(cmdBuf, "cfg", 3) != 0) {
+    return;  // not ours — likely line noise between frames
+  }
+
+  char key[16];
+  unsigned long value;
+  int parsed = sscanf(cmdBuf, "cfg %15s %lu", key, &value);
+  if (parsed <= 0) {
+    Serial.print(chamberConfigToString());
+  } else if (parsed == 2 && chamberConfigApply(key, (uint32_t)value)) {
+    Serial.printf("cfg: %s=%lu saved\n", key, value);
+  } else {
+    Serial.println("cfg: unknown key or value out of range");
+  }
+}
+
+void InputOutput::setLatencyHist(const volatile unsigned long* bins,
+                                 uint8_t count) {
+  latBins = bins;
+  latBinCount = count;
 }
 
-void InputOutput::setPWM(float pwmValue) {
-  ledcWrite(PWM_CHANNEL, pwmValue);
+// Little-endian field packing for harvest payloads
+static int packU32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+  return 4;
 }
 
-String InputOutput::toString() {
-  String result = "[Switches] S1=";
-  result += (sw1 ? "HIGH" : "LOW ");
-  result += " S2=";
-  result += (sw2 ? "HIGH" : "LOW ");
-  result += " | [Analog] ";
-  result += String(potValue);
-  result += " | [Lux] ";
-  result += String(luxValue);
-  return result;
+// Answer one validated binary request (layouts in HarvestProto.h). Runs
+// in the ingestion task between frames; every response is a bounded
+// memcpy-and-write, so the lux stream never stalls behind a harvest.
+// Unknown commands get an empty payload so the host can tell old
+// firmware from a dropped request.
+void InputOutput::handleHarvestRequest(uint8_t cmd, uint16_t arg) {
+  static uint8_t resp[HARVEST_RESP_MAX];
+  uint8_t* p = resp + HARVEST_RESP_HDR_SIZE;
+  uint16_t len = 0;
+
+  switch (cmd) {
+    case HARVEST_CMD_BOUNDS: {
+      int lo, hi;
+      getClampBounds(lo, hi);
+      len += packU32(p + len, (uint32_t)lo);
+      len += packU32(p + len, (uint32_t)hi);
+      len += packU32(p + len, (uint32_t)restoredMin);
+      len += packU32(p + len, (uint32_t)restoredMax);
+      p[len++] = restoredBounds ? 1 : 0;
+      break;
+    }
+    case HARVEST_CMD_DOSE: {
+      len += packU32(p + len, (uint32_t)getDoseDayLuxHours());
+      p[len++] = DOSE_BUCKETS;
+      for (int i = 0; i < DOSE_BUCKETS; i++) {
+        int idx = (doseHourIdx + DOSE_BUCKETS - i) % DOSE_BUCKETS;
+        len += packU32(p + len, (uint32_t)(doseHour[idx] / DOSE_HOUR_MS));
+      }
+      break;
+    }
+    case HARVEST_CMD_LATHIST: {
+      p[len++] = latBinCount;
+      for (uint8_t i = 0; i < latBinCount; i++) {
+        len += packU32(p + len, (uint32_t)latBins[i]);
+      }
+      break;
+    }
+    case HARVEST_CMD_LOG_PAGE:
+      len = (uint16_t)dataLogReadPage(arg, p, HARVEST_LOG_PAGE_BYTES);
+      break;
+    default:
+      break;  // empty payload
+  }
+
+  int total = harvest_resp_finish(resp, cmd, len);
+  Serial.write(resp, total);
+}
+
+// Track the direct/diffused sensor ratio and compare it to the calibrated
+// baseline. The averaged signal hides a drifting sensor almost perfectly
+// (a 30% fouled dome moves the average 15% but the ratio 30%), so the
+// ratio is the statistic that catches degradation within minutes.
+void InputOutput::updateDivergence(uint16_t fp1, uint16_t fp2) {
+  if (fp1 < DIV_MIN_FP || fp2 < DIV_MIN_FP) {
+    return;  // too dark for the ratio to mean anything
+  }
+
+  int32_t r = (int32_t)(((uint32_t)fp1 << DIV_RATIO_SHIFT) / fp2);
+  if (ratioSamples == 0) {
+    ratioFastFp = r;
+  } else {
+    ratioFastFp += (r - ratioFastFp) >> DIV_EWMA_SHIFT;
+  }
+  ratioSamples++;
+
+  // First calibration happens by itself once the EWMA has had a minute of
+  // valid light to settle; after that the stored baseline is authoritative
+  // until a "divcal" re-pins it
+  if (ratioBaseFp == 0) {
+    if (ratioSamples >= DIV_CAL_SAMPLES) {
+      saveDivergenceBaseline(ratioFastFp);
+      Serial.printf("div: baseline calibrated, ratio %.3f\n",
+                    ratioBaseFp / 256.0f);
+    }
+    return;
+  }
+
+  int32_t lo = ratioBaseFp * (100 - DIV_TOL_PCT) / 100;
+  int32_t hi = ratioBaseFp * (100 + DIV_TOL_PCT) / 100;
+  bool outside = (ratioFastFp < lo || ratioFastFp > hi);
+  if (outside && !divergenceAlarm) {
+    divergenceAlarm = true;
+  } else if (!outside && divergenceAlarm) {
+    divergenceAlarm = false;
+    Serial.println("div: ratio back within tolerance");
+  }
+  if (divergenceAlarm && millis() - lastDivLogMs >= DIV_LOG_PERIOD_MS) {
+    lastDivLogMs = millis();
+    Serial.printf("div: ALARM ratio %.3f vs baseline %.3f — check sensor domes\n",
+                  ratioFastFp / 256.0f, ratioBaseFp / 256.0f);
+  }
+}
+
+void InputOutput::saveDivergenceBaseline(int32_t baseFp) {
+  ratioBaseFp = baseFp;
+  divergenceAlarm = false;
+  Preferences prefs;
+  if (prefs.begin(BOUNDS_NVS_NAMESPACE, false)) {
+    prefs.putInt(DIV_NVS_KEY, baseFp);
+    prefs.end();
+  }
+}
+
+bool InputOutput::takeLuxUpdate() {
+  bool updated = luxUpdated;
+  luxUpdated = false;
+  return updated;
+}
+
+void InputOutput::setPWM(uint32_t duty) {
+  lastDuty = duty;  // keep the requested target; the cap below may shrink what's driven
+  duty = thermalApply(duty);
+  if (chamberCfg.pwmFadeMs > 0) {
+    // Let the LEDC peripheral interpolate from the current duty to the new
+    // target over the fade time: each control update becomes a smooth ramp
+    // instead of a hard step, with zero CPU cost. Starting a new fade simply
+    // retargets from wherever the previous one got to.
+    ledc_set_fade_with_time(PWM_LEDC_MODE, (ledc_channel_t)PWM_CHANNEL,
+                            duty, chamberCfg.pwmFadeMs);
+    ledc_fade_start(PWM_LEDC_MODE, (ledc_channel_t)PWM_CHANNEL, LEDC_FADE_NO_WAIT);
+  } else {
+    ledcWrite(PWM_CHANNEL, duty);
+  }
+  rtcDutyHold.lux = duty;  // what's driven (post-cap), so a reset resumes it
+  dutyHoldSeal();
+}
+
+// Q12 channel-mixing matrix: one row per LED strip, one column per report
+// channel in wire order (f1 f2 fz f3 f4 f5 fy f6 fxl f7 f8 nir clear).
+// Generated at compile time from the band/emitter overlap model in
+// MixMatrix.h — the constructor runs entirely in the compiler and the
+// result is flash-resident data, exactly like the hand-written table it
+// replaces. Each row sums to exactly 4096, so a flat spectrum maps to
+// the same drive level on every strip.
+static constexpr MixEmitter LED_EMITTERS[NUM_LED_CHANNELS] = LED_EMITTER_TABLE;
+static constexpr MixMatrix<NUM_LED_CHANNELS, NUM_SRC_CHANNELS, MIX_SHIFT>
+    MIX(LED_EMITTERS, AS7343_BANDS);
+static_assert(MIX.rowSum(0) == (1u << MIX_SHIFT) &&
+              MIX.rowSum(NUM_LED_CHANNELS - 1) == (1u << MIX_SHIFT),
+              "mix rows must sum to one full scale");
+
+// Mix the 13 report channels onto the LED strips and latch every strip in
+// the same PWM period: duties are staged with ledc_set_duty (which does not
+// take effect until an update), then the updates fire back-to-back so all
+// channels apply at the same period overflow — no inter-strip spectral skew.
+void InputOutput::setSpectralPWM(const uint16_t src[NUM_SRC_CHANNELS]) {
+  uint32_t duty[NUM_LED_CHANNELS];
+  for (int led = 0; led < NUM_LED_CHANNELS; led++) {
+    uint32_t acc = 0;
+    for (int s = 0; s < NUM_SRC_CHANNELS; s++) {
+      acc += (uint32_t)MIX.w[led][s] * src[s];
+    }
+    uint32_t mixed = acc >> MIX_SHIFT;  // back to the 16-bit source range
+    // Per-chamber drive scale: the report is a shared broadcast, so each
+    // chamber compensates its own strip efficiency and optical path here
+    mixed = (mixed * chamberCfg.spectralScale) / 100u;
+    if (mixed > 65535u) mixed = 65535u;  // scale >100% can push past full scale
+    duty[led] = (mixed * (uint32_t)MAX_PWM_VALUE) / 65535u;
+    if (duty[led] > MAX_PWM_VALUE) duty[led] = MAX_PWM_VALUE;
+    duty[led] = thermalApply(duty[led]);  // scale uniformly, preserving the spectrum
+  }
+
+  for (int led = 0; led < NUM_LED_CHANNELS; led++) {
+    ledc_set_duty(PWM_LEDC_MODE, (ledc_channel_t)(LED_CH_FIRST_LEDC + led), duty[led]);
+  }
+  for (int led = 0; led < NUM_LED_CHANNELS; led++) {
+    ledc_update_duty(PWM_LEDC_MODE, (ledc_channel_t)(LED_CH_FIRST_LEDC + led));
+  }
+
+  for (int led = 0; led < NUM_LED_CHANNELS; led++) {
+    rtcDutyHold.led[led] = duty[led];
+  }
+  dutyHoldSeal();
+}
+
+// Pin every LED pad ahead of an intentional reset (OTA, serial restart): a
+// GPIO hold survives a soft reset but can only freeze a rail, not a 14-bit
+// duty, so each channel is first parked at its nearer rail — deterministic,
+// instead of whatever PWM phase the reset happens to catch — for the few
+// hundred milliseconds the reboot takes. begin() then re-drives the true
+// duty from the RTC copy and releases the holds.
+void InputOutput::latchOutputsForReset() {
+  const uint8_t ledPins[NUM_LED_CHANNELS] = LED_CH_PINS;
+  ledcDetachPin(PWM_PIN);
+  pinMode(PWM_PIN, OUTPUT);
+  digitalWrite(PWM_PIN, rtcDutyHold.lux >= MAX_PWM_VALUE / 2 ? HIGH : LOW);
+  gpio_hold_en((gpio_num_t)PWM_PIN);
+  for (int i = 0; i < NUM_LED_CHANNELS; i++) {
+    ledcDetachPin(ledPins[i]);
+    pinMode(ledPins[i], OUTPUT);
+    digitalWrite(ledPins[i],
+                 rtcDutyHold.led[i] >= MAX_PWM_VALUE / 2 ? HIGH : LOW);
+    gpio_hold_en((gpio_num_t)ledPins[i]);
+  }
+}
+
+// Differential LCD rendering: callers stage rows into a 16x2 frame buffer,
+// and displayFlush() diffs it against a shadow copy of the glass, sending
+// only the runs of cells that actually changed. A typical update (one
+// number changing) costs a handful of I2C writes instead of a full
+// clear-and-repaint, so there is no flicker and far less time blocked on I2C.
+void InputOutput::displaySetRow(uint8_t row, const char* text) {
+  if (row >= LCD_ROWS) return;
+  uint8_t col = 0;
+  for (; col < LCD_COLS && text[col] != '\0'; col++) {
+    frameBuf[row][col] = text[col];
+  }
+  for (; col < LCD_COLS; col++) {
+    frameBuf[row][col] = ' ';
+  }
+}
+
+void InputOutput::displayFlush() {
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    uint8_t col = 0;
+    while (col < LCD_COLS) {
+      if (glassValid && frameBuf[row][col] == glassBuf[row][col]) {
+        col++;
+        continue;
+      }
+
+      // Start of a dirty run: one cursor move, then consecutive writes
+      lcd.setCursor(col, row);
+      while (col < LCD_COLS &&
+             (!glassValid || frameBuf[row][col] != glassBuf[row][col])) {
+        lcd.write((uint8_t)frameBuf[row][col]);
+        glassBuf[row][col] = frameBuf[row][col];
+        col++;
+      }
+    }
+  }
+  glassValid = true;
+}
+
+// Status line in a static buffer — called once per log period, and the
+// next call overwrites the previous line
+const char* InputOutput::toString() {
+  static char buf[176];
+  snprintf(buf, sizeof(buf),
+           "[Switches] S1=%s S2=%s | [Analog] %.2f | [Lux] %d (%d/%d) | [Dropped] %lu | [Div] %.2f%s | [Therm] %dC%s",
+           sw1 ? "HIGH" : "LOW ", sw2 ? "HIGH" : "LOW ",
+           potValue / 65536.0f, luxValue, lux1Value, lux2Value, droppedFrames,
+           ratioFastFp / 256.0f, divergenceAlarm ? " ALARM" : "",
+           thermalC, thermalAlarm ? " CAP" : "");
+  return buf;
 }
 
 // IO methods
 bool InputOutput::getSwitch1() { return sw1; }
 bool InputOutput::getSwitch2() { return sw2; }
-float InputOutput::getAnalogValue() { return potValue; }
+fix16_t InputOutput::getAnalogValue() { return potValue; }
 int InputOutput::getLuxValue() { return luxValue; }
-LiquidCrystal_I2C InputOutput::getLCD() { return lcd; }
+int InputOutput::getLux1Value() { return lux1Value; }
+int InputOutput::getLux2Value() { return lux2Value; }
+unsigned long InputOutput::getDroppedFrames() { return droppedFrames; }
+
+// Bounds buffer methods — the monotonic-deque machinery lives in
+// SlidingMinMax (shared with the host test harness); this just pushes and
+// refreshes the cached bounds
+void InputOutput::updateBounds(int rawLux) {
+  luxWindow.push(rawLux);
+  liveMin = luxWindow.minValue();
+  liveMax = luxWindow.maxValue();
+}
+
+// Checkpoint the live bounds so the next boot starts protected. At most
+// one NVS write per period, skipped entirely when nothing moved; the write
+// itself is a few ms, which a once-a-minute cadence keeps invisible.
+void InputOutput::checkpointBounds(int lo, int hi) {
+  unsigned long now = millis();
+  if (now - lastBoundsSaveMs < BOUNDS_SAVE_PERIOD_MS) {
+    return;
+  }
+  lastBoundsSaveMs = now;
+  if (lo == savedMin && hi == savedMax) {
+    return;
+  }
+
+  Preferences prefs;
+  if (prefs.begin(BOUNDS_NVS_NAMESPACE, false)) {
+    prefs.putInt(BOUNDS_NVS_KEY_MIN, lo);
+    prefs.putInt(BOUNDS_NVS_KEY_MAX, hi);
+    prefs.end();
+    savedMin = lo;
+    savedMax = hi;
+  }
+}
 
-// Bounds buffer methods
-void InputOutput::updateBounds() {
-  if (bufferCount == 0) return;
+uint32_t InputOutput::getPWMDuty() {
+  return lastDuty;
+}
 
-  liveMin = luxBuffer[0];
-  liveMax = luxBuffer[0];
-  for (int i = 1; i < bufferCount; i++) {
-    if (luxBuffer[i] < liveMin) liveMin = luxBuffer[i];
-    if (luxBuffer[i] > liveMax) liveMax = luxBuffer[i];
+// The bounds getClampedLux would apply right now, without pushing a
+// sample: percentile estimators once the live window has filled (deque
+// extremes if they ever cross), the NVS checkpoint during warmup, and
+// wide open (0, INT_MAX) when neither exists yet. Read-only mirror of the
+// clamp logic below, for the status paths.
+void InputOutput::getClampBounds(int& lo, int& hi) {
+  if (!luxWindow.full()) {
+    lo = restoredBounds ? restoredMin : 0;
+    hi = restoredBounds ? restoredMax : INT_MAX;
+    return;
+  }
+  lo = (int)luxLoQ.value();
+  hi = (int)luxHiQ.value();
+  if (hi < lo) {
+    lo = liveMin;
+    hi = liveMax;
   }
 }
 
 int InputOutput::getClampedLux(int rawLux) {
-  // Add raw value to buffer (so system can adapt to real changes)
-  luxBuffer[bufferIndex] = rawLux;
-  bufferIndex = (bufferIndex + 1) % LUX_BUFFER_SIZE;
-  if (bufferCount < LUX_BUFFER_SIZE) bufferCount++;
+  // Add raw value to window and refresh bounds (so system can adapt to real changes)
+  updateBounds(rawLux);
+  luxStats.push(rawLux, millis());
+  luxLoQ.add((float)rawLux);
+  luxHiQ.add((float)rawLux);
 
-  // Update min/max bounds from buffer
-  updateBounds();
+  int clamped = rawLux;
+  if (!luxWindow.full()) {
+    // Warmup: until the live window fills, fall back to the bounds
+    // checkpointed before the reboot rather than passing raw values through
+    if (restoredBounds) {
+      if (rawLux < restoredMin) clamped = restoredMin;
+      else if (rawLux > restoredMax) clamped = restoredMax;
+    }
+  } else {
+    // Percentile bounds instead of raw min/max: a spike that slipped past
+    // the median filter nudges the 95th percentile slightly instead of
+    // owning the max slot until it ages out of the window. Fall back to
+    // the deque extremes if the estimators ever cross.
+    int lo = (int)luxLoQ.value();
+    int hi = (int)luxHiQ.value();
+    if (hi < lo) {
+      lo = liveMin;
+      hi = liveMax;
+    }
+    checkpointBounds(lo, hi);
+    if (rawLux < lo) clamped = lo;
+    else if (rawLux > hi) clamped = hi;
+  }
 
-  // First minute: no clamping, just return raw value
-  if (bufferCount < LUX_BUFFER_SIZE) {
-    return rawLux;
+  // The clamped value is what actually drives the lights, so it is also
+  // what the dose ledger integrates
+  accumulateDose(clamped);
+  return clamped;
+}
+
+// Integrate clamped lux over the elapsed wall time into the current hour
+// bucket — one multiply-add per sample, versus hours of log post-processing
+// to reconstruct the same number after the fact. Rotating into a fresh
+// bucket every hour keeps the ring a rolling 24-hour ledger.
+void InputOutput::accumulateDose(int clampedLux) {
+  unsigned long now = millis();
+  if (doseHourStartMs == 0) {
+    doseHourStartMs = now;  // First sample opens the first hour
+  }
+  if (lastDoseMs != 0 && clampedLux > 0) {
+    doseHour[doseHourIdx] += (uint64_t)clampedLux * (now - lastDoseMs);
   }
+  lastDoseMs = now;
+
+  // Bucket rotation: once the disciplined clock has synced, buckets close
+  // on wall-clock hour boundaries so the ledger lines up with the
+  // satellite's unix_time column without resampling (the bucket in flight
+  // when sync first lands simply closes short at the next boundary).
+  // Before sync — and forever if no satellite is heard — the original
+  // uptime-based rotation applies.
+  if (clockSynced()) {
+    uint32_t epochHour = (uint32_t)(clockEpochMs() / DOSE_HOUR_MS);
+    if (doseEpochHour != 0 && epochHour != doseEpochHour) {
+      doseHourStartMs = now;
+      doseHourIdx = (doseHourIdx + 1) % DOSE_BUCKETS;
+      doseHour[doseHourIdx] = 0;  // The slot falling out of the 24h window
+    }
+    doseEpochHour = epochHour;
+  } else if (now - doseHourStartMs >= DOSE_HOUR_MS) {
+    doseHourStartMs = now;
+    doseHourIdx = (doseHourIdx + 1) % DOSE_BUCKETS;
+    doseHour[doseHourIdx] = 0;  // The slot falling out of the 24h window
+  }
+
+  // Checkpoint the ledger on the same discipline as the bounds: at most
+  // one write per period, skipped when nothing accumulated
+  if (now - lastDoseSaveMs < DOSE_SAVE_PERIOD_MS) {
+    return;
+  }
+  lastDoseSaveMs = now;
+
+  uint64_t total = 0;
+  for (int i = 0; i < DOSE_BUCKETS; i++) {
+    total += doseHour[i];
+  }
+  if (total == savedDoseTotal) {
+    return;
+  }
+
+  Preferences prefs;
+  if (prefs.begin(BOUNDS_NVS_NAMESPACE, false)) {
+    DoseBlob blob;
+    memcpy(blob.hour, doseHour, sizeof(blob.hour));
+    blob.idx = doseHourIdx;
+    prefs.putBytes(DOSE_NVS_KEY, &blob, sizeof(blob));
+    prefs.end();
+    savedDoseTotal = total;
+  }
+}
+
+// Dose readouts in lux-hours (lux·ms / 3.6e6) — coarse enough to fit the
+// LCD and the log line, while the ledger keeps full resolution internally
+unsigned long InputOutput::getDoseDayLuxHours() {
+  uint64_t total = 0;
+  for (int i = 0; i < DOSE_BUCKETS; i++) {
+    total += doseHour[i];
+  }
+  return (unsigned long)(total / DOSE_HOUR_MS);
+}
 
-  // Clamp to bounds
-  if (rawLux < liveMin) return liveMin;
-  if (rawLux > liveMax) return liveMax;
-  return rawLux;
+unsigned long InputOutput::getDoseHourLuxHours() {
+  return (unsigned long)(doseHour[doseHourIdx] / DOSE_HOUR_MS);
 }
\ No newline at end of file
@@ -6,37 +6,153 @@
 #include <LiquidCrystal_I2C.h>
 #include <string>
 #include "Config.h"
+#include "ChamberConfig.h"
+#include "FixPoint.h"
+#include "LuxFrame.h"
+#include "LuxStats.h"
+#include "P2Quantile.h"
+#include "RingBuffer.h"
+#include "SlidingMinMax.h"
 
 class InputOutput {
 public:
   InputOutput();
   void begin();             // Setup the IO components
-  void update();            // Updates input variables
+  void update();            // Updates all input variables at once
+  void readSwitches();      // Commit debounced interrupt state to sw1 & sw2
+  bool takeSwitchEvent();   // True once per settled switch edge
+  void readAnalog();        // Update potValue
+  void readUART();          // Update luxValue from serial
+  void ingestBytes(const uint8_t* data, size_t len); // Same assembler, other transports
+  bool takeLuxUpdate();     // True once per freshly received lux sample
   bool getSwitch1();        // Get sw1 state {HIGH, LOW}
   bool getSwitch2();        // Get sw2 state {HIGH, LOW}
-  float getAnalogValue();   // Get potValue [0,1]
-  int getLuxValue();        // Get luxValue [0,MAX)
+  fix16_t getAnalogValue(); // Get potValue, Q16.16 in [0, FIX16_ONE]
+  int getLuxValue();        // Get averaged luxValue [0,MAX)
+  int getLux1Value();       // Get sensor-1 lux from the last frame
+  int getLux2Value();       // Get sensor-2 lux from the last frame
+  unsigned long getDroppedFrames(); // Frames lost or corrupt since boot
   int getClampedLux(int rawLux); // Get lux clamped to 1-min bounds
-  LiquidCrystal_I2C getLCD();    // Get lcd object
-  void setPWM(float pwmValue);   // Set PWM duty cycle [0,1]
-  String toString();        // Return string representation
+  unsigned long getDoseDayLuxHours();  // Rolling-24h light dose (lux-hours)
+  unsigned long getDoseHourLuxHours(); // Current hour bucket (lux-hours)
+  void displaySetRow(uint8_t row, const char* text); // Stage a row (padded/truncated)
+  void displayFlush();           // Send only changed cells to the glass
+  void setPWM(uint32_t duty);    // Set PWM duty counts [0, MAX_PWM_VALUE]
+  uint32_t getPWMDuty();         // Last duty target handed to setPWM
+  void getClampBounds(int& lo, int& hi); // Bounds currently clamping lux
+  void setSpectralPWM(const uint16_t src[NUM_SRC_CHANNELS]); // Mix & latch all LED strips
+  void latchOutputsForReset();  // Pin LED pads before an intentional reboot
+  void setLatencyHist(const volatile unsigned long* bins, uint8_t count); // Expose main's histogram to harvest
+  int getThermalC();             // Last heatsink NTC reading (degrees C)
+  uint32_t getThermalCapPct();   // Duty cap the governor is applying (100 = none)
+  const char* toString();   // Status line in a static buffer (no heap)
 
 private:
   LiquidCrystal_I2C lcd;  // Chamber LCD object
   bool sw1, sw2;          // Chamber switch 1 & switch 2
-  float potValue;         // Scaled potValue [0, 1]
-  int luxValue;           // raw luxValue [0,MAX)
+  fix16_t potValue;       // Scaled potValue, Q16.16 in [0, FIX16_ONE]
+  int luxValue;           // Filtered lux from the last frame [0,MAX)
+  int lux1Value;          // Per-sensor lux from the last frame
+  int lux2Value;
+  bool luxUpdated;        // Set by readUART, cleared by takeLuxUpdate
 
-  // Bounds buffer (1 minute of lux history)
-  int luxBuffer[LUX_BUFFER_SIZE];
-  int bufferIndex;
-  int bufferCount;
+  // Filter pipeline state (median-of-3 despike + integer EWMA)
+  int medianBuf[3];       // Last three raw samples
+  uint8_t medianCount;    // Samples held (for warmup passthrough)
+  uint8_t medianIdx;      // Next write slot
+  int32_t ewmaFp;         // EWMA state in Q4 so low bits aren't lost
+  bool ewmaValid;         // ewmaFp holds a real value
+
+  // Binary frame assembler for the serial lux stream (sized for the
+  // largest batch frame; single-sample frames use the first 7 bytes)
+  uint8_t rxFrame[LUX_BATCH_FRAME_MAX];
+  uint8_t rxLen;
+
+  // Text command collector: printable bytes arriving between binary frames
+  // (the 0xA7 sync is not printable) build up a "cfg ..." line
+  char cmdBuf[48];
+  uint8_t cmdLen;
+
+  // Latency histogram lives in main.cpp (the control task writes it);
+  // setLatencyHist hands the harvest path a read-only view
+  const volatile unsigned long* latBins;
+  uint8_t latBinCount;
+  uint8_t lastSeq;        // Last accepted sequence number
+  bool seqValid;          // lastSeq holds a real value
+  unsigned long droppedFrames;  // Lost (sequence gap) or corrupt frames
+
+  // Differential LCD renderer: desired frame vs. what is on the glass
+  char frameBuf[LCD_ROWS][LCD_COLS];
+  char glassBuf[LCD_ROWS][LCD_COLS];
+  bool glassValid;        // false forces a full repaint on next flush
+
+  // Bounds window (1 minute of lux history) with O(1) sliding min/max
+  SlidingMinMax<LUX_BUFFER_SIZE> luxWindow;
   int liveMin, liveMax;
 
-  void readSwitches();    // Update sw1 & sw2
-  void readAnalog();      // Update potValue
-  void readUART();        // Update inputLux
-  void updateBounds();    // Recalculate min/max from buffer
+  // Bounds persisted across reboots: until the live window fills, clamping
+  // falls back to the last checkpointed min/max instead of passing raw
+  // values straight through for a whole minute
+  uint32_t lastDuty;            // Last duty target handed to setPWM
+
+  bool restoredBounds;          // NVS held a checkpoint at begin()
+  int restoredMin, restoredMax;
+  int savedMin, savedMax;       // Last values checkpointed (write dedup)
+  unsigned long lastBoundsSaveMs;
+
+  // Light-dose integrator: clamped lux x elapsed time accumulated in
+  // lux-milliseconds, one bucket per hour in a rolling 24-hour ring.
+  // Integrating at ingestion is a multiply-add; reconstructing the same
+  // dose from serial logs costs hours of post-processing.
+  uint64_t doseHour[24];        // lux·ms per hour bucket
+  uint8_t doseHourIdx;          // Bucket currently accumulating
+  unsigned long doseHourStartMs;
+  uint32_t doseEpochHour;       // Wall-clock hour of the bucket (0 = unset)
+  unsigned long lastDoseMs;     // Previous integration timestamp
+  unsigned long lastDoseSaveMs;
+  uint64_t savedDoseTotal;      // Total at last checkpoint (write dedup)
+
+  // Hierarchical count/sum/min/max aggregates over the raw lux stream,
+  // updated once per sample; backs the serial "stats" query
+  LuxStats luxStats;
+
+  // Dual-sensor divergence monitor: EWMA of the direct/diffused lux ratio
+  // against a calibrated baseline. A fouled diffuser dome or degrading
+  // sensor shifts the ratio within minutes, long before it would be
+  // visible in the averaged signal.
+  int32_t ratioFastFp;          // Q8 EWMA of lux1/lux2
+  int32_t ratioBaseFp;          // Q8 calibrated baseline (0 = uncalibrated)
+  uint32_t ratioSamples;        // Valid ratio samples seen (auto-cal gate)
+  bool divergenceAlarm;
+  unsigned long lastDivLogMs;   // Alarm print rate limit
+
+  // Streaming tail percentiles of the raw stream; once the live window has
+  // filled they replace raw min/max as the clamp bounds, so a single spike
+  // that survived the median can't widen the clamp range for a full minute
+  P2Quantile luxLoQ, luxHiQ;
+
+  // Thermal derating governor: heatsink NTC sampled on its own cadence,
+  // converted through the divider/B-parameter math and folded into a
+  // slew-limited Q16 duty cap that every PWM write passes through
+  uint32_t thermalCapQ16;       // Cap currently applied (65536 = none)
+  int thermalC;                 // Last NTC reading, degrees C
+  unsigned long lastThermalMs;
+  bool thermalAlarm;            // Derating engaged (log edge detect)
+
+  void sampleThermal();           // Rate-limited NTC read + curve update
+  uint32_t thermalApply(uint32_t duty); // Scale one duty by the cap
+
+  void updateBounds(int rawLux);  // Push sample, refresh liveMin/liveMax
+  void checkpointBounds(int lo, int hi); // Periodic clamp-bounds save to NVS
+  void accumulateDose(int clampedLux); // Integrate lux x time, rotate buckets
+  int filterLux(int rawLux);      // Median-of-3 despike + EWMA smoothing
+  void handleCommandLine();       // Dispatch a completed cfg command
+  void handleHarvestRequest(uint8_t cmd, uint16_t arg); // Answer a binary stats query
+  void ingestByte(uint8_t b);     // One byte through the frame assembler
+  void applyLuxSample(uint16_t fp1, uint16_t fp2); // Validity + filter + publish
+  void updateDivergence(uint16_t fp1, uint16_t fp2); // Ratio EWMA + alarm
+  void saveDivergenceBaseline(int32_t baseFp);     // Persist calibration
+  void resyncFrame(uint8_t len);  // Slide one byte after a corrupt frame
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "Log.h"
+#include <stdarg.h>
+#include "ChamberClock.h"
+
+// One line of log text; longer messages are truncated, never allocated.
+// Only the display task logs today — callers from a second task should
+// grow this into a mutex-guarded section rather than a second buffer.
+static char logBuf[176];
+
+// Every line leads with a timestamp: disciplined UTC epoch once the clock
+// has synced off a satellite report, uptime until then. Shore-side tooling
+// joins chamber and satellite data on this column directly.
+void logWrite(const char* fmt, ...) {
+  int n;
+  if (clockSynced()) {
+    uint64_t ms = clockEpochMs();
+    n = snprintf(logBuf, sizeof(logBuf), "[%lu.%03u] ",
+                 (unsigned long)(ms / 1000), (unsigned)(ms % 1000));
+  } else {
+    unsigned long up = millis();
+    n = snprintf(logBuf, sizeof(logBuf), "[up %lu.%03lu] ",
+                 up / 1000, up % 1000);
+  }
+  if (n < 0 || (size_t)n >= sizeof(logBuf)) {
+    n = 0;
+  }
+
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(logBuf + n, sizeof(logBuf) - n, fmt, args);
+  va_end(args);
+  Serial.println(logBuf);
+}
@@ -0,0 +1,57 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Allocation-free serial logging. Every message is formatted by vsnprintf
+// into one static buffer — no String concatenation, no heap churn over a
+// multi-day run. Levels compile out entirely below LOG_LEVEL (override
+// with -DLOG_LEVEL=... in platformio.ini), and LOG_EVERY_MS gates a
+// call site to a minimum period so a hot path can't flood the UART.
+//
+//   LOG_ERROR("LoRa init failed, code %d", state);
+//   LOG_EVERY_MS(1000, LOG_INFO("lux %d", lux));
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Formats into the shared static buffer and writes one line to Serial.
+// Call through the macros so disabled levels cost nothing.
+void logWrite(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+// Run stmt at most once per period_ms at this call site
+#define LOG_EVERY_MS(period_ms, stmt)                  \
+  do {                                                 \
+    static unsigned long _lastLogMs = 0;               \
+    unsigned long _nowMs = millis();                   \
+    if (_nowMs - _lastLogMs >= (period_ms)) {          \
+      _lastLogMs = _nowMs;                             \
+      stmt;                                            \
+    }                                                  \
+  } while (0)
+
+#endif
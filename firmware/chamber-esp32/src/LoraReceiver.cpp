@@ -0,0 +1,906 @@
+#include "LoraReceiver.h"
+#include <SPI.h>
+#include "ChamberClock.h"
+#include "ChamberConfig.h"
+#include "Log.h"
+#include "mbedtls/md.h"
+#include "orca_siphash.h"
+#include "solar.h"
+
+// Largest frame the satellite transmits: batch flag + count byte + four
+// keyframe bodies, or an extended keyframe — both well under this
+#define LORA_RX_BUF_SIZE 255
+
+// Frame format flags — mirror of the PAYLOAD_FMT_* table in the satellite
+// firmware; a new format there needs a case in decodeFrame()
+#define FMT_KEYFRAME  0x00
+#define FMT_DELTA     0x01
+#define FMT_BATCH     0x02
+#define FMT_EXTENDED  0x03
+#define FMT_HEARTBEAT 0x04
+#define FMT_MASKED    0x05
+#define FMT_PACKED    0x06
+#define FMT_PACKED_BATCH 0x07
+
+// Downlink frames claim magics from 0xC0 up; anything below is a satellite
+// payload frame and must carry the SipHash tag when frame auth is on
+#define DOWNLINK_MAGIC_BASE 0xC0
+
+// Downlink rate frame — mirror of the REMOTE_RATE_* layout in the
+// satellite's remote_config.h: magic, version, SF, 4-byte truncated HMAC
+#define RATE_FRAME_MAGIC 0xC1
+#define RATE_FRAME_SIZE  7
+
+// Downlink channel-mask frame — mirror of REMOTE_MASK_*: magic, version,
+// 16-bit mask, 4-byte truncated HMAC. MASK_ALL = all 13 channels.
+#define MASK_FRAME_MAGIC 0xC2
+#define MASK_FRAME_SIZE  8
+#define MASK_ALL         0x1FFF
+
+// Masked-frame proposals are repeated (the downlink window can miss) but
+// not every packet: wait this many frames between attempts
+#define MASK_RETRY_FRAMES 8
+
+// Downlink TX-power frame — mirror of REMOTE_POWER_*: magic, version,
+// signed adjustment in dB, 4-byte truncated HMAC. The chamber never
+// learns the satellite's absolute setting; it just nudges until the
+// received RSSI sits at the target, so a lost frame costs a retry, not
+// a wrong power level.
+#define POWER_FRAME_MAGIC 0xC3
+#define POWER_FRAME_SIZE  7
+
+// Power-loop policy: aim the received RSSI at the target (SF9/250 kHz
+// sensitivity is near -121 dBm, so this keeps ~30 dB of fade margin),
+// move only when the error is worth a hop, cap each step so the loop
+// creeps rather than jumps, and give the EWMA time to resettle between
+// proposals
+#define POWER_RSSI_TARGET_DBM (-90.0f)
+#define POWER_MIN_STEP_DB     2
+#define POWER_MAX_STEP_DB     6
+#define POWER_RETRY_FRAMES    16
+
+// Shared secret for downlink frame signatures. Per-fleet value injected at
+// build time; the default pairs with a stock satellite build.
+#ifndef REMOTE_CONFIG_HMAC_KEY
+#define REMOTE_CONFIG_HMAC_KEY "orca-bench-key"
+#endif
+
+// Adaptive-rate policy: propose SF7 only once the rolling SNR clears the
+// threshold with a real sample base behind it, and give up on a fast link
+// that has been silent for the fallback window
+#define RATE_FAST_SNR_DB     5.0f
+#define RATE_MIN_PACKETS     16
+#define RATE_FALLBACK_MS     30000UL
+#define LINK_EWMA_WEIGHT     0.125f  // 1/8 per packet
+
+// DIO1 fires on RX done; flag it and wake whoever blocks in
+// waitForPacket() — all SPI traffic stays in poll()
+static volatile bool packetPending = false;
+static SemaphoreHandle_t packetSem = NULL;
+static void IRAM_ATTR onDio1() {
+  packetPending = true;
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(packetSem, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+LoraReceiver::LoraReceiver()
+    : radio(new Module(LORA_CS_PIN, LORA_DIO1_PIN, LORA_RST_PIN, LORA_BUSY_PIN)),
+      claimedIdx(-1), poolDropFrames(0),
+      nodeCount(0), rxNode(NULL),
+      duplicateFrames(0), staleFrames(0),
+      receivedFrames(0), corruptFrames(0), missedSamples(0),
+      lastRssi(0.0f), lastAirtimeMs(0),
+      rssiEwma(0.0f), snrEwma(0.0f), linkEwmaValid(false),
+      currentSf(LORA_SF), lastPacketMs(0), packetsAtSf(0),
+      rateChanges(0), rateFallbacks(0),
+      satChannelMask(MASK_ALL), maskSendBackoff(0),
+      powerSendBackoff(0), powerProposals(0),
+      authFailFrames(0), solarRejectFrames(0) {
+  memset(nodes, 0, sizeof(nodes));
+}
+
+bool LoraReceiver::begin() {
+  packetSem = xSemaphoreCreateBinary();
+  SPI.begin(LORA_SCK_PIN, LORA_MISO_PIN, LORA_MOSI_PIN, LORA_CS_PIN);
+
+  // Radio parameters must mirror the satellite's exactly (see its CLAUDE.md).
+  // The carrier comes off the fleet frequency plan: "lorachan" selects
+  // which satellite's channel this chamber camps on (the RX path is
+  // passive, so following a different node is pure configuration).
+  float freqMhz = LORA_FREQ_MHZ +
+                  chamberCfg.loraChannel * LORA_CHANNEL_STEP_MHZ;
+  int state = radio.begin(freqMhz, LORA_BW_KHZ, LORA_SF, LORA_CR,
+                          LORA_SYNC_WORD);
+  if (state != RADIOLIB_ERR_NONE) {
+    LOG_ERROR("LoRa init failed, code %d", state);
+    return false;
+  }
+#if LORA_IMPLICIT_LEN
+  // Fixed-length frames, no PHY header — the satellite pads to match
+  radio.implicitHeader(LORA_IMPLICIT_LEN);
+#endif
+
+  radio.setDio1Action(onDio1);
+  state = radio.startReceive();
+  if (state != RADIOLIB_ERR_NONE) {
+    LOG_ERROR("LoRa startReceive failed, code %d", state);
+    return false;
+  }
+  return true;
+}
+
+// Block until DIO1 reports a finished packet (or the timeout passes).
+// Returning true means poll() has work to do right now.
+bool LoraReceiver::waitForPacket(uint32_t timeoutMs) {
+  if (packetPending) {
+    return true;
+  }
+  return xSemaphoreTake(packetSem, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+// Drain one pending packet if DIO1 has flagged it. Returns the number of
+// reports decoded out of it (0 when nothing was pending or the packet was
+// corrupt/heartbeat-only).
+int LoraReceiver::poll() {
+  if (!packetPending) {
+    return 0;
+  }
+  packetPending = false;
+
+  uint8_t buf[LORA_RX_BUF_SIZE];
+  size_t len = radio.getPacketLength();
+  if (len > sizeof(buf)) {
+    len = sizeof(buf);
+  }
+  int state = radio.readData(buf, len);
+
+  int decoded = 0;
+  if (state == RADIOLIB_ERR_NONE && len > 0) {
+#if LORA_FRAME_AUTH
+    // Verify the satellite's SipHash tag before the frame touches any
+    // state — link stats included, so a spoofer cannot steer the rate
+    // negotiation either. Overheard downlink frames (0xC0+) carry their
+    // own HMAC and are checked in their handlers instead.
+    if (buf[0] < DOWNLINK_MAGIC_BASE) {
+      static const char authKey[] = LORA_FRAME_AUTH_KEY;
+      if (len <= ORCA_FRAME_TAG_LEN ||
+          !orca_frame_tag_check((const uint8_t*)authKey, buf,
+                                len - ORCA_FRAME_TAG_LEN,
+                                buf + len - ORCA_FRAME_TAG_LEN)) {
+        authFailFrames++;
+        radio.startReceive();
+        return 0;
+      }
+      len -= ORCA_FRAME_TAG_LEN;
+    }
+#endif
+    // Resolve which satellite's stream this packet belongs to before any
+    // per-node state is touched. Payload frames carry no origin field
+    // yet, so the frequency-plan channel the chamber is camped on stands
+    // in for the node ID — one live slot today, but the decode paths all
+    // route through the registry, so growing the header an origin byte
+    // is a one-line change here.
+    rxNode = nodeSlot((uint16_t)chamberCfg.loraChannel);
+    updateLinkStats();
+    // How long this packet spent on the wire at the current modulation —
+    // the clock discipline subtracts it from the stamp's age
+    lastAirtimeMs = radio.getTimeOnAir(len) / 1000;
+    decoded = decodeFrame(buf, len);
+    // The satellite holds its downlink window open right after this frame,
+    // so a proposal has to go out now or wait a whole cycle — and only one
+    // frame fits the window: rate outranks power outranks mask
+    if (!maybeProposeRate() && !maybeProposePower()) {
+      maybeProposeMask();
+    }
+  } else {
+    corruptFrames++;
+  }
+
+  // readData leaves the radio idle; re-arm continuous receive
+  radio.startReceive();
+  return decoded;
+}
+
+// Bounded registry lookup: scan cost is fixed by the compile-time slot
+// count, so per-packet processing does not grow with the fleet. Slots
+// fill in order, so a free slot is only ever reached after every claimed
+// one has been checked. A full table recycles the slot silent the
+// longest — with the table sized to the satellites one vessel carries,
+// eviction only ever fires on a misconfigured channel plan.
+LoraReceiver::NodeState* LoraReceiver::nodeSlot(uint16_t nodeId) {
+  NodeState* oldest = &nodes[0];
+  for (int i = 0; i < NODE_SLOT_COUNT; i++) {
+    if (!nodes[i].inUse) {
+      nodes[i].inUse = true;
+      nodes[i].nodeId = nodeId;
+      nodeCount++;
+      return &nodes[i];
+    }
+    if (nodes[i].nodeId == nodeId) {
+      return &nodes[i];
+    }
+    if (nodes[i].lastHeardMs < oldest->lastHeardMs) {
+      oldest = &nodes[i];
+    }
+  }
+  memset(oldest, 0, sizeof(*oldest));
+  oldest->inUse = true;
+  oldest->nodeId = nodeId;
+  return oldest;
+}
+
+// Fold the packet that just arrived into the rolling link averages — the
+// fleet-wide pair that steers the rate/power negotiation (a blended
+// margin stays conservative for everyone on the channel) and the per-node
+// pair in the registry slot, which is what telemetry should report once
+// several satellites share the air.
+void LoraReceiver::updateLinkStats() {
+  lastRssi = radio.getRSSI();
+  float snr = radio.getSNR();
+  if (!linkEwmaValid) {
+    rssiEwma = lastRssi;
+    snrEwma = snr;
+    linkEwmaValid = true;
+  } else {
+    rssiEwma += LINK_EWMA_WEIGHT * (lastRssi - rssiEwma);
+    snrEwma += LINK_EWMA_WEIGHT * (snr - snrEwma);
+  }
+  if (!rxNode->ewmaValid) {
+    rxNode->rssiEwma = lastRssi;
+    rxNode->snrEwma = snr;
+    rxNode->ewmaValid = true;
+  } else {
+    rxNode->rssiEwma += LINK_EWMA_WEIGHT * (lastRssi - rxNode->rssiEwma);
+    rxNode->snrEwma += LINK_EWMA_WEIGHT * (snr - rxNode->snrEwma);
+  }
+  rxNode->frames++;
+  rxNode->lastHeardMs = millis();
+  lastPacketMs = millis();
+  packetsAtSf++;
+}
+
+// When the SF9 margin comfortably covers SF7, answer into the downlink
+// window with a signed rate frame and retune to match. The satellite
+// persists the new SF and cold-inits its radio next cycle, so an accepted
+// proposal misses no frames; a lost one is caught by the watchdog.
+bool LoraReceiver::maybeProposeRate() {
+  // Only the designated rate leader negotiates: several chambers answering
+  // the same downlink window would collide, and a retune by one would
+  // strand the rest. Followers track the leader via followRateFrame().
+  if (!chamberCfg.rateLeader) {
+    return false;
+  }
+  if (currentSf != LORA_SF || !linkEwmaValid ||
+      packetsAtSf < RATE_MIN_PACKETS || snrEwma < RATE_FAST_SNR_DB) {
+    return false;
+  }
+
+  uint8_t frame[RATE_FRAME_SIZE];
+  frame[0] = RATE_FRAME_MAGIC;
+  frame[1] = 1;  // layout version
+  frame[2] = LORA_SF_FAST;
+
+  uint8_t mac[32];
+  const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  if (md == NULL ||
+      mbedtls_md_hmac(md, (const unsigned char*)REMOTE_CONFIG_HMAC_KEY,
+                      strlen(REMOTE_CONFIG_HMAC_KEY), frame, 3, mac) != 0) {
+    return false;
+  }
+  memcpy(frame + 3, mac, 4);
+
+#if LORA_IMPLICIT_LEN
+  // The satellite's fixed-length receive window expects every frame padded
+  uint8_t padded[LORA_IMPLICIT_LEN] = {0};
+  memcpy(padded, frame, sizeof(frame));
+  int txState = radio.transmit(padded, sizeof(padded));
+#else
+  int txState = radio.transmit(frame, sizeof(frame));
+#endif
+  if (txState != RADIOLIB_ERR_NONE) {
+    return false;
+  }
+  radio.setSpreadingFactor(LORA_SF_FAST);
+  currentSf = LORA_SF_FAST;
+  packetsAtSf = 0;
+  rateChanges++;
+  LOG_INFO("LoRa: proposed SF%d, retuned receiver", LORA_SF_FAST);
+  return true;
+}
+
+// Closed-loop TX power: when the rolling RSSI sits off the margin target,
+// answer into the downlink window with a signed delta recommendation.
+// The satellite steps its persisted power and the loop re-measures over
+// the next POWER_RETRY_FRAMES packets — no acknowledgement needed, and a
+// lost frame just means the same nudge goes out again. Leader-gated like
+// the other proposals.
+bool LoraReceiver::maybeProposePower() {
+  if (!chamberCfg.rateLeader || !linkEwmaValid ||
+      packetsAtSf < RATE_MIN_PACKETS) {
+    return false;
+  }
+  if (powerSendBackoff > 0) {
+    powerSendBackoff--;
+    return false;
+  }
+
+  int delta = (int)(POWER_RSSI_TARGET_DBM - rssiEwma);
+  if (delta > -POWER_MIN_STEP_DB && delta < POWER_MIN_STEP_DB) {
+    return false;  // on target — leave the window to a mask proposal
+  }
+  if (delta > POWER_MAX_STEP_DB) {
+    delta = POWER_MAX_STEP_DB;
+  } else if (delta < -POWER_MAX_STEP_DB) {
+    delta = -POWER_MAX_STEP_DB;
+  }
+
+  uint8_t frame[POWER_FRAME_SIZE];
+  frame[0] = POWER_FRAME_MAGIC;
+  frame[1] = 1;  // layout version
+  frame[2] = (uint8_t)(int8_t)delta;
+
+  uint8_t mac[32];
+  const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  if (md == NULL ||
+      mbedtls_md_hmac(md, (const unsigned char*)REMOTE_CONFIG_HMAC_KEY,
+                      strlen(REMOTE_CONFIG_HMAC_KEY), frame, 3, mac) != 0) {
+    return false;
+  }
+  memcpy(frame + 3, mac, 4);
+
+#if LORA_IMPLICIT_LEN
+  uint8_t padded[LORA_IMPLICIT_LEN] = {0};
+  memcpy(padded, frame, sizeof(frame));
+  int txState = radio.transmit(padded, sizeof(padded));
+#else
+  int txState = radio.transmit(frame, sizeof(frame));
+#endif
+  if (txState != RADIOLIB_ERR_NONE) {
+    return false;
+  }
+  powerSendBackoff = POWER_RETRY_FRAMES;
+  powerProposals++;
+  LOG_INFO("LoRa: proposed TX power %+d dB (RSSI ewma %.1f dBm)",
+           delta, rssiEwma);
+  return true;
+}
+
+// When the configured channel mask differs from what the satellite is
+// seen transmitting, answer into the downlink window with a signed mask
+// frame. No local retune: confirmation is the next frame arriving in
+// masked (or full) form, which updates satChannelMask and ends the
+// retries. Leader-gated like rate proposals — one voice per window.
+void LoraReceiver::maybeProposeMask() {
+  if (!chamberCfg.rateLeader) {
+    return;
+  }
+  uint16_t want = (uint16_t)(chamberCfg.channelMask & MASK_ALL);
+  if (want == 0 || want == satChannelMask) {
+    maskSendBackoff = 0;
+    return;
+  }
+  if (maskSendBackoff > 0) {
+    maskSendBackoff--;
+    return;
+  }
+
+  uint8_t frame[MASK_FRAME_SIZE];
+  frame[0] = MASK_FRAME_MAGIC;
+  frame[1] = 1;  // layout version
+  frame[2] = (uint8_t)(want & 0xFF);
+  frame[3] = (uint8_t)(want >> 8);
+
+  uint8_t mac[32];
+  const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  if (md == NULL ||
+      mbedtls_md_hmac(md, (const unsigned char*)REMOTE_CONFIG_HMAC_KEY,
+                      strlen(REMOTE_CONFIG_HMAC_KEY), frame, 4, mac) != 0) {
+    return;
+  }
+  memcpy(frame + 4, mac, 4);
+
+#if LORA_IMPLICIT_LEN
+  uint8_t padded[LORA_IMPLICIT_LEN] = {0};
+  memcpy(padded, frame, sizeof(frame));
+  int txState = radio.transmit(padded, sizeof(padded));
+#else
+  int txState = radio.transmit(frame, sizeof(frame));
+#endif
+  if (txState == RADIOLIB_ERR_NONE) {
+    maskSendBackoff = MASK_RETRY_FRAMES;
+    LOG_INFO("LoRa: proposed channel mask 0x%04x", want);
+  }
+}
+
+// Called from the radio task's wait timeout: a fast link that has gone
+// quiet means the satellite never took (or lost) the new rate — drop back
+// to the SF9 floor both ends always share.
+void LoraReceiver::linkWatchdog() {
+  if (currentSf == LORA_SF || millis() - lastPacketMs < RATE_FALLBACK_MS) {
+    return;
+  }
+  radio.setSpreadingFactor(LORA_SF);
+  radio.startReceive();
+  currentSf = LORA_SF;
+  packetsAtSf = 0;
+  rateFallbacks++;
+  LOG_INFO("LoRa: fast link silent, back to SF%d", LORA_SF);
+}
+
+// Slot-pool hand-off to the control path: downstream takes indices in
+// decode order, reads the slots in place and returns each one after the
+// PWM latch. claim/publish/take all stay on the radio task and release on
+// the control task, so every index ring keeps one producer, one consumer.
+int LoraReceiver::takeReportSlot() {
+  return reportPool.take();
+}
+
+const LoraReceiver::ReportSlot& LoraReceiver::reportSlot(int idx) const {
+  return reportPool.at(idx);
+}
+
+void LoraReceiver::releaseReportSlot(int idx) {
+  reportPool.release(idx);
+}
+
+// Decode target for the report being assembled: a pool slot when one is
+// free, otherwise a scratch struct so sequence/dedup/delta-base
+// bookkeeping still runs while control is holding every slot. A claim
+// survives a rejected or corrupt report — the next claim reuses the slot
+// instead of touching the free ring, which belongs to the releasing task.
+orca_report_wire_t* LoraReceiver::claimReport() {
+  if (claimedIdx < 0) {
+    claimedIdx = reportPool.acquire();
+  }
+  return claimedIdx >= 0 ? &reportPool.at(claimedIdx).report : &overflowReport;
+}
+
+// Screen the claimed report and, when it advances the stream, publish its
+// slot to the control path. The verdict is returned either way — callers
+// gate clock discipline on it — and an accepted report that found the
+// pool dry (control stalled) is counted rather than delivered.
+bool LoraReceiver::commitReport() {
+  orca_report_wire_t* rep =
+      claimedIdx >= 0 ? &reportPool.at(claimedIdx).report : &overflowReport;
+  if (!screenReport(*rep)) {
+    return false;  // slot stays claimed; the next decode overwrites it
+  }
+  if (claimedIdx < 0) {
+    poolDropFrames++;
+    return true;
+  }
+  reportPool.at(claimedIdx).decodedUs = micros();
+  reportPool.publish(claimedIdx);
+  claimedIdx = -1;
+  return true;
+}
+
+// Dedup/reorder against the sending node's slot; true means the report
+// advances the stream and belongs on the control path. Sequence state
+// lives per node: the fleet's streams interleave on the air, and each
+// satellite counts samples on its own.
+bool LoraReceiver::screenReport(const orca_report_wire_t& report) {
+  NodeState& node = *rxNode;
+
+  // Delta frames decode against the satellite's transmission order, which
+  // is arrival order — so the delta base updates before any dedup verdict.
+  // This copy is deliberate: the base must survive the slot being recycled
+  // under the next packet.
+  node.lastReport = report;
+  node.lastReportValid = true;
+
+  // Exact repeat of something recently seen: a retransmission of a report
+  // that already got through
+  for (uint8_t i = 0; i < node.recentSeqCount; i++) {
+    if (node.recentSeq[i] == report.sample_count) {
+      duplicateFrames++;
+      return false;
+    }
+  }
+  node.recentSeq[node.recentSeqIdx] = report.sample_count;
+  node.recentSeqIdx = (node.recentSeqIdx + 1) % DEDUP_WINDOW_LEN;
+  if (node.recentSeqCount < DEDUP_WINDOW_LEN) {
+    node.recentSeqCount++;
+  }
+
+  // Late retransmission from the store-and-forward queue: it fills a gap
+  // we already charged as missed, but the PWM only moves forward in time
+  if (node.seqValid && report.sample_count <= node.lastSampleCount) {
+    staleFrames++;
+    if (missedSamples > 0) {
+      missedSamples--;
+    }
+    return false;
+  }
+
+  if (node.seqValid && report.sample_count > node.lastSampleCount + 1) {
+    missedSamples += report.sample_count - node.lastSampleCount - 1;
+  }
+  node.lastSampleCount = report.sample_count;
+  node.seqValid = true;
+
+#if SOLAR_CHECK_ENABLED
+  // Solar plausibility: the report carries everything needed to ask
+  // whether its own light level is physically possible — GPS position,
+  // its timestamp, and the channel counts. Bright light under a sun well
+  // below the horizon means a bad sensor, a corrupt-but-CRC-lucky frame,
+  // or something shining into the dome; none of it belongs on the strips.
+  // Sequence and dedup accounting above still ran, so the reject is
+  // invisible to link statistics.
+  if (report.gps_valid && report.unix_time > 1577836800UL &&
+      solar_elevation_cdeg(report.unix_time, report.lat_e7,
+                           report.lon_e7) < SOLAR_NIGHT_CDEG) {
+    uint16_t peak = 0;
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      if (report.channels[i] > peak) {
+        peak = report.channels[i];
+      }
+    }
+    if (peak > SOLAR_NIGHT_MAX_COUNTS) {
+      solarRejectFrames++;
+      return false;
+    }
+  }
+#endif
+
+  return true;
+}
+
+// Little-endian field readers for the masked-frame layout
+static uint16_t rdLE16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rdLE32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Packed keyframe body: shift byte, sample count, the 12-bit channel block
+// (expanded via orca_channels_unpack), then the keyframe tail verbatim
+#define PACKED_BODY_SIZE (1 + 4 + ORCA_PACKED_CH_BYTES + 17)
+
+static void decodePackedBody(const uint8_t* body, orca_report_wire_t& out) {
+  uint8_t shift = body[0];
+  out.sample_count = rdLE32(body + 1);
+  orca_channels_unpack(body + 5, shift, out.channels);
+  size_t pos = 5 + ORCA_PACKED_CH_BYTES;
+  out.gps_valid = body[pos++];
+  out.lat_e7 = (int32_t)rdLE32(body + pos);
+  pos += 4;
+  out.lon_e7 = (int32_t)rdLE32(body + pos);
+  pos += 4;
+  out.unix_time = rdLE32(body + pos);
+  pos += 4;
+  out.batt_mv = rdLE16(body + pos);
+  pos += 2;
+  out.sample_age_ms = rdLE16(body + pos);
+}
+
+// Varint + zigzag primitives matching the satellite's delta encoder
+static bool varintGet(const uint8_t* buf, size_t len, size_t& pos, uint32_t& out) {
+  uint32_t value = 0;
+  int shift = 0;
+  while (pos < len && shift < 35) {
+    uint8_t b = buf[pos++];
+    value |= (uint32_t)(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) {
+      out = value;
+      return true;
+    }
+    shift += 7;
+  }
+  return false;
+}
+
+static int32_t unzigzag32(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Apply a delta body (after the flag byte) against the last decoded report.
+// Field order mirrors the satellite's build_tx_frame: sample count, 13
+// channels, gps valid byte, latitude, longitude, unix time, then two fixed
+// bytes of absolute sample age.
+bool LoraReceiver::decodeDelta(const uint8_t* buf, size_t len, orca_report_wire_t& out) {
+  const NodeState& node = *rxNode;
+  if (!node.lastReportValid) {
+    return false;  // nothing to delta against until the next keyframe
+  }
+
+  out = node.lastReport;
+  size_t pos = 0;
+  uint32_t v;
+
+  if (!varintGet(buf, len, pos, v)) return false;
+  out.sample_count = node.lastReport.sample_count + (uint32_t)unzigzag32(v);
+
+  for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+    if (!varintGet(buf, len, pos, v)) return false;
+    out.channels[i] = (uint16_t)((int32_t)node.lastReport.channels[i] + unzigzag32(v));
+  }
+
+  if (pos >= len) return false;
+  out.gps_valid = buf[pos++];
+  if (!varintGet(buf, len, pos, v)) return false;
+  out.lat_e7 = node.lastReport.lat_e7 + unzigzag32(v);
+  if (!varintGet(buf, len, pos, v)) return false;
+  out.lon_e7 = node.lastReport.lon_e7 + unzigzag32(v);
+  if (!varintGet(buf, len, pos, v)) return false;
+  out.unix_time = node.lastReport.unix_time + (uint32_t)unzigzag32(v);
+
+  if (pos + 2 > len) return false;
+  out.sample_age_ms = (uint16_t)(buf[pos] | (buf[pos + 1] << 8));
+
+  return true;
+}
+
+// Dispatch on the flag byte, decoding every report the frame carries into
+// a claimed pool slot. Returns the number of reports delivered downstream.
+int LoraReceiver::decodeFrame(const uint8_t* buf, size_t len) {
+  switch (buf[0]) {
+    case FMT_KEYFRAME:
+    case FMT_EXTENDED: {
+      // Extended is a keyframe body plus stats and sampling-window
+      // blocks; the control path only needs the averages, so the
+      // trailer is simply left unread
+      if (len < 1 + ORCA_REPORT_WIRE_SIZE) {
+        corruptFrames++;
+        return 0;
+      }
+      receivedFrames++;
+      satChannelMask = MASK_ALL;  // Full frames mean masked mode is off
+      // The one copy a report ever takes: packet buffer into its pool slot
+      orca_report_wire_t* rep = claimReport();
+      *rep = *orca_report_decode(buf + 1);
+      bool gpsValid = rep->gps_valid;
+      uint32_t unixTime = rep->unix_time;
+      if (!commitReport()) {
+        return 0;
+      }
+      // A keyframe that advanced the stream was built moments before this
+      // packet left the antenna, so its GPS stamp disciplines the local
+      // clock. Duplicates and late retransmissions carry their original
+      // (stale) stamp and must not — hence the commit check.
+      if (gpsValid) {
+        clockDiscipline(unixTime, lastAirtimeMs);
+      }
+      return 1;
+    }
+
+    case FMT_BATCH: {
+      if (len < 2) {
+        corruptFrames++;
+        return 0;
+      }
+      uint8_t count = buf[1];
+      if (len < 2 + (size_t)count * ORCA_REPORT_WIRE_SIZE) {
+        corruptFrames++;
+        return 0;
+      }
+      receivedFrames++;
+      int delivered = 0;
+      for (uint8_t i = 0; i < count; i++) {
+        *claimReport() = *orca_report_decode(buf + 2 + i * ORCA_REPORT_WIRE_SIZE);
+        if (commitReport()) {
+          delivered++;
+        }
+      }
+      return delivered;
+    }
+
+    case FMT_DELTA: {
+      orca_report_wire_t* rep = claimReport();
+      if (!decodeDelta(buf + 1, len - 1, *rep)) {
+        corruptFrames++;
+        return 0;  // the claim is kept; the next decode overwrites it
+      }
+      receivedFrames++;
+      bool gpsValid = rep->gps_valid;
+      uint32_t unixTime = rep->unix_time;
+      if (!commitReport()) {
+        return 0;
+      }
+      // Same freshness rule as keyframes. Batch frames never discipline:
+      // they drain the store-and-forward backlog, so their stamps are as
+      // old as the outage that queued them.
+      if (gpsValid) {
+        clockDiscipline(unixTime, lastAirtimeMs);
+      }
+      return 1;
+    }
+
+    case FMT_MASKED: {
+      // Channel-mask frame: a keyframe with the spectral block cut down to
+      // the selected channels. Deselected channels hold their last known
+      // value so the mixer keeps driving those strips steadily.
+      if (len < 3) {
+        corruptFrames++;
+        return 0;
+      }
+      uint16_t mask = rdLE16(buf + 1);
+      int present = __builtin_popcount(mask);
+      if (mask == 0 || mask > MASK_ALL ||
+          len < 3u + 4u + 2u * present + 1u + 4u + 4u + 4u + 2u + 2u) {
+        corruptFrames++;
+        return 0;
+      }
+      receivedFrames++;
+      satChannelMask = mask;
+
+      orca_report_wire_t& report = *claimReport();
+      if (rxNode->lastReportValid) {
+        report = rxNode->lastReport;
+      } else {
+        memset(&report, 0, sizeof(report));
+      }
+      size_t pos = 3;
+      report.sample_count = rdLE32(buf + pos);
+      pos += 4;
+      for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+        if (mask & (1u << i)) {
+          report.channels[i] = rdLE16(buf + pos);
+          pos += 2;
+        }
+      }
+      report.gps_valid = buf[pos++];
+      report.lat_e7 = (int32_t)rdLE32(buf + pos);
+      pos += 4;
+      report.lon_e7 = (int32_t)rdLE32(buf + pos);
+      pos += 4;
+      report.unix_time = rdLE32(buf + pos);
+      pos += 4;
+      report.batt_mv = rdLE16(buf + pos);
+      pos += 2;
+      report.sample_age_ms = rdLE16(buf + pos);
+
+      bool gpsValid = report.gps_valid;
+      uint32_t unixTime = report.unix_time;
+      if (!commitReport()) {
+        return 0;
+      }
+      // Same freshness rule as keyframes — masked frames are built moments
+      // before transmission and carry a live GPS stamp
+      if (gpsValid) {
+        clockDiscipline(unixTime, lastAirtimeMs);
+      }
+      return 1;
+    }
+
+    case FMT_PACKED: {
+      // Bit-packed keyframe: full channel coverage at 12 bits each behind
+      // a shared shift; decodes to an ordinary report
+      if (len < 1 + PACKED_BODY_SIZE) {
+        corruptFrames++;
+        return 0;
+      }
+      receivedFrames++;
+      satChannelMask = MASK_ALL;  // Full-coverage frame — masked mode is off
+      orca_report_wire_t& report = *claimReport();
+      decodePackedBody(buf + 1, report);
+      bool gpsValid = report.gps_valid;
+      uint32_t unixTime = report.unix_time;
+      if (!commitReport()) {
+        return 0;
+      }
+      // Same freshness rule as plain keyframes
+      if (gpsValid) {
+        clockDiscipline(unixTime, lastAirtimeMs);
+      }
+      return 1;
+    }
+
+    case FMT_PACKED_BATCH: {
+      if (len < 2) {
+        corruptFrames++;
+        return 0;
+      }
+      uint8_t count = buf[1];
+      if (len < 2 + (size_t)count * PACKED_BODY_SIZE) {
+        corruptFrames++;
+        return 0;
+      }
+      receivedFrames++;
+      satChannelMask = MASK_ALL;
+      int delivered = 0;
+      for (uint8_t i = 0; i < count; i++) {
+        decodePackedBody(buf + 2 + i * PACKED_BODY_SIZE, *claimReport());
+        if (commitReport()) {
+          delivered++;
+        }
+      }
+      return delivered;
+    }
+
+    case FMT_HEARTBEAT:
+      // Alive-but-dark marker: no channel data to drive the LEDs with, but
+      // it still proves the link, so count it as received
+      receivedFrames++;
+      return 0;
+
+    case RATE_FRAME_MAGIC:
+      // The rate leader's signed proposal to the satellite, overheard on
+      // the shared channel. Followers retune off it so a rate change never
+      // strands part of the broadcast audience.
+      followRateFrame(buf, len);
+      return 0;
+
+    default:
+      corruptFrames++;
+      return 0;
+  }
+}
+
+// A follower chamber heard the leader's rate frame: verify the signature
+// (same shared secret that authorizes it at the satellite) and retune to
+// the proposed SF. The silence watchdog covers the case where the
+// satellite rejected a proposal we followed.
+void LoraReceiver::followRateFrame(const uint8_t* buf, size_t len) {
+  // Length is a lower bound: implicit-header mode pads every frame to the
+  // fixed length, and the padding sits outside the signed bytes anyway
+  if (chamberCfg.rateLeader || len < RATE_FRAME_SIZE || buf[1] != 1) {
+    return;
+  }
+
+  uint8_t mac[32];
+  const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  if (md == NULL ||
+      mbedtls_md_hmac(md, (const unsigned char*)REMOTE_CONFIG_HMAC_KEY,
+                      strlen(REMOTE_CONFIG_HMAC_KEY), buf, 3, mac) != 0 ||
+      memcmp(buf + 3, mac, 4) != 0) {
+    corruptFrames++;
+    return;
+  }
+
+  uint8_t sf = buf[2];
+  if (sf == currentSf || sf < LORA_SF_FAST || sf > LORA_SF) {
+    return;
+  }
+  radio.setSpreadingFactor(sf);
+  currentSf = sf;
+  packetsAtSf = 0;
+  rateChanges++;
+  LOG_INFO("LoRa: followed leader to SF%u", sf);
+}
+
+unsigned long LoraReceiver::getReceivedFrames() { return receivedFrames; }
+unsigned long LoraReceiver::getCorruptFrames()  { return corruptFrames; }
+unsigned long LoraReceiver::getMissedSamples()  { return missedSamples; }
+unsigned long LoraReceiver::getDuplicateFrames() { return duplicateFrames; }
+unsigned long LoraReceiver::getStaleFrames()     { return staleFrames; }
+unsigned long LoraReceiver::getAuthFailFrames()  { return authFailFrames; }
+unsigned long LoraReceiver::getSolarRejectFrames() { return solarRejectFrames; }
+float LoraReceiver::getLastRssi()               { return lastRssi; }
+float LoraReceiver::getSnrEwma()                { return snrEwma; }
+uint8_t LoraReceiver::getCurrentSf()            { return currentSf; }
+uint8_t LoraReceiver::getNodeCount()            { return nodeCount; }
+
+// Stats line in a static buffer — called once per log period, and the
+// next call overwrites the previous line
+const char* LoraReceiver::toString() {
+  static char buf[144];
+  int n = snprintf(buf, sizeof(buf),
+                   "LoRa rx:%lu corrupt:%lu missed:%lu dup:%lu stale:%lu "
+                   "rssi:%.1f snr:%.1f sf:%u",
+                   receivedFrames, corruptFrames, missedSamples,
+                   duplicateFrames, staleFrames, rssiEwma, snrEwma, currentSf);
+  // A second registry slot only appears once a second satellite is heard
+  if (nodeCount > 1 && n > 0 && (size_t)n < sizeof(buf)) {
+    n += snprintf(buf + n, sizeof(buf) - n, " nodes:%u", nodeCount);
+  }
+  if (rateFallbacks > 0 && n > 0 && (size_t)n < sizeof(buf)) {
+    n += snprintf(buf + n, sizeof(buf) - n, " fallbacks:%lu", rateFallbacks);
+  }
+  // Reports that found every pool slot in flight — control is stalling
+  if (poolDropFrames > 0 && n > 0 && (size_t)n < sizeof(buf)) {
+    n += snprintf(buf + n, sizeof(buf) - n, " pooldrop:%lu", poolDropFrames);
+  }
+  // Rejected forgeries are worth a line only once there are any
+  if (authFailFrames > 0 && n > 0 && (size_t)n < sizeof(buf)) {
+    n += snprintf(buf + n, sizeof(buf) - n, " authfail:%lu", authFailFrames);
+  }
+  if (solarRejectFrames > 0 && n > 0 && (size_t)n < sizeof(buf)) {
+    snprintf(buf + n, sizeof(buf) - n, " solar:%lu", solarRejectFrames);
+  }
+  return buf;
+}
@@ -0,0 +1,174 @@
+#ifndef LORA_RECEIVER_H
+#define LORA_RECEIVER_H
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include "Config.h"
+#include "SlotPool.h"
+#include "orca_payload.h"
+
+// SX1262 receiver for the satellite's LoRa reports. The radio sits in
+// continuous receive; DIO1 signals a finished packet from interrupt context
+// (flag + semaphore, so a dedicated task can block in waitForPacket() and
+// run the moment a frame lands) and poll() reads it out, decodes every
+// report it carries and stages them for takeReportSlot(). Decoding follows the
+// satellite's frame formats: keyframe and batch bodies are the shared
+// packed wire struct (zero-copy cast via orca_report_decode), extended
+// frames are a keyframe body plus a stats block we skip, delta frames
+// are zigzag varints applied against the last decoded report, and packed
+// frames are keyframes with the channel block bit-packed to 12 bits behind
+// a shared shift (orca_channels_unpack). Sequence
+// gaps are counted off sample_count the same way InputOutput counts lost
+// lux frames off the serial stream.
+//
+// The receiver also runs the adaptive-rate side of the link: per-packet
+// RSSI/SNR feed rolling averages (fleet-wide for the negotiation loops,
+// per node in the slot registry), and when the SNR margin comfortably
+// covers SF7 it answers
+// into the satellite's post-TX downlink window with a signed rate frame,
+// then retunes its own radio to match. A silence watchdog drops both back
+// to the SF9 floor if the faster link ever goes quiet. The same window
+// carries the TX power loop: signed delta nudges that walk the
+// satellite's output power until the received RSSI sits at the margin
+// target (maybeProposePower).
+//
+// LoRa is inherently broadcast, and the whole RX path is passive — any
+// number of chambers decode the same satellite for free, each applying its
+// own local scaling config. The one active behavior, rate negotiation, is
+// therefore role-gated: the single configured leader ("ratelead") proposes
+// and the rest retune by overhearing its signed rate frame, so a rate
+// change carries the whole audience at once.
+class LoraReceiver {
+public:
+  // Decoded reports ride a slot pool instead of a copy queue: decode fills
+  // a pool slot in place, takeReportSlot() hands downstream the slot index,
+  // and the slot is only recycled once releaseReportSlot() returns it — so
+  // a report is copied exactly once (out of the packet buffer) on its way
+  // to the PWM, and per-packet cost stays flat as frames get busier.
+  struct ReportSlot {
+    orca_report_wire_t report;
+    unsigned long decodedUs;  // micros() when the decode committed
+  };
+  // Sized for one worst-case batch packet plus slack, like the copy queue
+  // it replaced
+  static const int REPORT_POOL_LEN = 8;
+
+  LoraReceiver();
+  bool begin();                            // Bring up SPI + SX1262, start receiving
+  bool waitForPacket(uint32_t timeoutMs);  // Block until DIO1 signals a packet
+  int poll();                              // Drain a pending packet; reports decoded
+  int takeReportSlot();                    // Oldest ready slot index, -1 when none
+  const ReportSlot& reportSlot(int idx) const;  // Borrow a taken slot's contents
+  void releaseReportSlot(int idx);         // Return a slot after the PWM latch
+  unsigned long getReceivedFrames();       // Packets accepted since boot
+  unsigned long getCorruptFrames();        // CRC failures / undecodable packets
+  unsigned long getMissedSamples();        // sample_count gaps across accepted reports
+  unsigned long getDuplicateFrames();      // Exact repeats dropped by the dedup window
+  unsigned long getStaleFrames();          // Late retransmissions kept off the PWM
+  unsigned long getAuthFailFrames();       // Frames rejected by the SipHash tag
+  unsigned long getSolarRejectFrames();    // Reports failing the solar check
+  float getLastRssi();                     // RSSI of the last accepted packet (dBm)
+  float getSnrEwma();                      // Rolling SNR average (dB)
+  uint8_t getCurrentSf();                  // Spreading factor currently tuned
+  uint8_t getNodeCount();                  // Node registry slots in use
+  void linkWatchdog();                     // Fall back to SF9 after silence
+  const char* toString();                  // Stats line in a static buffer (no heap)
+
+private:
+  SX1262 radio;
+
+  // Decoded reports waiting for the control path, held in place: decode
+  // writes straight into a claimed slot and only the index travels. The
+  // pool's free ring is fed by the releasing (control) task and drained
+  // here; the ready ring never leaves the radio task.
+  SlotPool<ReportSlot, REPORT_POOL_LEN> reportPool;
+  int claimedIdx;                     // Slot claimed for the decode in progress
+  orca_report_wire_t overflowReport;  // Decode target when the pool is dry
+  unsigned long poolDropFrames;       // Reports accepted with no free slot
+
+  static const int DEDUP_WINDOW_LEN = 16;
+
+  // Per-satellite stream state. The TDMA grid puts several transmitters
+  // on the air, and each carries its own sample_count sequence — a
+  // duplicate from one node must not shadow another's report, a delta
+  // frame decodes against its own node's previous report, and one blended
+  // RSSI figure would steer the power loop wrong for everyone. Fixed-
+  // capacity table, no heap: slots are claimed on first sight and every
+  // lookup is bounded by the compile-time slot count, so per-packet cost
+  // (and RX-to-PWM latency) stays flat as the fleet grows. Sized to the
+  // satellite's FLEET_SLOT_COUNT.
+  static const int NODE_SLOT_COUNT = 6;
+  struct NodeState {
+    bool inUse;
+    uint16_t nodeId;
+
+    // Delta frames need this node's previous report to apply against
+    orca_report_wire_t lastReport;
+    bool lastReportValid;
+
+    uint32_t lastSampleCount;   // Highest sample_count delivered to control
+    bool seqValid;              // lastSampleCount holds a real value
+
+    // Dedup/reorder window: the store-and-forward queue and retry policies
+    // make duplicated and late reports normal, and sample_count is the
+    // only sequence signal. Recently seen sequence numbers kill exact
+    // duplicates; anything at or below the highest delivered sequence is
+    // a late retransmission that improves completeness but must not reach
+    // the PWM, which only ever moves forward in time.
+    uint32_t recentSeq[DEDUP_WINDOW_LEN];
+    uint8_t recentSeqIdx;
+    uint8_t recentSeqCount;
+
+    float rssiEwma, snrEwma;    // Per-node link telemetry
+    bool ewmaValid;
+    unsigned long frames;       // Packets accepted from this node
+    unsigned long lastHeardMs;  // millis() — eviction order if ever full
+  };
+  NodeState nodes[NODE_SLOT_COUNT];
+  uint8_t nodeCount;            // Slots in use
+  NodeState* rxNode;            // Slot the packet being decoded belongs to
+  NodeState* nodeSlot(uint16_t nodeId);
+
+  unsigned long duplicateFrames;
+  unsigned long staleFrames;    // Late retransmissions kept off the PWM
+
+  unsigned long receivedFrames;
+  unsigned long corruptFrames;
+  unsigned long missedSamples;
+  float lastRssi;
+  uint32_t lastAirtimeMs;       // Time-on-air of the packet being decoded
+
+  // Link telemetry and adaptive-rate state
+  float rssiEwma, snrEwma;      // Rolling per-packet averages
+  bool linkEwmaValid;           // Averages hold real data
+  uint8_t currentSf;            // SF the radio is tuned to right now
+  unsigned long lastPacketMs;   // millis() of the last accepted packet
+  unsigned long packetsAtSf;    // Packets since the last rate change
+  unsigned long rateChanges;    // Accepted downshifts proposed
+  unsigned long rateFallbacks;  // Watchdog reversions to the SF9 floor
+
+  // Channel-mask negotiation: the mask the satellite is currently seen
+  // transmitting (all-ones for full frames) vs. the configured request
+  uint16_t satChannelMask;
+  uint8_t maskSendBackoff;      // Frames to wait before re-proposing
+
+  // Closed-loop TX power: delta recommendations off the RSSI margin
+  uint8_t powerSendBackoff;     // Frames to wait before the next nudge
+  unsigned long powerProposals; // Power frames sent
+
+  unsigned long authFailFrames; // Frames rejected by the SipHash tag
+  unsigned long solarRejectFrames; // Bright-at-night reports kept off the PWM
+
+  void updateLinkStats();
+  bool maybeProposeRate();
+  bool maybeProposePower();
+  void maybeProposeMask();
+  void followRateFrame(const uint8_t* buf, size_t len);
+  orca_report_wire_t* claimReport();
+  bool commitReport();
+  bool screenReport(const orca_report_wire_t& report);
+  bool decodeDelta(const uint8_t* buf, size_t len, orca_report_wire_t& out);
+  int decodeFrame(const uint8_t* buf, size_t len);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef LTTB_H
+#define LTTB_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+// Largest-triangle-three-buckets downsampling (Steinarsson): reduce a
+// uniformly sampled series to nOut points that keep the visual shape —
+// peaks, troughs and edges survive where plain decimation would alias
+// them away. The interior is split into nOut - 2 buckets; each bucket
+// keeps the point forming the largest triangle with the previously kept
+// point and the next bucket's centroid, and the first and last points
+// are kept unconditionally.
+//
+// y is any callable mapping index -> value, so a ring buffer needs no
+// flattening before the pass; outIdx receives the selected source
+// indices in ascending order and must hold nOut entries. One pass,
+// O(count) work, no allocation — and uint16_t indices cap the input at
+// 65535 points, plenty for a day ring. Header-only like the other
+// single-purpose helpers here.
+template <typename YFn>
+inline size_t lttbSelect(YFn y, size_t count, size_t nOut, uint16_t* outIdx) {
+  if (count == 0 || nOut == 0) {
+    return 0;
+  }
+  if (count <= nOut) {
+    for (size_t i = 0; i < count; i++) {
+      outIdx[i] = (uint16_t)i;
+    }
+    return count;
+  }
+  if (nOut < 3) {
+    // No room for buckets: just the endpoints the algorithm always keeps
+    outIdx[0] = 0;
+    if (nOut == 2) {
+      outIdx[1] = (uint16_t)(count - 1);
+    }
+    return nOut;
+  }
+
+  // count > nOut here, so every bucket spans more than one source index
+  const float bucket = (float)(count - 2) / (float)(nOut - 2);
+  size_t kept = 0;
+  outIdx[kept++] = 0;
+  size_t prev = 0;
+
+  for (size_t b = 0; b + 2 < nOut; b++) {
+    size_t lo = 1 + (size_t)((float)b * bucket);
+    size_t hi = 1 + (size_t)((float)(b + 1) * bucket);
+    if (hi > count - 1) {
+      hi = count - 1;
+    }
+
+    // Third triangle corner: the next bucket's centroid — or the final
+    // point itself once this is the last interior bucket
+    size_t nlo = hi;
+    size_t nhi = 1 + (size_t)((float)(b + 2) * bucket);
+    if (nhi > count - 1) {
+      nhi = count - 1;
+    }
+    if (b + 3 == nOut) {
+      nlo = count - 1;
+      nhi = count;
+    }
+    float cx = 0.0f, cy = 0.0f;
+    for (size_t i = nlo; i < nhi; i++) {
+      cx += (float)i;
+      cy += y(i);
+    }
+    const float cn = (float)(nhi - nlo);
+    cx /= cn;
+    cy /= cn;
+
+    const float px = (float)prev;
+    const float py = y(prev);
+    float best = -1.0f;
+    size_t bestIdx = lo;
+    for (size_t i = lo; i < hi; i++) {
+      // Twice the triangle area; the factor cancels in the comparison
+      float area = (px - cx) * (y(i) - py) - (px - (float)i) * (cy - py);
+      if (area < 0.0f) {
+        area = -area;
+      }
+      if (area > best) {
+        best = area;
+        bestIdx = i;
+      }
+    }
+    outIdx[kept++] = (uint16_t)bestIdx;
+    prev = bestIdx;
+  }
+
+  outIdx[kept++] = (uint16_t)(count - 1);
+  return kept;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#include "LuxStats.h"
+#include <limits.h>
+
+void LuxAgg::reset() {
+  count = 0;
+  sum = 0;
+  minV = INT_MAX;
+  maxV = INT_MIN;
+}
+
+void LuxAgg::add(int v) {
+  count++;
+  sum += (uint64_t)v;
+  if (v < minV) minV = v;
+  if (v > maxV) maxV = v;
+}
+
+void LuxAgg::merge(const LuxAgg& other) {
+  if (other.count == 0) return;
+  count += other.count;
+  sum += other.sum;
+  if (other.minV < minV) minV = other.minV;
+  if (other.maxV > maxV) maxV = other.maxV;
+}
+
+int LuxAgg::mean() const {
+  return count == 0 ? 0 : (int)(sum / count);
+}
+
+LuxStats::LuxStats() : secIdx(0), minIdx(0), hourIdx(0),
+                       secFill(0), minFill(0), hourFill(0),
+                       curSecond(0), curMinute(0), curHour(0), started(false) {
+  secCur.reset();
+  minCur.reset();
+  hourCur.reset();
+}
+
+// Close the open second into the second ring and fold it into the open
+// minute; closing cascades upward, so each sample is touched once per tier
+void LuxStats::closeSecond() {
+  secRing[secIdx] = secCur;
+  secIdx = (secIdx + 1) % SEC_BUCKETS;
+  if (secFill < SEC_BUCKETS) secFill++;
+  minCur.merge(secCur);
+  secCur.reset();
+}
+
+void LuxStats::closeMinute() {
+  minRing[minIdx] = minCur;
+  minIdx = (minIdx + 1) % MIN_BUCKETS;
+  if (minFill < MIN_BUCKETS) minFill++;
+  hourCur.merge(minCur);
+  minCur.reset();
+}
+
+void LuxStats::closeHour() {
+  hourRing[hourIdx] = hourCur;
+  hourIdx = (hourIdx + 1) % HOUR_BUCKETS;
+  if (hourFill < HOUR_BUCKETS) hourFill++;
+  hourCur.reset();
+}
+
+void LuxStats::push(int lux, unsigned long nowMs) {
+  unsigned long second = nowMs / 1000UL;
+  unsigned long minute = second / 60UL;
+  unsigned long hour = minute / 60UL;
+
+  if (!started) {
+    started = true;
+    curSecond = second;
+    curMinute = minute;
+    curHour = hour;
+  }
+
+  // Boundary crossings close buckets before the new sample lands. A gap in
+  // the stream (no samples for a while) just leaves empty closed buckets
+  // behind, which merge as no-ops — no catch-up loop needed.
+  if (second != curSecond) {
+    closeSecond();
+    curSecond = second;
+  }
+  if (minute != curMinute) {
+    closeMinute();
+    curMinute = minute;
+  }
+  if (hour != curHour) {
+    closeHour();
+    curHour = hour;
+  }
+
+  secCur.add(lux);
+}
+
+// Queries merge the newest n closed buckets plus the open one — O(n) over
+// aggregates, never over samples. n is clamped to what the tier holds.
+LuxAgg LuxStats::overSeconds(int n) const {
+  LuxAgg out;
+  out.reset();
+  out.merge(secCur);
+  if (n > secFill) n = secFill;
+  for (int i = 1; i <= n; i++) {
+    out.merge(secRing[(secIdx + SEC_BUCKETS - i) % SEC_BUCKETS]);
+  }
+  return out;
+}
+
+LuxAgg LuxStats::overMinutes(int n) const {
+  LuxAgg out;
+  out.reset();
+  out.merge(secCur);
+  out.merge(minCur);
+  if (n > minFill) n = minFill;
+  for (int i = 1; i <= n; i++) {
+    out.merge(minRing[(minIdx + MIN_BUCKETS - i) % MIN_BUCKETS]);
+  }
+  return out;
+}
+
+LuxAgg LuxStats::overHours(int n) const {
+  LuxAgg out;
+  out.reset();
+  out.merge(secCur);
+  out.merge(minCur);
+  out.merge(hourCur);
+  if (n > hourFill) n = hourFill;
+  for (int i = 1; i <= n; i++) {
+    out.merge(hourRing[(hourIdx + HOUR_BUCKETS - i) % HOUR_BUCKETS]);
+  }
+  return out;
+}
@@ -0,0 +1,60 @@
+#ifndef LUX_STATS_H
+#define LUX_STATS_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#endif
+
+// Hierarchical aggregate index over the lux stream: per-second, per-minute
+// and per-hour buckets of count/sum/min/max, maintained incrementally as
+// samples arrive. A query like "mean lux over the last hour" walks at most
+// 60 closed buckets instead of rescanning 180k raw samples, so on-LCD and
+// serial statistics stay off the ingestion/control hot path entirely.
+
+// One aggregate bucket; merging two buckets is count/sum adds plus min/max
+struct LuxAgg {
+  uint32_t count;
+  uint64_t sum;
+  int minV;
+  int maxV;
+
+  void reset();
+  void add(int v);
+  void merge(const LuxAgg& other);
+  int mean() const;  // 0 when empty
+};
+
+class LuxStats {
+public:
+  LuxStats();
+  void push(int lux, unsigned long nowMs);  // O(1) amortized per sample
+  LuxAgg overSeconds(int n) const;  // Last n seconds (n <= 60), incl. partial
+  LuxAgg overMinutes(int n) const;  // Last n minutes (n <= 60), incl. partial
+  LuxAgg overHours(int n) const;    // Last n hours (n <= 24), incl. partial
+
+private:
+  // Closed buckets per tier; the current (still-filling) bucket is separate
+  static const int SEC_BUCKETS = 60;
+  static const int MIN_BUCKETS = 60;
+  static const int HOUR_BUCKETS = 24;
+
+  LuxAgg secRing[SEC_BUCKETS];
+  LuxAgg minRing[MIN_BUCKETS];
+  LuxAgg hourRing[HOUR_BUCKETS];
+  int secIdx, minIdx, hourIdx;        // Next write slot per ring
+  int secFill, minFill, hourFill;     // Closed buckets held (ramp-up)
+  LuxAgg secCur, minCur, hourCur;     // Accumulating buckets
+  unsigned long curSecond;            // nowMs / 1000 of the open second
+  unsigned long curMinute;
+  unsigned long curHour;
+  bool started;
+
+  void closeSecond();
+  void closeMinute();
+  void closeHour();
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef MIX_MATRIX_H
+#define MIX_MATRIX_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+// Compile-time generation of the spectral->LED mixing matrix. The weights
+// used to be tuned by hand; now they fall out of physics the compiler can
+// evaluate: each sensor band and each LED strip is modelled as a Gaussian
+// (center + FWHM), the band/emitter overlap integral gives the raw
+// weight, and every row is normalized to sum to exactly 1 << Shift so a
+// flat spectrum still maps to the same drive level on every strip. All of
+// it runs in a constexpr constructor — the table lands in flash as plain
+// data, and the runtime cost stays what it was: one fixed-point dot
+// product per strip. Retuning for new strip hardware is now a one-line
+// emitter edit instead of re-deriving thirteen weights.
+//
+// Near-zero overlaps (under 2% of the row peak) are clamped to zero, so
+// the generated matrix keeps the sparsity of the hand-tuned one and a
+// strip never twitches on a band it cannot meaningfully reproduce.
+
+// One AS7343 interference-filter band: center and FWHM in nm. fwhmNm == 0
+// marks a band with no defined passband (CLEAR), which mixes into nothing.
+struct MixBand {
+  uint16_t centerNm;
+  uint16_t fwhmNm;
+};
+
+// AS7343 channel passbands (datasheet table 6) in report wire order:
+// f1 f2 fz f3 f4 f5 fy f6 fxl f7 f8 nir clear. The driver header defines
+// the channel order; the optical centers live here because only the
+// mixing math needs them.
+constexpr MixBand AS7343_BANDS[13] = {
+  { 405, 30 },   // F1
+  { 425, 22 },   // F2
+  { 450, 55 },   // FZ
+  { 475, 30 },   // F3
+  { 515, 40 },   // F4
+  { 550, 35 },   // F5
+  { 555, 100 },  // FY
+  { 640, 50 },   // F6
+  { 600, 80 },   // FXL
+  { 690, 55 },   // F7
+  { 745, 60 },   // F8
+  { 855, 54 },   // NIR
+  { 0,   0 },    // CLEAR — broadband, carries no spectral shape
+};
+
+// One LED strip emitter, same Gaussian model
+struct MixEmitter {
+  uint16_t peakNm;
+  uint16_t fwhmNm;
+};
+
+namespace mixdetail {
+
+// e^-x via (1 + x/64)^-64: monotone, within a few percent over the range
+// the overlap math visits, and the error washes out in row normalization
+constexpr float expNeg(float x) {
+  float p = 1.0f + x / 64.0f;
+  p = p * p;
+  p = p * p;
+  p = p * p;
+  p = p * p;
+  p = p * p;
+  p = p * p;
+  return 1.0f / p;
+}
+
+// Overlap of two Gaussians: exp(-d^2 / (2 (s1^2 + s2^2))), FWHM -> sigma
+// via the usual 2.3548 factor. Amplitude-only — normalization is per row.
+constexpr float overlap(const MixBand& b, const MixEmitter& e) {
+  if (b.fwhmNm == 0) {
+    return 0.0f;
+  }
+  const float s1 = (float)b.fwhmNm / 2.3548f;
+  const float s2 = (float)e.fwhmNm / 2.3548f;
+  const float d = (float)b.centerNm - (float)e.peakNm;
+  return expNeg((d * d) / (2.0f * (s1 * s1 + s2 * s2)));
+}
+
+}  // namespace mixdetail
+
+template <size_t NLed, size_t NSrc, unsigned Shift = 12>
+struct MixMatrix {
+  uint16_t w[NLed][NSrc];
+
+  constexpr MixMatrix(const MixEmitter (&leds)[NLed],
+                      const MixBand (&bands)[NSrc])
+      : w{} {
+    for (size_t led = 0; led < NLed; led++) {
+      float raw[NSrc] = {};
+      float peak = 0.0f;
+      for (size_t s = 0; s < NSrc; s++) {
+        raw[s] = mixdetail::overlap(bands[s], leds[led]);
+        if (raw[s] > peak) {
+          peak = raw[s];
+        }
+      }
+      // Sparsify, then normalize the survivors to sum to 1 << Shift
+      float sum = 0.0f;
+      for (size_t s = 0; s < NSrc; s++) {
+        if (raw[s] < peak * 0.02f) {
+          raw[s] = 0.0f;
+        }
+        sum += raw[s];
+      }
+      uint32_t rowSum = 0;
+      size_t maxIdx = 0;
+      for (size_t s = 0; s < NSrc; s++) {
+        w[led][s] = (uint16_t)(raw[s] / sum * (float)(1u << Shift) + 0.5f);
+        rowSum += w[led][s];
+        if (w[led][s] > w[led][maxIdx]) {
+          maxIdx = s;
+        }
+      }
+      // Rounding residue lands on the dominant band so the row sum is
+      // exact and a flat spectrum drives every strip identically
+      w[led][maxIdx] = (uint16_t)((int32_t)w[led][maxIdx] +
+                                  (int32_t)(1u << Shift) - (int32_t)rowSum);
+    }
+  }
+
+  constexpr uint32_t rowSum(size_t led) const {
+    uint32_t sum = 0;
+    for (size_t s = 0; s < NSrc; s++) {
+      sum += w[led][s];
+    }
+    return sum;
+  }
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "OtaUpdate.h"
+
+#include "InputOutput.h"
+#include "Log.h"
+#include "OtaPatch.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+
+// OTA endpoints (see OtaUpdate.h). Both handlers stream: nothing larger
+// than the receive chunk is ever buffered in RAM, so a full-size image
+// passes through the same few kilobytes the dashboard uses.
+
+extern InputOutput io;
+
+#define OTA_RECV_CHUNK 1024
+
+// Reply, give the TCP stack a moment to flush, then latch the LED pads
+// and reboot into the freshly written partition
+static void otaFinishAndReboot(httpd_req_t* req, const char* msg) {
+  httpd_resp_set_type(req, "text/plain");
+  httpd_resp_sendstr(req, msg);
+  LOG_INFO("OTA: %s — rebooting", msg);
+  vTaskDelay(pdMS_TO_TICKS(250));
+  io.latchOutputsForReset();
+  esp_restart();
+}
+
+static esp_err_t otaFail(httpd_req_t* req, const char* msg) {
+  LOG_ERROR("OTA: %s", msg);
+  httpd_resp_set_status(req, "400 Bad Request");
+  httpd_resp_set_type(req, "text/plain");
+  httpd_resp_sendstr(req, msg);
+  return ESP_OK; // the HTTP exchange itself succeeded
+}
+
+/* ---------- Full image upload ---------- */
+
+static esp_err_t otaFullHandler(httpd_req_t* req) {
+  const esp_partition_t* target = esp_ota_get_next_update_partition(NULL);
+  if (target == NULL) {
+    return otaFail(req, "no inactive OTA partition");
+  }
+
+  esp_ota_handle_t ota;
+  if (esp_ota_begin(target, OTA_SIZE_UNKNOWN, &ota) != ESP_OK) {
+    return otaFail(req, "esp_ota_begin failed");
+  }
+
+  uint8_t buf[OTA_RECV_CHUNK];
+  size_t remaining = req->content_len;
+  while (remaining > 0) {
+    int got = httpd_req_recv(req, (char*)buf,
+                             remaining < sizeof(buf) ? remaining : sizeof(buf));
+    if (got <= 0) {
+      esp_ota_abort(ota);
+      return otaFail(req, "upload interrupted");
+    }
+    if (esp_ota_write(ota, buf, got) != ESP_OK) {
+      esp_ota_abort(ota);
+      return otaFail(req, "flash write failed");
+    }
+    remaining -= got;
+  }
+
+  if (esp_ota_end(ota) != ESP_OK ||
+      esp_ota_set_boot_partition(target) != ESP_OK) {
+    return otaFail(req, "image validation failed");
+  }
+  otaFinishAndReboot(req, "full image accepted");
+  return ESP_OK;
+}
+
+/* ---------- Delta patch upload ---------- */
+
+// Applier callbacks: base reads come from the running partition, output
+// bytes go to the esp_ota session on the inactive one
+struct PatchCtx {
+  const esp_partition_t* base;
+  esp_ota_handle_t ota;
+};
+
+static int patchReadBase(void* ctx, uint32_t off, void* buf, size_t len) {
+  PatchCtx* p = (PatchCtx*)ctx;
+  return esp_partition_read(p->base, off, buf, len) == ESP_OK ? 0 : -1;
+}
+
+static int patchWriteOut(void* ctx, const void* buf, size_t len) {
+  PatchCtx* p = (PatchCtx*)ctx;
+  return esp_ota_write(p->ota, buf, len) == ESP_OK ? 0 : -1;
+}
+
+// The patch header claims a base size and CRC; check them against the
+// running partition before esp_ota_begin erases anything. A delta built
+// against any other version dies here with the old image untouched.
+static bool baseMatches(const esp_partition_t* base, const ota_patch_hdr_t& hdr) {
+  if (hdr.base_size > base->size) {
+    return false;
+  }
+  uint8_t buf[256];
+  uint32_t crc = 0;
+  uint32_t off = 0;
+  while (off < hdr.base_size) {
+    size_t n = hdr.base_size - off;
+    if (n > sizeof(buf)) n = sizeof(buf);
+    if (esp_partition_read(base, off, buf, n) != ESP_OK) {
+      return false;
+    }
+    crc = ota_patch_crc32(crc, buf, n);
+    off += n;
+  }
+  return crc == hdr.base_crc;
+}
+
+static esp_err_t otaPatchHandler(httpd_req_t* req) {
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  const esp_partition_t* target = esp_ota_get_next_update_partition(NULL);
+  if (running == NULL || target == NULL) {
+    return otaFail(req, "no inactive OTA partition");
+  }
+  if (req->content_len < OTA_PATCH_HEADER_SIZE) {
+    return otaFail(req, "patch shorter than its header");
+  }
+
+  // Pull the fixed-size header first so the base check can run before
+  // the inactive partition is touched
+  uint8_t hdrBuf[OTA_PATCH_HEADER_SIZE];
+  size_t hdrGot = 0;
+  while (hdrGot < sizeof(hdrBuf)) {
+    int got = httpd_req_recv(req, (char*)hdrBuf + hdrGot, sizeof(hdrBuf) - hdrGot);
+    if (got <= 0) {
+      return otaFail(req, "upload interrupted");
+    }
+    hdrGot += got;
+  }
+  if (ota_patch_rd32(hdrBuf) != OTA_PATCH_MAGIC) {
+    return otaFail(req, "not a patch (bad magic)");
+  }
+  ota_patch_hdr_t hdr;
+  hdr.base_size = ota_patch_rd32(hdrBuf + 4);
+  hdr.base_crc = ota_patch_rd32(hdrBuf + 8);
+  hdr.new_size = ota_patch_rd32(hdrBuf + 12);
+  hdr.new_crc = ota_patch_rd32(hdrBuf + 16);
+  if (!baseMatches(running, hdr)) {
+    return otaFail(req, "patch base does not match the running image");
+  }
+
+  PatchCtx ctx;
+  ctx.base = running;
+  if (esp_ota_begin(target, hdr.new_size, &ctx.ota) != ESP_OK) {
+    return otaFail(req, "esp_ota_begin failed");
+  }
+
+  ota_patch_apply_t apply;
+  ota_patch_apply_begin(&apply, patchReadBase, patchWriteOut, &ctx);
+  if (ota_patch_apply_feed(&apply, hdrBuf, sizeof(hdrBuf)) != 0) {
+    esp_ota_abort(ctx.ota);
+    return otaFail(req, "patch header rejected");
+  }
+
+  uint8_t buf[OTA_RECV_CHUNK];
+  size_t remaining = req->content_len - sizeof(hdrBuf);
+  while (remaining > 0) {
+    int got = httpd_req_recv(req, (char*)buf,
+                             remaining < sizeof(buf) ? remaining : sizeof(buf));
+    if (got <= 0) {
+      esp_ota_abort(ctx.ota);
+      return otaFail(req, "upload interrupted");
+    }
+    if (ota_patch_apply_feed(&apply, buf, got) != 0) {
+      esp_ota_abort(ctx.ota);
+      return otaFail(req, "malformed patch");
+    }
+    remaining -= got;
+  }
+  if (ota_patch_apply_finish(&apply) != 0) {
+    esp_ota_abort(ctx.ota);
+    return otaFail(req, "patched image failed its CRC");
+  }
+
+  if (esp_ota_end(ctx.ota) != ESP_OK ||
+      esp_ota_set_boot_partition(target) != ESP_OK) {
+    return otaFail(req, "image validation failed");
+  }
+  otaFinishAndReboot(req, "delta patch applied");
+  return ESP_OK;
+}
+
+void otaRegisterHandlers(httpd_handle_t server) {
+  static const httpd_uri_t uriOta = { "/ota", HTTP_POST, otaFullHandler, NULL };
+  static const httpd_uri_t uriOtaPatch = { "/ota/patch", HTTP_POST,
+                                           otaPatchHandler, NULL };
+  httpd_register_uri_handler(server, &uriOta);
+  httpd_register_uri_handler(server, &uriOtaPatch);
+}
@@ -0,0 +1,33 @@
+#ifndef OTA_UPDATE_H
+#define OTA_UPDATE_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "esp_http_server.h"
+
+// Over-the-air firmware updates through the web status server. Two POST
+// endpoints on the existing soft-AP:
+//
+//   /ota        — full image, streamed straight into the inactive
+//                 partition. The fallback when no common base exists.
+//   /ota/patch  — binary delta against the *running* image (OtaPatch.h
+//                 format, built shore-side against the exact version a
+//                 chamber reports). The running partition's CRC is
+//                 verified before a byte is written, so a patch built
+//                 against the wrong version is rejected, not applied.
+//
+// A recompile of this codebase is a few percent of the image; over a
+// ship-to-shore link that is seconds instead of tens of minutes, which
+// decides whether a performance fix reaches a deployed chamber mid-cruise
+// at all. On success the chamber latches its LED outputs (see
+// latchOutputsForReset) and reboots into the new image — the experiment
+// sees the boot time, not a dark gap.
+//
+// Everything runs in the httpd task at upload time only; the control
+// path is untouched until the reboot itself.
+
+// Register the OTA endpoints on the status server; called by
+// webStatusBegin() once httpd is up
+void otaRegisterHandlers(httpd_handle_t server);
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef P2_QUANTILE_H
+#define P2_QUANTILE_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#endif
+
+// Streaming quantile estimator (Jain & Chlamtac's P² algorithm): tracks one
+// quantile of an unbounded stream with five markers — O(1) time and ~40
+// bytes of state per quantile, versus copying and sorting the whole history
+// window on every update. Estimates converge to within a few percent of the
+// exact order statistic on the smooth, slowly drifting signals seen here.
+//
+// Header-only so both the chamber firmware and the standalone prototype
+// sketches can use it without a build-system change.
+class P2Quantile {
+public:
+  explicit P2Quantile(float p) : prob(p), n(0) {}
+
+  // Feed one observation; the first five just seed the markers
+  void add(float x) {
+    if (n < 5) {
+      // Insertion-sort the seed into the marker heights
+      int i = (int)n;
+      while (i > 0 && q[i - 1] > x) {
+        q[i] = q[i - 1];
+        i--;
+      }
+      q[i] = x;
+      n++;
+      if (n == 5) {
+        for (int j = 0; j < 5; j++) pos[j] = j + 1;
+        npos[0] = 1.0f;
+        npos[1] = 1.0f + 2.0f * prob;
+        npos[2] = 1.0f + 4.0f * prob;
+        npos[3] = 3.0f + 2.0f * prob;
+        npos[4] = 5.0f;
+        dn[0] = 0.0f;
+        dn[1] = prob / 2.0f;
+        dn[2] = prob;
+        dn[3] = (1.0f + prob) / 2.0f;
+        dn[4] = 1.0f;
+      }
+      return;
+    }
+
+    // Locate the cell and stretch the extreme markers if needed
+    int k;
+    if (x < q[0]) {
+      q[0] = x;
+      k = 0;
+    } else if (x >= q[4]) {
+      q[4] = x;
+      k = 3;
+    } else {
+      k = 0;
+      while (k < 3 && x >= q[k + 1]) k++;
+    }
+
+    for (int i = k + 1; i < 5; i++) pos[i]++;
+    for (int i = 0; i < 5; i++) npos[i] += dn[i];
+    n++;
+
+    // Nudge the three interior markers toward their desired positions,
+    // parabolic (PP) prediction with a linear fallback when it would
+    // break marker ordering
+    for (int i = 1; i <= 3; i++) {
+      float d = npos[i] - pos[i];
+      if ((d >= 1.0f && pos[i + 1] - pos[i] > 1) ||
+          (d <= -1.0f && pos[i - 1] - pos[i] < -1)) {
+        int s = (d >= 0.0f) ? 1 : -1;
+        float qp = parabolic(i, s);
+        if (q[i - 1] < qp && qp < q[i + 1]) {
+          q[i] = qp;
+        } else {
+          q[i] = linear(i, s);
+        }
+        pos[i] += s;
+      }
+    }
+  }
+
+  // Current estimate; before five samples, the median of what's been seen
+  float value() const {
+    if (n == 0) return 0.0f;
+    if (n < 5) return q[n / 2];
+    return q[2];
+  }
+
+  uint32_t count() const { return n; }
+
+private:
+  float prob;
+  uint32_t n;
+  float q[5];     // Marker heights (q[2] is the estimate once running)
+  int pos[5];     // Actual marker positions
+  float npos[5];  // Desired marker positions
+  float dn[5];    // Desired-position increments per observation
+
+  float parabolic(int i, int s) const {
+    return q[i] + (float)s / (pos[i + 1] - pos[i - 1]) *
+        ((pos[i] - pos[i - 1] + s) * (q[i + 1] - q[i]) / (pos[i + 1] - pos[i]) +
+         (pos[i + 1] - pos[i] - s) * (q[i] - q[i - 1]) / (pos[i] - pos[i - 1]));
+  }
+
+  float linear(int i, int s) const {
+    return q[i] + s * (q[i + s] - q[i]) / (pos[i + s] - pos[i]);
+  }
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "Replay.h"
+
+#include "DataLog.h"
+#include "Log.h"
+
+// Replay engine (see Replay.h). One low-priority task streams the
+// logical datalog page by page, reassembles the [0xD5][type][len][payload]
+// envelopes across page boundaries, and paces each report record at the
+// recorded cadence divided by the acceleration factor. Everything here
+// runs off the control path: the only interaction with the live pipeline
+// is the injection callback, which costs the same as a radio arrival.
+
+#define REPLAY_PAGE_SIZE 512
+// Largest envelope we reassemble: header plus the biggest record the
+// logger writes (a batch lux frame); anything larger is skipped whole
+#define REPLAY_REC_MAX 160
+
+static ReplayReportFn s_onReport = NULL;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_stopRequested = false;
+
+// Progress counters, written by the replay task, read by toString()
+static volatile uint32_t s_accel = 0;
+static volatile unsigned long s_records = 0;
+static volatile unsigned long s_injected = 0;
+static volatile unsigned long s_violations = 0;
+static unsigned long s_startMs = 0;
+static unsigned long s_doneMs = 0;  // 0 while running
+
+static void replayTask(void*) {
+  // Page buffer with room to carry a partial envelope into the next page
+  static uint8_t buf[REPLAY_REC_MAX + REPLAY_PAGE_SIZE];
+  size_t carry = 0;
+  uint32_t page = 0;
+  const uint32_t delayMs = REPLAY_BASE_PERIOD_MS / s_accel;
+
+  for (;;) {
+    if (s_stopRequested) {
+      break;
+    }
+    size_t got = dataLogReadPage(page++, buf + carry, REPLAY_PAGE_SIZE);
+    if (got == 0) {
+      break;  // end of the flushed log
+    }
+    size_t len = carry + got;
+    size_t pos = 0;
+
+    while (pos + 4 <= len) {
+      if (buf[pos] != 0xD5) {
+        pos++;  // resync — a rotated-out file can start mid-record
+        continue;
+      }
+      uint8_t type = buf[pos + 1];
+      uint16_t plen = (uint16_t)(buf[pos + 2] | (buf[pos + 3] << 8));
+      if (plen > REPLAY_REC_MAX - 4) {
+        pos++;  // implausible length: treat the magic as payload noise
+        continue;
+      }
+      if (pos + 4 + plen > len) {
+        break;  // record straddles the page boundary — carry it over
+      }
+
+      s_records++;
+      if (type == DATALOG_REC_REPORT && plen >= ORCA_REPORT_WIRE_SIZE) {
+        // Stage budget: the extract-and-inject pass for one record must
+        // fit the budget or the run is flagged — this is the assertion
+        // that catches a pipeline regression at 60x, where a slow stage
+        // cannot hide behind the report cadence
+        unsigned long t0 = micros();
+        orca_report_wire_t report;
+        memcpy(&report, buf + pos + 4, sizeof(report));
+        s_onReport(report);
+        if (micros() - t0 > REPLAY_STAGE_BUDGET_US) {
+          s_violations++;
+        }
+        s_injected++;
+
+        // Pace at the accelerated report cadence; sub-tick delays floor
+        // at one tick, which bounds the usable acceleration
+        vTaskDelay(pdMS_TO_TICKS(delayMs > 0 ? delayMs : 1));
+        if (s_stopRequested) {
+          break;
+        }
+      }
+      pos += 4 + plen;
+    }
+
+    carry = len - pos;
+    if (carry > REPLAY_REC_MAX) {
+      carry = 0;  // stuck mid-noise: drop the tail and resync next page
+    } else {
+      memmove(buf, buf + pos, carry);
+    }
+  }
+
+  s_doneMs = millis();
+  LOG_INFO("replay: done — %lu records, %lu injected, %lu budget "
+           "violations, %lu s wall at %lux",
+           (unsigned long)s_records, (unsigned long)s_injected,
+           (unsigned long)s_violations,
+           (s_doneMs - s_startMs) / 1000UL, (unsigned long)s_accel);
+  s_task = NULL;
+  vTaskDelete(NULL);
+}
+
+void replayBegin(ReplayReportFn onReport) {
+  s_onReport = onReport;
+}
+
+bool replayStart(uint32_t accel) {
+  if (s_task != NULL || s_onReport == NULL || accel == 0) {
+    return false;
+  }
+  s_accel = accel;
+  s_records = 0;
+  s_injected = 0;
+  s_violations = 0;
+  s_startMs = millis();
+  s_doneMs = 0;
+  s_stopRequested = false;
+  // Core 0 with ingestion: replay is an input source, and the control
+  // task on core 1 must keep preempting it exactly like live traffic
+  if (xTaskCreatePinnedToCore(replayTask, "replay", 4096, NULL, 1,
+                              &s_task, 0) != pdPASS) {
+    s_task = NULL;
+    return false;
+  }
+  return true;
+}
+
+void replayStop() {
+  s_stopRequested = true;
+}
+
+bool replayActive() {
+  return s_task != NULL;
+}
+
+const char* replayToString() {
+  static char buf[96];
+  snprintf(buf, sizeof(buf),
+           "replay %s %lux: %lu rec, %lu injected, %lu viol",
+           s_task != NULL ? "RUNNING" : "idle", (unsigned long)s_accel,
+           (unsigned long)s_records, (unsigned long)s_injected,
+           (unsigned long)s_violations);
+  return buf;
+}
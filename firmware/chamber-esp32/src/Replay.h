@@ -0,0 +1,40 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "orca_payload.h"
+
+// Accelerated light-cycle replay: walks the flash datalog's report
+// records and re-injects them into the live spectral pipeline (mix ->
+// trend interpolation -> setSpectralPWM) at a configurable multiple of
+// the recorded cadence, so a full dawn-to-dusk cycle validates in
+// minutes instead of a day. Driven over serial ("replay <accel>" /
+// "replay stop"); the injection callback is registered by main, which
+// owns the control hand-off — replay itself never touches control state.
+//
+// The decode-to-PWM latency histogram keeps scoring replayed reports
+// exactly like radio arrivals, and replay adds its own stage budget: any
+// record whose extract-and-inject pass overruns REPLAY_STAGE_BUDGET_US
+// is counted as a violation and reported in the summary, so a pipeline
+// regression fails the replay instead of hiding in averages. Lux-frame
+// records are skipped — byte-level replay of the serial stream lives in
+// the host harness (replay_trace), where it can run clockless.
+typedef void (*ReplayReportFn)(const orca_report_wire_t& report);
+
+// Register the injection callback; called once from setup()
+void replayBegin(ReplayReportFn onReport);
+
+// Start replaying the datalog at accel x recorded speed. Returns false
+// when a replay is already running or no callback is registered.
+bool replayStart(uint32_t accel);
+
+// Request the replay task to wind down (it exits at the next record)
+void replayStop();
+
+bool replayActive();
+
+// Progress/summary line in a static buffer (no heap), for the periodic log
+const char* replayToString();
+
+#endif
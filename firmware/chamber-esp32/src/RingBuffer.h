@@ -0,0 +1,75 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// Fixed-capacity ring buffer with static storage: capacity is a template
+// parameter, so there is no heap allocation at construction, the compiler
+// knows every modulus at compile time, and two previously divergent
+// hand-rolled rings (the receiver prototype's malloc'd CircularBuffer and
+// InputOutput's lux window) share one implementation.
+//
+// operator[] and the iterators index chronologically (0 = oldest held
+// sample). data() exposes the raw slot array for callers that index by a
+// monotonically increasing sample sequence — after n pushes, the sample
+// with sequence s lives in slot s % N.
+template <typename T, size_t N>
+class RingBuffer {
+public:
+  RingBuffer() : head(0), count(0) {}
+
+  void push(const T& v) {
+    buf[head] = v;
+    head = (head + 1) % N;
+    if (count < N) count++;
+  }
+
+  size_t size() const { return count; }
+  size_t capacity() const { return N; }
+  bool empty() const { return count == 0; }
+  bool full() const { return count == N; }
+
+  void clear() {
+    head = 0;
+    count = 0;
+  }
+
+  T& operator[](size_t i) { return buf[physical(i)]; }
+  const T& operator[](size_t i) const { return buf[physical(i)]; }
+
+  T* data() { return buf; }
+  const T* data() const { return buf; }
+
+  class const_iterator {
+  public:
+    const_iterator(const RingBuffer* r, size_t idx) : rb(r), i(idx) {}
+    const T& operator*() const { return (*rb)[i]; }
+    const_iterator& operator++() { ++i; return *this; }
+    bool operator==(const const_iterator& o) const { return i == o.i; }
+    bool operator!=(const const_iterator& o) const { return i != o.i; }
+
+  private:
+    const RingBuffer* rb;
+    size_t i;
+  };
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, count); }
+
+private:
+  // Oldest element's slot: once full, the next write slot is the oldest
+  size_t start() const { return (count == N) ? head : 0; }
+  size_t physical(size_t i) const { return (start() + i) % N; }
+
+  T buf[N];
+  size_t head;
+  size_t count;
+};
+
+#endif
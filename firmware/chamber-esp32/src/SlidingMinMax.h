@@ -0,0 +1,72 @@
+#ifndef SLIDING_MIN_MAX_H
+#define SLIDING_MIN_MAX_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "RingBuffer.h"
+
+// Sliding-window min/max over the last N pushed samples, via monotonic
+// deques of sample sequence numbers: each sample is pushed and popped at
+// most once per deque, so the per-push cost is O(1) amortized instead of a
+// full O(N) rescan. Deque capacity is N + 1 so head == tail means empty.
+// Extracted from InputOutput so the bounds maintenance is testable (and
+// benchmarkable) off-target.
+template <int N>
+class SlidingMinMax {
+public:
+  SlidingMinMax() : minHead(0), minTail(0), maxHead(0), maxTail(0), seq(0) {}
+
+  void push(int v) {
+    const int cap = N + 1;
+    long s = seq++;
+
+    // Drop entries that just slid out of the window. The expired entry is
+    // the one occupying the ring slot we are about to overwrite, so this
+    // must run before the slot is reused.
+    long expire = s - N;
+    while (minHead != minTail && minDeque[minHead] <= expire)
+      minHead = (minHead + 1) % cap;
+    while (maxHead != maxTail && maxDeque[maxHead] <= expire)
+      maxHead = (maxHead + 1) % cap;
+
+    // Pop dominated entries from the back to keep the deques monotonic:
+    // min-deque values increase head->tail, max-deque values decrease
+    const int* slots = window.data();  // Raw slot access, indexed by seq % N
+    while (minHead != minTail) {
+      int back = (minTail + cap - 1) % cap;
+      if (slots[minDeque[back] % N] >= v) minTail = back;
+      else break;
+    }
+    while (maxHead != maxTail) {
+      int back = (maxTail + cap - 1) % cap;
+      if (slots[maxDeque[back] % N] <= v) maxTail = back;
+      else break;
+    }
+
+    // Store the sample (push writes slot seq % N) and push onto both deques
+    window.push(v);
+    minDeque[minTail] = s; minTail = (minTail + 1) % cap;
+    maxDeque[maxTail] = s; maxTail = (maxTail + 1) % cap;
+  }
+
+  int minValue() const { return window.data()[minDeque[minHead] % N]; }
+  int maxValue() const { return window.data()[maxDeque[maxHead] % N]; }
+  size_t size() const { return window.size(); }
+  bool full() const { return window.full(); }
+
+private:
+  RingBuffer<int, N> window;
+  long minDeque[N + 1];
+  long maxDeque[N + 1];
+  int minHead, minTail;
+  int maxHead, maxTail;
+  long seq;  // Monotonic count of samples pushed
+};
+
+#endif
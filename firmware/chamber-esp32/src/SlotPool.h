@@ -0,0 +1,77 @@
+#ifndef SLOT_POOL_H
+#define SLOT_POOL_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// Fixed pool of reusable slots with lock-free index hand-off, for moving
+// bulky records between tasks without copying them: the producing task
+// acquires a slot, fills it in place and publishes the index; the
+// consuming task takes the index, reads the slot in place and releases it
+// back to the pool. Two SPSC index rings carry the hand-off (free ring:
+// release -> acquire, ready ring: publish -> take), each following the
+// same volatile head/tail discipline as the sample rings in main.cpp, so
+// no lock is needed as long as each of the four operations stays on a
+// single task. The rings hold N+1 entries for N slots, so publish and
+// release can never find their ring full — only acquire can fail, and
+// only when every slot is genuinely in flight downstream.
+template <typename T, size_t N>
+class SlotPool {
+public:
+  static_assert(N <= 255, "slot indices travel as uint8_t");
+
+  SlotPool() : freeHead((uint8_t)N), freeTail(0), readyHead(0), readyTail(0) {
+    for (size_t i = 0; i < N; i++) {
+      freeRing[i] = (uint8_t)i;
+    }
+  }
+
+  size_t capacity() const { return N; }
+
+  // Claim a free slot to fill in place (producer side). Returns -1 when
+  // every slot is still held downstream.
+  int acquire() {
+    if (freeTail == freeHead) return -1;
+    int idx = freeRing[freeTail];
+    freeTail = (uint8_t)((freeTail + 1) % (N + 1));
+    return idx;
+  }
+
+  T& at(int idx) { return slots[idx]; }
+  const T& at(int idx) const { return slots[idx]; }
+
+  // Hand a filled slot to the consumer (producer side; cannot fail)
+  void publish(int idx) {
+    readyRing[readyHead] = (uint8_t)idx;
+    readyHead = (uint8_t)((readyHead + 1) % (N + 1));
+  }
+
+  // Oldest published slot index (consumer side); -1 when none are waiting
+  int take() {
+    if (readyTail == readyHead) return -1;
+    int idx = readyRing[readyTail];
+    readyTail = (uint8_t)((readyTail + 1) % (N + 1));
+    return idx;
+  }
+
+  // Return a slot to the pool once its contents are no longer referenced
+  // (consumer side; cannot fail)
+  void release(int idx) {
+    freeRing[freeHead] = (uint8_t)idx;
+    freeHead = (uint8_t)((freeHead + 1) % (N + 1));
+  }
+
+private:
+  T slots[N];
+  uint8_t freeRing[N + 1];
+  uint8_t readyRing[N + 1];
+  volatile uint8_t freeHead, freeTail;
+  volatile uint8_t readyHead, readyTail;
+};
+
+#endif
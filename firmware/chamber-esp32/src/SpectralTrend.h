@@ -0,0 +1,77 @@
+#ifndef SPECTRAL_TREND_H
+#define SPECTRAL_TREND_H
+
+// Pure logic — compiles on the host for the unit-test harness as well
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// Predictive hold between LoRa reports: with the satellite transmitting
+// every few seconds the spectral PWM would otherwise step discontinuously
+// while the real sky changes continuously. This fits a per-channel linear
+// trend through the last two decoded reports and extrapolates duty targets
+// at the control-loop rate; each arriving report snaps the output back to
+// truth (the extrapolation is exact at the moment a report lands, so the
+// snap itself is seamless unless the trend was wrong).
+//
+// Two guards keep a bad fit from driving the LEDs somewhere the sky never
+// went: extrapolation is capped at one inter-report interval past the
+// latest report (beyond that the projected endpoint is held — a dead link
+// must not keep ramping), and a gap longer than TREND_MAX_GAP_MS between
+// the two fit points discards the slope entirely, because a trend across a
+// dropout says nothing about the current minute. Integer math throughout,
+// like the rest of the hot path.
+#define TREND_MAX_GAP_MS 30000UL
+
+template <int N>
+class SpectralTrend {
+public:
+  SpectralTrend() : haveCur(false), havePrev(false), curMs(0), prevMs(0) {}
+
+  // Latch a freshly decoded report; the previous latch becomes the other
+  // fit point. nowMs is the caller's millis() at decode time.
+  void latch(const uint16_t ch[N], uint32_t nowMs) {
+    if (haveCur) {
+      for (int i = 0; i < N; i++) prev[i] = cur[i];
+      prevMs = curMs;
+      havePrev = true;
+    }
+    for (int i = 0; i < N; i++) cur[i] = ch[i];
+    curMs = nowMs;
+    haveCur = true;
+  }
+
+  // Extrapolated duty targets for nowMs. Returns false (out untouched)
+  // until two usable fit points exist — callers just keep the last
+  // snapped report on the strips in that case.
+  bool predict(uint32_t nowMs, uint16_t out[N]) const {
+    if (!haveCur || !havePrev) return false;
+    uint32_t dt = curMs - prevMs;
+    if (dt == 0 || dt > TREND_MAX_GAP_MS) return false;
+
+    // Cap the extrapolation at one inter-report interval; past that the
+    // projected endpoint holds until the link speaks again
+    uint32_t elapsed = nowMs - curMs;
+    if (elapsed > dt) elapsed = dt;
+
+    for (int i = 0; i < N; i++) {
+      int32_t delta = (int32_t)cur[i] - (int32_t)prev[i];
+      int64_t v = (int64_t)cur[i] + (int64_t)delta * (int64_t)elapsed / (int64_t)dt;
+      if (v < 0) v = 0;
+      if (v > 65535) v = 65535;
+      out[i] = (uint16_t)v;
+    }
+    return true;
+  }
+
+private:
+  uint16_t cur[N];
+  uint16_t prev[N];
+  bool haveCur, havePrev;
+  uint32_t curMs, prevMs;
+};
+
+#endif
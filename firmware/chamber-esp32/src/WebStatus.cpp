@@ -0,0 +1,279 @@
+#include "WebStatus.h"
+
+#if WEB_STATUS_ENABLED
+
+#include <WiFi.h>
+#include <esp_http_server.h>
+#include <sys/socket.h>
+#include "Log.h"
+#include "Lttb.h"
+#if OTA_WEB_ENABLED
+#include "OtaUpdate.h"
+#endif
+
+static httpd_handle_t server = NULL;
+
+// Registered SSE sockets (-1 = free slot). Touched by the httpd task
+// (register) and the display task (push); both paths hold webMux.
+static int sseClients[WEB_SSE_MAX_CLIENTS];
+
+// Snapshot double-buffer discipline is overkill for one struct: a short
+// spinlocked copy keeps /status reads consistent against the publisher
+static portMUX_TYPE webMux = portMUX_INITIALIZER_UNLOCKED;
+static WebSnapshot snap;
+static bool snapValid = false;
+
+// Day-curve lux history (see the WEB_HISTORY_* block in Config.h). The
+// publisher appends one point per WEB_HISTORY_PERIOD_MS; "/history"
+// LTTB-downsamples the ring on demand. Indices move under webMux; the
+// int16 entries themselves are read lock-free — each mutates once per
+// recording period and a torn read is impossible at that width.
+static int16_t histLux[WEB_HISTORY_LEN];
+static uint16_t histHead = 0;   // Next write position
+static uint16_t histCount = 0;  // Entries recorded, saturates at LEN
+static unsigned long histLastMs = 0;
+
+// The dashboard: plain HTML + an EventSource, no framework, served from
+// flash. Anything fancier belongs on the shore side, not in the chamber.
+static const char PAGE[] =
+  "<!DOCTYPE html><html><head><title>ORCA chamber</title>"
+  "<style>body{font-family:monospace;margin:2em}td{padding:2px 12px}</style>"
+  "</head><body><h3>ORCA chamber status</h3><table id='t'></table>"
+  "<h3>Lux, last 24 h</h3>"
+  "<canvas id='c' width='600' height='120' style='border:1px solid #ccc'>"
+  "</canvas><script>"
+  "var f={lux:'Lux',clamped:'Clamped lux',duty:'PWM duty',boundsLo:'Bound lo',"
+  "boundsHi:'Bound hi',pwm:'PWM enabled',doseDay:'Dose (lux-h/24h)',"
+  "rssi:'RSSI (dBm)',snr:'SNR avg (dB)',sf:'SF',rx:'Frames rx',"
+  "corrupt:'Corrupt',missed:'Missed samples',authfail:'Auth fail'};"
+  "new EventSource('/events').onmessage=function(e){var d=JSON.parse(e.data),"
+  "h='';for(var k in f)h+='<tr><td>'+f[k]+'</td><td>'+d[k]+'</td></tr>';"
+  "document.getElementById('t').innerHTML=h};"
+  // Day curve off /history (LTTB-downsampled on the chamber): plot ages
+  // right to left so the newest point sits at the right edge
+  "function dc(){fetch('/history?n=300').then(function(r){return r.json()})"
+  ".then(function(d){var c=document.getElementById('c'),x=c.getContext('2d'),"
+  "p=d.points;x.clearRect(0,0,c.width,c.height);if(!p.length)return;"
+  "var mx=1,t0=p[0][0]||1,i;for(i=0;i<p.length;i++)if(p[i][1]>mx)mx=p[i][1];"
+  "x.beginPath();for(i=0;i<p.length;i++){var px=(1-p[i][0]/t0)*c.width,"
+  "py=c.height-p[i][1]/mx*(c.height-4)-2;i?x.lineTo(px,py):x.moveTo(px,py)}"
+  "x.strokeStyle='#06c';x.stroke()}).catch(function(){})}"
+  "dc();setInterval(dc,60000);"
+  "</script></body></html>";
+
+static int formatJson(char* buf, size_t len, const WebSnapshot& s) {
+  // Display/web path only — float formatting is fine here
+  return snprintf(buf, len,
+    "{\"lux\":%d,\"clamped\":%d,\"duty\":%lu,\"boundsLo\":%d,\"boundsHi\":%d,"
+    "\"pwm\":%d,\"doseDay\":%lu,\"rssi\":%.1f,\"snr\":%.1f,\"sf\":%u,"
+    "\"rx\":%lu,\"corrupt\":%lu,\"missed\":%lu,\"authfail\":%lu}",
+    s.rawLux, s.clampedLux, (unsigned long)s.pwmDuty, s.boundsLo, s.boundsHi,
+    s.pwmEnabled ? 1 : 0, s.doseDayLuxH, s.rssi, s.snrEwma, s.sf,
+    s.rxFrames, s.corruptFrames, s.missedSamples, s.authFailFrames);
+}
+
+static esp_err_t rootHandler(httpd_req_t* req) {
+  httpd_resp_set_type(req, "text/html");
+  return httpd_resp_send(req, PAGE, HTTPD_RESP_USE_STRLEN);
+}
+
+static esp_err_t statusHandler(httpd_req_t* req) {
+  WebSnapshot s;
+  bool valid;
+  portENTER_CRITICAL(&webMux);
+  s = snap;
+  valid = snapValid;
+  portEXIT_CRITICAL(&webMux);
+  if (!valid) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_send(req, "no snapshot yet", HTTPD_RESP_USE_STRLEN);
+  }
+  char json[320];
+  formatJson(json, sizeof(json), s);
+  httpd_resp_set_type(req, "application/json");
+  return httpd_resp_send(req, json, HTTPD_RESP_USE_STRLEN);
+}
+
+// On-demand day curve: LTTB the history ring down to "?n=" points
+// (default 600). Runs wholly in the httpd task; ring indices are
+// snapshotted under the mux, the samples are read lock-free. The
+// response is [age_s, lux] pairs, newest last — relative ages need no
+// wall clock, which the chamber may not have.
+static esp_err_t historyHandler(httpd_req_t* req) {
+  size_t nOut = 600;
+  char query[32], val[8];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+      httpd_query_key_value(query, "n", val, sizeof(val)) == ESP_OK) {
+    int n = atoi(val);
+    if (n >= 3 && n <= WEB_HISTORY_MAX_POINTS) {
+      nOut = (size_t)n;
+    }
+  }
+
+  portENTER_CRITICAL(&webMux);
+  uint16_t head = histHead;
+  uint16_t count = histCount;
+  portEXIT_CRITICAL(&webMux);
+  if (count == 0) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_send(req, "no history yet", HTTPD_RESP_USE_STRLEN);
+  }
+
+  const uint16_t base =
+      (uint16_t)((head + WEB_HISTORY_LEN - count) % WEB_HISTORY_LEN);
+  auto yAt = [&](size_t i) {
+    return (float)histLux[(base + i) % WEB_HISTORY_LEN];
+  };
+
+  // httpd task only, so one static selection buffer serves every request
+  static uint16_t sel[WEB_HISTORY_MAX_POINTS];
+  size_t nSel = lttbSelect(yAt, count, nOut, sel);
+
+  httpd_resp_set_type(req, "application/json");
+  char buf[512];
+  int n = snprintf(buf, sizeof(buf), "{\"period_s\":%d,\"points\":[",
+                   (int)(WEB_HISTORY_PERIOD_MS / 1000));
+  for (size_t i = 0; i < nSel; i++) {
+    long age = (long)(count - 1 - sel[i]) * (WEB_HISTORY_PERIOD_MS / 1000);
+    int lux = histLux[(base + sel[i]) % WEB_HISTORY_LEN];
+    if ((size_t)n + 32 > sizeof(buf)) {
+      httpd_resp_send_chunk(req, buf, n);
+      n = 0;
+    }
+    n += snprintf(buf + n, sizeof(buf) - n, "%s[%ld,%d]",
+                  i ? "," : "", age, lux);
+  }
+  n += snprintf(buf + n, sizeof(buf) - n, "]}");
+  httpd_resp_send_chunk(req, buf, n);
+  return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// SSE subscription: send the headers by hand and return with the socket
+// still open — the server keeps the session alive waiting for a "next
+// request" that never comes, and webStatusPublish() writes event frames
+// straight to the socket from then on.
+static esp_err_t eventsHandler(httpd_req_t* req) {
+  int fd = httpd_req_to_sockfd(req);
+  int slot = -1;
+  portENTER_CRITICAL(&webMux);
+  for (int i = 0; i < WEB_SSE_MAX_CLIENTS; i++) {
+    if (sseClients[i] == fd) { slot = i; break; }   // refresh, not duplicate
+    if (slot < 0 && sseClients[i] < 0) slot = i;
+  }
+  if (slot >= 0) sseClients[slot] = fd;
+  portEXIT_CRITICAL(&webMux);
+  if (slot < 0) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_send(req, "stream slots full", HTTPD_RESP_USE_STRLEN);
+  }
+  static const char hdr[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n\r\n";
+  httpd_send(req, hdr, sizeof(hdr) - 1);
+  return ESP_OK;
+}
+
+bool webStatusBegin() {
+  for (int i = 0; i < WEB_SSE_MAX_CLIENTS; i++) {
+    sseClients[i] = -1;
+  }
+
+  // Soft-AP rather than station: the vessel has no shore infrastructure,
+  // and a phone on deck joining the chamber's own network needs nothing
+  // configured anywhere else
+  WiFi.mode(WIFI_AP);
+  if (!WiFi.softAP(WEB_AP_SSID, WEB_AP_PASS)) {
+    LOG_ERROR("Web status: soft-AP start failed");
+    return false;
+  }
+
+  httpd_config_t cfg = HTTPD_DEFAULT_CONFIG();
+  cfg.server_port = WEB_STATUS_PORT;
+  cfg.max_open_sockets = WEB_SSE_MAX_CLIENTS + 3;  // streams + page fetches
+  cfg.lru_purge_enable = true;
+  if (httpd_start(&server, &cfg) != ESP_OK) {
+    LOG_ERROR("Web status: httpd start failed");
+    server = NULL;
+    return false;
+  }
+
+  static const httpd_uri_t uriRoot    = { "/",        HTTP_GET, rootHandler,    NULL };
+  static const httpd_uri_t uriStatus  = { "/status",  HTTP_GET, statusHandler,  NULL };
+  static const httpd_uri_t uriEvents  = { "/events",  HTTP_GET, eventsHandler,  NULL };
+  static const httpd_uri_t uriHistory = { "/history", HTTP_GET, historyHandler, NULL };
+  httpd_register_uri_handler(server, &uriRoot);
+  httpd_register_uri_handler(server, &uriStatus);
+  httpd_register_uri_handler(server, &uriEvents);
+  httpd_register_uri_handler(server, &uriHistory);
+#if OTA_WEB_ENABLED
+  otaRegisterHandlers(server);
+#endif
+
+  LOG_INFO("Web status: http://%s/ (AP \"%s\")",
+           WiFi.softAPIP().toString().c_str(), WEB_AP_SSID);
+  return true;
+}
+
+void webStatusPublish(const WebSnapshot& s) {
+  if (server == NULL) {
+    return;
+  }
+
+  portENTER_CRITICAL(&webMux);
+  snap = s;
+  snapValid = true;
+  portEXIT_CRITICAL(&webMux);
+
+  // Day-curve recording rides the publish cadence and rate-limits itself
+  unsigned long nowMs = millis();
+  if (histLastMs == 0 || nowMs - histLastMs >= WEB_HISTORY_PERIOD_MS) {
+    histLastMs = nowMs;
+    int v = s.rawLux;
+    if (v > 32767) v = 32767;
+    if (v < 0) v = 0;
+    histLux[histHead] = (int16_t)v;
+    portENTER_CRITICAL(&webMux);
+    histHead = (uint16_t)((histHead + 1) % WEB_HISTORY_LEN);
+    if (histCount < WEB_HISTORY_LEN) histCount++;
+    portEXIT_CRITICAL(&webMux);
+  }
+
+  char frame[352];
+  int n = snprintf(frame, sizeof(frame), "data: ");
+  int body = formatJson(frame + n, sizeof(frame) - n - 2, s);
+  if (body <= 0 || (size_t)(n + body + 2) >= sizeof(frame)) {
+    return;
+  }
+  n += body;
+  frame[n++] = '\n';
+  frame[n++] = '\n';
+
+  for (int i = 0; i < WEB_SSE_MAX_CLIENTS; i++) {
+    portENTER_CRITICAL(&webMux);
+    int fd = sseClients[i];
+    portEXIT_CRITICAL(&webMux);
+    if (fd < 0) {
+      continue;
+    }
+    // MSG_DONTWAIT is the isolation guarantee: a full socket buffer
+    // (browser stopped reading) returns HTTPD_SOCK_ERR_TIMEOUT and the
+    // client just misses this update; any harder error means the peer is
+    // gone and the slot is reclaimed
+    int sent = httpd_socket_send(server, fd, frame, n, MSG_DONTWAIT);
+    if (sent < 0 && sent != HTTPD_SOCK_ERR_TIMEOUT) {
+      portENTER_CRITICAL(&webMux);
+      if (sseClients[i] == fd) sseClients[i] = -1;
+      portEXIT_CRITICAL(&webMux);
+      httpd_sess_trigger_close(server, fd);
+    }
+  }
+}
+
+#else  // !WEB_STATUS_ENABLED
+
+bool webStatusBegin() { return false; }
+void webStatusPublish(const WebSnapshot&) {}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef WEB_STATUS_H
+#define WEB_STATUS_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Embedded web status endpoint: the chamber brings up a soft-AP and an
+// esp_http_server instance serving a one-page dashboard ("/"), a JSON
+// snapshot ("/status") and a server-sent-events stream ("/events") that
+// pushes the same JSON once per WEB_SSE_PERIOD_MS. Everything runs in the
+// httpd task and the low-priority display task — the control task never
+// formats, copies or sends a byte for the web, so a browser cannot add a
+// microsecond to sample-to-LED latency.
+//
+// The SSE push is strictly non-blocking (MSG_DONTWAIT): a browser that
+// stops reading simply misses updates while its socket buffer is full,
+// and a dead socket is dropped on the first hard send error. The
+// publisher hands over a value snapshot, so the stream is always
+// internally consistent even though the fields come from two cores.
+struct WebSnapshot {
+  int rawLux;                 // Filtered lux from the serial stream
+  int clampedLux;             // After the 1-min bounds clamp
+  uint32_t pwmDuty;           // Lux-channel duty counts [0, MAX_PWM_VALUE]
+  int boundsLo, boundsHi;     // Clamp bounds currently in force
+  bool pwmEnabled;
+  unsigned long doseDayLuxH;  // Rolling-24h light dose (lux-hours)
+  float rssi, snrEwma;        // LoRa link telemetry
+  uint8_t sf;                 // Spreading factor currently tuned
+  unsigned long rxFrames, corruptFrames, missedSamples, authFailFrames;
+};
+
+// Soft-AP + HTTP server up; logs and returns false on failure (the
+// chamber runs fine without the web, exactly like a failed LoRa begin)
+bool webStatusBegin();
+
+// Store the snapshot for /status and push one SSE frame to every
+// connected browser. Non-blocking; safe to call from the display task.
+void webStatusPublish(const WebSnapshot& s);
+
+#endif
@@ -1,91 +1,591 @@
 #include "InputOutput.h"
+#include "ChamberClock.h"
+#include "FixPoint.h"
+#include "GammaLut.h"
+#include "Log.h"
+#include "LoraReceiver.h"
+#include "SpectralTrend.h"
+#include "WebStatus.h"
+#include "EspNowLink.h"
+#include "DataLog.h"
+#include "Replay.h"
+
+#include <Preferences.h>
+#include <esp_task_wdt.h>
 
 InputOutput io;
+LoraReceiver lora;
 
 enum DisplayMode { MODE_ANALOG = 0, MODE_LUX = 1 };
 
-// runtime state
-static DisplayMode displayMode = MODE_LUX;
-static bool pwmEnabled = false;
+// runtime state (written by the control task, read by the display task)
+static volatile DisplayMode displayMode = MODE_LUX;
+static volatile bool pwmEnabled = false;
+static volatile int rawLux = 0;
+static volatile fix16_t potValue = 0;
+static volatile int clampedLux = 0;  // written by control, read by the web push
 
-void setup() {
-  io.begin();  // Initialize all peripherals
+/* ---------- Crash-resilient mode state ---------- */
+
+// The switches drive displayMode/pwmEnabled while the chamber runs, but a
+// watchdog reset or power blip used to revert both to defaults until the
+// first switch poll — PWM disabled mid-experiment with nobody watching.
+// The pair is mirrored to RTC noinit RAM (survives any reset) on every
+// change, with an NVS copy behind it for power loss; restore runs at the
+// top of setup(), before the tasks and therefore before any setPWM(), so
+// a reset resumes the pre-crash state and the next switch poll — the
+// operator's actual configuration — takes over from there.
+#define MODE_STATE_MAGIC 0x4D4F4445UL  // 'MODE'
+#define MODE_STATE_NVS_NAMESPACE "modestate"
 
-  // ensure PWM off at start
-  io.setPWM(0);
+struct ModeState {
+  uint32_t magic;
+  uint32_t mode;
+  uint32_t enabled;
+  uint32_t check;  // magic ^ mode ^ enabled — rejects partial writes
+};
+RTC_NOINIT_ATTR static ModeState rtcModeState;
+
+static void modeStateRtcStore() {
+  rtcModeState.mode = (uint32_t)displayMode;
+  rtcModeState.enabled = pwmEnabled ? 1 : 0;
+  rtcModeState.check = MODE_STATE_MAGIC ^ rtcModeState.mode ^ rtcModeState.enabled;
+  rtcModeState.magic = MODE_STATE_MAGIC;
 }
 
-void loop() {
-  io.update();  // Update input/output states
+static void modeStatePersist() {
+  modeStateRtcStore();
+  // Flash write only on an operator switch flip — rare by definition
+  Preferences prefs;
+  if (prefs.begin(MODE_STATE_NVS_NAMESPACE, false)) {
+    prefs.putUChar("dmode", (uint8_t)displayMode);
+    prefs.putUChar("pwmen", pwmEnabled ? 1 : 0);
+    prefs.end();
+  }
+}
+
+static void modeStateRestore() {
+  if (rtcModeState.magic == MODE_STATE_MAGIC &&
+      rtcModeState.check ==
+          (MODE_STATE_MAGIC ^ rtcModeState.mode ^ rtcModeState.enabled)) {
+    // Warm reset (watchdog, panic, soft restart): RTC copy is newest
+    displayMode = (DisplayMode)rtcModeState.mode;
+    pwmEnabled = rtcModeState.enabled != 0;
+    return;
+  }
+  // Power-on: RTC RAM is garbage, fall back to the NVS copy (if any)
+  Preferences prefs;
+  if (prefs.begin(MODE_STATE_NVS_NAMESPACE, true)) {
+    displayMode = (DisplayMode)prefs.getUChar("dmode", (uint8_t)displayMode);
+    pwmEnabled = prefs.getUChar("pwmen", pwmEnabled ? 1 : 0) != 0;
+    prefs.end();
+  }
+  modeStateRtcStore();  // seed the RTC copy for the next reset
+}
+
+// Task watchdog covering the control task: if the loop that owns the PWM
+// stops making progress the chamber resets and the restore path above
+// puts the experiment back, instead of holding a stale light level until
+// someone notices
+#define CONTROL_WDT_TIMEOUT_S 5
+
+/* ---------- Core-to-core sample queue ---------- */
+
+// Input snapshot passed from ingestion (core 0) to control (core 1)
+struct InputSample {
+  int lux;
+  fix16_t pot;
+  bool sw1, sw2;
+  bool luxFresh;   // true when lux carries a newly received sample
+};
+
+// Lock-free single-producer/single-consumer ring: the head index is only
+// written by the producer and the tail only by the consumer, so no lock is
+// needed between the cores
+#define SAMPLE_QUEUE_LEN 32
+static InputSample sampleQueue[SAMPLE_QUEUE_LEN];
+static volatile uint32_t queueHead = 0;  // producer write index
+static volatile uint32_t queueTail = 0;  // consumer read index
 
-  // Read current switches (INPUT_PULLUP: true==HIGH==released, false==LOW==pressed)
-  bool sw1 = io.getSwitch1();
-  bool sw2 = io.getSwitch2();
+static bool queuePush(const InputSample& s) {
+  uint32_t next = (queueHead + 1) % SAMPLE_QUEUE_LEN;
+  if (next == queueTail) return false;  // full — drop the newest sample
+  sampleQueue[queueHead] = s;
+  queueHead = next;
+  return true;
+}
+
+static bool queuePop(InputSample& s) {
+  if (queueTail == queueHead) return false;
+  s = sampleQueue[queueTail];
+  queueTail = (queueTail + 1) % SAMPLE_QUEUE_LEN;
+  return true;
+}
 
-  // Swithc controls
-  if (sw1) {
-    displayMode = MODE_ANALOG;
+// Second SPSC ring, same discipline, carrying slot indices out of the LoRa
+// receiver's report pool: the radio task publishes each decoded report's
+// index, control reads the slot in place and returns it to the pool after
+// the PWM latch — a report crosses the cores without ever being copied.
+// Sized one past the pool so a push can never find the ring full while
+// every queued index is pool-backed.
+#define SPECTRAL_RING_LEN (LoraReceiver::REPORT_POOL_LEN + 1)
+static uint8_t spectralRing[SPECTRAL_RING_LEN];
+static volatile uint32_t spectralHead = 0;
+static volatile uint32_t spectralTail = 0;
+
+static void spectralPush(uint8_t slot) {
+  spectralRing[spectralHead] = slot;
+  spectralHead = (spectralHead + 1) % SPECTRAL_RING_LEN;
+}
+
+static bool spectralPop(uint8_t& slot) {
+  if (spectralTail == spectralHead) return false;
+  slot = spectralRing[spectralTail];
+  spectralTail = (spectralTail + 1) % SPECTRAL_RING_LEN;
+  return true;
+}
+
+// Replay staging: the replay task is a second producer, and the pool's
+// index rings are strictly single-producer — so replayed reports get a
+// one-slot mailbox of their own instead of a seat in the pool. Control
+// treats it as one more arrival candidate; whichever decoded latest wins
+// the latch.
+static orca_report_wire_t replayReport;
+static unsigned long replayDecodedUs = 0;
+static volatile bool replayReady = false;
+
+/* ---------- Decode-to-PWM latency histogram ---------- */
+
+// Light staleness is the performance currency for every pipeline change, so
+// the chamber keeps score: decode-to-setSpectralPWM latency in power-of-two
+// millisecond buckets (<1, <2, ..., >=128), written by the control task and
+// printed with the periodic log. The satellite-reported sample age rides
+// alongside so the log shows both halves of the end-to-end number (only
+// LoRa airtime is unaccounted for).
+#define LAT_HIST_BUCKETS 9
+static volatile unsigned long latHist[LAT_HIST_BUCKETS];
+static volatile uint16_t lastSampleAgeMs = 0;
+
+static void latHistRecord(unsigned long latencyUs) {
+  unsigned long ms = latencyUs / 1000;
+  int bucket = 0;
+  while (bucket < LAT_HIST_BUCKETS - 1 && ms >= (1UL << bucket)) {
+    bucket++;
   }
-  else {
-    displayMode = MODE_LUX;
+  latHist[bucket]++;
+}
+
+/* ---------- Input arbitration ---------- */
+
+// Three sources can feed the white strip at once: the module's UART lux
+// stream (50 Hz nominal, heartbeat-bounded when send-on-delta suppresses),
+// LoRa satellite reports (one per transmit cycle), and the pot. Rank them
+// by rate and fail over on silence instead of holding a frozen level:
+// UART silence hands over to the latest LoRa clear channel, LoRa silence
+// holds the last duty explicitly. The pot (MODE_ANALOG) is an operator
+// override and always wins its mode. Arbitration runs in the control task
+// only; the display task reads the volatile active source for the LCD.
+enum LightSource : uint8_t { SRC_POT, SRC_UART, SRC_LORA, SRC_HOLD };
+static volatile LightSource activeSource = SRC_HOLD;
+
+// UART: must outlast the module's 1 s send-on-delta heartbeat with margin.
+// LoRa: several report cycles — batch staging legitimately spaces arrivals.
+#define UART_STALL_MS 3000UL
+#define LORA_STALL_MS 30000UL
+
+// Control-task-only freshness state (no locking needed)
+static unsigned long lastUartFreshMs = 0;
+static unsigned long lastLoraFreshMs = 0;
+static bool uartEverFresh = false;
+static bool loraEverFresh = false;
+static uint16_t lastLoraClear = 0;  // Broadband channel of the newest report
+
+static LightSource arbitrateSource(unsigned long now) {
+  if (displayMode == MODE_ANALOG) return SRC_POT;
+  if (uartEverFresh && now - lastUartFreshMs <= UART_STALL_MS) return SRC_UART;
+  if (loraEverFresh && now - lastLoraFreshMs <= LORA_STALL_MS) return SRC_LORA;
+  return SRC_HOLD;
+}
+
+static const char* sourceName(LightSource s) {
+  switch (s) {
+    case SRC_POT:  return "POT";
+    case SRC_UART: return "UART";
+    case SRC_LORA: return "LORA";
+    default:       return "HOLD";
   }
+}
 
-  if (sw2) {
-    pwmEnabled = false;
+/* ---------- Control ---------- */
+
+// Recompute and apply the PWM output from the active source.
+// The gamma LUT maps the input through the CIE lightness curve to a 14-bit
+// duty, so dawn/dusk levels get fine, perceptually even steps and the hot
+// path is a table lookup plus Q16.16 scaling — no float anywhere.
+static void applyControl() {
+  if (!pwmEnabled) {
+    io.setPWM(0);
+    return;
   }
-  else {
-    pwmEnabled = true;
+
+  int index;
+  switch (activeSource) {
+    case SRC_POT:
+      index = fix16_mul_int(potValue, GAMMA_LUT_SIZE - 1);
+      break;
+    case SRC_UART:
+      // Use clamped lux for LED output; pure integer scaling into the LUT
+      index = (clampedLux * (GAMMA_LUT_SIZE - 1)) / (int)chamberCfg.scaleConstant;
+      break;
+    case SRC_LORA:
+      // Uncalibrated fallback: the satellite's broadband counts drive the
+      // strip proportionally. Relative tracking through an outage beats a
+      // frozen or dark chamber; the spectral strips are mixed separately.
+      index = ((int)lastLoraClear * (GAMMA_LUT_SIZE - 1)) / 65535;
+      break;
+    case SRC_HOLD:
+    default:
+      return;  // Every source silent — hold the last duty deliberately
   }
 
-  // Determine the input value (0.0 - 1.0) depending on mode
-  float inputNorm = 0.0f;
-  int rawLux = io.getLuxValue();
-  int lux = io.getClampedLux(rawLux);  // Clamp to 1-min bounds
-  float pot = io.getAnalogValue(); // already scaled 0..1 in InputOutput
+  io.setPWM(gammaDutyAt(index));
+}
+
+// Redraw the LCD (mode and value, fit to 16x2) through the differential
+// renderer — rows are staged as text and only changed cells hit the glass
+static void refreshDisplay() {
+  char row[LCD_COLS + 1];
 
   if (displayMode == MODE_ANALOG) {
-    inputNorm = pot;
+    io.displaySetRow(0, "Mode: ANALOG");
+    // show pot value as fraction (display path only — float is fine here)
+    snprintf(row, sizeof(row), "Pot:%.3f", potValue / 65536.0f);
   } else {
-    // Use clamped lux for LED output
-    inputNorm = (float)lux / 2750.0f;
-    if (inputNorm < 0.0f) inputNorm = 0.0f;
-    if (inputNorm > 1.0f) inputNorm = 1.0f;
+    // Active source after arbitration: "Mode: LUX [UART]" is 16 cols exact
+    snprintf(row, sizeof(row), "Mode: LUX [%s]", sourceName(activeSource));
+    io.displaySetRow(0, row);
+    // raw lux plus the rolling-day light dose ("Lux:4095 D:98304" is 16 cols)
+    snprintf(row, sizeof(row), "Lux:%d D:%lu", rawLux, io.getDoseDayLuxHours());
   }
+  io.displaySetRow(1, row);
+  io.displayFlush();
+}
+
+/* ---------- Tasks ---------- */
+
+// Core 0: owns every input — serial lux ingestion runs continuously,
+// switches/pot on their own cadence — and feeds snapshots to core 1
+static void ingestionTask(void*) {
+  unsigned long lastInputPollMs = 0;
+
+  for (;;) {
+#if LUX_TRANSPORT_ESPNOW
+    // Wireless frames drain into the same assembler as the UART bytes;
+    // both transports are live, whichever delivers first wins the sample
+    uint8_t wireless[64];
+    size_t wn;
+    while ((wn = espNowLinkRead(wireless, sizeof(wireless))) > 0) {
+      io.ingestBytes(wireless, wn);
+    }
+#endif
+    io.readUART();
+    bool luxFresh = io.takeLuxUpdate();
+
+    unsigned long now = millis();
+    bool inputsPolled = false;
+    // A settled switch edge forces an immediate snapshot so mode/PWM-enable
+    // changes don't wait out the poll cadence
+    if (io.takeSwitchEvent() || now - lastInputPollMs >= chamberCfg.inputPollMs) {
+      lastInputPollMs = now;
+      io.readSwitches();
+      io.readAnalog();
+      inputsPolled = true;
+    }
 
-  // Apply PWM if enabled
-  if (pwmEnabled) {
-    // scale to configured max PWM value (from Config.h)
-    uint32_t duty = (uint32_t)(inputNorm * (float)MAX_PWM_VALUE + 0.5f);
-    if (duty > MAX_PWM_VALUE) duty = MAX_PWM_VALUE;
-    io.setPWM((float)duty);
+    if (luxFresh || inputsPolled) {
+      InputSample s;
+      s.lux = io.getLuxValue();
+      s.pot = io.getAnalogValue();
+      s.sw1 = io.getSwitch1();
+      s.sw2 = io.getSwitch2();
+      s.luxFresh = luxFresh;
+      queuePush(s);
+    }
+
+    // One-tick yield; the serial buffer comfortably holds a tick of the
+    // 20 ms sample stream
+    vTaskDelay(1);
   }
-  else {
-    io.setPWM(0.0);
+}
+
+// Core 0, highest priority: sleeps on the DIO1 semaphore and reads each
+// packet out the moment it lands, so sample-to-LED latency is bounded by
+// interrupt + task-switch time instead of a poll period. Decoded reports
+// stay in their pool slots; only the slot index crosses to the control task.
+static void radioTask(void*) {
+  for (;;) {
+    if (!lora.waitForPacket(1000)) {
+      lora.linkWatchdog();  // revert a silent fast link to the SF9 floor
+      continue;
+    }
+    if (lora.poll() > 0) {
+      int idx;
+      while ((idx = lora.takeReportSlot()) >= 0) {
+        const LoraReceiver::ReportSlot& sl = lora.reportSlot(idx);
+        dataLogRecord(DATALOG_REC_REPORT, (const uint8_t*)&sl.report,
+                      sizeof(sl.report));
+        spectralPush((uint8_t)idx);  // cannot overflow: ring outsizes the pool
+      }
+    }
   }
+}
 
-  // Update LCD display: print mode and value (fit to 16x2)
-  LiquidCrystal_I2C lcd = io.getLCD();
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  if (displayMode == MODE_ANALOG) {
-    lcd.print("Mode: ANALOG");
-  } else {
-    lcd.print("Mode: LUX    ");
+// Replay injection: a replayed report enters the pipeline at the control
+// hand-off, so mixing, trend interpolation, the PWM latch and the latency
+// histogram all run — and all get scored — as in production. A mailbox
+// still holding the previous report drops the new one, the same
+// newest-loses policy the old full ring applied.
+static void replayInjectReport(const orca_report_wire_t& report) {
+  if (replayReady) {
+    return;
   }
+  replayReport = report;
+  replayDecodedUs = micros();
+  replayReady = true;
+}
 
-  lcd.setCursor(0, 1);
-  if (displayMode == MODE_ANALOG) {
-    // show pot value as fraction
-    lcd.print("Pot:");
-    lcd.print(pot, 3);
-  } else {
-    // show raw lux (what's received) on LCD
-    lcd.print("Lux:");
-    lcd.print(rawLux);
+// Predictive hold between reports: linear trend over the last two decoded
+// reports, refreshed at chamberCfg.predictMs so the light ramps toward the
+// expected next report instead of stepping once per arrival (control task
+// only — no locking needed)
+static SpectralTrend<NUM_SRC_CHANNELS> spectralTrend;
+
+// Core 1, high priority: drains the queue and drives the PWM. Preempts the
+// display task, so a stalled LCD write can never delay a light update.
+static void controlTask(void*) {
+  unsigned long lastPredictMs = 0;
+
+  esp_task_wdt_add(NULL);  // supervised: see CONTROL_WDT_TIMEOUT_S
+
+  for (;;) {
+    esp_task_wdt_reset();
+
+    // Re-arbitrate every pass: a stalled source is detected by silence, so
+    // the check cannot wait for a sample that is no longer arriving
+    LightSource src = arbitrateSource(millis());
+    if (src != activeSource) {
+      LOG_INFO("Input source: %s -> %s", sourceName(activeSource),
+               sourceName(src));
+      activeSource = src;
+      applyControl();
+    }
+
+    InputSample s;
+    while (queuePop(s)) {
+      // Switch controls (INPUT_PULLUP: true==HIGH==released, false==LOW==pressed)
+      DisplayMode m = s.sw1 ? MODE_ANALOG : MODE_LUX;
+      bool en = !s.sw2;
+      if (m != displayMode || en != pwmEnabled) {
+        displayMode = m;
+        pwmEnabled = en;
+        modeStatePersist();  // survive the next reset with this state
+      }
+      potValue = s.pot;
+      if (s.luxFresh) {
+        rawLux = s.lux;
+        clampedLux = io.getClampedLux(s.lux);  // Clamp to 1-min bounds
+        lastUartFreshMs = millis();
+        uartEverFresh = true;
+      }
+      // Cheap enough per sample, and a mode flip or recovered stream must
+      // take effect on this very sample, not a tick later
+      activeSource = arbitrateSource(millis());
+      applyControl();
+    }
+
+    // Latch the newest spectral report onto the LED strips; superseded
+    // slots go straight back to the pool so a burst (batch frame) doesn't
+    // replay old light levels
+    int spIdx = -1;
+    uint8_t slot;
+    while (spectralPop(slot)) {
+      if (spIdx >= 0) {
+        lora.releaseReportSlot(spIdx);
+      }
+      spIdx = slot;
+    }
+    const uint16_t* channels = NULL;
+    uint16_t ageMs = 0;
+    unsigned long decodedUs = 0;
+    if (spIdx >= 0) {
+      const LoraReceiver::ReportSlot& sl = lora.reportSlot(spIdx);
+      channels = sl.report.channels;
+      ageMs = sl.report.sample_age_ms;
+      decodedUs = sl.decodedUs;
+    }
+    bool replayPending = replayReady;
+    if (replayPending &&
+        (channels == NULL || (long)(replayDecodedUs - decodedUs) > 0)) {
+      channels = replayReport.channels;
+      ageMs = replayReport.sample_age_ms;
+      decodedUs = replayDecodedUs;
+    }
+    if (channels != NULL) {
+      if (pwmEnabled) {
+        // An arriving report is truth: snap to it and restart the trend
+        io.setSpectralPWM(channels);
+        spectralTrend.latch(channels, millis());
+        latHistRecord(micros() - decodedUs);
+        lastSampleAgeMs = ageMs;
+        lastLoraFreshMs = millis();
+        loraEverFresh = true;
+        lastLoraClear = channels[ORCA_CH_CLEAR];
+        if (activeSource == SRC_LORA) {
+          applyControl();  // Failed-over white strip tracks each new report
+        }
+      }
+      // Slot and mailbox are only returned once the latch is done — held
+      // storage is what makes reading the report in place safe
+      if (spIdx >= 0) {
+        lora.releaseReportSlot(spIdx);
+      }
+      if (replayPending) {
+        replayReady = false;  // consumed, or superseded by a newer arrival
+      }
+    } else if (pwmEnabled && chamberCfg.predictMs > 0) {
+      // Between reports, ride the fitted trend at the configured cadence
+      unsigned long now = millis();
+      if (now - lastPredictMs >= chamberCfg.predictMs) {
+        lastPredictMs = now;
+        uint16_t predicted[NUM_SRC_CHANNELS];
+        if (spectralTrend.predict(now, predicted)) {
+          io.setSpectralPWM(predicted);
+        }
+      }
+    }
+    vTaskDelay(1);
   }
+}
+
+// Task handles kept so the periodic log can report stack high-water marks;
+// a stack sized by guesswork either wastes RAM or corrupts it silently
+static TaskHandle_t ingestHandle = NULL;
+static TaskHandle_t radioHandle = NULL;
+static TaskHandle_t controlHandle = NULL;
+static TaskHandle_t displayHandle = NULL;
+
+// Core 1, low priority: display refresh and debug log on their own timers
+static void displayTask(void*) {
+  // Holding the boot banner is this task's job, not a delay() in begin():
+  // the first refresh is simply deferred while control and PWM are live
+  unsigned long bootMs = millis();
+  unsigned long lastDisplayMs = 0;
+  unsigned long lastLogMs = 0;
+  unsigned long lastWebMs = 0;
+
+  for (;;) {
+    unsigned long now = millis();
+
+    if (now - bootMs >= BANNER_HOLD_MS &&
+        now - lastDisplayMs >= chamberCfg.displayRefreshMs) {
+      lastDisplayMs = now;
+      refreshDisplay();
+    }
 
-  // Optional serial log for debugging
-  Serial.println(io.toString());
+    // Web status push on its own timer: snapshot assembled here (display
+    // task, lowest priority) and sent non-blocking, so the control task
+    // never does web work and a slow browser can only miss updates
+    if (now - lastWebMs >= WEB_SSE_PERIOD_MS) {
+      lastWebMs = now;
+      WebSnapshot ws;
+      ws.rawLux = rawLux;
+      ws.clampedLux = clampedLux;
+      ws.pwmDuty = io.getPWMDuty();
+      io.getClampBounds(ws.boundsLo, ws.boundsHi);
+      ws.pwmEnabled = pwmEnabled;
+      ws.doseDayLuxH = io.getDoseDayLuxHours();
+      ws.rssi = lora.getLastRssi();
+      ws.snrEwma = lora.getSnrEwma();
+      ws.sf = lora.getCurrentSf();
+      ws.rxFrames = lora.getReceivedFrames();
+      ws.corruptFrames = lora.getCorruptFrames();
+      ws.missedSamples = lora.getMissedSamples();
+      ws.authFailFrames = lora.getAuthFailFrames();
+      webStatusPublish(ws);
+    }
 
-  delay(LOOP_DELAY_MS); // update rate
-}
\ No newline at end of file
+    // Optional serial log for debugging
+    if (now - lastLogMs >= chamberCfg.logPeriodMs) {
+      lastLogMs = now;
+      LOG_INFO("%s", io.toString());
+      LOG_INFO("%s", lora.toString());
+      LOG_INFO("%s", dataLogToString());
+      if (replayActive()) {
+        LOG_INFO("%s", replayToString());
+      }
+#if LUX_TRANSPORT_ESPNOW
+      LOG_INFO("ESP-NOW ring drops: %lu", espNowLinkDrops());
+#endif
+      LOG_INFO("%s", clockToString());
+      LOG_INFO("Dose: day %lu lux-h, hour %lu lux-h",
+               io.getDoseDayLuxHours(), io.getDoseHourLuxHours());
+
+      // Histogram line assembled into a stack buffer — no String churn
+      char lat[128];
+      int n = snprintf(lat, sizeof(lat), "PWM lat ms <1..>=128:");
+      for (int i = 0; i < LAT_HIST_BUCKETS && n > 0 && (size_t)n < sizeof(lat); i++) {
+        n += snprintf(lat + n, sizeof(lat) - n, " %lu", latHist[i]);
+      }
+      if (n > 0 && (size_t)n < sizeof(lat)) {
+        snprintf(lat + n, sizeof(lat) - n, " satAge:%ums", lastSampleAgeMs);
+      }
+      LOG_INFO("%s", lat);
+
+      // Heap and stack watermarks: min-ever free heap plus each task's
+      // stack high-water mark in bytes — a leak or an undersized stack
+      // shows up as a falling number long before the crash
+      LOG_INFO("Mem: heap %u free %u min | stack ing:%u rad:%u ctl:%u dsp:%u",
+               (unsigned)esp_get_free_heap_size(),
+               (unsigned)esp_get_minimum_free_heap_size(),
+               (unsigned)uxTaskGetStackHighWaterMark(ingestHandle),
+               (unsigned)uxTaskGetStackHighWaterMark(radioHandle),
+               (unsigned)uxTaskGetStackHighWaterMark(controlHandle),
+               (unsigned)uxTaskGetStackHighWaterMark(displayHandle));
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(50));
+  }
+}
+
+/* ---------- Arduino entry points ---------- */
+
+void setup() {
+  modeStateRestore();  // before io.begin(), so before the first setPWM()
+  io.begin();  // Re-drives held duties (warm reset) or zero before anything slow
+  io.setLatencyHist(latHist, LAT_HIST_BUCKETS);  // Harvest protocol reads it
+  lora.begin();  // SX1262 up and listening (logs and continues on failure)
+  webStatusBegin();  // Soft-AP + status server (logs and continues on failure)
+  dataLogBegin();    // Local binary logger (logs and continues on failure)
+  replayBegin(replayInjectReport);  // Serial "replay <accel>" arms off this
+#if LUX_TRANSPORT_ESPNOW
+  espNowLinkBegin();  // Wireless lux stream (UART still works if this fails)
+#endif
+
+  // Control-loop watchdog: panic (and so reset) if the subscribed task
+  // stalls; the Arduino core's idle-task subscriptions stay as they are
+  esp_task_wdt_init(CONTROL_WDT_TIMEOUT_S, true);
+
+  // Pin ingestion + radio to core 0 and control/display to core 1; the
+  // radio task outranks ingestion so a packet is read the instant it lands,
+  // and the control task outranks the display task so PWM updates preempt
+  // LCD I2C traffic
+  xTaskCreatePinnedToCore(ingestionTask, "ingest",  4096, NULL, 3, &ingestHandle,  0);
+  xTaskCreatePinnedToCore(radioTask,     "radio",   4096, NULL, 4, &radioHandle,   0);
+  xTaskCreatePinnedToCore(controlTask,   "control", 4096, NULL, 3, &controlHandle, 1);
+  xTaskCreatePinnedToCore(displayTask,   "display", 4096, NULL, 1, &displayHandle, 1);
+}
+
+void loop() {
+  // All work happens in the pinned tasks; the Arduino loop task idles
+  vTaskDelay(pdMS_TO_TICKS(1000));
+}
@@ -1,6 +1,8 @@
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
 #include "Adafruit_VEML7700.h"
+#include "../src/P2Quantile.h"
+#include "../src/RingBuffer.h"
 
 // === I2C Pin Definitions ===
 #define SDA1 9   // First sensor I2C pins
@@ -31,7 +33,8 @@
 // === Timing Configuration ===
 const unsigned long SAMPLE_MS = 500;  //2Hz sampling
 const int WINDOW_SIZE = 600;          // 5 minutes @ 500ms -> 600 samples
-const float BOUNDS_ALPHA = 0.05;
+const float BOUNDS_ALPHA = 0.05;      // blending weight for min/max updates
+const float BOUNDS_QUANTILE = 0.05;   // clamp to the 5th/95th percentiles
 const unsigned long LCD_UPDATE_MS = 500;
 
 // === Sensor Objects ===
@@ -48,42 +51,6 @@ float minLux = 0.0;
 float maxLux = 1000.0;
 
 
-struct CircularBuffer {
-  int size;
-  int idx;
-  int count;
-  float *buf;
-  
-  CircularBuffer(int n = 0) {
-    size = n;
-    idx = 0;
-    count = 0;
-    if (n > 0) buf = (float*)malloc(sizeof(float) * n);
-    else buf = nullptr;
-  }
-  
-  ~CircularBuffer() { if (buf) free(buf); }
-  
-  void add(float v) {
-    if (!buf) return;
-    buf[idx] = v;
-    idx = (idx + 1) % size;
-    if (count < size) count++;
-  }
-  
-  int available() { return count; }
-  
-  void copyChronological(float *dest) {
-    if (!buf) return;
-    int start = (count == size) ? idx : 0;
-    int n = count;
-    for (int i = 0; i < n; ++i) {
-      int src = (start + i) % size;
-      dest[i] = buf[src];
-    }
-  }
-};
-
 // === Filter Base Class ===
 struct Filter {
   virtual float process(float value) = 0;
@@ -303,7 +270,14 @@ SGFilter sg(11, 3);
 // Choose filter: 0=SMA, 1=EMA, 2=SG
 int activeFilter = 1;
 
-CircularBuffer calibBuffer(WINDOW_SIZE);
+// Retained 5-minute history in static storage — no startup malloc, and the
+// ring implementation is shared with the chamber firmware
+RingBuffer<float, WINDOW_SIZE> calibBuffer;
+
+// Streaming percentile bounds: O(1) per sample and ~40 bytes each, replacing
+// the old copy-and-qsort of the whole calibration buffer on every update
+P2Quantile boundsLoQ(BOUNDS_QUANTILE);
+P2Quantile boundsHiQ(1.0 - BOUNDS_QUANTILE);
 
 // === Timing Variables ===
 unsigned long lastSample = 0;
@@ -313,73 +287,14 @@ unsigned long lastLCDUpdate = 0;
 float lastLuxValue = 0.0;
 
 // === Helper Functions ===
-int cmpFloat(const void *a, const void *b) {
-  float fa = *(const float*)a;
-  float fb = *(const float*)b;
-  if (fa < fb) return -1;
-  if (fa > fb) return 1;
-  return 0;
-}
-
-float computeMedian(float *arr, int n) {
-  if (n == 0) return 0.0;
-  float *tmp = (float*)malloc(sizeof(float)*n);
-  for (int i=0;i<n;i++) tmp[i] = arr[i];
-  qsort(tmp, n, sizeof(float), cmpFloat);
-  float med;
-  if (n % 2 == 1) med = tmp[n/2];
-  else med = 0.5 * (tmp[n/2 - 1] + tmp[n/2]);
-  free(tmp);
-  return med;
-}
-
-float computeMAD(float *arr, int n, float median) {
-  if (n == 0) return 0.0;
-  float *dev = (float*)malloc(sizeof(float)*n);
-  for (int i=0;i<n;i++) dev[i] = fabs(arr[i] - median);
-  float mad = computeMedian(dev, n);
-  free(dev);
-  return mad;
-}
-
+// Percentile bounds from the streaming estimators. The old path copied the
+// whole calibration buffer out and qsort'ed it (twice, for median and MAD)
+// on every sample; tail quantiles shed outliers the same way the MAD fence
+// did, at constant cost.
 void computeRobustBounds(float &outMin, float &outMax) {
-  int n = calibBuffer.available();
-  if (n == 0) { outMin = minLux; outMax = maxLux; return; }
-  
-  float *tmp = (float*)malloc(sizeof(float)*n);
-  calibBuffer.copyChronological(tmp);
-
-  float med = computeMedian(tmp, n);
-  float mad = computeMAD(tmp, n, med);
-  float sigma = 1.4826 * mad;
-  float threshold = 3.0 * sigma;
-  
-  float inMin = 1e30, inMax = -1e30;
-  int inCount = 0;
-  
-  for (int i=0;i<n;i++) {
-    float v = tmp[i];
-    if (sigma > 1e-9) {
-      if (fabs(v - med) <= threshold) {
-        inCount++;
-        if (v < inMin) inMin = v;
-        if (v > inMax) inMax = v;
-      }
-    } else {
-      inCount++;
-      if (v < inMin) inMin = v;
-      if (v > inMax) inMax = v;
-    }
-  }
-  
-  if (inCount == 0) {
-    outMin = med;
-    outMax = med;
-  } else {
-    outMin = inMin;
-    outMax = inMax;
-  }
-  free(tmp);
+  if (boundsLoQ.count() < 5) { outMin = minLux; outMax = maxLux; return; }
+  outMin = boundsLoQ.value();
+  outMax = boundsHiQ.value();
 }
 
 float mapFloat(float x, float inMin, float inMax, float outMin, float outMax) {
@@ -494,9 +409,12 @@ void loop() {
     else if (activeFilter == 1) filtered = ema.process(rawLux);
     else filtered = sg.process(rawLux);
     
-    // Add to calibration buffer
-    calibBuffer.add(filtered);
-    
+    // Add to calibration buffer (retained history; no longer on the
+    // bounds path) and feed the streaming quantiles
+    calibBuffer.push(filtered);
+    boundsLoQ.add(filtered);
+    boundsHiQ.add(filtered);
+
     // Compute robust bounds
     float newMin, newMax;
     computeRobustBounds(newMin, newMax);
@@ -0,0 +1,68 @@
+#ifndef FIX_POINT_H
+#define FIX_POINT_H
+
+#include <stdint.h>
+
+// Shared Q16.16 fixed-point arithmetic, used by both firmwares (each
+// project adds -I../common) wherever per-iteration control math would
+// otherwise run on float or double. On the RISC-V parts there is no FPU
+// at all and on the Xtensa parts double is software-emulated, so the
+// control paths stay deterministic and cheap by working in Q16.16:
+// 1.0 == FIX16_ONE, resolution 1/65536, range just under +/-32768.
+//
+// Every operation saturates instead of wrapping — a railed control value
+// is recoverable, a wrapped one flips the output.
+
+typedef int32_t fix16_t;
+
+#define FIX16_ONE ((fix16_t)0x00010000)
+#define FIX16_MAX ((fix16_t)0x7FFFFFFF)
+#define FIX16_MIN ((fix16_t)-0x7FFFFFFF - 1)
+
+// Clamp a wide intermediate back into Q16.16
+static inline fix16_t fix16_sat(int64_t v) {
+  if (v > (int64_t)FIX16_MAX) return FIX16_MAX;
+  if (v < (int64_t)FIX16_MIN) return FIX16_MIN;
+  return (fix16_t)v;
+}
+
+static inline fix16_t fix16_from_int(int32_t v) {
+  return fix16_sat((int64_t)v << 16);
+}
+
+// Round-to-nearest back to an integer
+static inline int32_t fix16_to_int(fix16_t v) {
+  return (int32_t)(((int64_t)v + FIX16_ONE / 2) >> 16);
+}
+
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
+  return fix16_sat(((int64_t)a * b) >> 16);
+}
+
+// Division by zero saturates in the direction of the numerator — the
+// least-wrong answer for a ratio whose denominator collapsed
+static inline fix16_t fix16_div(fix16_t a, fix16_t b) {
+  if (b == 0) return (a >= 0) ? FIX16_MAX : FIX16_MIN;
+  return fix16_sat(((int64_t)a << 16) / b);
+}
+
+// Q16.16 of num/den straight from two integers (e.g. an ADC count over
+// its full-scale value) without a float detour
+static inline fix16_t fix16_from_ratio(int32_t num, int32_t den) {
+  if (den == 0) return (num >= 0) ? FIX16_MAX : FIX16_MIN;
+  return fix16_sat(((int64_t)num << 16) / den);
+}
+
+// Scale an integer by a Q16.16 factor, rounded to nearest — the hot-path
+// form for table indexing and duty scaling
+static inline int32_t fix16_mul_int(fix16_t a, int32_t b) {
+  return (int32_t)(((int64_t)a * b + FIX16_ONE / 2) >> 16);
+}
+
+// a + (b - a) * t with t in [0, FIX16_ONE]. The difference is widened
+// before subtracting so rail-to-rail spans can't overflow.
+static inline fix16_t fix16_lerp(fix16_t a, fix16_t b, fix16_t t) {
+  return fix16_sat((int64_t)a + ((((int64_t)b - a) * t) >> 16));
+}
+
+#endif
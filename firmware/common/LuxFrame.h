@@ -0,0 +1,145 @@
+#ifndef LUX_FRAME_H
+#define LUX_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Binary sample frame carried over UART from module-esp32 to chamber-esp32.
+// Shared by both firmwares (each project adds -I../common) so the layout
+// cannot drift.
+//
+// Layout (7 bytes, little-endian):
+//   0    sync byte (LUX_FRAME_SYNC)
+//   1    sequence number, wraps at 256 — receiver detects dropped frames
+//   2-3  sensor 1 lux, unsigned 1/16-lux fixed point (0xFFFF = offline)
+//   4-5  sensor 2 lux, unsigned 1/16-lux fixed point (0xFFFF = offline)
+//   6    CRC8 (poly 0x07) over bytes 1-5
+//
+// 1/16-lux steps cover 0..4095.88 lux, comfortably above the VEML7700 range
+// at gain 1 / 100 ms integration. 0xFFFF is reserved as the "sensor offline"
+// sentinel (saturation stops one step short), so the module can keep
+// streaming the healthy sensor when the other one's bus is down.
+
+#define LUX_FRAME_SYNC   0xA7
+#define LUX_FRAME_SIZE   7
+#define LUX_FIXED_SHIFT  4      // lux = fixed-point value / 16
+#define LUX_FP_INVALID   0xFFFF // sensor offline / no reading in this slot
+
+typedef struct {
+  uint8_t  seq;
+  uint16_t lux1_fp;   // 1/16-lux fixed point
+  uint16_t lux2_fp;
+} lux_sample_t;
+
+// CRC-8, polynomial 0x07, init 0x00
+static inline uint8_t lux_frame_crc8(const uint8_t *data, int len) {
+  uint8_t crc = 0;
+  for (int i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Convert a float lux reading to the on-wire fixed point, saturating one
+// step below LUX_FP_INVALID so a bright reading can't read as "offline"
+static inline uint16_t lux_frame_to_fp(float lux) {
+  if (lux <= 0.0f) return 0;
+  float fp = lux * 16.0f + 0.5f;
+  return (fp >= 65534.0f) ? 65534 : (uint16_t)fp;
+}
+
+static inline void lux_frame_encode(uint8_t buf[LUX_FRAME_SIZE], uint8_t seq,
+                                    uint16_t lux1_fp, uint16_t lux2_fp) {
+  buf[0] = LUX_FRAME_SYNC;
+  buf[1] = seq;
+  buf[2] = (uint8_t)(lux1_fp & 0xFF);
+  buf[3] = (uint8_t)(lux1_fp >> 8);
+  buf[4] = (uint8_t)(lux2_fp & 0xFF);
+  buf[5] = (uint8_t)(lux2_fp >> 8);
+  buf[6] = lux_frame_crc8(&buf[1], 5);
+}
+
+// Returns false on sync or CRC mismatch
+static inline bool lux_frame_decode(const uint8_t buf[LUX_FRAME_SIZE],
+                                    lux_sample_t *out) {
+  if (buf[0] != LUX_FRAME_SYNC || lux_frame_crc8(&buf[1], 5) != buf[6]) {
+    return false;
+  }
+  out->seq     = buf[1];
+  out->lux1_fp = (uint16_t)(buf[2] | (buf[3] << 8));
+  out->lux2_fp = (uint16_t)(buf[4] | (buf[5] << 8));
+  return true;
+}
+
+// Batch frame: several consecutive sample pairs under one sync/seq/CRC,
+// cutting per-sample framing overhead from 3 bytes to a fraction of one —
+// the difference between 50 Hz and 100+ Hz fitting on the same wire.
+// Each sample carries its millisecond offset from the previous one so the
+// receiver can place (or interpolate) samples in time despite batching.
+//
+// Layout (variable, little-endian):
+//   0        sync byte (LUX_BATCH_SYNC)
+//   1        sequence number (same counter as single-sample frames)
+//   2        sample count, 1..LUX_BATCH_MAX_SAMPLES
+//   3+5i     dt_ms: ms since previous sample in the batch (0 for the first)
+//   4+5i..   sensor 1 lux fp, sensor 2 lux fp (as in the single frame)
+//   last     CRC8 (poly 0x07) over everything after the sync byte
+
+#define LUX_BATCH_SYNC          0xA8
+#define LUX_BATCH_MAX_SAMPLES   8
+#define LUX_BATCH_HDR_SIZE      3
+#define LUX_BATCH_FRAME_SIZE(n) (LUX_BATCH_HDR_SIZE + 5 * (n) + 1)
+#define LUX_BATCH_FRAME_MAX     LUX_BATCH_FRAME_SIZE(LUX_BATCH_MAX_SAMPLES)
+
+typedef struct {
+  uint8_t  seq;
+  uint8_t  count;
+  uint8_t  dt_ms[LUX_BATCH_MAX_SAMPLES];
+  uint16_t lux1_fp[LUX_BATCH_MAX_SAMPLES];
+  uint16_t lux2_fp[LUX_BATCH_MAX_SAMPLES];
+} lux_batch_t;
+
+// Returns the encoded length, or 0 when count is out of range
+static inline int lux_batch_encode(uint8_t buf[LUX_BATCH_FRAME_MAX],
+                                   const lux_batch_t *b) {
+  if (b->count == 0 || b->count > LUX_BATCH_MAX_SAMPLES) return 0;
+  buf[0] = LUX_BATCH_SYNC;
+  buf[1] = b->seq;
+  buf[2] = b->count;
+  int pos = LUX_BATCH_HDR_SIZE;
+  for (int i = 0; i < b->count; i++) {
+    buf[pos++] = b->dt_ms[i];
+    buf[pos++] = (uint8_t)(b->lux1_fp[i] & 0xFF);
+    buf[pos++] = (uint8_t)(b->lux1_fp[i] >> 8);
+    buf[pos++] = (uint8_t)(b->lux2_fp[i] & 0xFF);
+    buf[pos++] = (uint8_t)(b->lux2_fp[i] >> 8);
+  }
+  buf[pos] = lux_frame_crc8(&buf[1], pos - 1);
+  return pos + 1;
+}
+
+// Returns false on sync, count or CRC mismatch; buf must hold the full
+// frame (length is LUX_BATCH_FRAME_SIZE(buf[2]))
+static inline bool lux_batch_decode(const uint8_t *buf, lux_batch_t *out) {
+  if (buf[0] != LUX_BATCH_SYNC) return false;
+  uint8_t count = buf[2];
+  if (count == 0 || count > LUX_BATCH_MAX_SAMPLES) return false;
+  int len = LUX_BATCH_FRAME_SIZE(count);
+  if (lux_frame_crc8(&buf[1], len - 2) != buf[len - 1]) return false;
+  out->seq = buf[1];
+  out->count = count;
+  int pos = LUX_BATCH_HDR_SIZE;
+  for (int i = 0; i < count; i++) {
+    out->dt_ms[i] = buf[pos++];
+    out->lux1_fp[i] = (uint16_t)(buf[pos] | (buf[pos + 1] << 8));
+    pos += 2;
+    out->lux2_fp[i] = (uint16_t)(buf[pos] | (buf[pos + 1] << 8));
+    pos += 2;
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,358 @@
+#ifndef OTA_PATCH_H
+#define OTA_PATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Binary delta patch between two firmware images, carried over the
+// chamber's web endpoint ("/ota/patch"). Shared by the chamber firmware
+// (streaming applier) and the shore-side packaging tool (encoder) so the
+// layout cannot drift — same arrangement as LuxFrame.h.
+//
+// A recompile of this codebase changes a few percent of the image; at
+// ship-to-shore link speeds that is the difference between seconds and
+// tens of minutes per deployed chamber. The format is deliberately plain
+// — copy runs from the running image plus literal runs from the patch —
+// because the encoder, not the format, is where the compression lives,
+// and a plain format keeps the on-device applier small enough to audit.
+//
+// Patch layout (little-endian):
+//   0-3    magic "OPT1"
+//   4-7    base image size   (bytes of the running image covered)
+//   8-11   base image CRC32  (applier verifies before writing anything)
+//   12-15  new image size
+//   16-19  new image CRC32   (applier verifies after the last op)
+//   then ops until the new image is fully produced:
+//     0x01  COPY: u32 base offset, u32 length — bytes from the base image
+//     0x02  ADD:  u32 length, then that many literal bytes
+//
+// CRC32 is IEEE reflected, the same polynomial the satellite's RS-485
+// OTA path checks images with.
+
+#define OTA_PATCH_MAGIC       0x3154504FUL /* "OPT1" */
+#define OTA_PATCH_HEADER_SIZE 20
+
+#define OTA_PATCH_OP_COPY 0x01
+#define OTA_PATCH_OP_ADD  0x02
+
+// Applier error codes (negative, 0 = success)
+#define OTA_PATCH_ERR_MAGIC  (-1)
+#define OTA_PATCH_ERR_FORMAT (-2)
+#define OTA_PATCH_ERR_RANGE  (-3)
+#define OTA_PATCH_ERR_IO     (-4)
+#define OTA_PATCH_ERR_CRC    (-5)
+
+typedef struct {
+  uint32_t base_size;
+  uint32_t base_crc;
+  uint32_t new_size;
+  uint32_t new_crc;
+} ota_patch_hdr_t;
+
+// Streaming CRC32 (IEEE reflected), bitwise — the patch path is far from
+// hot and a table would cost 1 KB of flash on the device
+static inline uint32_t ota_patch_crc32(uint32_t crc, const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static inline uint32_t ota_patch_rd32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void ota_patch_wr32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)((v >> 8) & 0xFF);
+  p[2] = (uint8_t)((v >> 16) & 0xFF);
+  p[3] = (uint8_t)((v >> 24) & 0xFF);
+}
+
+/* ---------- Streaming applier ---------- */
+
+// Base-image reads and output writes go through callbacks so the device
+// side can map them straight onto esp_partition_read / esp_ota_write and
+// the host tests onto plain buffers. Both return 0 on success.
+typedef int (*ota_patch_read_fn)(void *ctx, uint32_t off, void *buf, size_t len);
+typedef int (*ota_patch_write_fn)(void *ctx, const void *buf, size_t len);
+
+typedef struct {
+  ota_patch_hdr_t hdr;
+  ota_patch_read_fn read_base;
+  ota_patch_write_fn write_out;
+  void *ctx;
+  // Parser state: bytes wanted before the current item (header or op
+  // arguments) completes, carried across feed() boundaries
+  uint8_t pending[OTA_PATCH_HEADER_SIZE];
+  size_t pending_len;
+  size_t pending_need;
+  uint8_t op;            // 0 = expecting an op byte
+  uint32_t add_left;     // literal bytes still owed to the current ADD
+  uint32_t produced;
+  uint32_t out_crc;
+  bool header_done;
+} ota_patch_apply_t;
+
+static inline void ota_patch_apply_begin(ota_patch_apply_t *a,
+                                         ota_patch_read_fn read_base,
+                                         ota_patch_write_fn write_out,
+                                         void *ctx) {
+  memset(a, 0, sizeof(*a));
+  a->read_base = read_base;
+  a->write_out = write_out;
+  a->ctx = ctx;
+  a->pending_need = OTA_PATCH_HEADER_SIZE;
+}
+
+// Emit new-image bytes: CRC, count, hand to the output callback
+static inline int ota_patch_emit_(ota_patch_apply_t *a, const void *buf, size_t len) {
+  if ((uint64_t)a->produced + len > a->hdr.new_size) {
+    return OTA_PATCH_ERR_RANGE;
+  }
+  if (a->write_out(a->ctx, buf, len) != 0) {
+    return OTA_PATCH_ERR_IO;
+  }
+  a->out_crc = ota_patch_crc32(a->out_crc, buf, len);
+  a->produced += (uint32_t)len;
+  return 0;
+}
+
+// Execute one complete COPY op against the base image in bounded chunks
+static inline int ota_patch_copy_(ota_patch_apply_t *a, uint32_t off, uint32_t len) {
+  if ((uint64_t)off + len > a->hdr.base_size) {
+    return OTA_PATCH_ERR_RANGE;
+  }
+  uint8_t chunk[128];
+  while (len > 0) {
+    size_t n = (len < sizeof(chunk)) ? len : sizeof(chunk);
+    if (a->read_base(a->ctx, off, chunk, n) != 0) {
+      return OTA_PATCH_ERR_IO;
+    }
+    int err = ota_patch_emit_(a, chunk, n);
+    if (err != 0) {
+      return err;
+    }
+    off += (uint32_t)n;
+    len -= (uint32_t)n;
+  }
+  return 0;
+}
+
+// Feed a slice of the patch stream; call repeatedly as bytes arrive.
+// Returns 0 to keep feeding, negative on error.
+static inline int ota_patch_apply_feed(ota_patch_apply_t *a,
+                                       const uint8_t *data, size_t len) {
+  while (len > 0) {
+    // Literal run in progress: pass bytes straight through
+    if (a->add_left > 0) {
+      size_t n = (len < a->add_left) ? len : a->add_left;
+      int err = ota_patch_emit_(a, data, n);
+      if (err != 0) {
+        return err;
+      }
+      a->add_left -= (uint32_t)n;
+      data += n;
+      len -= n;
+      continue;
+    }
+
+    // Accumulate the current fixed-size item (header, op byte, op args)
+    size_t n = a->pending_need - a->pending_len;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(a->pending + a->pending_len, data, n);
+    a->pending_len += n;
+    data += n;
+    len -= n;
+    if (a->pending_len < a->pending_need) {
+      return 0; // wait for more bytes
+    }
+    a->pending_len = 0;
+
+    if (!a->header_done) {
+      if (ota_patch_rd32(a->pending) != OTA_PATCH_MAGIC) {
+        return OTA_PATCH_ERR_MAGIC;
+      }
+      a->hdr.base_size = ota_patch_rd32(a->pending + 4);
+      a->hdr.base_crc = ota_patch_rd32(a->pending + 8);
+      a->hdr.new_size = ota_patch_rd32(a->pending + 12);
+      a->hdr.new_crc = ota_patch_rd32(a->pending + 16);
+      a->header_done = true;
+      a->pending_need = 1; // first op byte
+      continue;
+    }
+
+    if (a->op == 0) {
+      a->op = a->pending[0];
+      if (a->op == OTA_PATCH_OP_COPY) {
+        a->pending_need = 8;
+      } else if (a->op == OTA_PATCH_OP_ADD) {
+        a->pending_need = 4;
+      } else {
+        return OTA_PATCH_ERR_FORMAT;
+      }
+      continue;
+    }
+
+    if (a->op == OTA_PATCH_OP_COPY) {
+      int err = ota_patch_copy_(a, ota_patch_rd32(a->pending),
+                                ota_patch_rd32(a->pending + 4));
+      if (err != 0) {
+        return err;
+      }
+    } else {
+      a->add_left = ota_patch_rd32(a->pending);
+    }
+    a->op = 0;
+    a->pending_need = 1;
+  }
+  return 0;
+}
+
+// End of the patch stream: the new image must be exactly complete and its
+// CRC must match the header's claim. Returns 0 on success.
+static inline int ota_patch_apply_finish(const ota_patch_apply_t *a) {
+  if (!a->header_done || a->op != 0 || a->add_left != 0 ||
+      a->produced != a->hdr.new_size) {
+    return OTA_PATCH_ERR_FORMAT;
+  }
+  if (a->out_crc != a->hdr.new_crc) {
+    return OTA_PATCH_ERR_CRC;
+  }
+  return 0;
+}
+
+/* ---------- Encoder (shore / host side only) ---------- */
+
+// Block size the matcher indexes the base image at. Smaller finds more of
+// the unchanged code between relocations; 32 keeps op overhead (9 bytes
+// per COPY) well under the run lengths it typically finds.
+#define OTA_PATCH_ENC_BLOCK 32
+
+static inline uint32_t ota_patch_hash_(const uint8_t *p) {
+  // FNV-1a over one block: cheap and good enough for a verify-then-extend
+  // matcher, where a collision costs a memcmp, not a wrong byte
+  uint32_t h = 2166136261UL;
+  for (int i = 0; i < OTA_PATCH_ENC_BLOCK; i++) {
+    h = (h ^ p[i]) * 16777619UL;
+  }
+  return h;
+}
+
+// Greedy block-match encoder: index every block-aligned offset of the
+// base image in caller-provided scratch (table_entries power of two,
+// ~1 entry per base block), then walk the new image emitting verified,
+// forward-extended COPY runs and literal ADD runs between them. Returns
+// the patch size, or 0 when out_max is too small (callers fall back to a
+// full-image upload — a patch larger than the image has no reason to
+// exist).
+static inline size_t ota_patch_encode(const uint8_t *base, size_t base_len,
+                                      const uint8_t *img, size_t img_len,
+                                      uint8_t *out, size_t out_max,
+                                      uint32_t *table, size_t table_entries) {
+  if (out_max < OTA_PATCH_HEADER_SIZE || (table_entries & (table_entries - 1)) != 0) {
+    return 0;
+  }
+
+  ota_patch_wr32(out, OTA_PATCH_MAGIC);
+  ota_patch_wr32(out + 4, (uint32_t)base_len);
+  ota_patch_wr32(out + 8, ota_patch_crc32(0, base, base_len));
+  ota_patch_wr32(out + 12, (uint32_t)img_len);
+  ota_patch_wr32(out + 16, ota_patch_crc32(0, img, img_len));
+  size_t pos = OTA_PATCH_HEADER_SIZE;
+
+  // 0 marks an empty slot, so stored positions are offset by one. Short
+  // linear probing keeps hash collisions from shadowing base blocks —
+  // a shadowed block breaks what should be one long COPY into pieces.
+  memset(table, 0, table_entries * sizeof(table[0]));
+  for (size_t off = 0; off + OTA_PATCH_ENC_BLOCK <= base_len;
+       off += OTA_PATCH_ENC_BLOCK) {
+    uint32_t h = ota_patch_hash_(base + off);
+    for (int probe = 0; probe < 4; probe++) {
+      size_t slot = (h + (uint32_t)probe) & (table_entries - 1);
+      if (table[slot] == 0 || probe == 3) {
+        table[slot] = (uint32_t)(off + 1);
+        break;
+      }
+    }
+  }
+
+  size_t lit_start = 0; // start of the pending literal run
+  size_t i = 0;
+  while (i < img_len) {
+    size_t match_off = 0, match_len = 0;
+    if (i + OTA_PATCH_ENC_BLOCK <= img_len) {
+      uint32_t h = ota_patch_hash_(img + i);
+      for (int probe = 0; probe < 4 && match_len == 0; probe++) {
+        uint32_t slot = table[(h + (uint32_t)probe) & (table_entries - 1)];
+        if (slot == 0) {
+          continue;
+        }
+        size_t off = slot - 1;
+        if (memcmp(base + off, img + i, OTA_PATCH_ENC_BLOCK) == 0) {
+          match_off = off;
+          match_len = OTA_PATCH_ENC_BLOCK;
+          while (off + match_len < base_len && i + match_len < img_len &&
+                 base[off + match_len] == img[i + match_len]) {
+            match_len++;
+          }
+        }
+      }
+    }
+
+    if (match_len == 0) {
+      i++;
+      continue;
+    }
+
+    // Flush the literal run, then the copy
+    size_t lit = i - lit_start;
+    if (lit > 0) {
+      if (pos + 5 + lit > out_max) {
+        return 0;
+      }
+      out[pos++] = OTA_PATCH_OP_ADD;
+      ota_patch_wr32(out + pos, (uint32_t)lit);
+      pos += 4;
+      memcpy(out + pos, img + lit_start, lit);
+      pos += lit;
+    }
+    if (pos + 9 > out_max) {
+      return 0;
+    }
+    out[pos++] = OTA_PATCH_OP_COPY;
+    ota_patch_wr32(out + pos, (uint32_t)match_off);
+    pos += 4;
+    ota_patch_wr32(out + pos, (uint32_t)match_len);
+    pos += 4;
+
+    i += match_len;
+    lit_start = i;
+  }
+
+  size_t lit = img_len - lit_start;
+  if (lit > 0) {
+    if (pos + 5 + lit > out_max) {
+      return 0;
+    }
+    out[pos++] = OTA_PATCH_OP_ADD;
+    ota_patch_wr32(out + pos, (uint32_t)lit);
+    pos += 4;
+    memcpy(out + pos, img + lit_start, lit);
+    pos += lit;
+  }
+
+  return pos;
+}
+
+#endif
@@ -0,0 +1,114 @@
+// Microbenchmarks for the per-sample / per-report hot paths:
+//
+//   report_serialize   the lora_send_report() serializer — 13 robust channel
+//                      aggregates into a packed orca_report_wire_t + memcpy
+//   nmea_sentence      gps.c parse path: index one RMC sentence and convert
+//                      both coordinates to e7 fixed point
+//   bounds_update      InputOutput::updateBounds() — one SlidingMinMax push
+//   as7343_decode      burst-read decode, 37-byte buffer to 13 channels
+//   lux_frame_codec    chamber wire protocol encode + decode roundtrip
+//
+// Build on the host via the CMake target here; on target, compile this
+// file into an IDF/Arduino project and call bench_hotpath_run() — the
+// timing harness switches to esp_timer_get_time() automatically.
+
+#include <string.h>
+
+#include "LuxFrame.h"
+#include "SlidingMinMax.h"
+#include "as7343_decode.h"
+#include "bench_util.h"
+#include "nmea.h"
+#include "orca_agg.h"
+#include "orca_payload.h"
+
+volatile uint32_t bench_sink = 0;
+
+static uint32_t lcg_state = 2468;
+static uint32_t lcg() {
+  lcg_state = lcg_state * 1664525u + 1013904223u;
+  return lcg_state >> 16;
+}
+
+static void bench_report_serialize() {
+  uint16_t window[ORCA_NUM_CHANNELS][ORCA_AGG_WINDOW_MAX];
+  for (int c = 0; c < ORCA_NUM_CHANNELS; c++)
+    for (int i = 0; i < ORCA_AGG_WINDOW_MAX; i++)
+      window[c][i] = (uint16_t)lcg();
+
+  uint8_t buf[ORCA_REPORT_WIRE_SIZE];
+  BENCH_RUN("report_serialize", {
+    orca_report_wire_t wire = {};
+    wire.sample_count = (uint32_t)bi;
+    for (int c = 0; c < ORCA_NUM_CHANNELS; c++) {
+      wire.channels[c] = orca_robust_agg_u16(window[c], ORCA_AGG_WINDOW_MAX,
+                                             ORCA_AGG_WINDOW_MAX,
+                                             ORCA_AGG_MEDIAN);
+    }
+    wire.gps_valid = 1;
+    wire.lat_e7 = 481173000;
+    wire.lon_e7 = 115166667;
+    wire.unix_time = 1700000000u;
+    memcpy(buf, &wire, ORCA_REPORT_WIRE_SIZE);
+    bench_sink += buf[4];
+  });
+}
+
+static void bench_nmea_sentence() {
+  static const char rmc[] =
+      "GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,,*6A";
+  char scratch[sizeof(rmc)];
+  BENCH_RUN("nmea_sentence", {
+    memcpy(scratch, rmc, sizeof(rmc));  // nmea_index terminates in place
+    nmea_cursor_t cur;
+    nmea_index(scratch, &cur);
+    bench_sink += (uint32_t)nmea_coord_to_e7(&cur, 3, 4);
+    bench_sink += (uint32_t)nmea_coord_to_e7(&cur, 5, 6);
+  });
+}
+
+static void bench_bounds_update() {
+  // Same window size as the chamber's lux bounds (LUX_BUFFER_SIZE scale)
+  static SlidingMinMax<64> smm;
+  BENCH_RUN("bounds_update", {
+    smm.push((int)(lcg() % 4096));
+    bench_sink += (uint32_t)(smm.maxValue() - smm.minValue());
+  });
+}
+
+static void bench_as7343_decode() {
+  uint8_t raw[36];
+  for (int i = 0; i < 36; i++) raw[i] = (uint8_t)lcg();
+  as7343_channels_t ch;
+  BENCH_RUN("as7343_decode", {
+    as7343_decode_burst(raw, AS7343_SMUX_18CH, &ch);
+    bench_sink += ch.clear;
+  });
+}
+
+static void bench_lux_frame_codec() {
+  uint8_t buf[LUX_FRAME_SIZE];
+  lux_sample_t s = {};
+  BENCH_RUN("lux_frame_codec", {
+    lux_frame_encode(buf, (uint8_t)bi, (uint16_t)lcg(), (uint16_t)lcg());
+    lux_frame_decode(buf, &s);
+    bench_sink += s.lux1_fp;
+  });
+}
+
+void bench_hotpath_run() {
+  bench_report_serialize();
+  bench_nmea_sentence();
+  bench_bounds_update();
+  bench_as7343_decode();
+  bench_lux_frame_codec();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main(void) { bench_hotpath_run(); }
+#else
+int main() {
+  bench_hotpath_run();
+  return 0;
+}
+#endif
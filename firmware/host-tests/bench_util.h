@@ -0,0 +1,46 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+// Minimal microbenchmark harness shared by the host and on-target builds:
+// bench_now_us() is esp_timer_get_time() under ESP-IDF and CLOCK_MONOTONIC
+// on the host, so the same benchmark file reports wall-numbers from both.
+// BENCH_RUN calibrates the iteration count to ~100 ms per case, reports
+// ns/op and ops/s, and routes results through a volatile sink so the
+// optimizer cannot delete the measured work.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+static inline int64_t bench_now_us(void) { return esp_timer_get_time(); }
+#else
+#include <time.h>
+static inline int64_t bench_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+// Accumulate results here so the compiler must keep the measured work
+extern volatile uint32_t bench_sink;
+
+// body is a statement (or block) run `iters` times per timing pass
+#define BENCH_RUN(name, body)                                               \
+  do {                                                                      \
+    /* Warm up and calibrate: grow iters until a pass takes >= 100 ms */    \
+    int64_t iters = 64, elapsed = 0;                                        \
+    for (;;) {                                                              \
+      int64_t t0 = bench_now_us();                                          \
+      for (int64_t bi = 0; bi < iters; bi++) { body; }                      \
+      elapsed = bench_now_us() - t0;                                        \
+      if (elapsed >= 100000 || iters > (int64_t)1 << 40) break;             \
+      iters *= (elapsed < 10000) ? 8 : 2;                                   \
+    }                                                                       \
+    double ns_op = (double)elapsed * 1000.0 / (double)iters;                \
+    printf("%-24s %12.1f ns/op %14.0f ops/s  (%lld iters)\n",               \
+           name, ns_op, 1e9 / ns_op, (long long)iters);                     \
+  } while (0)
+
+#endif
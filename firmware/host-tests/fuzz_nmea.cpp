@@ -0,0 +1,199 @@
+// NMEA parser fuzzing harness + worst-case-input throughput benchmark.
+//
+// The sentence path (nmea_index's in-place field termination feeding the
+// RMC/GGA handlers in gps_parse_sentence) is exactly the code shape where
+// garbled shipboard serial bytes cause overreads or livelock, and a parser
+// that stalls on garbage turns the GPS lock timeout into the common case.
+// This harness throws mutated and purely random sentences at the host
+// build of the shipped parser and checks two invariants after every call:
+// the parser touched nothing past the sentence's NUL (guard canary), and
+// it returned at all (no livelock — the run completing is the check).
+//
+//   fuzz_nmea            deterministic 200k-case run + throughput numbers
+//                        (registered with ctest)
+//   fuzz_nmea N          same with N mutation cases
+//
+// For deeper runs, build with clang -fsanitize=fuzzer,address -DFUZZ_LIB
+// and libFuzzer drives LLVMFuzzerTestOneInput directly.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_util.h"
+#include "gps_parse.h"
+#include "test_util.h"
+
+volatile uint32_t bench_sink = 0;
+
+// Sentence buffer with a guard region: the parser may write anywhere up to
+// and including the NUL it was handed, and nowhere beyond.
+#define FUZZ_BUF   128
+#define GUARD_LEN  32
+#define GUARD_BYTE 0xA5
+
+static uint8_t s_arena[FUZZ_BUF + GUARD_LEN];
+
+static int check_guard(const uint8_t *data, size_t len) {
+  for (size_t i = len + 1; i < sizeof(s_arena); i++) {
+    if (s_arena[i] != GUARD_BYTE) {
+      fprintf(stderr, "guard clobbered at +%zu after: %.*s\n",
+              i - len, (int)len, (const char *)data);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int run_one(const uint8_t *data, size_t len) {
+  if (len >= FUZZ_BUF) len = FUZZ_BUF - 1;
+  int failures = 0;
+  gps_data_t out = {};
+
+  // Both entry points get a fresh copy: each indexes (and NULs) in place
+  memcpy(s_arena, data, len);
+  s_arena[len] = '\0';
+  memset(s_arena + len + 1, GUARD_BYTE, sizeof(s_arena) - len - 1);
+  gps_parse_sentence((char *)s_arena, &out);
+  failures += check_guard(data, len);
+
+  memcpy(s_arena, data, len);
+  s_arena[len] = '\0';
+  gps_parse_time_only((char *)s_arena, &out);
+  failures += check_guard(data, len);
+
+  return failures;
+}
+
+#ifdef FUZZ_LIB
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  run_one(data, size);
+  return 0;
+}
+#else
+
+static uint32_t lcg_state = 0xF022;
+static uint32_t lcg() {
+  lcg_state = lcg_state * 1664525u + 1013904223u;
+  return lcg_state >> 16;
+}
+
+// Seeds: the shapes the handlers actually dispatch on, plus near-misses
+static const char *CORPUS[] = {
+  "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,,*6A",
+  "$GNRMC,123519,V,,,,,,,230394,,*00",
+  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47",
+  "$GPVTG,084.4,T,,M,022.4,N,041.5,K*43",
+  "$GPRMC",
+  "$",
+  "$,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,",
+  "$GPRMC,123519,A,999999999999.038,N,01131.000,E,0,0,230394,,*6A",
+  "$GPRMC,123519,A,4807.038,NNNNNNNN,01131.000,EEEE,,,30394,,*",
+};
+#define CORPUS_N ((int)(sizeof(CORPUS) / sizeof(CORPUS[0])))
+
+static int fuzz_mutations(long cases) {
+  uint8_t buf[FUZZ_BUF];
+  int failures = 0;
+
+  for (long c = 0; c < cases; c++) {
+    size_t len;
+    if (c % 4 == 0) {
+      // Pure line noise, occasionally sprinkled with structure
+      len = 1 + lcg() % (FUZZ_BUF - 1);
+      for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)lcg();
+      if (lcg() % 2) buf[0] = '$';
+    } else {
+      // Mutate a corpus sentence: flips, truncation, insertion, repetition
+      const char *seed = CORPUS[lcg() % CORPUS_N];
+      len = strlen(seed);
+      memcpy(buf, seed, len);
+      int edits = 1 + (int)(lcg() % 8);
+      for (int e = 0; e < edits && len > 0; e++) {
+        switch (lcg() % 4) {
+        case 0: buf[lcg() % len] = (uint8_t)lcg(); break;         // flip
+        case 1: len = 1 + lcg() % len; break;                      // truncate
+        case 2:                                                    // insert
+          if (len < FUZZ_BUF - 1) {
+            size_t at = lcg() % (len + 1);
+            memmove(buf + at + 1, buf + at, len - at);
+            buf[at] = (uint8_t)((lcg() % 2) ? ',' : lcg());
+            len++;
+          }
+          break;
+        case 3: buf[lcg() % len] = (lcg() % 2) ? '*' : '.'; break; // structure
+        }
+      }
+    }
+    failures += run_one(buf, len);
+  }
+  return failures;
+}
+
+int main(int argc, char **argv) {
+  long cases = (argc > 1) ? atol(argv[1]) : 200000;
+
+  int failures = fuzz_mutations(cases);
+  CHECK_EQ(failures, 0);
+  printf("fuzz_nmea: %ld cases, %d guard violations\n", cases, failures);
+
+  // Throughput on hostile input: the all-commas sentence maxes out the
+  // field indexer, a valid RMC maxes out the conversion path. Both bound
+  // the per-sentence cost a noise burst can impose on the lock loop.
+  static const char rmc[] =
+      "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,,*6A";
+  char worst[FUZZ_BUF];
+  worst[0] = '$';
+  memset(worst + 1, ',', FUZZ_BUF - 2);
+  worst[FUZZ_BUF - 1] = '\0';
+
+  char scratch[FUZZ_BUF];
+  gps_data_t out = {};
+  BENCH_RUN("nmea_worst_case", {
+    memcpy(scratch, worst, sizeof(worst));
+    gps_parse_sentence(scratch, &out);
+    bench_sink += (uint32_t)out.satellites;
+  });
+  BENCH_RUN("nmea_valid_rmc", {
+    memcpy(scratch, rmc, sizeof(rmc));
+    gps_parse_sentence(scratch, &out);
+    bench_sink += (uint32_t)out.valid;
+  });
+  // Time-only fast path: full extraction on RMC vs header-compare rejection
+  // of everything else (the per-sentence cost during a timestamp refresh)
+  static const char gga[] =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+  BENCH_RUN("nmea_time_only_rmc", {
+    memcpy(scratch, rmc, sizeof(rmc));
+    bench_sink += (uint32_t)gps_parse_time_only(scratch, &out);
+  });
+  BENCH_RUN("nmea_time_only_reject", {
+    memcpy(scratch, gga, sizeof(gga));
+    bench_sink += (uint32_t)gps_parse_time_only(scratch, &out);
+  });
+
+  // The fast path must agree with the full parser on what it does extract
+  {
+    memcpy(scratch, rmc, sizeof(rmc));
+    gps_data_t fast = {};
+    CHECK(gps_parse_time_only(scratch, &fast));
+    gps_data_t full = {};
+    memcpy(scratch, rmc, sizeof(rmc));
+    gps_parse_sentence(scratch, &full);
+    CHECK(fast.datetime_valid);
+    CHECK_EQ(fast.datetime.tm_hour, full.datetime.tm_hour);
+    CHECK_EQ(fast.datetime.tm_min, full.datetime.tm_min);
+    CHECK_EQ(fast.datetime.tm_sec, full.datetime.tm_sec);
+    CHECK_EQ(fast.datetime.tm_mday, full.datetime.tm_mday);
+    CHECK_EQ(fast.datetime.tm_mon, full.datetime.tm_mon);
+    CHECK_EQ(fast.datetime.tm_year, full.datetime.tm_year);
+    CHECK_EQ(fast.valid, false);  // navigation state untouched
+    memcpy(scratch, gga, sizeof(gga));
+    gps_data_t rej = {};
+    CHECK(!gps_parse_time_only(scratch, &rej));
+    CHECK(!rej.datetime_valid);
+  }
+
+  return test_summary("fuzz_nmea");
+}
+#endif /* !FUZZ_LIB */
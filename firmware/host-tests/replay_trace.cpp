@@ -0,0 +1,336 @@
+// Recorded-trace replay engine: feeds byte streams through the exact
+// parsers and pipeline the firmware ships, with a deterministic clockless
+// data path, and reports end-to-end cycle times.
+//
+//   GPS (UBX):    raw NAV-PVT byte stream  -> ubx_parser_feed()
+//   GPS (NMEA):   sentence-per-line text   -> gps_parse_sentence()
+//   Channels:     36-byte burst records    -> as7343_decode_burst()
+//                 -> accumulate -> robust aggregate -> wire encode
+//                 (the accumulation/transmit pipeline of the wake cycle)
+//
+// Usage:
+//   replay_trace                     self-check on built-in synthetic traces
+//                                    (this mode is registered with ctest)
+//   replay_trace --ubx FILE          replay a recorded UART byte capture
+//   replay_trace --nmea FILE         replay a recorded sentence log
+//   replay_trace --channels FILE     replay recorded burst reads (36 B/rec)
+//
+// Record captures on hardware by dumping the UART ring buffer / burst
+// buffer to flash or console; any byte-exact capture replays here. On
+// target, compile this file into an IDF project and call
+// replay_trace_run_synthetic() for silicon numbers (esp_timer clock).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "as7343_decode.h"
+#include "bench_util.h"
+#include "gps_parse.h"
+#include "orca_agg.h"
+#include "orca_payload.h"
+#include "test_util.h"
+
+volatile uint32_t bench_sink = 0;
+
+/* ------------------------------------------------------------------ */
+/* Trace synthesis                                                     */
+/* ------------------------------------------------------------------ */
+
+static uint32_t lcg_state = 31337;
+static uint32_t lcg() {
+  lcg_state = lcg_state * 1664525u + 1013904223u;
+  return lcg_state >> 16;
+}
+
+static void put_u2(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_i4(uint8_t *p, int32_t v) {
+  p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+// Append one framed NAV-PVT message (Fletcher checksum included); returns
+// the number of bytes written
+static int synth_nav_pvt(uint8_t *out, int32_t lat_e7, int32_t lon_e7,
+                         uint8_t sats) {
+  uint8_t payload[UBX_NAV_PVT_LEN] = {0};
+  put_u2(payload + 4, 2026);          // year
+  payload[6] = 8;                     // month
+  payload[7] = 29;                    // day
+  payload[8] = 12; payload[9] = 34; payload[10] = 56;
+  payload[11] = 0x03;                 // validDate | validTime
+  payload[20] = 3;                    // fix_type: 3D
+  payload[21] = 0x01;                 // gnssFixOK
+  payload[23] = sats;
+  put_i4(payload + 24, lon_e7);
+  put_i4(payload + 28, lat_e7);
+  put_i4(payload + 36, 123450);       // hMSL, mm
+  put_i4(payload + 60, 1389);         // gSpeed, mm/s (~5 km/h)
+  put_i4(payload + 64, 8440000);      // headMot, 1e-5 deg
+  put_u2(payload + 76, 180);          // pdop 1.80
+
+  out[0] = 0xB5; out[1] = 0x62;
+  out[2] = 0x01; out[3] = 0x07;       // NAV-PVT
+  put_u2(out + 4, UBX_NAV_PVT_LEN);
+  memcpy(out + 6, payload, UBX_NAV_PVT_LEN);
+  uint8_t ck_a = 0, ck_b = 0;
+  for (int i = 2; i < 6 + UBX_NAV_PVT_LEN; i++) {
+    ck_a = (uint8_t)(ck_a + out[i]);
+    ck_b = (uint8_t)(ck_b + ck_a);
+  }
+  out[6 + UBX_NAV_PVT_LEN] = ck_a;
+  out[7 + UBX_NAV_PVT_LEN] = ck_b;
+  return 8 + UBX_NAV_PVT_LEN;
+}
+
+/* ------------------------------------------------------------------ */
+/* Replay: GPS byte streams                                            */
+/* ------------------------------------------------------------------ */
+
+static void replay_ubx(const uint8_t *bytes, size_t len, gps_data_t *data,
+                       int *fixes_out) {
+  ubx_parser_t parser;
+  ubx_parser_reset(&parser);
+
+  int fixes = 0;
+  int64_t t0 = bench_now_us();
+  for (size_t i = 0; i < len; i++) {
+    if (ubx_parser_feed(&parser, bytes[i], data)) fixes++;
+  }
+  int64_t elapsed = bench_now_us() - t0;
+
+  printf("ubx replay:      %zu bytes, %d fixes, %lld us total",
+         len, fixes, (long long)elapsed);
+  if (fixes > 0)
+    printf(", %.1f us/epoch", (double)elapsed / fixes);
+  printf("\n");
+  *fixes_out = fixes;
+}
+
+static void replay_nmea_text(const char *text, size_t len, gps_data_t *data,
+                             int *lines_out) {
+  int lines = 0;
+  char scratch[128];
+  int64_t t0 = bench_now_us();
+
+  const char *p = text;
+  const char *end = text + len;
+  while (p < end) {
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    size_t n = nl ? (size_t)(nl - p) : (size_t)(end - p);
+    if (n > 0 && p[n - 1] == '\r') n--;
+    if (n > 0 && n < sizeof(scratch) && p[0] == '$') {
+      memcpy(scratch, p, n);
+      scratch[n] = '\0';
+      gps_parse_sentence(scratch, data);
+      lines++;
+    }
+    p += nl ? (size_t)(nl - p) + 1 : (size_t)(end - p);
+  }
+
+  int64_t elapsed = bench_now_us() - t0;
+  printf("nmea replay:     %d sentences, %lld us total", lines,
+         (long long)elapsed);
+  if (lines > 0)
+    printf(", %.1f us/sentence", (double)elapsed / lines);
+  printf("\n");
+  *lines_out = lines;
+}
+
+/* ------------------------------------------------------------------ */
+/* Replay: channel accumulation / transmit pipeline                    */
+/*                                                                     */
+/* Mirrors one wake cycle: decode the burst, accumulate sums and the   */
+/* retained window (as the RTC accumulator does), and every            */
+/* samples_per_report close the cycle with 13 robust aggregates into a */
+/* wire report — the path between as7343_get_spectral_data() and       */
+/* lora_send_report().                                                 */
+/* ------------------------------------------------------------------ */
+
+static void replay_channels(const uint8_t *records, int count,
+                            int samples_per_report, uint32_t *reports_out,
+                            uint8_t *last_report /* ORCA_REPORT_WIRE_SIZE */) {
+  uint64_t sums[ORCA_NUM_CHANNELS] = {0};
+  uint16_t window[ORCA_NUM_CHANNELS][ORCA_AGG_WINDOW_MAX];
+  uint32_t cycle_samples = 0, total_samples = 0, reports = 0;
+  int64_t worst_cycle = 0;
+
+  int64_t t0 = bench_now_us();
+  for (int r = 0; r < count; r++) {
+    int64_t c0 = bench_now_us();
+
+    as7343_channels_t ch;
+    as7343_decode_burst(records + (size_t)r * 36, AS7343_SMUX_18CH, &ch);
+
+    const uint16_t *v = (const uint16_t *)&ch;
+    int slot = (int)(cycle_samples % ORCA_AGG_WINDOW_MAX);
+    for (int c = 0; c < ORCA_NUM_CHANNELS; c++) {
+      sums[c] += v[c];
+      window[c][slot] = v[c];
+    }
+    cycle_samples++;
+    total_samples++;
+
+    if ((int)cycle_samples >= samples_per_report) {
+      orca_report_wire_t wire = {};
+      wire.sample_count = total_samples;
+      for (int c = 0; c < ORCA_NUM_CHANNELS; c++) {
+        wire.channels[c] = orca_robust_agg_u16(window[c], cycle_samples,
+                                               ORCA_AGG_WINDOW_MAX,
+                                               ORCA_AGG_MEDIAN);
+        sums[c] = 0;
+      }
+      wire.unix_time = 1700000000u + reports;
+      memcpy(last_report, &wire, ORCA_REPORT_WIRE_SIZE);
+      cycle_samples = 0;
+      reports++;
+    }
+
+    int64_t cycle = bench_now_us() - c0;
+    if (cycle > worst_cycle) worst_cycle = cycle;
+  }
+  int64_t elapsed = bench_now_us() - t0;
+
+  printf("channel replay:  %d bursts, %u reports, %lld us total, "
+         "worst cycle %lld us\n",
+         count, (unsigned)reports, (long long)elapsed, (long long)worst_cycle);
+  *reports_out = reports;
+}
+
+/* ------------------------------------------------------------------ */
+/* Synthetic self-check (deterministic; the ctest entry point)         */
+/* ------------------------------------------------------------------ */
+
+int replay_trace_run_synthetic() {
+  // UBX: 50 epochs walking north-east, with line noise and a corrupted
+  // frame between messages to exercise resynchronization
+  {
+    static uint8_t trace[50 * 110 + 256];
+    size_t len = 0;
+    for (int e = 0; e < 50; e++) {
+      // Inter-message noise; a 0xB5 here would legitimately cost the parser
+      // the following frame, so keep it off the sync byte for a fixed count
+      uint8_t noise = (uint8_t)lcg();
+      trace[len++] = (noise == 0xB5) ? 0x00 : noise;
+      if (e == 25) {                  // one frame with a flipped payload byte
+        len += (size_t)synth_nav_pvt(trace + len, 0, 0, 1);
+        trace[len - 40] ^= 0xFF;
+      }
+      len += (size_t)synth_nav_pvt(trace + len, 481173000 + e * 100,
+                                   115166667 + e * 100, (uint8_t)(8 + e % 4));
+    }
+
+    gps_data_t data = {};
+    int fixes = 0;
+    replay_ubx(trace, len, &data, &fixes);
+    CHECK_EQ(fixes, 50);  // the corrupt frame must not count
+    CHECK(data.valid);
+    CHECK_EQ(data.fix_type, GPS_FIX_TYPE_3D);
+    CHECK((int64_t)(data.latitude * 1e7 + 0.5) == 481173000 + 49 * 100);
+    CHECK((int64_t)(data.longitude * 1e7 + 0.5) == 115166667 + 49 * 100);
+    CHECK(data.datetime_valid);
+    CHECK_EQ(data.datetime.tm_year, 2026 - 1900);
+  }
+
+  // NMEA: RMC/GGA pairs plus unhandled and garbage lines
+  {
+    static const char text[] =
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,,*6A\r\n"
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+        "$GPVTG,084.4,T,,M,022.4,N,041.5,K*43\r\n"
+        "garbage before sync\r\n"
+        "$GPRMC,123520,A,4807.040,N,01131.002,E,022.4,084.4,230394,,*6A\r\n";
+
+    gps_data_t data = {};
+    int lines = 0;
+    replay_nmea_text(text, sizeof(text) - 1, &data, &lines);
+    CHECK_EQ(lines, 4);  // garbage line skipped, VTG indexed but unhandled
+    CHECK(data.valid);
+    CHECK_EQ(data.satellites, 8);
+    CHECK((int64_t)(data.latitude * 1e7 + 0.5) == 481173333);
+    CHECK_EQ(data.datetime.tm_sec, 20);
+  }
+
+  // Channels: 64 bursts at 16 samples per report -> 4 reports
+  {
+    static uint8_t records[64 * 36];
+    for (size_t i = 0; i < sizeof(records); i++) records[i] = (uint8_t)lcg();
+    // Pin the cycle-1 FZ word of every burst so the median is predictable
+    for (int r = 0; r < 64; r++) { records[r * 36] = 0x34; records[r * 36 + 1] = 0x12; }
+
+    uint32_t reports = 0;
+    uint8_t last[ORCA_REPORT_WIRE_SIZE];
+    replay_channels(records, 64, ORCA_AGG_WINDOW_MAX, &reports, last);
+    CHECK_EQ(reports, 4);
+
+    const orca_report_wire_t *wire = orca_report_decode(last);
+    CHECK_EQ(wire->sample_count, 64);
+    // The replay accumulates in as7343_channels_t field order; fz is field 8
+    CHECK_EQ(wire->channels[8], 0x1234);
+  }
+
+  return test_summary("replay_trace");
+}
+
+#ifdef ESP_PLATFORM
+
+extern "C" void app_main(void) { replay_trace_run_synthetic(); }
+
+#else
+
+static uint8_t *read_file(const char *path, size_t *len_out) {
+  FILE *f = fopen(path, "rb");
+  if (!f) { perror(path); return NULL; }
+  fseek(f, 0, SEEK_END);
+  long sz = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *buf = (uint8_t *)malloc((size_t)sz);
+  if (!buf || fread(buf, 1, (size_t)sz, f) != (size_t)sz) {
+    fclose(f);
+    free(buf);
+    fprintf(stderr, "short read: %s\n", path);
+    return NULL;
+  }
+  fclose(f);
+  *len_out = (size_t)sz;
+  return buf;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 1) return replay_trace_run_synthetic();
+
+  if (argc != 3) {
+    fprintf(stderr,
+            "usage: %s [--ubx|--nmea|--channels FILE]\n"
+            "       (no arguments: synthetic self-check)\n", argv[0]);
+    return 2;
+  }
+
+  size_t len = 0;
+  uint8_t *buf = read_file(argv[2], &len);
+  if (!buf) return 2;
+
+  gps_data_t data = {};
+  int n = 0;
+  if (strcmp(argv[1], "--ubx") == 0) {
+    replay_ubx(buf, len, &data, &n);
+    printf("final fix: valid=%d lat=%.7f lon=%.7f sats=%d\n",
+           data.valid, data.latitude, data.longitude, data.satellites);
+  } else if (strcmp(argv[1], "--nmea") == 0) {
+    replay_nmea_text((const char *)buf, len, &data, &n);
+    printf("final fix: valid=%d lat=%.7f lon=%.7f sats=%d\n",
+           data.valid, data.latitude, data.longitude, data.satellites);
+  } else if (strcmp(argv[1], "--channels") == 0) {
+    uint32_t reports = 0;
+    uint8_t last[ORCA_REPORT_WIRE_SIZE] = {0};
+    replay_channels(buf, (int)(len / 36), ORCA_AGG_WINDOW_MAX, &reports, last);
+  } else {
+    fprintf(stderr, "unknown mode %s\n", argv[1]);
+    free(buf);
+    return 2;
+  }
+  free(buf);
+  return 0;
+}
+
+#endif
@@ -0,0 +1,42 @@
+// Compile-time gain/integration normalization for AS7343 raw counts
+
+#include "as7343_norm.h"
+#include "test_util.h"
+
+int main() {
+  // Reference operating point normalizes to identity
+  CHECK_EQ(AS7343_NORM_Q16[AS7343_NORM_REF_GAIN_STEP], 1u << 16);
+  CHECK_EQ(as7343_norm_apply(1234, AS7343_NORM_Q16[9]), 1234);
+
+  // Gain legs are exact power-of-two ratios of the 256x reference
+  CHECK_EQ(AS7343_NORM_Q16[1], 256u << 16);   // 1x
+  CHECK_EQ(AS7343_NORM_Q16[0], 512u << 16);   // 0.5x
+  CHECK_EQ(AS7343_NORM_Q16[12], 1u << 13);    // 2048x -> x1/8
+  for (int s = 1; s < AS7343_NORM_STEPS; s++) {
+    CHECK_EQ(AS7343_NORM_Q16[s - 1], 2 * AS7343_NORM_Q16[s]);
+  }
+
+  // Application: a dim reading captured at 1x scales up 256x on the wire
+  CHECK_EQ(as7343_norm_apply(100, AS7343_NORM_Q16[1]), 25600);
+  // ...and saturates instead of wrapping once past full scale
+  CHECK_EQ(as7343_norm_apply(300, AS7343_NORM_Q16[1]), 0xFFFF);
+  CHECK_EQ(as7343_norm_apply(0xFFFF, AS7343_NORM_Q16[0]), 0xFFFF);
+  // A bright reading at 2048x scales down losslessly (multiples of 8)
+  CHECK_EQ(as7343_norm_apply(8000, AS7343_NORM_Q16[12]), 1000);
+  CHECK_EQ(as7343_norm_apply(0, AS7343_NORM_Q16[5]), 0);
+
+  // Integration leg: doubling the integration time halves the multiplier
+  CHECK_EQ(as7343_norm_mult_q16(AS7343_NORM_REF_GAIN_STEP, 1, 599), 1u << 15);
+  // ...and a shorter integration scales counts up proportionally
+  CHECK_EQ(as7343_norm_mult_q16(AS7343_NORM_REF_GAIN_STEP, 0, 299),
+           (1u << 16) * 600u / 300u);
+
+  // The whole table agrees with the floating-point definition
+  for (int s = 0; s < AS7343_NORM_STEPS; s++) {
+    double gain = (s == 0) ? 0.5 : (double)(1u << (s - 1));
+    double expect = 65536.0 * 256.0 / gain;
+    CHECK_EQ(AS7343_NORM_Q16[s], (uint32_t)expect);
+  }
+
+  return test_summary("as7343_norm");
+}
@@ -0,0 +1,115 @@
+// Black-box record delta codec: XOR-vs-predecessor + zero-run-length
+
+#include "bbdelta.h"
+#include "test_util.h"
+
+#include <string.h>
+
+#define REC_MAX 86
+
+static uint32_t seed = 0xB1ACB0C5;
+static uint32_t lcg() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 16;
+}
+
+// Encode cur against prev, decode back, and check byte equality
+static size_t roundtrip(const uint8_t* prev, size_t prev_len,
+                        const uint8_t* cur, size_t cur_len) {
+  uint8_t enc[BBDELTA_BOUND(REC_MAX)];
+  uint8_t dec[REC_MAX];
+  size_t enc_len = bbdelta_encode(prev, prev_len, cur, cur_len, enc, sizeof(enc));
+  CHECK(enc_len > 0 || cur_len == 0);
+  size_t dec_len = bbdelta_decode(prev, prev_len, enc, enc_len, dec, sizeof(dec));
+  CHECK_EQ(dec_len, cur_len);
+  CHECK_EQ(memcmp(dec, cur, cur_len), 0);
+  return enc_len;
+}
+
+int main() {
+  // Identical records: one zero-run token per 128 bytes
+  {
+    uint8_t rec[77];
+    for (size_t i = 0; i < sizeof(rec); i++) rec[i] = (uint8_t)lcg();
+    size_t enc_len = roundtrip(rec, sizeof(rec), rec, sizeof(rec));
+    CHECK_EQ(enc_len, 1);
+  }
+
+  // Realistic drift: a few low bytes move between consecutive reports —
+  // the shape the codec exists for. Ratio must clear 3x.
+  {
+    uint8_t prev[77], cur[77];
+    for (size_t i = 0; i < sizeof(prev); i++) prev[i] = (uint8_t)lcg();
+    memcpy(cur, prev, sizeof(cur));
+    for (int i = 0; i < 8; i++) {
+      cur[(lcg() % 38) * 2] ^= (uint8_t)(1 + lcg() % 15);  // low bytes only
+    }
+    size_t enc_len = roundtrip(prev, sizeof(prev), cur, sizeof(cur));
+    CHECK(enc_len * 3 <= sizeof(cur));
+  }
+
+  // No predecessor: the difference is the record itself, still exact
+  {
+    uint8_t rec[REC_MAX];
+    for (size_t i = 0; i < sizeof(rec); i++) rec[i] = (uint8_t)lcg();
+    roundtrip(NULL, 0, rec, sizeof(rec));
+  }
+
+  // Unequal lengths both ways (trailer growth / shrink between records)
+  {
+    uint8_t prev[77], cur[REC_MAX];
+    for (size_t i = 0; i < sizeof(cur); i++) cur[i] = (uint8_t)lcg();
+    memcpy(prev, cur, sizeof(prev));
+    roundtrip(prev, sizeof(prev), cur, sizeof(cur));   // longer than prev
+    roundtrip(cur, sizeof(cur), prev, sizeof(prev));   // shorter than prev
+  }
+
+  // Incompressible input stays within the documented worst-case bound
+  {
+    uint8_t prev[REC_MAX], cur[REC_MAX];
+    for (size_t i = 0; i < sizeof(cur); i++) {
+      prev[i] = (uint8_t)lcg();
+      cur[i] = (uint8_t)(prev[i] ^ (uint8_t)(1 + (lcg() % 255)));
+    }
+    size_t enc_len = roundtrip(prev, sizeof(prev), cur, sizeof(cur));
+    CHECK(enc_len <= BBDELTA_BOUND(sizeof(cur)));
+  }
+
+  // Encode refuses to overflow a too-small output instead of truncating
+  {
+    uint8_t prev[64] = {0}, cur[64], enc[8];
+    for (size_t i = 0; i < sizeof(cur); i++) cur[i] = (uint8_t)(lcg() | 1);
+    CHECK_EQ(bbdelta_encode(prev, sizeof(prev), cur, sizeof(cur), enc,
+                            sizeof(enc)), 0);
+  }
+
+  // Decode rejects malformed streams: literal token past the end, and
+  // output overflow
+  {
+    uint8_t prev[4] = {0};
+    uint8_t bad[2] = {0x85, 0x01};  // claims 6 literals, carries 1
+    uint8_t out[REC_MAX];
+    CHECK_EQ(bbdelta_decode(prev, sizeof(prev), bad, sizeof(bad), out,
+                            sizeof(out)), 0);
+    uint8_t runs[4] = {0x7F, 0x7F, 0x7F, 0x7F};  // 512 zeros into 86
+    CHECK_EQ(bbdelta_decode(NULL, 0, runs, sizeof(runs), out, sizeof(out)), 0);
+  }
+
+  // Random chain sweep: every record decodes against its true predecessor
+  {
+    uint8_t prev[REC_MAX], cur[REC_MAX];
+    size_t prev_len = 0;
+    for (int iter = 0; iter < 500; iter++) {
+      size_t cur_len = 1 + lcg() % REC_MAX;
+      memcpy(cur, prev, prev_len < cur_len ? prev_len : cur_len);
+      for (size_t i = prev_len; i < cur_len; i++) cur[i] = (uint8_t)lcg();
+      int edits = (int)(lcg() % 12);
+      for (int e = 0; e < edits; e++) cur[lcg() % cur_len] = (uint8_t)lcg();
+      roundtrip(prev_len ? prev : NULL, prev_len, cur, cur_len);
+      memcpy(prev, cur, cur_len);
+      prev_len = cur_len;
+    }
+  }
+
+  return test_summary("test_bbdelta");
+}
@@ -0,0 +1,77 @@
+// Q16.16 fixed-point arithmetic (common/FixPoint.h): exact identities,
+// rounding behavior, and — the part a spot check would miss — saturation
+// at every rail. Every op feeding the control path must rail instead of
+// wrapping, so the saturation cases are enumerated explicitly.
+
+#include <stdio.h>
+
+#include "FixPoint.h"
+#include "test_util.h"
+
+int main() {
+  // Conversions round-trip and round to nearest
+  CHECK_EQ(fix16_from_int(0), 0);
+  CHECK_EQ(fix16_from_int(1), FIX16_ONE);
+  CHECK_EQ(fix16_from_int(-3), -3 * FIX16_ONE);
+  CHECK_EQ(fix16_to_int(fix16_from_int(1234)), 1234);
+  CHECK_EQ(fix16_to_int(fix16_from_int(-1234)), -1234);
+  CHECK_EQ(fix16_to_int(FIX16_ONE / 2), 1);       // 0.5 rounds up
+  CHECK_EQ(fix16_to_int(FIX16_ONE / 2 - 1), 0);   // just under 0.5
+  CHECK_EQ(fix16_to_int(-FIX16_ONE / 4), 0);      // -0.25 rounds to 0
+
+  // Multiply: identities, fractions, signs
+  CHECK_EQ(fix16_mul(fix16_from_int(3), fix16_from_int(4)), fix16_from_int(12));
+  CHECK_EQ(fix16_mul(fix16_from_int(100), FIX16_ONE / 2), fix16_from_int(50));
+  CHECK_EQ(fix16_mul(fix16_from_int(-3), fix16_from_int(4)), fix16_from_int(-12));
+  CHECK_EQ(fix16_mul(fix16_from_int(-3), fix16_from_int(-4)), fix16_from_int(12));
+  CHECK_EQ(fix16_mul(0, FIX16_MAX), 0);
+
+  // Divide: identities and the zero-denominator rails
+  CHECK_EQ(fix16_div(fix16_from_int(12), fix16_from_int(4)), fix16_from_int(3));
+  CHECK_EQ(fix16_div(FIX16_ONE, fix16_from_int(4)), FIX16_ONE / 4);
+  CHECK_EQ(fix16_div(fix16_from_int(-12), fix16_from_int(4)), fix16_from_int(-3));
+  CHECK_EQ(fix16_div(FIX16_ONE, 0), FIX16_MAX);
+  CHECK_EQ(fix16_div(-FIX16_ONE, 0), FIX16_MIN);
+
+  // Saturation instead of wraparound on every op
+  CHECK_EQ(fix16_from_int(40000), FIX16_MAX);
+  CHECK_EQ(fix16_from_int(-40000), FIX16_MIN);
+  CHECK_EQ(fix16_mul(fix16_from_int(30000), fix16_from_int(30000)), FIX16_MAX);
+  CHECK_EQ(fix16_mul(fix16_from_int(-30000), fix16_from_int(30000)), FIX16_MIN);
+  CHECK_EQ(fix16_div(fix16_from_int(30000), FIX16_ONE / 16), FIX16_MAX);
+  CHECK_EQ(fix16_from_ratio(1, 0), FIX16_MAX);
+  CHECK_EQ(fix16_from_ratio(2000000000, 2), FIX16_MAX);
+
+  // from_ratio: the ADC-scaling use case, exact at both ends
+  CHECK_EQ(fix16_from_ratio(0, 4095), 0);
+  CHECK_EQ(fix16_from_ratio(4095, 4095), FIX16_ONE);
+  CHECK_EQ(fix16_from_ratio(1, 2), FIX16_ONE / 2);
+  CHECK(fix16_from_ratio(2048, 4095) > FIX16_ONE / 2 - 64);
+  CHECK(fix16_from_ratio(2048, 4095) < FIX16_ONE / 2 + 64);
+
+  // mul_int: LUT indexing — full pot lands exactly on the last entry,
+  // zero on the first, midpoint on the middle
+  CHECK_EQ(fix16_mul_int(FIX16_ONE, 255), 255);
+  CHECK_EQ(fix16_mul_int(0, 255), 0);
+  CHECK_EQ(fix16_mul_int(FIX16_ONE / 2, 256), 128);
+  CHECK_EQ(fix16_mul_int(-FIX16_ONE, 255), -255);
+
+  // lerp: endpoints, midpoint, and a descending pair
+  CHECK_EQ(fix16_lerp(fix16_from_int(10), fix16_from_int(20), 0), fix16_from_int(10));
+  CHECK_EQ(fix16_lerp(fix16_from_int(10), fix16_from_int(20), FIX16_ONE), fix16_from_int(20));
+  CHECK_EQ(fix16_lerp(fix16_from_int(10), fix16_from_int(20), FIX16_ONE / 2), fix16_from_int(15));
+  CHECK_EQ(fix16_lerp(fix16_from_int(20), fix16_from_int(10), FIX16_ONE / 2), fix16_from_int(15));
+  CHECK_EQ(fix16_lerp(FIX16_MIN, FIX16_MAX, FIX16_ONE / 2), -1);
+
+  // Monotonic: scaling a rising pot through mul_int never steps backwards
+  {
+    int prev = -1;
+    for (int32_t counts = 0; counts <= 4095; counts += 7) {
+      int idx = fix16_mul_int(fix16_from_ratio(counts, 4095), 255);
+      CHECK(idx >= prev && idx <= 255);
+      prev = idx;
+    }
+  }
+
+  return test_summary("test_fixpoint");
+}
@@ -0,0 +1,95 @@
+// Binary stats-harvest framing between a host tool and chamber-esp32
+
+#include <string.h>
+
+#include "HarvestProto.h"
+#include "test_util.h"
+
+int main() {
+  // Request roundtrip
+  {
+    uint8_t buf[HARVEST_REQ_SIZE];
+    harvest_req_encode(buf, HARVEST_CMD_LOG_PAGE, 0xBEEF);
+    uint8_t cmd;
+    uint16_t arg;
+    CHECK(harvest_req_decode(buf, &cmd, &arg));
+    CHECK_EQ(cmd, HARVEST_CMD_LOG_PAGE);
+    CHECK_EQ(arg, 0xBEEF);
+  }
+
+  // Corruption anywhere in the request fails the CRC (or the sync check)
+  {
+    uint8_t buf[HARVEST_REQ_SIZE];
+    uint8_t cmd;
+    uint16_t arg;
+    for (int i = 0; i < HARVEST_REQ_SIZE; i++) {
+      harvest_req_encode(buf, HARVEST_CMD_DOSE, 3);
+      buf[i] ^= 0x01;
+      CHECK(!harvest_req_decode(buf, &cmd, &arg));
+    }
+  }
+
+  // The request sync collides with neither lux sync — the chamber routes
+  // all three streams off the first byte
+  CHECK(HARVEST_REQ_SYNC != LUX_FRAME_SYNC);
+  CHECK(HARVEST_REQ_SYNC != LUX_BATCH_SYNC);
+  CHECK(HARVEST_RESP_SYNC != HARVEST_REQ_SYNC);
+
+  // Response roundtrip, payload intact
+  {
+    uint8_t frame[HARVEST_RESP_MAX];
+    const uint8_t payload[] = { 0x11, 0x22, 0x33, 0x44, 0x55 };
+    memcpy(frame + HARVEST_RESP_HDR_SIZE, payload, sizeof(payload));
+    int total = harvest_resp_finish(frame, HARVEST_CMD_BOUNDS,
+                                    sizeof(payload));
+    CHECK_EQ(total, HARVEST_RESP_HDR_SIZE + (int)sizeof(payload) + 1);
+
+    uint8_t cmd;
+    uint16_t len;
+    CHECK(harvest_resp_decode(frame, &cmd, &len));
+    CHECK_EQ(cmd, HARVEST_CMD_BOUNDS);
+    CHECK_EQ(len, sizeof(payload));
+    CHECK_EQ(memcmp(frame + HARVEST_RESP_HDR_SIZE, payload,
+                    sizeof(payload)), 0);
+  }
+
+  // Empty payload (unknown command / past-EOF log page) still frames
+  {
+    uint8_t frame[HARVEST_RESP_HDR_SIZE + 1];
+    int total = harvest_resp_finish(frame, 0x7F, 0);
+    CHECK_EQ(total, HARVEST_RESP_HDR_SIZE + 1);
+    uint8_t cmd;
+    uint16_t len;
+    CHECK(harvest_resp_decode(frame, &cmd, &len));
+    CHECK_EQ(cmd, 0x7F);
+    CHECK_EQ(len, 0);
+  }
+
+  // A flipped payload byte fails the response CRC
+  {
+    uint8_t frame[HARVEST_RESP_MAX];
+    frame[HARVEST_RESP_HDR_SIZE] = 0xAB;
+    harvest_resp_finish(frame, HARVEST_CMD_LATHIST, 1);
+    frame[HARVEST_RESP_HDR_SIZE] ^= 0x01;
+    uint8_t cmd;
+    uint16_t len;
+    CHECK(!harvest_resp_decode(frame, &cmd, &len));
+  }
+
+  // A full log page — the largest payload — fits the sizing macro
+  {
+    uint8_t frame[HARVEST_RESP_MAX];
+    for (int i = 0; i < HARVEST_LOG_PAGE_BYTES; i++) {
+      frame[HARVEST_RESP_HDR_SIZE + i] = (uint8_t)i;
+    }
+    int total = harvest_resp_finish(frame, HARVEST_CMD_LOG_PAGE,
+                                    HARVEST_LOG_PAGE_BYTES);
+    CHECK(total <= (int)sizeof(frame));
+    uint8_t cmd;
+    uint16_t len;
+    CHECK(harvest_resp_decode(frame, &cmd, &len));
+    CHECK_EQ(len, HARVEST_LOG_PAGE_BYTES);
+  }
+
+  return test_summary("harvest_proto");
+}
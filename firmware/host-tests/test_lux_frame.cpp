@@ -0,0 +1,89 @@
+// Wire protocol shared between module-esp32 and chamber-esp32
+
+#include "LuxFrame.h"
+#include "test_util.h"
+
+int main() {
+  // Single-frame roundtrip
+  {
+    uint8_t buf[LUX_FRAME_SIZE];
+    lux_frame_encode(buf, 42, 1234, 5678);
+    lux_sample_t s;
+    CHECK(lux_frame_decode(buf, &s));
+    CHECK_EQ(s.seq, 42);
+    CHECK_EQ(s.lux1_fp, 1234);
+    CHECK_EQ(s.lux2_fp, 5678);
+  }
+
+  // Corruption anywhere in the payload fails the CRC
+  {
+    uint8_t buf[LUX_FRAME_SIZE];
+    lux_sample_t s;
+    for (int i = 1; i < LUX_FRAME_SIZE; i++) {
+      lux_frame_encode(buf, 7, 100, 200);
+      buf[i] ^= 0x01;
+      CHECK(!lux_frame_decode(buf, &s));
+    }
+    // Bad sync byte is rejected before the CRC
+    lux_frame_encode(buf, 7, 100, 200);
+    buf[0] = 0x00;
+    CHECK(!lux_frame_decode(buf, &s));
+  }
+
+  // Fixed-point conversion: rounding, saturation, sentinel reservation
+  CHECK_EQ(lux_frame_to_fp(0.0f), 0);
+  CHECK_EQ(lux_frame_to_fp(-5.0f), 0);
+  CHECK_EQ(lux_frame_to_fp(1.0f), 16);
+  CHECK_EQ(lux_frame_to_fp(100.03f), 1600);  // 1600.48 rounds down
+  CHECK_EQ(lux_frame_to_fp(1e9f), 65534);    // saturates below the sentinel
+  CHECK(lux_frame_to_fp(1e9f) != LUX_FP_INVALID);
+
+  // Batch roundtrip at both count extremes
+  for (int count = 1; count <= LUX_BATCH_MAX_SAMPLES; count += LUX_BATCH_MAX_SAMPLES - 1) {
+    lux_batch_t in = {};
+    in.seq = 99;
+    in.count = (uint8_t)count;
+    for (int i = 0; i < count; i++) {
+      in.dt_ms[i] = (uint8_t)(i ? 10 : 0);
+      in.lux1_fp[i] = (uint16_t)(1000 + i);
+      in.lux2_fp[i] = (i == 2) ? LUX_FP_INVALID : (uint16_t)(2000 + i);
+    }
+    uint8_t buf[LUX_BATCH_FRAME_MAX];
+    int len = lux_batch_encode(buf, &in);
+    CHECK_EQ(len, LUX_BATCH_FRAME_SIZE(count));
+
+    lux_batch_t out;
+    CHECK(lux_batch_decode(buf, &out));
+    CHECK_EQ(out.seq, 99);
+    CHECK_EQ(out.count, count);
+    for (int i = 0; i < count; i++) {
+      CHECK_EQ(out.dt_ms[i], in.dt_ms[i]);
+      CHECK_EQ(out.lux1_fp[i], in.lux1_fp[i]);
+      CHECK_EQ(out.lux2_fp[i], in.lux2_fp[i]);
+    }
+
+    // Flip one payload byte: CRC must catch it
+    buf[LUX_BATCH_HDR_SIZE] ^= 0x80;
+    CHECK(!lux_batch_decode(buf, &out));
+  }
+
+  // Out-of-range counts are rejected on both sides
+  {
+    lux_batch_t b = {};
+    uint8_t buf[LUX_BATCH_FRAME_MAX];
+    b.count = 0;
+    CHECK_EQ(lux_batch_encode(buf, &b), 0);
+    b.count = LUX_BATCH_MAX_SAMPLES + 1;
+    CHECK_EQ(lux_batch_encode(buf, &b), 0);
+
+    b.count = 1;
+    b.seq = 1;
+    int len = lux_batch_encode(buf, &b);
+    CHECK(len > 0);
+    buf[2] = LUX_BATCH_MAX_SAMPLES + 1;
+    lux_batch_t out;
+    CHECK(!lux_batch_decode(buf, &out));
+  }
+
+  return test_summary("test_lux_frame");
+}
@@ -0,0 +1,70 @@
+// LuxStats hierarchical aggregates with a synthetic clock
+
+#include "LuxStats.h"
+#include "test_util.h"
+
+int main() {
+  // LuxAgg merge arithmetic
+  {
+    LuxAgg a, b;
+    a.reset();
+    b.reset();
+    CHECK_EQ(a.mean(), 0);
+    a.add(10);
+    a.add(20);
+    b.add(60);
+    a.merge(b);
+    CHECK_EQ(a.count, 3);
+    CHECK_EQ(a.mean(), 30);
+    CHECK_EQ(a.minV, 10);
+    CHECK_EQ(a.maxV, 60);
+
+    // Merging an empty bucket is a no-op
+    LuxAgg empty;
+    empty.reset();
+    a.merge(empty);
+    CHECK_EQ(a.count, 3);
+  }
+
+  // 10 samples/s for 130 s: value v at second s is s (constant within the
+  // second), so windowed means are exact and easy to predict
+  {
+    LuxStats stats;
+    unsigned long t = 1000000;  // Arbitrary epoch, not second-aligned history
+    for (int s = 0; s < 130; s++) {
+      for (int k = 0; k < 10; k++) {
+        stats.push(s, t);
+        t += 100;
+      }
+    }
+    // Buckets close lazily on the next push, so second 129 is still the
+    // open bucket: overSeconds(10) = open second + 10 closed (119..128)
+    LuxAgg last10 = stats.overSeconds(10);
+    CHECK_EQ(last10.count, 110);
+    CHECK_EQ(last10.minV, 119);
+    CHECK_EQ(last10.maxV, 129);
+    CHECK_EQ(last10.mean(), 124);  // (119+129)/2 exactly
+
+    // Last full minute: seconds 70..129 (60 closed + partial-minute bucket)
+    LuxAgg lastMin = stats.overMinutes(1);
+    CHECK(lastMin.count >= 600);
+    CHECK(lastMin.maxV == 129);
+
+    // Over an hour we see everything pushed so far
+    LuxAgg all = stats.overHours(1);
+    CHECK_EQ(all.count, 1300);
+    CHECK_EQ(all.minV, 0);
+    CHECK_EQ(all.maxV, 129);
+  }
+
+  // The open (partial) second participates in queries immediately
+  {
+    LuxStats stats;
+    stats.push(500, 10000);
+    LuxAgg now = stats.overSeconds(1);
+    CHECK_EQ(now.count, 1);
+    CHECK_EQ(now.mean(), 500);
+  }
+
+  return test_summary("test_lux_stats");
+}
@@ -0,0 +1,62 @@
+// Compile-time mixing matrix: row normalization, band placement, and the
+// flat-spectrum invariant the PWM engine relies on
+
+#include "MixMatrix.h"
+#include "test_util.h"
+
+// The chamber's strip configuration (mirrors LED_EMITTER_TABLE)
+static constexpr MixEmitter kLeds[4] = {
+  {450, 70}, {535, 60}, {645, 70}, {800, 140}
+};
+static constexpr MixMatrix<4, 13> kMix(kLeds, AS7343_BANDS);
+
+// The whole point: the table exists before main() ever runs
+static_assert(kMix.rowSum(0) == 4096, "row 0 must sum to full scale");
+static_assert(kMix.rowSum(3) == 4096, "row 3 must sum to full scale");
+
+int main() {
+  // Every row sums to exactly one full scale in Q12
+  for (size_t led = 0; led < 4; led++) {
+    CHECK_EQ(kMix.rowSum(led), 4096);
+  }
+
+  // CLEAR (column 12) carries no spectral shape and must mix into nothing
+  for (size_t led = 0; led < 4; led++) {
+    CHECK_EQ(kMix.w[led][12], 0);
+  }
+
+  // Each strip's heaviest weight sits on a band near its emitter peak:
+  // blue in F1..F3 (405-475), green in F4..FY (515-555), red in F6..F7
+  // (600-690), NIR in F8/NIR (745-855). Wire order: f1 f2 fz f3 f4 f5 fy
+  // f6 fxl f7 f8 nir clear.
+  size_t peakIdx[4];
+  for (size_t led = 0; led < 4; led++) {
+    size_t best = 0;
+    for (size_t s = 1; s < 13; s++) {
+      if (kMix.w[led][s] > kMix.w[led][best]) best = s;
+    }
+    peakIdx[led] = best;
+  }
+  CHECK(peakIdx[0] <= 3);                      // blue
+  CHECK(peakIdx[1] >= 4 && peakIdx[1] <= 6);   // green
+  CHECK(peakIdx[2] >= 7 && peakIdx[2] <= 9);   // red
+  CHECK(peakIdx[3] == 10 || peakIdx[3] == 11); // NIR
+
+  // A distant band never leaks into a strip: blue gets nothing from NIR
+  // and vice versa (the 2% sparsity clamp at work)
+  CHECK_EQ(kMix.w[0][11], 0);
+  CHECK_EQ(kMix.w[3][0], 0);
+
+  // Flat spectrum in, identical drive out on every strip — the same
+  // dot product setSpectralPWM computes
+  const uint16_t flat = 20000;
+  for (size_t led = 0; led < 4; led++) {
+    uint32_t acc = 0;
+    for (size_t s = 0; s < 13; s++) {
+      acc += (uint32_t)kMix.w[led][s] * flat;
+    }
+    CHECK_EQ(acc >> 12, flat);
+  }
+
+  return test_summary("test_mix_matrix");
+}
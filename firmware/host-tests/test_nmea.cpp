@@ -0,0 +1,50 @@
+// NMEA cursor and coordinate conversion (satellite gps path)
+
+#include <string.h>
+
+#include "nmea.h"
+#include "test_util.h"
+
+int main() {
+  // Field indexing strips the checksum and terminates fields in place
+  {
+    char s[] = "GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,,*6A";
+    nmea_cursor_t cur;
+    nmea_index(s, &cur);
+    CHECK_EQ(cur.count, 12);
+    CHECK(strcmp(nmea_field(&cur, 0), "GPRMC") == 0);
+    CHECK(strcmp(nmea_field(&cur, 2), "A") == 0);
+    CHECK(strcmp(nmea_field(&cur, 9), "230394") == 0);
+    // Out-of-range fields read as empty, never NULL
+    CHECK(nmea_field(&cur, 30)[0] == '\0');
+    CHECK(nmea_field(&cur, -1)[0] == '\0');
+
+    // 4807.038 N = 48 deg + 7.038 min = 48.1173 deg exactly in e7
+    CHECK_EQ(nmea_coord_to_e7(&cur, 3, 4), 481173000);
+    // 01131.000 E = 11 deg + 31 min = 11.5166667 deg (rounded /60)
+    CHECK_EQ(nmea_coord_to_e7(&cur, 5, 6), 115166667);
+  }
+
+  // Southern / western cardinals negate
+  {
+    char s[] = "GPGGA,1,3345.500,S,15112.000,W";
+    nmea_cursor_t cur;
+    nmea_index(s, &cur);
+    CHECK_EQ(nmea_coord_to_e7(&cur, 2, 3), -337583333);
+    CHECK_EQ(nmea_coord_to_e7(&cur, 4, 5), -1512000000);
+  }
+
+  // Empty coordinate field converts to 0 (no fix yet)
+  {
+    char s[] = "GPGGA,,,,";
+    nmea_cursor_t cur;
+    nmea_index(s, &cur);
+    CHECK_EQ(nmea_coord_to_e7(&cur, 1, 2), 0);
+  }
+
+  CHECK_EQ(nmea_2dig("230394", 0), 23);
+  CHECK_EQ(nmea_2dig("230394", 2), 3);
+  CHECK_EQ(nmea_2dig("230394", 4), 94);
+
+  return test_summary("test_nmea");
+}
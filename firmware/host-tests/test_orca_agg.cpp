@@ -0,0 +1,51 @@
+// Aggregation primitives behind the satellite report builder
+
+#include "orca_agg.h"
+#include "test_util.h"
+
+int main() {
+  // Averaging with the zero-count edge case
+  CHECK_EQ(orca_avg_u16(0, 0), 0);
+  CHECK_EQ(orca_avg_u16(100, 4), 25);
+  CHECK_EQ(orca_avg_u16(7, 2), 3);  // integer floor, as on target
+
+  // Median: odd and even counts, unsorted input
+  {
+    uint16_t w[] = { 5, 1, 9, 3, 7 };
+    CHECK_EQ(orca_robust_agg_u16(w, 5, 16, ORCA_AGG_MEDIAN), 5);
+  }
+  {
+    uint16_t w[] = { 4, 1, 3, 2 };
+    CHECK_EQ(orca_robust_agg_u16(w, 4, 16, ORCA_AGG_MEDIAN), 2);  // (2+3)/2
+  }
+
+  // A single spike does not move the median
+  {
+    uint16_t w[] = { 100, 100, 65535, 100, 100, 100, 100 };
+    CHECK_EQ(orca_robust_agg_u16(w, 7, 16, ORCA_AGG_MEDIAN), 100);
+  }
+
+  // Trimmed mean discards the top/bottom quarter
+  {
+    uint16_t w[] = { 0, 10, 10, 10, 10, 10, 10, 65535 };
+    CHECK_EQ(orca_robust_agg_u16(w, 8, 16, ORCA_AGG_TRIMMED), 10);
+  }
+
+  // Count beyond the window clamps to window_n (ring semantics)
+  {
+    uint16_t w[] = { 1, 2, 3, 4 };
+    CHECK_EQ(orca_robust_agg_u16(w, 1000, 4, ORCA_AGG_MEAN), 2);
+  }
+
+  CHECK_EQ(orca_robust_agg_u16(NULL, 0, 16, ORCA_AGG_MEDIAN), 0);
+
+  // isqrt: exact floor across the range the stddev path uses
+  CHECK_EQ(orca_isqrt_u64(0), 0);
+  CHECK_EQ(orca_isqrt_u64(1), 1);
+  CHECK_EQ(orca_isqrt_u64(15), 3);
+  CHECK_EQ(orca_isqrt_u64(16), 4);
+  CHECK_EQ(orca_isqrt_u64(1000000000000ULL), 1000000);
+  CHECK_EQ(orca_isqrt_u64(999999999999ULL), 999999);
+
+  return test_summary("test_orca_agg");
+}
@@ -0,0 +1,109 @@
+// 12-bit channel bit-packing behind the packed payload formats
+
+#include "orca_payload.h"
+#include "test_util.h"
+
+#include <string.h>
+
+static void roundtrip(const uint16_t in[ORCA_NUM_CHANNELS],
+                      uint16_t out[ORCA_NUM_CHANNELS], uint8_t* shift) {
+  uint8_t buf[ORCA_PACKED_CH_BYTES];
+  *shift = orca_channels_pack(in, buf);
+  orca_channels_unpack(buf, *shift, out);
+}
+
+int main() {
+  CHECK_EQ(ORCA_PACKED_CH_BYTES, 20);  // 13 x 12 bits rounded up
+
+  // Everything within 12 bits: shift 0, bit-exact round trip
+  {
+    uint16_t in[ORCA_NUM_CHANNELS], out[ORCA_NUM_CHANNELS];
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      in[i] = (uint16_t)(i * 315);  // 0..3780, all under 0x0FFF
+    }
+    uint8_t shift;
+    roundtrip(in, out, &shift);
+    CHECK_EQ(shift, 0);
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      CHECK_EQ(out[i], in[i]);
+    }
+  }
+
+  // Boundary values pack losslessly at shift 0
+  {
+    uint16_t in[ORCA_NUM_CHANNELS] = { 0 }, out[ORCA_NUM_CHANNELS];
+    in[0] = 0x0FFF;
+    in[ORCA_NUM_CHANNELS - 1] = 1;
+    uint8_t shift;
+    roundtrip(in, out, &shift);
+    CHECK_EQ(shift, 0);
+    CHECK_EQ(out[0], 0x0FFF);
+    CHECK_EQ(out[ORCA_NUM_CHANNELS - 1], 1);
+    CHECK_EQ(out[1], 0);
+  }
+
+  // One bright channel forces a shared shift; error stays within the
+  // rounding bound (1 << (shift - 1)) on every channel
+  {
+    uint16_t in[ORCA_NUM_CHANNELS], out[ORCA_NUM_CHANNELS];
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      in[i] = (uint16_t)(100 + i * 7);
+    }
+    in[ORCA_NUM_CHANNELS - 1] = 0x1000;  // just past 12 bits
+    uint8_t shift;
+    roundtrip(in, out, &shift);
+    CHECK_EQ(shift, 1);
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      int diff = (int)out[i] - (int)in[i];
+      CHECK(diff >= -1 && diff <= 1);
+    }
+  }
+
+  // Full-scale input: worst-case shift of 4; rounding carries past 12 bits
+  // and clamps, so reconstruction lands at 0xFFF << 4
+  {
+    uint16_t in[ORCA_NUM_CHANNELS], out[ORCA_NUM_CHANNELS];
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      in[i] = 65535;
+    }
+    uint8_t shift;
+    roundtrip(in, out, &shift);
+    CHECK_EQ(shift, 4);
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      CHECK_EQ(out[i], 65520);  // within the (1 << 4) quantization bound
+    }
+  }
+
+  // The 4 trailing pad bits transmit as zero so identical reports yield
+  // identical bytes (the dedup window depends on deterministic encoding)
+  {
+    uint16_t in[ORCA_NUM_CHANNELS];
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+      in[i] = 0x0FFF;
+    }
+    uint8_t buf[ORCA_PACKED_CH_BYTES];
+    memset(buf, 0xAA, sizeof(buf));
+    CHECK_EQ(orca_channels_pack(in, buf), 0);
+    CHECK_EQ(buf[ORCA_PACKED_CH_BYTES - 1] >> 4, 0);
+  }
+
+  // Random-ish sweep: round trip is exact whenever the max fits 12 bits
+  {
+    uint32_t seed = 0xC0FFEE;
+    for (int iter = 0; iter < 200; iter++) {
+      uint16_t in[ORCA_NUM_CHANNELS], out[ORCA_NUM_CHANNELS];
+      for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        in[i] = (uint16_t)(seed & 0x0FFF);
+      }
+      uint8_t shift;
+      roundtrip(in, out, &shift);
+      CHECK_EQ(shift, 0);
+      for (int i = 0; i < ORCA_NUM_CHANNELS; i++) {
+        CHECK_EQ(out[i], in[i]);
+      }
+    }
+  }
+
+  return test_summary("test_orca_pack");
+}
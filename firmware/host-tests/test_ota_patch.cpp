@@ -0,0 +1,154 @@
+// Delta patch format shared between the chamber OTA endpoint and the
+// shore-side packaging tool: encoder/applier round trip, streaming
+// behavior across arbitrary feed boundaries, and rejection of damaged or
+// mismatched patches.
+
+#include <string.h>
+#include <vector>
+
+#include "OtaPatch.h"
+#include "test_util.h"
+
+// Deterministic byte stream standing in for a firmware image
+static uint32_t lcg = 0x0c0ffee1;
+static uint8_t next_byte() {
+  lcg = lcg * 1664525u + 1013904223u;
+  return (uint8_t)(lcg >> 24);
+}
+
+struct ApplyBuffers {
+  const std::vector<uint8_t>* base;
+  std::vector<uint8_t> out;
+};
+
+static int readBase(void* ctx, uint32_t off, void* buf, size_t len) {
+  ApplyBuffers* b = (ApplyBuffers*)ctx;
+  if ((size_t)off + len > b->base->size()) return -1;
+  memcpy(buf, b->base->data() + off, len);
+  return 0;
+}
+
+static int writeOut(void* ctx, const void* buf, size_t len) {
+  ApplyBuffers* b = (ApplyBuffers*)ctx;
+  const uint8_t* p = (const uint8_t*)buf;
+  b->out.insert(b->out.end(), p, p + len);
+  return 0;
+}
+
+// Apply a patch in feed_size slices; returns the finish() code (feed
+// errors short-circuit into it)
+static int applyPatch(const std::vector<uint8_t>& base,
+                      const std::vector<uint8_t>& patch, size_t feed_size,
+                      std::vector<uint8_t>* result) {
+  ApplyBuffers bufs;
+  bufs.base = &base;
+  ota_patch_apply_t a;
+  ota_patch_apply_begin(&a, readBase, writeOut, &bufs);
+  for (size_t pos = 0; pos < patch.size(); pos += feed_size) {
+    size_t n = patch.size() - pos;
+    if (n > feed_size) n = feed_size;
+    int err = ota_patch_apply_feed(&a, patch.data() + pos, n);
+    if (err != 0) return err;
+  }
+  *result = bufs.out;
+  return ota_patch_apply_finish(&a);
+}
+
+int main() {
+  // Base "image" and a typical successor: mostly identical, with a
+  // changed region, an insertion and a trailing extension
+  std::vector<uint8_t> base(65536);
+  for (size_t i = 0; i < base.size(); i++) base[i] = next_byte();
+
+  std::vector<uint8_t> img = base;
+  for (size_t i = 20000; i < 20800; i++) img[i] ^= 0x5A;     // changed code
+  img.insert(img.begin() + 40000, 300, 0xEE);                 // inserted data
+  for (int i = 0; i < 512; i++) img.push_back(next_byte());   // appended tail
+
+  std::vector<uint32_t> table(1 << 12);
+  std::vector<uint8_t> patch(img.size() + 1024);
+  size_t plen = ota_patch_encode(base.data(), base.size(), img.data(),
+                                 img.size(), patch.data(), patch.size(),
+                                 table.data(), table.size());
+  CHECK(plen > OTA_PATCH_HEADER_SIZE);
+  patch.resize(plen);
+
+  // The whole point: a small change must not cost a full image
+  CHECK(plen < img.size() / 10);
+
+  // Round trip, including awkward feed granularities that split the
+  // header, op arguments and literal runs across calls
+  const size_t feeds[] = { 1, 7, 256, patch.size() };
+  for (size_t f = 0; f < sizeof(feeds) / sizeof(feeds[0]); f++) {
+    std::vector<uint8_t> out;
+    CHECK_EQ(applyPatch(base, patch, feeds[f], &out), 0);
+    CHECK(out == img);
+  }
+
+  // Header carries what the device-side base check needs
+  {
+    ota_patch_hdr_t hdr;
+    hdr.base_size = ota_patch_rd32(patch.data() + 4);
+    hdr.base_crc = ota_patch_rd32(patch.data() + 8);
+    hdr.new_size = ota_patch_rd32(patch.data() + 12);
+    hdr.new_crc = ota_patch_rd32(patch.data() + 16);
+    CHECK_EQ(hdr.base_size, base.size());
+    CHECK_EQ(hdr.base_crc, ota_patch_crc32(0, base.data(), base.size()));
+    CHECK_EQ(hdr.new_size, img.size());
+    CHECK_EQ(hdr.new_crc, ota_patch_crc32(0, img.data(), img.size()));
+  }
+
+  // A flipped literal byte survives parsing but dies on the final CRC
+  {
+    std::vector<uint8_t> bad = patch;
+    bad[bad.size() - 1] ^= 0x01;
+    std::vector<uint8_t> out;
+    CHECK_EQ(applyPatch(base, bad, 256, &out), OTA_PATCH_ERR_CRC);
+  }
+
+  // A truncated stream leaves the image incomplete
+  {
+    std::vector<uint8_t> cut(patch.begin(), patch.end() - 40);
+    std::vector<uint8_t> out;
+    CHECK_EQ(applyPatch(base, cut, 256, &out), OTA_PATCH_ERR_FORMAT);
+  }
+
+  // Wrong magic is rejected before anything else
+  {
+    std::vector<uint8_t> bad = patch;
+    bad[0] ^= 0xFF;
+    std::vector<uint8_t> out;
+    CHECK_EQ(applyPatch(base, bad, 256, &out), OTA_PATCH_ERR_MAGIC);
+  }
+
+  // A COPY reaching past the base image is a range error, not a read
+  {
+    std::vector<uint8_t> bad(OTA_PATCH_HEADER_SIZE + 9);
+    ota_patch_wr32(bad.data(), OTA_PATCH_MAGIC);
+    ota_patch_wr32(bad.data() + 4, 100);  // tiny claimed base
+    ota_patch_wr32(bad.data() + 8, 0);
+    ota_patch_wr32(bad.data() + 12, 200);
+    ota_patch_wr32(bad.data() + 16, 0);
+    bad[OTA_PATCH_HEADER_SIZE] = OTA_PATCH_OP_COPY;
+    ota_patch_wr32(bad.data() + OTA_PATCH_HEADER_SIZE + 1, 50);
+    ota_patch_wr32(bad.data() + OTA_PATCH_HEADER_SIZE + 5, 200);  // 50+200 > 100
+    std::vector<uint8_t> out;
+    CHECK_EQ(applyPatch(base, bad, 256, &out), OTA_PATCH_ERR_RANGE);
+  }
+
+  // Identical images compress to almost nothing
+  {
+    std::vector<uint8_t> same(img.size() + 1024);
+    size_t slen = ota_patch_encode(img.data(), img.size(), img.data(),
+                                   img.size(), same.data(), same.size(),
+                                   table.data(), table.size());
+    CHECK(slen > 0);
+    CHECK(slen < 64);
+    same.resize(slen);
+    std::vector<uint8_t> out;
+    CHECK_EQ(applyPatch(img, same, 256, &out), 0);
+    CHECK(out == img);
+  }
+
+  return test_summary("test_ota_patch");
+}
@@ -0,0 +1,58 @@
+// P2Quantile convergence against known distributions
+
+#include "P2Quantile.h"
+#include "test_util.h"
+
+static uint32_t lcg_state = 777;
+static uint32_t lcg() {
+  lcg_state = lcg_state * 1664525u + 1013904223u;
+  return lcg_state >> 16;
+}
+
+static float absf(float x) { return x < 0 ? -x : x; }
+
+int main() {
+  // Empty and seeding behavior
+  {
+    P2Quantile q(0.5f);
+    CHECK_EQ(q.count(), 0);
+    CHECK(q.value() == 0.0f);
+    q.add(3.0f);
+    q.add(1.0f);
+    q.add(2.0f);
+    // Before five samples the estimate is the median of what's been seen
+    CHECK(q.value() == 2.0f);
+  }
+
+  // Uniform stream on [0, 1000): estimates should land within a few percent
+  // of the exact order statistics (the header's stated accuracy)
+  {
+    P2Quantile p05(0.05f), p50(0.5f), p95(0.95f);
+    for (int i = 0; i < 20000; i++) {
+      float x = (float)(lcg() % 1000);
+      p05.add(x);
+      p50.add(x);
+      p95.add(x);
+    }
+    CHECK(absf(p05.value() - 50.0f) < 25.0f);
+    CHECK(absf(p50.value() - 500.0f) < 25.0f);
+    CHECK(absf(p95.value() - 950.0f) < 25.0f);
+  }
+
+  // Constant stream collapses to the constant
+  {
+    P2Quantile q(0.5f);
+    for (int i = 0; i < 100; i++) q.add(42.0f);
+    CHECK(q.value() == 42.0f);
+  }
+
+  // Step change: the estimate tracks toward the new level
+  {
+    P2Quantile q(0.5f);
+    for (int i = 0; i < 500; i++) q.add(100.0f);
+    for (int i = 0; i < 5000; i++) q.add(900.0f);
+    CHECK(q.value() > 500.0f);
+  }
+
+  return test_summary("test_p2_quantile");
+}
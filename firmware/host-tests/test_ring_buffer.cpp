@@ -0,0 +1,57 @@
+// RingBuffer: chronological indexing, wrap-around, raw slot invariant
+
+#include "RingBuffer.h"
+#include "test_util.h"
+
+int main() {
+  RingBuffer<int, 4> rb;
+  CHECK(rb.empty());
+  CHECK_EQ(rb.size(), 0);
+  CHECK_EQ(rb.capacity(), 4);
+
+  // Partial fill: index 0 is the first push
+  rb.push(10);
+  rb.push(20);
+  rb.push(30);
+  CHECK_EQ(rb.size(), 3);
+  CHECK(!rb.full());
+  CHECK_EQ(rb[0], 10);
+  CHECK_EQ(rb[2], 30);
+
+  // Fill and wrap: oldest elements fall off, order stays chronological
+  rb.push(40);
+  CHECK(rb.full());
+  rb.push(50);
+  rb.push(60);
+  CHECK_EQ(rb.size(), 4);
+  CHECK_EQ(rb[0], 30);
+  CHECK_EQ(rb[1], 40);
+  CHECK_EQ(rb[2], 50);
+  CHECK_EQ(rb[3], 60);
+
+  // Iterator walks the same chronological order
+  {
+    int expect[] = { 30, 40, 50, 60 };
+    int i = 0;
+    for (RingBuffer<int, 4>::const_iterator it = rb.begin(); it != rb.end(); ++it) {
+      CHECK_EQ(*it, expect[i++]);
+    }
+    CHECK_EQ(i, 4);
+  }
+
+  // Raw slot invariant: sample with sequence s lives in data()[s % N]
+  {
+    RingBuffer<int, 4> raw;
+    for (int s = 0; s < 11; s++) {
+      raw.push(100 + s);
+      CHECK_EQ(raw.data()[s % 4], 100 + s);
+    }
+  }
+
+  rb.clear();
+  CHECK(rb.empty());
+  rb.push(7);
+  CHECK_EQ(rb[0], 7);
+
+  return test_summary("test_ring_buffer");
+}
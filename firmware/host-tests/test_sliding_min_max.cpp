@@ -0,0 +1,60 @@
+// SlidingMinMax vs a brute-force window rescan
+
+#include "SlidingMinMax.h"
+#include "test_util.h"
+
+// Small deterministic PRNG so failures reproduce exactly
+static uint32_t lcg_state = 12345;
+static uint32_t lcg() {
+  lcg_state = lcg_state * 1664525u + 1013904223u;
+  return lcg_state >> 16;
+}
+
+int main() {
+  const int W = 16;
+  SlidingMinMax<W> smm;
+  int history[4000];
+
+  for (int i = 0; i < 4000; i++) {
+    int v = (int)(lcg() % 4096);
+    history[i] = v;
+    smm.push(v);
+
+    int lo = (i + 1 > W) ? i + 1 - W : 0;
+    int bmin = history[lo], bmax = history[lo];
+    for (int j = lo; j <= i; j++) {
+      if (history[j] < bmin) bmin = history[j];
+      if (history[j] > bmax) bmax = history[j];
+    }
+    if (smm.minValue() != bmin || smm.maxValue() != bmax) {
+      CHECK_EQ(smm.minValue(), bmin);
+      CHECK_EQ(smm.maxValue(), bmax);
+      break;  // One divergence is enough to diagnose
+    }
+  }
+  CHECK(smm.full());
+  CHECK_EQ(smm.size(), W);
+
+  // Monotonic ramps are the deques' worst/best cases — check both directions
+  {
+    SlidingMinMax<8> up;
+    for (int i = 0; i < 20; i++) up.push(i);
+    CHECK_EQ(up.minValue(), 12);
+    CHECK_EQ(up.maxValue(), 19);
+
+    SlidingMinMax<8> down;
+    for (int i = 20; i > 0; i--) down.push(i);
+    CHECK_EQ(down.minValue(), 1);
+    CHECK_EQ(down.maxValue(), 8);
+  }
+
+  // Constant input
+  {
+    SlidingMinMax<4> flat;
+    for (int i = 0; i < 10; i++) flat.push(5);
+    CHECK_EQ(flat.minValue(), 5);
+    CHECK_EQ(flat.maxValue(), 5);
+  }
+
+  return test_summary("test_sliding_min_max");
+}
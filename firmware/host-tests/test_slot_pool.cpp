@@ -0,0 +1,82 @@
+// Slot pool index hand-off: acquire/publish/take/release semantics
+
+#include "SlotPool.h"
+#include "test_util.h"
+
+struct Rec {
+  int value;
+};
+
+int main() {
+  // Fresh pool: every slot acquirable exactly once, all distinct, then dry
+  {
+    SlotPool<Rec, 4> pool;
+    CHECK_EQ(pool.capacity(), 4u);
+    int idx[4];
+    for (int i = 0; i < 4; i++) {
+      idx[i] = pool.acquire();
+      CHECK(idx[i] >= 0);
+      for (int j = 0; j < i; j++) {
+        CHECK(idx[i] != idx[j]);
+      }
+    }
+    CHECK_EQ(pool.acquire(), -1);
+  }
+
+  // publish/take preserves order; released slots become acquirable again
+  {
+    SlotPool<Rec, 4> pool;
+    for (int v = 0; v < 3; v++) {
+      int i = pool.acquire();
+      pool.at(i).value = v;
+      pool.publish(i);
+    }
+    for (int v = 0; v < 3; v++) {
+      int i = pool.take();
+      CHECK(i >= 0);
+      CHECK_EQ(pool.at(i).value, v);
+      pool.release(i);
+    }
+    CHECK_EQ(pool.take(), -1);
+    for (int i = 0; i < 4; i++) {
+      CHECK(pool.acquire() >= 0);
+    }
+    CHECK_EQ(pool.acquire(), -1);
+  }
+
+  // Sustained cycling far past the ring size: indices keep recycling, FIFO
+  // order holds across every wrap, and no slot is ever lost
+  {
+    SlotPool<Rec, 4> pool;
+    uint32_t seed = 0x51075001;
+    int in = 0, out = 0;
+    for (int iter = 0; iter < 2000; iter++) {
+      seed = seed * 1664525u + 1013904223u;
+      if (seed & 0x10000) {
+        int i = pool.acquire();
+        if (i >= 0) {
+          pool.at(i).value = in++;
+          pool.publish(i);
+        }
+      } else {
+        int i = pool.take();
+        if (i >= 0) {
+          CHECK_EQ(pool.at(i).value, out++);
+          pool.release(i);
+        }
+      }
+    }
+    int i;
+    while ((i = pool.take()) >= 0) {
+      CHECK_EQ(pool.at(i).value, out++);
+      pool.release(i);
+    }
+    CHECK_EQ(in, out);
+    for (int k = 0; k < 4; k++) {
+      CHECK(pool.acquire() >= 0);  // every slot made it back to the pool
+    }
+    CHECK_EQ(pool.acquire(), -1);
+  }
+
+  return test_summary("test_slot_pool");
+}
@@ -0,0 +1,86 @@
+// Predictive hold between LoRa reports (SpectralTrend)
+
+#include "SpectralTrend.h"
+#include "test_util.h"
+
+int main() {
+  SpectralTrend<3> t;
+  uint16_t out[3];
+
+  // No data, then one report: never a prediction — callers hold the snap
+  CHECK(!t.predict(0, out));
+  uint16_t a[3] = { 1000, 0, 65535 };
+  t.latch(a, 1000);
+  CHECK(!t.predict(1500, out));
+
+  // Two reports 10 s apart: exact at arrival, linear in between
+  uint16_t b[3] = { 2000, 100, 65535 };
+  t.latch(b, 11000);
+  CHECK(t.predict(11000, out));
+  CHECK_EQ(out[0], 2000);
+  CHECK_EQ(out[1], 100);
+  CHECK_EQ(out[2], 65535);
+  CHECK(t.predict(16000, out));  // Halfway to the expected next report
+  CHECK_EQ(out[0], 2500);
+  CHECK_EQ(out[1], 150);
+  CHECK_EQ(out[2], 65535);
+
+  // Extrapolation caps at one inter-report interval: the projected
+  // endpoint holds however long the link stays quiet
+  CHECK(t.predict(21000, out));
+  CHECK_EQ(out[0], 3000);
+  CHECK(t.predict(90000, out));
+  CHECK_EQ(out[0], 3000);
+  CHECK_EQ(out[1], 200);
+
+  // Falling trend clamps at zero instead of wrapping
+  {
+    SpectralTrend<3> d;
+    uint16_t hi[3] = { 300, 50, 0 };
+    uint16_t lo[3] = { 100, 10, 0 };
+    d.latch(hi, 0);
+    d.latch(lo, 1000);
+    CHECK(d.predict(2000, out));
+    CHECK_EQ(out[0], 0);   // 100 - 200 clamps
+    CHECK_EQ(out[1], 0);   // 10 - 40 clamps
+    CHECK_EQ(out[2], 0);
+  }
+
+  // Rising trend clamps at the 16-bit ceiling
+  {
+    SpectralTrend<3> r;
+    uint16_t lo[3] = { 30000, 0, 0 };
+    uint16_t hi[3] = { 60000, 0, 0 };
+    r.latch(lo, 0);
+    r.latch(hi, 1000);
+    CHECK(r.predict(2000, out));
+    CHECK_EQ(out[0], 65535);  // 60000 + 30000 clamps
+  }
+
+  // A fit across a dropout (gap beyond TREND_MAX_GAP_MS) is discarded:
+  // no prediction until two fresh points exist again
+  {
+    SpectralTrend<3> g;
+    uint16_t p[3] = { 500, 500, 500 };
+    uint16_t q[3] = { 900, 900, 900 };
+    g.latch(p, 0);
+    g.latch(q, TREND_MAX_GAP_MS + 1000);
+    CHECK(!g.predict(TREND_MAX_GAP_MS + 2000, out));
+    uint16_t r2[3] = { 1000, 1000, 1000 };
+    g.latch(r2, TREND_MAX_GAP_MS + 11000);
+    CHECK(g.predict(TREND_MAX_GAP_MS + 16000, out));
+    CHECK_EQ(out[0], 1050);
+  }
+
+  // Duplicate timestamp (batch frame decoded in one pass) is rejected
+  // rather than divided by
+  {
+    SpectralTrend<3> z;
+    uint16_t p[3] = { 1, 2, 3 };
+    z.latch(p, 5000);
+    z.latch(p, 5000);
+    CHECK(!z.predict(6000, out));
+  }
+
+  return test_summary("test_spectral_trend");
+}
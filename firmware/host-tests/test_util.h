@@ -0,0 +1,42 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+// Minimal host test harness: CHECK macros count failures, test_summary()
+// prints the verdict and returns the process exit code for ctest. No
+// framework dependency, so the suite builds anywhere a C++ compiler does.
+
+#include <stdio.h>
+
+static int g_checks = 0;
+static int g_failures = 0;
+
+#define CHECK(cond)                                                      \
+  do {                                                                   \
+    g_checks++;                                                          \
+    if (!(cond)) {                                                       \
+      g_failures++;                                                      \
+      fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+    }                                                                    \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                   \
+  do {                                                                   \
+    g_checks++;                                                          \
+    long long va = (long long)(a), vb = (long long)(b);                  \
+    if (va != vb) {                                                      \
+      g_failures++;                                                      \
+      fprintf(stderr, "FAIL %s:%d: %s == %s (%lld != %lld)\n",           \
+              __FILE__, __LINE__, #a, #b, va, vb);                       \
+    }                                                                    \
+  } while (0)
+
+static inline int test_summary(const char *name) {
+  if (g_failures == 0) {
+    printf("%s: %d checks passed\n", name, g_checks);
+    return 0;
+  }
+  fprintf(stderr, "%s: %d of %d checks FAILED\n", name, g_failures, g_checks);
+  return 1;
+}
+
+#endif
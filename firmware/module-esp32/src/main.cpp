@@ -1,5 +1,14 @@
 #include <Wire.h>
 #include "Adafruit_VEML7700.h"
+#include "LuxFrame.h"
+#if LUX_TRANSPORT_ESPNOW
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#endif
+#if LUX_TRANSPORT_RS485
+#include "driver/uart.h"
+#endif
 
 // VEML7700 I2C Sensor Pins
 #define SDA1 21
@@ -8,8 +17,67 @@
 #define SCL2 32
 
 // UART RS-485 Constants
-#define SAMPLE_MS = 20
-#define UART0_BAUD = 115200
+#define SAMPLE_MS 20
+#define UART0_BAUD 115200
+
+// ESP-NOW transport: 1 broadcasts the same binary frames over 2.4 GHz
+// instead of the UART (connectionless, ~1 ms over the air — no cable
+// through the deck penetration). The chamber must be built with its
+// matching LUX_TRANSPORT_ESPNOW=1, and ESPNOW_WIFI_CHANNEL must match the
+// chamber's WiFi channel (its web-status soft-AP channel, default 1).
+// Select with -DLUX_TRANSPORT_ESPNOW=1 in platformio.ini; error/memory
+// text lines stay on the UART either way so a bench serial cable still
+// tells the whole story.
+#ifndef LUX_TRANSPORT_ESPNOW
+#define LUX_TRANSPORT_ESPNOW 0
+#endif
+#define ESPNOW_WIFI_CHANNEL 1
+
+// RS-485 transport: 1 sends the same binary frames out UART1 through the
+// MAX3485 — the wired deck-to-lab run the hardware was built around.
+// Differential signaling over a twisted pair of the existing ethernet
+// cabling holds 50-100 Hz sample rates across 50 m where single-ended
+// UART already corrupts, so the baud is raised well past UART0's. The
+// UART peripheral drives DE/RE itself (half-duplex mode asserts RTS for
+// exactly the TX duration — no bit-banged turnaround). Select with
+// -DLUX_TRANSPORT_RS485=1 in platformio.ini; error/memory text lines stay
+// on UART0 either way.
+#ifndef LUX_TRANSPORT_RS485
+#define LUX_TRANSPORT_RS485 0
+#endif
+#define RS485_UART_NUM UART_NUM_1
+#define RS485_TX_PIN   17
+#define RS485_RX_PIN   16  // Unused by the protocol; the driver wants a pin
+#define RS485_DE_PIN   4   // MAX3485 DE+/RE tied together, via UART RTS
+#define RS485_BAUD     460800
+
+// Samples packed per UART frame. 1 streams a single-sample frame per tick
+// (lowest latency — the chamber control loop sees each sample immediately);
+// raising it toward LUX_BATCH_MAX_SAMPLES amortizes the sync/seq/CRC
+// overhead across the batch, which is what makes 100+ Hz sampling fit on
+// this wire, at the cost of up to (N-1) x SAMPLE_MS of added staleness for
+// the early samples in each batch.
+#ifndef LUX_BATCH_SAMPLES
+#define LUX_BATCH_SAMPLES 1
+#endif
+
+// ---------- Send-on-delta ----------
+// Static light carries no information, yet the stream used to spend fifty
+// frames a second saying "unchanged" all night. Sampling stays at full
+// rate; a frame goes on the wire only when either channel has moved past
+// a threshold since the last one sent, or the heartbeat expires. A real
+// change still leaves on the very next tick (~SAMPLE_MS reaction), the
+// sequence number advances per *transmitted* frame so suppression never
+// reads as drops at the receiver, and an online/offline flip always
+// transmits. The threshold is the larger of an absolute floor (sensor
+// noise at steady light) and a percentage of the last sent value, so
+// dawn ramps resolve finely without the noise floor chattering at noon.
+// Batch builds (LUX_BATCH_SAMPLES > 1) keep full-rate streaming: they
+// exist to maximize throughput, and the 8-bit per-sample offsets in the
+// batch frame cannot span a suppressed gap.
+#define DELTA_SEND_FP      8     // absolute floor: 0.5 lux in 1/16-lux steps
+#define DELTA_SEND_PCT     2     // relative: percent of the last sent value
+#define DELTA_HEARTBEAT_MS 1000  // stasis keepalive / receiver liveness bound
 
 // VEML7700 Setup
 Adafruit_VEML7700 veml1 = Adafruit_VEML7700();
@@ -17,26 +85,221 @@ Adafruit_VEML7700 veml2 = Adafruit_VEML7700();
 TwoWire I2C_1 = TwoWire(0);
 TwoWire I2C_2 = TwoWire(1);
 unsigned long lastSample = 0;
+uint8_t frameSeq = 0;
+
+// Heap/stack watermark report interval. The line shares the wire with the
+// binary frames, like the init-failure messages: the receiver resyncs on
+// the frame sync byte, so a rare text line costs one dropped frame at most.
+#define MEM_LOG_MS 60000
+unsigned long lastMemLog = 0;
+
+// ---------- Adaptive ranging ----------
+// A fixed gain 1 / 100 ms exposure saturates around 7.5k lux (the chamber
+// spec calls for 120k) and quantizes dawn light to a handful of counts.
+// Each sensor walks a sensitivity ladder instead: raw ALS counts near the
+// top of the ADC step the sensor down a rung for the next window, counts
+// near the bottom step it up, so the *next* reading is correctly exposed
+// and no blocking auto-range re-read cycle ever runs. Lux is computed here
+// from raw counts and the rung's resolution (one I2C register read per
+// sensor, same NOWAIT property as before), so every reading lands on a
+// common lux basis regardless of the rung that produced it.
+//
+// Rungs ordered least to most sensitive. Integration stays <= 100 ms so a
+// reading is never more than one sample-stream-age worth stale; resolution
+// is the datasheet's 0.0036 lx/ct at gain 2 / 800 ms scaled by each rung.
+struct RangeRung {
+  uint8_t gain;       // VEML7700_GAIN_*
+  uint8_t integration; // VEML7700_IT_*
+  uint16_t itMs;
+  float resolution;   // lux per count
+  bool lowGain;       // gain < 1: apply the high-lux correction polynomial
+};
+
+static const RangeRung RUNGS[] = {
+  { VEML7700_GAIN_1_8, VEML7700_IT_25MS,  25,  1.8432f, true  },  // ~120k lux full scale
+  { VEML7700_GAIN_1_8, VEML7700_IT_50MS,  50,  0.9216f, true  },
+  { VEML7700_GAIN_1_4, VEML7700_IT_50MS,  50,  0.4608f, true  },
+  { VEML7700_GAIN_1_4, VEML7700_IT_100MS, 100, 0.2304f, true  },
+  { VEML7700_GAIN_1,   VEML7700_IT_100MS, 100, 0.0576f, false },
+  { VEML7700_GAIN_2,   VEML7700_IT_100MS, 100, 0.0288f, false },  // dawn / moonlight
+};
+static const int NUM_RUNGS = sizeof(RUNGS) / sizeof(RUNGS[0]);
+static const int START_RUNG = 2;
+
+// Retune thresholds on raw counts (16-bit ADC): the ~100x span between
+// them gives wide hysteresis, so rung changes are rare at steady light
+static const uint16_t RAW_STEP_DOWN = 10000;  // brighter than this rung likes
+static const uint16_t RAW_STEP_UP = 100;      // too dark to resolve well
+
+// Per-sensor fault isolation: a failed begin() marks just that sensor
+// offline and schedules retries with exponential backoff; the stream
+// continues single-source (LUX_FP_INVALID in the dead slot) instead of
+// rebooting the whole sender over one transient I2C hiccup
+static const unsigned long RETRY_MIN_MS = 500;
+static const unsigned long RETRY_MAX_MS = 8000;
+
+struct AutoRanger {
+  Adafruit_VEML7700* veml;
+  TwoWire* bus;
+  const char* name;
+  int rung;
+  unsigned long settleUntilMs;  // readings before this mix old/new exposure
+  float lastLux;                // held through settling windows
+  bool online;
+  unsigned long nextRetryMs;
+  unsigned long backoffMs;
+};
+
+AutoRanger ranger1 = { &veml1, &I2C_1, "VEML7700-1", START_RUNG, 0, 0.0f,
+                       false, 0, RETRY_MIN_MS };
+AutoRanger ranger2 = { &veml2, &I2C_2, "VEML7700-2", START_RUNG, 0, 0.0f,
+                       false, 0, RETRY_MIN_MS };
+
+void rangerApply(AutoRanger& r, int rung) {
+  r.rung = rung;
+  r.veml->setGain(RUNGS[rung].gain);
+  r.veml->setIntegrationTime(RUNGS[rung].integration);
+  // The window in flight straddles the old and new settings; hold the last
+  // good lux until a full window under the new exposure has completed
+  r.settleUntilMs = millis() + 2UL * RUNGS[rung].itMs;
+}
+
+// True when a channel has moved enough since the last transmitted frame
+// to be worth a frame of its own
+static bool deltaExceeded(uint16_t sent, uint16_t cur) {
+  if (sent == cur) return false;
+  if (sent == LUX_FP_INVALID || cur == LUX_FP_INVALID) {
+    return true;  // online/offline transitions always transmit
+  }
+  uint16_t diff = (sent > cur) ? (uint16_t)(sent - cur) : (uint16_t)(cur - sent);
+  uint32_t thresh = ((uint32_t)sent * DELTA_SEND_PCT) / 100u;
+  if (thresh < DELTA_SEND_FP) thresh = DELTA_SEND_FP;
+  return diff >= thresh;
+}
+
+// Vishay's high-lux nonlinearity correction (app note), applied on the
+// low-gain rungs where readings above ~1k lux bend away from linear
+float rangerCorrect(float lux) {
+  return (((6.0135e-13f * lux - 9.3924e-9f) * lux + 8.1488e-5f) * lux + 1.0023f) * lux;
+}
+
+// (Re)initialize one sensor. Success resets the backoff and re-applies the
+// ranging rung; failure just pushes the next attempt out, doubling up to
+// the cap so a permanently dead bus costs one probe every few seconds.
+void rangerTryInit(AutoRanger& r) {
+  if (r.veml->begin(r.bus)) {
+    r.online = true;
+    r.backoffMs = RETRY_MIN_MS;
+    rangerApply(r, START_RUNG);
+    return;
+  }
+  r.online = false;
+  r.nextRetryMs = millis() + r.backoffMs;
+  Serial.printf("ERROR: %s init failed, retry in %lums\n", r.name, r.backoffMs);
+  r.backoffMs *= 2;
+  if (r.backoffMs > RETRY_MAX_MS) r.backoffMs = RETRY_MAX_MS;
+}
+
+// One register read, scale by the rung's resolution, then retune for the
+// next window if the counts sat near either end of the ADC
+float rangerRead(AutoRanger& r) {
+  uint16_t raw = r.veml->readALS();
+  bool settling = (long)(millis() - r.settleUntilMs) < 0;
+
+  if (!settling) {
+    float lux = raw * RUNGS[r.rung].resolution;
+    if (RUNGS[r.rung].lowGain) {
+      lux = rangerCorrect(lux);
+    }
+    r.lastLux = lux;
+
+    if (raw >= RAW_STEP_DOWN && r.rung > 0) {
+      rangerApply(r, r.rung - 1);
+    } else if (raw < RAW_STEP_UP && r.rung < NUM_RUNGS - 1) {
+      rangerApply(r, r.rung + 1);
+    }
+  }
+  return r.lastLux;
+}
+
+// ---------- Frame transport ----------
+#if LUX_TRANSPORT_ESPNOW
+static const uint8_t ESPNOW_BCAST[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static bool espnowReady = false;
+
+// Broadcast peer on a pinned channel: no pairing, no MAC provisioning —
+// every chamber in range decodes the stream, mirroring how the LoRa
+// downlink treats its audience
+void espnowInit() {
+  WiFi.mode(WIFI_STA);
+  esp_wifi_set_channel(ESPNOW_WIFI_CHANNEL, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("ERROR: ESP-NOW init failed, frames fall back to UART");
+    return;
+  }
+  esp_now_peer_info_t peer = {};
+  memcpy(peer.peer_addr, ESPNOW_BCAST, sizeof(peer.peer_addr));
+  peer.channel = ESPNOW_WIFI_CHANNEL;
+  peer.ifidx = WIFI_IF_STA;
+  if (esp_now_add_peer(&peer) != ESP_OK) {
+    Serial.println("ERROR: ESP-NOW peer add failed, frames fall back to UART");
+    return;
+  }
+  espnowReady = true;
+}
+#endif
+
+#if LUX_TRANSPORT_RS485
+static bool rs485Ready = false;
+
+// UART1 in hardware half-duplex RS-485 mode: the peripheral raises RTS
+// (wired to DE/RE) while the shifter is busy and drops it on the last
+// stop bit, so turnaround timing never depends on software
+void rs485Init() {
+  Serial1.begin(RS485_BAUD, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
+  if (uart_set_pin(RS485_UART_NUM, RS485_TX_PIN, RS485_RX_PIN,
+                   RS485_DE_PIN, UART_PIN_NO_CHANGE) != ESP_OK ||
+      uart_set_mode(RS485_UART_NUM, UART_MODE_RS485_HALF_DUPLEX) != ESP_OK) {
+    Serial.println("ERROR: RS-485 init failed, frames fall back to UART");
+    return;
+  }
+  rs485Ready = true;
+}
+#endif
+
+// One encoded frame out the selected transport. A failed bring-up
+// degrades to the UART rather than going dark.
+void txFrame(const uint8_t* frame, size_t len) {
+#if LUX_TRANSPORT_ESPNOW
+  if (espnowReady) {
+    esp_now_send(ESPNOW_BCAST, frame, len);
+    return;
+  }
+#endif
+#if LUX_TRANSPORT_RS485
+  if (rs485Ready) {
+    Serial1.write(frame, len);
+    return;
+  }
+#endif
+  Serial.write(frame, len);
+}
 
 void setup() {
   Serial.begin(UART0_BAUD);
+#if LUX_TRANSPORT_ESPNOW
+  espnowInit();
+#endif
+#if LUX_TRANSPORT_RS485
+  rs485Init();
+#endif
   
-  // Initialize sensors
+  // Initialize sensors; a failure degrades to single-source streaming
+  // with background retries rather than rebooting the sender
   I2C_1.begin(SDA1, SCL1);
-  if (!veml1.begin(&I2C_1)) {
-    Serial.println("ERROR: Failed to initialize VEML7700-1");
-    ESP.restart(); // Attempt to restart ESP32
-  }
-  veml1.setGain(VEML7700_GAIN_1);
-  veml1.setIntegrationTime(VEML7700_IT_100MS);
-  
+  rangerTryInit(ranger1);
   I2C_2.begin(SDA2, SCL2);
-  if (!veml2.begin(&I2C_2)) {
-    Serial.println("ERROR: Failed to initialize VEML7700-2");
-    ESP.restart(); // Attempt to restart ESP32
-  }
-  veml2.setGain(VEML7700_GAIN_1);
-  veml2.setIntegrationTime(VEML7700_IT_100MS);
+  rangerTryInit(ranger2);
   
   delay(1000);  // Give receiver time to start
   lastSample = millis();
@@ -48,9 +311,68 @@ void loop() {
   if (now - lastSample >= SAMPLE_MS) {
     lastSample = now;
     
-    // Read both sensors and send averaged lux intensity via UART
-    float lux1 = veml1.readLux();
-    float lux2 = veml2.readLux();
-    Serial.println((lux1 + lux2)/2.0, 2);
+    // Probe any offline sensor once its backoff expires; the healthy one
+    // keeps streaming throughout
+    if (!ranger1.online && (long)(now - ranger1.nextRetryMs) >= 0) rangerTryInit(ranger1);
+    if (!ranger2.online && (long)(now - ranger2.nextRetryMs) >= 0) rangerTryInit(ranger2);
+
+    // Collect both sensors without waiting. The VEML7700s integrate
+    // continuously and in parallel on their independent buses, so their
+    // windows always overlap; each read is one raw-count register fetch
+    // scaled through the sensor's current ranging rung, with the rung
+    // retuned for the next window when the counts run hot or cold. An
+    // offline sensor's slot carries the LUX_FP_INVALID sentinel.
+    uint16_t fp1 = ranger1.online ? lux_frame_to_fp(rangerRead(ranger1))
+                                  : (uint16_t)LUX_FP_INVALID;
+    uint16_t fp2 = ranger2.online ? lux_frame_to_fp(rangerRead(ranger2))
+                                  : (uint16_t)LUX_FP_INVALID;
+
+    // Send the binary sample frame via UART: sync + sequence + both raw
+    // lux values (fixed point) + CRC8. The receiver averages (or not) as
+    // it sees fit and can detect dropped or corrupt frames.
+
+#if LUX_BATCH_SAMPLES > 1
+    // Accumulate into the pending batch (with per-sample ms offsets) and
+    // flush one frame when full
+    static lux_batch_t batch = {};
+    static unsigned long prevSampleMs = 0;
+    unsigned long dt = (batch.count == 0) ? 0 : now - prevSampleMs;
+    prevSampleMs = now;
+    batch.dt_ms[batch.count] = (dt > 255) ? 255 : (uint8_t)dt;
+    batch.lux1_fp[batch.count] = fp1;
+    batch.lux2_fp[batch.count] = fp2;
+    batch.count++;
+    if (batch.count >= LUX_BATCH_SAMPLES) {
+      batch.seq = frameSeq++;
+      uint8_t frame[LUX_BATCH_FRAME_MAX];
+      int len = lux_batch_encode(frame, &batch);
+      if (len > 0) txFrame(frame, len);
+      batch.count = 0;
+    }
+#else
+    // Send-on-delta: transmit when either channel moved, or on heartbeat.
+    // The sentinels in the initial "last sent" state make the first valid
+    // reading count as a change, so the stream opens immediately.
+    static uint16_t sentFp1 = LUX_FP_INVALID, sentFp2 = LUX_FP_INVALID;
+    static unsigned long lastTxMs = 0;
+    if (deltaExceeded(sentFp1, fp1) || deltaExceeded(sentFp2, fp2) ||
+        now - lastTxMs >= DELTA_HEARTBEAT_MS) {
+      uint8_t frame[LUX_FRAME_SIZE];
+      lux_frame_encode(frame, frameSeq++, fp1, fp2);
+      txFrame(frame, LUX_FRAME_SIZE);
+      sentFp1 = fp1;
+      sentFp2 = fp2;
+      lastTxMs = now;
+    }
+#endif
+  }
+
+  // Periodic heap/stack watermarks: the sender runs for months, so a slow
+  // leak or an undersized loop stack should show in the logs, not a reboot
+  if (now - lastMemLog >= MEM_LOG_MS) {
+    lastMemLog = now;
+    Serial.printf("MEM: heap %u free %u min, loop stack HWM %u\n",
+                  (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMinFreeHeap(),
+                  (unsigned)uxTaskGetStackHighWaterMark(NULL));
   }
 }
\ No newline at end of file
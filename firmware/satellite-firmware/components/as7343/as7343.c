@@ -8,20 +8,32 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <driver/gpio.h>
+#include <esp_attr.h>
+#include <nvs.h>
 #include <esp_log.h>
 #include <esp_check.h>
+#include <esp_rom_sys.h>
+#include <esp_sleep.h>
 #include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
 
 static const char *TAG = "AS7343";
 
 /* ── Timing ───────────────────────────────────────────────────────────────── */
-#define AS7343_POWERUP_DELAY_MS     UINT16_C(200)
-#define AS7343_APPSTART_DELAY_MS    UINT16_C(200)
-#define AS7343_CMD_DELAY_MS         UINT16_C(5)
+#define AS7343_READY_TIMEOUT_MS     UINT16_C(250)  /* worst-case power-up poll  */
+#define AS7343_READY_POLL_MS        UINT16_C(2)
+#define AS7343_PON_DELAY_US         UINT16_C(300)  /* datasheet PON ramp ~200 µs */
 #define AS7343_DATA_READY_DELAY_MS  UINT16_C(1)
 #define AS7343_POLL_TIMEOUT_MS      UINT16_C(2000)
+
+/* Flicker capture: 60 ms spans ≥3 mains periods at 50 Hz; modulation above
+ * 150 ‰ of the mean flags the sample window as artificially lit. */
+#define AS7343_FLICKER_CAPTURE_MS   UINT16_C(60)
+#define AS7343_FLICKER_MAX_SAMPLES  UINT8_C(64)
+#define AS7343_FLICKER_THRESHOLD_PERMILLE UINT16_C(150)
 #define I2C_XFR_TIMEOUT_MS          (500)
 
 #define ESP_ARG_CHECK(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -31,6 +43,8 @@ static const char *TAG = "AS7343";
 #define AS7343_REG_ENABLE       UINT8_C(0x80)
 #define AS7343_REG_ATIME        UINT8_C(0x81)
 #define AS7343_REG_STATUS2      UINT8_C(0x90)
+#define AS7343_REG_STATUS       UINT8_C(0x93)   /* latched int flags, W1C     */
+#define AS7343_REG_INTENAB      UINT8_C(0xF9)   /* SP_IEN bit [3]             */
 #define AS7343_REG_DATA0        UINT8_C(0x95)   /* first of 18×2 data bytes  */
 #define AS7343_REG_CFG0         UINT8_C(0xBF)
 #define AS7343_REG_CFG1         UINT8_C(0xC6)
@@ -38,35 +52,16 @@ static const char *TAG = "AS7343";
 #define AS7343_REG_ASTEP_L      UINT8_C(0xD4)
 #define AS7343_REG_ASTEP_H      UINT8_C(0xD5)
 #define AS7343_REG_ID           UINT8_C(0x5A)   /* bank-1                     */
+#define AS7343_REG_FD_CFG0      UINT8_C(0xD7)   /* fifo_write_fd bit [7]      */
+#define AS7343_REG_FD_STATUS    UINT8_C(0xE3)   /* latched FD flags, W1C      */
+#define AS7343_REG_CONTROL      UINT8_C(0xFA)   /* fifo_clr bit [1]           */
+#define AS7343_REG_FIFO_LVL     UINT8_C(0xFC)
+#define AS7343_REG_FDATA_L      UINT8_C(0xFD)   /* reading pops the FIFO      */
 
 #define AS7343_PART_ID          UINT8_C(0x81)
 
-/*
- * auto_smux=3 channel order in DATA registers (from SparkFun library header):
- *   Cycle 1: FZ, FY, FXL, NIR, VIS1, FD1    → DATA_0  .. DATA_5
- *   Cycle 2: F2, F3, F4,  F6,  VIS2, FD2    → DATA_6  .. DATA_11
- *   Cycle 3: F1, F7, F8,  F5,  VIS3, FD3    → DATA_12 .. DATA_17
- *
- * Each DATA register is 2 bytes (little-endian), so 36 bytes total from 0x95.
- */
-#define CH_FZ    0
-#define CH_FY    1
-#define CH_FXL   2
-#define CH_NIR   3
-#define CH_VIS1  4
-/* CH_FD1 = 5 – skipped */
-#define CH_F2    6
-#define CH_F3    7
-#define CH_F4    8
-#define CH_F6    9
-#define CH_VIS2  10
-/* CH_FD2 = 11 – skipped */
-#define CH_F1    12
-#define CH_F7    13
-#define CH_F8    14
-#define CH_F5    15
-#define CH_VIS3  16
-/* CH_FD3 = 17 – skipped */
+/* The auto_smux=3 DATA-register channel order and the byte-level decode
+ * live in as7343_decode.h (pure logic, shared with the host harness). */
 
 /* ── Register bitfield unions ─────────────────────────────────────────────── */
 
@@ -127,12 +122,84 @@ typedef union __attribute__((packed)) {
     uint8_t reg;
 } as7343_status2_reg_t;
 
+/* ── RTC warm-init cache ──────────────────────────────────────────────────── *
+ * The AS7343 stays powered across ESP deep sleep, so its registers persist.
+ * Remembering the configuration applied last cycle lets a wake skip the
+ * full register setup and the first-integration settle delay.             */
+#define AS7343_RTC_MAGIC 0xA5734302UL  /* bumped: parked flag added */
+
+RTC_DATA_ATTR static struct {
+    uint32_t magic;
+    uint8_t  gain;
+    uint8_t  atime;
+    uint16_t astep;
+    uint8_t  smux;
+    uint8_t  parked;  /* as7343_sleep() ran; next init takes the fast-wake path */
+} s_warm_cfg;
+
+/* ── Dark-offset calibration ──────────────────────────────────────────────── *
+ * Per-channel dark current measured with the lens capped. Applied in
+ * as7343_get_spectral_data() so accumulation and averaging downstream see
+ * corrected counts — subtracting on shore after avg_u16() truncation would
+ * bake the error in. Persisted in NVS; the RTC copy avoids an NVS read on
+ * every deep-sleep wake. Offset channel order matches as7343_channels_t. */
+#define AS7343_NVS_NAMESPACE  "as7343"
+#define AS7343_NVS_DARK_KEY   "dark_cal"
+#define AS7343_DARK_CAL_READS 8
+
+typedef struct {
+    uint8_t  gain;     /* as7343_gain_t at capture — offsets rescale with AGC */
+    uint8_t  atime;    /* integration config at capture — mismatch invalidates */
+    uint16_t astep;
+    uint16_t off[13];
+} as7343_dark_cal_t;
+
+_Static_assert(sizeof(as7343_channels_t) == 13 * sizeof(uint16_t),
+               "as7343_channels_t must be a plain array of 13 counts");
+
+RTC_DATA_ATTR static struct {
+    uint32_t          magic;
+    as7343_dark_cal_t cal;
+} s_dark_rtc;
+
 /* ── Device struct ────────────────────────────────────────────────────────── */
 typedef struct {
     i2c_master_dev_handle_t i2c_handle;
     as7343_config_t         config;
+    SemaphoreHandle_t       drdy_sem;   /* given from INT-pin ISR; NULL = polling */
+    as7343_dark_cal_t       dark;       /* valid only when dark_valid is set */
+    bool                    dark_valid;
+    bool                    static_ctx; /* lives in s_static_ctx, never free()d */
 } as7343_device_t;
 
+/* Internal static context for as7343_init_static(): the satellite carries
+ * exactly one sensor and re-inits it on every deep-sleep wake, so the
+ * hottest path in the system should not run the allocator at all. One
+ * context is enough; a second static init without a delete is refused. */
+static as7343_device_t s_static_ctx;
+static bool            s_static_in_use = false;
+
+/* Integration cycles per reading for the configured auto-SMUX mode */
+static inline uint32_t as7343_smux_cycles(const as7343_device_t *dev)
+{
+    return (dev->config.smux_mode == AS7343_SMUX_18CH) ? 3 : 1;
+}
+
+/* Wait out an integration period. With light_sleep_wait set the CPU light-
+ * sleeps on a timer wake instead of spinning a full-clock FreeRTOS delay —
+ * tens of milliseconds at sleep current on every sensor-only wake. Falls
+ * back to vTaskDelay if light sleep is refused. */
+static void as7343_integration_delay(const as7343_device_t *dev, uint32_t delay_ms)
+{
+    if (dev->config.light_sleep_wait) {
+        esp_sleep_enable_timer_wakeup((uint64_t)delay_ms * 1000ULL);
+        if (esp_light_sleep_start() == ESP_OK) {
+            return;
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+}
+
 /* ════════════════════════════════════════════════════════════════════════════
  * I²C HAL
  * ════════════════════════════════════════════════════════════════════════════ */
@@ -147,6 +214,23 @@ static inline esp_err_t as7343_i2c_write_byte(as7343_device_t *dev,
     return ESP_OK;
 }
 
+/* Multi-byte write: the register address auto-increments, so runs of
+ * contiguous registers go out in a single transaction instead of one
+ * START/addr/STOP per byte. */
+static inline esp_err_t as7343_i2c_write_bytes(as7343_device_t *dev,
+                                                uint8_t reg,
+                                                const uint8_t *vals, size_t len)
+{
+    uint8_t tx[8];
+    if (len + 1 > sizeof(tx)) return ESP_ERR_INVALID_ARG;
+    tx[0] = reg;
+    memcpy(&tx[1], vals, len);
+    ESP_RETURN_ON_ERROR(
+        i2c_master_transmit(dev->i2c_handle, tx, len + 1, I2C_XFR_TIMEOUT_MS),
+        TAG, "i2c write %u bytes at 0x%02X failed", (unsigned)len, reg);
+    return ESP_OK;
+}
+
 static inline esp_err_t as7343_i2c_read_bytes(as7343_device_t *dev,
                                                uint8_t reg,
                                                uint8_t *buf, size_t len)
@@ -178,9 +262,114 @@ static inline esp_err_t as7343_set_bank(as7343_device_t *dev, uint8_t bank)
     return ESP_OK;
 }
 
+/* ── Data-ready wait ──────────────────────────────────────────────────────── */
+
+/* INT pin ISR: the sensor pulls INT low when SP_IEN fires at measurement
+ * completion. Just release the waiting task. */
+static void IRAM_ATTR as7343_drdy_isr(void *arg)
+{
+    as7343_device_t *dev = (as7343_device_t *)arg;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(dev->drdy_sem, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/* Wire up the INT pin and enable the spectral interrupt (SP_IEN).
+ * Non-fatal on failure — the driver silently stays on the polling path. */
+static void as7343_setup_drdy_irq(as7343_device_t *dev)
+{
+    if (dev->config.int_gpio < 0) {
+        return;
+    }
+
+    dev->drdy_sem = xSemaphoreCreateBinary();
+    if (dev->drdy_sem == NULL) {
+        return;
+    }
+
+    gpio_config_t io = {
+        .pin_bit_mask = (1ULL << dev->config.int_gpio),
+        .mode         = GPIO_MODE_INPUT,
+        .pull_up_en   = GPIO_PULLUP_ENABLE,    /* INT is open-drain active-low */
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type    = GPIO_INTR_NEGEDGE,
+    };
+    gpio_config(&io);
+
+    /* May already be installed by another driver — both outcomes are fine */
+    esp_err_t ret = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        vSemaphoreDelete(dev->drdy_sem);
+        dev->drdy_sem = NULL;
+        return;
+    }
+    gpio_isr_handler_add((gpio_num_t)dev->config.int_gpio,
+                         as7343_drdy_isr, dev);
+
+    /* SP_IEN: assert INT on spectral measurement completion */
+    if (as7343_i2c_write_byte(dev, AS7343_REG_INTENAB, 1u << 3) != ESP_OK) {
+        ESP_LOGW(TAG, "INTENAB write failed — falling back to STATUS2 polling");
+        gpio_isr_handler_remove((gpio_num_t)dev->config.int_gpio);
+        vSemaphoreDelete(dev->drdy_sem);
+        dev->drdy_sem = NULL;
+        return;
+    }
+    ESP_LOGI(TAG, "Data-ready interrupt armed on GPIO%d", dev->config.int_gpio);
+}
+
 /* ── Poll AVALID ──────────────────────────────────────────────────────────── */
 static esp_err_t as7343_wait_avalid(as7343_device_t *dev)
 {
+    /* Interrupt path: block on the ISR semaphore so the idle task (and
+     * tickless light sleep, when enabled) owns the CPU for the ~50 ms
+     * integration instead of a 1 ms poll loop. Falls through to polling
+     * on timeout in case the INT line is miswired. */
+    if (dev->drdy_sem != NULL) {
+        /* Clear any stale latched flags so the next edge is the real one */
+        as7343_i2c_write_byte(dev, AS7343_REG_STATUS, 0xFF);
+
+        if (dev->config.light_sleep_wait) {
+            /* Light-sleep until INT falls. Level-triggered wake, so an
+             * assertion during the register write above cannot be missed;
+             * the timer wake bounds a miswired INT line. The negedge ISR
+             * does not run during light sleep, so check AVALID directly
+             * on resume instead of relying on the semaphore. */
+            gpio_wakeup_enable((gpio_num_t)dev->config.int_gpio,
+                               GPIO_INTR_LOW_LEVEL);
+            esp_sleep_enable_gpio_wakeup();
+            esp_sleep_enable_timer_wakeup(
+                (uint64_t)AS7343_POLL_TIMEOUT_MS * 1000ULL);
+            esp_err_t slept = esp_light_sleep_start();
+            gpio_wakeup_disable((gpio_num_t)dev->config.int_gpio);
+            if (slept == ESP_OK) {
+                as7343_status2_reg_t s2 = { .reg = 0 };
+                ESP_RETURN_ON_ERROR(
+                    as7343_i2c_read_byte(dev, AS7343_REG_STATUS2, &s2.reg),
+                    TAG, "read STATUS2 failed");
+                if (s2.bits.avalid)
+                    return ESP_OK;
+            }
+            /* Inconclusive — fall through to the semaphore/polling path */
+        }
+
+        if (xSemaphoreTake(dev->drdy_sem,
+                           pdMS_TO_TICKS(AS7343_POLL_TIMEOUT_MS)) == pdTRUE) {
+            as7343_status2_reg_t s2 = { .reg = 0 };
+            ESP_RETURN_ON_ERROR(
+                as7343_i2c_read_byte(dev, AS7343_REG_STATUS2, &s2.reg),
+                TAG, "read STATUS2 failed");
+            if (s2.bits.asat_analog || s2.bits.asat_digital)
+                ESP_LOGW(TAG, "Saturation (STATUS2=0x%02X) – "
+                              "reduce gain or integration time", s2.reg);
+            if (s2.bits.avalid)
+                return ESP_OK;
+            /* Spurious edge — fall back to polling for the remainder */
+        }
+        ESP_LOGW(TAG, "INT wait inconclusive — polling STATUS2");
+    }
+
     const uint64_t t0 = esp_timer_get_time();
     while (true) {
         as7343_status2_reg_t s2 = { .reg = 0 };
@@ -201,20 +390,172 @@ static esp_err_t as7343_wait_avalid(as7343_device_t *dev)
     }
 }
 
+/* ── Power-up readiness poll ──────────────────────────────────────────────── *
+ * Replace the old fixed 200 ms power-up sleep: the part typically answers
+ * I²C within a few ms, so poll a bank-0 register with short backoff and
+ * stop the moment it responds.                                            */
+static esp_err_t as7343_wait_ready(as7343_device_t *dev)
+{
+    const uint64_t t0 = esp_timer_get_time();
+    while (true) {
+        uint8_t v = 0;
+        if (i2c_master_transmit_receive(dev->i2c_handle,
+                                        (uint8_t[]){ AS7343_REG_ENABLE }, 1,
+                                        &v, 1, I2C_XFR_TIMEOUT_MS) == ESP_OK) {
+            return ESP_OK;
+        }
+        if (ESP_TIMEOUT_CHECK(t0, (uint64_t)AS7343_READY_TIMEOUT_MS * 1000)) {
+            ESP_LOGE(TAG, "Sensor not responding after %u ms",
+                     AS7343_READY_TIMEOUT_MS);
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(AS7343_READY_POLL_MS));
+    }
+}
+
+/* ── Warm-init check ──────────────────────────────────────────────────────── *
+ * True when the RTC cache says this exact configuration was applied last
+ * cycle and the sensor still reports PON + SP_EN — registers survived, so
+ * the full setup sequence (and its settle delay) can be skipped.          */
+static bool as7343_warm_cfg_matches(const as7343_device_t *dev)
+{
+    return s_warm_cfg.magic == AS7343_RTC_MAGIC &&
+           s_warm_cfg.gain  == (uint8_t)dev->config.gain &&
+           s_warm_cfg.atime == dev->config.atime &&
+           s_warm_cfg.astep == dev->config.astep &&
+           s_warm_cfg.smux  == (uint8_t)dev->config.smux_mode;
+}
+
+static bool as7343_warm_init_valid(as7343_device_t *dev)
+{
+    if (!as7343_warm_cfg_matches(dev) || s_warm_cfg.parked) {
+        return false;
+    }
+
+    as7343_enable_reg_t en = { .reg = 0 };
+    if (as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg) != ESP_OK) {
+        return false;
+    }
+    return en.bits.power_on && en.bits.spectral_enabled;
+}
+
+static void as7343_warm_cfg_store(const as7343_device_t *dev)
+{
+    s_warm_cfg.gain   = (uint8_t)dev->config.gain;
+    s_warm_cfg.atime  = dev->config.atime;
+    s_warm_cfg.astep  = dev->config.astep;
+    s_warm_cfg.smux   = (uint8_t)dev->config.smux_mode;
+    s_warm_cfg.parked = 0;
+    s_warm_cfg.magic  = AS7343_RTC_MAGIC;
+}
+
+/* ── Parked fast-wake ─────────────────────────────────────────────────────── *
+ * Counterpart of as7343_sleep(): the RTC cache says the sensor was parked
+ * (SP_EN off, CFG0 low_power set) with this exact configuration and still
+ * reports PON, so all other registers are intact. Clearing low_power and
+ * re-enabling the spectral engine is enough — the ID check, ATIME/CFG1/
+ * ASTEP/CFG20 writes and their verification are all skipped. The first
+ * measurement still needs a full integration pass, which the existing
+ * AVALID poll in get_spectral_data absorbs.                                */
+static bool as7343_parked_init_valid(as7343_device_t *dev)
+{
+    if (!as7343_warm_cfg_matches(dev) || !s_warm_cfg.parked) {
+        return false;
+    }
+
+    as7343_enable_reg_t en = { .reg = 0 };
+    if (as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg) != ESP_OK) {
+        return false;
+    }
+    return en.bits.power_on && !en.bits.spectral_enabled;
+}
+
+static esp_err_t as7343_unpark(as7343_device_t *dev)
+{
+    as7343_cfg0_reg_t cfg0 = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_CFG0, &cfg0.reg),
+                        TAG, "read CFG0 failed");
+    cfg0.bits.low_power = false;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CFG0, cfg0.reg),
+                        TAG, "clear low_power failed");
+
+    as7343_enable_reg_t en = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg),
+                        TAG, "read ENABLE failed");
+    en.bits.spectral_enabled = true;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write SP_EN=1 failed");
+
+    s_warm_cfg.parked = 0;
+    return ESP_OK;
+}
+
+/* ── Dark-offset helpers ──────────────────────────────────────────────────── */
+
+/* Populate dev->dark from the RTC copy, falling back to NVS on cold boot.
+ * A calibration captured at a different integration time is ignored. */
+static void as7343_dark_cal_load(as7343_device_t *dev)
+{
+    if (s_dark_rtc.magic != AS7343_RTC_MAGIC) {
+        nvs_handle_t nvs;
+        if (nvs_open(AS7343_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+            return;
+        }
+        size_t len = sizeof(s_dark_rtc.cal);
+        esp_err_t err = nvs_get_blob(nvs, AS7343_NVS_DARK_KEY,
+                                     &s_dark_rtc.cal, &len);
+        nvs_close(nvs);
+        if (err != ESP_OK || len != sizeof(s_dark_rtc.cal)) {
+            return;
+        }
+        s_dark_rtc.magic = AS7343_RTC_MAGIC;
+    }
+
+    if (s_dark_rtc.cal.atime != dev->config.atime ||
+        s_dark_rtc.cal.astep != dev->config.astep) {
+        ESP_LOGW(TAG, "Dark calibration ignored: integration time changed "
+                      "since capture — recalibrate");
+        return;
+    }
+    dev->dark = s_dark_rtc.cal;
+    dev->dark_valid = true;
+}
+
+/* Subtract the dark offsets in place, floored at zero. Offsets were
+ * captured at dark.gain and dark counts scale ~2x per gain step, so shift
+ * by the AGC gain delta before subtracting. */
+static void as7343_dark_cal_apply(const as7343_device_t *dev,
+                                  as7343_channels_t *channels)
+{
+    if (!dev->dark_valid) {
+        return;
+    }
+    int shift = (int)dev->config.gain - (int)dev->dark.gain;
+    uint16_t *ch = (uint16_t *)channels;
+    for (int i = 0; i < 13; i++) {
+        uint32_t off = (shift >= 0) ? ((uint32_t)dev->dark.off[i] << shift)
+                                    : ((uint32_t)dev->dark.off[i] >> -shift);
+        ch[i] = ((uint32_t)ch[i] > off) ? (uint16_t)(ch[i] - off) : 0;
+    }
+}
+
 /* ════════════════════════════════════════════════════════════════════════════
  * Register setup
  * ════════════════════════════════════════════════════════════════════════════ */
 static esp_err_t as7343_setup_registers(as7343_device_t *dev)
 {
+    const uint64_t t_setup = esp_timer_get_time();
+
     /* 1. Ensure bank-0 */
     ESP_RETURN_ON_ERROR(as7343_set_bank(dev, 0), TAG, "set bank0 failed");
 
-    /* 2. PON=1 */
+    /* 2. PON=1 — the oscillator ramp is ~200 µs (datasheet), so a short
+     *    busy-wait beats a FreeRTOS tick-granular delay here */
     as7343_enable_reg_t en = { .reg = 0 };
     en.bits.power_on = true;
     ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
                         TAG, "write PON failed");
-    vTaskDelay(pdMS_TO_TICKS(AS7343_CMD_DELAY_MS));
+    esp_rom_delay_us(AS7343_PON_DELAY_US);
 
     /* 3. Verify part ID (bank-1) */
     ESP_RETURN_ON_ERROR(as7343_set_bank(dev, 1), TAG, "set bank1 for ID failed");
@@ -234,15 +575,7 @@ static esp_err_t as7343_setup_registers(as7343_device_t *dev)
                                                dev->config.atime),
                         TAG, "write ATIME failed");
 
-    /* 5. ASTEP (LSB first) */
-    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ASTEP_L,
-                                               (uint8_t)(dev->config.astep & 0xFF)),
-                        TAG, "write ASTEP_L failed");
-    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ASTEP_H,
-                                               (uint8_t)(dev->config.astep >> 8)),
-                        TAG, "write ASTEP_H failed");
-
-    /* 6. Gain */
+    /* 5. Gain */
     as7343_cfg1_reg_t cfg1 = { .reg = 0 };
     ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_CFG1, &cfg1.reg),
                         TAG, "read CFG1 failed");
@@ -250,14 +583,22 @@ static esp_err_t as7343_setup_registers(as7343_device_t *dev)
     ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CFG1, cfg1.reg),
                         TAG, "write CFG1 failed");
 
-    /* 7. auto_smux = 3 → 18-channel mode
-     *    Must be set before SP_EN=1 and must not change during measurement */
+    /* 6. ASTEP + auto_smux. ASTEP_L/ASTEP_H/CFG20 are contiguous
+     *    (0xD4..0xD6) so all three go out in one auto-increment write.
+     *    auto_smux must be set before SP_EN=1 and must not change during
+     *    measurement. */
     as7343_cfg20_reg_t cfg20 = { .reg = 0 };
     ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_CFG20, &cfg20.reg),
                         TAG, "read CFG20 failed");
-    cfg20.bits.auto_smux = 3;
-    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CFG20, cfg20.reg),
-                        TAG, "write CFG20 auto_smux=3 failed");
+    cfg20.bits.auto_smux = (uint8_t)dev->config.smux_mode;
+    uint8_t astep_smux[3] = {
+        (uint8_t)(dev->config.astep & 0xFF),
+        (uint8_t)(dev->config.astep >> 8),
+        cfg20.reg,
+    };
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_bytes(dev, AS7343_REG_ASTEP_L,
+                                                astep_smux, sizeof(astep_smux)),
+                        TAG, "write ASTEP/CFG20 failed");
 
     /* Verify CFG20 was written correctly */
     uint8_t cfg20_verify = 0;
@@ -265,9 +606,9 @@ static esp_err_t as7343_setup_registers(as7343_device_t *dev)
     ESP_LOGI(TAG, "CFG20 written=0x%02X readback=0x%02X (auto_smux bits=%d)",
              cfg20.reg, cfg20_verify, (cfg20_verify >> 5) & 0x3);
 
-    /* 8. SP_EN=1 — leave spectral measurement running continuously,
+    /* 7. SP_EN=1 — leave spectral measurement running continuously,
      *    exactly as the SparkFun library does.
-     *    Delay afterwards to let the first full 3-cycle auto_smux pass complete
+     *    Delay afterwards to let the first full auto_smux pass complete
      *    before any read is attempted. */
     ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg),
                         TAG, "read ENABLE for SP_EN failed");
@@ -275,14 +616,17 @@ static esp_err_t as7343_setup_registers(as7343_device_t *dev)
     ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
                         TAG, "write SP_EN=1 failed");
 
-    /* Wait for first complete measurement cycle (3 × t_int + margin) */
+    /* Wait for first complete measurement (cycles × t_int + margin) */
     uint32_t t_int_us = (uint32_t)(dev->config.atime + 1) *
                         (uint32_t)(dev->config.astep + 1) * 278 / 100; /* ×2.78 µs */
-    uint32_t t_int_ms = (t_int_us * 3) / 1000 + 50;
-    vTaskDelay(pdMS_TO_TICKS(t_int_ms));
+    uint32_t t_int_ms = (t_int_us * as7343_smux_cycles(dev)) / 1000 + 50;
+    as7343_integration_delay(dev, t_int_ms);
 
-    ESP_LOGI(TAG, "Setup complete: gain=%d atime=%u astep=%u auto_smux=3",
-             dev->config.gain, dev->config.atime, dev->config.astep);
+    ESP_LOGI(TAG, "Setup complete: gain=%d atime=%u astep=%u auto_smux=%d "
+                  "(%llu us incl. settle)",
+             dev->config.gain, dev->config.atime, dev->config.astep,
+             (int)dev->config.smux_mode,
+             (unsigned long long)(esp_timer_get_time() - t_setup));
     return ESP_OK;
 }
 
@@ -290,20 +634,12 @@ static esp_err_t as7343_setup_registers(as7343_device_t *dev)
  * Public API
  * ════════════════════════════════════════════════════════════════════════════ */
 
-esp_err_t as7343_init(i2c_master_bus_handle_t bus_handle,
-                      const as7343_config_t *config,
-                      as7343_handle_t *handle)
+/* Shared bring-up for a zeroed device context (heap or static) */
+static esp_err_t as7343_init_dev(as7343_device_t *dev,
+                                 i2c_master_bus_handle_t bus_handle,
+                                 const as7343_config_t *config)
 {
-    ESP_ARG_CHECK(bus_handle && config && handle);
-
-    vTaskDelay(pdMS_TO_TICKS(AS7343_POWERUP_DELAY_MS));
-
-    esp_err_t ret = i2c_master_probe(bus_handle, config->i2c_address,
-                                     I2C_XFR_TIMEOUT_MS);
-    ESP_GOTO_ON_ERROR(ret, err, TAG, "probe failed at 0x%02X", config->i2c_address);
-
-    as7343_device_t *dev = (as7343_device_t *)calloc(1, sizeof(as7343_device_t));
-    ESP_GOTO_ON_FALSE(dev, ESP_ERR_NO_MEM, err, TAG, "no memory");
+    esp_err_t ret = ESP_OK;
 
     dev->config = *config;
 
@@ -312,82 +648,171 @@ esp_err_t as7343_init(i2c_master_bus_handle_t bus_handle,
         .device_address  = config->i2c_address,
         .scl_speed_hz    = config->i2c_clock_speed,
     };
-    ESP_GOTO_ON_ERROR(i2c_master_bus_add_device(bus_handle, &dev_cfg,
-                                                 &dev->i2c_handle),
-                      err_free, TAG, "add device failed");
+    ESP_RETURN_ON_ERROR(i2c_master_bus_add_device(bus_handle, &dev_cfg,
+                                                  &dev->i2c_handle),
+                        TAG, "add device failed");
 
-    vTaskDelay(pdMS_TO_TICKS(AS7343_CMD_DELAY_MS));
+    /* Poll until the part answers instead of sleeping a fixed 200 ms */
+    ESP_GOTO_ON_ERROR(as7343_wait_ready(dev),
+                      err_handle, TAG, "power-up readiness poll failed");
 
-    ESP_GOTO_ON_ERROR(as7343_setup_registers(dev),
-                      err_handle, TAG, "setup_registers failed");
+    if (as7343_warm_init_valid(dev)) {
+        /* Registers survived deep sleep with this exact configuration and
+         * SP_EN is still running — skip the full setup and settle delay */
+        ESP_LOGI(TAG, "Warm init: configuration retained from last cycle");
+    } else if (as7343_parked_init_valid(dev)) {
+        /* Sensor was parked by as7343_sleep() before a long deep sleep;
+         * registers are retained, only low_power and SP_EN need flipping */
+        ESP_GOTO_ON_ERROR(as7343_unpark(dev),
+                          err_handle, TAG, "unpark failed");
+        ESP_LOGI(TAG, "Fast wake: sensor unparked, configuration retained");
+    } else {
+        s_warm_cfg.magic = 0;
+        ESP_GOTO_ON_ERROR(as7343_setup_registers(dev),
+                          err_handle, TAG, "setup_registers failed");
+        as7343_warm_cfg_store(dev);
+    }
 
-    *handle = (as7343_handle_t)dev;
-    vTaskDelay(pdMS_TO_TICKS(AS7343_APPSTART_DELAY_MS));
+    as7343_setup_drdy_irq(dev);
+    as7343_dark_cal_load(dev);
     return ESP_OK;
 
 err_handle:
     i2c_master_bus_rm_device(dev->i2c_handle);
-err_free:
-    free(dev);
-err:
+    dev->i2c_handle = NULL;
     return ret;
 }
 
+esp_err_t as7343_init(i2c_master_bus_handle_t bus_handle,
+                      const as7343_config_t *config,
+                      as7343_handle_t *handle)
+{
+    ESP_ARG_CHECK(bus_handle && config && handle);
+
+    as7343_device_t *dev = (as7343_device_t *)calloc(1, sizeof(as7343_device_t));
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_NO_MEM, TAG, "no memory");
+
+    esp_err_t ret = as7343_init_dev(dev, bus_handle, config);
+    if (ret != ESP_OK) {
+        free(dev);
+        return ret;
+    }
+
+    *handle = (as7343_handle_t)dev;
+    return ESP_OK;
+}
+
+esp_err_t as7343_init_static(i2c_master_bus_handle_t bus_handle,
+                             const as7343_config_t *config,
+                             as7343_handle_t *handle)
+{
+    ESP_ARG_CHECK(bus_handle && config && handle);
+    ESP_RETURN_ON_FALSE(!s_static_in_use, ESP_ERR_INVALID_STATE, TAG,
+                        "static context already in use");
+
+    memset(&s_static_ctx, 0, sizeof(s_static_ctx));
+    s_static_ctx.static_ctx = true;
+
+    esp_err_t ret = as7343_init_dev(&s_static_ctx, bus_handle, config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    s_static_in_use = true;
+    *handle = (as7343_handle_t)&s_static_ctx;
+    return ESP_OK;
+}
+
 esp_err_t as7343_get_spectral_data(as7343_handle_t handle,
                                    as7343_channels_t *channels)
 {
     as7343_device_t *dev = (as7343_device_t *)handle;
     ESP_ARG_CHECK(dev && channels);
 
-    /* Wait for a complete 3-cycle auto_smux measurement before reading.
-     * t_int per cycle = (ATIME+1) × (ASTEP+1) × 2.78 µs  (datasheet eq. 1)
-     * Total for 3 cycles + 50 ms margin. */
-    uint32_t t_int_us = (uint32_t)(dev->config.atime + 1) *
-                        (uint32_t)(dev->config.astep + 1) * 278 / 100; /* ×2.78 µs */
-    uint32_t delay_ms = (t_int_us * 3) / 1000 + 50;
-    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+    /* Wait for a complete auto_smux measurement before reading. */
+    if (dev->drdy_sem != NULL) {
+        /* Interrupt mode: sleep until the sensor signals completion */
+        ESP_RETURN_ON_ERROR(as7343_wait_avalid(dev),
+                            TAG, "wait for data-ready failed");
+    } else {
+        /* Polling fallback: fixed worst-case integration delay.
+         * t_int per cycle = (ATIME+1) × (ASTEP+1) × 2.78 µs (datasheet eq. 1)
+         * Total for all SMUX cycles + 50 ms margin. */
+        uint32_t t_int_us = (uint32_t)(dev->config.atime + 1) *
+                            (uint32_t)(dev->config.astep + 1) * 278 / 100; /* ×2.78 µs */
+        uint32_t delay_ms = (t_int_us * as7343_smux_cycles(dev)) / 1000 + 50;
+        as7343_integration_delay(dev, delay_ms);
+    }
 
     /* Ensure bank-0 before read (matches SparkFun readSpectraDataFromSensor) */
     ESP_RETURN_ON_ERROR(as7343_set_bank(dev, 0), TAG, "set bank0 before read failed");
 
-    /* Datasheet section 10.2.7: reading ASTATUS (0x94) latches all 36 spectral
+    /* Datasheet section 10.2.7: reading ASTATUS (0x94) latches all spectral
      * data bytes, and those bytes must be read consecutively in the SAME I²C
      * transaction. Two separate transactions allow the sensor to overwrite
      * cycle-1 DATA registers (FZ/FY/FXL/NIR/CLEAR) between the reads, producing
-     * zeros on those channels. Fix: single 37-byte burst from 0x94. */
+     * zeros on those channels. Fix: single burst from 0x94 — 37 bytes in
+     * 18-channel mode, 13 bytes (ASTATUS + 6 words) in 6-channel mode. */
     uint8_t buf[37] = { 0 };
-    ESP_RETURN_ON_ERROR(as7343_i2c_read_bytes(dev, 0x94, buf, sizeof(buf)),
+    uint32_t burst_len = 1 + as7343_smux_cycles(dev) * 6 * 2;
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_bytes(dev, 0x94, buf, burst_len),
                         TAG, "burst read ASTATUS+data failed");
 
     uint8_t astatus = buf[0];          /* ASTATUS at 0x94          */
     uint8_t *raw    = &buf[1];         /* DATA_0..DATA_17 at 0x95+ */
     (void)astatus;                     /* suppress unused-variable warning */
 
-#define RD16(ch) ((uint16_t)raw[(ch)*2] | ((uint16_t)raw[(ch)*2+1] << 8))
-
-    /* Map channels per auto_smux=3 order (SparkFun header, lines 70-72):
-     * Cycle 1: FZ, FY, FXL, NIR, VIS, FD
-     * Cycle 2: F2, F3, F4,  F6,  VIS, FD
-     * Cycle 3: F1, F7, F8,  F5,  VIS, FD */
-    channels->fz    = RD16(CH_FZ);
-    channels->fy    = RD16(CH_FY);
-    channels->fxl   = RD16(CH_FXL);
-    channels->nir   = RD16(CH_NIR);
-    channels->clear = RD16(CH_VIS1);
-    channels->f2    = RD16(CH_F2);
-    channels->f3    = RD16(CH_F3);
-    channels->f4    = RD16(CH_F4);
-    channels->f6    = RD16(CH_F6);
-    channels->f1    = RD16(CH_F1);
-    channels->f7    = RD16(CH_F7);
-    channels->f8    = RD16(CH_F8);
-    channels->f5    = RD16(CH_F5);
-
-#undef RD16
+    as7343_decode_burst(raw, dev->config.smux_mode, channels);
+
+    as7343_dark_cal_apply(dev, channels);
 
     return ESP_OK;
 }
 
+esp_err_t as7343_calibrate_dark(as7343_handle_t handle)
+{
+    as7343_device_t *dev = (as7343_device_t *)handle;
+    ESP_ARG_CHECK(dev);
+
+    /* Average several readings with the subtraction disabled so a rerun
+     * never calibrates against already-corrected counts */
+    dev->dark_valid = false;
+    uint32_t acc[13] = { 0 };
+    for (int n = 0; n < AS7343_DARK_CAL_READS; n++) {
+        as7343_channels_t ch;
+        ESP_RETURN_ON_ERROR(as7343_get_spectral_data(handle, &ch),
+                            TAG, "dark calibration read failed");
+        const uint16_t *v = (const uint16_t *)&ch;
+        for (int i = 0; i < 13; i++) {
+            acc[i] += v[i];
+        }
+    }
+
+    dev->dark.gain  = (uint8_t)dev->config.gain;
+    dev->dark.atime = dev->config.atime;
+    dev->dark.astep = dev->config.astep;
+    for (int i = 0; i < 13; i++) {
+        dev->dark.off[i] = (uint16_t)(acc[i] / AS7343_DARK_CAL_READS);
+    }
+    dev->dark_valid = true;
+    s_dark_rtc.cal   = dev->dark;
+    s_dark_rtc.magic = AS7343_RTC_MAGIC;
+
+    nvs_handle_t nvs;
+    ESP_RETURN_ON_ERROR(nvs_open(AS7343_NVS_NAMESPACE, NVS_READWRITE, &nvs),
+                        TAG, "nvs open failed");
+    esp_err_t err = nvs_set_blob(nvs, AS7343_NVS_DARK_KEY,
+                                 &dev->dark, sizeof(dev->dark));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    ESP_LOGI(TAG, "Dark calibration stored (gain=%u, clear offset=%u)",
+             dev->dark.gain, dev->dark.off[12]);
+    return err;
+}
+
 esp_err_t as7343_set_gain(as7343_handle_t handle, as7343_gain_t gain)
 {
     as7343_device_t *dev = (as7343_device_t *)handle;
@@ -413,6 +838,132 @@ esp_err_t as7343_set_gain(as7343_handle_t handle, as7343_gain_t gain)
     en.bits.spectral_enabled = true;
     ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
                         TAG, "write SP_EN=1 failed");
+    as7343_warm_cfg_store(dev);   /* keep warm-init cache coherent */
+    return ESP_OK;
+}
+
+esp_err_t as7343_set_smux_mode(as7343_handle_t handle, as7343_smux_mode_t mode)
+{
+    as7343_device_t *dev = (as7343_device_t *)handle;
+    ESP_ARG_CHECK(dev);
+    if (mode != AS7343_SMUX_6CH && mode != AS7343_SMUX_18CH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* CFG20 must not change during measurement: SP_EN off first */
+    as7343_enable_reg_t en = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg),
+                        TAG, "read ENABLE failed");
+    en.bits.spectral_enabled = false;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write SP_EN=0 failed");
+
+    as7343_cfg20_reg_t cfg20 = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_CFG20, &cfg20.reg),
+                        TAG, "read CFG20 failed");
+    cfg20.bits.auto_smux = (uint8_t)mode;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CFG20, cfg20.reg),
+                        TAG, "write CFG20 auto_smux failed");
+    dev->config.smux_mode = mode;
+
+    /* Re-enable SP_EN */
+    en.bits.spectral_enabled = true;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write SP_EN=1 failed");
+    as7343_warm_cfg_store(dev);   /* keep warm-init cache coherent */
+    return ESP_OK;
+}
+
+esp_err_t as7343_measure_flicker(as7343_handle_t handle,
+                                 as7343_flicker_t *result)
+{
+    as7343_device_t *dev = (as7343_device_t *)handle;
+    ESP_ARG_CHECK(dev && result);
+
+    memset(result, 0, sizeof(*result));
+
+    /* FD shares the ADC sequencer with spectral measurement: SP_EN off,
+     * FD samples routed into the FIFO as 8-bit values (fd_fifo_8b doubles
+     * the usable depth and 8 bits resolve mains ripple fine). */
+    as7343_enable_reg_t en = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg),
+                        TAG, "read ENABLE failed");
+    en.bits.spectral_enabled = false;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write SP_EN=0 failed");
+
+    as7343_cfg20_reg_t cfg20 = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_CFG20, &cfg20.reg),
+                        TAG, "read CFG20 failed");
+    as7343_cfg20_reg_t cfg20_fd = cfg20;
+    cfg20_fd.bits.fd_fifo_8b = 1;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CFG20, cfg20_fd.reg),
+                        TAG, "write fd_fifo_8b failed");
+
+    uint8_t fd_cfg0 = 0;
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_FD_CFG0, &fd_cfg0),
+                        TAG, "read FD_CFG0 failed");
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_FD_CFG0,
+                                               fd_cfg0 | 0x80), /* fifo_write_fd */
+                        TAG, "write fifo_write_fd failed");
+
+    /* Drop any stale FIFO contents, then run FD at the default sample rate
+     * for long enough to span several mains cycles */
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CONTROL, 1u << 1),
+                        TAG, "fifo_clr failed");
+    en.bits.flicker_enabled = true;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write FD_EN=1 failed");
+    vTaskDelay(pdMS_TO_TICKS(AS7343_FLICKER_CAPTURE_MS));
+    en.bits.flicker_enabled = false;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write FD_EN=0 failed");
+
+    uint8_t level = 0;
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_FIFO_LVL, &level),
+                        TAG, "read FIFO_LVL failed");
+    if (level > AS7343_FLICKER_MAX_SAMPLES) {
+        level = AS7343_FLICKER_MAX_SAMPLES;
+    }
+
+    /* Drain the FIFO one sample at a time (each FDATA read pops an entry)
+     * and reduce to min/max/mean on the fly */
+    uint32_t sum = 0;
+    uint8_t vmin = 0xFF, vmax = 0;
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < level; i++) {
+        uint8_t v = 0;
+        if (as7343_i2c_read_byte(dev, AS7343_REG_FDATA_L, &v) != ESP_OK) {
+            break;
+        }
+        sum += v;
+        if (v < vmin) vmin = v;
+        if (v > vmax) vmax = v;
+        count++;
+    }
+
+    /* Restore the spectral configuration regardless of capture outcome */
+    as7343_i2c_write_byte(dev, AS7343_REG_FD_CFG0, fd_cfg0);
+    as7343_i2c_write_byte(dev, AS7343_REG_CFG20, cfg20.reg);
+    as7343_i2c_write_byte(dev, AS7343_REG_FD_STATUS, 0xFF);
+    en.bits.spectral_enabled = true;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write SP_EN=1 failed");
+
+    result->sample_count = count;
+    if (count >= 8 && sum > 0) {
+        uint32_t mean = sum / count;
+        if (mean > 0) {
+            uint32_t mod = ((uint32_t)(vmax - vmin) * 1000U) / mean;
+            result->modulation_permille = (mod > 0xFFFF) ? 0xFFFF : (uint16_t)mod;
+            result->detected =
+                result->modulation_permille >= AS7343_FLICKER_THRESHOLD_PERMILLE;
+        }
+    }
+
+    ESP_LOGI(TAG, "Flicker: %u samples, modulation=%u permille%s",
+             result->sample_count, result->modulation_permille,
+             result->detected ? " (DETECTED)" : "");
     return ESP_OK;
 }
 
@@ -446,6 +997,34 @@ esp_err_t as7343_set_integration_time(as7343_handle_t handle,
     en.bits.spectral_enabled = true;
     ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
                         TAG, "write SP_EN=1 failed");
+    as7343_warm_cfg_store(dev);   /* keep warm-init cache coherent */
+    return ESP_OK;
+}
+
+esp_err_t as7343_sleep(as7343_handle_t handle)
+{
+    as7343_device_t *dev = (as7343_device_t *)handle;
+    ESP_ARG_CHECK(dev);
+
+    /* Stop the spectral engine first — low_power must not be set while a
+     * measurement is in flight */
+    as7343_enable_reg_t en = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_ENABLE, &en.reg),
+                        TAG, "read ENABLE failed");
+    en.bits.spectral_enabled = false;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_ENABLE, en.reg),
+                        TAG, "write SP_EN=0 failed");
+
+    /* PON stays set so the register file is retained; low_power gates the
+     * oscillator and drops idle draw to the datasheet sleep floor */
+    as7343_cfg0_reg_t cfg0 = { .reg = 0 };
+    ESP_RETURN_ON_ERROR(as7343_i2c_read_byte(dev, AS7343_REG_CFG0, &cfg0.reg),
+                        TAG, "read CFG0 failed");
+    cfg0.bits.low_power = true;
+    ESP_RETURN_ON_ERROR(as7343_i2c_write_byte(dev, AS7343_REG_CFG0, cfg0.reg),
+                        TAG, "set low_power failed");
+
+    s_warm_cfg.parked = 1;
     return ESP_OK;
 }
 
@@ -468,6 +1047,11 @@ esp_err_t as7343_delete(as7343_handle_t handle)
 {
     ESP_ARG_CHECK(handle);
     esp_err_t ret = as7343_remove(handle);
-    free(handle);
+    as7343_device_t *dev = (as7343_device_t *)handle;
+    if (dev->static_ctx) {
+        s_static_in_use = false;   /* context reusable, nothing to free */
+    } else {
+        free(handle);
+    }
     return ret;
 }
\ No newline at end of file
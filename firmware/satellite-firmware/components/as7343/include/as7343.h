@@ -11,13 +11,19 @@
 #include <esp_err.h>
 #include <driver/i2c_master.h>
 
+#include "as7343_decode.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /* ── I²C defaults ─────────────────────────────────────────────────────────── */
 #define I2C_AS7343_DEV_ADDR         UINT8_C(0x39)
-#define I2C_AS7343_DEV_CLK_SPD      UINT32_C(100000)
+/* Fast-mode 400 kHz (datasheet section 10.1) cuts the 37-byte burst read
+ * from ~4 ms to ~1 ms; fall back to standard mode if the bus pull-ups
+ * cannot hold the lines high (see init_i2c_and_sensor) */
+#define I2C_AS7343_DEV_CLK_SPD      UINT32_C(400000)
+#define I2C_AS7343_DEV_CLK_SPD_SAFE UINT32_C(100000)
 
 /* ── Default config macro ─────────────────────────────────────────────────── *
  * atime=29, astep=599 → t_int = (29+1)×(599+1)×2.78µs ≈ 50 ms              */
@@ -27,8 +33,15 @@ extern "C" {
     .gain            = AS7343_GAIN_256X,              \
     .atime           = 0,                            \
     .astep           = 599,                          \
+    .int_gpio        = -1,                           \
+    .smux_mode       = AS7343_SMUX_18CH,             \
+    .light_sleep_wait = false,                       \
 }
 
+/* auto-SMUX mode (as7343_smux_mode_t) and the channel-data struct
+ * (as7343_channels_t) live in as7343_decode.h with the burst decode,
+ * which is pure logic shared with the host test/benchmark harness. */
+
 /* ── Gain ─────────────────────────────────────────────────────────────────── */
 typedef enum {
     AS7343_GAIN_0_5X  = 0,
@@ -46,23 +59,6 @@ typedef enum {
     AS7343_GAIN_2048X = 12,
 } as7343_gain_t;
 
-/* ── Channel data ─────────────────────────────────────────────────────────── */
-typedef struct {
-    uint16_t f1;    /* ~405 nm */
-    uint16_t f2;    /* ~425 nm */
-    uint16_t f3;    /* ~475 nm */
-    uint16_t f4;    /* ~515 nm */
-    uint16_t f5;    /* ~550 nm */
-    uint16_t f6;    /* ~640 nm */
-    uint16_t f7;    /* ~690 nm */
-    uint16_t f8;    /* ~745 nm */
-    uint16_t fz;    /* ~450 nm */
-    uint16_t fy;    /* ~555 nm */
-    uint16_t fxl;   /* ~600 nm */
-    uint16_t nir;   /* ~855 nm */
-    uint16_t clear; /* broadband */
-} as7343_channels_t;
-
 /* ── Config ───────────────────────────────────────────────────────────────── */
 typedef struct {
     uint16_t      i2c_address;
@@ -70,8 +66,25 @@ typedef struct {
     as7343_gain_t gain;
     uint8_t       atime;
     uint16_t      astep;
+    int           int_gpio;   /* Sensor INT pin GPIO; -1 = poll STATUS2 instead */
+    as7343_smux_mode_t smux_mode; /* 18-channel spectra vs. fast 6-channel */
+    bool          light_sleep_wait; /* Light-sleep through integration delays.
+                                     * Leave off when the wait overlaps UART
+                                     * traffic (e.g. GPS acquisition): light
+                                     * sleep drops RX data. */
 } as7343_config_t;
 
+/* ── Flicker detection ────────────────────────────────────────────────────── *
+ * Result of a FIFO burst capture on the FD photodiode: modulation is the
+ * peak-to-peak swing over the mean in permille, so 50/60 Hz mains ripple
+ * from artificial lighting shows up as a large figure while steady sun or
+ * darkness stays near zero.                                               */
+typedef struct {
+    bool     detected;            /* modulation above rejection threshold */
+    uint16_t modulation_permille; /* (max-min) × 1000 / mean              */
+    uint8_t  sample_count;        /* FD samples drained from the FIFO     */
+} as7343_flicker_t;
+
 /* ── Opaque handle ────────────────────────────────────────────────────────── */
 typedef void *as7343_handle_t;
 
@@ -80,14 +93,46 @@ esp_err_t as7343_init(i2c_master_bus_handle_t bus_handle,
                       const as7343_config_t *config,
                       as7343_handle_t *handle);
 
+/* Like as7343_init but backed by a driver-internal static context: zero
+ * heap traffic, which matters on a wake path that runs millions of times.
+ * One context exists (one sensor per board); a second static init without
+ * an intervening as7343_delete returns ESP_ERR_INVALID_STATE. Delete marks
+ * the context reusable instead of freeing it. */
+esp_err_t as7343_init_static(i2c_master_bus_handle_t bus_handle,
+                             const as7343_config_t *config,
+                             as7343_handle_t *handle);
+
 esp_err_t as7343_get_spectral_data(as7343_handle_t handle,
                                    as7343_channels_t *channels);
 
 esp_err_t as7343_set_gain(as7343_handle_t handle, as7343_gain_t gain);
 
+esp_err_t as7343_set_smux_mode(as7343_handle_t handle,
+                               as7343_smux_mode_t mode);
+
+/* Capture a burst of FD-channel samples through the sensor FIFO and compute
+ * a flicker figure-of-merit. Pauses spectral measurement for ~60 ms. */
+esp_err_t as7343_measure_flicker(as7343_handle_t handle,
+                                 as7343_flicker_t *result);
+
+/* Measure per-channel dark offsets (run with the lens capped / LED off),
+ * persist them to NVS and subtract them from every subsequent reading.
+ * Offsets are captured at the current gain and rescaled across AGC gain
+ * changes; changing atime/astep invalidates the calibration. */
+esp_err_t as7343_calibrate_dark(as7343_handle_t handle);
+
 esp_err_t as7343_set_integration_time(as7343_handle_t handle,
                                       uint8_t atime, uint16_t astep);
 
+/* Park the sensor for a long MCU deep sleep: SP_EN off, CFG0 low_power
+ * set, PON retained so the register file survives. The next init on this
+ * configuration takes a fast-wake path (clear low_power, re-enable SP_EN)
+ * instead of the full setup sequence. Note the wake stub's AVALID check
+ * fails against a parked sensor, so stub-only sampling is unavailable
+ * until that init runs — park only when the sleep is long enough that a
+ * full boot on wake is already the plan. */
+esp_err_t as7343_sleep(as7343_handle_t handle);
+
 esp_err_t as7343_remove(as7343_handle_t handle);
 esp_err_t as7343_delete(as7343_handle_t handle);
 
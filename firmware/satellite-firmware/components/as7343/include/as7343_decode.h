@@ -0,0 +1,83 @@
+/*
+ * AS7343 burst-read decode — pure logic split out of as7343.c so the
+ * channel-mapping code (and the wire structs it fills) compiles on the
+ * host for the unit-test / benchmark harness. No ESP-IDF dependencies.
+ */
+
+#ifndef __AS7343_DECODE_H__
+#define __AS7343_DECODE_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ── auto-SMUX mode ───────────────────────────────────────────────────────── *
+ * 18-channel mode runs three integration cycles per reading for the full
+ * spectrum; 6-channel mode finishes in one cycle (FZ, FY, FXL, NIR, CLEAR
+ * populated, the rest zero) for triple the effective sample rate.          */
+typedef enum {
+    AS7343_SMUX_6CH  = 0,   /* 1 cycle:  FZ, FY, FXL, NIR, VIS, FD */
+    AS7343_SMUX_18CH = 3,   /* 3 cycles: all 13 reported channels  */
+} as7343_smux_mode_t;
+
+/* ── Channel data ─────────────────────────────────────────────────────────── */
+typedef struct {
+    uint16_t f1;    /* ~405 nm */
+    uint16_t f2;    /* ~425 nm */
+    uint16_t f3;    /* ~475 nm */
+    uint16_t f4;    /* ~515 nm */
+    uint16_t f5;    /* ~550 nm */
+    uint16_t f6;    /* ~640 nm */
+    uint16_t f7;    /* ~690 nm */
+    uint16_t f8;    /* ~745 nm */
+    uint16_t fz;    /* ~450 nm */
+    uint16_t fy;    /* ~555 nm */
+    uint16_t fxl;   /* ~600 nm */
+    uint16_t nir;   /* ~855 nm */
+    uint16_t clear; /* broadband */
+} as7343_channels_t;
+
+/*
+ * Decode the DATA_0..DATA_17 bytes of a burst read (raw = the 36 bytes
+ * after ASTATUS) into channel values.
+ *
+ * auto_smux=3 channel order in DATA registers (from SparkFun library header):
+ *   Cycle 1: FZ, FY, FXL, NIR, VIS1, FD1    → DATA_0  .. DATA_5
+ *   Cycle 2: F2, F3, F4,  F6,  VIS2, FD2    → DATA_6  .. DATA_11
+ *   Cycle 3: F1, F7, F8,  F5,  VIS3, FD3    → DATA_12 .. DATA_17
+ *
+ * Each DATA register is 2 bytes little-endian. The FD slots are skipped;
+ * in 6-channel mode only cycle 1 ran, so the F1..F8 fields stay zero.
+ */
+static inline void as7343_decode_burst(const uint8_t *raw,
+                                       as7343_smux_mode_t smux_mode,
+                                       as7343_channels_t *channels)
+{
+#define RD16(ch) ((uint16_t)raw[(ch)*2] | ((uint16_t)raw[(ch)*2+1] << 8))
+    memset(channels, 0, sizeof(*channels));
+    channels->fz    = RD16(0);   /* cycle 1 */
+    channels->fy    = RD16(1);
+    channels->fxl   = RD16(2);
+    channels->nir   = RD16(3);
+    channels->clear = RD16(4);   /* VIS1; FD1 at slot 5 skipped */
+    if (smux_mode == AS7343_SMUX_18CH) {
+        channels->f2 = RD16(6);  /* cycle 2 */
+        channels->f3 = RD16(7);
+        channels->f4 = RD16(8);
+        channels->f6 = RD16(9);  /* VIS2/FD2 at 10/11 skipped */
+        channels->f1 = RD16(12); /* cycle 3 */
+        channels->f7 = RD16(13);
+        channels->f8 = RD16(14);
+        channels->f5 = RD16(15); /* VIS3/FD3 at 16/17 skipped */
+    }
+#undef RD16
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
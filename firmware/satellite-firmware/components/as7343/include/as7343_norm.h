@@ -0,0 +1,95 @@
+/*
+ * Compile-time normalization of AS7343 raw counts to a common scale.
+ *
+ * Raw counts mean nothing across reports unless every reading is on the
+ * same gain/integration footing, and the payload deliberately carries
+ * neither (the wire scale IS the footing). This header generates, at
+ * compile time, the Q16 multipliers that take a count captured at any
+ * gain step and integration setting to "basic counts" at the reference
+ * operating point — gain 256x, atime=0/astep=599 (the driver default,
+ * ~1.67 ms). Applying the multiplier at accumulation is one 32-bit
+ * multiply per channel, which is what lets the AGC roam the full gain
+ * range without any payload or receiver change.
+ *
+ * C++ only (constexpr): consumed by the firmware's wake path and the
+ * host harness; the C driver itself never needs it. Gain steps encode
+ * as7343_gain_t: step s is a true gain of 2^(s-1) (step 0 = 0.5x), so
+ * the gain leg of every multiplier is an exact power of two and the
+ * normalization is lossless up to saturation.
+ */
+
+#ifndef __AS7343_NORM_H__
+#define __AS7343_NORM_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+/* Reference operating point; keep in sync with AS7343_CONFIG_DEFAULT */
+#define AS7343_NORM_REF_GAIN_STEP 9   /* AS7343_GAIN_256X */
+#define AS7343_NORM_REF_ATIME     0
+#define AS7343_NORM_REF_ASTEP     599
+#define AS7343_NORM_STEPS         13  /* gain steps 0.5x .. 2048x */
+
+/* Integration time in astep units: (atime+1) x (astep+1) */
+static constexpr uint32_t as7343_norm_tint_steps(uint8_t atime, uint16_t astep)
+{
+    return (uint32_t)(atime + 1u) * (astep + 1u);
+}
+
+/* Q16 multiplier for the gain leg alone: 65536 x 256 / 2^(step-1) */
+static constexpr uint32_t as7343_norm_gain_q16(uint8_t gain_step)
+{
+    return 1u << (16 + AS7343_NORM_REF_GAIN_STEP - gain_step);
+}
+
+/* Q16 multiplier taking a raw count at (gain_step, atime, astep) to the
+ * reference scale; the integration leg is a rational scale folded into
+ * the same fixed-point constant */
+static constexpr uint32_t as7343_norm_mult_q16(uint8_t gain_step,
+                                               uint8_t atime, uint16_t astep)
+{
+    return (uint32_t)(
+        ((uint64_t)as7343_norm_gain_q16(gain_step) *
+         as7343_norm_tint_steps(AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP)) /
+        as7343_norm_tint_steps(atime, astep));
+}
+
+/* The whole gain range at the default integration setting, indexed by
+ * as7343_gain_t. Firmware running its hot path from IRAM should keep a
+ * DRAM_ATTR copy — this table lands in .rodata (flash). */
+static constexpr uint32_t AS7343_NORM_Q16[AS7343_NORM_STEPS] = {
+    as7343_norm_mult_q16(0,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(1,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(2,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(3,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(4,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(5,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(6,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(7,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(8,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(9,  AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(10, AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(11, AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+    as7343_norm_mult_q16(12, AS7343_NORM_REF_ATIME, AS7343_NORM_REF_ASTEP),
+};
+
+/* At the reference point the multiplier must be identity, and the gain
+ * leg must reproduce the exact shifts the AGC has always applied */
+static_assert(AS7343_NORM_Q16[AS7343_NORM_REF_GAIN_STEP] == (1u << 16),
+              "reference gain step must normalize to identity");
+static_assert(as7343_norm_gain_q16(1) == (256u << 16),
+              "gain 1x is 256 below the reference");
+static_assert(as7343_norm_gain_q16(12) == (1u << 13),
+              "gain 2048x is 8x above the reference");
+
+/* Apply a Q16 multiplier to a raw count, saturating at full scale */
+static inline uint16_t as7343_norm_apply(uint16_t raw, uint32_t mult_q16)
+{
+    uint64_t norm = ((uint64_t)raw * mult_q16) >> 16;
+    return (norm > 0xFFFFu) ? 0xFFFFu : (uint16_t)norm;
+}
+
+#endif /* __cplusplus */
+
+#endif /* __AS7343_NORM_H__ */
@@ -0,0 +1,107 @@
+#include "bbdelta.h"
+
+static uint8_t diff_at(const uint8_t *prev, size_t prev_len,
+                       const uint8_t *cur, size_t i)
+{
+    uint8_t p = (prev != NULL && i < prev_len) ? prev[i] : 0;
+    return (uint8_t)(cur[i] ^ p);
+}
+
+size_t bbdelta_encode(const uint8_t *prev, size_t prev_len,
+                      const uint8_t *cur, size_t cur_len,
+                      uint8_t *out, size_t out_max)
+{
+    size_t in = 0;
+    size_t written = 0;
+
+    while (in < cur_len)
+    {
+        if (diff_at(prev, prev_len, cur, in) == 0)
+        {
+            size_t run = 1;
+            while (in + run < cur_len && run < 128 &&
+                   diff_at(prev, prev_len, cur, in + run) == 0)
+            {
+                run++;
+            }
+            if (written + 1 > out_max)
+            {
+                return 0;
+            }
+            out[written++] = (uint8_t)(run - 1);
+            in += run;
+        }
+        else
+        {
+            /* Literal run ends at the next zero pair: a lone zero between
+             * literals is cheaper carried as a literal than as two extra
+             * tokens, so only a two-byte zero run breaks the literal */
+            size_t run = 1;
+            while (in + run < cur_len && run < 128)
+            {
+                if (diff_at(prev, prev_len, cur, in + run) == 0 &&
+                    (in + run + 1 >= cur_len ||
+                     diff_at(prev, prev_len, cur, in + run + 1) == 0))
+                {
+                    break;
+                }
+                run++;
+            }
+            if (written + 1 + run > out_max)
+            {
+                return 0;
+            }
+            out[written++] = (uint8_t)(0x7F + run);
+            for (size_t i = 0; i < run; i++)
+            {
+                out[written++] = diff_at(prev, prev_len, cur, in + i);
+            }
+            in += run;
+        }
+    }
+    return written;
+}
+
+size_t bbdelta_decode(const uint8_t *prev, size_t prev_len,
+                      const uint8_t *enc, size_t enc_len,
+                      uint8_t *out, size_t out_max)
+{
+    size_t in = 0;
+    size_t produced = 0;
+
+    while (in < enc_len)
+    {
+        uint8_t token = enc[in++];
+        if (token <= 0x7F)
+        {
+            size_t run = (size_t)token + 1;
+            if (produced + run > out_max)
+            {
+                return 0;
+            }
+            for (size_t i = 0; i < run; i++, produced++)
+            {
+                out[produced] = (prev != NULL && produced < prev_len)
+                                    ? prev[produced]
+                                    : 0;
+            }
+        }
+        else
+        {
+            size_t run = (size_t)token - 0x7F;
+            if (in + run > enc_len || produced + run > out_max)
+            {
+                return 0;
+            }
+            for (size_t i = 0; i < run; i++, produced++)
+            {
+                uint8_t p = (prev != NULL && produced < prev_len)
+                                ? prev[produced]
+                                : 0;
+                out[produced] = (uint8_t)(enc[in + i] ^ p);
+            }
+            in += run;
+        }
+    }
+    return produced;
+}
@@ -0,0 +1,55 @@
+#ifndef BBDELTA_H
+#define BBDELTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------------
+ * Black-box record delta codec — pure logic, host-replayable
+ *
+ * Consecutive black-box records barely differ: spectra move slowly, the
+ * profiling trailer's stats creep, and most bytes repeat exactly. The
+ * codec XORs a record against its predecessor and run-length-codes the
+ * zero bytes of the difference, which is the whole trick: byte-oriented,
+ * no bit twiddling, no tables, negligible CPU on the C6. A full entropy
+ * coder buys little on top of zero-RLE for this data and costs code and
+ * cycles the wake budget does not have.
+ *
+ * Token stream (one byte each, literals follow their token):
+ *   0x00..0x7F   run of (token + 1) zero difference bytes   (1..128)
+ *   0x80..0xFF   (token - 0x7F) literal difference bytes    (1..128)
+ *
+ * Records of unequal length delta cleanly: the shorter side is padded
+ * with zeros for the XOR, and the caller keeps the true length outside
+ * the stream (the slot layout already stores one per record).
+ * -------------------------------------------------------------------------- */
+
+/* Worst case (no zero bytes at all): one token per 128 literals */
+#define BBDELTA_BOUND(n) ((n) + ((n) + 127) / 128)
+
+/**
+ * Delta-encode cur against prev (prev may be NULL/empty: the difference
+ * is then cur itself). Returns the encoded size, or 0 when the result
+ * would not fit in out_max — the caller falls back to storing raw.
+ */
+size_t bbdelta_encode(const uint8_t *prev, size_t prev_len,
+                      const uint8_t *cur, size_t cur_len,
+                      uint8_t *out, size_t out_max);
+
+/**
+ * Reverse bbdelta_encode. Returns the reconstructed record length, or 0
+ * when the stream is malformed or the output would exceed out_max.
+ */
+size_t bbdelta_decode(const uint8_t *prev, size_t prev_len,
+                      const uint8_t *enc, size_t enc_len,
+                      uint8_t *out, size_t out_max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,226 @@
+#include "gps_parse.h"
+#include "nmea.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * UBX binary input (NAV-PVT)
+ * -------------------------------------------------------------------------- */
+#define UBX_CLASS_NAV   0x01
+#define UBX_ID_NAV_PVT  0x07
+
+/* Receive state machine */
+typedef enum {
+    UBX_WAIT_SYNC1,
+    UBX_WAIT_SYNC2,
+    UBX_HEADER,     /* class, id, len (4 bytes) */
+    UBX_PAYLOAD,
+    UBX_CHECKSUM,   /* ck_a, ck_b */
+} ubx_rx_state_t;
+
+/* Little-endian field extraction from the fixed NAV-PVT layout */
+static uint16_t ubx_u2(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t ubx_u4(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static int32_t ubx_i4(const uint8_t *p) { return (int32_t)ubx_u4(p); }
+
+/* Fill *out from a checksum-verified NAV-PVT payload */
+static void parse_nav_pvt(const uint8_t *p, gps_data_t *out)
+{
+    uint8_t valid_flags = p[11];
+    uint8_t fix_type    = p[20];
+    uint8_t flags       = p[21];
+
+    out->valid = (flags & 0x01) != 0;  /* gnssFixOK */
+    out->fix_type = (fix_type == 3) ? GPS_FIX_TYPE_3D
+                  : (fix_type == 2) ? GPS_FIX_TYPE_2D
+                                    : GPS_FIX_TYPE_NONE;
+    out->satellites = p[23];
+
+    out->longitude  = ubx_i4(p + 24) * 1e-7;
+    out->latitude   = ubx_i4(p + 28) * 1e-7;
+    out->altitude_m = ubx_i4(p + 36) * 1e-3f;  /* hMSL, mm */
+
+    float speed_kmph = ubx_i4(p + 60) * 3.6e-3f; /* gSpeed, mm/s */
+    out->speed_kmph  = speed_kmph;
+    out->speed_knots = speed_kmph / 1.852f;
+    out->track_deg   = ubx_i4(p + 64) * 1e-5f; /* headMot */
+    out->heading_deg = out->track_deg;
+    out->pdop = ubx_u2(p + 76) * 0.01f;
+
+    /* validDate | validTime */
+    if ((valid_flags & 0x03) == 0x03) {
+        out->datetime.tm_year = ubx_u2(p + 4) - 1900;
+        out->datetime.tm_mon  = p[6] - 1;
+        out->datetime.tm_mday = p[7];
+        out->datetime.tm_hour = p[8];
+        out->datetime.tm_min  = p[9];
+        out->datetime.tm_sec  = p[10];
+        out->datetime_valid = true;
+    }
+}
+
+void ubx_parser_reset(ubx_parser_t *p)
+{
+    memset(p, 0, sizeof(*p));
+    p->state = UBX_WAIT_SYNC1;
+}
+
+bool ubx_parser_feed(ubx_parser_t *p, uint8_t b, gps_data_t *out)
+{
+    switch ((ubx_rx_state_t)p->state) {
+    case UBX_WAIT_SYNC1:
+        if (b == 0xB5) p->state = UBX_WAIT_SYNC2;
+        return false;
+
+    case UBX_WAIT_SYNC2:
+        p->state = (b == 0x62) ? UBX_HEADER : UBX_WAIT_SYNC1;
+        p->got = 0;
+        p->ck_a = p->ck_b = 0;
+        return false;
+
+    case UBX_HEADER:
+        p->hdr[p->got++] = b;
+        p->ck_a = (uint8_t)(p->ck_a + b);
+        p->ck_b = (uint8_t)(p->ck_b + p->ck_a);
+        if (p->got == 4) {
+            p->len = (uint16_t)(p->hdr[2] | (p->hdr[3] << 8));
+            p->got = 0;
+            /* Only NAV-PVT is enabled; anything else (or a corrupt length)
+             * is skipped by resynchronizing on the next sync pattern */
+            if (p->hdr[0] != UBX_CLASS_NAV || p->hdr[1] != UBX_ID_NAV_PVT ||
+                p->len != UBX_NAV_PVT_LEN) {
+                p->state = UBX_WAIT_SYNC1;
+            } else {
+                p->state = UBX_PAYLOAD;
+            }
+        }
+        return false;
+
+    case UBX_PAYLOAD:
+        p->payload[p->got++] = b;
+        p->ck_a = (uint8_t)(p->ck_a + b);
+        p->ck_b = (uint8_t)(p->ck_b + p->ck_a);
+        if (p->got == p->len) {
+            p->got = 0;
+            p->state = UBX_CHECKSUM;
+        }
+        return false;
+
+    case UBX_CHECKSUM:
+        p->ck[p->got++] = b;
+        if (p->got < 2) {
+            return false;
+        }
+        p->state = UBX_WAIT_SYNC1;
+        if (p->ck[0] != p->ck_a || p->ck[1] != p->ck_b) {
+            return false;
+        }
+        parse_nav_pvt(p->payload, out);
+        return true;
+    }
+    return false;
+}
+
+/* --------------------------------------------------------------------------
+ * NMEA text input: the lazy field cursor lives in the nmea component. The
+ * satellite's consumer is get_gps_fix() — lat, lon, time and validity — so
+ * everything else (VTG speed, GSA DOPs, magnetic variation) is never
+ * converted at all.
+ * -------------------------------------------------------------------------- */
+void gps_parse_sentence(char *sentence, gps_data_t *out)
+{
+    nmea_cursor_t cur;
+    nmea_index(sentence, &cur);
+    if (cur.count < 1) return;
+
+    const char *type = cur.field[0] + 1;  /* skip '$', e.g. "GNRMC" */
+
+    /* Match on last 3 chars of sentence type to handle GP/GN/GL/GA/GB */
+    const char *mtype = type + (strlen(type) > 3 ? strlen(type) - 3 : 0);
+
+    /* ------------------------------------------------------------------ */
+    /* RMC – validity, position, date/time: everything get_gps_fix() needs */
+    /* $xxRMC,hhmmss,A/V,lat,N/S,lon,E/W,speed,track,date,,,mode         */
+    /* ------------------------------------------------------------------ */
+    if (strcmp(mtype, "RMC") == 0 && cur.count >= 10) {
+        out->valid = (nmea_field(&cur, 2)[0] == 'A');
+
+        out->latitude  = nmea_coord_to_e7(&cur, 3, 4) * 1e-7;
+        out->longitude = nmea_coord_to_e7(&cur, 5, 6) * 1e-7;
+
+        /* Date: ddmmyy */
+        const char *date = nmea_field(&cur, 9);
+        if (strlen(date) == 6) {
+            out->datetime.tm_mday = nmea_2dig(date, 0);
+            out->datetime.tm_mon  = nmea_2dig(date, 2) - 1;
+            out->datetime.tm_year = nmea_2dig(date, 4) + 100;
+        }
+        /* Time: hhmmss.sss */
+        const char *tod = nmea_field(&cur, 1);
+        if (strlen(tod) >= 6) {
+            out->datetime.tm_hour = nmea_2dig(tod, 0);
+            out->datetime.tm_min  = nmea_2dig(tod, 2);
+            out->datetime.tm_sec  = nmea_2dig(tod, 4);
+            out->datetime_valid = true;
+        }
+    }
+
+    /* ------------------------------------------------------------------ */
+    /* GGA – position fallback + satellite count (diagnostics log)         */
+    /* $xxGGA,time,lat,N,lon,E,quality,sats,hdop,alt,M,...                */
+    /* ------------------------------------------------------------------ */
+    else if (strcmp(mtype, "GGA") == 0 && cur.count >= 10) {
+        out->satellites = atoi(nmea_field(&cur, 7));
+        if (nmea_field(&cur, 2)[0]) {
+            out->latitude  = nmea_coord_to_e7(&cur, 2, 3) * 1e-7;
+            out->longitude = nmea_coord_to_e7(&cur, 4, 5) * 1e-7;
+        }
+    }
+
+    /* GSA and VTG are indexed like everything else but deliberately have
+     * no handlers: DOPs and ground speed have no consumer on this node,
+     * so their float conversions were pure waste in the lock loop. */
+}
+
+bool gps_parse_time_only(char *sentence, gps_data_t *out)
+{
+    /* Header match before any indexing: "$GPRMC" / "$GNRMC" / friends all
+     * carry RMC at offset 3, so every other sentence type is rejected for
+     * the cost of three byte compares */
+    if (sentence[0] != '$' || strlen(sentence) < 6 ||
+        memcmp(sentence + 3, "RMC", 3) != 0) {
+        return false;
+    }
+
+    nmea_cursor_t cur;
+    nmea_index(sentence, &cur);
+    if (cur.count < 10) {
+        return false;
+    }
+
+    /* Time and date only — no coordinate conversion, no validity flag
+     * update. The receiver leaves both fields empty until its clock is
+     * set (warm-start backup RAM keeps it across our sleeps), so their
+     * presence at full width is the validity signal; the RMC status
+     * character gates navigation, not time, and is deliberately ignored
+     * here — a time hit under status 'V' is exactly the case this path
+     * exists for. */
+    const char *date = nmea_field(&cur, 9);
+    const char *tod  = nmea_field(&cur, 1);
+    if (strlen(date) != 6 || strlen(tod) < 6) {
+        return false;
+    }
+    out->datetime.tm_mday = nmea_2dig(date, 0);
+    out->datetime.tm_mon  = nmea_2dig(date, 2) - 1;
+    out->datetime.tm_year = nmea_2dig(date, 4) + 100;
+    out->datetime.tm_hour = nmea_2dig(tod, 0);
+    out->datetime.tm_min  = nmea_2dig(tod, 2);
+    out->datetime.tm_sec  = nmea_2dig(tod, 4);
+    out->datetime_valid = true;
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef GPS_PARSE_H
+#define GPS_PARSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------------
+ * GPS parsing — pure logic split out of main/gps.c
+ *
+ * Everything here operates on caller-provided state and raw bytes, with no
+ * UART or FreeRTOS dependencies, so the host harness can replay recorded
+ * byte streams through exactly the code the firmware runs. gps.c keeps the
+ * driver plumbing (events, ring buffer, power commands) and feeds bytes in.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @brief GPS fix type (2D / 3D)
+ */
+typedef enum {
+    GPS_FIX_TYPE_NONE = 1,
+    GPS_FIX_TYPE_2D   = 2,
+    GPS_FIX_TYPE_3D   = 3,
+} gps_fix_type_t;
+
+/**
+ * @brief Aggregated GPS data, updated on each successful parse cycle.
+ */
+typedef struct {
+    /* --- Position --- */
+    double latitude;            /*!< Decimal degrees, positive = North */
+    double longitude;           /*!< Decimal degrees, positive = East  */
+    float  altitude_m;          /*!< Altitude above mean sea level, metres */
+
+    /* --- Motion --- */
+    float  speed_kmph;          /*!< Ground speed, km/h  */
+    float  speed_knots;         /*!< Ground speed, knots */
+    float  track_deg;           /*!< True track / heading, degrees */
+    float  heading_deg;         /*!< Mag-variation-adjusted heading, degrees */
+
+    /* --- Satellite info --- */
+    int    satellites;          /*!< Number of satellites in use */
+    float  hdop;                /*!< Horizontal dilution of precision */
+    float  pdop;                /*!< Position dilution of precision */
+    float  vdop;                /*!< Vertical dilution of precision */
+
+    /* --- Fix status --- */
+    gps_fix_type_t fix_type;    /*!< Fix type: none / 2D / 3D (GPGSA) */
+    bool           valid;       /*!< True when GPRMC reports an active fix */
+
+    /* --- Time / Date (UTC) --- */
+    struct tm datetime;         /*!< UTC date & time from GPRMC */
+    bool      datetime_valid;   /*!< True once a date/time sentence has been parsed */
+} gps_data_t;
+
+/* --------------------------------------------------------------------------
+ * UBX binary input (NAV-PVT)
+ * -------------------------------------------------------------------------- */
+#define UBX_NAV_PVT_LEN 92
+
+/** Byte-at-a-time UBX receive state machine (one per stream). */
+typedef struct {
+    int      state;             /* ubx_rx_state_t, private to gps_parse.c */
+    uint8_t  hdr[4];
+    uint8_t  payload[UBX_NAV_PVT_LEN];
+    uint16_t len;
+    uint16_t got;
+    uint8_t  ck[2];
+    uint8_t  ck_a, ck_b;
+} ubx_parser_t;
+
+/** Reset to hunting for the sync pattern (also the initial state). */
+void ubx_parser_reset(ubx_parser_t *p);
+
+/**
+ * Feed one byte; fills *out and returns true when a checksum-verified
+ * NAV-PVT message completed. Unknown messages and corrupt frames are
+ * skipped by resynchronizing on the next sync pattern.
+ */
+bool ubx_parser_feed(ubx_parser_t *p, uint8_t b, gps_data_t *out);
+
+/* --------------------------------------------------------------------------
+ * NMEA text input (RMC / GGA)
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Parse one null-terminated NMEA sentence (leading '$' included) into *out.
+ * Indexes fields in place, so the sentence buffer is modified. Sentences
+ * without a handler (GSA, VTG, ...) are indexed and ignored.
+ */
+void gps_parse_sentence(char *sentence, gps_data_t *out);
+
+/**
+ * Time-only fast path: rejects everything but "$G?RMC" with a header byte
+ * compare, then extracts just the UTC time and date fields. Returns true
+ * and sets out->datetime / out->datetime_valid on a hit; no position,
+ * motion or validity fields are touched (RMC status 'V' still yields time
+ * once the receiver clock is set). Modifies the sentence buffer like
+ * gps_parse_sentence().
+ */
+bool gps_parse_time_only(char *sentence, gps_data_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
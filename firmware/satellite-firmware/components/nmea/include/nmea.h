@@ -0,0 +1,42 @@
+#ifndef NMEA_H
+#define NMEA_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------------
+ * Lazy NMEA field cursor
+ *
+ * One pass over the sentence records where each field starts (terminating
+ * the fields in place); string-to-number conversion happens only when a
+ * handler actually asks for a field. Pure C with no ESP-IDF dependencies,
+ * so the same code runs under the host unit-test harness.
+ * -------------------------------------------------------------------------- */
+#define MAX_NMEA_FIELDS 24
+
+typedef struct {
+    const char *field[MAX_NMEA_FIELDS];
+    int count;
+} nmea_cursor_t;
+
+/* Index a null-terminated sentence in place (strips the *XX checksum) */
+void nmea_index(char *sentence, nmea_cursor_t *cur);
+
+/* Out-of-range indices read as empty, so handlers need no count checks */
+const char *nmea_field(const nmea_cursor_t *cur, int i);
+
+/* Convert NMEA ddmm.mmmm + cardinal to 1e-7-degree fixed point entirely in
+ * integer arithmetic (no software doubles in the lock loop) */
+int32_t nmea_coord_to_e7(const nmea_cursor_t *cur, int coord_i, int card_i);
+
+/* Two-digit decimal at a fixed offset (date/time subfields) */
+int nmea_2dig(const char *s, int off);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+#include "nmea.h"
+
+#include <string.h>
+
+void nmea_index(char *sentence, nmea_cursor_t *cur)
+{
+    /* Strip checksum (*XX) if present */
+    char *star = strchr(sentence, '*');
+    if (star) *star = '\0';
+
+    cur->count = 0;
+    char *p = sentence;
+    while (cur->count < MAX_NMEA_FIELDS) {
+        cur->field[cur->count++] = p;
+        char *comma = strchr(p, ',');
+        if (!comma) break;
+        *comma = '\0';
+        p = comma + 1;
+    }
+}
+
+const char *nmea_field(const nmea_cursor_t *cur, int i)
+{
+    return (i >= 0 && i < cur->count) ? cur->field[i] : "";
+}
+
+/* Convert NMEA ddmm.mmmm + cardinal to 1e-7-degree fixed point entirely in
+ * integer arithmetic. The C6 has no double-precision FPU, so an atof()-based
+ * path would run software doubles on every coordinate in the lock loop;
+ * this is two integer scans and one 64-bit divide instead. */
+int32_t nmea_coord_to_e7(const nmea_cursor_t *cur, int coord_i, int card_i)
+{
+    const char *p = nmea_field(cur, coord_i);
+    if (p[0] == '\0') return 0;
+
+    /* Integer part is dd (or ddd) degrees with mm whole minutes appended */
+    uint32_t intpart = 0;
+    while (*p >= '0' && *p <= '9') {
+        intpart = intpart * 10 + (uint32_t)(*p++ - '0');
+    }
+    uint32_t deg       = intpart / 100;
+    uint32_t min_whole = intpart % 100;
+
+    /* Fractional minutes, up to 7 significant digits */
+    uint32_t frac = 0, scale = 1;
+    if (*p == '.') {
+        p++;
+        while (*p >= '0' && *p <= '9' && scale < 10000000U) {
+            frac  = frac * 10 + (uint32_t)(*p++ - '0');
+            scale *= 10;
+        }
+    }
+
+    /* minutes in 1e-7 min units, then to 1e-7 degrees (rounded /60) */
+    uint64_t min_e7 = (uint64_t)min_whole * 10000000ULL +
+                      (uint64_t)frac * (10000000ULL / scale);
+    int64_t e7 = (int64_t)deg * 10000000LL + (int64_t)((min_e7 + 30) / 60);
+
+    const char *card = nmea_field(cur, card_i);
+    if (card[0] == 'S' || card[0] == 'W') e7 = -e7;
+    return (int32_t)e7;
+}
+
+int nmea_2dig(const char *s, int off)
+{
+    return (s[off] - '0') * 10 + (s[off + 1] - '0');
+}
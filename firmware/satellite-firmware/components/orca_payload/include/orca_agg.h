@@ -0,0 +1,103 @@
+#ifndef ORCA_AGG_H
+#define ORCA_AGG_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Aggregation primitives used to turn the per-wake sample window into
+ * report values. Pure integer code with no ESP-IDF dependencies, so the
+ * host unit-test harness exercises exactly what builds the reports.
+ *
+ * Modes for orca_robust_agg_u16:
+ *   ORCA_AGG_MEAN    — plain arithmetic mean of the window
+ *   ORCA_AGG_MEDIAN  — median (kills single spikes)
+ *   ORCA_AGG_TRIMMED — mean with the top/bottom quarter discarded
+ */
+#define ORCA_AGG_MEAN    0
+#define ORCA_AGG_MEDIAN  1
+#define ORCA_AGG_TRIMMED 2
+
+/* Largest window the sort scratch is sized for (matches ROBUST_WINDOW_N) */
+#define ORCA_AGG_WINDOW_MAX 16
+
+/* Averaging with edge case check */
+static inline uint16_t orca_avg_u16(uint64_t sum, uint32_t count)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    return (uint16_t)(sum / count);
+}
+
+/* Robust aggregate over a retained sample window. Sorts a local copy in
+ * place — insertion sort is optimal at window_n <= 16 — then takes the
+ * mean, median or quartile-trimmed mean. */
+static inline uint16_t orca_robust_agg_u16(const uint16_t *window,
+                                           uint32_t count, uint32_t window_n,
+                                           int mode)
+{
+    if (count == 0 || window_n == 0 || window_n > ORCA_AGG_WINDOW_MAX)
+    {
+        return 0;
+    }
+    uint32_t n = (count < window_n) ? count : window_n;
+
+    uint16_t sorted[ORCA_AGG_WINDOW_MAX];
+    memcpy(sorted, window, n * sizeof(uint16_t));
+    for (uint32_t i = 1; i < n; i++)
+    {
+        uint16_t key = sorted[i];
+        uint32_t j = i;
+        while (j > 0 && sorted[j - 1] > key)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = key;
+    }
+
+    if (mode == ORCA_AGG_MEDIAN)
+    {
+        if (n & 1)
+        {
+            return sorted[n / 2];
+        }
+        return (uint16_t)(((uint32_t)sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+    }
+
+    uint32_t trim = (mode == ORCA_AGG_TRIMMED) ? n / 4 : 0;
+    uint32_t sum = 0;
+    for (uint32_t i = trim; i < n - trim; i++)
+    {
+        sum += sorted[i];
+    }
+    return (uint16_t)(sum / (n - 2 * trim));
+}
+
+/* Integer square root (Newton's method); exact floor for our range */
+static inline uint32_t orca_isqrt_u64(uint64_t v)
+{
+    if (v == 0)
+    {
+        return 0;
+    }
+    uint64_t x = v;
+    uint64_t y = (x + 1) / 2;
+    while (y < x)
+    {
+        x = y;
+        y = (x + v / x) / 2;
+    }
+    return (uint32_t)x;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * ORCA report payload — the single definition of the on-air/on-wire report
+ * layout.
+ *
+ * The packed struct below IS the wire format (little-endian on every target
+ * we ship), so encoding is a plain copy of the struct bytes and decoding is
+ * a cast — no field-by-field serialization on either end. Used by the LoRa
+ * keyframe/batch bodies, the RS-485 frame, and the chamber-side receiver
+ * (the chamber build adds this include directory via -I).
+ *
+ * Layout (47 bytes, little-endian):
+ *   4  bytes - sample_count
+ *   13x 2 bytes - channel averages in ORCA_CH_* order (26 bytes)
+ *   1  byte  - gps_valid
+ *   4  bytes - latitude  (int32, 1e-7 deg, u-blox convention)
+ *   4  bytes - longitude (int32, 1e-7 deg)
+ *   4  bytes - unix_time
+ *   2  bytes - batt_mv (pack voltage in millivolts, 0 = not measured)
+ *   2  bytes - sample_age_ms (last sensor sample to frame encode)
+ */
+
+// Spectral channel ordering on the wire (AS7343 channels)
+typedef enum
+{
+    ORCA_CH_F1 = 0,   // 405 nm
+    ORCA_CH_F2,       // 425 nm
+    ORCA_CH_FZ,       // 450 nm
+    ORCA_CH_F3,       // 475 nm
+    ORCA_CH_F4,       // 515 nm
+    ORCA_CH_F5,       // 550 nm
+    ORCA_CH_FY,       // 555 nm
+    ORCA_CH_F6,       // 640 nm
+    ORCA_CH_FXL,      // 600 nm
+    ORCA_CH_F7,       // 690 nm
+    ORCA_CH_F8,       // 745 nm
+    ORCA_CH_NIR,      // 855 nm
+    ORCA_CH_CLEAR,    // broadband
+    ORCA_NUM_CHANNELS
+} orca_channel_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t sample_count;
+    uint16_t channels[ORCA_NUM_CHANNELS];
+    uint8_t  gps_valid;
+    int32_t  lat_e7;      // 1e-7 degrees
+    int32_t  lon_e7;      // 1e-7 degrees
+    uint32_t unix_time;
+    uint16_t batt_mv;     // 0 when the ADC read failed
+    uint16_t sample_age_ms; // ms from the last sensor sample to encode
+                            // (saturates at 65535) — receivers subtract it
+                            // from their own clock to bound light staleness
+} orca_report_wire_t;
+
+#define ORCA_REPORT_WIRE_SIZE 47
+
+#ifdef __cplusplus
+static_assert(sizeof(orca_report_wire_t) == ORCA_REPORT_WIRE_SIZE,
+              "Wire layout drifted - update ORCA_REPORT_WIRE_SIZE and every decoder");
+#else
+_Static_assert(sizeof(orca_report_wire_t) == ORCA_REPORT_WIRE_SIZE,
+               "Wire layout drifted - update ORCA_REPORT_WIRE_SIZE and every decoder");
+#endif
+
+// Zero-copy decode: reinterpret a received buffer of at least
+// ORCA_REPORT_WIRE_SIZE bytes as a report. The layout is packed, so member
+// access is safe on targets without alignment faults for byte loads.
+static inline const orca_report_wire_t *orca_report_decode(const uint8_t *buf)
+{
+    return (const orca_report_wire_t *)buf;
+}
+
+/*
+ * Bit-packed channel block: 13 channels at 12 bits each (20 bytes) instead
+ * of 13 x uint16 (26 bytes). At the default gain the averages rarely use
+ * more than 12 significant bits; the rare bright frame is handled by a
+ * shared shift annotation — every channel right-shifted by the same amount
+ * (round to nearest) until the largest fits, so relative precision is kept
+ * across the whole spectrum rather than clipping one band. The shift byte
+ * rides next to the block on the wire; 0 means the packing was lossless.
+ *
+ * Bit order is LSB-first within the block (channel i occupies bits
+ * [12*i, 12*i+12) counted from byte 0 bit 0), matching the little-endian
+ * convention of everything else on this wire. The final 4 bits are padding
+ * and transmit as zero.
+ */
+#define ORCA_PACKED_CH_BITS  12
+#define ORCA_PACKED_CH_MAX   0x0FFFu
+#define ORCA_PACKED_CH_BYTES ((ORCA_NUM_CHANNELS * ORCA_PACKED_CH_BITS + 7) / 8)
+
+// Pack the channel block into out[ORCA_PACKED_CH_BYTES]; returns the shared
+// shift the receiver must undo (0..4)
+static inline uint8_t orca_channels_pack(const uint16_t ch[ORCA_NUM_CHANNELS],
+                                         uint8_t *out)
+{
+    uint16_t max_v = 0;
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+        if (ch[i] > max_v)
+        {
+            max_v = ch[i];
+        }
+    }
+    uint8_t shift = 0;
+    while ((unsigned)(max_v >> shift) > ORCA_PACKED_CH_MAX)
+    {
+        shift++;
+    }
+
+    uint32_t acc = 0;
+    int bits = 0;
+    int n = 0;
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+        // Round to nearest; rounding can carry past 12 bits, so clamp
+        uint32_t v = shift ? (((uint32_t)ch[i] + (1u << (shift - 1))) >> shift)
+                           : ch[i];
+        if (v > ORCA_PACKED_CH_MAX)
+        {
+            v = ORCA_PACKED_CH_MAX;
+        }
+        acc |= v << bits;
+        bits += ORCA_PACKED_CH_BITS;
+        while (bits >= 8)
+        {
+            out[n++] = (uint8_t)(acc & 0xFF);
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits > 0)
+    {
+        out[n++] = (uint8_t)(acc & 0xFF); // trailing 4-bit pad
+    }
+    return shift;
+}
+
+// Undo orca_channels_pack: expand ORCA_PACKED_CH_BYTES back into 13
+// channel values, re-applying the shared shift
+static inline void orca_channels_unpack(const uint8_t *in, uint8_t shift,
+                                        uint16_t ch[ORCA_NUM_CHANNELS])
+{
+    uint32_t acc = 0;
+    int bits = 0;
+    int n = 0;
+    for (int i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+        while (bits < ORCA_PACKED_CH_BITS)
+        {
+            acc |= (uint32_t)in[n++] << bits;
+            bits += 8;
+        }
+        uint32_t v = (acc & ORCA_PACKED_CH_MAX) << shift;
+        ch[i] = (v > 0xFFFFu) ? 0xFFFFu : (uint16_t)v;
+        acc >>= ORCA_PACKED_CH_BITS;
+        bits -= ORCA_PACKED_CH_BITS;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed-point solar elevation.
+ *
+ * Integer-only implementation of the standard low-precision solar position
+ * algorithm (mean longitude / mean anomaly / ecliptic longitude, fixed
+ * 23.44deg obliquity, three-term equation of time), good to well under a
+ * degree against the full NOAA model across this century. That is plenty
+ * for scheduling decisions banded in tens of degrees, and it runs in a few
+ * microseconds with no libm — cheap enough for every wake.
+ *
+ * Angles are milli-degrees internally and centi-degrees at the API; sines
+ * are Q15 via a 91-entry quarter-wave table with linear interpolation,
+ * and arcsine inverts that table by bisection.
+ */
+
+/**
+ * Sun elevation above the horizon in centi-degrees (-9000..9000 cdeg),
+ * ignoring atmospheric refraction. Position in the wire's 1e-7 degree
+ * fixed point; time as unix seconds UTC.
+ */
+int32_t solar_elevation_cdeg(uint32_t unix_time, int32_t lat_e7, int32_t lon_e7);
+
+#ifdef __cplusplus
+}
+#endif
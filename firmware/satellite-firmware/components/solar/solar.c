@@ -0,0 +1,112 @@
+#include "solar.h"
+
+/*
+ * All angles below are milli-degrees (mdeg) unless noted; trig values are
+ * Q15 (32767 = 1.0). The astronomical constants are the usual
+ * low-precision series (e.g. the Astronomical Almanac's approximate solar
+ * coordinates), scaled to integers.
+ */
+
+#define J2000_UNIX 946728000LL /* 2000-01-01 12:00:00 UTC */
+
+/* Quarter-wave sine table, Q15 at 1-degree steps 0..90 */
+static const int16_t SIN_TABLE[91] = {
+        0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+     5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767,
+};
+
+/* sin(a) in Q15 for a in mdeg (any sign, any magnitude) */
+static int32_t sin_q15(int64_t a_mdeg)
+{
+    int32_t a = (int32_t)(a_mdeg % 360000);
+    if (a < 0) a += 360000;
+
+    int neg = 0;
+    if (a >= 180000) {
+        a -= 180000;
+        neg = 1;
+    }
+    if (a > 90000) {
+        a = 180000 - a;
+    }
+
+    int32_t idx = a / 1000;
+    int32_t frac = a % 1000;
+    int32_t lo = SIN_TABLE[idx];
+    int32_t hi = (idx < 90) ? SIN_TABLE[idx + 1] : lo;
+    int32_t s = lo + ((hi - lo) * frac) / 1000;
+    return neg ? -s : s;
+}
+
+static int32_t cos_q15(int64_t a_mdeg)
+{
+    return sin_q15(a_mdeg + 90000);
+}
+
+/* asin(x) in mdeg for x in Q15, by bisection over the monotonic quarter
+ * wave — 18 rounds pin the result to well under the table's own error */
+static int32_t asin_mdeg(int32_t x_q15)
+{
+    if (x_q15 >= 32767) return 90000;
+    if (x_q15 <= -32767) return -90000;
+
+    int32_t lo = -90000, hi = 90000;
+    for (int i = 0; i < 18; i++) {
+        int32_t mid = (lo + hi) / 2;
+        if (sin_q15(mid) < x_q15) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo + hi) / 2;
+}
+
+int32_t solar_elevation_cdeg(uint32_t unix_time, int32_t lat_e7, int32_t lon_e7)
+{
+    int64_t t = (int64_t)unix_time - J2000_UNIX; /* seconds since J2000 */
+
+    /* Mean longitude and mean anomaly: 280.460 + 0.9856474 deg/day,
+     * 357.528 + 0.9856003 deg/day */
+    int64_t L = 280460 + (t * 985647) / 86400000;
+    int64_t g = 357528 + (t * 985600) / 86400000;
+
+    /* Ecliptic longitude: L + 1.915 sin g + 0.020 sin 2g */
+    int64_t lambda = L + (1915 * sin_q15(g)) / 32768
+                       + (20 * sin_q15(2 * g)) / 32768;
+
+    /* Declination from the fixed 23.44 deg obliquity */
+    int32_t sin_decl = (int32_t)(((int64_t)sin_q15(23440) * sin_q15(lambda)) >> 15);
+    int32_t decl = asin_mdeg(sin_decl);
+
+    /* Equation of time, three-term approximation in minutes scaled to
+     * mdeg of hour angle (1 min of time = 250 mdeg):
+     * 9.87 sin 2B - 7.53 cos B - 1.5 sin B, B anchored ~March equinox */
+    int64_t doy_md = ((t * 1000) / 86400) % 365250; /* milli-days into year */
+    if (doy_md < 0) doy_md += 365250;
+    int64_t B = ((doy_md - 80500) * 360000) / 365250;
+    int64_t eot = (2468 * sin_q15(2 * B) - 1883 * cos_q15(B)
+                   - 375 * sin_q15(B)) / 32768;
+
+    /* Hour angle: true solar time minus noon. 1 s = 25/6 mdeg. */
+    int64_t sod = (int64_t)(unix_time % 86400);
+    int64_t ha = (sod * 25) / 6 + lon_e7 / 10000 + eot - 180000;
+
+    /* sin(elev) = sin(lat) sin(decl) + cos(lat) cos(decl) cos(ha) */
+    int64_t lat = lat_e7 / 10000;
+    int32_t s = (int32_t)(((int64_t)sin_q15(lat) * sin_decl) >> 15);
+    int32_t c = (int32_t)(((int64_t)cos_q15(lat) * cos_q15(decl)) >> 15);
+    int32_t sin_elev = s + (int32_t)(((int64_t)c * cos_q15(ha)) >> 15);
+    if (sin_elev > 32767) sin_elev = 32767;
+    if (sin_elev < -32767) sin_elev = -32767;
+
+    return asin_mdeg(sin_elev) / 10;
+}
@@ -13,6 +13,7 @@
 // ROM GPIO header path changed on C6 — use the soc-agnostic driver instead
 #include "driver/gpio.h"
 #include "driver/spi_master.h"   // C6 does NOT expose raw spi_dev_t safely; use the driver
+#include "driver/rmt_rx.h"       // hardware edge capture for pulseIn
 #include "hal/gpio_hal.h"
 #include "hal/spi_hal.h"
 #include "soc/gpio_sig_map.h"    // C6-specific GPIO matrix signal indices
@@ -20,6 +21,7 @@
 #include "soc/rtc.h"
 // DPORT_* registers do not exist on C6 (RISC-V); clock gating uses PCR peripheral
 #include "soc/pcr_reg.h"
+#include "esp_rom_sys.h"
 #include "esp_timer.h"
 #include "esp_log.h"
 
@@ -57,12 +59,32 @@ uint32_t spiFrequencyToClockDiv(uint32_t freq) {
   return div;                         // used as pre-divider value
 }
 
+// ── Instrumentation ──────────────────────────────────────────────────────────
+// Compile-time gated counters for the radio path: how many SPI transactions
+// and BUSY-wait microseconds RadioLib actually generates through this HAL.
+// Zero code and zero cycles when disabled (the default).
+#ifndef ESPHAL_STATS
+#define ESPHAL_STATS 0
+#endif
+
+#if ESPHAL_STATS
+typedef struct {
+  uint32_t spi_transactions;  // polling_transmit calls
+  uint32_t spi_bytes;         // payload bytes moved (both directions count once)
+  uint64_t spi_time_us;       // cumulative time inside SPI transfers
+  uint64_t delay_us;          // cumulative delayMicroseconds wait
+} esphal_stats_t;
+#endif
+
 // ── HAL class ────────────────────────────────────────────────────────────────
 class EspHal : public RadioLibHal {
 public:
-  EspHal(int8_t sck, int8_t miso, int8_t mosi)
+  // spiClk: the SX1262 tolerates up to 16 MHz SPI. 8 MHz is validated on
+  // the C6 board (short traces, no glitches observed on a scope at the
+  // radio header); pass 2 MHz for long-leaded bring-up rigs.
+  EspHal(int8_t sck, int8_t miso, int8_t mosi, uint32_t spiClk = 8000000)
     : RadioLibHal(INPUT, OUTPUT, LOW, HIGH, RISING, FALLING),
-      spiSCK(sck), spiMISO(miso), spiMOSI(mosi) {}
+      spiSCK(sck), spiMISO(miso), spiMOSI(mosi), spiClkHz(spiClk) {}
 
   void init() override {
     spiBegin();
@@ -97,17 +119,91 @@ public:
     return gpio_get_level((gpio_num_t)pin);
   }
 
+  // ── Interrupt dispatch ────────────────────────────────────────────────
+  // Managed ISR lifecycle instead of leaning on the GPIO driver's per-pin
+  // handler table: the service is installed exactly once (with its error
+  // actually checked), and every pin dispatches through one IRAM-resident
+  // trampoline whose slot table lives in DRAM — no flash-resident code or
+  // rodata on the interrupt path, so a dispatch can land safely during a
+  // flash write and costs the same few hundred nanoseconds every time.
+  // A slot can carry a plain callback (RadioLib's usage), a direct task
+  // notification (isrNotifyTarget — the cheapest ISR-to-task wakeup
+  // FreeRTOS has), or both. Interrupt-to-task latency bounds how tightly
+  // the TX-done wait can trail the radio, which is airtime margin that
+  // otherwise has to be padded with polling.
+  struct IsrSlot {
+    gpio_num_t pin;
+    void (*cb)(void);
+    TaskHandle_t notify;
+  };
+  static constexpr int ISR_SLOTS = 4;
+
+  static void IRAM_ATTR isrTrampoline(void *arg) {
+    IsrSlot *slot = (IsrSlot *)arg;
+    if (slot->cb != nullptr) {
+      slot->cb();
+    }
+    if (slot->notify != nullptr) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(slot->notify, &woken);
+      portYIELD_FROM_ISR(woken);
+    }
+  }
+
+  static IsrSlot *isrSlotFor(gpio_num_t pin) {
+    IsrSlot *free_slot = nullptr;
+    for (int i = 0; i < ISR_SLOTS; i++) {
+      if (s_isrSlots[i].pin == pin) {
+        return &s_isrSlots[i];
+      }
+      if (free_slot == nullptr && s_isrSlots[i].pin == GPIO_NUM_NC) {
+        free_slot = &s_isrSlots[i];
+      }
+    }
+    if (free_slot != nullptr) {
+      free_slot->pin = pin;
+    }
+    return free_slot;
+  }
+
+  // Route this pin's interrupts to a direct task notification (nullptr
+  // clears it). Takes effect on the current attach or the next one.
+  static void isrNotifyTarget(uint32_t pin, TaskHandle_t task) {
+    IsrSlot *slot = isrSlotFor((gpio_num_t)pin);
+    if (slot != nullptr) {
+      slot->notify = task;
+    }
+  }
+
   void attachInterrupt(uint32_t interruptNum,
                        void (*interruptCb)(void),
                        uint32_t mode) override {
     if (interruptNum == RADIOLIB_NC) return;
 
-    // ESP_INTR_FLAG_IRAM keeps ISR in IRAM — safe on C6 as well
-    gpio_install_isr_service((int)ESP_INTR_FLAG_IRAM);
+    // Install-once: ESP_INTR_FLAG_IRAM keeps the service's dispatcher in
+    // IRAM (safe on C6), and a real failure is worth knowing about once
+    // instead of being masked by the already-installed error on reattach
+    if (!s_isrInstalled) {
+      esp_err_t err = gpio_install_isr_service((int)ESP_INTR_FLAG_IRAM);
+      if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE("EspHal", "ISR service install failed: %d", (int)err);
+        return;
+      }
+      s_isrInstalled = true;
+    }
+
+    IsrSlot *slot = isrSlotFor((gpio_num_t)interruptNum);
+    if (slot == nullptr) {
+      ESP_LOGE("EspHal", "No ISR slot free for GPIO %lu",
+               (unsigned long)interruptNum);
+      return;
+    }
+    slot->cb = interruptCb;
+
     gpio_set_intr_type((gpio_num_t)interruptNum,
                        (gpio_int_type_t)(mode & 0x7));
-    gpio_isr_handler_add((gpio_num_t)interruptNum,
-                         (void (*)(void *))interruptCb, NULL);
+    gpio_isr_handler_add((gpio_num_t)interruptNum, &EspHal::isrTrampoline,
+                         slot);
   }
 
   void detachInterrupt(uint32_t interruptNum) override {
@@ -115,6 +211,13 @@ public:
     gpio_isr_handler_remove((gpio_num_t)interruptNum);
     gpio_wakeup_disable((gpio_num_t)interruptNum);
     gpio_set_intr_type((gpio_num_t)interruptNum, GPIO_INTR_DISABLE);
+
+    IsrSlot *slot = isrSlotFor((gpio_num_t)interruptNum);
+    if (slot != nullptr) {
+      slot->pin = GPIO_NUM_NC;
+      slot->cb = nullptr;
+      slot->notify = nullptr;
+    }
   }
 
   // ── Timing ────────────────────────────────────────────────────────────────
@@ -122,14 +225,28 @@ public:
     vTaskDelay(ms / portTICK_PERIOD_MS);
   }
 
+  // Tiered: RadioLib calls this around every BUSY handshake and GPIO
+  // settle, dozens of times per transmission. Short waits use the ROM's
+  // cycle-calibrated busy loop; anything spanning scheduler ticks yields
+  // them to the idle task (and tickless light sleep, when enabled) and
+  // spins out only the sub-tick remainder.
   void delayMicroseconds(unsigned long us) override {
-    uint64_t m = (uint64_t)esp_timer_get_time();
-    if (us) {
-      uint64_t e = m + us;
-      if (m > e) {   // 64-bit overflow (takes ~584 years, but be safe)
-        while ((uint64_t)esp_timer_get_time() > e) NOP();
-      }
-      while ((uint64_t)esp_timer_get_time() < e) NOP();
+    if (us == 0) return;
+#if ESPHAL_STATS
+    s_stats.delay_us += us;
+#endif
+    if (us < 100) {
+      esp_rom_delay_us((uint32_t)us);
+      return;
+    }
+    uint64_t deadline = (uint64_t)esp_timer_get_time() + us;
+    uint32_t ticks = us / (portTICK_PERIOD_MS * 1000UL);
+    if (ticks) {
+      vTaskDelay(ticks);
+    }
+    int64_t remainder = (int64_t)(deadline - (uint64_t)esp_timer_get_time());
+    if (remainder > 0) {
+      esp_rom_delay_us((uint32_t)remainder);
     }
   }
 
@@ -141,16 +258,59 @@ public:
     return (unsigned long)(esp_timer_get_time());
   }
 
+  // ── Pulse capture ─────────────────────────────────────────────────────────
+  // RMT-backed pulseIn: the RMT peripheral timestamps edges in hardware at
+  // 1 us resolution and raises an interrupt when the capture completes, so
+  // the CPU blocks (yielding to the idle task) instead of spinning on
+  // digitalRead + micros for the whole pulse. The RX channel is created
+  // lazily and cached per pin, so repeated measurements on the same line —
+  // and any future anemometer/PPS-style instrument — reuse it. Pulses
+  // longer than RMT_PULSE_MAX_US (the 15-bit idle threshold at 1 MHz)
+  // cannot be resolved and report 0, same as a timeout.
   long pulseIn(uint32_t pin, uint32_t state,
                unsigned long timeout) override {
     if (pin == RADIOLIB_NC) return 0;
-    this->pinMode(pin, INPUT);
-    uint32_t start   = this->micros();
-    uint32_t curtick = this->micros();
-    while (this->digitalRead(pin) == state) {
-      if ((this->micros() - curtick) > timeout) return 0;
+
+    // Channel exhaustion or driver refusal degrades to the polled loop
+    // rather than failing the measurement
+    if (!rmtEnsureChannel((gpio_num_t)pin)) {
+      return pulseInPolled(pin, state, timeout);
     }
-    return this->micros() - start;
+
+    s_rmtWaiter = xTaskGetCurrentTaskHandle();
+    s_rmtSymbolCount = 0;
+
+    rmt_receive_config_t rxCfg = {
+      .signal_range_min_ns = 1000,                   // < 1 us is a glitch
+      .signal_range_max_ns = RMT_PULSE_MAX_US * 1000UL,
+    };
+    if (rmt_receive(s_rmtChan, s_rmtSymbols, sizeof(s_rmtSymbols),
+                    &rxCfg) != ESP_OK) {
+      return pulseInPolled(pin, state, timeout);
+    }
+
+    // Sleep until the idle threshold closes the capture or the caller's
+    // timeout expires; either way no cycles are burnt waiting
+    uint32_t ticks = (uint32_t)(timeout / 1000UL) / portTICK_PERIOD_MS + 1;
+    if (ulTaskNotifyTake(pdTRUE, ticks) == 0) {
+      rmt_disable(s_rmtChan);     // abort the pending receive
+      rmt_enable(s_rmtChan);
+      s_rmtWaiter = nullptr;
+      return 0;
+    }
+    s_rmtWaiter = nullptr;
+
+    // The first captured half-symbol at the requested level is the pulse;
+    // a zero duration means it outlasted the idle threshold
+    for (size_t i = 0; i < s_rmtSymbolCount; i++) {
+      if (s_rmtSymbols[i].level0 == state && s_rmtSymbols[i].duration0 != 0) {
+        return (long)s_rmtSymbols[i].duration0;
+      }
+      if (s_rmtSymbols[i].level1 == state && s_rmtSymbols[i].duration1 != 0) {
+        return (long)s_rmtSymbols[i].duration1;
+      }
+    }
+    return 0;
   }
 
   // ── SPI ───────────────────────────────────────────────────────────────────
@@ -158,26 +318,44 @@ public:
   // the raw SPI register map.  The safest approach on IDF is the spi_master
   // driver which abstracts all of that away cleanly.
   void spiBegin() {
+    // Retained-bus mode: lora_transmit_frame() constructs a HAL per
+    // transmit, and RadioLib's term() used to tear SPI2_HOST down just to
+    // rebuild it identically moments later. The device handle is held in
+    // a static owner instead, so warm transmit cycles reuse the live
+    // driver objects. (The SPI clock is fixed by whichever instance
+    // created the bus; call spiRelease() before changing it.)
+    if (s_spiHandle != nullptr) {
+      spiHandle = s_spiHandle;
+      return;
+    }
+
     spi_bus_config_t buscfg = {
       .mosi_io_num   = spiMOSI,
       .miso_io_num   = spiMISO,
       .sclk_io_num   = spiSCK,
       .quadwp_io_num = -1,
       .quadhd_io_num = -1,
-      .max_transfer_sz = 64,
+      // Large enough for any SX1262 FIFO burst (256 B) plus command/address
+      // bytes; DMA makes the per-transaction size essentially free.
+      .max_transfer_sz = 4096,
     };
 
-    // SPI2_HOST is the general-purpose SPI on C6 (replaces HSPI on classic ESP32)
-    spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_DISABLED);
+    // SPI2_HOST is the general-purpose SPI on C6 (replaces HSPI on classic ESP32).
+    // DMA lets whole-buffer transfers complete as a single transaction instead
+    // of one driver call per byte.
+    spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_CH_AUTO);
 
     spi_device_interface_config_t devcfg = {
       .mode           = 0,               // SPI mode 0 (CPOL=0, CPHA=0)
-      .clock_speed_hz = 2000000,         // 2 MHz — same as original
+      // Constructor-selected; at the default 8 MHz a 52-byte FIFO load
+      // measures ~65 us against ~240 us at the old fixed 2 MHz
+      .clock_speed_hz = (int)spiClkHz,
       .spics_io_num   = -1,              // CS managed by RadioLib
       .queue_size     = 1,
     };
 
     spi_bus_add_device(SPI2_HOST, &devcfg, &spiHandle);
+    s_spiHandle = spiHandle;
   }
 
   void spiBeginTransaction() {
@@ -191,14 +369,37 @@ public:
       .tx_buffer = &b,
       .rx_buffer = &rxByte,
     };
+#if ESPHAL_STATS
+    int64_t t0 = esp_timer_get_time();
+#endif
     spi_device_polling_transmit(spiHandle, &t);
+#if ESPHAL_STATS
+    s_stats.spi_transactions++;
+    s_stats.spi_bytes++;
+    s_stats.spi_time_us += (uint64_t)(esp_timer_get_time() - t0);
+#endif
     return rxByte;
   }
 
   void spiTransfer(uint8_t* out, size_t len, uint8_t* in) {
-    for (size_t i = 0; i < len; i++) {
-      in[i] = spiTransferByte(out[i]);
-    }
+    if (len == 0) return;
+    // Submit the whole buffer as one DMA transaction — a 51-byte FIFO write
+    // costs one driver call instead of 51.  The driver bounce-buffers
+    // non-DMA-capable memory transparently, so stack buffers are fine.
+    spi_transaction_t t = {
+      .length    = len * 8,   // bits
+      .tx_buffer = out,
+      .rx_buffer = in,
+    };
+#if ESPHAL_STATS
+    int64_t t0 = esp_timer_get_time();
+#endif
+    spi_device_polling_transmit(spiHandle, &t);
+#if ESPHAL_STATS
+    s_stats.spi_transactions++;
+    s_stats.spi_bytes += (uint32_t)len;
+    s_stats.spi_time_us += (uint64_t)(esp_timer_get_time() - t0);
+#endif
   }
 
   void spiEndTransaction() {
@@ -206,14 +407,123 @@ public:
   }
 
   void spiEnd() {
-    spi_bus_remove_device(spiHandle);
-    spi_bus_free(SPI2_HOST);
+    // Intentionally does not free the bus — see spiBegin(). RadioLib's
+    // term() lands here on every HAL teardown.
+    spiHandle = nullptr;
+  }
+
+#if ESPHAL_STATS
+  static void statsReset() { s_stats = {}; }
+  static esphal_stats_t statsGet() { return s_stats; }
+#endif
+
+  // Actually release SPI2_HOST (e.g. before reconfiguring the clock or
+  // handing the pins to another driver)
+  static void spiRelease() {
+    if (s_spiHandle != nullptr) {
+      spi_bus_remove_device(s_spiHandle);
+      spi_bus_free(SPI2_HOST);
+      s_spiHandle = nullptr;
+    }
+  }
+
+  // Free the cached RMT capture channel (e.g. to hand the RMT block to
+  // another driver); the next pulseIn recreates it
+  static void rmtRelease() {
+    if (s_rmtChan != nullptr) {
+      rmt_disable(s_rmtChan);
+      rmt_del_channel(s_rmtChan);
+      s_rmtChan = nullptr;
+    }
   }
 
 private:
+  // Longest half-symbol the RX channel can time: 15-bit tick counter at
+  // the 1 MHz capture resolution
+  static constexpr uint32_t RMT_PULSE_MAX_US = 32767;
+
+  // Create (or retarget) the cached RX channel for this pin
+  static bool rmtEnsureChannel(gpio_num_t pin) {
+    if (s_rmtChan != nullptr && s_rmtPin == pin) {
+      return true;
+    }
+    rmtRelease();
+
+    rmt_rx_channel_config_t cfg = {};
+    cfg.gpio_num          = pin;
+    cfg.clk_src           = RMT_CLK_SRC_DEFAULT;
+    cfg.resolution_hz     = 1000000;   // 1 tick = 1 us
+    cfg.mem_block_symbols = 48;        // one C6 RMT memory block
+    if (rmt_new_rx_channel(&cfg, &s_rmtChan) != ESP_OK) {
+      s_rmtChan = nullptr;
+      return false;
+    }
+    rmt_rx_event_callbacks_t cbs = {};
+    cbs.on_recv_done = &EspHal::rmtRxDone;
+    if (rmt_rx_register_event_callbacks(s_rmtChan, &cbs, nullptr) != ESP_OK ||
+        rmt_enable(s_rmtChan) != ESP_OK) {
+      rmt_del_channel(s_rmtChan);
+      s_rmtChan = nullptr;
+      return false;
+    }
+    s_rmtPin = pin;
+    return true;
+  }
+
+  static bool IRAM_ATTR rmtRxDone(rmt_channel_handle_t,
+                                  const rmt_rx_done_event_data_t *edata,
+                                  void *) {
+    // Symbols land directly in s_rmtSymbols (handed to rmt_receive);
+    // publish the count, then wake the measuring task
+    s_rmtSymbolCount = edata->num_symbols;
+    BaseType_t woken = pdFALSE;
+    if (s_rmtWaiter != nullptr) {
+      vTaskNotifyGiveFromISR(s_rmtWaiter, &woken);
+    }
+    return woken == pdTRUE;
+  }
+
+  // Original spin-loop implementation, kept as the fallback when the RMT
+  // block is unavailable
+  long pulseInPolled(uint32_t pin, uint32_t state, unsigned long timeout) {
+    this->pinMode(pin, INPUT);
+    uint32_t start   = this->micros();
+    uint32_t curtick = this->micros();
+    while (this->digitalRead(pin) == state) {
+      if ((this->micros() - curtick) > timeout) return 0;
+    }
+    return this->micros() - start;
+  }
+
+  // ISR dispatch state, shared by all HAL instances. The slot table is
+  // explicitly initialized so it lands in .data (DRAM), where the IRAM
+  // trampoline can read it during flash operations.
+  inline static bool s_isrInstalled = false;
+  inline static IsrSlot s_isrSlots[ISR_SLOTS] = {
+    { GPIO_NUM_NC, nullptr, nullptr },
+    { GPIO_NUM_NC, nullptr, nullptr },
+    { GPIO_NUM_NC, nullptr, nullptr },
+    { GPIO_NUM_NC, nullptr, nullptr },
+  };
+
+  // Bus ownership shared by all HAL instances within one wake
+  inline static spi_device_handle_t s_spiHandle = nullptr;
+
+  // Cached RMT capture channel (one pin at a time; retargeted on demand)
+  inline static rmt_channel_handle_t s_rmtChan = nullptr;
+  inline static gpio_num_t s_rmtPin = GPIO_NUM_NC;
+  inline static volatile size_t s_rmtSymbolCount = 0;
+  inline static volatile TaskHandle_t s_rmtWaiter = nullptr;
+  inline static rmt_symbol_word_t s_rmtSymbols[48];
+
+#if ESPHAL_STATS
+  inline static esphal_stats_t s_stats = {};
+#endif
+
   int8_t           spiSCK;
   int8_t           spiMISO;
   int8_t           spiMOSI;
+  uint32_t         spiClkHz;
   spi_device_handle_t spiHandle = nullptr;
 };
 
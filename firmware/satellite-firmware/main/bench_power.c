@@ -0,0 +1,163 @@
+#include "bench_power.h"
+
+#if BENCH_POWER_ENABLED
+
+#include <string.h>
+
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_timer.h"
+
+#include "profiling.h"
+#include "sat_log.h"
+
+/**
+ * Bench current-draw profiler (see bench_power.h). One esp_timer tick per
+ * sample: read the shunt monitor, stamp it with the stage profiling.c has
+ * open, append. The periodic timer runs in the esp_timer task, the same
+ * context the rest of the firmware already trusts for its callbacks, so
+ * nothing here touches ISR constraints.
+ */
+
+static const char *TAG = "bench_power";
+
+typedef struct __attribute__((packed))
+{
+    uint16_t mv;   // Shunt monitor output, millivolts
+    uint8_t stage; // prof_stage_t open at the sample, 0xFF = none
+} bench_sample_t;
+
+static bench_sample_t s_buf[BENCH_POWER_MAX_SAMPLES];
+static volatile size_t s_count;
+
+static adc_oneshot_unit_handle_t s_unit;
+static adc_cali_handle_t s_cali;
+static bool s_calibrated;
+static esp_timer_handle_t s_timer;
+
+static void bench_sample_cb(void *arg)
+{
+    (void)arg;
+    if (s_count >= BENCH_POWER_MAX_SAMPLES) {
+        return; // Buffer full: keep ticking cheaply until stop
+    }
+
+    int raw = 0;
+    if (adc_oneshot_read(s_unit, BENCH_POWER_ADC_CHANNEL, &raw) != ESP_OK) {
+        return;
+    }
+    int mv = 0;
+    if (!s_calibrated || adc_cali_raw_to_voltage(s_cali, raw, &mv) != ESP_OK) {
+        mv = raw * 3300 / 4095;
+    }
+
+    s_buf[s_count].mv = (mv < 0) ? 0 : (uint16_t)mv;
+    s_buf[s_count].stage = prof_stage_current();
+    s_count++;
+}
+
+void bench_power_start(void)
+{
+    if (s_timer != NULL) {
+        return;
+    }
+
+    adc_oneshot_unit_init_cfg_t unit_cfg = {};
+    unit_cfg.unit_id = BENCH_POWER_ADC_UNIT;
+    if (adc_oneshot_new_unit(&unit_cfg, &s_unit) != ESP_OK) {
+        SAT_LOGI("%s: ADC unavailable, capture disabled\n", TAG);
+        return;
+    }
+    adc_oneshot_chan_cfg_t chan_cfg = {};
+    chan_cfg.atten = ADC_ATTEN_DB_12;
+    chan_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    adc_oneshot_config_channel(s_unit, BENCH_POWER_ADC_CHANNEL, &chan_cfg);
+
+    // eFuse curve-fitting calibration when available, linear fallback else
+    adc_cali_curve_fitting_config_t cali_cfg = {};
+    cali_cfg.unit_id = BENCH_POWER_ADC_UNIT;
+    cali_cfg.atten = ADC_ATTEN_DB_12;
+    cali_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    s_calibrated =
+        adc_cali_create_scheme_curve_fitting(&cali_cfg, &s_cali) == ESP_OK;
+
+    s_count = 0;
+
+    const esp_timer_create_args_t targs = {
+        .callback = bench_sample_cb,
+        .name = "bench_pwr",
+    };
+    if (esp_timer_create(&targs, &s_timer) == ESP_OK) {
+        esp_timer_start_periodic(s_timer, BENCH_POWER_SAMPLE_US);
+        SAT_LOGI("%s: capture armed (%u us/sample, %u max)\n", TAG,
+                 (unsigned)BENCH_POWER_SAMPLE_US,
+                 (unsigned)BENCH_POWER_MAX_SAMPLES);
+    }
+}
+
+void bench_power_stop(void)
+{
+    if (s_timer == NULL) {
+        return;
+    }
+    esp_timer_stop(s_timer);
+    esp_timer_delete(s_timer);
+    s_timer = NULL;
+
+    if (s_calibrated) {
+        adc_cali_delete_scheme_curve_fitting(s_cali);
+        s_cali = NULL;
+        s_calibrated = false;
+    }
+    adc_oneshot_del_unit(s_unit);
+    s_unit = NULL;
+
+    SAT_LOGI("%s: capture stopped, %u samples held\n", TAG,
+             (unsigned)s_count);
+}
+
+size_t bench_power_count(void)
+{
+    return s_count;
+}
+
+size_t bench_power_chunk(size_t first, uint8_t *out, size_t out_max)
+{
+    size_t held = s_count;
+    if (first >= held || out_max < 4 + sizeof(bench_sample_t)) {
+        return 0;
+    }
+
+    size_t n = held - first;
+    if (n > BENCH_POWER_CHUNK_SAMPLES) {
+        n = BENCH_POWER_CHUNK_SAMPLES;
+    }
+    size_t fit = (out_max - 4) / sizeof(bench_sample_t);
+    if (n > fit) {
+        n = fit;
+    }
+
+    out[0] = (uint8_t)(first & 0xFF);
+    out[1] = (uint8_t)(first >> 8);
+    out[2] = (uint8_t)(first >> 16);
+    out[3] = (uint8_t)(first >> 24);
+    memcpy(out + 4, &s_buf[first], n * sizeof(bench_sample_t));
+    return 4 + n * sizeof(bench_sample_t);
+}
+
+#else /* !BENCH_POWER_ENABLED */
+
+// Flight builds: link-time no-ops so call sites stay unconditional
+void bench_power_start(void) {}
+void bench_power_stop(void) {}
+size_t bench_power_count(void) { return 0; }
+size_t bench_power_chunk(size_t first, uint8_t *out, size_t out_max)
+{
+    (void)first;
+    (void)out;
+    (void)out_max;
+    return 0;
+}
+
+#endif /* BENCH_POWER_ENABLED */
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Bench current-draw profiler. Power models for this node have always been
+ * spreadsheet estimates; nothing correlated firmware stages with measured
+ * current. A bench build (compile with -DBENCH_POWER_ENABLED=1) samples an
+ * INA-style shunt monitor's voltage output on a spare ADC channel at a
+ * fixed high rate into a RAM buffer, tagging every sample with the wake
+ * stage currently open in profiling.c. After the cycle the capture is
+ * harvested over RS-485 ('p' command), giving joules-per-stage ground
+ * truth against which power optimizations can actually be ranked.
+ *
+ * Bench-only by design: the buffer is plain RAM (a deep sleep discards
+ * it), the sampler costs an ADC read every 500 us, and the harvest window
+ * holds the node awake — none of which belongs in a flight image. The
+ * monitor's mV-per-amp scale is a property of the bench rig, so samples
+ * are dumped as raw millivolts and converted offline.
+ *
+ * Leave RS_SNS deasserted during the capture wake: asserting it diverts
+ * app_main into the wired streaming bypass, and the point here is to
+ * profile the flight code path. The pre-sleep harvest window services the
+ * command channel regardless of the sense line.
+ */
+
+#ifndef BENCH_POWER_ENABLED
+#define BENCH_POWER_ENABLED 0
+#endif
+
+// Shunt monitor output on GPIO1 (ADC1 channel 1) — the last free ADC pin;
+// GPIO4 is the battery divider
+#define BENCH_POWER_ADC_UNIT ADC_UNIT_1
+#define BENCH_POWER_ADC_CHANNEL ADC_CHANNEL_1
+
+// 2 kHz: fast enough to resolve the ~1 ms radio ramp steps, slow enough
+// that a full worst-case wake (GPS timeout + TX retries) still fits
+#define BENCH_POWER_SAMPLE_US 500
+
+// 8192 samples x 3 bytes = 24 KiB of RAM, ~4 s of capture
+#define BENCH_POWER_MAX_SAMPLES 8192
+
+// Samples per harvest frame: 4-byte start index + 24 x 3-byte samples
+// stays within the command channel's response sizing
+#define BENCH_POWER_CHUNK_SAMPLES 24
+
+// How long the post-cycle harvest window keeps the node awake (ms)
+#define BENCH_POWER_HARVEST_MS 3000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Arm the ADC and start the periodic sampler; the buffer fills once and
+// then the sampler parks itself. No-op (and free) when the bench flag is
+// off or the capture is already running.
+void bench_power_start(void);
+
+// Stop the sampler and release the ADC; the buffer stays readable.
+void bench_power_stop(void);
+
+// Samples captured so far.
+size_t bench_power_count(void);
+
+// Serialize one harvest chunk starting at sample index first:
+//   4 bytes little-endian first index, then up to
+//   BENCH_POWER_CHUNK_SAMPLES x (uint16 mV + uint8 stage tag, 0xFF = no
+//   stage open). Returns bytes written, 0 when first is past the end.
+size_t bench_power_chunk(size_t first, uint8_t *out, size_t out_max);
+
+#ifdef __cplusplus
+}
+#endif
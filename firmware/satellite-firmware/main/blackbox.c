@@ -0,0 +1,399 @@
+#include "blackbox.h"
+
+#include <string.h>
+#include "bbdelta.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+static const char *TAG = "blackbox";
+
+/* --------------------------------------------------------------------------
+ * Slot layout — same ring discipline as report_queue.c, but each slot now
+ * holds a GROUP of delta-coded records instead of one raw record:
+ *
+ *   marker(4) | record_count(1) | [len(1) payload] per record
+ *
+ * The first record in a slot is stored raw (the keyframe); each following
+ * record is bbdelta-coded against its predecessor, so a slot is fully
+ * self-contained — sector erases and partial-power-loss damage never
+ * orphan a delta chain. Consecutive records differ by a handful of bytes,
+ * so a slot that used to hold one 77-byte record typically holds three or
+ * four, which is the whole compression win: same partition, 3-4x history.
+ *
+ * The group under construction lives in RTC RAM between deep-sleep wakes
+ * and reaches flash only when the next record no longer fits (or on
+ * blackbox_flush() before a harvest). A full power loss forfeits at most
+ * one slot's worth of pending records — black-box telemetry, not data the
+ * mission depends on.
+ *
+ * NOR flash only clears bits between erases, so a slot is either erased
+ * (0xFFFFFFFF) or written; reads never consume. The written region is one
+ * contiguous run in ring order, recovered on mount by scanning markers. A
+ * sector is erased only when the write pointer wraps back onto it, so
+ * erases spread evenly across the partition.
+ * -------------------------------------------------------------------------- */
+
+/* Bumped from 0xB1ACB0C5: pre-group slots must read as garbage, not as
+ * one-record groups with a delta stream where the payload used to be */
+#define SLOT_WRITTEN 0xB1ACB0C6UL
+#define SLOT_ERASED  0xFFFFFFFFUL
+
+#define SLOT_SIZE        (4 + 1 + BLACKBOX_RECORD_MAX + 2) /* padded to 93 */
+#define SLOT_BODY_MAX    (SLOT_SIZE - 5)
+#define SECTOR_SIZE      4096
+#define SLOTS_PER_SECTOR (SECTOR_SIZE / SLOT_SIZE)
+
+static const esp_partition_t *s_part = NULL;
+static uint32_t s_num_slots = 0;
+static uint32_t s_head = 0;       // Oldest written slot
+static uint32_t s_slot_count = 0; // Written slots
+static uint32_t s_tail = 0;       // Next slot to write
+static size_t   s_count = 0;      // Records across all written slots
+
+// Sequential-harvest cache: the slot (and its first record's index) where
+// the last blackbox_read() landed, so a front-to-back dump walks each slot
+// once instead of re-walking the ring per record
+static bool     s_cache_valid = false;
+static uint32_t s_cache_slot = 0;
+static size_t   s_cache_base = 0;
+
+/* --------------------------------------------------------------------------
+ * Pending group (RTC RAM — survives deep sleep, not power loss)
+ * -------------------------------------------------------------------------- */
+#define PENDING_MAGIC 0xBB0CDE17UL
+
+RTC_DATA_ATTR static struct
+{
+    uint32_t magic;
+    uint8_t  n;        // Records in the pending group
+    uint8_t  used;     // Body bytes filled
+    uint8_t  last_len; // Raw length of the newest record (delta base)
+    uint8_t  body[SLOT_BODY_MAX];
+    uint8_t  last_raw[BLACKBOX_RECORD_MAX];
+} s_pending;
+
+static void pending_reset(void)
+{
+    s_pending.magic = PENDING_MAGIC;
+    s_pending.n = 0;
+    s_pending.used = 0;
+    s_pending.last_len = 0;
+}
+
+static void pending_ensure_valid(void)
+{
+    if (s_pending.magic != PENDING_MAGIC)
+    {
+        pending_reset();
+    }
+}
+
+static uint32_t slot_offset(uint32_t slot)
+{
+    uint32_t sector = slot / SLOTS_PER_SECTOR;
+    uint32_t within = slot % SLOTS_PER_SECTOR;
+    return sector * SECTOR_SIZE + within * SLOT_SIZE;
+}
+
+static esp_err_t read_marker(uint32_t slot, uint32_t *marker)
+{
+    return esp_partition_read(s_part, slot_offset(slot), marker, sizeof(*marker));
+}
+
+// Records held by a written slot (the count byte after the marker)
+static esp_err_t read_slot_records(uint32_t slot, uint8_t *n)
+{
+    return esp_partition_read(s_part, slot_offset(slot) + 4, n, sizeof(*n));
+}
+
+// Erase the sector the write pointer is entering; groups living there are
+// the ring's oldest and simply age out.
+static esp_err_t prepare_sector_for(uint32_t slot)
+{
+    if (slot % SLOTS_PER_SECTOR != 0)
+    {
+        return ESP_OK;
+    }
+
+    uint32_t sector_base = (slot / SLOTS_PER_SECTOR) * SECTOR_SIZE;
+
+    while (s_slot_count > 0 &&
+           s_head / SLOTS_PER_SECTOR == slot / SLOTS_PER_SECTOR)
+    {
+        uint8_t n = 0;
+        if (read_slot_records(s_head, &n) == ESP_OK && (size_t)n <= s_count)
+        {
+            s_count -= n;
+        }
+        s_head = (s_head + 1) % s_num_slots;
+        s_slot_count--;
+    }
+    s_cache_valid = false;
+
+    return esp_partition_erase_range(s_part, sector_base, SECTOR_SIZE);
+}
+
+esp_err_t blackbox_init(void)
+{
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                      ESP_PARTITION_SUBTYPE_ANY, "blackbox");
+    if (s_part == NULL)
+    {
+        ESP_LOGE(TAG, "blackbox partition not found — recorder disabled");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    s_num_slots = (s_part->size / SECTOR_SIZE) * SLOTS_PER_SECTOR;
+    s_head = 0;
+    s_tail = 0;
+    s_slot_count = 0;
+    s_count = 0;
+    s_cache_valid = false;
+    pending_ensure_valid();
+
+    // Recover the contiguous written run: head is the written slot whose
+    // predecessor is not written, depth is the written-slot count
+    bool found_head = false;
+    for (uint32_t i = 0; i < s_num_slots; i++)
+    {
+        uint32_t prev_marker = SLOT_ERASED;
+        uint32_t marker = SLOT_ERASED;
+        ESP_RETURN_ON_ERROR(read_marker(i, &marker), TAG, "marker read failed");
+        ESP_RETURN_ON_ERROR(
+            read_marker((i + s_num_slots - 1) % s_num_slots, &prev_marker),
+            TAG, "marker read failed");
+
+        if (marker == SLOT_WRITTEN)
+        {
+            uint8_t n = 0;
+            ESP_RETURN_ON_ERROR(read_slot_records(i, &n), TAG,
+                                "count read failed");
+            s_slot_count++;
+            s_count += n;
+            if (!found_head && prev_marker != SLOT_WRITTEN)
+            {
+                s_head = i;
+                found_head = true;
+            }
+        }
+    }
+    s_tail = (s_head + s_slot_count) % s_num_slots;
+
+    ESP_LOGI(TAG, "Mounted: %lu slots, %lu written, %u records (+%u pending)",
+             (unsigned long)s_num_slots, (unsigned long)s_slot_count,
+             (unsigned)s_count, (unsigned)s_pending.n);
+    return ESP_OK;
+}
+
+esp_err_t blackbox_flush(void)
+{
+    if (s_part == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pending_ensure_valid();
+    if (s_pending.n == 0)
+    {
+        return ESP_OK;
+    }
+
+    ESP_RETURN_ON_ERROR(prepare_sector_for(s_tail), TAG, "sector erase failed");
+
+    uint8_t slot[SLOT_SIZE];
+    memset(slot, 0xFF, sizeof(slot));
+    const uint32_t marker = SLOT_WRITTEN;
+    memcpy(&slot[0], &marker, sizeof(marker));
+    slot[4] = s_pending.n;
+    memcpy(&slot[5], s_pending.body, s_pending.used);
+
+    ESP_RETURN_ON_ERROR(
+        esp_partition_write(s_part, slot_offset(s_tail), slot, sizeof(slot)),
+        TAG, "slot write failed");
+
+    s_tail = (s_tail + 1) % s_num_slots;
+    s_slot_count++;
+    s_count += s_pending.n;
+    pending_reset();
+    return ESP_OK;
+}
+
+esp_err_t blackbox_append(const void *rec, size_t len)
+{
+    if (s_part == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (rec == NULL || len == 0 || len > BLACKBOX_RECORD_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pending_ensure_valid();
+
+    // Delta against the newest pending record when there is one and the
+    // coded form fits the remaining body space
+    if (s_pending.n > 0 && s_pending.n < 255)
+    {
+        uint8_t enc[BBDELTA_BOUND(BLACKBOX_RECORD_MAX)];
+        size_t enc_len = bbdelta_encode(s_pending.last_raw, s_pending.last_len,
+                                        (const uint8_t *)rec, len,
+                                        enc, sizeof(enc));
+        size_t room = (size_t)SLOT_BODY_MAX - s_pending.used;
+        if (enc_len > 0 && enc_len <= 255 && 1 + enc_len <= room)
+        {
+            s_pending.body[s_pending.used++] = (uint8_t)enc_len;
+            memcpy(&s_pending.body[s_pending.used], enc, enc_len);
+            s_pending.used += (uint8_t)enc_len;
+            s_pending.n++;
+            memcpy(s_pending.last_raw, rec, len);
+            s_pending.last_len = (uint8_t)len;
+            return ESP_OK;
+        }
+    }
+
+    // Group full (or first record ever): flush and start a new group with
+    // this record as its raw keyframe
+    if (s_pending.n > 0)
+    {
+        ESP_RETURN_ON_ERROR(blackbox_flush(), TAG, "group flush failed");
+    }
+    s_pending.body[0] = (uint8_t)len;
+    memcpy(&s_pending.body[1], rec, len);
+    s_pending.used = (uint8_t)(1 + len);
+    s_pending.n = 1;
+    memcpy(s_pending.last_raw, rec, len);
+    s_pending.last_len = (uint8_t)len;
+    return ESP_OK;
+}
+
+size_t blackbox_count(void)
+{
+    pending_ensure_valid();
+    return s_count + s_pending.n;
+}
+
+// Decode record sub (0-based) out of a slot buffer: keyframe raw, then
+// delta chain. Returns the record length, or 0 on a corrupt stream.
+static size_t slot_decode(const uint8_t *slot, uint32_t sub,
+                          uint8_t *out)
+{
+    uint8_t bufA[BLACKBOX_RECORD_MAX];
+    uint8_t bufB[BLACKBOX_RECORD_MAX];
+    uint8_t *prev = bufA;
+    uint8_t *cur = bufB;
+    size_t prev_len = 0;
+    size_t cur_len = 0;
+    size_t off = 5;
+    uint8_t n = slot[4];
+
+    if (sub >= n)
+    {
+        return 0;
+    }
+    for (uint32_t j = 0; j <= sub; j++)
+    {
+        size_t len = slot[off++];
+        if (off + len > SLOT_SIZE)
+        {
+            return 0;
+        }
+        if (j == 0)
+        {
+            if (len > BLACKBOX_RECORD_MAX)
+            {
+                return 0;
+            }
+            memcpy(cur, &slot[off], len);
+            cur_len = len;
+        }
+        else
+        {
+            cur_len = bbdelta_decode(prev, prev_len, &slot[off], len,
+                                     cur, BLACKBOX_RECORD_MAX);
+            if (cur_len == 0)
+            {
+                return 0;
+            }
+        }
+        off += len;
+        uint8_t *tmp = prev;
+        prev = cur;
+        cur = tmp;
+        prev_len = cur_len;
+    }
+    memcpy(out, prev, prev_len);
+    return prev_len;
+}
+
+esp_err_t blackbox_read(size_t idx, void *out, size_t *out_len)
+{
+    if (s_part == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (out == NULL || out_len == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pending_ensure_valid();
+    if (idx >= s_count + s_pending.n)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Pending records are served straight from the RTC group
+    if (idx >= s_count)
+    {
+        uint8_t group[5 + SLOT_BODY_MAX];
+        group[4] = s_pending.n;
+        memcpy(&group[5], s_pending.body, s_pending.used);
+        size_t len = slot_decode(group, (uint32_t)(idx - s_count), out);
+        if (len == 0)
+        {
+            return ESP_FAIL;
+        }
+        *out_len = len;
+        return ESP_OK;
+    }
+
+    // Walk written slots from the cache point (or the head) to the group
+    // holding idx
+    uint32_t slot_idx = s_head;
+    size_t base = 0;
+    if (s_cache_valid && idx >= s_cache_base)
+    {
+        slot_idx = s_cache_slot;
+        base = s_cache_base;
+    }
+    uint8_t slot[SLOT_SIZE];
+    for (;;)
+    {
+        ESP_RETURN_ON_ERROR(
+            esp_partition_read(s_part, slot_offset(slot_idx), slot, sizeof(slot)),
+            TAG, "slot read failed");
+        uint8_t n = slot[4];
+        if (idx < base + n)
+        {
+            break;
+        }
+        base += n;
+        slot_idx = (slot_idx + 1) % s_num_slots;
+        if (base >= s_count)
+        {
+            return ESP_ERR_NOT_FOUND; // Counts inconsistent — corrupt ring
+        }
+    }
+    s_cache_valid = true;
+    s_cache_slot = slot_idx;
+    s_cache_base = base;
+
+    size_t len = slot_decode(slot, (uint32_t)(idx - base), out);
+    if (len == 0)
+    {
+        ESP_LOGE(TAG, "Corrupt delta group in slot %lu", (unsigned long)slot_idx);
+        return ESP_FAIL;
+    }
+    *out_len = len;
+    return ESP_OK;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * Flash black-box recorder. LoRa delivers ~51 bytes per transmit cycle;
+ * everything else the satellite measures used to be discarded forever.
+ * Every built report (wire body plus profiling stats trailer) is appended
+ * to a ring of fixed-size slots in a dedicated "blackbox" data
+ * partition, using the same one-way marker discipline as report_queue.c
+ * so erase wear spreads across the whole partition. Unlike the queue,
+ * reads are non-destructive: the ring is harvested in bulk over RS-485
+ * when the node is wired or recovered.
+ *
+ * Records are delta-compressed (bbdelta component): each slot holds a raw
+ * keyframe followed by delta-coded successors, typically 3-4 records
+ * where one used to fit — the same partition retains 3-4x the history.
+ * The group under construction waits in RTC RAM until its slot fills;
+ * call blackbox_flush() before a harvest to make it readable.
+ */
+
+// Maximum payload bytes one record can hold. Must cover
+// ORCA_REPORT_WIRE_SIZE + PROF_TRAILER_MAX_SIZE (asserted at the append
+// site); changing it re-strides the slot layout, so a firmware update
+// across the change effectively starts the ring fresh.
+#define BLACKBOX_RECORD_MAX 86
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mount the ring: locate the blackbox partition and recover the record
+// run by scanning slot markers. Must be called once before append/read.
+esp_err_t blackbox_init(void);
+
+// Append one record (len <= BLACKBOX_RECORD_MAX). When the ring wraps,
+// the oldest sector of records is erased to make room — newest data wins.
+esp_err_t blackbox_append(const void *rec, size_t len);
+
+// Write the pending (RTC-resident) record group to flash, if any. Called
+// before bulk harvest; appends between flushes restart a fresh group.
+esp_err_t blackbox_flush(void);
+
+// Number of records currently held (flushed + pending).
+size_t blackbox_count(void);
+
+// Read record idx (0 = oldest) into out (capacity BLACKBOX_RECORD_MAX).
+// Does not consume the record.
+esp_err_t blackbox_read(size_t idx, void *out, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,6 @@
 #include "gps.h"
+#include "gps_parse.h"
+#include "sat_log.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -7,26 +9,40 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/uart.h"
 #include "esp_log.h"
 #include "esp_idf_version.h"
+#include "esp_sleep.h"
+#include "nvs.h"
+#include <time.h>
 
 /* --------------------------------------------------------------------------
  * UART configuration — adjust to match your wiring
  * -------------------------------------------------------------------------- */
 #define GPS_UART_NUM        UART_NUM_1
 #define GPS_UART_RX_PIN     5
+#define GPS_UART_TX_PIN     15   /* to GPS RXD — only carries UBX power commands */
 #define GPS_UART_BAUD       115200
 #define GPS_UART_BUF_SIZE   1024
 
+#define GPS_UART_QUEUE_LEN  16
+#define GPS_MAX_SENTENCE    120   /* NMEA caps sentences at 82 chars; margin for vendor extras */
+
+/* Use the UBX binary protocol (NAV-PVT) instead of NMEA text. One 92-byte
+ * fixed-layout message per epoch replaces four text sentences and all the
+ * tokenizing/strtod work; set to 0 to fall back to the NMEA parser. */
+#define GPS_USE_UBX         1
+
 static const char *TAG = "gps";
 
 /* --------------------------------------------------------------------------
  * UART read state
  * -------------------------------------------------------------------------- */
-static char   s_buf[GPS_UART_BUF_SIZE + 1];
-static size_t s_total_bytes;
-static char  *s_last_buf_end;
+#if !GPS_USE_UBX
+static char          s_buf[GPS_MAX_SENTENCE + 1];
+#endif
+static QueueHandle_t s_uart_queue;
 
 /* --------------------------------------------------------------------------
  * Shared GPS state
@@ -34,189 +50,318 @@ static char  *s_last_buf_end;
 static gps_data_t s_data = {0};
 
 /* --------------------------------------------------------------------------
- * Internal: read one NMEA line from UART
+ * Internal: UBX protocol output (power management only)
  * -------------------------------------------------------------------------- */
-static void uart_read_line(char **out_buf, size_t *out_len, int timeout_ms)
+
+/* Frame and send one UBX message: sync1 sync2 class id len payload ck_a ck_b,
+ * with the 8-bit Fletcher checksum over class..payload. */
+static void ubx_send(uint8_t cls, uint8_t id, const uint8_t *payload, uint16_t len)
 {
-    *out_buf = NULL;
-    *out_len = 0;
+    uint8_t frame[8 + 48];  /* largest message we send is AID-INI (48 bytes) */
+    if (len > sizeof(frame) - 8) {
+        return;
+    }
 
-    if (s_last_buf_end != NULL) {
-        size_t remaining = s_total_bytes - (s_last_buf_end - s_buf);
-        memmove(s_buf, s_last_buf_end, remaining);
-        s_last_buf_end = NULL;
-        s_total_bytes  = remaining;
+    frame[0] = 0xB5;
+    frame[1] = 0x62;
+    frame[2] = cls;
+    frame[3] = id;
+    frame[4] = (uint8_t)(len & 0xFF);
+    frame[5] = (uint8_t)(len >> 8);
+    memcpy(&frame[6], payload, len);
+
+    uint8_t ck_a = 0, ck_b = 0;
+    for (int i = 2; i < 6 + len; i++) {
+        ck_a = (uint8_t)(ck_a + frame[i]);
+        ck_b = (uint8_t)(ck_b + ck_a);
     }
+    frame[6 + len]     = ck_a;
+    frame[6 + len + 1] = ck_b;
 
-    int read_bytes = uart_read_bytes(GPS_UART_NUM,
-                                     (uint8_t *)s_buf + s_total_bytes,
-                                     GPS_UART_BUF_SIZE - s_total_bytes,
-                                     pdMS_TO_TICKS(timeout_ms));
-    if (read_bytes <= 0) {
-        return;
+    uart_write_bytes(GPS_UART_NUM, frame, 8 + len);
+    uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(100));
+}
+
+#if GPS_USE_UBX
+/* --------------------------------------------------------------------------
+ * Internal: UBX binary input (NAV-PVT)
+ *
+ * The byte-level state machine and NAV-PVT field extraction live in the
+ * gps_parse component (pure logic, replayable on the host); this file owns
+ * the parser instance and feeds it UART bytes.
+ * -------------------------------------------------------------------------- */
+static ubx_parser_t s_ubx;
+
+/* Configure the receiver for UBX NAV-PVT only: silence the periodic NMEA
+ * sentences and enable NAV-PVT at the navigation rate. */
+static void ubx_configure_output(void)
+{
+    /* CFG-MSG: msgClass, msgID, rate (current port) */
+    static const uint8_t nmea_ids[] = { 0x00 /*GGA*/, 0x01 /*GLL*/, 0x02 /*GSA*/,
+                                        0x03 /*GSV*/, 0x04 /*RMC*/, 0x05 /*VTG*/ };
+    for (size_t i = 0; i < sizeof(nmea_ids); i++) {
+        uint8_t payload[3] = { 0xF0, nmea_ids[i], 0 };
+        ubx_send(0x06, 0x01, payload, sizeof(payload));
     }
-    s_total_bytes += read_bytes;
 
-    char *start = memchr(s_buf, '$', s_total_bytes);
-    if (start == NULL) {
-        s_total_bytes = 0;
-        return;
+    uint8_t pvt_on[3] = { 0x01 /*NAV*/, 0x07 /*PVT*/, 1 };
+    ubx_send(0x06, 0x01, pvt_on, sizeof(pvt_on));
+}
+#endif /* GPS_USE_UBX */
+
+/* --------------------------------------------------------------------------
+ * Internal: cold-start aiding (UBX AID-INI)
+ *
+ * Backup mode keeps ephemeris/almanac/clock alive in the receiver's own
+ * battery-backed RAM, so routine wakes warm-start for free. A battery swap
+ * loses all of it, and a cold acquisition (~30 s TTFF) can never beat the
+ * lock window — the node would transmit invalid fixes for dozens of cycles.
+ * So the last good fix is checkpointed to NVS (write-deduped: only after
+ * moving ~1 km or every few hours) and pushed back into the receiver as an
+ * AID-INI position/time seed when the node itself cold-boots. That skips
+ * the sky search and gets a warm-equivalent start in one cycle. Ephemeris
+ * is deliberately not harvested: an AID-EPH sweep is ~3.5 KB of NVS per
+ * constellation pass and position/time aiding already recovers nearly all
+ * of the TTFF. */
+#define GPS_AID_NVS_NAMESPACE "gps_aid"
+#define GPS_AID_NVS_KEY       "fix"
+#define GPS_AID_MOVE_1E7      100000     /* ~1.1 km before a re-save */
+#define GPS_AID_RESAVE_S      (6 * 3600) /* or this much elapsed time */
+#define GPS_AID_POS_ACC_CM    10000000   /* 100 km: drifting-platform margin */
+#define GPS_AID_TIME_ACC_MS   60000      /* covers leap-second slop and RTC drift */
+#define GPS_EPOCH_OFFSET_S    315964800UL /* Unix time of the GPS epoch */
+#define GPS_UTC_LEAP_S        18         /* GPS-UTC offset as of 2017 */
+
+typedef struct __attribute__((packed)) {
+    int32_t  lat_1e7;   /* degrees * 1e7 */
+    int32_t  lon_1e7;
+    int32_t  alt_cm;
+    uint32_t unix_time; /* of the checkpointed fix */
+} gps_aid_blob_t;
+
+static bool gps_aid_read(gps_aid_blob_t *out)
+{
+    nvs_handle_t h;
+    if (nvs_open(GPS_AID_NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) {
+        return false;
     }
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(h, GPS_AID_NVS_KEY, out, &len);
+    nvs_close(h);
+    return err == ESP_OK && len == sizeof(*out);
+}
 
-    char *end = memchr(start, '\r', s_total_bytes - (start - s_buf));
-    if (end == NULL || *(++end) != '\n') {
+/* Checkpoint the live fix if it differs enough from the stored one */
+static void gps_aid_save(void)
+{
+    if (!s_data.valid || !s_data.datetime_valid) {
         return;
     }
-    end++;
 
-    /* Null-terminate for easy string ops, then restore for length calc */
-    end[-2] = '\0';
+    struct tm dt = s_data.datetime;
+    gps_aid_blob_t blob = {
+        .lat_1e7   = (int32_t)(s_data.latitude * 1e7),
+        .lon_1e7   = (int32_t)(s_data.longitude * 1e7),
+        .alt_cm    = (int32_t)(s_data.altitude_m * 100.0f),
+        .unix_time = (uint32_t)mktime(&dt), /* TZ=UTC0, set by the fix path */
+    };
+
+    gps_aid_blob_t old;
+    if (gps_aid_read(&old) &&
+        labs((long)(blob.lat_1e7 - old.lat_1e7)) < GPS_AID_MOVE_1E7 &&
+        labs((long)(blob.lon_1e7 - old.lon_1e7)) < GPS_AID_MOVE_1E7 &&
+        blob.unix_time - old.unix_time < GPS_AID_RESAVE_S) {
+        return; /* aiding-equivalent to what's stored — spare the flash */
+    }
+
+    nvs_handle_t h;
+    if (nvs_open(GPS_AID_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_blob(h, GPS_AID_NVS_KEY, &blob, sizeof(blob)) == ESP_OK) {
+        nvs_commit(h);
+    }
+    nvs_close(h);
+}
 
-    *out_buf = start;
-    *out_len = (end - 2) - start;  /* length without \r\n */
+/* Seed the receiver with the checkpointed position (and time, when the
+ * node's own clock survived) via AID-INI */
+static void gps_aid_inject(void)
+{
+    gps_aid_blob_t blob;
+    if (!gps_aid_read(&blob)) {
+        return; /* never had a fix to checkpoint */
+    }
 
-    if (end < s_buf + s_total_bytes) {
-        s_last_buf_end = end;
-    } else {
-        s_total_bytes = 0;
+    uint32_t flags = 0x01 | 0x20; /* position valid, position is LLA */
+
+    /* Time aiding only when the system clock is plausibly ahead of the
+     * checkpoint: after a full power loss it reads ~1970 and a wrong week
+     * number would hurt more than no time at all */
+    uint16_t wno = 0;
+    uint32_t tow_ms = 0;
+    time_t now = time(NULL);
+    if (now > (time_t)blob.unix_time) {
+        uint32_t gps_s = (uint32_t)now - GPS_EPOCH_OFFSET_S + GPS_UTC_LEAP_S;
+        wno = (uint16_t)(gps_s / 604800UL);
+        tow_ms = (gps_s % 604800UL) * 1000UL;
+        flags |= 0x02; /* time valid */
     }
+
+    uint8_t p[48] = {0};
+    memcpy(&p[0], &blob.lat_1e7, 4);
+    memcpy(&p[4], &blob.lon_1e7, 4);
+    memcpy(&p[8], &blob.alt_cm, 4);
+    uint32_t pos_acc = GPS_AID_POS_ACC_CM;
+    memcpy(&p[12], &pos_acc, 4);
+    /* tmCfg (16..17) zero: no external time mark */
+    memcpy(&p[18], &wno, 2);
+    memcpy(&p[20], &tow_ms, 4);
+    /* towNs (24..27) zero */
+    uint32_t tacc_ms = GPS_AID_TIME_ACC_MS;
+    memcpy(&p[28], &tacc_ms, 4);
+    /* tAccNs, clock drift and accuracy (32..43) zero */
+    memcpy(&p[44], &flags, 4);
+    ubx_send(0x0B, 0x01, p, sizeof(p));
+
+    ESP_LOGI(TAG, "Aiding injected: lat %ld lon %ld%s",
+             (long)blob.lat_1e7, (long)blob.lon_1e7,
+             (flags & 0x02) ? " + time" : "");
 }
 
 /* --------------------------------------------------------------------------
- * Internal: split a comma-separated NMEA sentence into fields
- * Returns number of fields found.
- * fields[] will point into the sentence buffer (which is modified in place).
+ * Internal: navigation rate (CFG-RATE)
+ *
+ * The receiver defaults to 1 Hz epochs; at 5 Hz the first valid epoch after
+ * a warm start lands up to 800 ms sooner, which is pure lock-loop time.
+ * Output volume rises with it, but only the enabled messages are emitted.
  * -------------------------------------------------------------------------- */
-#define MAX_NMEA_FIELDS 24
-static int split_nmea(char *sentence, char *fields[], int max_fields)
+#define GPS_NAV_RATE_MS 200
+
+static void gps_set_nav_rate(uint16_t ms)
 {
-    /* Strip checksum (*XX) if present */
-    char *star = strchr(sentence, '*');
-    if (star) *star = '\0';
-
-    int count = 0;
-    char *p = sentence;
-    while (count < max_fields) {
-        fields[count++] = p;
-        char *comma = strchr(p, ',');
-        if (!comma) break;
-        *comma = '\0';
-        p = comma + 1;
-    }
-    return count;
+    /* measRate (ms), navRate (cycles), timeRef (1 = GPS time) */
+    uint8_t payload[6] = {
+        (uint8_t)(ms & 0xFF), (uint8_t)(ms >> 8),
+        0x01, 0x00,
+        0x01, 0x00,
+    };
+    ubx_send(0x06, 0x08, payload, sizeof(payload));
 }
 
+#if !GPS_USE_UBX
 /* --------------------------------------------------------------------------
- * Internal: convert NMEA ddmm.mmmm + cardinal to signed decimal degrees
+ * Internal: trim the NMEA sentence set (CFG-MSG)
+ *
+ * The receiver defaults to RMC, GGA, GLL, GSA, GSV and VTG every epoch but
+ * only RMC and GGA have handlers here — the rest were received, pattern-
+ * detected and indexed just to be thrown away. The TX pin carries the
+ * disable messages; an older module that ignores them merely stays chatty.
  * -------------------------------------------------------------------------- */
-static double nmea_coord_to_dd(const char *coord, const char *card)
+static void nmea_configure_output(void)
 {
-    if (!coord || coord[0] == '\0') return 0.0;
-    double raw = atof(coord);
-    int degrees = (int)(raw / 100);
-    double minutes = raw - (degrees * 100);
-    double dd = degrees + minutes / 60.0;
-    if (card && (card[0] == 'S' || card[0] == 'W')) dd = -dd;
-    return dd;
+    static const struct { uint8_t id; uint8_t rate; } msg_rates[] = {
+        { 0x00, 1 },  /* GGA */
+        { 0x01, 0 },  /* GLL */
+        { 0x02, 0 },  /* GSA */
+        { 0x03, 0 },  /* GSV */
+        { 0x04, 1 },  /* RMC */
+        { 0x05, 0 },  /* VTG */
+    };
+    for (size_t i = 0; i < sizeof(msg_rates) / sizeof(msg_rates[0]); i++) {
+        uint8_t payload[3] = { 0xF0, msg_rates[i].id, msg_rates[i].rate };
+        ubx_send(0x06, 0x01, payload, sizeof(payload));
+    }
 }
 
 /* --------------------------------------------------------------------------
- * Internal: parse one null-terminated NMEA sentence
+ * Internal: read one NMEA line from UART
+ *
+ * Sentences are delimited in hardware: the UART pattern-detect interrupt
+ * fires on each '\n' and posts an event, so the caller blocks in
+ * xQueueReceive (no busy-polling) and each byte is copied out of the driver
+ * ring buffer exactly once — no leftover-byte shuffling between calls.
  * -------------------------------------------------------------------------- */
-static void parse_sentence(char *sentence)
+static void uart_read_line(char **out_buf, size_t *out_len, int timeout_ms)
 {
-    char *fields[MAX_NMEA_FIELDS];
-    int n = split_nmea(sentence, fields, MAX_NMEA_FIELDS);
-    if (n < 1) return;
-
-    const char *type = fields[0] + 1;  /* skip '$', e.g. "GNRMC" */
-
-    /* Match on last 3 chars of sentence type to handle GP/GN/GL/GA/GB */
-    const char *mtype = type + (strlen(type) > 3 ? strlen(type) - 3 : 0);
-
-    /* ------------------------------------------------------------------ */
-    /* RMC – position, speed, track, date/time                            */
-    /* $xxRMC,hhmmss,A/V,lat,N/S,lon,E/W,speed,track,date,,,mode         */
-    /* ------------------------------------------------------------------ */
-    if (strcmp(mtype, "RMC") == 0 && n >= 10) {
-        /* Status: field[2] = 'A' active, 'V' void */
-        s_data.valid = (n > 2 && fields[2][0] == 'A');
-
-        if (n > 5) {
-            s_data.latitude  = nmea_coord_to_dd(fields[3], fields[4]);
-            s_data.longitude = nmea_coord_to_dd(fields[5], fields[6]);
-        }
-        if (n > 7 && fields[7][0]) s_data.speed_knots = atof(fields[7]);
-        s_data.speed_kmph = s_data.speed_knots * 1.852f;
-        if (n > 8 && fields[8][0]) s_data.track_deg = atof(fields[8]);
-
-        /* Date: ddmmyy */
-        if (n > 9 && strlen(fields[9]) == 6) {
-            char tmp[3] = {0};
-            strncpy(tmp, fields[9] + 0, 2); s_data.datetime.tm_mday  = atoi(tmp);
-            strncpy(tmp, fields[9] + 2, 2); s_data.datetime.tm_mon   = atoi(tmp) - 1;
-            strncpy(tmp, fields[9] + 4, 2); s_data.datetime.tm_year  = atoi(tmp) + 100;
+    *out_buf = NULL;
+    *out_len = 0;
+
+    uart_event_t event;
+    if (xQueueReceive(s_uart_queue, &event, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return;
+    }
+
+    switch (event.type) {
+    case UART_PATTERN_DET: {
+        int pos = uart_pattern_pop_pos(GPS_UART_NUM);
+        if (pos < 0 || pos >= (int)sizeof(s_buf)) {
+            /* Pattern position queue overflowed or the sentence is
+             * implausibly long — drop buffered data and resynchronize */
+            uart_flush_input(GPS_UART_NUM);
+            uart_pattern_queue_reset(GPS_UART_NUM, GPS_UART_QUEUE_LEN);
+            return;
         }
-        /* Time: hhmmss.sss */
-        if (n > 1 && strlen(fields[1]) >= 6) {
-            char tmp[3] = {0};
-            strncpy(tmp, fields[1] + 0, 2); s_data.datetime.tm_hour = atoi(tmp);
-            strncpy(tmp, fields[1] + 2, 2); s_data.datetime.tm_min  = atoi(tmp);
-            strncpy(tmp, fields[1] + 4, 2); s_data.datetime.tm_sec  = atoi(tmp);
-            s_data.datetime_valid = true;
+
+        /* Read the sentence including its '\n' terminator */
+        int read_bytes = uart_read_bytes(GPS_UART_NUM, (uint8_t *)s_buf,
+                                         pos + 1, pdMS_TO_TICKS(timeout_ms));
+        if (read_bytes <= 0) {
+            return;
         }
 
-        /* Mag variation */
-        double heading = s_data.track_deg;
-        if (n > 11 && fields[10][0]) {
-            double magvar = atof(fields[10]);
-            if (n > 11 && fields[11][0] == 'E') heading -= magvar;
-            else if (n > 11 && fields[11][0] == 'W') heading += magvar;
+        /* Trim \r\n and null-terminate for string ops */
+        int len = read_bytes;
+        while (len > 0 && (s_buf[len - 1] == '\n' || s_buf[len - 1] == '\r')) {
+            len--;
         }
-        s_data.heading_deg = (float)fmod(heading + 360.0, 360.0);
-    }
+        s_buf[len] = '\0';
 
-    /* ------------------------------------------------------------------ */
-    /* GGA – fix quality, altitude, satellite count                        */
-    /* $xxGGA,time,lat,N,lon,E,quality,sats,hdop,alt,M,...                */
-    /* ------------------------------------------------------------------ */
-    else if (strcmp(mtype, "GGA") == 0 && n >= 10) {
-        if (n > 7 && fields[7][0]) s_data.satellites = atoi(fields[7]);
-        if (n > 9 && fields[9][0]) s_data.altitude_m = atof(fields[9]);
-        if (n > 3 && fields[2][0]) {
-            s_data.latitude  = nmea_coord_to_dd(fields[2], fields[3]);
-            s_data.longitude = nmea_coord_to_dd(fields[4], fields[5]);
+        /* Skip leading garbage before '$' (partial sentence after boot) */
+        char *start = memchr(s_buf, '$', len);
+        if (start == NULL) {
+            return;
         }
-    }
 
-    /* ------------------------------------------------------------------ */
-    /* GSA – fix type, DOP                                                 */
-    /* $xxGSA,mode,fixtype,...,pdop,hdop,vdop                             */
-    /* ------------------------------------------------------------------ */
-    else if (strcmp(mtype, "GSA") == 0 && n >= 18) {
-        if (fields[2][0]) s_data.fix_type = (gps_fix_type_t)atoi(fields[2]);
-        if (fields[n-3][0]) s_data.pdop = atof(fields[n-3]);
-        if (fields[n-2][0]) s_data.hdop = atof(fields[n-2]);
-        if (fields[n-1][0]) s_data.vdop = atof(fields[n-1]);
+        *out_buf = start;
+        *out_len = len - (start - s_buf);
+        return;
     }
 
-    /* ------------------------------------------------------------------ */
-    /* VTG – speed / track                                                 */
-    /* $xxVTG,track,T,,M,speed_knots,N,speed_kmph,K,mode                 */
-    /* ------------------------------------------------------------------ */
-    else if (strcmp(mtype, "VTG") == 0 && n >= 8) {
-        if (fields[1][0]) s_data.track_deg   = atof(fields[1]);
-        if (fields[5][0]) s_data.speed_knots = atof(fields[5]);
-        if (fields[7][0]) s_data.speed_kmph  = atof(fields[7]);
+    case UART_FIFO_OVF:
+    case UART_BUFFER_FULL:
+        /* Producer outran us (e.g. long GPS-idle stretch); recover cleanly */
+        uart_flush_input(GPS_UART_NUM);
+        xQueueReset(s_uart_queue);
+        uart_pattern_queue_reset(GPS_UART_NUM, GPS_UART_QUEUE_LEN);
+        return;
+
+    default:
+        return;
     }
 }
 
+/* Sentence parsing (RMC/GGA handlers over the nmea field cursor) lives in
+ * the gps_parse component; lines read from the UART go straight to
+ * gps_parse_sentence(line, &s_data). */
+#endif /* !GPS_USE_UBX */
+
 /* --------------------------------------------------------------------------
  * Public API
  * -------------------------------------------------------------------------- */
 
 void gps_init(void)
 {
+    /* Idempotent: a second call within one wake (fix retry, self-benchmark
+     * during a wired session) must not re-install the UART driver — just
+     * make sure the receiver is awake */
+    static bool s_inited = false;
+    if (s_inited) {
+        gps_wake();
+        return;
+    }
+    s_inited = true;
+
     uart_config_t cfg = {
         .baud_rate  = GPS_UART_BAUD,
         .data_bits  = UART_DATA_8_BITS,
@@ -229,26 +374,158 @@ void gps_init(void)
     };
     ESP_ERROR_CHECK(uart_param_config(GPS_UART_NUM, &cfg));
     ESP_ERROR_CHECK(uart_set_pin(GPS_UART_NUM,
-                                 UART_PIN_NO_CHANGE, GPS_UART_RX_PIN,
+                                 GPS_UART_TX_PIN, GPS_UART_RX_PIN,
                                  UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
     ESP_ERROR_CHECK(uart_driver_install(GPS_UART_NUM,
-                                        GPS_UART_BUF_SIZE * 2, 0, 0, NULL, 0));
+                                        GPS_UART_BUF_SIZE * 2, GPS_UART_BUF_SIZE,
+                                        GPS_UART_QUEUE_LEN, &s_uart_queue, 0));
+
+#if !GPS_USE_UBX
+    /* Sentence-delimit in hardware: interrupt on each '\n' so complete
+     * lines arrive as queue events instead of being polled for */
+    ESP_ERROR_CHECK(uart_enable_pattern_det_baud_intr(GPS_UART_NUM, '\n', 1, 9, 0, 0));
+    uart_pattern_queue_reset(GPS_UART_NUM, GPS_UART_QUEUE_LEN);
+#endif
 
     memset(&s_data, 0, sizeof(s_data));
-    s_total_bytes  = 0;
-    s_last_buf_end = NULL;
 
-    ESP_LOGI(TAG, "GPS UART%d initialised at %d baud on RX GPIO%d",
-             GPS_UART_NUM, GPS_UART_BAUD, GPS_UART_RX_PIN);
+    gps_wake();
+
+#if GPS_USE_UBX
+    ubx_parser_reset(&s_ubx);
+    ubx_configure_output();
+#else
+    nmea_configure_output();
+#endif
+    gps_set_nav_rate(GPS_NAV_RATE_MS);
+
+    /* Cold boots (battery swap, brownout) are the only wakes where the
+     * receiver may have lost its backup RAM and be facing a cold
+     * acquisition; routine timer wakes skip the injection entirely. The
+     * receiver treats a seed it doesn't need as a no-op. */
+    static bool s_aid_attempted = false;
+    if (!s_aid_attempted &&
+        esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) {
+        gps_aid_inject();
+    }
+    s_aid_attempted = true;
+
+    ESP_LOGI(TAG, "GPS UART%d initialised at %d baud on RX GPIO%d / TX GPIO%d",
+             GPS_UART_NUM, GPS_UART_BAUD, GPS_UART_RX_PIN, GPS_UART_TX_PIN);
+}
+
+void gps_sleep(void)
+{
+    /* Checkpoint the fix (if any) for cold-start aiding before the
+     * receiver goes down; deduped, so this is almost always free */
+    gps_aid_save();
+
+    /* UBX RXM-PMREQ (version 0): duration = 0 (indefinite), flags bit 1 =
+     * enter backup mode. The receiver keeps ephemeris, almanac and clock in
+     * battery-backed RAM at ~15 µA, so the next cycle gets a warm-start fix
+     * in well under a second instead of a cold acquisition. */
+    uint8_t payload[8] = {0};
+    payload[4] = 0x02;  /* flags: backup */
+    ubx_send(0x02, 0x41, payload, sizeof(payload));
+
+    ESP_LOGI(TAG, "GPS entering backup mode");
+}
+
+void gps_wake(void)
+{
+    /* Any edge on the receiver's RXD wakes it from backup mode; a 0xFF
+     * dummy byte is the u-blox-recommended wake sequence and is ignored if
+     * the receiver is already running. First NMEA output follows within
+     * ~100 ms. */
+    const uint8_t dummy = 0xFF;
+    uart_write_bytes(GPS_UART_NUM, &dummy, 1);
+    uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(100));
+}
+
+#if GPS_USE_UBX
+
+void gps_print_raw(void)
+{
+    uint8_t b;
+    while (uart_read_bytes(GPS_UART_NUM, &b, 1, pdMS_TO_TICKS(100)) == 1) {
+        SAT_LOGT("%02X ", b);
+    }
+    SAT_LOGT("\n");
+}
+
+/* Service one UART event: drain its bytes through the UBX state machine
+ * (each byte is touched exactly once) or recover from an overflow. Returns
+ * the number of bytes consumed; sets *got_pvt when a NAV-PVT completed. */
+static int ubx_service_event(const uart_event_t *event, bool *got_pvt)
+{
+    int consumed = 0;
+
+    switch (event->type) {
+    case UART_DATA: {
+        size_t remaining = event->size;
+        while (remaining > 0) {
+            uint8_t chunk[64];
+            size_t want = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+            int n = uart_read_bytes(GPS_UART_NUM, chunk, want, 0);
+            if (n <= 0) {
+                break;
+            }
+            for (int i = 0; i < n; i++) {
+                *got_pvt |= ubx_parser_feed(&s_ubx, chunk[i], &s_data);
+            }
+            consumed  += n;
+            remaining -= n;
+        }
+        break;
+    }
+
+    case UART_FIFO_OVF:
+    case UART_BUFFER_FULL:
+        uart_flush_input(GPS_UART_NUM);
+        xQueueReset(s_uart_queue);
+        ubx_parser_reset(&s_ubx);
+        break;
+
+    default:
+        break;
+    }
+    return consumed;
+}
+
+bool gps_update(void)
+{
+    uart_event_t event;
+    if (xQueueReceive(s_uart_queue, &event, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return false;
+    }
+
+    bool got_pvt = false;
+    ubx_service_event(&event, &got_pvt);
+    return got_pvt;
 }
 
+int gps_poll(void)
+{
+    /* Zero-tick queue reads: drain only what the driver has already
+     * buffered, then hand the CPU straight back to the caller */
+    int consumed = 0;
+    bool got_pvt = false;
+    uart_event_t event;
+    while (xQueueReceive(s_uart_queue, &event, 0) == pdTRUE) {
+        consumed += ubx_service_event(&event, &got_pvt);
+    }
+    return consumed;
+}
+
+#else /* NMEA */
+
 void gps_print_raw(void)
 {
     char  *line = NULL;
     size_t len  = 0;
     uart_read_line(&line, &len, 100);
     if (len > 0) {
-        printf("%s\n", line);
+        SAT_LOGT("%s\n", line);
     }
 }
 
@@ -262,10 +539,75 @@ bool gps_update(void)
         return false;
     }
 
-    parse_sentence(line);
+    gps_parse_sentence(line, &s_data);
     return true;
 }
 
+int gps_poll(void)
+{
+    /* Pattern-detected lines are already sitting in the driver ring buffer,
+     * so zero-timeout reads either return a complete sentence at once or
+     * nothing; loop until the queue is empty */
+    int consumed = 0;
+    for (;;) {
+        char  *line = NULL;
+        size_t len  = 0;
+        uart_read_line(&line, &len, 0);
+        if (len == 0 || line == NULL) {
+            break;
+        }
+        gps_parse_sentence(line, &s_data);
+        consumed += (int)len;
+    }
+    return consumed;
+}
+
+#endif /* GPS_USE_UBX */
+
+bool gps_refresh_time(int timeout_ms)
+{
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeout_ms);
+
+#if GPS_USE_UBX
+    /* NAV-PVT is the only message enabled, so "one message" and "one RMC"
+     * cost the same here: pump events until a PVT with valid date/time
+     * flags lands. Cleared first so a stale epoch can't satisfy the wait. */
+    s_data.datetime_valid = false;
+    while (!s_data.datetime_valid) {
+        TickType_t now = xTaskGetTickCount();
+        if (now >= deadline) {
+            return false;
+        }
+        uart_event_t event;
+        if (xQueueReceive(s_uart_queue, &event, deadline - now) != pdTRUE) {
+            continue;
+        }
+        bool got_pvt = false;
+        ubx_service_event(&event, &got_pvt);
+    }
+    return true;
+#else
+    /* First RMC with populated time/date fields wins; every other sentence
+     * type is rejected by the header compare before it is even indexed, and
+     * no coordinate conversion runs at all. */
+    for (;;) {
+        TickType_t now = xTaskGetTickCount();
+        if (now >= deadline) {
+            return false;
+        }
+        char  *line = NULL;
+        size_t len  = 0;
+        uart_read_line(&line, &len, (int)((deadline - now) * portTICK_PERIOD_MS));
+        if (len == 0 || line == NULL) {
+            continue;
+        }
+        if (gps_parse_time_only(line, &s_data)) {
+            return true;
+        }
+    }
+#endif
+}
+
 void gps_get_data(gps_data_t *out)
 {
     if (out != NULL) {
@@ -6,52 +6,34 @@ extern "C" {
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <time.h>
+
+/* gps_data_t, gps_fix_type_t and the byte-level UBX/NMEA parsers live in
+ * the gps_parse component (pure logic, shared with the host harness for
+ * recorded-trace replay); this header keeps the driver-facing API. */
+#include "gps_parse.h"
 
 /**
- * @brief GPS fix type (2D / 3D)
+ * @brief Initialise the UART interface to the GPS module.
+ * Must be called once before gps_update().
  */
-typedef enum {
-    GPS_FIX_TYPE_NONE = 1,
-    GPS_FIX_TYPE_2D   = 2,
-    GPS_FIX_TYPE_3D   = 3,
-} gps_fix_type_t;
+void gps_init(void);
 
 /**
- * @brief Aggregated GPS data, updated on each successful parse cycle.
+ * @brief Put the GPS receiver into backup mode (UBX RXM-PMREQ).
+ *
+ * The receiver retains ephemeris/almanac/clock in backed-up RAM, so the next
+ * gps_wake() delivers a warm-start fix in well under a second. Call between
+ * transmit cycles once the fix has been consumed.
  */
-typedef struct {
-    /* --- Position --- */
-    double latitude;            /*!< Decimal degrees, positive = North */
-    double longitude;           /*!< Decimal degrees, positive = East  */
-    float  altitude_m;          /*!< Altitude above mean sea level, metres */
-
-    /* --- Motion --- */
-    float  speed_kmph;          /*!< Ground speed, km/h  */
-    float  speed_knots;         /*!< Ground speed, knots */
-    float  track_deg;           /*!< True track / heading, degrees */
-    float  heading_deg;         /*!< Mag-variation-adjusted heading, degrees */
-
-    /* --- Satellite info --- */
-    int    satellites;          /*!< Number of satellites in use */
-    float  hdop;                /*!< Horizontal dilution of precision */
-    float  pdop;                /*!< Position dilution of precision */
-    float  vdop;                /*!< Vertical dilution of precision */
-
-    /* --- Fix status --- */
-    gps_fix_type_t fix_type;    /*!< Fix type: none / 2D / 3D (GPGSA) */
-    bool           valid;       /*!< True when GPRMC reports an active fix */
-
-    /* --- Time / Date (UTC) --- */
-    struct tm datetime;         /*!< UTC date & time from GPRMC */
-    bool      datetime_valid;   /*!< True once a date/time sentence has been parsed */
-} gps_data_t;
+void gps_sleep(void);
 
 /**
- * @brief Initialise the UART interface to the GPS module.
- * Must be called once before gps_update().
+ * @brief Wake the GPS receiver from backup mode.
+ *
+ * Sends a dummy byte on the TX line (any RXD edge wakes the receiver); safe
+ * to call when the receiver is already running. Called by gps_init().
  */
-void gps_init(void);
+void gps_wake(void);
 
 /**
  * @brief Read and parse one NMEA sentence (100 ms timeout).
@@ -63,6 +45,36 @@ void gps_init(void);
  */
 bool gps_update(void);
 
+/**
+ * @brief Non-blocking pump of the GPS byte stream.
+ *
+ * Drains whatever the UART driver has buffered through the parser and
+ * returns immediately — unlike gps_update(), it never blocks waiting for
+ * data. Call it between other work (sensor reads, radio activity) to keep
+ * acquisition progressing, then check gps_get_data() for results.
+ *
+ * @return Number of bytes consumed from the UART (0 when nothing was pending).
+ */
+int gps_poll(void);
+
+/**
+ * @brief Time-only refresh: block until a UTC date/time is recovered.
+ *
+ * The cheap path when only a timestamp is needed (position cache fresh,
+ * or a full acquisition just timed out with the receiver still awake): in
+ * NMEA builds only RMC sentences are examined — a header byte compare
+ * rejects everything else before it is indexed, and the time/date fields
+ * are pulled through the lazy cursor with no coordinate conversion. In
+ * UBX builds the next NAV-PVT with valid date/time flags wins. RMC status
+ * 'V' still yields time once the receiver clock is set, so this typically
+ * completes on the first sentence even without a navigation fix. Only the
+ * datetime fields of the snapshot are updated.
+ *
+ * @param timeout_ms  How long to wait for a time-bearing message.
+ * @return true when gps_get_data() now carries a fresh UTC date/time.
+ */
+bool gps_refresh_time(int timeout_ms);
+
 /**
  * @brief Print the raw NMEA sentence from the GPS (for debugging).
  * Call instead of gps_update() to see what sentences the GPS is sending.
@@ -0,0 +1,251 @@
+#include "profiling.h"
+
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+
+/**
+ * Per-stage wake-cycle profiling (see profiling.h).
+ *
+ * Accumulators live in RTC memory so stats span deep-sleep cycles; a magic
+ * word guards against garbage after a cold boot or layout change, mirroring
+ * the s_rtc_state convention. The fault counters alone are additionally
+ * checkpointed to NVS: timing stats losing a power cycle costs one stats
+ * window, but a lifetime failure count that silently restarts at zero
+ * reads as a node that healed itself.
+ */
+
+#define PROF_RTC_MAGIC 0xA5F20F12UL // bumped for the fault counter block
+
+#define PROF_NVS_NAMESPACE "orca_prof"
+#define PROF_NVS_KEY_FAULTS "faults"
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t sum_us;
+    uint32_t min_us;
+    uint32_t max_us;
+} prof_stage_stats_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t reports_since_stats;
+    prof_stage_stats_t stage[PROF_STAGE_COUNT];
+    uint32_t fault[PROF_FAULT_COUNT];
+    // Values at the last NVS checkpoint; a write only happens when the
+    // live counters have moved past these, so quiet weeks cost no flash
+    uint32_t fault_saved[PROF_FAULT_COUNT];
+} prof_rtc_t;
+
+static RTC_DATA_ATTR prof_rtc_t s_prof;
+
+// In-flight begin timestamps; per-boot only, a stage never spans a sleep
+static int64_t s_stage_start_us[PROF_STAGE_COUNT];
+
+// Open stages in begin order, innermost last; backs prof_stage_current()
+static uint8_t s_stage_stack[PROF_STAGE_COUNT];
+static uint8_t s_stage_depth;
+
+// Cold boot (or layout change) wiped RTC: pick the lifetime fault
+// counters back up from the last NVS checkpoint. Follows the gps.c aiding
+// convention — NVS trouble just means the counters restart, never a stall.
+static void prof_faults_restore(void)
+{
+    nvs_handle_t h;
+    if (nvs_open(PROF_NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) {
+        return;
+    }
+    uint32_t saved[PROF_FAULT_COUNT];
+    size_t len = sizeof(saved);
+    if (nvs_get_blob(h, PROF_NVS_KEY_FAULTS, saved, &len) == ESP_OK &&
+        len == sizeof(saved)) {
+        memcpy(s_prof.fault, saved, sizeof(saved));
+        memcpy(s_prof.fault_saved, saved, sizeof(saved));
+    }
+    nvs_close(h);
+}
+
+// Persist the fault counters; called at the stats-trailer cadence and
+// only when something has actually changed since the last checkpoint
+static void prof_faults_checkpoint(void)
+{
+    if (memcmp(s_prof.fault, s_prof.fault_saved, sizeof(s_prof.fault)) == 0) {
+        return;
+    }
+    nvs_handle_t h;
+    if (nvs_open(PROF_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_blob(h, PROF_NVS_KEY_FAULTS, s_prof.fault,
+                     sizeof(s_prof.fault)) == ESP_OK &&
+        nvs_commit(h) == ESP_OK) {
+        memcpy(s_prof.fault_saved, s_prof.fault, sizeof(s_prof.fault));
+    }
+    nvs_close(h);
+}
+
+static void prof_ensure_valid(void)
+{
+    if (s_prof.magic != PROF_RTC_MAGIC) {
+        memset(&s_prof, 0, sizeof(s_prof));
+        for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+            s_prof.stage[i].min_us = UINT32_MAX;
+        }
+        prof_faults_restore();
+        s_prof.magic = PROF_RTC_MAGIC;
+    }
+}
+
+void prof_stage_begin(prof_stage_t stage)
+{
+    if (stage >= PROF_STAGE_COUNT) {
+        return;
+    }
+    prof_ensure_valid();
+    s_stage_start_us[stage] = esp_timer_get_time();
+
+    // Track the open-stage stack: a re-entered stage keeps its slot
+    for (int i = 0; i < s_stage_depth; i++) {
+        if (s_stage_stack[i] == (uint8_t)stage) {
+            return;
+        }
+    }
+    s_stage_stack[s_stage_depth++] = (uint8_t)stage;
+}
+
+void prof_stage_end(prof_stage_t stage)
+{
+    if (stage >= PROF_STAGE_COUNT || s_stage_start_us[stage] == 0) {
+        return;
+    }
+    prof_ensure_valid();
+
+    int64_t elapsed = esp_timer_get_time() - s_stage_start_us[stage];
+    s_stage_start_us[stage] = 0;
+
+    // Drop the stage from the open stack (usually the top entry)
+    for (int i = 0; i < s_stage_depth; i++) {
+        if (s_stage_stack[i] == (uint8_t)stage) {
+            for (int j = i; j + 1 < s_stage_depth; j++) {
+                s_stage_stack[j] = s_stage_stack[j + 1];
+            }
+            s_stage_depth--;
+            break;
+        }
+    }
+
+    if (elapsed < 0) {
+        return;
+    }
+
+    uint32_t us = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+    prof_stage_stats_t *st = &s_prof.stage[stage];
+    st->count++;
+    st->sum_us += us;
+    if (us < st->min_us) {
+        st->min_us = us;
+    }
+    if (us > st->max_us) {
+        st->max_us = us;
+    }
+}
+
+void prof_fault_count(prof_fault_t fault)
+{
+    if (fault >= PROF_FAULT_COUNT) {
+        return;
+    }
+    prof_ensure_valid();
+    s_prof.fault[fault]++;
+}
+
+uint32_t prof_fault_get(prof_fault_t fault)
+{
+    if (fault >= PROF_FAULT_COUNT) {
+        return 0;
+    }
+    prof_ensure_valid();
+    return s_prof.fault[fault];
+}
+
+uint8_t prof_stage_current(void)
+{
+    return (s_stage_depth > 0) ? s_stage_stack[s_stage_depth - 1] : 0xFF;
+}
+
+bool prof_stats_due(void)
+{
+    prof_ensure_valid();
+    return ++s_prof.reports_since_stats >= PROF_STATS_EVERY_N;
+}
+
+// Saturating microsecond -> millisecond conversion for the packed trailer
+static uint16_t prof_us_to_ms16(uint64_t us)
+{
+    uint64_t ms = us / 1000ULL;
+    return (ms > UINT16_MAX) ? UINT16_MAX : (uint16_t)ms;
+}
+
+size_t prof_append_stats_raw(uint8_t *buf)
+{
+    prof_ensure_valid();
+
+    size_t idx = 0;
+    buf[idx++] = PROF_TRAILER_MARKER;
+    buf[idx++] = PROF_STAGE_COUNT;
+
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        const prof_stage_stats_t *st = &s_prof.stage[i];
+        uint16_t min_ms = (st->count > 0) ? prof_us_to_ms16(st->min_us) : 0;
+        uint16_t mean_ms = (st->count > 0) ? prof_us_to_ms16(st->sum_us / st->count) : 0;
+        uint16_t max_ms = prof_us_to_ms16(st->max_us);
+
+        buf[idx++] = (uint8_t)(min_ms & 0xFF);
+        buf[idx++] = (uint8_t)(min_ms >> 8);
+        buf[idx++] = (uint8_t)(mean_ms & 0xFF);
+        buf[idx++] = (uint8_t)(mean_ms >> 8);
+        buf[idx++] = (uint8_t)(max_ms & 0xFF);
+        buf[idx++] = (uint8_t)(max_ms >> 8);
+    }
+
+    /* Memory watermarks: lifetime heap low-water mark (KiB, saturating)
+     * and the main task's stack high-water mark (bytes). A slow leak shows
+     * up here on day one instead of at the hour-23 lockup. */
+    uint32_t heap_kib = esp_get_minimum_free_heap_size() / 1024;
+    uint16_t heap16 = (heap_kib > UINT16_MAX) ? UINT16_MAX : (uint16_t)heap_kib;
+    UBaseType_t hwm = uxTaskGetStackHighWaterMark(NULL);
+    uint16_t stack16 = (hwm > UINT16_MAX) ? UINT16_MAX : (uint16_t)hwm;
+
+    buf[idx++] = (uint8_t)(heap16 & 0xFF);
+    buf[idx++] = (uint8_t)(heap16 >> 8);
+    buf[idx++] = (uint8_t)(stack16 & 0xFF);
+    buf[idx++] = (uint8_t)(stack16 >> 8);
+
+    /* Fault counters, saturating at uint16: a node past 65535 of anything
+     * has made its point, and the shore tooling only cares about the rate
+     * of change anyway. */
+    buf[idx++] = PROF_FAULT_COUNT;
+    for (int i = 0; i < PROF_FAULT_COUNT; i++) {
+        uint32_t n = s_prof.fault[i];
+        uint16_t n16 = (n > UINT16_MAX) ? UINT16_MAX : (uint16_t)n;
+        buf[idx++] = (uint8_t)(n16 & 0xFF);
+        buf[idx++] = (uint8_t)(n16 >> 8);
+    }
+
+    return idx;
+}
+
+size_t prof_append_stats(uint8_t *buf)
+{
+    size_t idx = prof_append_stats_raw(buf);
+    s_prof.reports_since_stats = 0;
+    prof_faults_checkpoint();
+    return idx;
+}
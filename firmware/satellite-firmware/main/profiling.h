@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Lightweight per-stage wake-cycle profiling.
+ *
+ * Each stage of the wake cycle is bracketed with begin/end calls that
+ * timestamp via esp_timer_get_time(). Min/max/sum/count per stage live in
+ * RTC memory so they accumulate across deep sleeps, and a compact stats
+ * trailer is appended to every Nth LoRa report so field deployments report
+ * where their awake time actually goes. The trailer also carries heap and
+ * stack watermarks (minimum-ever free heap, main-task stack high-water
+ * mark), since heap health decides multi-day stability.
+ *
+ * Alongside the timings, lifetime fault counters: how often each stage
+ * actually fails (I2C read errors, GPS lock timeouts, LoRa TX failures,
+ * RS-485 CRC rejects). Failure rates are performance data — every retry
+ * is watts — and a counter that starts climbing is visible from shore
+ * long before anyone climbs a mast. The counters ride RTC memory like
+ * the timing stats but are also checkpointed to NVS at the trailer
+ * cadence, so they survive full power loss, not just deep sleep.
+ */
+
+typedef enum
+{
+    PROF_STAGE_I2C_INIT = 0, // I2C bus + AS7343 bring-up
+    PROF_STAGE_SENSOR_READ,  // as7343_get_spectral_data + accumulate
+    PROF_STAGE_GPS_FIX,      // get_gps_fix (wall time inside the task)
+    PROF_STAGE_LORA_TX,      // radio bring-up + transmit + sleep
+    PROF_STAGE_COUNT
+} prof_stage_t;
+
+typedef enum
+{
+    PROF_FAULT_SENSOR_I2C = 0, // as7343_get_spectral_data error
+    PROF_FAULT_GPS_TIMEOUT,    // get_gps_fix lock timeout
+    PROF_FAULT_LORA_TX,        // lora transmit path failure
+    PROF_FAULT_RS485_CRC,      // inbound RS-485 frame CRC reject
+    PROF_FAULT_COUNT
+} prof_fault_t;
+
+// Marker byte introducing the stats trailer inside a LoRa frame
+#define PROF_TRAILER_MARKER 0xF0
+
+// Append the trailer to every Nth transmitted report
+#define PROF_STATS_EVERY_N 20
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bracket a stage; nesting different stages is fine, re-entering the same
+// stage restarts its timer
+void prof_stage_begin(prof_stage_t stage);
+void prof_stage_end(prof_stage_t stage);
+
+// Innermost stage currently open (most recently begun and not yet ended),
+// 0xFF when none. Lets samplers running on their own cadence — the bench
+// current profiler — tag data with the stage it landed in.
+uint8_t prof_stage_current(void);
+
+// Record one occurrence of a fault (lifetime counter, RTC + NVS)
+void prof_fault_count(prof_fault_t fault);
+
+// Lifetime count for one fault class (0 for out-of-range)
+uint32_t prof_fault_get(prof_fault_t fault);
+
+// True when the next transmitted report should carry the stats trailer
+bool prof_stats_due(void);
+
+// Append the packed trailer to buf:
+//   1 byte marker, 1 byte stage count, then per stage
+//   min/mean/max as uint16 milliseconds (6 bytes each), heap/stack
+//   watermarks, 1 byte fault count, then per fault a saturating uint16.
+// Returns the number of bytes written. Resets the every-Nth counter and
+// checkpoints the fault counters to NVS when they have moved.
+size_t prof_append_stats(uint8_t *buf);
+
+// Same trailer without consuming the every-Nth cadence; used by the
+// black-box recorder, which logs stats with every record.
+size_t prof_append_stats_raw(uint8_t *buf);
+
+// Worst-case trailer size for buffer sizing
+// marker + stage count + 6 bytes per stage + heap/stack watermarks
+// + fault count + 2 bytes per fault
+#define PROF_TRAILER_MAX_SIZE \
+    (2 + PROF_STAGE_COUNT * 6 + 4 + 1 + PROF_FAULT_COUNT * 2)
+
+#ifdef __cplusplus
+}
+#endif
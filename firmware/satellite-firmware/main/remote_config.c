@@ -0,0 +1,430 @@
+#include "remote_config.h"
+
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "mbedtls/md.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "rtc_state.h"
+
+static const char *TAG = "remote_cfg";
+
+#define NVS_NAMESPACE "orca_cfg"
+
+// All settings live in one versioned packed blob so a boot costs a single
+// NVS read instead of one flash transaction per key
+#define NVS_KEY_BLOB "cfg_blob"
+#define CFG_BLOB_VERSION 2
+
+// Legacy per-key layout, read once to migrate fleets flashed before the
+// blob existed
+#define NVS_KEY_CYCLE "tx_cycle_ms"
+#define NVS_KEY_SAMPLES "samples_per_tx"
+#define NVS_KEY_GPS "gps_timeout_ms"
+#define NVS_KEY_SF "lora_sf"
+#define NVS_KEY_MASK "chan_mask"
+
+typedef struct __attribute__((packed))
+{
+    uint8_t version;
+    uint32_t transmit_cycle_ms;
+    uint32_t samples_per_transmit;
+    uint32_t gps_lock_timeout_ms;
+    uint32_t lora_sf;
+    uint32_t channel_mask;
+    int32_t lora_tx_dbm;
+    uint32_t crc; // CRC-32 over everything above; mismatch = defaults
+} cfg_blob_t;
+
+// Version-1 layout (no TX power), read once to migrate stored overrides
+typedef struct __attribute__((packed))
+{
+    uint8_t version;
+    uint32_t transmit_cycle_ms;
+    uint32_t samples_per_transmit;
+    uint32_t gps_lock_timeout_ms;
+    uint32_t lora_sf;
+    uint32_t channel_mask;
+    uint32_t crc;
+} cfg_blob_v1_t;
+
+// RTC-retained copy of the loaded config. Warm wakes serve the whole
+// config from here — a magic/CRC check and a struct copy, never a flash
+// transaction on the wake path. Written back only when a downlink frame
+// actually changes something.
+#define CFG_CACHE_MAGIC 0xC06F1601UL
+
+RTC_DATA_ATTR static struct
+{
+    uint32_t magic;
+    remote_config_t cfg;
+    uint32_t crc; // CRC-32 over cfg
+} s_cfg_cache;
+
+// Shared secret for the config-frame HMAC. Per-fleet value injected at
+// build time; the default only pairs with the bench chamber.
+#ifndef REMOTE_CONFIG_HMAC_KEY
+#define REMOTE_CONFIG_HMAC_KEY "orca-bench-key"
+#endif
+
+// Accepted value ranges; a malformed (but correctly signed) frame must not
+// be able to brick the duty cycle
+#define CFG_CYCLE_MS_MIN 500UL
+#define CFG_CYCLE_MS_MAX 3600000UL
+#define CFG_SAMPLES_MIN 1UL
+#define CFG_SAMPLES_MAX 64UL
+#define CFG_GPS_MS_MIN 1000UL
+#define CFG_GPS_MS_MAX 120000UL
+
+// Spreading factor: SF9 (the compile-time default) is the slowest rate
+// allowed, so the worst-case airtime asserts in satellite-firmware.cpp
+// stay the worst case no matter what the chamber proposes
+#define CFG_SF_MIN 7UL
+#define CFG_SF_MAX 9UL
+#define CFG_SF_DEFAULT 9UL // Matches LORA_SPREAD in satellite-firmware.cpp
+
+// TX power: the SX1262's full range. The default matches RadioLib's
+// begin() default — the level every node transmitted at before the
+// power loop existed.
+#define CFG_TXPWR_MIN_DBM (-9)
+#define CFG_TXPWR_MAX_DBM 22
+#define CFG_TXPWR_DEFAULT_DBM 10
+
+static bool s_nvs_ready = false;
+
+static void nvs_ready_or_init(void)
+{
+    if (s_nvs_ready)
+    {
+        return;
+    }
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "NVS init failed: %s — overrides disabled",
+                 esp_err_to_name(err));
+        return;
+    }
+    s_nvs_ready = true;
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void cfg_cache_store(const remote_config_t *cfg)
+{
+    s_cfg_cache.cfg = *cfg;
+    s_cfg_cache.crc = rtc_state_crc32(&s_cfg_cache.cfg, sizeof(s_cfg_cache.cfg));
+    s_cfg_cache.magic = CFG_CACHE_MAGIC;
+}
+
+static void cfg_defaults(remote_config_t *cfg)
+{
+    cfg->transmit_cycle_ms = (uint32_t)TRANSMIT_CYCLE_MS;
+    cfg->samples_per_transmit = SAMPLES_PER_TRANSMIT;
+    cfg->gps_lock_timeout_ms = (uint32_t)GPS_LOCK_TIMEOUT_MS;
+    cfg->lora_sf = CFG_SF_DEFAULT;
+    cfg->channel_mask = REMOTE_MASK_ALL;
+    cfg->lora_tx_dbm = CFG_TXPWR_DEFAULT_DBM;
+}
+
+static bool persist(const remote_config_t *cfg)
+{
+    // Keep the warm-wake cache coherent whether or not flash cooperates;
+    // the applied values are live in RAM either way
+    cfg_cache_store(cfg);
+
+    nvs_ready_or_init();
+    if (!s_nvs_ready)
+    {
+        return false;
+    }
+    nvs_handle_t h;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK)
+    {
+        return false;
+    }
+
+    cfg_blob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    blob.version = CFG_BLOB_VERSION;
+    blob.transmit_cycle_ms = cfg->transmit_cycle_ms;
+    blob.samples_per_transmit = cfg->samples_per_transmit;
+    blob.gps_lock_timeout_ms = cfg->gps_lock_timeout_ms;
+    blob.lora_sf = cfg->lora_sf;
+    blob.channel_mask = cfg->channel_mask;
+    blob.lora_tx_dbm = cfg->lora_tx_dbm;
+    blob.crc = rtc_state_crc32(&blob, sizeof(blob) - sizeof(blob.crc));
+
+    bool ok = nvs_set_blob(h, NVS_KEY_BLOB, &blob, sizeof(blob)) == ESP_OK &&
+              nvs_commit(h) == ESP_OK;
+    nvs_close(h);
+    return ok;
+}
+
+void remote_config_load(remote_config_t *cfg)
+{
+    // Warm wake: the RTC cache survived deep sleep — config load is a
+    // struct copy, no NVS and no flash read
+    if (s_cfg_cache.magic == CFG_CACHE_MAGIC &&
+        rtc_state_crc32(&s_cfg_cache.cfg, sizeof(s_cfg_cache.cfg)) ==
+            s_cfg_cache.crc)
+    {
+        *cfg = s_cfg_cache.cfg;
+        return;
+    }
+
+    cfg_defaults(cfg);
+
+    nvs_ready_or_init();
+    if (!s_nvs_ready)
+    {
+        cfg_cache_store(cfg);
+        return;
+    }
+
+    nvs_handle_t h;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK)
+    {
+        cfg_cache_store(cfg); // Nothing stored yet — defaults stand
+        return;
+    }
+
+    union
+    {
+        cfg_blob_t v2;
+        cfg_blob_v1_t v1;
+    } blob;
+    size_t len = sizeof(blob);
+    bool migrate = false;
+    esp_err_t got = nvs_get_blob(h, NVS_KEY_BLOB, &blob, &len);
+    if (got == ESP_OK && len == sizeof(blob.v2) &&
+        blob.v2.version == CFG_BLOB_VERSION &&
+        blob.v2.crc ==
+            rtc_state_crc32(&blob.v2, sizeof(blob.v2) - sizeof(blob.v2.crc)))
+    {
+        cfg->transmit_cycle_ms = blob.v2.transmit_cycle_ms;
+        cfg->samples_per_transmit = blob.v2.samples_per_transmit;
+        cfg->gps_lock_timeout_ms = blob.v2.gps_lock_timeout_ms;
+        cfg->lora_sf = blob.v2.lora_sf;
+        cfg->channel_mask = blob.v2.channel_mask;
+        cfg->lora_tx_dbm = blob.v2.lora_tx_dbm;
+    }
+    else if (got == ESP_OK && len == sizeof(blob.v1) && blob.v1.version == 1 &&
+             blob.v1.crc ==
+                 rtc_state_crc32(&blob.v1, sizeof(blob.v1) - sizeof(blob.v1.crc)))
+    {
+        // Version-1 blob: carry the stored overrides forward, TX power
+        // stays at the default, and rewrite in the current layout
+        cfg->transmit_cycle_ms = blob.v1.transmit_cycle_ms;
+        cfg->samples_per_transmit = blob.v1.samples_per_transmit;
+        cfg->gps_lock_timeout_ms = blob.v1.gps_lock_timeout_ms;
+        cfg->lora_sf = blob.v1.lora_sf;
+        cfg->channel_mask = blob.v1.channel_mask;
+        migrate = true;
+    }
+    else
+    {
+        // No blob (or a corrupt one): pick up any legacy per-key overrides
+        // once, then write them back in blob form. A corrupt blob with no
+        // legacy keys falls through to the compiled defaults.
+        migrate = nvs_get_u32(h, NVS_KEY_CYCLE, &cfg->transmit_cycle_ms) == ESP_OK;
+        nvs_get_u32(h, NVS_KEY_SAMPLES, &cfg->samples_per_transmit);
+        nvs_get_u32(h, NVS_KEY_GPS, &cfg->gps_lock_timeout_ms);
+        nvs_get_u32(h, NVS_KEY_SF, &cfg->lora_sf);
+        nvs_get_u32(h, NVS_KEY_MASK, &cfg->channel_mask);
+    }
+    nvs_close(h);
+
+    cfg_cache_store(cfg);
+    if (migrate)
+    {
+        persist(cfg);
+        ESP_LOGI(TAG, "Migrated per-key config to blob layout");
+    }
+
+    ESP_LOGI(TAG, "Config: cycle=%lu ms, samples=%lu, gps_timeout=%lu ms, sf=%lu, mask=0x%04lx, tx=%ld dBm",
+             (unsigned long)cfg->transmit_cycle_ms,
+             (unsigned long)cfg->samples_per_transmit,
+             (unsigned long)cfg->gps_lock_timeout_ms,
+             (unsigned long)cfg->lora_sf,
+             (unsigned long)cfg->channel_mask,
+             (long)cfg->lora_tx_dbm);
+}
+
+bool remote_config_apply_frame(const uint8_t *frame, size_t len,
+                               remote_config_t *cfg)
+{
+    if (frame == NULL || len != REMOTE_CONFIG_FRAME_SIZE ||
+        frame[0] != REMOTE_CONFIG_FRAME_MAGIC || frame[1] != 1)
+    {
+        return false;
+    }
+
+    // Truncated HMAC-SHA256 over header + values with the fleet secret.
+    // 4 bytes is plenty against stray LoRa traffic on a 150 ms window.
+    uint8_t mac[32];
+    const mbedtls_md_info_t *md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (md == NULL ||
+        mbedtls_md_hmac(md, (const unsigned char *)REMOTE_CONFIG_HMAC_KEY,
+                        strlen(REMOTE_CONFIG_HMAC_KEY), frame, 14, mac) != 0 ||
+        memcmp(mac, frame + 14, 4) != 0)
+    {
+        ESP_LOGW(TAG, "Config frame rejected: bad signature");
+        return false;
+    }
+
+    uint32_t cycle = rd32(frame + 2);
+    uint32_t samples = rd32(frame + 6);
+    uint32_t gps = rd32(frame + 10);
+    if (cycle < CFG_CYCLE_MS_MIN || cycle > CFG_CYCLE_MS_MAX ||
+        samples < CFG_SAMPLES_MIN || samples > CFG_SAMPLES_MAX ||
+        gps < CFG_GPS_MS_MIN || gps > CFG_GPS_MS_MAX)
+    {
+        ESP_LOGW(TAG, "Config frame rejected: value out of range");
+        return false;
+    }
+
+    cfg->transmit_cycle_ms = cycle;
+    cfg->samples_per_transmit = samples;
+    cfg->gps_lock_timeout_ms = gps;
+
+    if (!persist(cfg))
+    {
+        ESP_LOGW(TAG, "Config accepted but NVS persist failed");
+    }
+    ESP_LOGI(TAG, "Config updated: cycle=%lu ms, samples=%lu, gps_timeout=%lu ms",
+             (unsigned long)cycle, (unsigned long)samples, (unsigned long)gps);
+    return true;
+}
+
+bool remote_rate_apply_frame(const uint8_t *frame, size_t len,
+                             remote_config_t *cfg)
+{
+    if (frame == NULL || len != REMOTE_RATE_FRAME_SIZE ||
+        frame[0] != REMOTE_RATE_FRAME_MAGIC || frame[1] != 1)
+    {
+        return false;
+    }
+
+    uint8_t mac[32];
+    const mbedtls_md_info_t *md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (md == NULL ||
+        mbedtls_md_hmac(md, (const unsigned char *)REMOTE_CONFIG_HMAC_KEY,
+                        strlen(REMOTE_CONFIG_HMAC_KEY), frame, 3, mac) != 0 ||
+        memcmp(mac, frame + 3, 4) != 0)
+    {
+        ESP_LOGW(TAG, "Rate frame rejected: bad signature");
+        return false;
+    }
+
+    uint32_t sf = frame[2];
+    if (sf < CFG_SF_MIN || sf > CFG_SF_MAX)
+    {
+        ESP_LOGW(TAG, "Rate frame rejected: SF%lu out of range",
+                 (unsigned long)sf);
+        return false;
+    }
+
+    cfg->lora_sf = sf;
+    if (!persist(cfg))
+    {
+        ESP_LOGW(TAG, "Rate accepted but NVS persist failed");
+    }
+    ESP_LOGI(TAG, "Spreading factor updated: SF%lu", (unsigned long)sf);
+    return true;
+}
+
+bool remote_mask_apply_frame(const uint8_t *frame, size_t len,
+                             remote_config_t *cfg)
+{
+    if (frame == NULL || len != REMOTE_MASK_FRAME_SIZE ||
+        frame[0] != REMOTE_MASK_FRAME_MAGIC || frame[1] != 1)
+    {
+        return false;
+    }
+
+    uint8_t mac[32];
+    const mbedtls_md_info_t *md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (md == NULL ||
+        mbedtls_md_hmac(md, (const unsigned char *)REMOTE_CONFIG_HMAC_KEY,
+                        strlen(REMOTE_CONFIG_HMAC_KEY), frame, 4, mac) != 0 ||
+        memcmp(mac, frame + 4, 4) != 0)
+    {
+        ESP_LOGW(TAG, "Mask frame rejected: bad signature");
+        return false;
+    }
+
+    uint32_t mask = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8);
+    // Zero would silence every channel; bits above the 13 real channels
+    // would desynchronize the receiver's field count
+    if (mask == 0 || mask > REMOTE_MASK_ALL)
+    {
+        ESP_LOGW(TAG, "Mask frame rejected: mask 0x%04lx out of range",
+                 (unsigned long)mask);
+        return false;
+    }
+
+    cfg->channel_mask = mask;
+    if (!persist(cfg))
+    {
+        ESP_LOGW(TAG, "Mask accepted but NVS persist failed");
+    }
+    ESP_LOGI(TAG, "Channel mask updated: 0x%04lx", (unsigned long)mask);
+    return true;
+}
+
+bool remote_power_apply_frame(const uint8_t *frame, size_t len,
+                              remote_config_t *cfg)
+{
+    if (frame == NULL || len != REMOTE_POWER_FRAME_SIZE ||
+        frame[0] != REMOTE_POWER_FRAME_MAGIC || frame[1] != 1)
+    {
+        return false;
+    }
+
+    uint8_t mac[32];
+    const mbedtls_md_info_t *md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (md == NULL ||
+        mbedtls_md_hmac(md, (const unsigned char *)REMOTE_CONFIG_HMAC_KEY,
+                        strlen(REMOTE_CONFIG_HMAC_KEY), frame, 3, mac) != 0 ||
+        memcmp(mac, frame + 3, 4) != 0)
+    {
+        ESP_LOGW(TAG, "Power frame rejected: bad signature");
+        return false;
+    }
+
+    // Delta form: step from our own persisted value, clamped to the PA's
+    // range, so a stale or replayed recommendation cannot command a jump
+    int32_t dbm = cfg->lora_tx_dbm + (int32_t)(int8_t)frame[2];
+    if (dbm < CFG_TXPWR_MIN_DBM)
+    {
+        dbm = CFG_TXPWR_MIN_DBM;
+    }
+    else if (dbm > CFG_TXPWR_MAX_DBM)
+    {
+        dbm = CFG_TXPWR_MAX_DBM;
+    }
+    if (dbm == cfg->lora_tx_dbm)
+    {
+        return true; // Signed and sane, but already at the clamp
+    }
+
+    cfg->lora_tx_dbm = dbm;
+    if (!persist(cfg))
+    {
+        ESP_LOGW(TAG, "Power accepted but NVS persist failed");
+    }
+    ESP_LOGI(TAG, "TX power updated: %ld dBm", (long)dbm);
+    return true;
+}
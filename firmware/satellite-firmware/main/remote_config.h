@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Over-the-air runtime configuration.
+ *
+ * The timing knobs in rtc_state.h are compile-time defaults; a deployed
+ * satellite can be retuned without mast recovery via a signed config frame
+ * sent by the chamber during the post-TX downlink window (see
+ * lora_transmit_frame). Accepted values persist in NVS and override the
+ * defaults on every subsequent boot. Storage is one versioned CRC'd blob,
+ * mirrored in an RTC-retained cache: warm wakes load config with a struct
+ * copy, cold boots cost a single NVS read, and flash is written only when
+ * a frame actually changes a value.
+ *
+ * Frame layout (18 bytes, little-endian):
+ *   [0]      0xC0 magic
+ *   [1]      layout version (1)
+ *   [2..5]   transmit_cycle_ms
+ *   [6..9]   samples_per_transmit
+ *   [10..13] gps_lock_timeout_ms
+ *   [14..17] first 4 bytes of HMAC-SHA256 over bytes [0..13]
+ *
+ * A second, smaller frame retunes just the LoRa spreading factor. The
+ * chamber watches its receive-side SNR margin and proposes a faster rate
+ * when the link allows; keeping it separate from the config frame means
+ * the chamber never has to guess (and so cannot clobber) timing values
+ * it does not know.
+ *
+ * Rate frame layout (7 bytes):
+ *   [0]      0xC1 magic
+ *   [1]      layout version (1)
+ *   [2]      spreading factor (7..9; SF9 is the airtime worst case the
+ *            compile-time budget asserts are sized for)
+ *   [3..6]   first 4 bytes of HMAC-SHA256 over bytes [0..2]
+ *
+ * A third frame selects which spectral channels single-report frames
+ * carry (PAYLOAD_FMT_MASKED); bit i of the mask is channel i in
+ * orca_channel_t wire order. All-ones restores full frames.
+ *
+ * Mask frame layout (8 bytes):
+ *   [0]      0xC2 magic
+ *   [1]      layout version (1)
+ *   [2..3]   channel mask, little-endian (1..0x1FFF)
+ *   [4..7]   first 4 bytes of HMAC-SHA256 over bytes [0..3]
+ *
+ * A fourth frame closes the TX power loop: the chamber watches its
+ * receive RSSI against a margin target and recommends an adjustment.
+ * The recommendation is a signed delta rather than an absolute level so
+ * a lost frame (or a chamber with a stale idea of the satellite's
+ * setting) can never command a jump — the satellite steps from its own
+ * persisted value and the loop re-measures.
+ *
+ * Power frame layout (7 bytes):
+ *   [0]      0xC3 magic
+ *   [1]      layout version (1)
+ *   [2]      recommended adjustment, dB, two's complement
+ *   [3..6]   first 4 bytes of HMAC-SHA256 over bytes [0..2]
+ */
+
+#define REMOTE_CONFIG_FRAME_MAGIC 0xC0
+#define REMOTE_CONFIG_FRAME_SIZE 18
+
+#define REMOTE_RATE_FRAME_MAGIC 0xC1
+#define REMOTE_RATE_FRAME_SIZE 7
+
+#define REMOTE_MASK_FRAME_MAGIC 0xC2
+#define REMOTE_MASK_FRAME_SIZE 8
+
+#define REMOTE_POWER_FRAME_MAGIC 0xC3
+#define REMOTE_POWER_FRAME_SIZE 7
+
+// All 13 channels selected — the default, and the "masked mode off" value
+#define REMOTE_MASK_ALL 0x1FFFUL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t transmit_cycle_ms;
+    uint32_t samples_per_transmit;
+    uint32_t gps_lock_timeout_ms;
+    uint32_t lora_sf; // Spreading factor; chamber-tunable via rate frame
+    uint32_t channel_mask; // Channels carried by single-report frames
+    int32_t lora_tx_dbm; // TX power; chamber-tunable via power frame
+} remote_config_t;
+
+// Fill cfg from NVS, falling back to the compile-time defaults for any
+// value never overridden. Initialises NVS on first call.
+void remote_config_load(remote_config_t *cfg);
+
+// Validate a downlink frame (magic, version, HMAC, value ranges); on
+// success update cfg and persist it to NVS. Returns false on any mismatch.
+bool remote_config_apply_frame(const uint8_t *frame, size_t len,
+                               remote_config_t *cfg);
+
+// Validate a downlink rate frame; on success update cfg->lora_sf and
+// persist it. The new rate takes effect at the next cold radio init.
+bool remote_rate_apply_frame(const uint8_t *frame, size_t len,
+                             remote_config_t *cfg);
+
+// Validate a downlink channel-mask frame; on success update
+// cfg->channel_mask and persist it. Takes effect from the next report.
+bool remote_mask_apply_frame(const uint8_t *frame, size_t len,
+                             remote_config_t *cfg);
+
+// Validate a downlink power frame; on success step cfg->lora_tx_dbm by
+// the recommended delta (clamped to the SX1262's range) and persist it.
+// Takes effect at the next cold radio init.
+bool remote_power_apply_frame(const uint8_t *frame, size_t len,
+                              remote_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
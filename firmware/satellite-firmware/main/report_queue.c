@@ -0,0 +1,194 @@
+#include "report_queue.h"
+
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+static const char *TAG = "report_queue";
+
+/* --------------------------------------------------------------------------
+ * Slot layout
+ *
+ * The partition is a ring of fixed-size slots. Each slot starts with a
+ * 4-byte marker followed by a length byte and the frame payload. NOR flash
+ * can only clear bits between erases, so the marker walks one-way:
+ *
+ *   0xFFFFFFFF (erased) -> SLOT_WRITTEN -> SLOT_DRAINED (all zero)
+ *
+ * Head/tail are recovered on mount by scanning markers, so no separate
+ * index record needs rewriting (and wearing out) on every operation.
+ * Sectors are erased only when the write pointer wraps back onto them,
+ * spreading erases evenly across the partition.
+ * -------------------------------------------------------------------------- */
+
+#define SLOT_WRITTEN 0x5AFEC0DEUL
+#define SLOT_ERASED  0xFFFFFFFFUL
+#define SLOT_DRAINED 0x00000000UL
+
+#define SLOT_SIZE        (4 + 1 + REPORT_QUEUE_FRAME_MAX + 3) /* marker+len+payload, padded to 168 */
+#define SECTOR_SIZE      4096
+#define SLOTS_PER_SECTOR (SECTOR_SIZE / SLOT_SIZE)
+
+static const esp_partition_t *s_part = NULL;
+static uint32_t s_num_slots = 0;
+static uint32_t s_head = 0;  // Next slot to pop (oldest written)
+static uint32_t s_tail = 0;  // Next slot to write
+static size_t   s_count = 0;
+
+static uint32_t slot_offset(uint32_t slot)
+{
+    uint32_t sector = slot / SLOTS_PER_SECTOR;
+    uint32_t within = slot % SLOTS_PER_SECTOR;
+    return sector * SECTOR_SIZE + within * SLOT_SIZE;
+}
+
+static esp_err_t read_marker(uint32_t slot, uint32_t *marker)
+{
+    return esp_partition_read(s_part, slot_offset(slot), marker, sizeof(*marker));
+}
+
+// Mark a written slot as drained (bit-clear only, no erase needed)
+static esp_err_t drain_slot(uint32_t slot)
+{
+    const uint32_t zero = SLOT_DRAINED;
+    return esp_partition_write(s_part, slot_offset(slot), &zero, sizeof(zero));
+}
+
+// Ensure the sector containing the given slot is fully erased before reuse.
+// Called only when the write pointer enters a sector, i.e. once per
+// SLOTS_PER_SECTOR pushes — the wear-leveling erase cadence.
+static esp_err_t prepare_sector_for(uint32_t slot)
+{
+    if (slot % SLOTS_PER_SECTOR != 0)
+    {
+        return ESP_OK;
+    }
+
+    uint32_t sector_base = (slot / SLOTS_PER_SECTOR) * SECTOR_SIZE;
+
+    // Drop any still-queued frames living in this sector (oldest data)
+    while (s_count > 0 &&
+           s_head / SLOTS_PER_SECTOR == slot / SLOTS_PER_SECTOR)
+    {
+        s_head = (s_head + 1) % s_num_slots;
+        s_count--;
+        ESP_LOGW(TAG, "Ring full: dropped oldest queued frame");
+    }
+
+    return esp_partition_erase_range(s_part, sector_base, SECTOR_SIZE);
+}
+
+esp_err_t report_queue_init(void)
+{
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                      ESP_PARTITION_SUBTYPE_ANY, "reports");
+    if (s_part == NULL)
+    {
+        ESP_LOGE(TAG, "reports partition not found — queue disabled");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    s_num_slots = (s_part->size / SECTOR_SIZE) * SLOTS_PER_SECTOR;
+    s_head = 0;
+    s_tail = 0;
+    s_count = 0;
+
+    // Recover state: the written region is a single contiguous run in ring
+    // order. Find the first written slot after a non-written one (head) and
+    // count written slots (queue depth); tail is the slot after the run.
+    bool found_head = false;
+    for (uint32_t i = 0; i < s_num_slots; i++)
+    {
+        uint32_t prev_marker = SLOT_ERASED;
+        uint32_t marker = SLOT_ERASED;
+        ESP_RETURN_ON_ERROR(read_marker(i, &marker), TAG, "marker read failed");
+        ESP_RETURN_ON_ERROR(
+            read_marker((i + s_num_slots - 1) % s_num_slots, &prev_marker),
+            TAG, "marker read failed");
+
+        if (marker == SLOT_WRITTEN)
+        {
+            s_count++;
+            if (!found_head && prev_marker != SLOT_WRITTEN)
+            {
+                s_head = i;
+                found_head = true;
+            }
+        }
+    }
+    s_tail = (s_head + s_count) % s_num_slots;
+
+    ESP_LOGI(TAG, "Mounted: %lu slots, %u queued (head=%lu tail=%lu)",
+             (unsigned long)s_num_slots, (unsigned)s_count,
+             (unsigned long)s_head, (unsigned long)s_tail);
+    return ESP_OK;
+}
+
+esp_err_t report_queue_push(const void *frame, size_t len)
+{
+    if (s_part == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (frame == NULL || len == 0 || len > REPORT_QUEUE_FRAME_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_RETURN_ON_ERROR(prepare_sector_for(s_tail), TAG, "sector erase failed");
+
+    uint8_t slot[SLOT_SIZE];
+    memset(slot, 0xFF, sizeof(slot));
+    const uint32_t marker = SLOT_WRITTEN;
+    memcpy(&slot[0], &marker, sizeof(marker));
+    slot[4] = (uint8_t)len;
+    memcpy(&slot[5], frame, len);
+
+    ESP_RETURN_ON_ERROR(
+        esp_partition_write(s_part, slot_offset(s_tail), slot, sizeof(slot)),
+        TAG, "slot write failed");
+
+    s_tail = (s_tail + 1) % s_num_slots;
+    s_count++;
+    return ESP_OK;
+}
+
+esp_err_t report_queue_pop(void *out, size_t *out_len)
+{
+    if (s_part == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (out == NULL || out_len == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_count == 0)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t slot[SLOT_SIZE];
+    ESP_RETURN_ON_ERROR(
+        esp_partition_read(s_part, slot_offset(s_head), slot, sizeof(slot)),
+        TAG, "slot read failed");
+
+    uint8_t len = slot[4];
+    if (len > REPORT_QUEUE_FRAME_MAX)
+    {
+        len = REPORT_QUEUE_FRAME_MAX;
+    }
+    memcpy(out, &slot[5], len);
+    *out_len = len;
+
+    ESP_RETURN_ON_ERROR(drain_slot(s_head), TAG, "drain mark failed");
+    s_head = (s_head + 1) % s_num_slots;
+    s_count--;
+    return ESP_OK;
+}
+
+size_t report_queue_count(void)
+{
+    return s_count;
+}
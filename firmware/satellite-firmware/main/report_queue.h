@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * Flash-backed store-and-forward queue for report frames that failed to
+ * transmit over LoRa. Frames are kept in a dedicated "reports" data
+ * partition organised as a ring of fixed-size slots; writes advance across
+ * the whole partition before any sector is erased again, so erase wear is
+ * spread evenly. Survives deep sleep and full power loss.
+ */
+
+// Maximum payload bytes one queue slot can hold. Must cover
+// sizeof(report_payload_t) — asserted where the struct is defined;
+// changing it re-strides the slot layout, so a firmware update across
+// the change effectively starts the ring fresh.
+#define REPORT_QUEUE_FRAME_MAX 160
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mount the queue: locate the reports partition and recover head/tail by
+// scanning slot markers. Must be called once before push/pop.
+esp_err_t report_queue_init(void);
+
+// Append one frame (len <= REPORT_QUEUE_FRAME_MAX). When the ring is full
+// the oldest unsent frame is dropped to make room — newest data wins.
+esp_err_t report_queue_push(const void *frame, size_t len);
+
+// Pop the oldest queued frame into out (capacity REPORT_QUEUE_FRAME_MAX).
+// Returns ESP_ERR_NOT_FOUND when the queue is empty.
+esp_err_t report_queue_pop(void *out, size_t *out_len);
+
+// Number of frames currently queued.
+size_t report_queue_count(void);
+
+#ifdef __cplusplus
+}
+#endif
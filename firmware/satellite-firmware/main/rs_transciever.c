@@ -1,23 +1,89 @@
 #include "rs_transciever.h"
+#include "sat_log.h"
 
 #include <stdio.h>
 #include <string.h>
 #include "driver/gpio.h"
+#include "driver/uart.h"
 #include "esp_err.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_system.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "nvs.h"
+#include "profiling.h"
 
 // RS-485 pin configuration (mirrors satellite-firmware.cpp)
 #define RS_SNS_PIN  GPIO_NUM_10   // Sense: HIGH = device connected
-#define RS_EN_PIN   GPIO_NUM_23   // TX enable: HIGH = drive RS-485 bus
+#define RS_EN_PIN   GPIO_NUM_23   // TX enable, driven as RTS by the UART
+#define RS_TX_PIN   GPIO_NUM_16   // RS-485 TX (shared with console UART0 TX)
 
-// RS_TX is GPIO_NUM_16, which is also the console UART0 TX pin.
-// We do NOT reassign it — printf already drives it. We only need RS_EN
-// to gate the RS-485 transceiver.
+// UART configuration: UART0 in hardware RS-485 half-duplex mode. The
+// peripheral raises RTS (wired to RS_EN) for exactly the duration of each
+// transmission, and uart_wait_tx_done() reports true TX completion — no
+// manual direction toggling and no fixed drain sleep.
+#define RS_UART_NUM      UART_NUM_0
+#define RS_UART_BAUD     115200
+#define RS_UART_BUF_SIZE 256
+
+// Baud negotiation: the short shipboard cable runs take 921600 comfortably,
+// and bulk paths (flash-log dump, streaming mode) are throttled 8x below
+// the wire at the console's 115200. At init we probe the high rate with a
+// framed '?' and expect an ACK (0x06) back within the timeout; silence or
+// garble means a legacy chamber (or a marginal run) and we stay at the safe
+// rate. A chamber that later fails CRC on a frame answers NAK (0x15), which
+// also drops us back — so a run that degrades mid-session self-heals.
+#define RS_UART_BAUD_HIGH     921600
+#define RS485_PROBE_TIMEOUT_MS 20
+#define RS485_ACK  0x06
+#define RS485_NAK  0x15
+
+// Multi-drop addressing: several satellites daisy-chain down one
+// ethernet-cable run, so every frame opens with a 2-byte header — the
+// node address (sender for satellite frames, destination for chamber
+// frames) and a frame type. The chamber polls addresses round-robin; a
+// node transmits its report only when polled, so the bus never collides.
+// A bus that stays silent for RS485_POLL_WAIT_MS (bench, single node,
+// legacy chamber that never polls) falls through to an immediate send.
+#define RS485_ADDR_NVS_NAMESPACE "orca_node"
+#define RS485_ADDR_NVS_KEY       "addr"
+#define RS485_ADDR_BROADCAST     0xFF
+#define RS485_POLL_WAIT_MS       50
+
+// Frame types (second header byte)
+#define RS485_FT_REPORT 'R'
+#define RS485_FT_PROBE  '?'
+#define RS485_FT_POLL   'P'
+
+// Largest inbound payload any frame type carries: an OTA chunk's offset
+// plus its data. Frame and COBS buffers size off this.
+#define RS485_PAYLOAD_MAX (4 + RS485_OTA_DATA_MAX)
+
+// Firmware OTA session. Progress checkpoints to NVS every
+// RS485_OTA_SAVE_BYTES so a transfer interrupted by a cable knock or a
+// power dip resumes instead of restarting — at the negotiated high baud a
+// lost session costs minutes of mast-top time. Each OTA frame handled
+// extends the command-service window by the keepalive, so a transfer is
+// not cut off by the normal short window.
+#define RS485_OTA_NVS_SIZE   "ota_size"
+#define RS485_OTA_NVS_CRC    "ota_crc"
+#define RS485_OTA_NVS_OFF    "ota_off"
+#define RS485_OTA_SAVE_BYTES (16 * 1024)
+#define RS485_OTA_KEEPALIVE_MS 1000
+
+// Framing mode: 1 = COBS-framed binary with CRC16 (~46 bytes on the wire,
+// ~4 ms at 115200), 0 = legacy ASCII START/END line (~250 bytes, ~20 ms
+// plus double formatting cost on the wake path)
+#define RS485_BINARY_FRAMING 1
+
+// Raw binary payload = the shared packed wire struct (orca_payload.h),
+// byte-identical to the LoRa keyframe body — no local serializer needed
 
 // -----------------------------------------------------------------------
 
 static bool s_gpio_ready = false;
+static bool s_uart_ready = false;
 
 static void init_gpio(void)
 {
@@ -32,17 +98,43 @@ static void init_gpio(void)
     };
     gpio_config(&sns_cfg);
 
-    gpio_config_t en_cfg = {
-        .pin_bit_mask = (1ULL << RS_EN_PIN),
-        .mode         = GPIO_MODE_OUTPUT,
-        .pull_up_en   = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type    = GPIO_INTR_DISABLE,
+    s_gpio_ready = true;
+}
+
+// Bring up UART0 in hardware RS-485 half-duplex mode with RTS on RS_EN.
+// The transceiver is keyed by the peripheral per transmission.
+static void init_uart(void)
+{
+    if (s_uart_ready) return;
+
+    uart_config_t cfg = {
+        .baud_rate  = RS_UART_BAUD,
+        .data_bits  = UART_DATA_8_BITS,
+        .parity     = UART_PARITY_DISABLE,
+        .stop_bits  = UART_STOP_BITS_1,
+        .flow_ctrl  = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
     };
-    gpio_config(&en_cfg);
-    gpio_set_level(RS_EN_PIN, 0);  // Idle low
+    ESP_ERROR_CHECK(uart_param_config(RS_UART_NUM, &cfg));
+    ESP_ERROR_CHECK(uart_set_pin(RS_UART_NUM,
+                                 RS_TX_PIN, UART_PIN_NO_CHANGE,
+                                 RS_EN_PIN, UART_PIN_NO_CHANGE));
+    ESP_ERROR_CHECK(uart_driver_install(RS_UART_NUM,
+                                        RS_UART_BUF_SIZE * 2, 0, 0, NULL, 0));
+    ESP_ERROR_CHECK(uart_set_mode(RS_UART_NUM, UART_MODE_RS485_HALF_DUPLEX));
 
-    s_gpio_ready = true;
+    s_uart_ready = true;
+}
+
+// Write a buffer and block until the last stop bit has left the shifter
+static bool uart_send_all(const uint8_t *data, size_t len)
+{
+    if (uart_write_bytes(RS_UART_NUM, data, len) != (int)len) {
+        return false;
+    }
+    // TX-done event: returns as soon as the FIFO and shifter are empty,
+    // typically single-digit ms for our frames instead of a fixed 30 ms
+    return uart_wait_tx_done(RS_UART_NUM, pdMS_TO_TICKS(100)) == ESP_OK;
 }
 
 // -----------------------------------------------------------------------
@@ -53,11 +145,506 @@ bool is_connected(void)
     return gpio_get_level(RS_SNS_PIN) == 1;
 }
 
-bool rs485_send(const rs_report_payload_t *payload)
+// -----------------------------------------------------------------------
+// Binary framing helpers
+// -----------------------------------------------------------------------
+
+// CRC16-CCITT (poly 0x1021, init 0xFFFF) over the raw payload
+static uint16_t crc16_ccitt(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                                 : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// COBS encode: removes all 0x00 bytes so a bare 0x00 can delimit frames.
+// out must hold len + len/254 + 1 bytes. Returns encoded length.
+static size_t cobs_encode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t  out_idx  = 1;
+    size_t  code_idx = 0;
+    uint8_t code     = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_idx] = code;
+            code_idx = out_idx++;
+            code = 1;
+        } else {
+            out[out_idx++] = in[i];
+            if (++code == 0xFF) {
+                out[code_idx] = code;
+                code_idx = out_idx++;
+                code = 1;
+            }
+        }
+    }
+    out[code_idx] = code;
+    return out_idx;
+}
+
+// COBS decode into out (same size as in suffices). Returns decoded length,
+// or 0 on a malformed frame.
+static size_t cobs_decode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t in_idx = 0, out_idx = 0;
+    while (in_idx < len) {
+        uint8_t code = in[in_idx++];
+        if (code == 0 || in_idx + code - 1 > len) return 0;
+        for (uint8_t i = 1; i < code; i++) {
+            out[out_idx++] = in[in_idx++];
+        }
+        if (code != 0xFF && in_idx < len) {
+            out[out_idx++] = 0;
+        }
+    }
+    return out_idx;
+}
+
+// This node's bus address. Assigned per node at provisioning time via NVS;
+// a node that was never provisioned answers address 0.
+static uint8_t node_addr(void)
+{
+    static uint8_t s_addr = 0;
+    static bool    s_loaded = false;
+    if (!s_loaded) {
+        nvs_handle_t h;
+        if (nvs_open(RS485_ADDR_NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+            nvs_get_u8(h, RS485_ADDR_NVS_KEY, &s_addr);
+            nvs_close(h);
+        }
+        s_loaded = true;
+    }
+    return s_addr;
+}
+
+// Frame a payload behind the addressing header (append CRC16 little-endian,
+// COBS-encode, 0x00 delimiter) and transmit it. The UART keys the
+// transceiver via RTS for exactly the frame duration.
+static bool send_framed(uint8_t type, const uint8_t *payload, size_t len)
+{
+    // Sized for the larger of a report body and a command response
+    uint8_t raw[2 + RS485_CMD_RESP_MAX + 2];
+    if (2 + len + 2 > sizeof(raw)) return false;
+
+    raw[0] = node_addr();
+    raw[1] = type;
+    memcpy(&raw[2], payload, len);
+    len += 2;
+    uint16_t crc = crc16_ccitt(raw, len);
+    raw[len++] = (uint8_t)(crc & 0xFF);
+    raw[len++] = (uint8_t)(crc >> 8);
+
+    uint8_t frame[sizeof(raw) + sizeof(raw) / 254 + 2];
+    size_t  flen = cobs_encode(raw, len, frame);
+    frame[flen++] = 0x00;
+
+    return uart_send_all(frame, flen);
+}
+
+// Read one inbound frame (delimited, COBS-decoded, CRC-checked) within
+// timeout_ms. Returns the decoded length (header included) or 0.
+static size_t read_frame(uint8_t *out, size_t out_max, int timeout_ms)
+{
+    uint8_t enc[2 * (2 + RS485_PAYLOAD_MAX + 2)];
+    size_t  got = 0;
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeout_ms);
+
+    for (;;) {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t left = (now < deadline) ? (deadline - now) : 0;
+        uint8_t b;
+        if (uart_read_bytes(RS_UART_NUM, &b, 1, left) != 1) {
+            return 0;
+        }
+        if (b != 0x00) {
+            if (got < sizeof(enc)) enc[got++] = b;
+            continue;
+        }
+        if (got == 0) continue;  // Bare delimiter / resync
+
+        uint8_t raw[sizeof(enc)];
+        size_t  len = cobs_decode(enc, got, raw);
+        got = 0;
+        if (len < 4) continue;  // Header + CRC minimum
+
+        uint16_t crc = (uint16_t)raw[len - 2] | ((uint16_t)raw[len - 1] << 8);
+        if (crc != crc16_ccitt(raw, len - 2)) {
+            // Counted, not just dropped: a climbing reject rate flags a
+            // marginal cable run from shore before it degrades the baud
+            prof_fault_count(PROF_FAULT_RS485_CRC);
+            continue;
+        }
+
+        len -= 2;
+        if (len > out_max) continue;
+        memcpy(out, raw, len);
+        return len;
+    }
+}
+
+// Block until the chamber polls this node (or broadcast), bounded by
+// RS485_POLL_WAIT_MS. A silent or poll-free bus falls through so the
+// common single-node setup keeps its push behavior.
+static void wait_for_poll(void)
+{
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(RS485_POLL_WAIT_MS);
+    for (;;) {
+        TickType_t now = xTaskGetTickCount();
+        if (now >= deadline) return;
+        uint8_t hdr[2 + ORCA_REPORT_WIRE_SIZE];
+        size_t  len = read_frame(hdr, sizeof(hdr),
+                                 (int)((deadline - now) * portTICK_PERIOD_MS));
+        if (len >= 2 && hdr[1] == RS485_FT_POLL &&
+            (hdr[0] == node_addr() || hdr[0] == RS485_ADDR_BROADCAST)) {
+            return;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------
+// Firmware OTA
+// -----------------------------------------------------------------------
+
+// CRC32 (IEEE, reflected) over the full image — the end-to-end check on
+// top of the link layer's per-frame CRC16
+static uint32_t crc32_ieee(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (uint32_t)(-(int32_t)(crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static struct {
+    const esp_partition_t *part;  // Update (non-running) slot being written
+    uint32_t size;                // Image size announced at OTA_BEGIN
+    uint32_t crc;                 // Image CRC32 announced at OTA_BEGIN
+    uint32_t offset;              // Next byte expected
+    uint32_t saved_offset;        // Last offset checkpointed to NVS
+    bool     active;
+} s_ota;
+
+// Checkpoint the session to NVS. Offset granularity is RS485_OTA_SAVE_BYTES
+// to bound flash wear; resume rounds down to the last checkpoint.
+static void ota_save_session(void)
+{
+    nvs_handle_t h;
+    if (nvs_open(RS485_ADDR_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) {
+        return;
+    }
+    nvs_set_u32(h, RS485_OTA_NVS_SIZE, s_ota.size);
+    nvs_set_u32(h, RS485_OTA_NVS_CRC, s_ota.crc);
+    nvs_set_u32(h, RS485_OTA_NVS_OFF, s_ota.offset);
+    nvs_commit(h);
+    nvs_close(h);
+    s_ota.saved_offset = s_ota.offset;
+}
+
+static void ota_clear_session(void)
+{
+    nvs_handle_t h;
+    if (nvs_open(RS485_ADDR_NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) {
+        nvs_erase_key(h, RS485_OTA_NVS_SIZE);
+        nvs_erase_key(h, RS485_OTA_NVS_CRC);
+        nvs_erase_key(h, RS485_OTA_NVS_OFF);
+        nvs_commit(h);
+        nvs_close(h);
+    }
+    s_ota.active = false;
+}
+
+// OTA_BEGIN: open (or resume) a session into the non-running slot. A
+// stored session matching the announced size and CRC32 resumes from its
+// checkpoint; anything else erases the slot and starts clean.
+static size_t ota_begin(const uint8_t *arg, size_t arg_len, uint8_t *resp)
+{
+    resp[0] = 1;
+    memset(&resp[1], 0, 4);
+    if (arg_len != 8) {
+        return 5;
+    }
+    uint32_t size, crc;
+    memcpy(&size, &arg[0], 4);
+    memcpy(&crc, &arg[4], 4);
+
+    const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+    if (part == NULL || size == 0 || size > part->size) {
+        SAT_LOGI("OTA rejected: size %lu vs slot %lu\n",
+                 (unsigned long)size,
+                 (unsigned long)(part ? part->size : 0));
+        return 5;
+    }
+
+    uint32_t stored_size = 0, stored_crc = 0, stored_off = 0;
+    nvs_handle_t h;
+    if (nvs_open(RS485_ADDR_NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+        nvs_get_u32(h, RS485_OTA_NVS_SIZE, &stored_size);
+        nvs_get_u32(h, RS485_OTA_NVS_CRC, &stored_crc);
+        nvs_get_u32(h, RS485_OTA_NVS_OFF, &stored_off);
+        nvs_close(h);
+    }
+
+    s_ota.part = part;
+    s_ota.size = size;
+    s_ota.crc = crc;
+    if (stored_size == size && stored_crc == crc && stored_off <= size) {
+        // Same image as the interrupted session: pick up at the checkpoint
+        s_ota.offset = stored_off;
+        SAT_LOGI("OTA resume at %lu/%lu\n",
+                 (unsigned long)stored_off, (unsigned long)size);
+    } else {
+        uint32_t erase = (size + 4095u) & ~4095u;  // whole flash sectors
+        if (esp_partition_erase_range(part, 0, erase) != ESP_OK) {
+            return 5;
+        }
+        s_ota.offset = 0;
+        SAT_LOGI("OTA begin: %lu bytes into %s\n",
+                 (unsigned long)size, part->label);
+    }
+    ota_save_session();
+    s_ota.active = true;
+
+    resp[0] = 0;
+    memcpy(&resp[1], &s_ota.offset, 4);
+    return 5;
+}
+
+// OTA_DATA: write one chunk at its announced offset. Out-of-step offsets
+// (lost response, chamber retry) are not an error — the reply always
+// carries the offset this node expects next, and the chamber rewinds.
+static size_t ota_data(const uint8_t *arg, size_t arg_len, uint8_t *resp)
+{
+    resp[0] = 1;
+    memcpy(&resp[1], &s_ota.offset, 4);
+    if (!s_ota.active || arg_len < 4) {
+        return 5;
+    }
+    uint32_t off;
+    memcpy(&off, arg, 4);
+    size_t n = arg_len - 4;
+
+    if (off == s_ota.offset && s_ota.offset + n <= s_ota.size) {
+        if (esp_partition_write(s_ota.part, off, &arg[4], n) != ESP_OK) {
+            return 5;
+        }
+        s_ota.offset += (uint32_t)n;
+        if (s_ota.offset - s_ota.saved_offset >= RS485_OTA_SAVE_BYTES ||
+            s_ota.offset == s_ota.size) {
+            ota_save_session();
+        }
+    }
+
+    resp[0] = 0;
+    memcpy(&resp[1], &s_ota.offset, 4);
+    return 5;
+}
+
+// OTA_END: read the slot back, check the image CRC32, swap the boot
+// partition and restart. A CRC mismatch scraps the session so the next
+// attempt starts clean rather than resuming corrupt state.
+static size_t ota_end(uint8_t *resp)
+{
+    resp[0] = 1;
+    if (!s_ota.active || s_ota.offset != s_ota.size) {
+        return 1;
+    }
+
+    uint32_t crc = 0;
+    uint8_t chunk[256];
+    for (uint32_t off = 0; off < s_ota.size; off += sizeof(chunk)) {
+        size_t n = s_ota.size - off;
+        if (n > sizeof(chunk)) n = sizeof(chunk);
+        if (esp_partition_read(s_ota.part, off, chunk, n) != ESP_OK) {
+            return 1;
+        }
+        crc = crc32_ieee(crc, chunk, n);
+    }
+    if (crc != s_ota.crc) {
+        SAT_LOGI("OTA CRC mismatch: got %08lx want %08lx\n",
+                 (unsigned long)crc, (unsigned long)s_ota.crc);
+        ota_clear_session();
+        return 1;
+    }
+
+    // esp_ota_set_boot_partition validates the image header before
+    // committing the swap, so a structurally broken image is refused here
+    // even with a matching CRC; the old slot stays intact either way
+    if (esp_ota_set_boot_partition(s_ota.part) != ESP_OK) {
+        ota_clear_session();
+        return 1;
+    }
+    ota_clear_session();
+    SAT_LOGI("OTA complete — restarting into %s\n", s_ota.part->label);
+    resp[0] = 0;
+    return 1;
+}
+
+// Dispatch one OTA frame and send its response. The restart on a
+// successful OTA_END happens after the response has fully left the wire.
+static void ota_dispatch(uint8_t cmd, const uint8_t *arg, size_t arg_len)
+{
+    uint8_t resp[5];
+    size_t  rlen;
+    bool    restart = false;
+
+    switch (cmd) {
+    case RS485_CMD_OTA_BEGIN:
+        rlen = ota_begin(arg, arg_len, resp);
+        break;
+    case RS485_CMD_OTA_DATA:
+        rlen = ota_data(arg, arg_len, resp);
+        break;
+    default:
+        rlen = ota_end(resp);
+        restart = (resp[0] == 0);
+        break;
+    }
+
+    send_framed(cmd, resp, rlen);
+    if (restart) {
+        uart_wait_tx_done(RS_UART_NUM, pdMS_TO_TICKS(100));
+        esp_restart();
+    }
+}
+
+// -----------------------------------------------------------------------
+// Command channel
+// -----------------------------------------------------------------------
+
+static rs485_cmd_handler_t s_cmd_handler = NULL;
+
+void rs485_set_cmd_handler(rs485_cmd_handler_t handler)
+{
+    s_cmd_handler = handler;
+}
+
+bool rs485_send_blob(uint8_t type, const uint8_t *payload, size_t len)
+{
+    init_gpio();
+    init_uart();
+    return send_framed(type, payload, len);
+}
+
+int rs485_service_commands(int window_ms)
+{
+    init_gpio();
+    init_uart();
+
+    int handled = 0;
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(window_ms);
+    do {
+        TickType_t now = xTaskGetTickCount();
+        int left = (now < deadline)
+                       ? (int)((deadline - now) * portTICK_PERIOD_MS) : 0;
+        uint8_t frame[2 + RS485_PAYLOAD_MAX];
+        size_t  len = read_frame(frame, sizeof(frame), left);
+        if (len < 2) {
+            break;  // Timeout or nothing pending
+        }
+        if (frame[0] != node_addr() && frame[0] != RS485_ADDR_BROADCAST) {
+            continue;  // Another node's traffic
+        }
+        uint8_t cmd = frame[1];
+        if (cmd == RS485_CMD_OTA_BEGIN || cmd == RS485_CMD_OTA_DATA ||
+            cmd == RS485_CMD_OTA_END) {
+            // OTA frames never reach the application handler, and each one
+            // pushes the window out so a transfer in flight is not cut off
+            // by the normal short service window
+            ota_dispatch(cmd, &frame[2], len - 2);
+            deadline = xTaskGetTickCount() +
+                       pdMS_TO_TICKS(RS485_OTA_KEEPALIVE_MS);
+            handled++;
+            continue;
+        }
+        if (cmd == RS485_FT_POLL || cmd == RS485_FT_REPORT ||
+            cmd == RS485_FT_PROBE || s_cmd_handler == NULL) {
+            continue;
+        }
+
+        uint8_t resp[RS485_CMD_RESP_MAX];
+        size_t  rlen = s_cmd_handler(cmd, &frame[2], len - 2,
+                                     resp, sizeof(resp));
+        send_framed(cmd, resp, rlen);
+        handled++;
+    } while (xTaskGetTickCount() < deadline);
+    return handled;
+}
+
+// -----------------------------------------------------------------------
+// Baud negotiation
+// -----------------------------------------------------------------------
+
+static uint32_t s_active_baud = RS_UART_BAUD;
+static bool     s_baud_probed = false;
+
+// One-shot probe at the high rate on the first send of a session. A framed
+// '?' that comes back ACKed locks the high rate in; anything else (legacy
+// chamber, marginal cable) costs one probe timeout and stays safe. Note
+// UART0 doubles as the console, so logs shift rate along with the bus.
+static void negotiate_baud(void)
+{
+    if (s_baud_probed) return;
+    s_baud_probed = true;
+
+    uart_set_baudrate(RS_UART_NUM, RS_UART_BAUD_HIGH);
+    uart_flush_input(RS_UART_NUM);
+
+    if (send_framed(RS485_FT_PROBE, (const uint8_t *)"", 0)) {
+        uint8_t resp = 0;
+        if (uart_read_bytes(RS_UART_NUM, &resp, 1,
+                            pdMS_TO_TICKS(RS485_PROBE_TIMEOUT_MS)) == 1 &&
+            resp == RS485_ACK) {
+            s_active_baud = RS_UART_BAUD_HIGH;
+            SAT_LOGI("RS-485 negotiated %d baud\n", RS_UART_BAUD_HIGH);
+            return;
+        }
+    }
+    uart_set_baudrate(RS_UART_NUM, RS_UART_BAUD);
+    uart_flush_input(RS_UART_NUM);
+}
+
+bool rs485_send(const orca_report_wire_t *payload)
 {
     if (!payload) return false;
     init_gpio();
+    init_uart();
+
+#if RS485_BINARY_FRAMING
+    negotiate_baud();
 
+    // Hold for our poll slot when the chamber is running the bus
+    wait_for_poll();
+
+    // The packed struct is the wire layout — its bytes go straight out
+    bool ok = send_framed(RS485_FT_REPORT,
+                          (const uint8_t *)payload, ORCA_REPORT_WIRE_SIZE);
+
+    // A CRC failure at the negotiated rate comes back as NAK: the run has
+    // degraded, so drop to the safe rate and resend this frame once
+    uint8_t resp = 0;
+    if (ok && s_active_baud == RS_UART_BAUD_HIGH &&
+        uart_read_bytes(RS_UART_NUM, &resp, 1, 0) == 1 && resp == RS485_NAK) {
+        s_active_baud = RS_UART_BAUD;
+        uart_set_baudrate(RS_UART_NUM, RS_UART_BAUD);
+        uart_flush_input(RS_UART_NUM);
+        SAT_LOGI("RS-485 NAK at high rate — falling back to %d baud\n",
+               RS_UART_BAUD);
+        ok = send_framed(RS485_FT_REPORT,
+                         (const uint8_t *)payload, ORCA_REPORT_WIRE_SIZE);
+    }
+    return ok;
+#else
     // Build single-line ASCII packet: START <fields> END
     char buf[512];
     int n = snprintf(buf, sizeof(buf),
@@ -79,29 +666,25 @@ bool rs485_send(const rs_report_payload_t *payload)
         "gps_valid:%d,"
         "lat:%.6f,"
         "lon:%.6f,"
-        "time:%" PRIu32
+        "time:%" PRIu32 ","
+        "batt_mv:%" PRIu16
         " END\n",
         payload->sample_count,
-        payload->avg_f1,  payload->avg_f2,  payload->avg_fz,
-        payload->avg_f3,  payload->avg_f4,  payload->avg_f5,
-        payload->avg_fy,  payload->avg_f6,  payload->avg_fxl,
-        payload->avg_f7,  payload->avg_f8,  payload->avg_nir,
-        payload->avg_clear,
-        (int)payload->gps.valid,
-        payload->gps.latitude_deg,
-        payload->gps.longitude_deg,
-        payload->gps.unix_time);
+        payload->channels[ORCA_CH_F1],  payload->channels[ORCA_CH_F2],
+        payload->channels[ORCA_CH_FZ],  payload->channels[ORCA_CH_F3],
+        payload->channels[ORCA_CH_F4],  payload->channels[ORCA_CH_F5],
+        payload->channels[ORCA_CH_FY],  payload->channels[ORCA_CH_F6],
+        payload->channels[ORCA_CH_FXL], payload->channels[ORCA_CH_F7],
+        payload->channels[ORCA_CH_F8],  payload->channels[ORCA_CH_NIR],
+        payload->channels[ORCA_CH_CLEAR],
+        (int)payload->gps_valid,
+        payload->lat_e7 / 1e7,
+        payload->lon_e7 / 1e7,
+        payload->unix_time,
+        payload->batt_mv);
 
     if (n >= (int)sizeof(buf)) return false;  // Overflowed
 
-    // Assert RS_EN to drive the RS-485 bus, send via the console UART
-    // (GPIO 16 = UART0 TX = RS_TX — same pin, no reassignment needed),
-    // then wait for the hardware TX FIFO to drain before releasing.
-    gpio_set_level(RS_EN_PIN, 1);
-    printf("%s", buf);
-    fflush(stdout);
-    vTaskDelay(pdMS_TO_TICKS(30));  // Wait for UART0 TX FIFO to drain (~17 ms at 115200)
-    gpio_set_level(RS_EN_PIN, 0);
-
-    return true;
+    return uart_send_all((const uint8_t *)buf, (size_t)n);
+#endif
 }
@@ -3,22 +3,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-// Forward-declare the payload type so this header stays self-contained.
-// The full definition lives in satellite-firmware.cpp; include that or
-// redefine locally before including this header.
-typedef struct {
-    bool valid;
-    double latitude_deg;
-    double longitude_deg;
-    uint32_t unix_time;
-} rs_gps_fix_t;
-
-typedef struct {
-    uint32_t sample_count;
-    uint16_t avg_f1, avg_f2, avg_fz, avg_f3, avg_f4, avg_f5;
-    uint16_t avg_fy, avg_f6, avg_fxl, avg_f7, avg_f8, avg_nir, avg_clear;
-    rs_gps_fix_t gps;
-} rs_report_payload_t;
+#include "orca_payload.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,9 +12,65 @@ extern "C" {
 // Returns true if RS_SNS pin is HIGH (device connected), false if LOW.
 bool is_connected(void);
 
-// Encode payload as ASCII and transmit over RS-485.
+// Frame the shared wire payload and transmit over RS-485.
 // Returns true on success.
-bool rs485_send(const rs_report_payload_t *payload);
+bool rs485_send(const orca_report_wire_t *payload);
+
+// ---- Command channel ----
+
+// Inbound command frame types (the frame-type header byte; any payload
+// after the header is the command argument)
+#define RS485_CMD_GET_CONFIG 'g'
+#define RS485_CMD_SET_CONFIG 's'
+#define RS485_CMD_CALIBRATE  'c'
+#define RS485_CMD_DUMP_STATS 'd'
+#define RS485_CMD_DUMP_LOG   'l'
+#define RS485_CMD_DUMP_BOX   'b'
+#define RS485_CMD_DUMP_BENCH 'p'  // Bench current capture (see bench_power.h)
+#define RS485_CMD_SELF_BENCH 'm'  // On-target micro-measurements (self_bench_run)
+
+// Firmware OTA frame types, handled inside rs_transciever.c (never routed
+// to the application handler). Stop-and-wait, one response per frame:
+//   OTA_BEGIN  arg: u32 image size + u32 image CRC32
+//              resp: u8 status + u32 resume offset (0 on a fresh session)
+//   OTA_DATA   arg: u32 offset + up to RS485_OTA_DATA_MAX image bytes
+//              resp: u8 status + u32 next expected offset
+//   OTA_END    arg: none
+//              resp: u8 status; on success the node swaps boot partitions
+//              and restarts into the new image
+// Every frame is CRC16-checked by the link layer; a session interrupted
+// mid-transfer resumes from the last checkpointed offset when the chamber
+// re-issues OTA_BEGIN with the same size and CRC32.
+#define RS485_CMD_OTA_BEGIN 'u'
+#define RS485_CMD_OTA_DATA  'w'
+#define RS485_CMD_OTA_END   'z'
+
+// Image bytes per OTA_DATA frame — sized so a full chunk frame still fits
+// the UART driver's receive buffer with COBS and CRC overhead
+#define RS485_OTA_DATA_MAX 192
+
+// Largest command response payload one frame can carry (sized for a full
+// black-box record: wire report + stats trailer)
+#define RS485_CMD_RESP_MAX 80
+
+// Handle one command: write any response payload into resp (at most
+// resp_max bytes) and return its length; 0 sends a bare header-only reply.
+typedef size_t (*rs485_cmd_handler_t)(uint8_t cmd, const uint8_t *arg,
+                                      size_t arg_len, uint8_t *resp,
+                                      size_t resp_max);
+
+// Register the application's command handler (NULL disables dispatch).
+void rs485_set_cmd_handler(rs485_cmd_handler_t handler);
+
+// Send an arbitrary payload behind the addressing header with the given
+// frame type. Used by bulk paths (black-box harvest) that stream many
+// frames in answer to a single command.
+bool rs485_send_blob(uint8_t type, const uint8_t *payload, size_t len);
+
+// Service inbound commands addressed to this node for up to window_ms
+// (0 = drain only what is already pending). Each command's response goes
+// out as a frame of the same type. Returns the number handled.
+int rs485_service_commands(int window_ms);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "orca_payload.h"
+
+/**
+ * RTC-retained accumulator state and sampling configuration, shared between
+ * the main application (satellite-firmware.cpp) and the deep-sleep wake stub
+ * (wake_stub.c). Both run against the same RTC_DATA_ATTR instance, so the
+ * layout here is the single source of truth.
+ */
+
+// Sampling & transmit timing configuration — compile-time defaults only.
+// The live values are the cfg_* fields below, seeded from these (or an
+// NVS override accepted over the air, see remote_config.h) at boot.
+#define TRANSMIT_CYCLE_MS 1000ULL
+#define SAMPLES_PER_TRANSMIT 1
+#define GPS_LOCK_TIMEOUT_MS 5000ULL
+#define SAMPLING_CYCLE_MS (uint64_t)(TRANSMIT_CYCLE_MS / SAMPLES_PER_TRANSMIT)
+
+// Back-to-back integrations collected per full wake. Each wake pays a
+// fixed ~400 ms of boot and sensor bring-up against a 1.67-50 ms
+// integration; banking k integrations per wake and sleeping k periods
+// divides that overhead by k while the average sample rate stays put.
+// The cost is temporal clustering — k samples land microseconds apart
+// instead of evenly spaced — which is fine under smooth illumination but
+// blunts flicker detection and the transient burst governor's edge
+// response, so the default stays at the flight-proven 1. The wake stub
+// is the other amortization of the same overhead and only collects one
+// integration per wake; values > 1 therefore leave the stub uninstalled.
+#define SAMPLES_PER_WAKE 1
+
+// While the day/night governor holds night_mode, every sleep (main app
+// and wake stub alike) is stretched by this factor
+#define NIGHT_SLEEP_MULTIPLIER 10ULL
+
+// Transient burst governor: a cloud edge shows up as a jump between
+// consecutive normalized clear-channel samples; when one trips the
+// threshold (absolute floor AND >=25% of the previous reading), the next
+// BURST_WAKES sleeps run at BURST_PERIOD_MS instead of the scheduled
+// period, so the fast edge is sampled instead of aliased. Both samplers
+// detect and both schedulers honor it; reports whose window contains
+// burst samples carry a tag trailer.
+#define BURST_PERIOD_MS 1000UL
+#define BURST_WAKES 60UL
+#define BURST_CLEAR_DELTA_MIN 2048
+
+// Report trailer marking a window with burst-cadence samples; same
+// marker-byte scheme as PROF_TRAILER_MARKER (profiling.h), next code up
+#define BURST_TRAILER_MARKER 0xF1
+
+// Robust aggregation keeps the last N raw samples per channel so report
+// building can use a median or trimmed mean instead of the spike-prone
+// arithmetic mean. Sized so in-place selection stays trivial (N <= 16).
+#define ROBUST_WINDOW_N 16
+
+// RTC retained-state validation; version 12 = slow-clock calibration
+#define RTC_STATE_MAGIC 0xA53443D1UL
+#define RTC_STATE_VERSION 12UL
+
+// RTC slow-clock calibration (satellite-firmware.cpp): Q16 identity value
+// and the bounds the GPS-derived correction is trusted within. The RC
+// oscillator drifts by percent-level amounts with temperature, so both
+// schedulers scale their programmed sleeps by clk_cal_q16.
+#define CLK_CAL_ONE_Q16 65536UL
+#define CLK_CAL_MAX_DEV_Q16 3277UL // +/-5%; larger = measurement glitch
+
+// RTC data struct to retain information between deep sleeps
+typedef struct
+{
+    // Check RTC
+    uint32_t magic;
+    uint32_t version;
+
+    // Check cycle counts
+    uint32_t cycle_sample_count; // Number of samples in the sum
+    uint32_t total_sample_count; // Overall sample number post-averaging
+
+    uint64_t first_sample_time_us;
+    uint64_t last_sample_time_us;
+
+    // RTC wall clock (GPS-disciplined gettimeofday) of the window's first
+    // sample — unlike the esp_timer stamps above it survives deep sleep,
+    // so the report can carry the window's true temporal extent. 0 when
+    // the window was opened by a stub-only wake (no wall clock there).
+    uint64_t first_sample_wall_us;
+
+    // Channel sums indexed by orca_channel_t (wire order). Accumulate,
+    // clear and average are plain loops over this array.
+    uint64_t sums[ORCA_NUM_CHANNELS];
+
+    // Variability accumulators, same indexing. A squared uint16 sample is
+    // < 2^32, so uint64 sums of squares cannot overflow within a window.
+    // mins start at 0xFFFF and maxs at 0 when the accumulator is cleared.
+    uint64_t sum_sq[ORCA_NUM_CHANNELS];
+    uint16_t mins[ORCA_NUM_CHANNELS];
+    uint16_t maxs[ORCA_NUM_CHANNELS];
+
+    // Ring of the most recent raw samples per channel, written at
+    // slot (cycle_sample_count % ROBUST_WINDOW_N) by both the main
+    // sampler and the wake stub
+    uint16_t window[ORCA_NUM_CHANNELS][ROBUST_WINDOW_N];
+
+    // Day/night governor (satellite-firmware.cpp). Lives here so the wake
+    // stub stretches its re-armed sleep by the same factor at night.
+    uint32_t night_mode;
+
+    // Solar scheduling governor: sampling-period stretch factor derived
+    // from sun elevation at the last full wake (satellite-firmware.cpp).
+    // 0 = no position/time knowledge yet — fall back to night_mode. The
+    // stub applies it unchanged; doing the trig there would drag the
+    // tables into RTC IRAM for no benefit at stub timescales.
+    uint32_t solar_period_mult;
+
+    // Transient burst governor. burst_remaining counts wakes still owed at
+    // the fast BURST_PERIOD_MS cadence (both schedulers decrement it);
+    // burst_last_clear / burst_last_valid hold the previous normalized
+    // clear-channel sample for the consecutive-jump detector; burst_in_cycle
+    // is set when any sample in the current accumulation window was taken
+    // under burst cadence, so the report can be tagged.
+    uint32_t burst_remaining;
+    uint32_t burst_last_valid;
+    uint16_t burst_last_clear;
+    uint16_t burst_in_cycle;
+
+    // Live timing configuration. Seeded from the defaults / NVS override
+    // at every full boot; the wake stub reads these instead of the
+    // #defines so over-the-air retuning applies to stub-only wakes too.
+    uint32_t cfg_transmit_cycle_ms;
+    uint32_t cfg_samples_per_transmit;
+    uint32_t cfg_gps_lock_timeout_ms;
+
+    // Exposure controller: currently programmed as7343_gain_t value, the
+    // index into the integration-time ladder (AIT_ASTEP in
+    // satellite-firmware.cpp) and the combined Q16 multiplier that takes
+    // a raw count at that exposure to the reference scale (256x, default
+    // integration). Both samplers normalize by multiplying with
+    // agc_norm_q16 before accumulating — the stub never re-derives it.
+    uint32_t agc_gain;
+    uint32_t ait_level;
+    uint32_t agc_norm_q16;
+
+    // RTC slow-clock correction, Q16: programmed sleep durations are
+    // multiplied by this so "RTC-perceived" microseconds elapse as true
+    // (GPS) microseconds. Maintained against successive GPS fixes in
+    // gps_cache_store(); CLK_CAL_ONE_Q16 = no correction. Applied by both
+    // schedulers so stub-armed sleeps hold the TDMA grid too.
+    uint32_t clk_cal_q16;
+} satellite_rtc_state_t;
+
+// CRC-protected snapshot of the live state. Two banks alternate so a
+// brownout mid-copy can only corrupt the bank being written; boot-time
+// validation falls back to the newest intact bank instead of a full
+// reset when the live copy fails its magic/version check.
+typedef struct
+{
+    satellite_rtc_state_t state;
+    uint32_t seq; // Monotonic commit counter; newest valid bank wins
+    uint32_t crc; // CRC-32 over state and seq
+} rtc_state_bank_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Defined (RTC_DATA_ATTR) in satellite-firmware.cpp
+extern satellite_rtc_state_t s_rtc_state;
+
+// Snapshot banks and their helpers live in wake_stub.c (RTC-resident) so
+// stub-only wakes can commit their mutations too
+extern rtc_state_bank_t s_rtc_banks[2];
+uint32_t rtc_state_crc32(const void *buf, uint32_t len);
+void rtc_state_commit(void);
+
+// Wake stub entry point (wake_stub.c); registered before each deep sleep
+void wake_stub_sample(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+#include "sat_log.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * Asynchronous log drain (see sat_log.h). Producers vsnprintf into a stack
+ * buffer and copy it into a RAM ring under a short critical section — a
+ * few microseconds against the milliseconds a 115200-baud printf blocks.
+ * A lowest-priority task owns the actual console writes, so UART drain
+ * time lands in otherwise-idle slack instead of inside the profiled wake
+ * stages. A full ring drops the message and counts it; observability
+ * never back-pressures the path being observed.
+ *
+ * The ESP32-C6 console has no DMA engine to hand this to, and installing
+ * the interrupt-driven UART driver on UART0 would fight the stdio VFS the
+ * rest of the system (ESP_LOG, panic output) still uses — the drain task
+ * over the stock console write gets the same property that matters:
+ * producers return immediately.
+ */
+
+#define SAT_LOG_RING_SIZE 4096 // ~2 wakes of DEBUG output
+#define SAT_LOG_LINE_MAX 192   // Longest single message after formatting
+#define SAT_LOG_TASK_STACK 2304
+#define SAT_LOG_TASK_PRIO (tskIDLE_PRIORITY + 1)
+
+static uint8_t s_ring[SAT_LOG_RING_SIZE];
+static volatile size_t s_head; // Producer write index
+static volatile size_t s_tail; // Drain read index
+static volatile uint32_t s_dropped;
+static TaskHandle_t s_drain_task;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t ring_used(void)
+{
+    return (s_head + SAT_LOG_RING_SIZE - s_tail) % SAT_LOG_RING_SIZE;
+}
+
+static void drain_task(void *arg)
+{
+    (void)arg;
+    uint8_t chunk[128];
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (s_tail != s_head) {
+            size_t n = 0;
+            portENTER_CRITICAL(&s_lock);
+            while (s_tail != s_head && n < sizeof(chunk)) {
+                chunk[n++] = s_ring[s_tail];
+                s_tail = (s_tail + 1) % SAT_LOG_RING_SIZE;
+            }
+            portEXIT_CRITICAL(&s_lock);
+            // The only blocking write in the system lives here, at a
+            // priority nothing on the wake path ever yields to for long
+            fwrite(chunk, 1, n, stdout);
+        }
+        fflush(stdout);
+    }
+}
+
+void sat_log_init(void)
+{
+    if (s_drain_task == NULL) {
+        xTaskCreate(drain_task, "sat_log", SAT_LOG_TASK_STACK, NULL,
+                    SAT_LOG_TASK_PRIO, &s_drain_task);
+    }
+}
+
+void sat_log_printf(const char *fmt, ...)
+{
+    char line[SAT_LOG_LINE_MAX];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (len <= 0) {
+        return;
+    }
+    if ((size_t)len >= sizeof(line)) {
+        len = sizeof(line) - 1; // Truncated: ship what was formatted
+    }
+
+    if (s_drain_task == NULL) {
+        // Pre-init (or init failed): the old synchronous behavior
+        fwrite(line, 1, len, stdout);
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    // Leave one byte free so head == tail always means empty
+    if (ring_used() + (size_t)len >= SAT_LOG_RING_SIZE) {
+        s_dropped++;
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+    for (int i = 0; i < len; i++) {
+        s_ring[s_head] = (uint8_t)line[i];
+        s_head = (s_head + 1) % SAT_LOG_RING_SIZE;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    xTaskNotifyGive(s_drain_task);
+}
+
+void sat_log_flush(int timeout_ms)
+{
+    if (s_drain_task == NULL) {
+        fflush(stdout);
+        return;
+    }
+    if (s_dropped > 0) {
+        sat_log_printf("log: %lu message(s) dropped (ring full)\n",
+                       (unsigned long)s_dropped);
+        s_dropped = 0;
+    }
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    xTaskNotifyGive(s_drain_task);
+    while (s_tail != s_head && esp_timer_get_time() < deadline) {
+        vTaskDelay(1);
+    }
+    fflush(stdout);
+}
+
+uint32_t sat_log_dropped(void)
+{
+    return s_dropped;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Compile-time-leveled logging for the satellite sources.
+ *
+ * Every printf on the wake path costs milliseconds of blocking 115200-baud
+ * UART output per cycle, which a season of wakes turns into real battery.
+ * These macros compile to nothing above the configured level — the format
+ * strings don't even reach the binary — so release builds run the hot path
+ * silently while bench builds keep the full dumps.
+ *
+ * Levels (each includes the ones below it):
+ *   SAT_LOG_TRACE  per-sample channel dumps, raw byte streams
+ *   SAT_LOG_DEBUG  per-wake state (RTC counters, fix details, sleep timing)
+ *   SAT_LOG_INFO   rare events: mode changes, failures, fallbacks, batches
+ *   SAT_LOG_OFF    nothing at all
+ *
+ * Select with -DSAT_LOG_LEVEL=SAT_LOG_x (idf.py -DCMAKE_C_FLAGS / the
+ * component CMakeLists); defaults to INFO, which keeps every per-wake
+ * message out of production output.
+ *
+ * Messages that do compile in go through an asynchronous path: producers
+ * format into a RAM ring and return immediately, a lowest-priority task
+ * drains the ring to the console, and a full ring drops the message and
+ * counts it rather than back-pressuring the producer (sat_log.c). So a
+ * chatty bench build stalls the wake path no more than a silent release
+ * build does, and its stage timings stay representative. Call
+ * sat_log_flush() before deep sleep or the tail of the ring is lost.
+ */
+
+#define SAT_LOG_OFF   0
+#define SAT_LOG_INFO  1
+#define SAT_LOG_DEBUG 2
+#define SAT_LOG_TRACE 3
+
+#ifndef SAT_LOG_LEVEL
+#define SAT_LOG_LEVEL SAT_LOG_INFO
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Format into the RAM ring and return; never blocks on the UART. Falls
+// back to plain vprintf until sat_log_init() has run.
+void sat_log_printf(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+
+// Start the drain task. Call once, early in app_main.
+void sat_log_init(void);
+
+// Block (bounded by timeout_ms) until the ring has drained to the UART.
+// Call before deep sleep so the tail of the wake's output isn't lost.
+void sat_log_flush(int timeout_ms);
+
+// Messages dropped because the ring was full.
+uint32_t sat_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if SAT_LOG_LEVEL >= SAT_LOG_INFO
+#define SAT_LOGI(...) sat_log_printf(__VA_ARGS__)
+#else
+#define SAT_LOGI(...) ((void)0)
+#endif
+
+#if SAT_LOG_LEVEL >= SAT_LOG_DEBUG
+#define SAT_LOGD(...) sat_log_printf(__VA_ARGS__)
+#else
+#define SAT_LOGD(...) ((void)0)
+#endif
+
+#if SAT_LOG_LEVEL >= SAT_LOG_TRACE
+#define SAT_LOGT(...) sat_log_printf(__VA_ARGS__)
+#else
+#define SAT_LOGT(...) ((void)0)
+#endif
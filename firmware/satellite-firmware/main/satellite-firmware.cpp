@@ -2,15 +2,38 @@
 #include <string.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <sys/time.h>
 #include "driver/i2c_master.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_oneshot.h"
 #include "as7343.h"
+#include "as7343_norm.h"
+#include "bench_power.h"
+#include "blackbox.h"
+#include "esp_attr.h"
 #include "esp_err.h"
+#include "esp_pm.h"
+#include "esp_random.h"
 #include "esp_sleep.h"
 #include "esp_system.h"
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "EspHal.h"
 #include "gps.h"
+#include "nvs.h"
+#include "orca_payload.h"
+#include "orca_agg.h"
+#include "orca_siphash.h"
+#include "profiling.h"
+#include "remote_config.h"
+#include "report_queue.h"
 #include "rs_transciever.h"
+#include "rtc_state.h"
+#include "sat_log.h"
+#include "solar.h"
 
 /**
  * The satellite module utilizes deep sleep cycles to minimize power draw while sampling data
@@ -22,17 +45,15 @@
 // I2C AS7343 pin configuration
 static constexpr gpio_num_t I2C_SCL_GPIO = GPIO_NUM_19;
 static constexpr gpio_num_t I2C_SDA_GPIO = GPIO_NUM_18;
+static constexpr gpio_num_t AS7343_INT_GPIO = GPIO_NUM_4; // Sensor INT (data-ready)
 #define I2C_PORT I2C_NUM_0
 
-// Sampling & transmit timing configuration
-#define TRANSMIT_CYCLE_MS 1000ULL
-#define SAMPLES_PER_TRANSMIT 1
-#define GPS_LOCK_TIMEOUT_MS 5000ULL
-#define SAMPLING_CYCLE_MS (uint64_t)(TRANSMIT_CYCLE_MS / SAMPLES_PER_TRANSMIT)
+// Auto-SMUX mode: 18-channel for full spectra, 6-channel (one integration
+// cycle, F1..F8 zero) when cloud-transient studies need rate over resolution
+#define SENSOR_SMUX_MODE AS7343_SMUX_18CH
 
-// RTC retained-state validation
-#define RTC_STATE_MAGIC 0xA53443D1UL
-#define RTC_STATE_VERSION 1UL
+// Sampling/transmit timing and the RTC state layout live in rtc_state.h,
+// shared with the deep-sleep wake stub
 
 // SPI configuration
 static constexpr gpio_num_t SPI_SCK  = GPIO_NUM_6;
@@ -45,8 +66,23 @@ static constexpr gpio_num_t LORA_DIO1  = GPIO_NUM_20;
 static constexpr gpio_num_t LORA_RESET = GPIO_NUM_0;
 static constexpr gpio_num_t LORA_BUSY  = GPIO_NUM_3;
 
-// LoRa frequency configuration
+// This node's fleet identity, set per node at flash time. Drives both the
+// frequency-plan channel below and the TDMA slot (scheduling section).
+#define FLEET_NODE_ID 0
+
+// LoRa frequency configuration. Nodes spread across a channel plan derived
+// from the fleet ID: LORA_CHANNEL_COUNT carriers spaced
+// LORA_CHANNEL_STEP_MHZ apart (3x the 250 kHz bandwidth of separation),
+// rising from the LORA_FREQ base through the upper half of the US 902-928
+// MHz ISM band. Node 0 keeps the legacy single carrier, and fleet
+// aggregate throughput scales with occupied channels instead of
+// time-sharing one channel's duty cycle. The chamber runs the same plan
+// from its config ("lorachan" = FLEET_NODE_ID % LORA_CHANNEL_COUNT).
 #define LORA_FREQ 915.0
+#define LORA_CHANNEL_COUNT 8
+#define LORA_CHANNEL_STEP_MHZ 0.8
+#define LORA_NODE_FREQ \
+    (LORA_FREQ + (FLEET_NODE_ID % LORA_CHANNEL_COUNT) * LORA_CHANNEL_STEP_MHZ)
 #define LORA_BANDWIDTH 250.0
 #define LORA_SPREAD 9
 #define LORA_CODING_RATE 7
@@ -78,52 +114,216 @@ typedef struct
 typedef struct
 {
     uint32_t sample_count; // Average sample number
-    uint16_t avg_f1;
-    uint16_t avg_f2;
-    uint16_t avg_fz;
-    uint16_t avg_f3;
-    uint16_t avg_f4;
-    uint16_t avg_f5;
-    uint16_t avg_fy;
-    uint16_t avg_f6;
-    uint16_t avg_fxl;
-    uint16_t avg_f7;
-    uint16_t avg_f8;
-    uint16_t avg_nir;
-    uint16_t avg_clear;
+    uint16_t avg[ORCA_NUM_CHANNELS]; // Channel averages, orca_channel_t order
+    uint16_t stddev[ORCA_NUM_CHANNELS]; // Per-channel stddev over the window
+    uint16_t min[ORCA_NUM_CHANNELS]; // Per-channel window minimum
+    uint16_t max[ORCA_NUM_CHANNELS]; // Per-channel window maximum
+    uint16_t batt_mv; // Pack voltage at report time (0 = not measured)
+    uint64_t sampled_wall_us; // RTC wall clock of the last sample folded in
+    uint64_t window_start_wall_us; // RTC wall clock of the first sample
     gps_fix_t gps; // GPS data
 } report_payload_t;
 
+// The store-and-forward queue holds these structs verbatim; a field added
+// here without resizing the slots silently disables the whole spill path
+// (every push fails its length guard)
+static_assert(sizeof(report_payload_t) <= REPORT_QUEUE_FRAME_MAX,
+              "report_payload_t outgrew the flash queue slot");
+
 /* ---------- RTC-retained accumulator ---------- */
 
-// RTC data struct to retain information between deep sleeps
+// Shared with the wake stub — layout defined in rtc_state.h
+extern "C" {
+RTC_DATA_ATTR satellite_rtc_state_t s_rtc_state;
+}
+
+// Runtime timing configuration: compile-time defaults unless an NVS
+// override (accepted over the air, see remote_config.h) exists
+static remote_config_t s_cfg;
+
+// Push the loaded configuration into RTC state so the wake stub uses the
+// same timing as the full application
+static void rtc_state_seed_config(void)
+{
+    s_rtc_state.cfg_transmit_cycle_ms = s_cfg.transmit_cycle_ms;
+    s_rtc_state.cfg_samples_per_transmit = s_cfg.samples_per_transmit;
+    s_rtc_state.cfg_gps_lock_timeout_ms = s_cfg.gps_lock_timeout_ms;
+}
+
+/* ---------- RTC-retained radio warm-start state ---------- */
+
+// Magic marking an SX1262 left in configuration-retention sleep across our deep sleep
+#define RADIO_RTC_MAGIC 0x5A126201UL
+
+// Survives deep sleep alongside s_rtc_state; valid only while the radio holds
+// its LoRa configuration in retention sleep
 RTC_DATA_ATTR static struct
 {
-    // Check RTC
     uint32_t magic;
-    uint32_t version;
-
-    // Check cycle counts
-    uint32_t cycle_sample_count; // Number of samples in the sum
-    uint32_t total_sample_count; // Overall sample number post-averaging
-
-    uint64_t first_sample_time_us;
-    uint64_t last_sample_time_us;
-
-    uint64_t sum_f1;
-    uint64_t sum_f2;
-    uint64_t sum_fz;
-    uint64_t sum_f3;
-    uint64_t sum_f4;
-    uint64_t sum_f5;
-    uint64_t sum_fy;
-    uint64_t sum_f6;
-    uint64_t sum_fxl;
-    uint64_t sum_f7;
-    uint64_t sum_f8;
-    uint64_t sum_nir;
-    uint64_t sum_clear;
-} s_rtc_state;
+} s_radio_rtc;
+
+// Check whether the radio can be woken via the fast register-restore path
+static bool radio_warm_start_available(void)
+{
+    return s_radio_rtc.magic == RADIO_RTC_MAGIC;
+}
+
+// Mark the sleeping radio as holding valid retained configuration
+static void radio_warm_start_arm(void)
+{
+    s_radio_rtc.magic = RADIO_RTC_MAGIC;
+}
+
+// Force the next wake to run the full begin() sequence
+static void radio_warm_start_invalidate(void)
+{
+    s_radio_rtc.magic = 0;
+}
+
+/* ---------- Per-phase CPU frequency scaling ---------- */
+
+// Most of a wake is peripheral-bound: the AS7343 integrates at I2C pace
+// and the GPS wait is 115200-baud UART. With DFS configured, the core
+// idles down to PM_CPU_MIN_MHZ through those phases and only the lock
+// holders below (payload build + SPI radio phase) run at full clock —
+// clock matched to workload through the longest-duration wake phases.
+#define PM_CPU_MAX_MHZ 160
+#define PM_CPU_MIN_MHZ 80
+
+static esp_pm_lock_handle_t s_cpu_max_lock;
+
+static void pm_init(void)
+{
+    esp_pm_config_t cfg = {};
+    cfg.max_freq_mhz = PM_CPU_MAX_MHZ;
+    cfg.min_freq_mhz = PM_CPU_MIN_MHZ;
+    // Light sleep stays off: the GPS UART drops RX data in light sleep
+    // (see as7343_config_t.light_sleep_wait for the same constraint)
+    cfg.light_sleep_enable = false;
+
+    esp_err_t err = esp_pm_configure(&cfg);
+    if (err != ESP_OK)
+    {
+        // ESP_ERR_NOT_SUPPORTED: CONFIG_PM_ENABLE is off in this build —
+        // run the whole wake at the default clock, as before
+        return;
+    }
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_LOCK_CPU_FREQ_MAX, 0,
+                                       "wake_cpu", &s_cpu_max_lock));
+}
+
+// Bracket the CPU-bound phases; everything outside a hold runs at
+// PM_CPU_MIN_MHZ
+static void pm_full_speed(bool on)
+{
+    if (s_cpu_max_lock == NULL)
+    {
+        return;
+    }
+    if (on)
+    {
+        esp_pm_lock_acquire(s_cpu_max_lock);
+    }
+    else
+    {
+        esp_pm_lock_release(s_cpu_max_lock);
+    }
+}
+
+/* ---------- Automatic exposure (gain + integration time) ---------- */
+
+// Fixed 256x gain saturates at tropical noon and buries dusk readings in
+// quantization noise. The controller inspects each wake's clear-channel
+// reading and steps exposure one notch per cycle toward the usable band
+// along two axes with very different costs: gain (free) and integration
+// time (every extra millisecond is spent awake on every future wake). So
+// underexposure spends the gain range first and only then lengthens the
+// integration, while overexposure sheds integration time before giving
+// up gain. Both choices live in RTC so the next wake starts correctly
+// exposed instead of burning a re-read on clipped data.
+#define AGC_REFERENCE_GAIN AS7343_GAIN_256X
+#define AGC_GAIN_MIN AS7343_GAIN_1X
+#define AGC_GAIN_MAX AS7343_GAIN_2048X
+#define AGC_HIGH_COUNTS 58000 // Near clipping — step exposure down
+#define AGC_LOW_COUNTS 1500   // Quantization territory — step exposure up
+
+// Integration ladder: astep doubles from the 1.67 ms driver default up
+// to ~50 ms (atime stays 0). Dark calibration is captured at the default
+// setting, so extended levels run with approximate dark subtraction — an
+// acceptable trade in the dim conditions that reach them.
+#define AIT_LEVELS 6
+static const uint16_t AIT_ASTEP[AIT_LEVELS] = {
+    599, 1199, 2399, 4799, 9599, 17999
+};
+
+// Recompute the combined Q16 normalization multiplier (as7343_norm.h)
+// after an exposure change. Cold path — runs only when a step actually
+// moved; the per-sample path just multiplies by the cached value, which
+// is also what lets the wake stub normalize without these tables.
+static void agc_norm_refresh(void)
+{
+    s_rtc_state.agc_norm_q16 = as7343_norm_mult_q16(
+        (uint8_t)s_rtc_state.agc_gain, 0, AIT_ASTEP[s_rtc_state.ait_level]);
+}
+
+// Normalize a raw count at the current gain and integration setting to
+// the reference "basic counts" scale (256x, default integration), so
+// windows that span an exposure change still average on one scale
+static IRAM_ATTR uint16_t agc_normalize(uint16_t raw)
+{
+    return as7343_norm_apply(raw, s_rtc_state.agc_norm_q16);
+}
+
+// Step exposure toward correct range based on this wake's raw clear
+// reading; takes effect on the sensor's next integration
+static IRAM_ATTR void agc_update(uint16_t clear_raw)
+{
+    uint32_t gain = s_rtc_state.agc_gain;
+    uint32_t level = s_rtc_state.ait_level;
+    if (clear_raw >= AGC_HIGH_COUNTS)
+    {
+        // Shedding integration first also shortens every future wake
+        if (level > 0)
+        {
+            level--;
+        }
+        else if (gain > AGC_GAIN_MIN)
+        {
+            gain--;
+        }
+    }
+    else if (clear_raw <= AGC_LOW_COUNTS)
+    {
+        // Gain first — it costs nothing; photons only get extra
+        // integration time once the gain range is exhausted
+        if (gain < AGC_GAIN_MAX)
+        {
+            gain++;
+        }
+        else if (level < AIT_LEVELS - 1)
+        {
+            level++;
+        }
+    }
+
+    if (gain != s_rtc_state.agc_gain &&
+        as7343_set_gain(s_sensor, (as7343_gain_t)gain) == ESP_OK)
+    {
+        SAT_LOGI("AGC: gain step %lu -> %lu (clear=%u)\n",
+               (unsigned long)s_rtc_state.agc_gain, (unsigned long)gain,
+               clear_raw);
+        s_rtc_state.agc_gain = gain;
+        agc_norm_refresh();
+    }
+    if (level != s_rtc_state.ait_level &&
+        as7343_set_integration_time(s_sensor, 0, AIT_ASTEP[level]) == ESP_OK)
+    {
+        SAT_LOGI("AIT: astep %u -> %u (clear=%u)\n",
+               AIT_ASTEP[s_rtc_state.ait_level], AIT_ASTEP[level], clear_raw);
+        s_rtc_state.ait_level = level;
+        agc_norm_refresh();
+    }
+}
 
 /* ---------- RTC-retained state helpers ---------- */
 
@@ -133,20 +333,17 @@ static void rtc_state_clear_accumulator(void)
     s_rtc_state.cycle_sample_count = 0;
     s_rtc_state.first_sample_time_us = 0;
     s_rtc_state.last_sample_time_us = 0;
+    s_rtc_state.first_sample_wall_us = 0;
+
+    memset(s_rtc_state.sums, 0, sizeof(s_rtc_state.sums));
+    memset(s_rtc_state.sum_sq, 0, sizeof(s_rtc_state.sum_sq));
+    memset(s_rtc_state.mins, 0xFF, sizeof(s_rtc_state.mins)); // 0xFFFF each
+    memset(s_rtc_state.maxs, 0, sizeof(s_rtc_state.maxs));
+    memset(s_rtc_state.window, 0, sizeof(s_rtc_state.window));
 
-    s_rtc_state.sum_f1 = 0;
-    s_rtc_state.sum_f2 = 0;
-    s_rtc_state.sum_fz = 0;
-    s_rtc_state.sum_f3 = 0;
-    s_rtc_state.sum_f4 = 0;
-    s_rtc_state.sum_f5 = 0;
-    s_rtc_state.sum_fy = 0;
-    s_rtc_state.sum_f6 = 0;
-    s_rtc_state.sum_fxl = 0;
-    s_rtc_state.sum_f7 = 0;
-    s_rtc_state.sum_f8 = 0;
-    s_rtc_state.sum_nir = 0;
-    s_rtc_state.sum_clear = 0;
+    // The burst tag covers one accumulation window; the governor itself
+    // (burst_remaining, last-clear tracking) outlives the report
+    s_rtc_state.burst_in_cycle = 0;
 }
 
 // Reset the s_rtc_state data struct
@@ -157,74 +354,263 @@ static void rtc_state_full_reset(void)
     s_rtc_state.version = RTC_STATE_VERSION;
     rtc_state_clear_accumulator();
     s_rtc_state.total_sample_count = 0;
+
+    // Safe timing defaults until remote_config_load() has run
+    s_rtc_state.cfg_transmit_cycle_ms = (uint32_t)TRANSMIT_CYCLE_MS;
+    s_rtc_state.cfg_samples_per_transmit = SAMPLES_PER_TRANSMIT;
+    s_rtc_state.cfg_gps_lock_timeout_ms = (uint32_t)GPS_LOCK_TIMEOUT_MS;
+
+    s_rtc_state.agc_gain = AS7343_GAIN_256X;
+    s_rtc_state.ait_level = 0;
+    agc_norm_refresh();  // identity at the reference exposure
+
+    s_rtc_state.clk_cal_q16 = CLK_CAL_ONE_Q16; // uncalibrated until two fixes
+}
+
+// Set when rtc_state_init_if_needed() had to wipe state (full power loss)
+static bool s_rtc_cold_boot = false;
+
+// CRC + magic/version check of one snapshot bank (see rtc_state.h)
+static bool rtc_bank_valid(const rtc_state_bank_t *bank)
+{
+    return bank->state.magic == RTC_STATE_MAGIC &&
+           bank->state.version == RTC_STATE_VERSION &&
+           bank->crc == rtc_state_crc32(bank, sizeof(*bank) - sizeof(bank->crc));
 }
 
 // Init the s_rtc_state data struct if uninitialized
 static void rtc_state_init_if_needed(void)
 {
-    if (s_rtc_state.magic != RTC_STATE_MAGIC ||
-        s_rtc_state.version != RTC_STATE_VERSION)
+    if (s_rtc_state.magic == RTC_STATE_MAGIC &&
+        s_rtc_state.version == RTC_STATE_VERSION)
+    {
+        return;
+    }
+
+    // Before nuking a full transmit window of samples, try the snapshot
+    // banks: a marginal brownout or bit flip usually corrupts the live
+    // copy while at least one CRC-checked snapshot survives intact
+    const rtc_state_bank_t *best = NULL;
+    for (int i = 0; i < 2; i++)
+    {
+        if (rtc_bank_valid(&s_rtc_banks[i]) &&
+            (best == NULL || s_rtc_banks[i].seq > best->seq))
+        {
+            best = &s_rtc_banks[i];
+        }
+    }
+    if (best != NULL)
+    {
+        s_rtc_state = best->state;
+        SAT_LOGI("RTC state corrupt; recovered from snapshot bank (commit %lu)\n",
+               (unsigned long)best->seq);
+        return;
+    }
+
+    rtc_state_full_reset();
+    s_rtc_cold_boot = true;
+}
+
+/* ---------- Sequence continuity across power loss ---------- */
+
+// total_sample_count lives in RTC memory and dies with it on a full power
+// loss (battery swap, deep solar brownout), which used to restart the
+// sequence at zero and break receiver-side gap detection and dedup.
+// Checkpoint the counter to NVS every SEQ_CHECKPOINT_INTERVAL transmits to
+// bound flash wear, and restore it on cold boot with a forward jump past
+// the worst-case un-checkpointed span so the sequence never runs backwards.
+#define SEQ_NVS_NAMESPACE "orca_seq"
+#define SEQ_NVS_KEY "total_samples"
+#define SEQ_CHECKPOINT_INTERVAL 16UL
+
+// Advance the sequence counter, periodically checkpointing it to NVS.
+// Call once per transmit (LoRa or RS-485), never per raw sample.
+static void seq_advance(void)
+{
+    s_rtc_state.total_sample_count++;
+    if (s_rtc_state.total_sample_count % SEQ_CHECKPOINT_INTERVAL != 0)
+    {
+        return;
+    }
+    nvs_handle_t h;
+    if (nvs_open(SEQ_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK)
+    {
+        return;
+    }
+    if (nvs_set_u32(h, SEQ_NVS_KEY, s_rtc_state.total_sample_count) == ESP_OK)
+    {
+        nvs_commit(h);
+    }
+    nvs_close(h);
+}
+
+// After a cold boot, resume the sequence from the last NVS checkpoint.
+// Must run after remote_config_load() (which brings up NVS).
+static void seq_restore_if_cold_boot(void)
+{
+    if (!s_rtc_cold_boot)
+    {
+        return;
+    }
+    nvs_handle_t h;
+    if (nvs_open(SEQ_NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK)
     {
-        rtc_state_full_reset();
+        return; // Nothing checkpointed yet — zero is genuinely correct
     }
+    uint32_t saved = 0;
+    esp_err_t err = nvs_get_u32(h, SEQ_NVS_KEY, &saved);
+    nvs_close(h);
+    if (err != ESP_OK)
+    {
+        return;
+    }
+    // Jump a full interval past the checkpoint: numbers in the
+    // un-checkpointed gap may already be on the air, and a duplicate is
+    // worse for receiver-side dedup than a small hole
+    s_rtc_state.total_sample_count = saved + SEQ_CHECKPOINT_INTERVAL;
+    SAT_LOGI("Sequence restored from NVS checkpoint: resuming at %lu\n",
+           (unsigned long)s_rtc_state.total_sample_count);
 }
 
+// Copy a driver sample into orca_channel_t (wire) order
+static IRAM_ATTR void as7343_to_channel_array(const as7343_channels_t *ch,
+                                    uint16_t out[ORCA_NUM_CHANNELS])
+{
+    out[ORCA_CH_F1]    = ch->f1;
+    out[ORCA_CH_F2]    = ch->f2;
+    out[ORCA_CH_FZ]    = ch->fz;
+    out[ORCA_CH_F3]    = ch->f3;
+    out[ORCA_CH_F4]    = ch->f4;
+    out[ORCA_CH_F5]    = ch->f5;
+    out[ORCA_CH_FY]    = ch->fy;
+    out[ORCA_CH_F6]    = ch->f6;
+    out[ORCA_CH_FXL]   = ch->fxl;
+    out[ORCA_CH_F7]    = ch->f7;
+    out[ORCA_CH_F8]    = ch->f8;
+    out[ORCA_CH_NIR]   = ch->nir;
+    out[ORCA_CH_CLEAR] = ch->clear;
+}
+
+// RTC wall clock — defined with the GPS cache below
+static uint64_t rtc_wall_us(void);
+
 // Add a sample to the s_rtc_state data struct
-static void rtc_state_add_sample(const as7343_channels_t *ch, uint64_t timestamp_us)
+static IRAM_ATTR void rtc_state_add_sample(const as7343_channels_t *ch, uint64_t timestamp_us)
 {
-    // If adding the first sample, record the first_sample_time_us
+    // If adding the first sample, record the first_sample_time_us — and
+    // its wall-clock twin, which survives the deep sleeps between here
+    // and the report build (the esp_timer stamp restarts every wake)
     if (s_rtc_state.cycle_sample_count == 0)
     {
         s_rtc_state.first_sample_time_us = timestamp_us;
+        s_rtc_state.first_sample_wall_us =
+            rtc_wall_us() - ((uint64_t)esp_timer_get_time() - timestamp_us);
     }
 
     s_rtc_state.last_sample_time_us = timestamp_us;
+    uint32_t slot = s_rtc_state.cycle_sample_count % ROBUST_WINDOW_N;
     s_rtc_state.cycle_sample_count++;
 
-    s_rtc_state.sum_f1 += ch->f1;
-    s_rtc_state.sum_f2 += ch->f2;
-    s_rtc_state.sum_fz += ch->fz;
-    s_rtc_state.sum_f3 += ch->f3;
-    s_rtc_state.sum_f4 += ch->f4;
-    s_rtc_state.sum_f5 += ch->f5;
-    s_rtc_state.sum_fy += ch->fy;
-    s_rtc_state.sum_f6 += ch->f6;
-    s_rtc_state.sum_fxl += ch->fxl;
-    s_rtc_state.sum_f7 += ch->f7;
-    s_rtc_state.sum_f8 += ch->f8;
-    s_rtc_state.sum_nir += ch->nir;
-    s_rtc_state.sum_clear += ch->clear;
+    uint16_t values[ORCA_NUM_CHANNELS];
+    as7343_to_channel_array(ch, values);
+    for (size_t i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+        uint16_t v = agc_normalize(values[i]);
+        s_rtc_state.sums[i] += v;
+        s_rtc_state.sum_sq[i] += (uint32_t)v * v;
+        if (v < s_rtc_state.mins[i]) s_rtc_state.mins[i] = v;
+        if (v > s_rtc_state.maxs[i]) s_rtc_state.maxs[i] = v;
+        s_rtc_state.window[i][slot] = v;
+    }
+
+    // Transient burst detector: a jump between consecutive normalized
+    // clear-channel samples that clears both the absolute floor and a
+    // quarter of the previous reading means a fast optical edge (cloud,
+    // shadow) is in progress — arm the fast-cadence governor so it gets
+    // sampled rather than aliased. Mirrored in wake_stub.c.
+    uint16_t clear_v = agc_normalize(values[ORCA_CH_CLEAR]);
+    if (s_rtc_state.burst_last_valid)
+    {
+        uint16_t prev = s_rtc_state.burst_last_clear;
+        uint16_t diff = clear_v > prev ? clear_v - prev : prev - clear_v;
+        if (diff >= BURST_CLEAR_DELTA_MIN && (uint32_t)diff * 4 >= prev)
+        {
+            s_rtc_state.burst_remaining = BURST_WAKES;
+        }
+    }
+    s_rtc_state.burst_last_clear = clear_v;
+    s_rtc_state.burst_last_valid = 1;
+    if (s_rtc_state.burst_remaining > 0)
+    {
+        s_rtc_state.burst_in_cycle = 1;
+    }
 }
 
-// Averaging function with edge case check
-static uint16_t avg_u16(uint64_t sum, uint32_t count)
+// How the per-channel report value is aggregated from the window. The
+// primitives themselves (mean/median/trimmed, isqrt) live in orca_agg.h in
+// the orca_payload component — pure integer code the host test harness
+// exercises directly.
+#define REPORT_AGG_MODE  ORCA_AGG_MEDIAN
+
+// Population stddev from the retained sum / sum-of-squares:
+//   var = (n*sum_sq - sum^2) / n^2
+// All-integer; n*sum_sq tops out around 2^56 for any realistic window.
+static uint16_t stddev_u16(uint64_t sum, uint64_t sum_sq, uint32_t count)
 {
     if (count == 0)
     {
         return 0;
     }
-    return (uint16_t)(sum / count);
+    uint64_t n = count;
+    uint64_t num = n * sum_sq - sum * sum;
+    return (uint16_t)orca_isqrt_u64(num / (n * n));
 }
 
-// Populate a report_payload_t struct
-static void rtc_state_build_report(report_payload_t *report, const gps_fix_t *gps)
+// RTC wall clock — defined with the GPS cache below
+static uint64_t rtc_wall_us(void);
+
+// Populate a report_payload_t struct from an accumulator bank — either the
+// live s_rtc_state or the transmit path's private snapshot (bank A), which
+// is what lets sampling continue into the live copy during a transmit
+static void rtc_state_build_report(const satellite_rtc_state_t *acc,
+                                   report_payload_t *report, const gps_fix_t *gps)
 {
     memset(report, 0, sizeof(*report));
 
-    report->sample_count = s_rtc_state.total_sample_count;
-    report->avg_f1 = avg_u16(s_rtc_state.sum_f1, s_rtc_state.cycle_sample_count);
-    report->avg_f2 = avg_u16(s_rtc_state.sum_f2, s_rtc_state.cycle_sample_count);
-    report->avg_fz = avg_u16(s_rtc_state.sum_fz, s_rtc_state.cycle_sample_count);
-    report->avg_f3 = avg_u16(s_rtc_state.sum_f3, s_rtc_state.cycle_sample_count);
-    report->avg_f4 = avg_u16(s_rtc_state.sum_f4, s_rtc_state.cycle_sample_count);
-    report->avg_f5 = avg_u16(s_rtc_state.sum_f5, s_rtc_state.cycle_sample_count);
-    report->avg_fy = avg_u16(s_rtc_state.sum_fy, s_rtc_state.cycle_sample_count);
-    report->avg_f6 = avg_u16(s_rtc_state.sum_f6, s_rtc_state.cycle_sample_count);
-    report->avg_fxl = avg_u16(s_rtc_state.sum_fxl, s_rtc_state.cycle_sample_count);
-    report->avg_f7 = avg_u16(s_rtc_state.sum_f7, s_rtc_state.cycle_sample_count);
-    report->avg_f8 = avg_u16(s_rtc_state.sum_f8, s_rtc_state.cycle_sample_count);
-    report->avg_nir = avg_u16(s_rtc_state.sum_nir, s_rtc_state.cycle_sample_count);
-    report->avg_clear = avg_u16(s_rtc_state.sum_clear, s_rtc_state.cycle_sample_count);
+    report->sample_count = acc->total_sample_count;
+    for (size_t i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+#if REPORT_AGG_MODE == ORCA_AGG_MEAN
+        report->avg[i] = orca_avg_u16(acc->sums[i], acc->cycle_sample_count);
+#else
+        // Sun-glint / shadow spikes in a short window would skew a plain
+        // mean; the robust aggregate over the raw-sample ring survives them
+        report->avg[i] = orca_robust_agg_u16(acc->window[i],
+                                             acc->cycle_sample_count,
+                                             ROBUST_WINDOW_N, REPORT_AGG_MODE);
+#endif
+        report->stddev[i] = stddev_u16(acc->sums[i], acc->sum_sq[i],
+                                       acc->cycle_sample_count);
+        // mins rest at 0xFFFF until the first sample lands
+        report->min[i] = (acc->cycle_sample_count > 0) ? acc->mins[i] : 0;
+        report->max[i] = acc->maxs[i];
+    }
+
+    report->batt_mv = s_batt_mv;
+
+    // Translate the esp_timer sample stamp onto the RTC wall clock, which
+    // keeps counting while a batched report waits in RTC memory. The final
+    // sample always lands in the same wake as the report build, so the
+    // esp_timer delta is valid here.
+    report->sampled_wall_us =
+        rtc_wall_us() -
+        ((uint64_t)esp_timer_get_time() - acc->last_sample_time_us);
+
+    // Stub-opened windows carry no wall stamp for their first sample;
+    // collapse the window onto its last sample rather than invent a start
+    report->window_start_wall_us =
+        (acc->first_sample_wall_us != 0) ? acc->first_sample_wall_us
+                                         : report->sampled_wall_us;
 
     if (gps != NULL)
     {
@@ -232,53 +618,308 @@ static void rtc_state_build_report(report_payload_t *report, const gps_fix_t *gp
     }
 }
 
+/* ---------- Battery monitoring ---------- */
+
+// Pack voltage through a 100k/100k divider on GPIO1 (ADC1 channel 1 —
+// GPIO4/channel 4 belongs to the AS7343 data-ready interrupt, and the
+// radio, SPI bus and GPS own GPIO0/2/3/5/6). Below the TX cutoff the
+// ~120 mA radio burst browns the regulator out, which reset-loops the
+// chip and wipes RTC state — an accumulate-only cycle is strictly better
+// than that.
+#define BATT_ADC_UNIT ADC_UNIT_1
+#define BATT_ADC_CHANNEL ADC_CHANNEL_1
+#define BATT_DIVIDER_NUM 2   // Divider halves the pack voltage
+#define BATT_TX_CUTOFF_MV 3500
+
+// Measured once per wake in app_main; 0 when the read failed
+static uint16_t s_batt_mv;
+
+// One-shot ADC read of the pack voltage in millivolts
+static uint16_t read_battery_mv(void)
+{
+    adc_oneshot_unit_handle_t unit = NULL;
+    adc_oneshot_unit_init_cfg_t unit_cfg = {};
+    unit_cfg.unit_id = BATT_ADC_UNIT;
+    if (adc_oneshot_new_unit(&unit_cfg, &unit) != ESP_OK)
+    {
+        return 0;
+    }
+
+    adc_oneshot_chan_cfg_t chan_cfg = {};
+    chan_cfg.atten = ADC_ATTEN_DB_12; // Full divider range
+    chan_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    adc_oneshot_config_channel(unit, BATT_ADC_CHANNEL, &chan_cfg);
+
+    // eFuse curve-fitting calibration when available, linear fallback else
+    adc_cali_handle_t cali = NULL;
+    adc_cali_curve_fitting_config_t cali_cfg = {};
+    cali_cfg.unit_id = BATT_ADC_UNIT;
+    cali_cfg.atten = ADC_ATTEN_DB_12;
+    cali_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    bool calibrated =
+        adc_cali_create_scheme_curve_fitting(&cali_cfg, &cali) == ESP_OK;
+
+    int raw = 0;
+    int mv = 0;
+    if (adc_oneshot_read(unit, BATT_ADC_CHANNEL, &raw) == ESP_OK)
+    {
+        if (!calibrated || adc_cali_raw_to_voltage(cali, raw, &mv) != ESP_OK)
+        {
+            mv = raw * 3300 / 4095;
+        }
+    }
+
+    if (calibrated)
+    {
+        adc_cali_delete_scheme_curve_fitting(cali);
+    }
+    adc_oneshot_del_unit(unit);
+
+    return (uint16_t)(mv * BATT_DIVIDER_NUM);
+}
+
+/* ---------- Day/night power governor ---------- */
+
+// The AS7343's broadband clear channel doubles as a free ambient-light
+// sensor. Below the enter threshold the governor stretches every sleep by
+// NIGHT_SLEEP_MULTIPLIER, skips GPS entirely and transmits only a small
+// heartbeat; above the exit threshold normal operation resumes. The gap
+// between the thresholds keeps dusk from flapping the mode.
+#define NIGHT_CLEAR_ENTER 40  // Clear-channel average below this = night
+#define NIGHT_CLEAR_EXIT 120  // Above this = day again
+
+// Re-evaluate night_mode from the accumulated clear-channel average
+static void night_mode_update(void)
+{
+    uint16_t clear_avg = orca_avg_u16(s_rtc_state.sums[ORCA_CH_CLEAR],
+                                 s_rtc_state.cycle_sample_count);
+    if (!s_rtc_state.night_mode && clear_avg < NIGHT_CLEAR_ENTER)
+    {
+        s_rtc_state.night_mode = 1;
+        SAT_LOGI("Night mode entered (clear avg %u)\n", clear_avg);
+    }
+    else if (s_rtc_state.night_mode && clear_avg > NIGHT_CLEAR_EXIT)
+    {
+        s_rtc_state.night_mode = 0;
+        SAT_LOGI("Night mode left (clear avg %u)\n", clear_avg);
+    }
+}
+
 /* ---------- Hardware init ---------- */
 
-static void init_i2c_and_sensor(void)
+// A transient I2C glitch (salt-air corrosion, connector vibration) should
+// cost one retry, not a reboot loop: tear the bus down completely between
+// attempts and back off exponentially
+#define SENSOR_INIT_ATTEMPTS 3
+#define SENSOR_INIT_BACKOFF_MS 100
+
+// Bring up the I2C bus and the AS7343. On persistent failure s_sensor
+// stays NULL and the caller degrades the wake to heartbeat-only — on a
+// mast-mounted node, uptime is throughput.
+static esp_err_t init_i2c_and_sensor(void)
 {
-    i2c_master_bus_config_t bus_cfg = {};
-    bus_cfg.clk_source = I2C_CLK_SRC_DEFAULT;
-    bus_cfg.i2c_port = I2C_PORT;
-    bus_cfg.scl_io_num = I2C_SCL_GPIO;
-    bus_cfg.sda_io_num = I2C_SDA_GPIO;
-    bus_cfg.glitch_ignore_cnt = 7;
-    bus_cfg.flags.enable_internal_pullup = true;
+    prof_stage_begin(PROF_STAGE_I2C_INIT);
+
+    esp_err_t err = ESP_FAIL;
+    for (int attempt = 0; attempt < SENSOR_INIT_ATTEMPTS; attempt++)
+    {
+        if (attempt > 0)
+        {
+            uint32_t backoff_ms = SENSOR_INIT_BACKOFF_MS << (attempt - 1);
+            SAT_LOGI("Sensor init attempt %d failed (%s); retrying in %lu ms\n",
+                   attempt, esp_err_to_name(err), (unsigned long)backoff_ms);
+            vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+        }
+
+        i2c_master_bus_config_t bus_cfg = {};
+        bus_cfg.clk_source = I2C_CLK_SRC_DEFAULT;
+        bus_cfg.i2c_port = I2C_PORT;
+        bus_cfg.scl_io_num = I2C_SCL_GPIO;
+        bus_cfg.sda_io_num = I2C_SDA_GPIO;
+        bus_cfg.glitch_ignore_cnt = 7;
+        bus_cfg.flags.enable_internal_pullup = true;
+
+        err = i2c_new_master_bus(&bus_cfg, &s_i2c_bus);
+        if (err != ESP_OK)
+        {
+            s_i2c_bus = NULL;
+            continue;
+        }
+
+        as7343_config_t cfg = AS7343_CONFIG_DEFAULT;
+        cfg.int_gpio = AS7343_INT_GPIO;
+        // Fast mode needs real pull-ups: both lines must idle high. A line
+        // reading low here (missing pull-up, corroded harness) would produce
+        // marginal edges at 400 kHz, so drop back to standard mode instead.
+        if (gpio_get_level(I2C_SCL_GPIO) == 0 || gpio_get_level(I2C_SDA_GPIO) == 0)
+        {
+            SAT_LOGI("I2C bus not idling high — falling back to 100 kHz\n");
+            cfg.i2c_clock_speed = I2C_AS7343_DEV_CLK_SPD_SAFE;
+        }
+        // Start at the retained exposure (gain and integration time) so
+        // the first integration of this wake is already correctly exposed
+        cfg.gain = (as7343_gain_t)s_rtc_state.agc_gain;
+        if (s_rtc_state.ait_level < AIT_LEVELS)
+        {
+            cfg.astep = AIT_ASTEP[s_rtc_state.ait_level];
+        }
+        cfg.smux_mode = SENSOR_SMUX_MODE;
+        // Light-sleep through integration waits on sensor-only wakes. Transmit
+        // wakes overlap the sensor read with background GPS acquisition on
+        // UART, and light sleep would drop NMEA bytes.
+        cfg.light_sleep_wait =
+            (s_rtc_state.cycle_sample_count + SAMPLES_PER_WAKE <
+             s_rtc_state.cfg_samples_per_transmit);
+
+        // Static driver context: this line runs on every wake, and the
+        // handle never survives deep sleep anyway — no reason to pay the
+        // allocator each time
+        err = as7343_init_static(s_i2c_bus, &cfg, &s_sensor);
+        if (err == ESP_OK)
+        {
+            break;
+        }
 
-    ESP_ERROR_CHECK(i2c_new_master_bus(&bus_cfg, &s_i2c_bus));
+        // Full bus teardown: deleting the bus driver releases the pads, so
+        // a slave holding SDA low gets a fresh START on the next attempt
+        s_sensor = NULL;
+        i2c_del_master_bus(s_i2c_bus);
+        s_i2c_bus = NULL;
+    }
 
-    as7343_config_t cfg = AS7343_CONFIG_DEFAULT;
-    ESP_ERROR_CHECK(as7343_init(s_i2c_bus, &cfg, &s_sensor));
+    prof_stage_end(PROF_STAGE_I2C_INIT);
+    return err;
 }
 
 /* ---------- Sensor ---------- */
 
+/* The per-sample chain below is IRAM_ATTR: each deep-sleep wake executes
+ * it through a cold flash cache, and XIP fetch stalls land exactly while
+ * we are racing back to sleep. IRAM residency makes that cost zero across
+ * every wake of a deployment. The operand data is already in DRAM/RTC RAM
+ * (s_rtc_state and the stack); the once-per-wake init and driver paths
+ * stay in flash, where they are dominated by I2C/UART transactions anyway
+ * and IRAM is too scarce to spend on them. The wake stub (wake_stub.c)
+ * already follows the same pattern with RTC_IRAM_ATTR. */
+
 // Poll sensor and record sample to s_rtc_state data struct
-static esp_err_t read_sensor_and_accumulate(void)
+static IRAM_ATTR esp_err_t read_sensor_and_accumulate(void)
 {
+    if (s_sensor == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
     as7343_channels_t ch = {0};
     uint64_t now_us = (uint64_t)esp_timer_get_time();
 
+    prof_stage_begin(PROF_STAGE_SENSOR_READ);
     esp_err_t err = as7343_get_spectral_data(s_sensor, &ch);
     if (err != ESP_OK)
     {
+        prof_fault_count(PROF_FAULT_SENSOR_I2C);
+        prof_stage_end(PROF_STAGE_SENSOR_READ);
         return err;
     }
 
     // Add local sample to s_rtc_state data struct
     rtc_state_add_sample(&ch, now_us);
 
+    // Re-aim the exposure for the next integration from this raw reading
+    agc_update(ch.clear);
+    prof_stage_end(PROF_STAGE_SENSOR_READ);
+
     // DEBUG: Reports sampling event to Serial monitor
-    printf("Stored sample #%lu\n", (unsigned long)s_rtc_state.total_sample_count);
-    printf("F1=%u F2=%u FZ=%u F3=%u\n", ch.f1, ch.f2, ch.fz, ch.f3);
-    printf("F4=%u F5=%u FY=%u F6=%u\n", ch.f4, ch.f5, ch.fy, ch.f6);
-    printf("FXL=%u F7=%u F8=%u NIR=%u CLEAR=%u\n",
+    SAT_LOGT("Stored sample #%lu\n", (unsigned long)s_rtc_state.total_sample_count);
+    SAT_LOGT("F1=%u F2=%u FZ=%u F3=%u\n", ch.f1, ch.f2, ch.fz, ch.f3);
+    SAT_LOGT("F4=%u F5=%u FY=%u F6=%u\n", ch.f4, ch.f5, ch.fy, ch.f6);
+    SAT_LOGT("FXL=%u F7=%u F8=%u NIR=%u CLEAR=%u\n",
            ch.fxl, ch.f7, ch.f8, ch.nir, ch.clear);
 
     return ESP_OK;
 }
 
+/* ---------- Double-banked accumulator ---------- */
+
+// Bank A: the transmit path's private snapshot of the accumulator. The
+// swap (copy + clear of the live state) happens before any of the slow
+// transmit work, so samples taken while GPS and the radio block land in
+// the freshly cleared live copy (bank B) instead of a sampling blackout.
+// Not RTC-retained on purpose: the snapshot only lives within one wake,
+// and any report worth keeping is already staged in s_batch_rtc or the
+// flash queue by the time the node sleeps.
+static satellite_rtc_state_t s_acc_bank;
+
+// Background sampler: keeps the configured sampling cadence running in
+// the live bank while the transmit tail blocks (GPS join up to 5 s plus
+// radio airtime). Same start/join shape as the concurrent GPS task. The
+// sensor I2C bus is exclusively this task's between start and join — the
+// transmit path's flicker check runs before the bank swap.
+static SemaphoreHandle_t s_bg_sample_stop;
+static SemaphoreHandle_t s_bg_sample_done;
+static bool s_bg_sample_running;
+
+static void bg_sample_task(void *arg)
+{
+    uint32_t period_ms = (uint32_t)(s_rtc_state.cfg_transmit_cycle_ms /
+                                    s_rtc_state.cfg_samples_per_transmit);
+    // Wait first: this wake's scheduled sample is already in the bank
+    while (xSemaphoreTake(s_bg_sample_stop, pdMS_TO_TICKS(period_ms)) != pdTRUE)
+    {
+        if (read_sensor_and_accumulate() != ESP_OK)
+        {
+            break; // sensor trouble — stop quietly, the next wake retries
+        }
+    }
+    xSemaphoreGive(s_bg_sample_done);
+    vTaskDelete(NULL);
+}
+
+static void bg_sampling_start(void)
+{
+    if (s_sensor == NULL || s_rtc_state.cfg_samples_per_transmit == 0)
+    {
+        return;
+    }
+    if (s_bg_sample_stop == NULL)
+    {
+        s_bg_sample_stop = xSemaphoreCreateBinary();
+        s_bg_sample_done = xSemaphoreCreateBinary();
+    }
+    if (s_bg_sample_stop == NULL || s_bg_sample_done == NULL)
+    {
+        return; // degrade to the old blackout behavior
+    }
+    // Drain a stop token left behind by a sampler that exited on its own
+    xSemaphoreTake(s_bg_sample_stop, 0);
+    if (xTaskCreate(bg_sample_task, "bg_sample", 4096, NULL, 5, NULL) == pdPASS)
+    {
+        s_bg_sample_running = true;
+    }
+}
+
+static void bg_sampling_join(void)
+{
+    if (!s_bg_sample_running)
+    {
+        return;
+    }
+    xSemaphoreGive(s_bg_sample_stop);
+    // A sampler mid-read finishes its I2C burst first; bound the wait to
+    // well past one integration rather than trusting it blindly
+    xSemaphoreTake(s_bg_sample_done, pdMS_TO_TICKS(2000));
+    s_bg_sample_running = false;
+}
+
 /* ---------- GPS / LoRa placeholders ---------- */
 
+// Early-abort probe: with the antenna obstructed (below-deck stowage,
+// heavy icing) no fix will come however long we wait. If after this window
+// nothing is tracked — zero satellites, or a dilution so large the solution
+// is meaningless — give up at once instead of burning the full lock timeout.
+#define GPS_PROBE_WINDOW_MS 500
+#define GPS_PDOP_ABSURD 20.0f
+
 static esp_err_t get_gps_fix(gps_fix_t *fix)
 {
     if (fix == NULL)
@@ -288,184 +929,2316 @@ static esp_err_t get_gps_fix(gps_fix_t *fix)
 
     memset(fix, 0, sizeof(*fix));
 
+    // Wall time including the lock wait; runs inside the GPS task when
+    // acquisition is overlapped
+    prof_stage_begin(PROF_STAGE_GPS_FIX);
+
     // Initialize GPS
     gps_init();
     gps_data_t data;
 
-    setenv("TZ", "UTC0", 1); // GPS always outputs UTC
-    tzset();
+    // Once per boot, not per attempt: the environment doesn't survive deep
+    // sleep, but repeated fix calls within a wake needn't redo tzset()
+    static bool s_tz_set = false;
+    if (!s_tz_set)
+    {
+        setenv("TZ", "UTC0", 1); // GPS always outputs UTC
+        tzset();
+        s_tz_set = true;
+    }
 
     int64_t start = esp_timer_get_time();
     do
     {
         gps_update();
         gps_get_data(&data);
-        if ((esp_timer_get_time() - start) >= (int64_t)GPS_LOCK_TIMEOUT_MS * 1000)
+        int64_t waited_us = esp_timer_get_time() - start;
+        if (waited_us >= (int64_t)GPS_PROBE_WINDOW_MS * 1000 && !data.valid &&
+            (data.satellites == 0 || data.pdop > GPS_PDOP_ABSURD))
+        {
+            SAT_LOGI("GPS probe hopeless (%d sats, pdop %.1f) — aborting early\n",
+                   data.satellites, data.pdop);
+            fix->valid = false;
+            gps_sleep();
+            prof_stage_end(PROF_STAGE_GPS_FIX);
+            return ESP_OK;
+        }
+        if (waited_us >=
+            (int64_t)s_rtc_state.cfg_gps_lock_timeout_ms * 1000)
         {
+            prof_fault_count(PROF_FAULT_GPS_TIMEOUT);
             fix->valid = false;
             fix->latitude_deg = 0.0;
             fix->longitude_deg = 0.0;
             fix->unix_time = 0;
-            return ESP_OK;
 
-            // TODO: Put GPS to warm-sleep between cycles via UART TX
+            // No navigation fix, but the receiver is awake and its clock is
+            // usually set long before position converges. One time-only hit
+            // (RMC header match / next PVT — no coordinate conversion) trues
+            // up the wall clock so the cache-extrapolated timestamps served
+            // while this fix ages don't ride accumulated RTC drift.
+            if (gps_refresh_time(250))
+            {
+                gps_get_data(&data);
+                time_t utc = mktime(&data.datetime);
+                struct timeval now;
+                gettimeofday(&now, NULL);
+                if (now.tv_sec != utc)
+                {
+                    struct timeval tv = {};
+                    tv.tv_sec = utc;
+                    settimeofday(&tv, NULL);
+                }
+            }
+
+            // Still warm-sleep the receiver: it keeps refining its ephemeris
+            // snapshot in backup RAM and the next attempt starts warm
+            gps_sleep();
+            prof_stage_end(PROF_STAGE_GPS_FIX);
+            return ESP_OK;
         }
     } while (!data.valid || !data.datetime_valid);
 
     time_t unix_time = mktime(&data.datetime);
 
-    printf("Lat:       %.6f\n", data.latitude);
-    printf("Lon:       %.6f\n", data.longitude);
-    printf("Unix Time: %lld\n", (long long)unix_time);
+    SAT_LOGD("Lat:       %.6f\n", data.latitude);
+    SAT_LOGD("Lon:       %.6f\n", data.longitude);
+    SAT_LOGD("Unix Time: %lld\n", (long long)unix_time);
 
     fix->valid = true;
     fix->latitude_deg = data.latitude;
     fix->longitude_deg = data.longitude;
     fix->unix_time = unix_time;
 
+    // Fix consumed — park the receiver in backup mode until the next cycle
+    gps_sleep();
+
+    prof_stage_end(PROF_STAGE_GPS_FIX);
     return ESP_OK;
 }
 
-// Send LoRa packet
-static esp_err_t lora_send_report(const report_payload_t *report)
+/* ---------- GPS duty cycling ---------- */
+
+// A moored or slow platform does not need a fresh fix every transmit cycle.
+// Reuse the last valid fix for up to GPS_REUSE_CYCLES reports (advancing its
+// timestamp from the RTC wall clock, which runs through deep sleep) and only
+// re-acquire on the Mth cycle or once the fix ages out.
+
+#define GPS_REUSE_CYCLES 6      // Fresh acquisition every Mth transmit cycle
+#define GPS_FIX_MAX_AGE_S 120   // Staleness budget regardless of cycle count
+
+#define GPS_CACHE_MAGIC 0x6F5CACE1UL
+RTC_DATA_ATTR static struct
+{
+    uint32_t magic;
+    uint32_t reuse_count;       // Reports served from this fix so far
+    uint64_t acquired_wall_us;  // RTC wall clock at acquisition
+    gps_fix_t fix;
+} s_gps_cache;
+
+// RTC wall clock; unlike esp_timer it keeps counting through deep sleep
+static uint64_t rtc_wall_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+// True while the cached fix may stand in for a fresh acquisition
+static bool gps_cache_fresh(void)
 {
-    if (report == NULL)
+    if (s_gps_cache.magic != GPS_CACHE_MAGIC || !s_gps_cache.fix.valid ||
+        s_gps_cache.reuse_count >= GPS_REUSE_CYCLES)
     {
-        return ESP_ERR_INVALID_ARG;
+        return false;
     }
+    uint64_t age_us = rtc_wall_us() - s_gps_cache.acquired_wall_us;
+    return age_us <= (uint64_t)GPS_FIX_MAX_AGE_S * 1000000ULL;
+}
 
-    // --- Build compact binary payload ---
-    // Layout (little-endian):
-    //   4  bytes - sample_count
-    //   13x 2 bytes - avg_f1..f8, fz, f3..f5, fy, fxl, nir, clear (26 bytes)
-    //   1  byte  - gps.valid
-    //   8  bytes - latitude_deg  (double)
-    //   8  bytes - longitude_deg (double)
-    //   4  bytes - unix_time
-    // Total: 51 bytes
+// Serve a report from the cache, advancing unix_time by the fix's age
+static bool gps_fix_from_cache(gps_fix_t *fix)
+{
+    if (!gps_cache_fresh())
+    {
+        return false;
+    }
+    *fix = s_gps_cache.fix;
+    fix->unix_time += (uint32_t)((rtc_wall_us() - s_gps_cache.acquired_wall_us)
+                                 / 1000000ULL);
+    s_gps_cache.reuse_count++;
+    SAT_LOGD("GPS fix reused from cache (%lu/%d)\n",
+           (unsigned long)s_gps_cache.reuse_count, GPS_REUSE_CYCLES);
+    return true;
+}
 
-    uint8_t buf[51];
-    size_t  offset = 0;
+// Slow-clock calibration: the shortest fix-to-fix baseline worth
+// measuring against the 1 s unix_time quantization (600 s bounds the
+// quantization error at ~0.17%, well under the RC drift being chased)
+// and the longest before a temperature excursion mid-baseline makes the
+// average misleading
+#define CLK_CAL_MIN_BASELINE_S 600UL
+#define CLK_CAL_MAX_BASELINE_S 172800UL
+
+// Fold one fix-to-fix drift measurement into the retained correction.
+// rtc_elapsed is what the RTC-propagated wall clock claims passed since
+// the previous fix; gps_elapsed is what GPS says actually passed. Their
+// Q16 ratio is the factor a programmed sleep must be scaled by so it
+// elapses in true time; a 3:1 EWMA smooths the 1 s fix quantization.
+static void clk_cal_update(uint64_t rtc_elapsed_us, uint64_t gps_elapsed_us)
+{
+    if (gps_elapsed_us < (uint64_t)CLK_CAL_MIN_BASELINE_S * 1000000ULL ||
+        gps_elapsed_us > (uint64_t)CLK_CAL_MAX_BASELINE_S * 1000000ULL)
+    {
+        return;
+    }
+    uint32_t meas = (uint32_t)((rtc_elapsed_us << 16) / gps_elapsed_us);
+    if (meas < CLK_CAL_ONE_Q16 - CLK_CAL_MAX_DEV_Q16 ||
+        meas > CLK_CAL_ONE_Q16 + CLK_CAL_MAX_DEV_Q16)
+    {
+        SAT_LOGI("Clock cal: measurement %lu/65536 discarded (out of range)\n",
+               (unsigned long)meas);
+        return;
+    }
+    uint32_t prev = s_rtc_state.clk_cal_q16;
+    if (prev == 0)
+    {
+        prev = CLK_CAL_ONE_Q16; // pre-v12 state restored from a bank
+    }
+    s_rtc_state.clk_cal_q16 = (3 * prev + meas) / 4;
+    SAT_LOGD("Clock cal: meas %lu -> factor %lu/65536 over %llu s\n",
+           (unsigned long)meas, (unsigned long)s_rtc_state.clk_cal_q16,
+           (unsigned long long)(gps_elapsed_us / 1000000ULL));
+}
 
-    // sample_count (uint32_t)
-    memcpy(buf + offset, &report->sample_count, sizeof(report->sample_count));
-    offset += sizeof(report->sample_count);
-
-    // Spectral channels in struct declaration order
-    const uint16_t channels[] = {
-        report->avg_f1,  report->avg_f2,  report->avg_fz,
-        report->avg_f3,  report->avg_f4,  report->avg_f5,
-        report->avg_fy,  report->avg_f6,  report->avg_fxl,
-        report->avg_f7,  report->avg_f8,  report->avg_nir,
-        report->avg_clear
-    };
-    for (size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); i++)
+// Record a freshly acquired fix as the new reuse base
+static void gps_cache_store(const gps_fix_t *fix)
+{
+    if (!fix->valid)
+    {
+        return; // Never cache a timeout; retry next cycle
+    }
+    // Fix-to-fix drift measurement, taken before the clock is stepped:
+    // the previous fix left the wall clock exactly on GPS time, so any
+    // disagreement now is RTC slow-clock drift accumulated since
+    if (s_gps_cache.magic == GPS_CACHE_MAGIC && s_gps_cache.fix.valid &&
+        fix->unix_time > s_gps_cache.fix.unix_time)
     {
-        memcpy(buf + offset, &channels[i], sizeof(uint16_t));
-        offset += sizeof(uint16_t);
+        clk_cal_update(rtc_wall_us() - s_gps_cache.acquired_wall_us,
+                       (uint64_t)(fix->unix_time - s_gps_cache.fix.unix_time) *
+                           1000000ULL);
     }
 
-    // GPS
-    uint8_t gps_valid = report->gps.valid ? 1u : 0u;
-    buf[offset++] = gps_valid;
+    // Discipline the RTC wall clock to GPS time first, so every node in a
+    // fleet shares the same TDMA slot grid (and the fix-age math below
+    // never straddles a clock step)
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    if ((uint32_t)now.tv_sec != fix->unix_time)
+    {
+        struct timeval tv = {};
+        tv.tv_sec = (time_t)fix->unix_time;
+        settimeofday(&tv, NULL);
+    }
 
-    memcpy(buf + offset, &report->gps.latitude_deg,  sizeof(double)); offset += sizeof(double);
-    memcpy(buf + offset, &report->gps.longitude_deg, sizeof(double)); offset += sizeof(double);
-    memcpy(buf + offset, &report->gps.unix_time,     sizeof(uint32_t)); offset += sizeof(uint32_t);
+    s_gps_cache.fix = *fix;
+    s_gps_cache.reuse_count = 0;
+    s_gps_cache.acquired_wall_us = rtc_wall_us();
+    s_gps_cache.magic = GPS_CACHE_MAGIC;
+}
 
-    // Sanity-check at compile time
-    static_assert(sizeof(buf) == 4 + (13 * 2) + 1 + 8 + 8 + 4,
-                  "Payload size mismatch – update buf[] if struct changes");
+/* ---------- Concurrent GPS acquisition ---------- */
 
-    // --- Initialise radio ---
-    EspHal  *hal   = new EspHal(SPI_SCK, SPI_MISO, SPI_MOSI);
-    SX1262   radio = new Module(hal, LORA_CS, LORA_DIO1, LORA_RESET, LORA_BUSY);
+// The GPS polling loop blocks in uart_read_bytes for up to
+// GPS_LOCK_TIMEOUT_MS, so running it in its own task lets AS7343
+// integration and radio bring-up proceed in parallel instead of
+// serializing 3-5 s of wall time per transmit cycle.
 
-    radio.begin(LORA_FREQ);
-    radio.setBandwidth(LORA_BANDWIDTH);
-    radio.setSpreadingFactor(LORA_SPREAD);
-    radio.setCodingRate(LORA_CODING_RATE);
-    radio.setSyncWord(LORA_SYNC_WORD);
+static gps_fix_t s_gps_result;
+static esp_err_t s_gps_err = ESP_FAIL;
+static SemaphoreHandle_t s_gps_done = NULL;
+static bool s_gps_started = false;
 
-    // --- Transmit ---
-    int16_t state = radio.transmit(buf, offset);
+static void gps_acquisition_task(void *arg)
+{
+    s_gps_err = get_gps_fix(&s_gps_result);
+    xSemaphoreGive(s_gps_done);
+    vTaskDelete(NULL);
+}
 
-    static const char *TAG = "lora_send";
-    if (state == RADIOLIB_ERR_NONE)
+// Kick off GPS acquisition in the background; call as early in the wake
+// cycle as possible
+static void gps_acquisition_start(void)
+{
+    if (s_gps_done == NULL)
     {
-        ESP_LOGI(TAG, "LoRa TX OK  %u bytes | samples=%lu | gps=%s",
-                 (unsigned)offset,
-                 (unsigned long)report->sample_count,
-                 report->gps.valid ? "valid" : "invalid");
+        s_gps_done = xSemaphoreCreateBinary();
     }
-    else
+    if (s_gps_done == NULL ||
+        xTaskCreate(gps_acquisition_task, "gps_fix", 4096, NULL, 5, NULL) != pdPASS)
     {
-        ESP_LOGE(TAG, "LoRa TX failed, code %d", state);
-        return ESP_FAIL;
+        // Fall back to the synchronous path in gps_acquisition_join
+        s_gps_started = false;
+        return;
     }
-
-    return ESP_OK;
+    s_gps_started = true;
 }
 
-/* ---------- Report flow ---------- */
-
-// Checks if a LoRa transmit is due
+// Block until the background acquisition finishes and hand out the fix.
+// Degrades to a direct synchronous get_gps_fix() if the task never started.
+static esp_err_t gps_acquisition_join(gps_fix_t *fix)
+{
+    if (!s_gps_started)
+    {
+        return get_gps_fix(fix);
+    }
+
+    // The task bounds itself with the configured lock timeout; the margin here only
+    // covers scheduling slack
+    if (xSemaphoreTake(s_gps_done,
+                       pdMS_TO_TICKS(s_rtc_state.cfg_gps_lock_timeout_ms + 1000)) != pdTRUE)
+    {
+        s_gps_started = false;
+        return ESP_ERR_TIMEOUT;
+    }
+    s_gps_started = false;
+
+    *fix = s_gps_result;
+    return s_gps_err;
+}
+
+// Peak-current sequencing: the GPS front end acquiring (~35 mA) and the
+// SX1262 ramping to full TX power (~120 mA) are the two largest loads on
+// the pack, and on a cold or depleted cell their sum sags the rail past
+// the regulator's margin mid-transmit. The normal flow already serializes
+// them (join completes and get_gps_fix backup-sleeps the receiver before
+// any transmit), so this gate is the enforcement for the abnormal flows —
+// a join timeout that left the task acquiring, or a cache-served transmit
+// racing a background start. Bound the wait, then force the receiver to
+// backup; a lost fix attempt is recoverable, a brownout reset is not.
+#define GPS_QUIESCE_WAIT_MS 250
+
+static void gps_quiesce_for_tx(void)
+{
+    if (!s_gps_started)
+    {
+        return; // Receiver already joined and backup-slept
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    if (xSemaphoreTake(s_gps_done, pdMS_TO_TICKS(GPS_QUIESCE_WAIT_MS)) == pdTRUE)
+    {
+        // Acquisition finished while we waited; the result stays stored
+        // for a later join, but the receiver is already in backup
+        xSemaphoreGive(s_gps_done);
+        SAT_LOGD("TX gate: GPS quiesced after %lld ms wait\n",
+               (long long)((esp_timer_get_time() - t0) / 1000));
+        return;
+    }
+
+    // Still acquiring: pull the receiver into backup out from under the
+    // task. The PMREQ write shares the UART with the task's reads, which
+    // the driver serializes; the task then just runs out its timeout.
+    SAT_LOGI("TX gate: GPS still acquiring — forcing receiver to backup\n");
+    gps_sleep();
+}
+
+/* ---------- Payload encoding ---------- */
+
+// Format flag byte prefixed to every LoRa frame
+#define PAYLOAD_FMT_KEYFRAME 0x00 // Full fixed layout follows
+#define PAYLOAD_FMT_DELTA    0x01 // Varint channel deltas vs. previous frame
+#define PAYLOAD_FMT_BATCH    0x02 // Count byte + N concatenated keyframe bodies
+#define PAYLOAD_FMT_EXTENDED 0x03 // Keyframe body + per-channel stddev/min/max
+#define PAYLOAD_FMT_HEARTBEAT 0x04 // Night heartbeat: sample count + clear avg
+#define PAYLOAD_FMT_MASKED   0x05 // 16-bit channel mask + selected channels only
+#define PAYLOAD_FMT_PACKED   0x06 // Keyframe with 12-bit bit-packed channels
+#define PAYLOAD_FMT_PACKED_BATCH 0x07 // Count byte + N packed keyframe bodies
+
+// Extended report mode: single-report keyframes gain a per-channel
+// stddev/min/max block. Variability over the averaging window — cloud
+// transits vs. steady overcast — costs 78 bytes here vs. an impossible
+// transmit-rate increase. Batch frames stay plain: four extended bodies
+// would exceed the SX126x 255-byte payload limit (see the airtime
+// static_asserts below).
+#define REPORT_EXTENDED_STATS 1
+#define REPORT_EXT_BLOCK_SIZE (ORCA_NUM_CHANNELS * 3 * 2)
+
+// Sampling-window block appended to extended frames: 8-byte window start
+// (microseconds since the Unix epoch, from the GPS-disciplined wall
+// clock; 0 = start unknown) + 4-byte window duration in ms. Without it
+// the receiver can only guess a report's temporal extent from arrival
+// time, with LoRa and queueing jitter baked in; with it, averaged
+// windows attribute correctly however slow the transmit schedule runs.
+#define REPORT_WINDOW_BLOCK_SIZE (8 + 4)
+
+// Bit-packed channel mode: keyframe bodies carry the spectral block as
+// 13 x 12-bit values behind a shared shift annotation (orca_payload.h)
+// instead of 13 x uint16 — 6 bytes off every body, 24 off a full batch
+// frame, at zero precision cost whenever the averages fit 12 bits (the
+// normal case at gain 256x). Delta frames are unaffected; extended resync
+// keyframes keep the full-width body so their stats block stays aligned
+// with full-precision channels.
+#define REPORT_PACKED_CHANNELS 1
+
+// Completed reports staged per transmission. >1 batches reports into a
+// single frame, cutting radio wakeups by the same factor; 1 transmits each
+// report immediately (with delta encoding) as before.
+#define REPORTS_PER_BATCH 4
+
+// Force a keyframe at least this often so a receiver joining mid-stream
+// (or missing a frame) resynchronizes quickly
+#define KEYFRAME_INTERVAL 10
+
+// Last successfully transmitted report — the delta base the receiver holds
+#define DELTA_RTC_MAGIC 0xDE17A001UL
+RTC_DATA_ATTR static struct
+{
+    uint32_t magic; // Valid only when `last` was confirmed on air
+    uint32_t frames_since_keyframe;
+    report_payload_t last;
+} s_delta_rtc;
+
+// Copy the spectral channels out in wire order (already stored that way)
+static void report_channels(const report_payload_t *report,
+                            uint16_t out[ORCA_NUM_CHANNELS])
+{
+    memcpy(out, report->avg, sizeof(report->avg));
+}
+
+// ZigZag fold so small negative deltas stay small on the wire
+static uint32_t zigzag32(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+// LEB128 varint append; returns new offset
+static size_t varint_put(uint8_t *buf, size_t offset, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        buf[offset++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    buf[offset++] = (uint8_t)v;
+    return offset;
+}
+
+// Degrees to int32 scaled by 1e-7 (u-blox convention). ±90/±180° fit with
+// room to spare, and 1e-7 deg (~1.1 cm) is far below GPS accuracy, so this
+// is lossless in practice at half the bytes of a double.
+static int32_t deg_to_e7(double deg)
+{
+    return (int32_t)(deg * 1e7 + (deg >= 0 ? 0.5 : -0.5));
+}
+
+// Keyframe body = the shared packed wire struct (see orca_payload.h)
+#define REPORT_RAW_SIZE ORCA_REPORT_WIRE_SIZE
+
+// Fill the shared wire struct from a working report; the packed struct is
+// the on-air layout, so no per-field serialization happens afterwards
+// Age of the report's newest sensor sample at encode time, saturated to
+// the 16-bit wire field. Computed when the frame is built — not when the
+// report was — so reports parked in the RTC batch buffer age honestly.
+static uint16_t report_age_ms(const report_payload_t *report)
+{
+    uint64_t now = rtc_wall_us();
+    if (report->sampled_wall_us == 0 || now < report->sampled_wall_us)
+    {
+        return 0;
+    }
+    uint64_t age_ms = (now - report->sampled_wall_us) / 1000ULL;
+    return (age_ms > UINT16_MAX) ? UINT16_MAX : (uint16_t)age_ms;
+}
+
+static void report_to_wire(const report_payload_t *report, orca_report_wire_t *wire)
+{
+    wire->sample_count = report->sample_count;
+    report_channels(report, wire->channels);
+    wire->gps_valid = report->gps.valid ? 1u : 0u;
+    wire->lat_e7 = deg_to_e7(report->gps.latitude_deg);
+    wire->lon_e7 = deg_to_e7(report->gps.longitude_deg);
+    wire->unix_time = report->gps.unix_time;
+    wire->batt_mv = report->batt_mv;
+    wire->sample_age_ms = report_age_ms(report);
+}
+
+static size_t encode_report_raw(const report_payload_t *report, uint8_t *buf)
+{
+    orca_report_wire_t wire;
+    report_to_wire(report, &wire);
+    memcpy(buf, &wire, ORCA_REPORT_WIRE_SIZE);
+    return ORCA_REPORT_WIRE_SIZE;
+}
+
+// Masked frame: the keyframe layout with the spectral block reduced to
+// the channels selected by the remote channel mask (bit i = channel i in
+// wire order). An experiment that only needs the PAR bands can cut the
+// spectral block from 26 bytes to 10 without touching them; everything
+// around the channels — count, GPS, battery, age — is carried verbatim.
+static size_t encode_report_masked(const report_payload_t *report,
+                                   uint8_t *buf, uint16_t mask)
+{
+    orca_report_wire_t wire;
+    report_to_wire(report, &wire);
+
+    size_t offset = 0;
+    buf[offset++] = PAYLOAD_FMT_MASKED;
+    buf[offset++] = (uint8_t)(mask & 0xFF);
+    buf[offset++] = (uint8_t)(mask >> 8);
+    buf[offset++] = (uint8_t)(wire.sample_count & 0xFF);
+    buf[offset++] = (uint8_t)(wire.sample_count >> 8);
+    buf[offset++] = (uint8_t)(wire.sample_count >> 16);
+    buf[offset++] = (uint8_t)(wire.sample_count >> 24);
+    for (size_t i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+        if (mask & (1u << i))
+        {
+            buf[offset++] = (uint8_t)(wire.channels[i] & 0xFF);
+            buf[offset++] = (uint8_t)(wire.channels[i] >> 8);
+        }
+    }
+    buf[offset++] = wire.gps_valid;
+    const int32_t coords[2] = { wire.lat_e7, wire.lon_e7 };
+    for (size_t c = 0; c < 2; c++)
+    {
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] & 0xFF);
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] >> 8);
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] >> 16);
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] >> 24);
+    }
+    buf[offset++] = (uint8_t)(wire.unix_time & 0xFF);
+    buf[offset++] = (uint8_t)(wire.unix_time >> 8);
+    buf[offset++] = (uint8_t)(wire.unix_time >> 16);
+    buf[offset++] = (uint8_t)(wire.unix_time >> 24);
+    buf[offset++] = (uint8_t)(wire.batt_mv & 0xFF);
+    buf[offset++] = (uint8_t)(wire.batt_mv >> 8);
+    buf[offset++] = (uint8_t)(wire.sample_age_ms & 0xFF);
+    buf[offset++] = (uint8_t)(wire.sample_age_ms >> 8);
+    return offset;
+}
+
+// Packed keyframe body: shift byte + sample_count + the bit-packed channel
+// block + the non-channel tail verbatim. Same field order as the wire
+// struct, just with the spectral block compressed (see orca_payload.h).
+#define REPORT_PACKED_BODY_SIZE (1 + 4 + ORCA_PACKED_CH_BYTES + 17)
+
+static size_t encode_report_packed(const report_payload_t *report, uint8_t *buf)
+{
+    orca_report_wire_t wire;
+    report_to_wire(report, &wire);
+
+    size_t offset = 0;
+    uint8_t packed[ORCA_PACKED_CH_BYTES];
+    buf[offset++] = orca_channels_pack(wire.channels, packed);
+    buf[offset++] = (uint8_t)(wire.sample_count & 0xFF);
+    buf[offset++] = (uint8_t)(wire.sample_count >> 8);
+    buf[offset++] = (uint8_t)(wire.sample_count >> 16);
+    buf[offset++] = (uint8_t)(wire.sample_count >> 24);
+    memcpy(buf + offset, packed, sizeof(packed));
+    offset += sizeof(packed);
+    buf[offset++] = wire.gps_valid;
+    const int32_t coords[2] = { wire.lat_e7, wire.lon_e7 };
+    for (size_t c = 0; c < 2; c++)
+    {
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] & 0xFF);
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] >> 8);
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] >> 16);
+        buf[offset++] = (uint8_t)((uint32_t)coords[c] >> 24);
+    }
+    buf[offset++] = (uint8_t)(wire.unix_time & 0xFF);
+    buf[offset++] = (uint8_t)(wire.unix_time >> 8);
+    buf[offset++] = (uint8_t)(wire.unix_time >> 16);
+    buf[offset++] = (uint8_t)(wire.unix_time >> 24);
+    buf[offset++] = (uint8_t)(wire.batt_mv & 0xFF);
+    buf[offset++] = (uint8_t)(wire.batt_mv >> 8);
+    buf[offset++] = (uint8_t)(wire.sample_age_ms & 0xFF);
+    buf[offset++] = (uint8_t)(wire.sample_age_ms >> 8);
+    return offset;
+}
+
+static_assert(REPORT_PACKED_BODY_SIZE < ORCA_REPORT_WIRE_SIZE,
+              "packed body must beat the plain wire struct");
+
+// Extended-stats block: 13 x (stddev, min, max) as little-endian uint16,
+// channel-major in orca_channel_t order. Appended after a keyframe body.
+static size_t encode_report_ext(const report_payload_t *report, uint8_t *buf)
+{
+    size_t offset = 0;
+    for (size_t i = 0; i < ORCA_NUM_CHANNELS; i++)
+    {
+        const uint16_t fields[3] = {
+            report->stddev[i], report->min[i], report->max[i]
+        };
+        for (size_t f = 0; f < 3; f++)
+        {
+            buf[offset++] = (uint8_t)(fields[f] & 0xFF);
+            buf[offset++] = (uint8_t)(fields[f] >> 8);
+        }
+    }
+    return offset;
+}
+
+// Sampling-window block (see REPORT_WINDOW_BLOCK_SIZE): start stamp and
+// duration of the averaged window, so the receiver gets sub-second
+// temporal extent instead of guessing from arrival time
+static size_t encode_report_window(const report_payload_t *report, uint8_t *buf)
+{
+    size_t offset = 0;
+    uint64_t start_us = report->window_start_wall_us;
+    uint64_t dur_ms = 0;
+    if (report->sampled_wall_us > start_us)
+    {
+        dur_ms = (report->sampled_wall_us - start_us) / 1000ULL;
+        if (dur_ms > UINT32_MAX)
+        {
+            dur_ms = UINT32_MAX;
+        }
+    }
+    for (int b = 0; b < 8; b++)
+    {
+        buf[offset++] = (uint8_t)(start_us >> (8 * b));
+    }
+    for (int b = 0; b < 4; b++)
+    {
+        buf[offset++] = (uint8_t)((uint32_t)dur_ms >> (8 * b));
+    }
+    return offset;
+}
+
+// Build the on-air frame: flag byte + keyframe or delta body. Spectral
+// channels change slowly between reports, so varint zigzag deltas against
+// the previously transmitted frame typically shrink the body to a handful
+// of bytes; the GPS block is carried verbatim.
+static size_t build_tx_frame(const report_payload_t *report, uint8_t *buf,
+                             bool force_keyframe)
+{
+    bool keyframe = force_keyframe ||
+                    s_delta_rtc.magic != DELTA_RTC_MAGIC ||
+                    s_delta_rtc.frames_since_keyframe >= KEYFRAME_INTERVAL;
+
+    if (keyframe)
+    {
+#if REPORT_EXTENDED_STATS
+        buf[0] = PAYLOAD_FMT_EXTENDED;
+        size_t n = 1 + encode_report_raw(report, buf + 1);
+        n += encode_report_ext(report, buf + n);
+        return n + encode_report_window(report, buf + n);
+#elif REPORT_PACKED_CHANNELS
+        // Quantization note: with a non-zero shift the receiver's delta
+        // base is the reconstructed (shifted-back) channels while ours is
+        // exact, so later deltas land within the one-off rounding error of
+        // this frame — bounded, not cumulative, and zero at shift 0
+        buf[0] = PAYLOAD_FMT_PACKED;
+        return 1 + encode_report_packed(report, buf + 1);
+#else
+        buf[0] = PAYLOAD_FMT_KEYFRAME;
+        return 1 + encode_report_raw(report, buf + 1);
+#endif
+    }
+
+    size_t offset = 0;
+    buf[offset++] = PAYLOAD_FMT_DELTA;
+
+    offset = varint_put(buf, offset,
+        zigzag32((int32_t)(report->sample_count - s_delta_rtc.last.sample_count)));
+
+    uint16_t cur[13], prev[13];
+    report_channels(report, cur);
+    report_channels(&s_delta_rtc.last, prev);
+    for (size_t i = 0; i < 13; i++)
+    {
+        offset = varint_put(buf, offset,
+                            zigzag32((int32_t)cur[i] - (int32_t)prev[i]));
+    }
+
+    // GPS as deltas too: a stationary (or slow) platform yields 1-2 byte
+    // varints for position and time instead of 12 fixed bytes
+    buf[offset++] = report->gps.valid ? 1u : 0u;
+    offset = varint_put(buf, offset, zigzag32(
+        deg_to_e7(report->gps.latitude_deg) -
+        deg_to_e7(s_delta_rtc.last.gps.latitude_deg)));
+    offset = varint_put(buf, offset, zigzag32(
+        deg_to_e7(report->gps.longitude_deg) -
+        deg_to_e7(s_delta_rtc.last.gps.longitude_deg)));
+    offset = varint_put(buf, offset, zigzag32(
+        (int32_t)(report->gps.unix_time - s_delta_rtc.last.gps.unix_time)));
+
+    // Sample age is fresh every frame (deltas of it are meaningless), so
+    // it rides along as two fixed little-endian bytes
+    uint16_t age_ms = report_age_ms(report);
+    buf[offset++] = (uint8_t)(age_ms & 0xFF);
+    buf[offset++] = (uint8_t)(age_ms >> 8);
+
+    return offset;
+}
+
+// Reports completed but not yet transmitted (batching mode)
+#define BATCH_RTC_MAGIC 0xBA7C4E01UL
+RTC_DATA_ATTR static struct
+{
+    uint32_t magic;
+    uint32_t count;
+    report_payload_t reports[REPORTS_PER_BATCH];
+} s_batch_rtc;
+
+// Spill the staged batch to the flash queue, checking every push: reports
+// the flash refused stay staged in RTC RAM (the batch compacts down to
+// the survivors) so a write error defers them to the next cycle instead
+// of dropping them behind a success log. Returns the number persisted.
+static uint32_t spill_batch_to_flash(void)
+{
+    uint32_t kept = 0;
+    uint32_t queued = 0;
+    for (uint32_t i = 0; i < s_batch_rtc.count; i++)
+    {
+        esp_err_t err = report_queue_push(&s_batch_rtc.reports[i],
+                                          sizeof(report_payload_t));
+        if (err == ESP_OK)
+        {
+            queued++;
+        }
+        else
+        {
+            SAT_LOGI("Flash queue push failed: %s\n", esp_err_to_name(err));
+            if (kept != i)
+            {
+                s_batch_rtc.reports[kept] = s_batch_rtc.reports[i];
+            }
+            kept++;
+        }
+    }
+    s_batch_rtc.count = kept;
+    return queued;
+}
+
+/* ---------- Change-detection transmit gate ---------- */
+
+// A report counts as unchanged when every channel average is within this
+// many counts of the last report we kept (noise floor at gain=256x)
+#define TX_SUPPRESS_EPSILON 8
+
+// Heartbeat: never suppress more than this many consecutive reports, so
+// the receiver can distinguish "nothing changed" from "satellite died"
+#define TX_HEARTBEAT_MAX_SKIPS 30
+
+RTC_DATA_ATTR static uint32_t s_suppressed_reports;
+
+// True when all 13 channel averages agree within TX_SUPPRESS_EPSILON
+static bool report_unchanged(const report_payload_t *a, const report_payload_t *b)
+{
+    uint16_t ca[13], cb[13];
+    report_channels(a, ca);
+    report_channels(b, cb);
+    for (size_t i = 0; i < 13; i++)
+    {
+        int32_t diff = (int32_t)ca[i] - (int32_t)cb[i];
+        if (diff < -TX_SUPPRESS_EPSILON || diff > TX_SUPPRESS_EPSILON)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The most recent report we actually kept: the newest staged batch entry,
+// else the last frame confirmed on air
+static const report_payload_t *last_kept_report(void)
+{
+    if (s_batch_rtc.magic == BATCH_RTC_MAGIC && s_batch_rtc.count > 0)
+    {
+        return &s_batch_rtc.reports[s_batch_rtc.count - 1];
+    }
+    if (s_delta_rtc.magic == DELTA_RTC_MAGIC)
+    {
+        return &s_delta_rtc.last;
+    }
+    return NULL;
+}
+
+// Record a confirmed transmission as the receiver's new delta base
+static void delta_state_commit(const report_payload_t *report, bool was_keyframe)
+{
+    s_delta_rtc.last = *report;
+    s_delta_rtc.frames_since_keyframe =
+        was_keyframe ? 1 : s_delta_rtc.frames_since_keyframe + 1;
+    s_delta_rtc.magic = DELTA_RTC_MAGIC;
+}
+
+/* ---------- Compile-time airtime budget ---------- */
+
+// SX126x LoRa time-on-air (Semtech SX1261/2 datasheet formulas), evaluated
+// entirely at compile time. A spreading-factor, bandwidth or frame-size
+// change that blows the airtime or duty-cycle budget now fails the build
+// instead of a field battery.
+#define LORA_PREAMBLE_SYMBOLS 8
+#define LORA_MAX_FRAME_BYTES 255 // SX126x payload FIFO limit
+
+// Implicit-header mode: 0 (default) keeps explicit headers; a non-zero
+// value pads every frame — both directions, both ends — to exactly that
+// many bytes and drops the 20-bit PHY header from each transmission.
+// Worth it only when the padding costs less than the header symbols,
+// i.e. deployments running keyframe-heavy schedules where frames already
+// sit near one size; with delta encoding doing its job the padding loses
+// more than the header saves, hence the default. Must match
+// LORA_IMPLICIT_LEN in the chamber's Config.h exactly — a mismatch
+// deafens the link in both directions.
+#ifndef LORA_IMPLICIT_LEN
+#define LORA_IMPLICIT_LEN 0
+#endif
+static_assert(LORA_IMPLICIT_LEN >= 0 && LORA_IMPLICIT_LEN <= LORA_MAX_FRAME_BYTES,
+              "implicit-header frame length out of range");
+
+// Uplink frame authentication: every transmitted frame ends in a 4-byte
+// SipHash-2-4 tag under a per-deployment key, so a neighboring 915 MHz
+// device (or a deliberate forgery) cannot feed the chambers frames they
+// would turn into light commands. SipHash rather than the downlink's
+// HMAC-SHA256 because the uplink tags every frame inside the wake-time
+// budget: tagging a full report costs single-digit microseconds, far
+// under one sensor I2C transaction. Must match LORA_FRAME_AUTH and the
+// key in the chamber's Config.h; the default key pairs with a stock
+// chamber build and real deployments inject their own at build time.
+#ifndef LORA_FRAME_AUTH
+#define LORA_FRAME_AUTH 1
+#endif
+#ifndef LORA_FRAME_AUTH_KEY
+#define LORA_FRAME_AUTH_KEY "orca-frame-key-1" // exactly 16 bytes
+#endif
+#define LORA_AUTH_TAG_LEN (LORA_FRAME_AUTH ? ORCA_FRAME_TAG_LEN : 0)
+static_assert(sizeof(LORA_FRAME_AUTH_KEY) == ORCA_SIPHASH_KEY_LEN + 1,
+              "frame-auth key must be exactly 16 bytes");
+static_assert(LORA_IMPLICIT_LEN == 0 || LORA_IMPLICIT_LEN > LORA_AUTH_TAG_LEN,
+              "implicit length leaves no room for the auth tag");
+
+// Budget knobs: worst-case airtime of any single frame, and the sustained
+// duty cycle of the batch schedule. Sized for the current US 915 MHz
+// profile; EU deployments must tighten both together with
+// TRANSMIT_CYCLE_MS.
+#define LORA_AIRTIME_BUDGET_MS 750.0
+#define LORA_DUTY_CYCLE_BUDGET_PERCENT 20.0
+
+// Listen-before-talk: CAD attempts before transmitting regardless, and
+// the base of the randomized exponential backoff between attempts
+#define LBT_MAX_ATTEMPTS 4
+#define LBT_BACKOFF_BASE_MS 30
+
+// Downlink window held open after each successful transmit; the chamber
+// knows exactly when we listen and can answer with a signed config frame
+#define CONFIG_RX_WINDOW_MS 150
+
+static constexpr double lora_symbol_ms(int sf, double bw_khz)
+{
+    return (double)(1 << sf) / bw_khz;
+}
+
+// Low-data-rate optimization is mandatory above 16 ms symbols
+static constexpr bool lora_ldro(int sf, double bw_khz)
+{
+    return lora_symbol_ms(sf, bw_khz) > 16.0;
+}
+
+static constexpr int lora_ceil_div(int num, int den)
+{
+    return (num + den - 1) / den;
+}
+
+// Symbols in the payload part, CRC on. The 20-bit PHY header rides in
+// the payload symbol count and disappears in implicit-header mode.
+#define LORA_HEADER_BITS (LORA_IMPLICIT_LEN ? 8 : 28)
+static constexpr int lora_payload_symbols(int bytes, int sf, int cr_denom,
+                                          bool ldro)
+{
+    return 8 + ((8 * bytes - 4 * sf + LORA_HEADER_BITS + 16) > 0
+                    ? lora_ceil_div(8 * bytes - 4 * sf + LORA_HEADER_BITS + 16,
+                                    4 * (sf - (ldro ? 2 : 0))) * cr_denom
+                    : 0);
+}
+
+// Whole-frame time on air in ms for the configured radio profile
+static constexpr double lora_airtime_ms(int bytes)
+{
+    return (LORA_PREAMBLE_SYMBOLS + 4.25 +
+            lora_payload_symbols(bytes, LORA_SPREAD, LORA_CODING_RATE,
+                                 lora_ldro(LORA_SPREAD, LORA_BANDWIDTH))) *
+           lora_symbol_ms(LORA_SPREAD, LORA_BANDWIDTH);
+}
+
+// Bring up the radio (warm or cold), transmit one prebuilt frame, and park
+// the radio back in retention sleep
+static esp_err_t lora_transmit_frame(const uint8_t *buf, size_t offset)
+{
+    // --- Initialise radio ---
+    static const char *TAG = "lora_send";
+
+    // Never ramp the PA while the GPS front end is still drawing; the
+    // bench capture shows this boundary as the GPS stage closing before
+    // the TX stage opens
+    gps_quiesce_for_tx();
+
+    pm_full_speed(true);
+    prof_stage_begin(PROF_STAGE_LORA_TX);
+
+    EspHal  *hal   = new EspHal(SPI_SCK, SPI_MISO, SPI_MOSI);
+    SX1262   radio = new Module(hal, LORA_CS, LORA_DIO1, LORA_RESET, LORA_BUSY);
+
+#if ESPHAL_STATS
+    EspHal::statsReset();
+#endif
+
+    int16_t state = RADIOLIB_ERR_NONE;
+
+    // Warm start: the SX1262 retained its full LoRa configuration in sleep
+    // across our deep sleep, so a standby wakeup is all that is needed —
+    // no begin() sequence, no re-applying bandwidth/SF/CR/sync word.
+    if (radio_warm_start_available())
+    {
+        state = radio.standby();
+        if (state != RADIOLIB_ERR_NONE)
+        {
+            ESP_LOGW(TAG, "Warm start failed (code %d), falling back to cold init", state);
+            radio_warm_start_invalidate();
+        }
+    }
+
+    // Cold start: full bring-up and configuration from scratch
+    if (!radio_warm_start_available())
+    {
+        state = radio.begin(LORA_NODE_FREQ); // this node's plan carrier
+        if (state != RADIOLIB_ERR_NONE)
+        {
+            ESP_LOGE(TAG, "radio.begin failed, code %d", state);
+            prof_fault_count(PROF_FAULT_LORA_TX);
+            prof_stage_end(PROF_STAGE_LORA_TX);
+            pm_full_speed(false);
+            return ESP_FAIL;
+        }
+        radio.setBandwidth(LORA_BANDWIDTH);
+        // SF comes from config: the chamber can lower it via a signed rate
+        // frame when its receive margin allows. The airtime math and budget
+        // asserts stay on LORA_SPREAD (SF9, the allowed worst case), so a
+        // faster SF just means DIO1 ends the TX light sleep early.
+        radio.setSpreadingFactor((uint8_t)s_cfg.lora_sf);
+        radio.setCodingRate(LORA_CODING_RATE);
+        radio.setSyncWord(LORA_SYNC_WORD);
+        // TX power from config: the chamber steps it against its receive
+        // margin via signed power frames. Short-range rigs settle far
+        // below the +10 dBm default, which is energy saved every report.
+        radio.setOutputPower((int8_t)s_cfg.lora_tx_dbm);
+#if LORA_IMPLICIT_LEN
+        // Part of the retained packet params, so cold init only
+        radio.implicitHeader(LORA_IMPLICIT_LEN);
+#endif
+    }
+
+#if LORA_IMPLICIT_LEN
+    // Pad to the compiled-in length (minus the auth tag, which always sits
+    // in the final bytes so the receiver finds it at a fixed offset): the
+    // receiver is configured for exactly this many bytes per frame, and
+    // the airtime below must charge for them
+    uint8_t fixed[LORA_IMPLICIT_LEN - LORA_AUTH_TAG_LEN] = {0};
+    if (offset > sizeof(fixed))
+    {
+        ESP_LOGE(TAG, "Frame %u bytes exceeds implicit length %u",
+                 (unsigned)offset, (unsigned)sizeof(fixed));
+        prof_stage_end(PROF_STAGE_LORA_TX);
+        pm_full_speed(false);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(fixed, buf, offset);
+    buf = fixed;
+    offset = sizeof(fixed);
+#endif
+
+#if LORA_FRAME_AUTH
+    // Tag last, over everything that precedes it (padding included in
+    // implicit mode), so the receiver verifies before decoding a byte
+    static const char auth_key[] = LORA_FRAME_AUTH_KEY;
+    uint8_t authed[LORA_MAX_FRAME_BYTES];
+    if (offset + ORCA_FRAME_TAG_LEN > sizeof(authed))
+    {
+        ESP_LOGE(TAG, "Frame %u bytes leaves no room for the auth tag",
+                 (unsigned)offset);
+        prof_stage_end(PROF_STAGE_LORA_TX);
+        pm_full_speed(false);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(authed, buf, offset);
+    orca_frame_tag((const uint8_t *)auth_key, authed, offset, authed + offset);
+    buf = authed;
+    offset += ORCA_FRAME_TAG_LEN;
+#endif
+
+    // --- Listen before talk ---
+    // With several satellites per vessel, simultaneous wakeups collide
+    // on-channel and every colliding frame is wasted airtime. A CAD scan
+    // costs a few ms; on detection back off a randomized, doubling delay
+    // so contending nodes interleave. After the last attempt transmit
+    // anyway — stale data is worth less than no data.
+    for (int attempt = 0; attempt < LBT_MAX_ATTEMPTS; attempt++)
+    {
+        int16_t cad = radio.scanChannel();
+        if (cad != RADIOLIB_LORA_DETECTED)
+        {
+            break; // Channel free (or CAD unsupported error — don't stall)
+        }
+        uint32_t backoff_ms = LBT_BACKOFF_BASE_MS +
+                              esp_random() % (LBT_BACKOFF_BASE_MS << attempt);
+        ESP_LOGI(TAG, "Channel busy (CAD), backing off %lu ms",
+                 (unsigned long)backoff_ms);
+        vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+    }
+
+    // --- Transmit ---
+    // Non-blocking start + light sleep for the precomputed time-on-air.
+    // The blocking transmit() busy-polls BUSY/IRQ at full CPU clock for
+    // the whole airtime; the radio burns the power it must, but the CPU
+    // need not match it. DIO1 goes high on TX_DONE, so a level wake ends
+    // the sleep early and a short bounded poll absorbs clock skew.
+    state = radio.startTransmit(const_cast<uint8_t *>(buf), offset);
+    if (state == RADIOLIB_ERR_NONE)
+    {
+        gpio_wakeup_enable(LORA_DIO1, GPIO_INTR_HIGH_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+        esp_sleep_enable_timer_wakeup(
+            (uint64_t)(lora_airtime_ms((int)offset) * 1000.0));
+        esp_light_sleep_start();
+        gpio_wakeup_disable(LORA_DIO1);
+
+        // Residual wait for TX_DONE (the sleep timer undershoots by the
+        // clock-skew margin): an edge interrupt delivering a direct task
+        // notification through the HAL's IRAM trampoline, instead of a
+        // tick-granular poll — the task resumes within interrupt latency
+        // of DIO1 rising rather than up to a scheduler tick later
+        if (gpio_get_level(LORA_DIO1) == 0)
+        {
+            ulTaskNotifyTake(pdTRUE, 0); // drain anything stale
+            EspHal::isrNotifyTarget(LORA_DIO1, xTaskGetCurrentTaskHandle());
+            hal->attachInterrupt(LORA_DIO1, nullptr, GPIO_INTR_POSEDGE);
+            if (gpio_get_level(LORA_DIO1) == 0) // re-check: edge may have won
+            {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+            }
+            hal->detachInterrupt(LORA_DIO1);
+        }
+        if (gpio_get_level(LORA_DIO1) == 0)
+        {
+            state = RADIOLIB_ERR_TX_TIMEOUT;
+        }
+        radio.finishTransmit();
+    }
+
+    esp_err_t result;
+    if (state == RADIOLIB_ERR_NONE)
+    {
+        ESP_LOGI(TAG, "LoRa TX OK  %u bytes", (unsigned)offset);
+        result = ESP_OK;
+    }
+    else
+    {
+        ESP_LOGE(TAG, "LoRa TX failed, code %d", state);
+        prof_fault_count(PROF_FAULT_LORA_TX);
+        result = ESP_FAIL;
+    }
+
+    // --- Post-TX downlink window ---
+    // Listen briefly for a signed config frame from the chamber. Costs
+    // CONFIG_RX_WINDOW_MS of RX current per transmission and is the only
+    // moment a deployed node is reachable; accepted values persist in NVS
+    // and retune the cadence from the next cycle on.
+    if (result == ESP_OK)
+    {
+        // SX126x RX timeout counts in 15.625 us steps
+        radio.startReceive((uint32_t)(CONFIG_RX_WINDOW_MS * 1000 / 15.625));
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_RX_WINDOW_MS));
+
+#if LORA_IMPLICIT_LEN
+        // Every downlink frame arrives padded to the fixed length, so the
+        // type can't be told from the length — the HMAC inside each
+        // candidate layout decides (padding is outside both signatures)
+        uint8_t rx[LORA_IMPLICIT_LEN];
+        size_t  rx_len = radio.getPacketLength();
+        if (rx_len >= REMOTE_CONFIG_FRAME_SIZE && rx_len <= sizeof(rx) &&
+            radio.readData(rx, rx_len) == RADIOLIB_ERR_NONE)
+        {
+            if (remote_config_apply_frame(rx, REMOTE_CONFIG_FRAME_SIZE, &s_cfg))
+            {
+                rtc_state_seed_config();
+            }
+            else if (remote_rate_apply_frame(rx, REMOTE_RATE_FRAME_SIZE, &s_cfg))
+            {
+                radio_warm_start_invalidate();
+            }
+            else if (remote_power_apply_frame(rx, REMOTE_POWER_FRAME_SIZE, &s_cfg))
+            {
+                // Output power is part of the retained radio config too
+                radio_warm_start_invalidate();
+            }
+            else
+            {
+                remote_mask_apply_frame(rx, REMOTE_MASK_FRAME_SIZE, &s_cfg);
+            }
+        }
+#else
+        uint8_t rx[REMOTE_CONFIG_FRAME_SIZE];
+        size_t  rx_len = radio.getPacketLength();
+        if (rx_len == REMOTE_CONFIG_FRAME_SIZE &&
+            radio.readData(rx, rx_len) == RADIOLIB_ERR_NONE &&
+            remote_config_apply_frame(rx, rx_len, &s_cfg))
+        {
+            rtc_state_seed_config();
+        }
+        else if (rx_len == REMOTE_RATE_FRAME_SIZE &&
+                 radio.readData(rx, rx_len) == RADIOLIB_ERR_NONE &&
+                 remote_rate_apply_frame(rx, rx_len, &s_cfg))
+        {
+            // The retained radio config still holds the old SF; force a
+            // cold init next cycle so the new rate actually takes effect
+            radio_warm_start_invalidate();
+        }
+        else if (rx_len == REMOTE_POWER_FRAME_SIZE &&
+                 radio.readData(rx, rx_len) == RADIOLIB_ERR_NONE &&
+                 remote_power_apply_frame(rx, rx_len, &s_cfg))
+        {
+            // Output power is part of the retained radio config too
+            radio_warm_start_invalidate();
+        }
+        else if (rx_len == REMOTE_MASK_FRAME_SIZE &&
+                 radio.readData(rx, rx_len) == RADIOLIB_ERR_NONE)
+        {
+            remote_mask_apply_frame(rx, rx_len, &s_cfg);
+        }
+#endif
+        radio.standby();
+    }
+
+    // Park the radio in configuration-retention sleep so the next wake can
+    // use the fast register-restore path instead of a full begin()
+    if (radio.sleep(true) == RADIOLIB_ERR_NONE)
+    {
+        radio_warm_start_arm();
+    }
+    else
+    {
+        radio_warm_start_invalidate();
+    }
+
+#if ESPHAL_STATS
+    // Where the radio path spends its time: SPI transaction count, bytes
+    // moved and BUSY-handshake waits for this whole transmit cycle
+    esphal_stats_t st = EspHal::statsGet();
+    ESP_LOGI(TAG, "HAL stats: %lu SPI xfers, %lu bytes, %llu us SPI, %llu us delays",
+             (unsigned long)st.spi_transactions, (unsigned long)st.spi_bytes,
+             (unsigned long long)st.spi_time_us,
+             (unsigned long long)st.delay_us);
+#endif
+
+    prof_stage_end(PROF_STAGE_LORA_TX);
+    pm_full_speed(false);
+    return result;
+}
+
+// Send a single report (keyframe or delta encoded)
+static esp_err_t lora_send_report(const report_payload_t *report,
+                                  bool force_keyframe)
+{
+    if (report == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Worst case: flag + full keyframe + extended-stats + window blocks,
+    // or flag + 14 x 5-byte varints + GPS (+2 for the burst-tag trailer)
+    uint8_t buf[1 + REPORT_RAW_SIZE + REPORT_EXT_BLOCK_SIZE +
+                REPORT_WINDOW_BLOCK_SIZE + 40 + PROF_TRAILER_MAX_SIZE + 2];
+    static_assert(sizeof(buf) + LORA_AUTH_TAG_LEN <= LORA_MAX_FRAME_BYTES,
+                  "report frame exceeds the SX126x payload limit");
+    static_assert(lora_airtime_ms(sizeof(buf) + LORA_AUTH_TAG_LEN) <=
+                      LORA_AIRTIME_BUDGET_MS,
+                  "worst-case report airtime over budget");
+    static_assert(LORA_IMPLICIT_LEN == 0 ||
+                      sizeof(buf) + LORA_AUTH_TAG_LEN <= LORA_IMPLICIT_LEN,
+                  "worst-case report frame does not fit the implicit length");
+    size_t  offset;
+    bool    was_keyframe = false;
+    bool    masked = (s_cfg.channel_mask != REMOTE_MASK_ALL);
+    if (masked)
+    {
+        // Masked mode replaces the keyframe/delta stream entirely: the
+        // receiver never needs a delta base, and invalidating ours here
+        // forces a resynchronizing keyframe when the full stream resumes
+        offset = encode_report_masked(report, buf,
+                                      (uint16_t)s_cfg.channel_mask);
+        s_delta_rtc.magic = 0;
+    }
+    else
+    {
+        offset = build_tx_frame(report, buf, force_keyframe);
+        was_keyframe = (buf[0] == PAYLOAD_FMT_KEYFRAME ||
+                        buf[0] == PAYLOAD_FMT_EXTENDED);
+    }
+
+    // Piggyback the wake-cycle timing stats on every Nth report
+    if (prof_stats_due())
+    {
+        offset += prof_append_stats(buf + offset);
+    }
+
+    // Tag reports whose window contains burst-cadence samples, so the
+    // chamber can distinguish a transient chase from steady-state data.
+    // Same marker-trailer scheme as the profiling stats: receivers that
+    // do not know the marker simply leave the bytes unread. Read from
+    // bank A — the live flag was cleared at the bank swap.
+    if (s_acc_bank.burst_in_cycle)
+    {
+        buf[offset++] = BURST_TRAILER_MARKER;
+        buf[offset++] = 1;
+    }
+
+    esp_err_t err = lora_transmit_frame(buf, offset);
+    if (err == ESP_OK && !masked)
+    {
+        delta_state_commit(report, was_keyframe);
+    }
+    return err;
+}
+
+// Night heartbeat: proves the node is alive (and dark) for 7 bytes on air
+// instead of a full extended keyframe — no GPS, no batch staging
+static esp_err_t lora_send_heartbeat(uint16_t clear_avg)
+{
+    uint8_t buf[1 + 4 + 2];
+    size_t  offset = 0;
+    buf[offset++] = PAYLOAD_FMT_HEARTBEAT;
+    buf[offset++] = (uint8_t)(s_rtc_state.total_sample_count & 0xFF);
+    buf[offset++] = (uint8_t)(s_rtc_state.total_sample_count >> 8);
+    buf[offset++] = (uint8_t)(s_rtc_state.total_sample_count >> 16);
+    buf[offset++] = (uint8_t)(s_rtc_state.total_sample_count >> 24);
+    buf[offset++] = (uint8_t)(clear_avg & 0xFF);
+    buf[offset++] = (uint8_t)(clear_avg >> 8);
+    return lora_transmit_frame(buf, offset);
+}
+
+// Send several reports concatenated into one frame:
+//   1 byte flag, 1 byte count, then count x REPORT_RAW_SIZE keyframe bodies.
+// One transmission amortizes preamble, sync word and radio ramp-up over
+// all of them.
+static esp_err_t lora_send_batch(const report_payload_t *reports, size_t count)
+{
+    if (reports == NULL || count == 0 || count > REPORTS_PER_BATCH)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Plain or packed keyframe bodies only — extended bodies would not fit
+    // the radio's 255-byte frame at REPORTS_PER_BATCH = 4
+#if REPORT_PACKED_CHANNELS
+    uint8_t buf[2 + REPORTS_PER_BATCH * REPORT_PACKED_BODY_SIZE +
+                PROF_TRAILER_MAX_SIZE];
+#else
+    uint8_t buf[2 + REPORTS_PER_BATCH * REPORT_RAW_SIZE + PROF_TRAILER_MAX_SIZE];
+#endif
+    static_assert(sizeof(buf) + LORA_AUTH_TAG_LEN <= LORA_MAX_FRAME_BYTES,
+                  "batch frame exceeds the SX126x payload limit");
+    static_assert(lora_airtime_ms(sizeof(buf) + LORA_AUTH_TAG_LEN) <=
+                      LORA_AIRTIME_BUDGET_MS,
+                  "worst-case batch airtime over budget");
+    // One batch frame goes out per REPORTS_PER_BATCH transmit cycles
+    static_assert(lora_airtime_ms(sizeof(buf) + LORA_AUTH_TAG_LEN) * 100.0 <=
+                      (double)(REPORTS_PER_BATCH * TRANSMIT_CYCLE_MS) *
+                          LORA_DUTY_CYCLE_BUDGET_PERCENT,
+                  "sustained duty cycle over budget");
+    static_assert(LORA_IMPLICIT_LEN == 0 ||
+                      sizeof(buf) + LORA_AUTH_TAG_LEN <= LORA_IMPLICIT_LEN,
+                  "worst-case batch frame does not fit the implicit length");
+
+    size_t offset = 0;
+#if REPORT_PACKED_CHANNELS
+    buf[offset++] = PAYLOAD_FMT_PACKED_BATCH;
+    buf[offset++] = (uint8_t)count;
+    for (size_t i = 0; i < count; i++)
+    {
+        offset += encode_report_packed(&reports[i], buf + offset);
+    }
+#else
+    buf[offset++] = PAYLOAD_FMT_BATCH;
+    buf[offset++] = (uint8_t)count;
+    for (size_t i = 0; i < count; i++)
+    {
+        offset += encode_report_raw(&reports[i], buf + offset);
+    }
+#endif
+
+    // Piggyback the wake-cycle timing stats on every Nth frame
+    if (prof_stats_due())
+    {
+        offset += prof_append_stats(buf + offset);
+    }
+
+    return lora_transmit_frame(buf, offset);
+}
+
+/* ---------- Wake budget supervisor ---------- */
+
+// Bounded worst-case awake time is a power guarantee: a wake pinned open
+// by a wedged I2C bus or a flooding GPS UART drains in hours what should
+// last weeks. Each stage already bounds itself — sensor bring-up retries
+// with backoff, the GPS loop counts wall time against its lock timeout,
+// the radio busy-waits are capped — but "every stage happens to be
+// bounded" is a property of today's code, not a contract. Two layers turn
+// it into one:
+//
+//   - soft deadlines: the transmit tail checks the wake's elapsed time
+//     before committing to radio airtime and degrades instead of
+//     overrunning (the batch spills to the flash queue; the stale-cache
+//     fallback already substitutes for a slow GPS acquisition)
+//   - a hard backstop: a one-shot esp_timer that forces the normal sleep
+//     path if app_main has not reached it in time. Firing means some
+//     stage is wedged past its own bounds, so abandoning the partial
+//     cycle is the right trade — the RTC accumulators survive and the
+//     next wake retries with freshly reset peripherals.
+//
+// The wired RS-485 session is bench-powered and stays awake by design,
+// so it disarms the backstop on entry.
+
+// Hard ceiling on a wake: worst honest path is sensor retries (~300 ms),
+// GPS lock timeout plus join margin (~6 s), a batch transmit and a full
+// queue drain at SF9 (~4 s of airtime) — tripled for slack
+#define WAKE_BUDGET_BACKSTOP_MS 30000
+
+// Soft deadline for committing new radio airtime within a wake
+#define WAKE_TX_DEADLINE_MS 15000
+
+static void schedule_next_wakeup_and_sleep(void);
+
+static esp_timer_handle_t s_wake_backstop;
+
+// Runs in the esp_timer task; the main task may be wedged mid-transaction,
+// which is fine — deep sleep entry resets every peripheral on the way out
+static void wake_backstop_cb(void *arg)
+{
+    SAT_LOGI("Wake exceeded %d ms backstop — forcing sleep\n",
+           WAKE_BUDGET_BACKSTOP_MS);
+    schedule_next_wakeup_and_sleep();
+}
+
+static void wake_budget_arm(void)
+{
+    const esp_timer_create_args_t args = {
+        .callback = wake_backstop_cb,
+        .name = "wake_budget",
+    };
+    if (esp_timer_create(&args, &s_wake_backstop) == ESP_OK)
+    {
+        esp_timer_start_once(s_wake_backstop,
+                             (uint64_t)WAKE_BUDGET_BACKSTOP_MS * 1000ULL);
+    }
+}
+
+static void wake_budget_disarm(void)
+{
+    if (s_wake_backstop != NULL)
+    {
+        esp_timer_stop(s_wake_backstop);
+    }
+}
+
+// True once this wake has been running longer than deadline_ms;
+// esp_timer_get_time() counts from the wake, so no start timestamp needed
+static bool wake_past_deadline(uint32_t deadline_ms)
+{
+    return (uint64_t)esp_timer_get_time() >= (uint64_t)deadline_ms * 1000ULL;
+}
+
+/* ---------- Report flow ---------- */
+
+// Flash stores mount on first use, not at boot. Both mount routines scan
+// every slot marker in their partition to recover ring state, which is the
+// single biggest fixed cost a wake can pay — and an accumulate-only wake
+// (the common case: sample, add to RTC sums, sleep) never touches either
+// store. Bring-up is therefore keyed to the paths that actually consume
+// them: the transmit tail and the wired session. GPS UART and the SPI
+// radio already follow the same discipline (gps_init() runs inside
+// get_gps_fix() only when the RTC fix cache cannot serve, and the radio
+// is built inside lora_transmit_frame() once a frame exists), leaving the
+// sensor's I2C bring-up as the only per-wake peripheral cost.
+static bool s_storage_mounted = false;
+static void storage_mounts_ensure(void)
+{
+    if (s_storage_mounted)
+    {
+        return;
+    }
+    // Queue first: the transmit tail reads it before the black box, and
+    // each mount is independently non-fatal if its partition is missing
+    report_queue_init();
+    blackbox_init();
+    s_storage_mounted = true;
+}
+
+/* ---------- Outage retry scheduling ---------- */
+
+// When the chamber receiver goes down, every node's queue grows and every
+// node wants to retry — and the TDMA grid that keeps same-vessel nodes
+// apart also synchronizes their retry *epochs*, so the moment the receiver
+// returns the whole fleet collides on it in repeating bursts (CAD backoff
+// only separates frames by tens of ms; the bursts recur every cycle).
+// Two mechanisms spread the recovery out:
+//
+//   - after a failed live transmit, sit out a randomized number of cycles
+//     drawn from a doubling window (1 + rand % 2^streak). The batch still
+//     spills to the flash queue, so backoff defers airtime, never data.
+//   - after the link returns, the queued backlog drains on a slow-start
+//     budget: 1 frame on the first healthy cycle, doubling per healthy
+//     cycle up to QUEUE_DRAIN_PER_CYCLE — so a fleet's worth of month-deep
+//     queues ramps onto the receiver instead of arriving all at once.
+//
+// State lives in its own RTC block (same magic discipline as the GPS
+// cache): a streak must survive deep sleep to double.
+#define TX_RETRY_MAX_EXP 6  // Window cap: 64 cycles (~1 min at base cadence)
+
+#define TX_RETRY_MAGIC 0xBACC0FF5UL
+RTC_DATA_ATTR static struct
+{
+    uint32_t magic;
+    uint32_t fail_streak;    // Consecutive failed live transmits
+    uint32_t skip_remaining; // Cycles of airtime still to sit out
+    uint32_t healthy_cycles; // Successful cycles since the last failure
+} s_tx_retry;
+
+static void tx_retry_ensure_valid(void)
+{
+    if (s_tx_retry.magic != TX_RETRY_MAGIC)
+    {
+        memset(&s_tx_retry, 0, sizeof(s_tx_retry));
+        s_tx_retry.magic = TX_RETRY_MAGIC;
+    }
+}
+
+// True when this cycle's airtime should be skipped (and the batch spilled)
+static bool tx_retry_should_skip(void)
+{
+    tx_retry_ensure_valid();
+    if (s_tx_retry.skip_remaining == 0)
+    {
+        return false;
+    }
+    s_tx_retry.skip_remaining--;
+    SAT_LOGI("TX backoff: sitting out this cycle (%lu more, streak %lu)\n",
+           (unsigned long)s_tx_retry.skip_remaining,
+           (unsigned long)s_tx_retry.fail_streak);
+    return true;
+}
+
+static void tx_retry_note_failure(void)
+{
+    tx_retry_ensure_valid();
+    s_tx_retry.healthy_cycles = 0;
+    if (s_tx_retry.fail_streak < 31)
+    {
+        s_tx_retry.fail_streak++;
+    }
+    uint32_t exp = s_tx_retry.fail_streak < TX_RETRY_MAX_EXP
+                       ? s_tx_retry.fail_streak
+                       : TX_RETRY_MAX_EXP;
+    // Uniform draw over a doubling window: no two nodes share a schedule,
+    // however synchronized their failures were
+    s_tx_retry.skip_remaining = 1 + esp_random() % (1UL << exp);
+    SAT_LOGI("TX backoff: failure %lu, next attempt in %lu cycles\n",
+           (unsigned long)s_tx_retry.fail_streak,
+           (unsigned long)s_tx_retry.skip_remaining);
+}
+
+static void tx_retry_note_success(void)
+{
+    tx_retry_ensure_valid();
+    s_tx_retry.fail_streak = 0;
+    s_tx_retry.skip_remaining = 0;
+    if (s_tx_retry.healthy_cycles < 31)
+    {
+        s_tx_retry.healthy_cycles++;
+    }
+}
+
+// Maximum queued frames drained after a successful live transmission,
+// bounding per-wake airtime during link recovery (~2.5 s at SF9; the
+// slow-start ramp below keeps the first recovery cycles well under it)
+#define QUEUE_DRAIN_PER_CYCLE 8
+
+// Slow-start drain budget: 1, 2, 4, ... frames per healthy cycle
+static int tx_drain_budget(void)
+{
+    tx_retry_ensure_valid();
+    uint32_t shift = s_tx_retry.healthy_cycles > 0
+                         ? s_tx_retry.healthy_cycles - 1
+                         : 0;
+    if (shift > 3)
+    {
+        return QUEUE_DRAIN_PER_CYCLE;
+    }
+    uint32_t budget = 1UL << shift;
+    return budget < QUEUE_DRAIN_PER_CYCLE ? (int)budget
+                                          : QUEUE_DRAIN_PER_CYCLE;
+}
+
+// Retransmit frames queued during earlier link outages, oldest first.
+// Stops at the first failure (link likely still down) or after the
+// per-cycle drain budget.
+static void drain_report_queue(void)
+{
+    const int budget = tx_drain_budget();
+    for (int i = 0; i < budget; i++)
+    {
+        // Drained frames are pure bonus throughput — never worth running
+        // the wake into the backstop for
+        if (wake_past_deadline(WAKE_TX_DEADLINE_MS))
+        {
+            return;
+        }
+
+        report_payload_t queued;
+        size_t len = 0;
+        if (report_queue_pop(&queued, &len) != ESP_OK || len != sizeof(queued))
+        {
+            return;
+        }
+
+        // Queued frames are out of sequence — always send as keyframes
+        if (lora_send_report(&queued, true) != ESP_OK)
+        {
+            // Link dropped again mid-drain — requeue, back off, give up
+            report_queue_push(&queued, sizeof(queued));
+            tx_retry_note_failure();
+            return;
+        }
+        SAT_LOGI("Drained 1 queued report (%u remaining)\n",
+               (unsigned)report_queue_count());
+    }
+}
+
+// Checks if a LoRa transmit is due
 static bool transmit_due(void)
 {
-    return s_rtc_state.cycle_sample_count >= SAMPLES_PER_TRANSMIT;
+    return s_rtc_state.cycle_sample_count >= s_rtc_state.cfg_samples_per_transmit;
+}
+
+// The slow transmit tail, running entirely against bank A (s_acc_bank)
+// while the background sampler owns the live accumulator. Nothing in here
+// may touch the live sample fields.
+static esp_err_t transmit_cycle_banked(void)
+{
+    // First wake that can push, pop or record — pay the partition scans now
+    storage_mounts_ensure();
+
+    // Serve the fix from the RTC cache when it is still fresh; otherwise
+    // collect the acquisition started at wakeup (overlapped with sensing)
+    gps_fix_t gps = {0};
+    report_payload_t report = {0};
+    if (!gps_fix_from_cache(&gps))
+    {
+        esp_err_t join_err = gps_acquisition_join(&gps);
+        if (join_err != ESP_OK)
+        {
+            SAT_LOGI("GPS acquisition failed: %s\n", esp_err_to_name(join_err));
+            return join_err;
+        }
+        if (gps.valid)
+        {
+            gps_cache_store(&gps);
+        }
+        else if (s_gps_cache.magic == GPS_CACHE_MAGIC && s_gps_cache.fix.valid)
+        {
+            // Aborted or timed-out acquisition: a stale anchorage position
+            // still beats an empty one on a moored platform
+            gps = s_gps_cache.fix;
+            gps.unix_time += (uint32_t)(
+                (rtc_wall_us() - s_gps_cache.acquired_wall_us) / 1000000ULL);
+            SAT_LOGI("Reusing stale cached fix after failed acquisition\n");
+        }
+    }
+    esp_err_t err;
+
+    // Build report_payload_t struct using the snapshot and gps data
+    rtc_state_build_report(&s_acc_bank, &report, &gps);
+
+    // Black-box: every built report is recorded to flash (with profiling
+    // stats) regardless of what the radio gates below decide
+    {
+        uint8_t rec[ORCA_REPORT_WIRE_SIZE + PROF_TRAILER_MAX_SIZE];
+        static_assert(sizeof(rec) <= BLACKBOX_RECORD_MAX,
+                      "blackbox slot too small for report + stats trailer");
+        orca_report_wire_t bb;
+        report_to_wire(&report, &bb);
+        memcpy(rec, &bb, ORCA_REPORT_WIRE_SIZE);
+        size_t rlen = ORCA_REPORT_WIRE_SIZE +
+                      prof_append_stats_raw(rec + ORCA_REPORT_WIRE_SIZE);
+        blackbox_append(rec, rlen);
+    }
+
+    // Suppress spectrally-unchanged reports (stable overnight / overcast
+    // conditions), bounded by the heartbeat so silence stays meaningful
+    const report_payload_t *prev = last_kept_report();
+    if (prev != NULL && report_unchanged(&report, prev) &&
+        s_suppressed_reports < TX_HEARTBEAT_MAX_SKIPS)
+    {
+        s_suppressed_reports++;
+        SAT_LOGD("Channels unchanged within epsilon; report suppressed (%lu/%d)\n",
+               (unsigned long)s_suppressed_reports, TX_HEARTBEAT_MAX_SKIPS);
+        return ESP_OK;
+    }
+    s_suppressed_reports = 0;
+
+    // Stage the completed report; the accumulator was already handed to
+    // the new window at the bank swap
+    if (s_batch_rtc.magic != BATCH_RTC_MAGIC ||
+        s_batch_rtc.count > REPORTS_PER_BATCH)
+    {
+        s_batch_rtc.magic = BATCH_RTC_MAGIC;
+        s_batch_rtc.count = 0;
+    }
+    // A still-full batch here means the last cycle could neither transmit
+    // nor spill (flash push failed): drop the oldest staged report to make
+    // room — the same newest-wins policy the flash ring itself applies
+    if (s_batch_rtc.count == REPORTS_PER_BATCH)
+    {
+        for (uint32_t i = 1; i < REPORTS_PER_BATCH; i++)
+        {
+            s_batch_rtc.reports[i - 1] = s_batch_rtc.reports[i];
+        }
+        s_batch_rtc.count--;
+        SAT_LOGI("Batch still full from a failed spill; oldest report dropped\n");
+    }
+    s_batch_rtc.reports[s_batch_rtc.count++] = report;
+
+    if (s_batch_rtc.count < REPORTS_PER_BATCH)
+    {
+        SAT_LOGD("Report staged (%lu/%d); radio stays asleep this cycle\n",
+               (unsigned long)s_batch_rtc.count, REPORTS_PER_BATCH);
+        return ESP_OK;
+    }
+
+    // Soft deadline: if the earlier stages already ate most of the wake
+    // budget, starting airtime now risks tripping the hard backstop
+    // mid-transmission. Spill the batch to flash instead — the next
+    // healthy wake drains it once its own live transmit succeeds.
+    if (wake_past_deadline(WAKE_TX_DEADLINE_MS))
+    {
+        uint32_t queued = spill_batch_to_flash();
+        SAT_LOGI("Wake past %d ms TX deadline — %lu report(s) queued to flash\n",
+               WAKE_TX_DEADLINE_MS, (unsigned long)queued);
+        return ESP_OK;
+    }
+
+    // Outage backoff: inside a randomized sit-out window, defer the airtime
+    // (not the data — the batch spills to flash like any other miss, and
+    // reports the flash refuses stay staged rather than being cleared)
+    if (tx_retry_should_skip())
+    {
+        spill_batch_to_flash();
+        return ESP_OK;
+    }
+
+    // Batch full — one transmission carries all staged reports
+    if (REPORTS_PER_BATCH == 1)
+    {
+        err = lora_send_report(&s_batch_rtc.reports[0], false);
+    }
+    else
+    {
+        err = lora_send_batch(s_batch_rtc.reports, s_batch_rtc.count);
+    }
+
+    if (err != ESP_OK)
+    {
+        // Spill the whole batch to flash so a multi-minute link outage
+        // costs no data
+        SAT_LOGI("LoRa transmit failed: %s\n", esp_err_to_name(err));
+        uint32_t queued = spill_batch_to_flash();
+        SAT_LOGI("Queued %lu report(s) to flash (%u pending)\n",
+               (unsigned long)queued, (unsigned)report_queue_count());
+        tx_retry_note_failure();
+        return err;
+    }
+    s_batch_rtc.count = 0;
+    tx_retry_note_success();
+
+    SAT_LOGI("Report batch sent successfully.\n");
+
+    // Link is up — opportunistically retransmit frames from past outages
+    if (report_queue_count() > 0)
+    {
+        drain_report_queue();
+    }
+
+    return ESP_OK;
 }
 
 // Performs transmit operations
 static esp_err_t perform_transmit_cycle(void)
 {
-    // Update averaged sample count
-    s_rtc_state.total_sample_count++;
+    // Update averaged sample count (checkpointed to NVS every Nth transmit)
+    seq_advance();
 
     // Check for sensor data to transmit
     if (s_rtc_state.cycle_sample_count == 0)
     {
-        printf("Report due, but no samples stored\n");
+        SAT_LOGI("Report due, but no samples stored\n");
         return ESP_OK;
     }
 
-    // Obtain GPS data
-    gps_fix_t gps = {0};
-    report_payload_t report = {0};
-    esp_err_t err = get_gps_fix(&gps);
-    if (err != ESP_OK)
+    // Battery gate: below the TX cutoff the radio burst would brown the
+    // regulator out and crash-loop the chip. Keep accumulating — the data
+    // is safe in RTC and goes out once the pack recovers (or the sun rises)
+    if (s_batt_mv > 0 && s_batt_mv < BATT_TX_CUTOFF_MV)
     {
-        printf("GPS acquisition failed: %s\n", esp_err_to_name(err));
-        return err;
+        SAT_LOGI("Battery %u mV below TX cutoff %d mV — accumulate-only cycle\n",
+               s_batt_mv, BATT_TX_CUTOFF_MV);
+        return ESP_OK;
     }
 
-    // Build report_payload_t struct using s_rtc_state and gps data
-    rtc_state_build_report(&report, &gps);
+    // Night governor: in the dark there is nothing worth a full report —
+    // heartbeat only, no GPS, and the caller stretches the sleep period
+    night_mode_update();
+    if (s_rtc_state.night_mode)
+    {
+        uint16_t clear_avg = orca_avg_u16(s_rtc_state.sums[ORCA_CH_CLEAR],
+                                     s_rtc_state.cycle_sample_count);
+        rtc_state_clear_accumulator();
+        return lora_send_heartbeat(clear_avg);
+    }
 
-    // Send report_payload_t struct using LoRa
-    err = lora_send_report(&report);
-    if (err != ESP_OK)
+    // Flicker check: a FIFO burst on the FD photodiode flags 50/60 Hz
+    // contamination from ship deck lighting. The report still goes out —
+    // shore processing discounts flagged windows — but the condition is
+    // visible at the source instead of being discovered in post. Runs
+    // before the bank swap so the background sampler owns the sensor bus
+    // for the rest of the cycle.
+    if (s_sensor != NULL)
     {
-        printf("LoRa transmit failed: %s\n", esp_err_to_name(err));
-        return err;
+        as7343_flicker_t flicker = {};
+        if (as7343_measure_flicker(s_sensor, &flicker) == ESP_OK &&
+            flicker.detected)
+        {
+            SAT_LOGI("Flicker detected (%u permille) — window likely artificially lit\n",
+                   flicker.modulation_permille);
+        }
     }
 
-    // Reset the s_rtc_state data struct
-    printf("Report sent successfully. Clearing retained accumulator.\n");
+    // Bank swap: snapshot the accumulator for the transmit path (bank A)
+    // and clear the live copy, so the slow tail below — GPS join, radio
+    // airtime — no longer punches a sampling blackout into the window:
+    // the background sampler keeps filling the live copy (bank B)
+    s_acc_bank = s_rtc_state;
     rtc_state_clear_accumulator();
 
-    return ESP_OK;
+    bg_sampling_start();
+    esp_err_t err = transmit_cycle_banked();
+    bg_sampling_join();
+    return err;
+}
+
+/* ---------- On-demand self-benchmark ---------- */
+
+// Factory bench numbers go stale the moment hardware ages or a connector
+// corrodes: the board that measured 65 us per FIFO load on the bench may
+// be paying triple that through an oxidized header two winters later, and
+// the first visible symptom is a battery curve or a data gap. On command,
+// re-run the same micro-measurements on-target and answer with a compact
+// frame; shore tooling diffs it against the unit's factory baseline.
+// Composite wake timings are already harvestable via DUMP_STATS — this
+// frame carries the primitives underneath them.
+//
+// Response payload (little-endian):
+//   u8  version
+//   u32 i2c_burst_us    one full AS7343 spectral read, integration
+//                       included (0 = sensor absent)
+//   u32 spi_fifo_us     52-byte transfer on the radio bus, chip deselected
+//                       (~65 us factory at 8 MHz — see EspHal::spiBegin)
+//   u32 gps_time_us     receiver wake to first time-bearing sentence
+//                       (0 = timed out)
+//   u32 nvs_commit_us   one u32 write + commit (flash wear lands here)
+//   u32 pack_1k_us      1000 x orca_channels_pack of a fixed block
+//                       (CPU clock / flash-cache sanity)
+#define SELF_BENCH_VERSION 1
+#define SELF_BENCH_SIZE (1 + 5 * 4)
+#define SELF_BENCH_GPS_TIMEOUT_MS 3000
+
+static void bench_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static size_t self_bench_run(uint8_t *resp)
+{
+    int64_t t0;
+
+    // I2C burst: the exact read every sampling wake pays
+    uint32_t i2c_burst_us = 0;
+    if (s_sensor != NULL)
+    {
+        as7343_channels_t ch = {0};
+        t0 = esp_timer_get_time();
+        if (as7343_get_spectral_data(s_sensor, &ch) == ESP_OK)
+        {
+            i2c_burst_us = (uint32_t)(esp_timer_get_time() - t0);
+        }
+    }
+
+    // SPI: same driver path as a radio FIFO load, but with the SX1262
+    // deselected so no byte reaches it — pure bus/driver/DMA timing
+    uint32_t spi_fifo_us;
+    {
+        gpio_set_direction(LORA_CS, GPIO_MODE_OUTPUT);
+        gpio_set_level(LORA_CS, 1);
+        EspHal hal(SPI_SCK, SPI_MISO, SPI_MOSI);
+        hal.spiBegin(); // Retained-bus: reuses a live SPI2_HOST if present
+        uint8_t out[52] = {0};
+        uint8_t in[52];
+        t0 = esp_timer_get_time();
+        hal.spiTransfer(out, sizeof(out), in);
+        spi_fifo_us = (uint32_t)(esp_timer_get_time() - t0);
+        hal.spiEnd();
+    }
+
+    // GPS: receiver wake to first time-bearing sentence. Antenna or
+    // backup-supply degradation stretches this long before fixes fail.
+    uint32_t gps_time_us = 0;
+    {
+        gps_init(); // Idempotent; wakes the receiver if already up
+        t0 = esp_timer_get_time();
+        if (gps_refresh_time(SELF_BENCH_GPS_TIMEOUT_MS))
+        {
+            gps_time_us = (uint32_t)(esp_timer_get_time() - t0);
+        }
+        gps_sleep();
+    }
+
+    // NVS: a u32 write + commit, the unit of every checkpoint this
+    // firmware makes. Worn sectors show up as a growing commit time.
+    uint32_t nvs_commit_us = 0;
+    {
+        nvs_handle_t h;
+        if (nvs_open("orca_bench", NVS_READWRITE, &h) == ESP_OK)
+        {
+            static uint32_t s_bench_counter = 0;
+            t0 = esp_timer_get_time();
+            if (nvs_set_u32(h, "t", ++s_bench_counter) == ESP_OK &&
+                nvs_commit(h) == ESP_OK)
+            {
+                nvs_commit_us = (uint32_t)(esp_timer_get_time() - t0);
+            }
+            nvs_close(h);
+        }
+    }
+
+    // CPU: fixed work whose time moves only with clock config or
+    // flash-cache health, anchoring the measurements above
+    uint32_t pack_1k_us;
+    {
+        uint16_t channels[ORCA_NUM_CHANNELS];
+        for (int i = 0; i < ORCA_NUM_CHANNELS; i++)
+        {
+            channels[i] = (uint16_t)(i * 4093);
+        }
+        uint8_t packed[ORCA_PACKED_CH_BYTES];
+        volatile uint8_t sink = 0;
+        t0 = esp_timer_get_time();
+        for (int i = 0; i < 1000; i++)
+        {
+            sink ^= orca_channels_pack(channels, packed);
+        }
+        pack_1k_us = (uint32_t)(esp_timer_get_time() - t0);
+        (void)sink;
+    }
+
+    resp[0] = SELF_BENCH_VERSION;
+    bench_put_u32(resp + 1, i2c_burst_us);
+    bench_put_u32(resp + 5, spi_fifo_us);
+    bench_put_u32(resp + 9, gps_time_us);
+    bench_put_u32(resp + 13, nvs_commit_us);
+    bench_put_u32(resp + 17, pack_1k_us);
+
+    SAT_LOGI("Self-bench: i2c %lu us, spi %lu us, gps %lu us, nvs %lu us, pack %lu us\n",
+           (unsigned long)i2c_burst_us, (unsigned long)spi_fifo_us,
+           (unsigned long)gps_time_us, (unsigned long)nvs_commit_us,
+           (unsigned long)pack_1k_us);
+    return SELF_BENCH_SIZE;
+}
+
+/* ---------- RS-485 command channel ---------- */
+
+// Wired command handler: the bench gets the same knobs the air has
+// (config, dark calibration, profiling stats, flash-queue harvest)
+// without reflashing. SET_CONFIG reuses the HMAC-signed remote-config
+// frame so the wire grants no more authority than LoRa does.
+static size_t rs485_handle_command(uint8_t cmd, const uint8_t *arg,
+                                   size_t arg_len, uint8_t *resp,
+                                   size_t resp_max)
+{
+    switch (cmd)
+    {
+    case RS485_CMD_GET_CONFIG:
+    {
+        if (resp_max < 12)
+        {
+            return 0;
+        }
+        const uint32_t vals[3] = {
+            s_cfg.transmit_cycle_ms,
+            s_cfg.samples_per_transmit,
+            s_cfg.gps_lock_timeout_ms,
+        };
+        for (size_t i = 0; i < 3; i++)
+        {
+            resp[i * 4 + 0] = (uint8_t)(vals[i] & 0xFF);
+            resp[i * 4 + 1] = (uint8_t)(vals[i] >> 8);
+            resp[i * 4 + 2] = (uint8_t)(vals[i] >> 16);
+            resp[i * 4 + 3] = (uint8_t)(vals[i] >> 24);
+        }
+        return 12;
+    }
+
+    case RS485_CMD_SET_CONFIG:
+        resp[0] = remote_config_apply_frame(arg, arg_len, &s_cfg) ? 1 : 0;
+        if (resp[0])
+        {
+            rtc_state_seed_config();
+        }
+        return 1;
+
+    case RS485_CMD_CALIBRATE:
+        resp[0] = (s_sensor != NULL &&
+                   as7343_calibrate_dark(s_sensor) == ESP_OK) ? 1 : 0;
+        return 1;
+
+    case RS485_CMD_DUMP_STATS:
+        if (resp_max < PROF_TRAILER_MAX_SIZE)
+        {
+            return 0;
+        }
+        return prof_append_stats(resp);
+
+    case RS485_CMD_DUMP_BOX:
+    {
+        // Bulk harvest: stream every record as its own 'b' frame at the
+        // negotiated rate, then answer with the total count (4 bytes —
+        // shorter than any record, which is how the chamber tells them
+        // apart). A month of records drains in under a minute at 921600.
+        blackbox_flush(); // Pending delta group becomes readable
+        size_t count = blackbox_count();
+        uint8_t rec[BLACKBOX_RECORD_MAX];
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t rlen = 0;
+            if (blackbox_read(i, rec, &rlen) != ESP_OK)
+            {
+                break;
+            }
+            rs485_send_blob(RS485_CMD_DUMP_BOX, rec, rlen);
+        }
+        resp[0] = (uint8_t)(count & 0xFF);
+        resp[1] = (uint8_t)(count >> 8);
+        resp[2] = (uint8_t)(count >> 16);
+        resp[3] = (uint8_t)(count >> 24);
+        return 4;
+    }
+
+    case RS485_CMD_DUMP_BENCH:
+    {
+        // Same bulk-harvest shape as DUMP_BOX: the capture streams out as
+        // indexed 'p' chunk frames, then the sample count answers the
+        // command. Empty (or flight-build) captures answer count 0.
+        uint8_t chunk[4 + BENCH_POWER_CHUNK_SAMPLES * 3];
+        size_t idx = 0;
+        size_t clen;
+        while ((clen = bench_power_chunk(idx, chunk, sizeof(chunk))) > 0)
+        {
+            rs485_send_blob(RS485_CMD_DUMP_BENCH, chunk, clen);
+            idx += (clen - 4) / 3;
+        }
+        size_t count = bench_power_count();
+        resp[0] = (uint8_t)(count & 0xFF);
+        resp[1] = (uint8_t)(count >> 8);
+        resp[2] = (uint8_t)(count >> 16);
+        resp[3] = (uint8_t)(count >> 24);
+        return 4;
+    }
+
+    case RS485_CMD_SELF_BENCH:
+        if (resp_max < SELF_BENCH_SIZE)
+        {
+            return 0;
+        }
+        return self_bench_run(resp);
+
+    case RS485_CMD_DUMP_LOG:
+    {
+        // One queued frame per command: byte 0 carries the remaining
+        // count so the chamber knows when to stop asking
+        uint8_t frame[REPORT_QUEUE_FRAME_MAX];
+        size_t flen = 0;
+        if (report_queue_pop(frame, &flen) != ESP_OK ||
+            1 + flen > resp_max)
+        {
+            resp[0] = 0;
+            return 1;
+        }
+        size_t remaining = report_queue_count();
+        resp[0] = (remaining > 255) ? 255 : (uint8_t)remaining;
+        memcpy(resp + 1, frame, flen);
+        return 1 + flen;
+    }
+
+    default:
+        return 0; // Unknown command: bare header-only reply
+    }
+}
+
+/* ---------- RS-485 streaming mode ---------- */
+
+// Wired means powered: a deep-sleep/boot cycle per wired sample pays boot,
+// I2C init and sensor power-up (400 ms+) for data the bench could take at
+// the sensor's own rate. While the RS-485 link holds, stay awake and
+// stream back-to-back samples — the sensor free-runs, so each read
+// returns at the integration-time limit (~20+ Hz at default atime/astep
+// instead of the ~1 Hz duty cycle) at no battery cost.
+static void rs485_stream_loop(const gps_fix_t *gps)
+{
+    SAT_LOGI("RS-485 streaming: sampling at the integration-time limit\n");
+
+    const int64_t t0_us = esp_timer_get_time();
+    uint32_t frames = 0;
+
+    while (is_connected())
+    {
+        as7343_channels_t ch = {0};
+        esp_err_t err = as7343_get_spectral_data(s_sensor, &ch);
+        if (err != ESP_OK)
+        {
+            SAT_LOGI("Streaming read failed: %s\n", esp_err_to_name(err));
+            break;
+        }
+
+        // Keep the exposure tracking scene changes just like the duty cycle
+        agc_update(ch.clear);
+
+        orca_report_wire_t wire = {};
+        // The RTC counter keeps the wired stream on the same sequence as
+        // the radio reports; NVS checkpointing stays on the transmit path
+        // so 20 Hz framing does not grind flash
+        wire.sample_count = ++s_rtc_state.total_sample_count;
+        as7343_to_channel_array(&ch, wire.channels);
+        wire.gps_valid = gps->valid ? 1u : 0u;
+        wire.lat_e7 = deg_to_e7(gps->latitude_deg);
+        wire.lon_e7 = deg_to_e7(gps->longitude_deg);
+        wire.unix_time = gps->valid
+            ? gps->unix_time +
+                  (uint32_t)((esp_timer_get_time() - t0_us) / 1000000LL)
+            : 0;
+        wire.batt_mv = s_batt_mv;
+
+        if (!rs485_send(&wire))
+        {
+            SAT_LOGI("Streaming frame %lu failed to send\n",
+                   (unsigned long)frames);
+            break;
+        }
+        frames++;
+
+        // Drain any commands the chamber slipped in between frames
+        rs485_service_commands(0);
+
+        // Let the idle task feed the watchdog; the sensor's integration
+        // time is the real pacing element
+        vTaskDelay(1);
+    }
+
+    SAT_LOGI("Streaming ended after %lu frames; resuming duty cycle\n",
+           (unsigned long)frames);
 }
 
 /* ---------- Sleep ---------- */
 
+// Shortest sleep worth arming; below this we jump to the next deadline
+// rather than waking again almost immediately
+#define MIN_SLEEP_US 50000ULL
+
+// Sleeps at least this long park the AS7343 (as7343_sleep) before the MCU
+// goes down. A parked sensor fails the wake stub's AVALID check, so that
+// wake full-boots into the driver's fast-wake path — fine for stretched
+// night/solar sleeps where sensor idle draw dominates, wrong for the 1 s
+// cadence where the free-running sensor is what makes stub sampling work.
+#define SENSOR_PARK_MIN_US 5000000ULL
+
+// Fleet TDMA: with 3-6 satellites per vessel, free-running schedules still
+// collide even behind listen-before-talk. Each node snaps its wakeups onto
+// its own slot of the absolute (GPS-time) period grid, so the fleet
+// interleaves without ever hearing each other. Engages only once a GPS fix
+// has disciplined the wall clock (gps_cache_store runs settimeofday).
+//
+// The same snap is what keeps the fleet's SAMPLES on one shared timeline:
+// every governor stretch is an integer multiple of the base period, and a
+// grid of k x (m x base) anchored at the epoch is a subset of the base
+// grid — so whatever rates individual nodes are running, their samples
+// land on the same absolute seconds (:00/:05/:10 ...) and shore-side
+// merging is a column join, not a resampling pass. Stub-only wakes
+// free-run for the few samples inside one transmit window; the next full
+// wake snaps the phase back.
+#define FLEET_TDMA_ENABLED 1
+// FLEET_NODE_ID lives with the LoRa configuration up top (it also selects
+// the transmit carrier); only the slot geometry is defined here
+#define FLEET_SLOT_COUNT 6 // Max nodes per vessel
+
+// The sensor read happens this long after the wake timer fires (deep-sleep
+// boot plus driver bring-up, measured typical). The scheduler wakes this
+// much early so the sample — not the wake — lands on the grid tick.
+#define SAMPLE_WAKE_LEAD_US 150000ULL
+
+// Wall clock values before this are boot-relative, not GPS time (2020-01-01)
+#define FLEET_EPOCH_MIN_US 1577836800000000ULL
+
+// Solar scheduling governor: with position and GPS-disciplined time in
+// hand, scale the sampling period with sun elevation instead of sampling
+// uniformly around the clock. The light signal's information rate peaks
+// through the dawn/dusk transitions, so that band keeps the base rate;
+// stable midday and deep night get stretched. Unlike the optical night
+// governor this knows dawn is coming while it is still pitch dark, so the
+// transition is never sampled at the night rate. Bands are elevation in
+// centi-degrees; -6 deg is civil twilight's lower edge.
+#define SOLAR_NIGHT_CDEG    (-600) // Below: night — optical governor's rate
+#define SOLAR_TRANS_CDEG     1500  // -6..15 deg: dawn/dusk — base rate
+#define SOLAR_MID_CDEG       3500  // 15..35 deg: shoulder
+#define SOLAR_SHOULDER_MULT  2
+#define SOLAR_MIDDAY_MULT    4     // Above 35 deg: stable midday
+
+// Period stretch factor from the current sun angle, or 0 when position or
+// disciplined time is missing (callers fall back to the night governor)
+static uint32_t solar_period_multiplier(void)
+{
+    if (s_gps_cache.magic != GPS_CACHE_MAGIC || !s_gps_cache.fix.valid)
+    {
+        return 0;
+    }
+    const uint64_t wall_us = rtc_wall_us();
+    if (wall_us < FLEET_EPOCH_MIN_US)
+    {
+        return 0; // Wall clock was never GPS-disciplined
+    }
+
+    // Position from the cache without charging its reuse budget: a mast
+    // does not move far enough between fixes to bend the sun angle
+    int32_t elev = solar_elevation_cdeg((uint32_t)(wall_us / 1000000ULL),
+                                        deg_to_e7(s_gps_cache.fix.latitude_deg),
+                                        deg_to_e7(s_gps_cache.fix.longitude_deg));
+    if (elev < SOLAR_NIGHT_CDEG)
+    {
+        return (uint32_t)NIGHT_SLEEP_MULTIPLIER;
+    }
+    if (elev < SOLAR_TRANS_CDEG)
+    {
+        return 1;
+    }
+    if (elev < SOLAR_MID_CDEG)
+    {
+        return SOLAR_SHOULDER_MULT;
+    }
+    return SOLAR_MIDDAY_MULT;
+}
+
+/* ---------- Pre-sleep GPIO quiescence ---------- */
+
+// Park every output in its lowest-leakage state and latch it with the pad
+// hold circuit before deep sleep; gpio_holds_release() undoes the latches
+// first thing on wake, before any peripheral re-init. Pins deliberately
+// not touched: SDA/SCL (18/19) keep their main-app pad config because the
+// wake stub bit-bangs them, and they idle high drawing nothing through
+// the pull-ups; pure inputs (MISO, BUSY, DIO1, RS_SNS, GPS RX) have no
+// drive to leak.
+static void gpio_quiesce_for_sleep(void)
+{
+    // Level choices: RS_EN low disables the MAX3485 driver; status LEDs
+    // off; LoRa CS and RESET high keep the sleeping SX1262 deselected and
+    // out of reset (reset would wipe its retained config); SCK/MOSI low
+    // so the radio's inputs aren't left floating mid-rail; GPS TX high —
+    // the UART idle level — because any falling edge on the receiver's
+    // RXD wakes it from backup mode
+    static const struct { gpio_num_t pin; uint32_t level; } park[] = {
+        { RS_EN, 0 },
+        { RS_GRN, 0 },
+        { RS_YLW, 0 },
+        { LORA_CS, 1 },
+        { LORA_RESET, 1 },
+        { SPI_SCK, 0 },
+        { SPI_MOSI, 0 },
+        { GPIO_NUM_15 /* GPS TX (gps.c) */, 1 },
+    };
+    for (size_t i = 0; i < sizeof(park) / sizeof(park[0]); i++)
+    {
+        gpio_reset_pin(park[i].pin); // detach from whatever matrixed it
+        gpio_set_direction(park[i].pin, GPIO_MODE_OUTPUT);
+        gpio_set_level(park[i].pin, park[i].level);
+        gpio_hold_en(park[i].pin);
+    }
+    gpio_deep_sleep_hold_en();
+}
+
+// Release the pad holds so the wake's peripheral inits get live pins
+static void gpio_holds_release(void)
+{
+    static const gpio_num_t held[] = {
+        RS_EN, RS_GRN, RS_YLW, LORA_CS, LORA_RESET,
+        SPI_SCK, SPI_MOSI, GPIO_NUM_15,
+    };
+    gpio_deep_sleep_hold_dis();
+    for (size_t i = 0; i < sizeof(held) / sizeof(held[0]); i++)
+    {
+        gpio_hold_dis(held[i]);
+    }
+}
+
 static void schedule_next_wakeup_and_sleep(void)
 {
-    const uint64_t sleep_us = SAMPLING_CYCLE_MS * 1000ULL;
+    // Sleeping is what the backstop exists to force; stop it so it cannot
+    // fire between here and esp_deep_sleep_start (stopping a one-shot from
+    // inside its own callback is a supported no-op)
+    wake_budget_disarm();
+
+    uint64_t period_us = ((uint64_t)s_rtc_state.cfg_transmit_cycle_ms /
+                          s_rtc_state.cfg_samples_per_transmit) * 1000ULL;
+
+#if SAMPLES_PER_WAKE > 1
+    // Each wake banked SAMPLES_PER_WAKE integrations, so the sleep spans
+    // that many sampling periods to hold the configured average rate
+    period_us *= SAMPLES_PER_WAKE;
+#endif
+
+    // Transient burst governor outranks everything: while a detected
+    // optical edge is being chased, sampling runs at the fast cadence
+    // regardless of what the solar/night governors would stretch to.
+    s_rtc_state.solar_period_mult = solar_period_multiplier();
+    if (s_rtc_state.burst_remaining > 0)
+    {
+        s_rtc_state.burst_remaining--;
+        period_us = (uint64_t)BURST_PERIOD_MS * 1000ULL;
+    }
+    // Solar governor next (it knows about the coming dawn), optical night
+    // governor as the fallback when position or time is missing. The
+    // multiplier persists in RTC state so stub-only wakes stretch alike.
+    else if (s_rtc_state.solar_period_mult > 0)
+    {
+        period_us *= s_rtc_state.solar_period_mult;
+    }
+    else if (s_rtc_state.night_mode)
+    {
+        period_us *= NIGHT_SLEEP_MULTIPLIER;
+    }
+
+    // esp_timer_get_time() counts from this wake, so it directly measures
+    // how much of the sampling period we have already consumed awake.
+    // Sleep only for the remainder so sample spacing stays at N x T_s
+    // instead of T_s + awake time.
+    const uint64_t awake_us = (uint64_t)esp_timer_get_time();
+
+    // If the cycle overran whole periods (e.g. GPS acquisition ran long),
+    // target the next future deadline instead of sleeping for ~0 and
+    // bunching samples together
+    const uint64_t missed = awake_us / period_us;
+    uint64_t sleep_us = (missed + 1) * period_us - awake_us;
+    if (sleep_us < MIN_SLEEP_US)
+    {
+        sleep_us += period_us;
+    }
+
+#if FLEET_TDMA_ENABLED
+    // Shift the wakeup forward onto this node's slot boundary of the
+    // absolute period grid; all GPS-disciplined nodes agree on the grid.
+    // The phase is computed at the moment the SAMPLE will be taken
+    // (SAMPLE_WAKE_LEAD_US after the timer fires), so the sensor read —
+    // not the boot — lands on the grid tick and the fleet's samples line
+    // up on the same absolute seconds.
+    const uint64_t wall_us = rtc_wall_us();
+    if (wall_us > FLEET_EPOCH_MIN_US)
+    {
+        const uint64_t slot_us = period_us / FLEET_SLOT_COUNT;
+        const uint64_t target = (FLEET_NODE_ID % FLEET_SLOT_COUNT) * slot_us;
+        const uint64_t phase =
+            (wall_us + sleep_us + SAMPLE_WAKE_LEAD_US) % period_us;
+        sleep_us += (target + period_us - phase) % period_us;
+    }
+#endif
+
+    // Scale by the GPS-derived slow-clock correction last, after all the
+    // true-time math: the timer counts RTC-perceived microseconds, and
+    // clk_cal_q16 is the ratio that makes those elapse as true ones
+    if (s_rtc_state.clk_cal_q16 != 0 &&
+        s_rtc_state.clk_cal_q16 != CLK_CAL_ONE_Q16)
+    {
+        sleep_us = (sleep_us * (uint64_t)s_rtc_state.clk_cal_q16) >> 16;
+    }
 
     ESP_ERROR_CHECK(esp_sleep_enable_timer_wakeup(sleep_us));
 
-    printf("Sleeping for %llu ms\n", SAMPLING_CYCLE_MS);
-    fflush(stdout);
+    // Explicit power-domain map instead of the IDF's conservative
+    // defaults. The sleep floor, not the awake path, dominates energy at
+    // multi-second spacing, so every domain the timer wake doesn't need
+    // is forced off: only LP SRAM stays powered (wake stub code plus
+    // s_rtc_state and its snapshot banks). The timer itself counts on the
+    // always-on slow clock; there is no EXT/LP-GPIO wake source, no use
+    // of the fast RC between wakes, and the 2.4 GHz modem never runs.
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_FAST_MEM, ESP_PD_OPTION_ON);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_SLOW_MEM, ESP_PD_OPTION_ON);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_OFF);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_XTAL, ESP_PD_OPTION_OFF);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RC_FAST, ESP_PD_OPTION_OFF);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_MODEM, ESP_PD_OPTION_OFF);
+
+#if SAMPLES_PER_WAKE > 1
+    // Burst mode and the wake stub amortize the same fixed wake cost in
+    // different ways, and the stub only collects one integration per wake
+    // — installing it here would silently undersample. Every wake takes
+    // the full-boot path instead.
+#else
+    // Sensor-only wakeups are handled entirely by the RTC-resident stub;
+    // it falls through to a normal boot when a transmit cycle is due
+    esp_set_deep_sleep_wake_stub(&wake_stub_sample);
+#endif
+
+    SAT_LOGD("Awake %llu ms; sleeping %llu ms to hold %llu ms spacing\n",
+           (unsigned long long)(awake_us / 1000ULL),
+           (unsigned long long)(sleep_us / 1000ULL),
+           (unsigned long long)(period_us / 1000ULL));
+    SAT_LOGD("Mem: min free heap %lu B, main stack HWM %u B\n",
+           (unsigned long)esp_get_minimum_free_heap_size(),
+           (unsigned)uxTaskGetStackHighWaterMark(NULL));
+
+    // Drain the log ring before the RAM holding it disappears; every
+    // profiled stage is already closed, so this blocks nothing measured
+    sat_log_flush(500);
+
+#if BENCH_POWER_ENABLED
+    // Bench capture ends here — deep sleep would discard the RAM buffer —
+    // and the rig gets a command window to harvest it ('p') before the
+    // node goes down
+    bench_power_stop();
+    rs485_service_commands(BENCH_POWER_HARVEST_MS);
+#endif
+
+    // Long sleep: the sensor's active idle current matters more than the
+    // stub fast path we give up (see SENSOR_PARK_MIN_US). Best effort —
+    // on failure the sensor just keeps free-running as before.
+    if (sleep_us >= SENSOR_PARK_MIN_US && s_sensor != NULL)
+    {
+        as7343_sleep(s_sensor);
+    }
+
+    // Park and latch every output in its lowest-leakage state; this is
+    // the last thing to touch a peripheral before the CPU goes away
+    gpio_quiesce_for_sleep();
+
+    // Snapshot everything this wake mutated before losing the CPU
+    rtc_state_commit();
 
     esp_deep_sleep_start();
 }
@@ -474,52 +3247,167 @@ static void schedule_next_wakeup_and_sleep(void)
 
 extern "C" void app_main(void)
 {
+    // Branch on the wake cause first: a routine timer wake — the millionth
+    // of its kind — trusts the RTC caches and skips everything one-time,
+    // while first power-on, brownout recovery and panic resets take the
+    // full bring-up with its banner and integrity restore
+    const bool timer_wake =
+        esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+
+    // Logging goes asynchronous from here: producers fill a RAM ring, the
+    // drain task owns the UART (see sat_log.c)
+    sat_log_init();
+
     // Initialize RTC memory if needed
     rtc_state_init_if_needed();
 
-    printf("RTC state: cycle_sample_count=%lu total_sample_count=%lu\n",
+    // Unlatch the pads the previous wake parked (no-op on cold boot)
+    gpio_holds_release();
+
+    if (!timer_wake)
+    {
+        SAT_LOGI("Cold start (wakeup cause %d): RTC state %s\n",
+               (int)esp_sleep_get_wakeup_cause(),
+               s_rtc_cold_boot ? "reset" : "carried over");
+    }
+
+    // Configure DFS before any phase work; no-op unless CONFIG_PM_ENABLE
+    pm_init();
+
+    // Bench builds only: shunt-current capture covers everything from here
+    // to the pre-sleep harvest window (no-op in flight images)
+    bench_power_start();
+
+    // Backstop the whole wake before any peripheral can wedge it open
+    wake_budget_arm();
+
+    // Apply persisted timing overrides (or the compile-time defaults) and
+    // mirror them into RTC state for the wake stub
+    remote_config_load(&s_cfg);
+    rtc_state_seed_config();
+
+    // Full power loss wiped RTC memory: pick the sequence back up from the
+    // last NVS checkpoint instead of restarting at zero
+    seq_restore_if_cold_boot();
+
+    // Pack voltage: telemetry for every report and the brownout gate for
+    // the transmit path. A routine accumulate-only wake builds neither, so
+    // it skips the ADC unit bring-up entirely (the TX gate treats 0 as
+    // "no reading"); wired sessions always report, hence is_connected()
+    if (!timer_wake || is_connected() ||
+        s_rtc_state.cycle_sample_count + SAMPLES_PER_WAKE >=
+            s_rtc_state.cfg_samples_per_transmit)
+    {
+        s_batt_mv = read_battery_mv();
+        SAT_LOGD("Battery: %u mV\n", s_batt_mv);
+    }
+
+    // The flash queue and black box mount lazily (storage_mounts_ensure):
+    // their init scans cost nothing on the accumulate-only wakes that
+    // dominate the duty cycle
+
+    SAT_LOGD("RTC state: cycle_sample_count=%lu total_sample_count=%lu\n",
            (unsigned long)s_rtc_state.cycle_sample_count,
            (unsigned long)s_rtc_state.total_sample_count);
 
-    // Initialize I2C bus and sensor
-    init_i2c_and_sensor();
+    // Initialize I2C bus and sensor; persistent failure degrades the wake
+    // instead of aborting into a reboot loop
+    esp_err_t sensor_err = init_i2c_and_sensor();
+    if (sensor_err != ESP_OK)
+    {
+        SAT_LOGI("Sensor unavailable after %d attempts: %s\n",
+               SENSOR_INIT_ATTEMPTS, esp_err_to_name(sensor_err));
+        if (!is_connected())
+        {
+            // Stay visible on the fleet channel so shore can tell a dead
+            // sensor from a dead node
+            lora_send_heartbeat(0);
+        }
+        schedule_next_wakeup_and_sleep();
+    }
 
     if (is_connected())
     {
-        printf("RS-485 connected — bypassing LoRa averaging\n");
+        SAT_LOGI("RS-485 connected — bypassing LoRa averaging\n");
+
+        // Bench-powered and intentionally long-lived: no wake budget here
+        wake_budget_disarm();
+
+        // The wired session records every report and serves queue-harvest
+        // commands, so it needs the flash stores up front
+        storage_mounts_ensure();
+
+        // Wired command channel is live for the whole connected session
+        rs485_set_cmd_handler(rs485_handle_command);
+
+        // Start GPS in the background so it overlaps the sensor read
+        gps_acquisition_start();
 
         // Sample sensor
         esp_err_t err = read_sensor_and_accumulate();
         if (err != ESP_OK)
         {
-            printf("Sensor read failed: %s\n", esp_err_to_name(err));
+            SAT_LOGI("Sensor read failed: %s\n", esp_err_to_name(err));
             schedule_next_wakeup_and_sleep();
         }
 
         // Always get GPS on RS-485 path
         gps_fix_t gps = {0};
-        get_gps_fix(&gps);
+        gps_acquisition_join(&gps);
 
         // Build report from this single sample and send immediately
-        s_rtc_state.total_sample_count++;
+        seq_advance();
         report_payload_t report = {0};
-        rtc_state_build_report(&report, &gps);
+        rtc_state_build_report(&s_rtc_state, &report, &gps);
         rtc_state_clear_accumulator();
 
-        // rs_report_payload_t has identical layout — cast via memcpy
-        rs_report_payload_t rs_report;
-        memcpy(&rs_report, &report, sizeof(rs_report));
-        rs485_send(&rs_report);
+        // Same wire layout as the LoRa keyframe body
+        orca_report_wire_t wire;
+        report_to_wire(&report, &wire);
+        rs485_send(&wire);
+
+        // Wired reports are black-box material too
+        blackbox_append(&wire, ORCA_REPORT_WIRE_SIZE);
+
+        // Give the chamber a window to issue commands between reports
+        rs485_service_commands(20);
+
+        // Stay awake and stream while the link holds; returns on
+        // disconnect or sensor failure, then the normal sleep path runs
+        rs485_stream_loop(&gps);
     }
     else
     {
-        printf("No RS-485 device — normal LoRa path\n");
+        SAT_LOGD("No RS-485 device — normal LoRa path\n");
+
+        // If this wake's sample will trigger a transmit and the cached fix
+        // has aged out, start GPS now so UART acquisition runs concurrently
+        // with spectral integration. Night mode skips GPS altogether — the
+        // heartbeat carries no position.
+        if (s_rtc_state.cycle_sample_count + SAMPLES_PER_WAKE >= s_rtc_state.cfg_samples_per_transmit &&
+            !s_rtc_state.night_mode &&
+            !gps_cache_fresh())
+        {
+            gps_acquisition_start();
+        }
 
-        // Sensor sampling and RTC storage
-        esp_err_t err = read_sensor_and_accumulate();
+        // Sensor sampling and RTC storage. SAMPLES_PER_WAKE > 1 banks a
+        // burst of consecutive integrations against this wake's fixed
+        // boot cost — as7343_get_spectral_data waits out a complete
+        // auto-SMUX measurement each call, so every loop iteration is a
+        // distinct integration, not a re-read of stale registers.
+        esp_err_t err = ESP_OK;
+        for (uint32_t burst = 0; burst < SAMPLES_PER_WAKE; burst++)
+        {
+            err = read_sensor_and_accumulate();
+            if (err != ESP_OK)
+            {
+                break;
+            }
+        }
         if (err != ESP_OK)
         {
-            printf("Sensor read failed: %s\n", esp_err_to_name(err));
+            SAT_LOGI("Sensor read failed: %s\n", esp_err_to_name(err));
             schedule_next_wakeup_and_sleep();
         }
 
@@ -529,7 +3417,7 @@ extern "C" void app_main(void)
             err = perform_transmit_cycle();
             if (err != ESP_OK)
             {
-                printf("Report cycle failed; retained data kept for retry.\n");
+                SAT_LOGI("Report cycle failed; retained data kept for retry.\n");
             }
         }
     }
@@ -540,17 +3428,34 @@ extern "C" void app_main(void)
 // TODO: Implement default instantiation (below) to get rid of warnings
 
 /**
- * 
-size_t off = 0;
-uint32_t sample_count; memcpy(&sample_count, buf+off, 4); off+=4;
-uint16_t channels[13];
-for(int i=0;i<13;i++){ memcpy(&channels[i], buf+off, 2); off+=2; }
-bool valid = buf[off++];
-double lat, lon; uint32_t ts;
-memcpy(&lat, buf+off, 8); off+=8;
-memcpy(&lon, buf+off, 8); off+=8;
-memcpy(&ts,  buf+off, 4); off+=4;
- * 
+ * Receiver-side keyframe decode (frame[0] == PAYLOAD_FMT_KEYFRAME): the
+ * body is the shared packed struct, so it is a zero-copy cast —
+ *
+ *   const orca_report_wire_t *r = orca_report_decode(buf + 1);
+ *   double lat = r->lat_e7 / 1e7, lon = r->lon_e7 / 1e7;
+ *
+ * Delta frames (PAYLOAD_FMT_DELTA) carry zigzag varints against the
+ * previous decoded frame in the same field order, closed by two fixed
+ * little-endian bytes of absolute sample age.
+ *
+ * Extended frames (PAYLOAD_FMT_EXTENDED) are a keyframe body followed by
+ * 13 x (stddev, min, max) little-endian uint16 in channel order, then the
+ * sampling-window block: 8-byte window start (us since the Unix epoch on
+ * the GPS-disciplined clock, 0 = unknown) and 4-byte duration in ms, both
+ * little-endian. Batch frames always carry plain keyframe bodies.
+ *
+ * Masked frames (PAYLOAD_FMT_MASKED) are the keyframe layout with a
+ * 16-bit channel mask after the flag and only the selected channels in
+ * the spectral block; deselected channels hold their last decoded value.
+ *
+ * With LORA_FRAME_AUTH on, every frame ends in a 4-byte SipHash-2-4 tag
+ * over the preceding bytes (padding included in implicit-header mode);
+ * receivers verify it before decoding anything.
+ *
+ * Packed frames (PAYLOAD_FMT_PACKED, and _PACKED_BATCH bodies) replace
+ * the spectral block with a shift byte plus 13 x 12-bit values; expand
+ * with orca_channels_unpack() from orca_payload.h, the rest of the body
+ * is the keyframe tail unchanged.
  */
 
  // TODO
@@ -0,0 +1,363 @@
+#include "rtc_state.h"
+
+#include "esp_attr.h"
+#include "esp_rom_gpio.h"
+#include "esp_rom_sys.h"
+#include "esp_sleep.h"
+#include "esp_wake_stub.h"
+#include "soc/gpio_reg.h"
+#include "soc/gpio_sig_map.h"
+
+/**
+ * Deep-sleep wake stub for sensor-only cycles.
+ *
+ * With SAMPLES_PER_TRANSMIT > 1 most wakeups only read the AS7343 once and
+ * accumulate into s_rtc_state, yet they paid the full ESP-IDF boot. This
+ * stub runs straight out of RTC fast memory before the bootloader: it
+ * bit-bangs the single I2C burst read, accumulates, re-arms the timer and
+ * goes back to sleep. The full application boots only when the cycle will
+ * transmit or when anything looks off (bad RTC state, sensor not ready,
+ * I2C NACK) — the slow path is always the safe fallback.
+ *
+ * Everything here must live in RTC memory (RTC_IRAM_ATTR / RTC_DATA_ATTR)
+ * and may only call ROM functions; the pads keep their main-app IO MUX
+ * configuration (including I2C pull-ups) across deep sleep, we just re-route
+ * them from the I2C peripheral to plain GPIO for bit-banging.
+ *
+ * Why this is a wake stub and not the C6's LP core: the LP core would be
+ * strictly cheaper (microamps per sample, HP domain never powers up), but
+ * it can only reach LP IO — GPIO0..7 — and its LP_I2C controller is fixed
+ * to GPIO6/7. On this board the sensor is wired to GPIO18/19 (HP-domain
+ * only) and GPIO6/7 carry the radio's SPI clock and MOSI, so no LP-core
+ * path to the AS7343 exists without a respin that moves both buses. If
+ * that respin happens, this whole file becomes an LP-core program and the
+ * HP core wakes only on transmit_due(); until then the stub's abbreviated
+ * HP boot is the deepest per-sample optimization the wiring allows.
+ */
+
+/* Pin / device constants (mirror satellite-firmware.cpp and the driver) */
+#define STUB_SDA_GPIO      18
+#define STUB_SCL_GPIO      19
+#define STUB_I2C_ADDR      0x39
+#define STUB_HALF_PERIOD_US 5     /* ~100 kHz */
+
+#define STUB_REG_STATUS2   0x90
+#define STUB_REG_ASTATUS   0x94
+#define STUB_AVALID_BIT    (1u << 6)
+
+/* auto_smux=3 channel positions in the 18-word data block (see as7343.c) */
+#define STUB_CH_FZ   0
+#define STUB_CH_FY   1
+#define STUB_CH_FXL  2
+#define STUB_CH_NIR  3
+#define STUB_CH_VIS1 4
+#define STUB_CH_F2   6
+#define STUB_CH_F3   7
+#define STUB_CH_F4   8
+#define STUB_CH_F6   9
+#define STUB_CH_F1   12
+#define STUB_CH_F7   13
+#define STUB_CH_F8   14
+#define STUB_CH_F5   15
+
+/* ── Open-drain GPIO primitives ───────────────────────────────────────────── *
+ * High = release the line (input, external/pad pull-up), low = drive 0.    */
+
+static inline void RTC_IRAM_ATTR pin_release(uint32_t pin)
+{
+    REG_WRITE(GPIO_ENABLE_W1TC_REG, 1U << pin);
+}
+
+static inline void RTC_IRAM_ATTR pin_drive_low(uint32_t pin)
+{
+    REG_WRITE(GPIO_OUT_W1TC_REG, 1U << pin);
+    REG_WRITE(GPIO_ENABLE_W1TS_REG, 1U << pin);
+}
+
+static inline uint32_t RTC_IRAM_ATTR pin_read(uint32_t pin)
+{
+    return (REG_READ(GPIO_IN_REG) >> pin) & 1U;
+}
+
+static inline void RTC_IRAM_ATTR i2c_half_delay(void)
+{
+    esp_rom_delay_us(STUB_HALF_PERIOD_US);
+}
+
+/* ── Soft-I2C primitives ──────────────────────────────────────────────────── */
+
+static void RTC_IRAM_ATTR i2c_claim_pins(void)
+{
+    /* The main app leaves SDA/SCL matrixed to the I2C peripheral; reroute
+     * the pads to plain GPIO for bit-banging. Pad pull-ups persist. */
+    esp_rom_gpio_pad_select_gpio(STUB_SDA_GPIO);
+    esp_rom_gpio_pad_select_gpio(STUB_SCL_GPIO);
+    esp_rom_gpio_connect_out_signal(STUB_SDA_GPIO, SIG_GPIO_OUT_IDX, false, false);
+    esp_rom_gpio_connect_out_signal(STUB_SCL_GPIO, SIG_GPIO_OUT_IDX, false, false);
+    pin_release(STUB_SDA_GPIO);
+    pin_release(STUB_SCL_GPIO);
+    i2c_half_delay();
+}
+
+static void RTC_IRAM_ATTR i2c_start(void)
+{
+    pin_release(STUB_SDA_GPIO);
+    pin_release(STUB_SCL_GPIO);
+    i2c_half_delay();
+    pin_drive_low(STUB_SDA_GPIO);
+    i2c_half_delay();
+    pin_drive_low(STUB_SCL_GPIO);
+    i2c_half_delay();
+}
+
+static void RTC_IRAM_ATTR i2c_stop(void)
+{
+    pin_drive_low(STUB_SDA_GPIO);
+    i2c_half_delay();
+    pin_release(STUB_SCL_GPIO);
+    i2c_half_delay();
+    pin_release(STUB_SDA_GPIO);
+    i2c_half_delay();
+}
+
+/* Returns true when the slave ACKed */
+static bool RTC_IRAM_ATTR i2c_write_byte(uint8_t b)
+{
+    for (int i = 7; i >= 0; i--) {
+        if ((b >> i) & 1) pin_release(STUB_SDA_GPIO);
+        else              pin_drive_low(STUB_SDA_GPIO);
+        i2c_half_delay();
+        pin_release(STUB_SCL_GPIO);
+        i2c_half_delay();
+        pin_drive_low(STUB_SCL_GPIO);
+    }
+
+    /* ACK clock */
+    pin_release(STUB_SDA_GPIO);
+    i2c_half_delay();
+    pin_release(STUB_SCL_GPIO);
+    i2c_half_delay();
+    bool ack = (pin_read(STUB_SDA_GPIO) == 0);
+    pin_drive_low(STUB_SCL_GPIO);
+    i2c_half_delay();
+    return ack;
+}
+
+static uint8_t RTC_IRAM_ATTR i2c_read_byte(bool ack)
+{
+    uint8_t b = 0;
+    pin_release(STUB_SDA_GPIO);
+    for (int i = 7; i >= 0; i--) {
+        i2c_half_delay();
+        pin_release(STUB_SCL_GPIO);
+        i2c_half_delay();
+        b = (uint8_t)((b << 1) | pin_read(STUB_SDA_GPIO));
+        pin_drive_low(STUB_SCL_GPIO);
+    }
+
+    /* ACK / NACK */
+    if (ack) pin_drive_low(STUB_SDA_GPIO);
+    else     pin_release(STUB_SDA_GPIO);
+    i2c_half_delay();
+    pin_release(STUB_SCL_GPIO);
+    i2c_half_delay();
+    pin_drive_low(STUB_SCL_GPIO);
+    pin_release(STUB_SDA_GPIO);
+    i2c_half_delay();
+    return b;
+}
+
+/* Burst read: S addr+W reg Sr addr+R data... P. Returns false on any NACK. */
+static bool RTC_IRAM_ATTR i2c_read_regs(uint8_t reg, uint8_t *buf, uint32_t len)
+{
+    i2c_start();
+    if (!i2c_write_byte((STUB_I2C_ADDR << 1) | 0) || !i2c_write_byte(reg)) {
+        i2c_stop();
+        return false;
+    }
+    i2c_start();   /* repeated start */
+    if (!i2c_write_byte((STUB_I2C_ADDR << 1) | 1)) {
+        i2c_stop();
+        return false;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = i2c_read_byte(i + 1 < len);
+    }
+    i2c_stop();
+    return true;
+}
+
+/* ── CRC-protected snapshot banks ─────────────────────────────────────────── *
+ * Defined here (rather than the main app) so every helper the stub calls
+ * lives in RTC memory. The main app commits before each deep sleep; the
+ * stub commits after its accumulator mutations below.                       */
+
+RTC_DATA_ATTR rtc_state_bank_t s_rtc_banks[2];
+
+/* Bitwise (table-free) reflected CRC-32, poly 0xEDB88320. A lookup table
+ * would cost 1 KB of RTC memory for a ~730-byte message; not worth it. */
+uint32_t RTC_IRAM_ATTR rtc_state_crc32(const void *buf, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    uint32_t crc = 0xFFFFFFFFUL;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (uint32_t)(-(int32_t)(crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+void RTC_IRAM_ATTR rtc_state_commit(void)
+{
+    /* Overwrite the older bank so the newer one survives a brownout that
+     * lands mid-copy */
+    rtc_state_bank_t *dst = (s_rtc_banks[0].seq <= s_rtc_banks[1].seq)
+                                ? &s_rtc_banks[0] : &s_rtc_banks[1];
+    uint32_t newest = (s_rtc_banks[0].seq > s_rtc_banks[1].seq)
+                          ? s_rtc_banks[0].seq : s_rtc_banks[1].seq;
+
+    /* Word copy: no dependence on a flash-resident memcpy */
+    _Static_assert(sizeof(satellite_rtc_state_t) % 4 == 0,
+                   "RTC state must be word-copyable");
+    const uint32_t *src = (const uint32_t *)&s_rtc_state;
+    uint32_t *out = (uint32_t *)&dst->state;
+    for (uint32_t i = 0; i < sizeof(satellite_rtc_state_t) / 4; i++) {
+        out[i] = src[i];
+    }
+    dst->seq = newest + 1;
+    dst->crc = rtc_state_crc32(dst, sizeof(*dst) - sizeof(dst->crc));
+}
+
+/* ── Stub entry ───────────────────────────────────────────────────────────── */
+
+void RTC_IRAM_ATTR wake_stub_sample(void)
+{
+    /* Only handle plain timer wakeups with valid retained state */
+    if (esp_wake_stub_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER ||
+        s_rtc_state.magic != RTC_STATE_MAGIC ||
+        s_rtc_state.version != RTC_STATE_VERSION) {
+        esp_default_wake_deep_sleep();
+        return;
+    }
+
+    /* A cycle that will transmit (or report via RS-485) needs GPS + radio —
+     * that is the full application's job */
+    if (s_rtc_state.cycle_sample_count + 1 >= s_rtc_state.cfg_samples_per_transmit) {
+        esp_default_wake_deep_sleep();
+        return;
+    }
+
+    i2c_claim_pins();
+
+    /* Sensor must be alive with a completed measurement (AVALID). The
+     * sensor free-runs across our deep sleep, so with T_s >= t_int this is
+     * normally already set. Anything else -> full boot. */
+    uint8_t status2 = 0;
+    if (!i2c_read_regs(STUB_REG_STATUS2, &status2, 1) ||
+        (status2 & STUB_AVALID_BIT) == 0) {
+        esp_default_wake_deep_sleep();
+        return;
+    }
+
+    /* Single 37-byte burst from ASTATUS latches and reads all 18 channels */
+    uint8_t buf[37];
+    if (!i2c_read_regs(STUB_REG_ASTATUS, buf, sizeof(buf))) {
+        esp_default_wake_deep_sleep();
+        return;
+    }
+    const uint8_t *raw = &buf[1];
+
+#define RD16(ch) ((uint16_t)raw[(ch)*2] | ((uint16_t)raw[(ch)*2+1] << 8))
+
+    /* Data-block position of each orca_channel_t slot. Lives in RTC memory
+     * (RTC_RODATA_ATTR) so it stays reachable before the bootloader runs. */
+    static RTC_RODATA_ATTR const uint8_t stub_ch_map[ORCA_NUM_CHANNELS] = {
+        [ORCA_CH_F1]    = STUB_CH_F1,
+        [ORCA_CH_F2]    = STUB_CH_F2,
+        [ORCA_CH_FZ]    = STUB_CH_FZ,
+        [ORCA_CH_F3]    = STUB_CH_F3,
+        [ORCA_CH_F4]    = STUB_CH_F4,
+        [ORCA_CH_F5]    = STUB_CH_F5,
+        [ORCA_CH_FY]    = STUB_CH_FY,
+        [ORCA_CH_F6]    = STUB_CH_F6,
+        [ORCA_CH_FXL]   = STUB_CH_FXL,
+        [ORCA_CH_F7]    = STUB_CH_F7,
+        [ORCA_CH_F8]    = STUB_CH_F8,
+        [ORCA_CH_NIR]   = STUB_CH_NIR,
+        [ORCA_CH_CLEAR] = STUB_CH_VIS1,
+    };
+
+    /* Normalize to the reference exposure scale so mixed-exposure windows
+     * accumulate on one scale — mirrors agc_normalize(). The main app
+     * caches the combined gain/integration multiplier in RTC state, so
+     * the stub needs one Q16 multiply and none of the exposure tables. */
+    uint32_t norm_q16 = s_rtc_state.agc_norm_q16;
+
+    uint32_t slot = s_rtc_state.cycle_sample_count % ROBUST_WINDOW_N;
+    for (uint32_t i = 0; i < ORCA_NUM_CHANNELS; i++) {
+        uint32_t nv =
+            (uint32_t)(((uint64_t)RD16(stub_ch_map[i]) * norm_q16) >> 16);
+        uint16_t v = (nv > 0xFFFF) ? 0xFFFF : (uint16_t)nv;
+        s_rtc_state.sums[i] += v;
+        s_rtc_state.sum_sq[i] += (uint32_t)v * v;
+        if (v < s_rtc_state.mins[i]) s_rtc_state.mins[i] = v;
+        if (v > s_rtc_state.maxs[i]) s_rtc_state.maxs[i] = v;
+        s_rtc_state.window[i][slot] = v;
+
+        /* Transient burst detector on the clear channel — mirrors
+         * rtc_state_add_sample() so edges caught on stub-only wakes arm
+         * the fast cadence too */
+        if (i == ORCA_CH_CLEAR) {
+            if (s_rtc_state.burst_last_valid) {
+                uint16_t prev = s_rtc_state.burst_last_clear;
+                uint16_t diff = v > prev ? v - prev : prev - v;
+                if (diff >= BURST_CLEAR_DELTA_MIN && (uint32_t)diff * 4 >= prev) {
+                    s_rtc_state.burst_remaining = BURST_WAKES;
+                }
+            }
+            s_rtc_state.burst_last_clear = v;
+            s_rtc_state.burst_last_valid = 1;
+        }
+    }
+    if (s_rtc_state.burst_remaining > 0) {
+        s_rtc_state.burst_in_cycle = 1;
+    }
+
+#undef RD16
+
+    /* No esp_timer (or wall clock) in the stub; sample timestamps are
+     * refreshed by the next full-boot cycle, and a window opened here
+     * keeps first_sample_wall_us = 0 (start unknown on the wire) */
+    s_rtc_state.cycle_sample_count++;
+
+    /* Snapshot the mutated state so this sample survives RTC corruption */
+    rtc_state_commit();
+
+    /* Re-arm the timer and go straight back to sleep through this stub;
+     * the scheduling governor's stretch factor applies here too: the
+     * solar multiplier computed at the last full wake when available,
+     * else the optical night governor. The cfg_* fields are seeded at
+     * every full boot and validated by the version check above, so the
+     * division is safe. */
+    uint64_t period_us = ((uint64_t)s_rtc_state.cfg_transmit_cycle_ms /
+                          s_rtc_state.cfg_samples_per_transmit) * 1000ULL;
+    if (s_rtc_state.burst_remaining > 0) {
+        /* Burst governor outranks the stretch factors; see rtc_state.h */
+        s_rtc_state.burst_remaining--;
+        period_us = (uint64_t)BURST_PERIOD_MS * 1000ULL;
+    } else if (s_rtc_state.solar_period_mult > 0) {
+        period_us *= s_rtc_state.solar_period_mult;
+    } else if (s_rtc_state.night_mode) {
+        period_us *= NIGHT_SLEEP_MULTIPLIER;
+    }
+    /* Same slow-clock correction the main scheduler applies, so stub-armed
+     * sleeps track the TDMA grid too (pure shift/multiply — stub-safe) */
+    if (s_rtc_state.clk_cal_q16 != 0 &&
+        s_rtc_state.clk_cal_q16 != CLK_CAL_ONE_Q16) {
+        period_us = (period_us * (uint64_t)s_rtc_state.clk_cal_q16) >> 16;
+    }
+    esp_wake_stub_set_wakeup_time(period_us);
+    esp_wake_stub_sleep(&wake_stub_sample);
+}